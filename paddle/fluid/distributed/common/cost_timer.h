@@ -19,6 +19,7 @@
 #include "butil/time.h"
 #include "bvar/latency_recorder.h"
 #include "glog/logging.h"
+#include "paddle/phi/core/platform/metrics.h"
 
 namespace paddle {
 namespace distributed {
@@ -67,6 +68,14 @@ class CostTimer {
     _profiler_node = profiler.profiler(label);
     // 如果不在profiler中，则使用log输出耗时信息
     _is_print_cost = _profiler_node == NULL;
+    if (paddle::platform::MetricsRegistry::IsEnabled()) {
+      auto& registry = paddle::platform::MetricsRegistry::GetInstance();
+      _histogram = registry.GetHistogram(
+          "paddle_ps_latency_seconds",
+          "Latency of the parameter server operations timed by CostTimer.",
+          {{"label", label}});
+      _start_time_us = butil::gettimeofday_us();
+    }
     _start_time_ms = butil::gettimeofday_ms();
   }
   explicit CostTimer(CostProfilerNode& profiler_node) {  // NOLINT
@@ -75,6 +84,11 @@ class CostTimer {
     _start_time_ms = butil::gettimeofday_ms();
   }
   ~CostTimer() {
+    if (_histogram != nullptr) {
+      _histogram->Observe(
+          static_cast<double>(butil::gettimeofday_us() - _start_time_us) *
+          1e-6);
+    }
     if (_is_print_cost) {
       VLOG(3) << "CostTimer label:" << _label
               << ", cost:" << butil::gettimeofday_ms() - _start_time_ms << "ms";
@@ -88,6 +102,8 @@ class CostTimer {
   bool _is_print_cost;
   uint64_t _start_time_ms;
   CostProfilerNode* _profiler_node;
+  paddle::platform::MetricHistogram* _histogram = nullptr;
+  uint64_t _start_time_us = 0;
 };
 }  // namespace distributed
 }  // namespace paddle
@@ -15,6 +15,7 @@
 #include "paddle/fluid/distributed/fleet_executor/carrier.h"
 
 #include <algorithm>
+#include <map>
 #include <vector>
 
 #include "paddle/common/flags.h"
@@ -148,6 +149,11 @@ void Carrier::CopyParameters(
 
 bool Carrier::EnqueueInterceptorMessage(
     const InterceptorMessage& interceptor_message) {
+  return EnqueueInterceptorMessage(InterceptorMessage(interceptor_message));
+}
+
+bool Carrier::EnqueueInterceptorMessage(
+    InterceptorMessage&& interceptor_message) {
   PADDLE_ENFORCE_EQ(
       interceptor_message.ctrl_message(),
       false,
@@ -155,7 +161,8 @@ bool Carrier::EnqueueInterceptorMessage(
           "Control message should be only send inter rank using message bus."));
   int64_t dst_id = interceptor_message.dst_id();
   Interceptor* dst_interceptor = GetInterceptor(dst_id);
-  dst_interceptor->EnqueueRemoteInterceptorMessage(interceptor_message);
+  dst_interceptor->EnqueueRemoteInterceptorMessage(
+      std::move(interceptor_message));
   return true;
 }
 
@@ -218,7 +225,7 @@ int64_t Carrier::GetRank(int64_t interceptor_id) const {
   return interceptor_id_to_rank_.at(interceptor_id);
 }
 
-bool Carrier::Send(const InterceptorMessage& msg) {
+int64_t Carrier::GetDstRank(const InterceptorMessage& msg) const {
   int64_t src_id = msg.src_id();
   // TODO(liyurui): compatible solution, will be removed completely in the
   // future
@@ -236,16 +243,76 @@ bool Carrier::Send(const InterceptorMessage& msg) {
                             "the carrier rank id %lld.",
                             src_rank,
                             rank_));
-  if (src_rank == dst_rank) {
-    VLOG(3) << "Send a message from interceptor " << src_id
-            << " to interceptor " << dst_id << ", which are in the same ranks.";
-    return EnqueueInterceptorMessage(msg);
+  return dst_rank;
+}
+
+namespace {
+// Inter-rank messages held back by BeginCoalesceRemoteMessages on the current
+// thread, grouped by destination rank. Null when not coalescing.
+thread_local std::map<int64_t, std::vector<InterceptorMessage>>*
+    coalesced_remote_messages = nullptr;
+}  // namespace
+
+void Carrier::BeginCoalesceRemoteMessages() {
+  static thread_local std::map<int64_t, std::vector<InterceptorMessage>>
+      outbox;
+  coalesced_remote_messages = &outbox;
+}
+
+bool Carrier::FlushRemoteMessages() {
+  auto* outbox = coalesced_remote_messages;
+  coalesced_remote_messages = nullptr;
+  if (outbox == nullptr) {
+    return true;
+  }
+  bool success = true;
+  for (auto& item : *outbox) {
+    if (item.second.empty()) {
+      continue;
+    }
+    VLOG(3) << "Send " << item.second.size() << " coalesced messages to rank "
+            << item.first << ".";
+    success =
+        GlobalVal<MessageBus>::Get()->SendBatch(item.first, item.second) &&
+        success;
+    item.second.clear();
+  }
+  return success;
+}
+
+bool Carrier::SendRemote(int64_t dst_rank, const InterceptorMessage& msg) {
+  VLOG(3) << "Send a message from interceptor " << msg.src_id()
+          << " to interceptor " << msg.dst_id()
+          << ", which are in different ranks.";
+  if (coalesced_remote_messages != nullptr) {
+    (*coalesced_remote_messages)[dst_rank].emplace_back(msg);
+    return true;
   }
-  VLOG(3) << "Send a message from interceptor " << src_id << " to interceptor "
-          << dst_id << ", which are in different ranks.";
   return GlobalVal<MessageBus>::Get()->Send(dst_rank, msg);
 }
 
+bool Carrier::Send(const InterceptorMessage& msg) {
+  int64_t dst_rank = GetDstRank(msg);
+  if (dst_rank == rank_) {
+    VLOG(3) << "Send a message from interceptor " << msg.src_id()
+            << " to interceptor " << msg.dst_id()
+            << ", which are in the same ranks.";
+    return EnqueueInterceptorMessage(msg);
+  }
+  return SendRemote(dst_rank, msg);
+}
+
+bool Carrier::Send(InterceptorMessage&& msg) {
+  int64_t dst_rank = GetDstRank(msg);
+  if (dst_rank == rank_) {
+    VLOG(3) << "Send a message from interceptor " << msg.src_id()
+            << " to interceptor " << msg.dst_id()
+            << ", which are in the same ranks.";
+    return EnqueueInterceptorMessage(std::move(msg));
+  }
+  return SendRemote(dst_rank, msg);
+}
+
 Interceptor* Carrier::SetInterceptor(int64_t interceptor_id,
                                      std::unique_ptr<Interceptor> interceptor) {
   auto iter = interceptor_idx_to_interceptor_.find(interceptor_id);
@@ -75,6 +75,7 @@ class Carrier final {
 
   // Enqueue a message to corresponding interceptor id
   bool EnqueueInterceptorMessage(const InterceptorMessage& interceptor_message);
+  bool EnqueueInterceptorMessage(InterceptorMessage&& interceptor_message);
 
   // get interceptor based on the interceptor id
   Interceptor* GetInterceptor(int64_t interceptor_id);
@@ -88,6 +89,14 @@ class Carrier final {
   bool IsInit() const;
 
   bool Send(const InterceptorMessage& msg);
+  // Same as above, but a message for this rank is moved into the mailbox of
+  // the destination instead of being copied.
+  bool Send(InterceptorMessage&& msg);
+
+  // Between the two calls, messages sent to other ranks from the current
+  // thread are held back, then sent as one batch per destination rank.
+  void BeginCoalesceRemoteMessages();
+  bool FlushRemoteMessages();
 
  private:
   DISABLE_COPY_AND_ASSIGN(Carrier);
@@ -99,6 +108,11 @@ class Carrier final {
 
   int64_t GetRank(int64_t interceptor_id) const;
 
+  // Returns the destination rank when the message leaves this rank, or
+  // rank_ when it is delivered locally.
+  int64_t GetDstRank(const InterceptorMessage& msg) const;
+  bool SendRemote(int64_t dst_rank, const InterceptorMessage& msg);
+
   // interceptor logic id to actually interceptor
   std::unordered_map<int64_t, std::unique_ptr<Interceptor>>
       interceptor_idx_to_interceptor_;
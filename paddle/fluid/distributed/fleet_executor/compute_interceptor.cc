@@ -288,7 +288,7 @@ void ComputeInterceptor::ReplyCompletedToUpStream() {
     InterceptorMessage reply_msg;
     reply_msg.set_message_type(DATA_IS_USELESS);
     reply_msg.set_scope_idx(cur_scope_id_);
-    Send(up_id, reply_msg);
+    Send(up_id, std::move(reply_msg));
   }
 }
 
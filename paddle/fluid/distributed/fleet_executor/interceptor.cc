@@ -25,12 +25,11 @@ Interceptor::Interceptor(int64_t interceptor_id, TaskNode* node)
       node_(node),
       carrier_(nullptr),
       loop_(nullptr),
-      messages_() {}
+      mailbox_() {}
 
 Interceptor::~Interceptor() {  // NOLINT
   // FIXME(wangxi): throw in stop function
-  // std::lock_guard<std::mutex> lock(mutex_);
-  // PADDLE_ENFORCE_EQ(messages_.empty(), true,
+  // PADDLE_ENFORCE_EQ(pending_ == 0, true,
   //                  common::errors::PreconditionNotMet(
   //                      "Interceptor must destruct with messages empty"));
 }
@@ -45,23 +44,41 @@ void Interceptor::Handle(const InterceptorMessage& msg) {
 }
 
 void Interceptor::LoopOnce() {
-  std::deque<InterceptorMessage> tmp_messages;
-  {
-    std::lock_guard<std::mutex> lock(mutex_);
-    messages_.swap(tmp_messages);
-  }
-  PADDLE_ENFORCE_EQ(tmp_messages.empty(),
-                    false,
-                    common::errors::PreconditionNotMet(
-                        "tmp_messages must not empty in task loop"));
-
-  for (auto& msg : tmp_messages) {
+  // Only handle the messages pending when the loop starts, the ones arriving
+  // meanwhile are handled by a rescheduled LoopOnce so that the interceptors
+  // sharing this task loop are served fairly.
+  const int64_t num_messages = pending_.load(std::memory_order_acquire);
+  PADDLE_ENFORCE_GT(
+      num_messages,
+      0,
+      common::errors::PreconditionNotMet(
+          "Interceptor must have pending messages in task loop."));
+
+  InterceptorMessage msg;
+  for (int64_t i = 0; i < num_messages; ++i) {
+    // The message is counted as soon as its sender claimed a mailbox slot,
+    // spin for the short window before the slot is linked.
+    while (!mailbox_.TryPop(&msg)) {
+      std::this_thread::yield();
+    }
     const MessageType message_type = msg.message_type();
     VLOG(3) << "Interceptor " << interceptor_id_ << " has received a message"
             << " from interceptor " << msg.src_id()
             << " with message: " << message_type << ".";
 
+    // Messages to other ranks sent by one handler leave as one batch per rank.
+    if (carrier_ != nullptr) {
+      carrier_->BeginCoalesceRemoteMessages();
+    }
     Handle(msg);
+    if (carrier_ != nullptr) {
+      carrier_->FlushRemoteMessages();
+    }
+  }
+
+  if (pending_.fetch_sub(num_messages, std::memory_order_acq_rel) >
+      num_messages) {
+    loop_->QueueInLoop([this]() { LoopOnce(); });
   }
 }
 
@@ -74,17 +91,17 @@ void Interceptor::StopCarrier() {
 
 void Interceptor::EnqueueRemoteInterceptorMessage(
     const InterceptorMessage& message) {
+  EnqueueRemoteInterceptorMessage(InterceptorMessage(message));
+}
+
+void Interceptor::EnqueueRemoteInterceptorMessage(
+    InterceptorMessage&& message) {
   // Called by Carrier, enqueue an InterceptorMessage to remote mailbox
   VLOG(3) << "Enqueue message: " << message.message_type() << " into "
           << interceptor_id_ << "'s remote mailbox.";
 
-  bool empty = false;
-  {
-    std::lock_guard<std::mutex> lock(mutex_);
-    empty = messages_.empty();
-    messages_.emplace_back(message);
-  }
-  if (empty) {
+  mailbox_.Push(std::move(message));
+  if (pending_.fetch_add(1, std::memory_order_acq_rel) == 0) {
     loop_->QueueInLoop([this]() { LoopOnce(); });
   }
 }
@@ -98,6 +115,15 @@ bool Interceptor::Send(int64_t dst_id, InterceptorMessage& msg) {
   return carrier_->Send(msg);
 }
 
+bool Interceptor::Send(int64_t dst_id, InterceptorMessage&& msg) {
+  PADDLE_ENFORCE_NOT_NULL(
+      carrier_,
+      common::errors::PreconditionNotMet("Carrier is not registered."));
+  msg.set_src_id(interceptor_id_);
+  msg.set_dst_id(dst_id);
+  return carrier_->Send(std::move(msg));
+}
+
 static InterceptorFactory::CreateInterceptorMap& GetInterceptorMap() {
   static InterceptorFactory::CreateInterceptorMap interceptorMap;
   return interceptorMap;
@@ -25,6 +25,7 @@
 #include "paddle/common/errors.h"
 #include "paddle/common/macros.h"
 #include "paddle/fluid/distributed/fleet_executor/interceptor_message.pb.h"
+#include "paddle/fluid/distributed/fleet_executor/mailbox.h"
 #include "paddle/fluid/framework/blocking_queue.h"
 #include "paddle/fluid/framework/new_executor/interpretercore.h"
 #include "paddle/fluid/platform/enforce.h"
@@ -70,8 +71,12 @@ class Interceptor {
   // Called by Carrier, enqueue an InterceptorMessage to remote mailbox
   void EnqueueRemoteInterceptorMessage(
       const InterceptorMessage& interceptor_message);
+  void EnqueueRemoteInterceptorMessage(
+      InterceptorMessage&& interceptor_message);
 
   bool Send(int64_t dst_id, InterceptorMessage& msg);  // NOLINT
+  // The message is moved to a local destination without being copied.
+  bool Send(int64_t dst_id, InterceptorMessage&& msg);
 
   void SetPlace(const phi::Place& place) { place_ = place; }
 
@@ -121,8 +126,11 @@ class Interceptor {
   // interceptor handle which process message
   MsgHandle handle_{nullptr};
 
-  std::mutex mutex_;
-  std::deque<InterceptorMessage> messages_;
+  // Senders push into the mailbox without taking a lock. pending_ counts the
+  // pushed but not yet handled messages, the sender that raises it from zero
+  // schedules LoopOnce, so at most one LoopOnce is in flight per interceptor.
+  MpscMailbox<InterceptorMessage> mailbox_;
+  std::atomic<int64_t> pending_{0};
 };
 
 class InterceptorFactory {
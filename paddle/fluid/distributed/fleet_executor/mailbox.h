@@ -0,0 +1,83 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <atomic>
+#include <utility>
+
+#include "paddle/common/macros.h"
+
+namespace paddle {
+namespace distributed {
+
+// An unbounded lock-free multi-producer single-consumer queue. Any thread may
+// Push, only one thread at a time may TryPop. Producers never wait on each
+// other or on the consumer: a push is one atomic exchange.
+//
+// The queue always keeps one dummy node at the tail. A popped node becomes the
+// new dummy after its value has been moved out, so no extra stub is needed.
+template <typename T>
+class MpscMailbox {
+ public:
+  MpscMailbox() : head_(new Node()), tail_(head_.load()) {}
+
+  ~MpscMailbox() {
+    T value;
+    while (TryPop(&value)) {
+    }
+    delete tail_;
+  }
+
+  void Push(T&& value) {
+    auto* node = new Node(std::move(value));
+    Node* prev = head_.exchange(node, std::memory_order_acq_rel);
+    prev->next.store(node, std::memory_order_release);
+  }
+
+  void Push(const T& value) { Push(T(value)); }
+
+  // Returns false when the queue is empty, or when a producer has claimed a
+  // slot but not linked it yet, callers that know an element was pushed
+  // should retry.
+  bool TryPop(T* value) {
+    Node* tail = tail_;
+    Node* next = tail->next.load(std::memory_order_acquire);
+    if (next == nullptr) {
+      return false;
+    }
+    *value = std::move(next->value);
+    tail_ = next;
+    delete tail;
+    return true;
+  }
+
+ private:
+  DISABLE_COPY_AND_ASSIGN(MpscMailbox);
+
+  struct Node {
+    Node() = default;
+    explicit Node(T&& v) : value(std::move(v)) {}
+    std::atomic<Node*> next{nullptr};
+    T value;
+  };
+
+  // producers side
+  alignas(64) std::atomic<Node*> head_;
+  // consumer side
+  alignas(64) Node* tail_;
+};
+
+}  // namespace distributed
+}  // namespace paddle
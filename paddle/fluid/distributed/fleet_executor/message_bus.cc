@@ -115,6 +115,46 @@ bool MessageBus::Send(int64_t dst_rank,
   return true;
 }
 
+bool MessageBus::SendBatch(
+    int64_t dst_rank,
+    const std::vector<InterceptorMessage>& interceptor_messages) {
+  if (interceptor_messages.size() == 1) {
+    return Send(dst_rank, interceptor_messages.front());
+  }
+  PADDLE_ENFORCE_EQ(
+      IsInit(),
+      true,
+      common::errors::PreconditionNotMet(
+          "Using message bus since it has not been initialized."));
+#if defined(PADDLE_WITH_DISTRIBUTE) && !defined(PADDLE_WITH_PSLIB)
+  InterceptorMessageBatch batch;
+  batch.mutable_messages()->Reserve(
+      static_cast<int>(interceptor_messages.size()));
+  for (const auto& interceptor_message : interceptor_messages) {
+    *batch.add_messages() = interceptor_message;
+  }
+  int retry_time = 0;  // message bus will retry sending for 10 times
+  while (retry_time < 10) {
+    ++retry_time;
+    if (SendBatchInterRank(dst_rank, batch)) {
+      VLOG(3) << "Message bus sends a batch of " << batch.messages_size()
+              << " messages inter rank successfully with " << retry_time
+              << " times retries.";
+      return true;
+    }
+    VLOG(3) << "Message bus sends batch failed, retry after 1 seconds.";
+    std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+  }
+  VLOG(3) << "Message bus sends batch inter rank fail after 10 times retries.";
+  return false;
+#else
+  PADDLE_THROW(common::errors::Unavailable(
+      "Fleet executor does not support sending message between different "
+      "ranks when Paddle isn't compiled with distributed for now."));
+#endif
+  return true;
+}
+
 void MessageBus::IncreaseBarrierCount() {
   VLOG(3) << "IncreaseBarrierCount";
   {
@@ -207,31 +247,32 @@ void MessageBus::ListenPort() {
 }
 
 #if defined(PADDLE_WITH_DISTRIBUTE) && !defined(PADDLE_WITH_PSLIB)
-bool MessageBus::SendInterRank(int64_t dst_rank,
-                               const InterceptorMessage& interceptor_message) {
+brpc::Channel* MessageBus::GetChannel(int64_t dst_rank) {
+  std::lock_guard<std::mutex> lock(channel_mutex_);
+  auto iter = channels_.find(dst_rank);
+  if (iter != channels_.end()) {
+    return iter->second.get();
+  }
   const auto& dst_addr = GetAddr(dst_rank);
-  VLOG(3) << "Message bus sending to addr: " << dst_addr;
+  VLOG(3) << "Message bus creates channel to addr: " << dst_addr;
   const char* dst_addr_for_brpc = dst_addr.c_str();
-  brpc::Channel channel;
+  auto channel = std::make_unique<brpc::Channel>();
   brpc::ChannelOptions options;
   options.protocol = "baidu_std";
   options.connect_timeout_ms = 100000;
   options.timeout_ms = 100000;
   options.max_retry = 5;
   PADDLE_ENFORCE_EQ(
-      channel.Init(dst_addr_for_brpc, &options),
+      channel->Init(dst_addr_for_brpc, &options),
       0,
       common::errors::Unavailable("Message bus: init brpc channel error."));
-  MessageService_Stub stub(&channel);
-  InterceptorResponse response;
-  brpc::Controller ctrl;
-  ctrl.set_log_id(0);
-  if (interceptor_message.ctrl_message()) {
-    stub.IncreaseBarrierCount(&ctrl, &interceptor_message, &response, nullptr);
-  } else {
-    stub.ReceiveInterceptorMessage(
-        &ctrl, &interceptor_message, &response, nullptr);
-  }
+  auto* ptr = channel.get();
+  channels_.emplace(dst_rank, std::move(channel));
+  return ptr;
+}
+
+bool MessageBus::CheckResponse(const brpc::Controller& ctrl,
+                               const InterceptorResponse& response) {
   if (!ctrl.Failed()) {
     if (response.rst()) {
       VLOG(3) << "Message bus: brpc sends success.";
@@ -247,6 +288,33 @@ bool MessageBus::SendInterRank(int64_t dst_rank,
   }
 }
 
+bool MessageBus::SendInterRank(int64_t dst_rank,
+                               const InterceptorMessage& interceptor_message) {
+  VLOG(3) << "Message bus sending to rank: " << dst_rank;
+  MessageService_Stub stub(GetChannel(dst_rank));
+  InterceptorResponse response;
+  brpc::Controller ctrl;
+  ctrl.set_log_id(0);
+  if (interceptor_message.ctrl_message()) {
+    stub.IncreaseBarrierCount(&ctrl, &interceptor_message, &response, nullptr);
+  } else {
+    stub.ReceiveInterceptorMessage(
+        &ctrl, &interceptor_message, &response, nullptr);
+  }
+  return CheckResponse(ctrl, response);
+}
+
+bool MessageBus::SendBatchInterRank(int64_t dst_rank,
+                                    const InterceptorMessageBatch& batch) {
+  VLOG(3) << "Message bus sending a batch to rank: " << dst_rank;
+  MessageService_Stub stub(GetChannel(dst_rank));
+  InterceptorResponse response;
+  brpc::Controller ctrl;
+  ctrl.set_log_id(0);
+  stub.ReceiveInterceptorMessageBatch(&ctrl, &batch, &response, nullptr);
+  return CheckResponse(ctrl, response);
+}
+
 #endif
 
 }  // namespace paddle::distributed
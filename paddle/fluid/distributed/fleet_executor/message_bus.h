@@ -15,10 +15,12 @@
 #pragma once
 
 #include <condition_variable>
+#include <memory>
 #include <mutex>
 #include <string>
 #include <thread>
 #include <unordered_map>
+#include <vector>
 
 #if defined(PADDLE_WITH_DISTRIBUTE) && !defined(PADDLE_WITH_PSLIB)
 #include "brpc/channel.h"
@@ -50,6 +52,9 @@ class MessageBus final {
 
   // called by Interceptor, send InterceptorMessage to dst
   bool Send(int64_t dst_rank, const InterceptorMessage& interceptor_message);
+  // send several messages for the same dst rank with one rpc
+  bool SendBatch(int64_t dst_rank,
+                 const std::vector<InterceptorMessage>& interceptor_messages);
 
   void IncreaseBarrierCount();
   void Barrier();
@@ -67,6 +72,13 @@ class MessageBus final {
   // send the message inter rank (dst is different rank with src)
   bool SendInterRank(int64_t dst_rank,
                      const InterceptorMessage& interceptor_message);
+  bool SendBatchInterRank(int64_t dst_rank,
+                          const InterceptorMessageBatch& batch);
+  bool CheckResponse(const brpc::Controller& ctrl,
+                     const InterceptorResponse& response);
+
+  // channels are created once per dst rank and reused by all later sends
+  brpc::Channel* GetChannel(int64_t dst_rank);
 #endif
 
   bool is_init_{false};
@@ -83,6 +95,8 @@ class MessageBus final {
   MessageServiceImpl message_service_;
   // brpc server
   brpc::Server server_;
+  std::mutex channel_mutex_;
+  std::unordered_map<int64_t, std::unique_ptr<brpc::Channel>> channels_;
 #endif
 
   // for barrier
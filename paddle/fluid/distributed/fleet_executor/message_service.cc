@@ -34,6 +34,21 @@ void MessageServiceImpl::ReceiveInterceptorMessage(
   response->set_rst(flag);
 }
 
+void MessageServiceImpl::ReceiveInterceptorMessageBatch(
+    google::protobuf::RpcController* control_base,
+    const InterceptorMessageBatch* request,
+    InterceptorResponse* response,
+    google::protobuf::Closure* done) {
+  brpc::ClosureGuard done_guard(done);
+  VLOG(3) << "Message Service receives a batch of " << request->messages_size()
+          << " messages.";
+  bool flag = true;
+  for (const auto& message : request->messages()) {
+    flag = GlobalVal<MessageBus>::Get()->DispatchMsgToCarrier(message) && flag;
+  }
+  response->set_rst(flag);
+}
+
 void MessageServiceImpl::IncreaseBarrierCount(
     google::protobuf::RpcController* control_base,
     const InterceptorMessage* request,
@@ -29,6 +29,11 @@ class MessageServiceImpl : public MessageService {
       const InterceptorMessage* request,
       InterceptorResponse* response,
       google::protobuf::Closure* done);
+  virtual void ReceiveInterceptorMessageBatch(
+      google::protobuf::RpcController* control_base,
+      const InterceptorMessageBatch* request,
+      InterceptorResponse* response,
+      google::protobuf::Closure* done);
   virtual void IncreaseBarrierCount(
       google::protobuf::RpcController* control_base,
       const InterceptorMessage* request,
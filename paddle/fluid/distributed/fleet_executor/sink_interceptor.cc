@@ -49,7 +49,7 @@ void SinkInterceptor::ReplyCompletedToUpStream(int64_t upstream_id) {
   InterceptorMessage msg;
   msg.set_message_type(DATA_IS_USELESS);
   msg.set_scope_idx(scope_idx);
-  Send(upstream_id, msg);
+  Send(upstream_id, std::move(msg));
   upstream_step_.at(upstream_id) = micro_step + 1;
   if (micro_step == max_run_times_ - 1) {
     StopCarrierIfComplete();
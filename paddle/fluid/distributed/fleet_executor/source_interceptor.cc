@@ -38,7 +38,7 @@ void SourceInterceptor::SendDataReadyToDownStream(int64_t downstream_id) {
   InterceptorMessage ready_msg;
   ready_msg.set_message_type(DATA_IS_READY);
   ready_msg.set_scope_idx(scope_idx);
-  Send(downstream_id, ready_msg);
+  Send(downstream_id, std::move(ready_msg));
   downstream_step_.at(downstream_id) = micro_step + 1;
 }
 
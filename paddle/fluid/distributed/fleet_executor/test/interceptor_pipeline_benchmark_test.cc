@@ -0,0 +1,97 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "paddle/common/flags.h"
+#include "paddle/fluid/distributed/fleet_executor/carrier.h"
+#include "paddle/fluid/distributed/fleet_executor/global.h"
+#include "paddle/fluid/distributed/fleet_executor/interceptor.h"
+#include "paddle/fluid/distributed/fleet_executor/message_bus.h"
+#include "paddle/fluid/distributed/fleet_executor/task_node.h"
+
+PD_DEFINE_int32(pipeline_bench_stages, 4, "Number of pipeline stages.");
+PD_DEFINE_int32(pipeline_bench_micro_steps, 2000, "Number of micro batches.");
+
+namespace paddle {
+namespace distributed {
+
+// A synthetic 1F1B schedule on local ranks: every stage has a forward and a
+// backward interceptor without ops, and the buffers between them shrink
+// towards the last stage like the warmup depth of 1F1B. Since no op runs, the
+// measured time is the cost of message passing and scheduling.
+TEST(InterceptorPipeline, Benchmark1F1B) {
+  const int64_t num_stages = FLAGS_pipeline_bench_stages;
+  const int64_t micro_steps = FLAGS_pipeline_bench_micro_steps;
+
+  std::unordered_map<int64_t, int64_t> interceptor_id_to_rank = {
+      {SOURCE_ID, 0}, {SINK_ID, 0}};
+  for (int64_t i = 0; i < 2 * num_stages; ++i) {
+    interceptor_id_to_rank[i] = 0;
+  }
+  std::string carrier_id = "0";
+  Carrier* carrier =
+      GlobalMap<std::string, Carrier>::Create(carrier_id, carrier_id);
+  carrier->Init(0, interceptor_id_to_rank);
+  MessageBus* msg_bus = GlobalVal<MessageBus>::Create();
+  msg_bus->Init(0, {{0, ""}}, "");
+
+  // NOTE: don't delete, otherwise interceptor will use undefined node
+  std::vector<TaskNode*> nodes;
+  nodes.push_back(new TaskNode(0, SOURCE_ID, micro_steps));
+  for (int64_t i = 0; i < 2 * num_stages; ++i) {
+    nodes.push_back(new TaskNode(0, 0, i, micro_steps));
+  }
+  nodes.push_back(new TaskNode(0, SINK_ID, micro_steps));
+
+  // source->F0->...->F(S-1)->B(S-1)->...->B0->sink
+  for (size_t i = 0; i + 1 < nodes.size(); ++i) {
+    int64_t stage = std::min<int64_t>(static_cast<int64_t>(i),
+                                      2 * num_stages - static_cast<int64_t>(i));
+    int64_t buff_size = std::max<int64_t>(num_stages - stage, 1);
+    nodes[i]->AddDownstreamTask(nodes[i + 1]->task_id(), buff_size);
+    nodes[i + 1]->AddUpstreamTask(nodes[i]->task_id(), buff_size);
+  }
+
+  carrier->SetInterceptor(
+      SOURCE_ID, InterceptorFactory::Create("Source", SOURCE_ID, nodes[0]));
+  for (int64_t i = 0; i < 2 * num_stages; ++i) {
+    carrier->SetInterceptor(
+        i, InterceptorFactory::Create("Compute", i, nodes[i + 1]));
+  }
+  carrier->SetInterceptor(
+      SINK_ID, InterceptorFactory::Create("Sink", SINK_ID, nodes.back()));
+
+  auto start = std::chrono::steady_clock::now();
+  InterceptorMessage msg;
+  msg.set_message_type(START);
+  msg.set_dst_id(SOURCE_ID);
+  carrier->EnqueueInterceptorMessage(msg);
+  carrier->Wait();
+  auto elapsed = std::chrono::duration<double, std::micro>(
+                     std::chrono::steady_clock::now() - start)
+                     .count();
+  carrier->Release();
+
+  std::cout << num_stages << " stages, " << micro_steps
+            << " micro batches: " << elapsed / 1000.0 << " ms, "
+            << micro_steps * 1e6 / elapsed << " micro batches/s."
+            << std::endl;
+}
+
+}  // namespace distributed
+}  // namespace paddle
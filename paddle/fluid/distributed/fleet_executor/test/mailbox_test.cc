@@ -0,0 +1,76 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/distributed/fleet_executor/mailbox.h"
+
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace paddle {
+namespace distributed {
+
+TEST(MpscMailbox, SingleThread) {
+  MpscMailbox<std::unique_ptr<int>> mailbox;
+  std::unique_ptr<int> value;
+  EXPECT_FALSE(mailbox.TryPop(&value));
+  for (int i = 0; i < 10; ++i) {
+    mailbox.Push(std::make_unique<int>(i));
+  }
+  for (int i = 0; i < 10; ++i) {
+    ASSERT_TRUE(mailbox.TryPop(&value));
+    EXPECT_EQ(*value, i);
+  }
+  EXPECT_FALSE(mailbox.TryPop(&value));
+  // values left in the mailbox are released by its destructor
+  mailbox.Push(std::make_unique<int>(10));
+}
+
+TEST(MpscMailbox, MultiProducer) {
+  constexpr int kProducers = 4;
+  constexpr int kPerProducer = 10000;
+  MpscMailbox<std::pair<int, int>> mailbox;
+
+  std::vector<std::thread> producers;
+  for (int p = 0; p < kProducers; ++p) {
+    producers.emplace_back([&mailbox, p]() {
+      for (int i = 0; i < kPerProducer; ++i) {
+        mailbox.Push(std::make_pair(p, i));
+      }
+    });
+  }
+
+  // messages of one producer must come out in the order they were pushed
+  std::vector<int> next(kProducers, 0);
+  int received = 0;
+  std::pair<int, int> value;
+  while (received < kProducers * kPerProducer) {
+    if (!mailbox.TryPop(&value)) {
+      std::this_thread::yield();
+      continue;
+    }
+    ASSERT_EQ(value.second, next[value.first]);
+    ++next[value.first];
+    ++received;
+  }
+  for (auto& t : producers) {
+    t.join();
+  }
+  EXPECT_FALSE(mailbox.TryPop(&value));
+}
+
+}  // namespace distributed
+}  // namespace paddle
@@ -20,6 +20,7 @@
 
 #include "paddle/fluid/distributed/ps/service/coordinator_client.h"
 #include "paddle/fluid/framework/archive.h"
+#include "paddle/phi/core/platform/metrics.h"
 #include "paddle/utils/string/split.h"
 
 static const int max_port = 65535;
@@ -88,6 +89,18 @@ inline size_t get_sparse_shard(uint32_t shard_num,
   return (key % shard_num) / local_shard_num;
 }
 
+// Number of pending async push tasks of a table, exported as a gauge.
+static void RecordPushQueueDepth(const char *kind, size_t table_id, int depth) {
+  if (!paddle::platform::MetricsRegistry::IsEnabled()) {
+    return;
+  }
+  paddle::platform::MetricsRegistry::GetInstance()
+      .GetGauge("paddle_ps_client_push_queue_depth",
+                "Pending async push tasks of a parameter server table.",
+                {{"kind", kind}, {"table", std::to_string(table_id)}})
+      ->Set(depth);
+}
+
 void DownpourPsClientService::service(
     ::google::protobuf::RpcController *controller,
     const PsRequestMessage *request,
@@ -1532,6 +1545,7 @@ std::future<int32_t> BrpcPsClient::PushSparse(size_t table_id,
   auto push_timer = std::make_shared<CostTimer>("pserver_client_push_sparse");
   CostTimer parse_timer("pserver_client_push_sparse_parse");
   int push_sparse_async_num = _push_sparse_task_queue_map[table_id]->Size();
+  RecordPushQueueDepth("sparse", table_id, push_sparse_async_num);
   while (push_sparse_async_num > FLAGS_pserver_max_async_call_num) {
     //    LOG(INFO) << "PushSparse Waiting for async_call_num consume,
     //    task_num:"
@@ -1893,6 +1907,7 @@ std::future<int32_t> BrpcPsClient::PushDense(const Region *regions,
   auto parse_timer =
       std::make_shared<CostTimer>("pserver_client_push_dense_parse");
   int push_dense_async_num = _push_dense_task_queue_map[table_id]->Size();
+  RecordPushQueueDepth("dense", table_id, push_dense_async_num);
   while (push_dense_async_num > FLAGS_pserver_max_async_call_num) {
     //    LOG(INFO) << "PushDense Waiting for async_call_num consume,
     //    task_num:"
@@ -524,12 +524,18 @@ void AsyncCommunicator::SendByCommunicator() {
           continue;
         } else {
           wait_times = 0;
-          for (size_t i = 0; i < var_nums; i++) {
+          // Takes every step already in the queue at once, the other vars
+          // of the table are pushed along with the first one.
+          size_t num = check_queue->PopBatch(
+              max_merge_var_num_ - merged_var_num, &vars[0]);
+          for (size_t i = 1; i < var_nums; i++) {
             auto &var_name = varnames[i];
             auto &var_queue = send_varname_to_queue_[var_name];
-            vars[i].push_back(var_queue->Pop());
+            for (size_t j = 0; j < num; j++) {
+              vars[i].push_back(var_queue->Pop());
+            }
           }
-          merged_var_num++;
+          merged_var_num += static_cast<int>(num);
         }
       }
       if (merged_var_num == 0) return;
@@ -853,7 +859,7 @@ void AsyncCommunicator::InitImpl(const RpcCtxMap &send_varname_to_ctx,
     auto &varnames = ctx.origin_varnames;
     for (auto &var_name : varnames) {
       send_varname_to_queue_[var_name] =
-          std::make_shared<BlockingQueue<std::shared_ptr<Variable>>>(
+          std::make_shared<MpscQueue<std::shared_ptr<Variable>>>(
               send_queue_size_);
     }
   }
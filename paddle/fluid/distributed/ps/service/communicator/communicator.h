@@ -17,13 +17,16 @@ limitations under the License. */
 #include <ThreadPool.h>
 #include <stdint.h>
 
+#include <algorithm>
 #include <atomic>
+#include <chrono>
 #include <deque>
 #include <map>
 #include <memory>
 #include <numeric>
 #include <set>
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include <unordered_set>
 #include <utility>
@@ -151,6 +154,134 @@ class BlockingQueue {
   mutable std::mutex mutex_;
 };
 
+// Bounded lock-free ring for many producers and a single consumer, e.g. the
+// trainer threads pushing the gradients of a variable and the send task of
+// its table. Every slot holds the position it expects next: a producer
+// claims a position with one CAS and publishes the element by bumping the
+// sequence of the slot, so producers never contend on a lock and the
+// consumer can take every published element at once with PopBatch.
+template <typename T>
+class MpscQueue {
+ public:
+  explicit MpscQueue(size_t capacity) : capacity_(capacity) {
+    PADDLE_ENFORCE_GT(capacity_,
+                      0,
+                      common::errors::InvalidArgument(
+                          "The capacity must be greater than 0."));
+    slots_.reset(new Slot[capacity_]);
+    for (size_t i = 0; i < capacity_; ++i) {
+      slots_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  // Waits while the queue is full.
+  bool Push(const T &elem) {
+    T copy(elem);
+    return Push(std::move(copy));
+  }
+
+  bool Push(T &&elem) {
+    size_t pos = push_pos_.load(std::memory_order_relaxed);
+    Slot *slot = nullptr;
+    for (int spins = 0;; ++spins) {
+      slot = &slots_[pos % capacity_];
+      size_t sequence = slot->sequence.load(std::memory_order_acquire);
+      auto diff = static_cast<int64_t>(sequence - pos);
+      if (diff == 0) {
+        if (push_pos_.compare_exchange_weak(
+                pos, pos + 1, std::memory_order_relaxed)) {
+          break;
+        }
+      } else {
+        if (diff < 0) {
+          // Full: the consumer has not freed the slot of the last round.
+          Backoff(spins);
+        }
+        pos = push_pos_.load(std::memory_order_relaxed);
+      }
+    }
+    slot->elem = std::move(elem);
+    slot->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Waits until an element is published. Only called by the consumer.
+  T Pop() {
+    size_t pos = pop_pos_.load(std::memory_order_relaxed);
+    Slot &slot = slots_[pos % capacity_];
+    for (int spins = 0;
+         slot.sequence.load(std::memory_order_acquire) != pos + 1;
+         ++spins) {
+      Backoff(spins);
+    }
+    T rc(std::move(slot.elem));
+    Release(&slot, pos);
+    return rc;
+  }
+
+  // Moves up to `max_num` published elements to the end of `out` without
+  // waiting, returns how many were moved. Only called by the consumer.
+  size_t PopBatch(size_t max_num, std::vector<T> *out) {
+    size_t pos = pop_pos_.load(std::memory_order_relaxed);
+    size_t num = 0;
+    for (; num < max_num; ++num, ++pos) {
+      Slot &slot = slots_[pos % capacity_];
+      if (slot.sequence.load(std::memory_order_acquire) != pos + 1) {
+        break;
+      }
+      out->push_back(std::move(slot.elem));
+      Release(&slot, pos);
+    }
+    return num;
+  }
+
+  size_t Cap() const { return capacity_; }
+
+  // The elements PopBatch can take now: the published ones up to the first
+  // position claimed by a producer but not published yet.
+  size_t Size() const {
+    size_t pos = pop_pos_.load(std::memory_order_acquire);
+    size_t num = 0;
+    for (; num < capacity_; ++num, ++pos) {
+      if (slots_[pos % capacity_].sequence.load(std::memory_order_acquire) !=
+          pos + 1) {
+        break;
+      }
+    }
+    return num;
+  }
+
+ private:
+  struct Slot {
+    std::atomic<size_t> sequence;
+    T elem;
+  };
+
+  void Release(Slot *slot, size_t pos) {
+    // Drops the reference held by the slot before it can be reused.
+    slot->elem = T();
+    slot->sequence.store(pos + capacity_, std::memory_order_release);
+    pop_pos_.store(pos + 1, std::memory_order_release);
+  }
+
+  static void Backoff(int spins) {
+    if (spins < 64) {
+      return;
+    } else if (spins < 1024) {
+      std::this_thread::yield();
+    } else {
+      std::this_thread::sleep_for(std::chrono::microseconds(50));
+    }
+  }
+
+  const size_t capacity_;
+  std::unique_ptr<Slot[]> slots_;
+  // On their own cache lines, the producers only write `push_pos_` and the
+  // consumer only writes `pop_pos_`.
+  alignas(64) std::atomic<size_t> push_pos_{0};
+  alignas(64) std::atomic<size_t> pop_pos_{0};
+};
+
 template <typename T,
           int MajorType = Eigen::RowMajor,
           typename IndexType = Eigen::DenseIndex>
@@ -176,28 +307,44 @@ inline void MergeVars(const std::string &var_name,
     auto *out_t = out_var->GetMutable<phi::DenseTensor>();
     out_t->mutable_data<T>(dims, cpu_place);
     // check the input dims
+    std::vector<const T *> in_data;
+    in_data.reserve(vars.size());
     for (auto &var : vars) {
       auto &var_t = var->Get<phi::DenseTensor>();
       PADDLE_ENFORCE_EQ(
           var_t.dims(),
           dims,
           common::errors::InvalidArgument("vars should have the same dims."));
+      in_data.push_back(var_t.data<T>());
     }
 
-    // set output tensor to 0.
-    phi::CPUContext cpu_ctx;
-    phi::funcs::SetConstant<phi::CPUContext, T> constant_functor;
-    constant_functor(cpu_ctx, out_t, static_cast<T>(0));
-    // sum all vars to out
-    auto result = EigenVector<T>::Flatten(*out_t);
-    for (auto &var : vars) {
-      auto &in_t = var->Get<phi::DenseTensor>();
-      auto in = EigenVector<T>::Flatten(in_t);
-      result.device(*cpu_ctx.eigen_device()) = result + in;
-    }
-    if (!merge_add) {
-      result.device(*cpu_ctx.eigen_device()) =
-          result / static_cast<T>(vars.size());
+    // Sums all vars chunk by chunk in a single pass over the output, the
+    // chunk stays in cache while every var is added to it and the chunks
+    // are summed in parallel.
+    constexpr int64_t kChunkSize = 4096;
+    T *out_data = out_t->data<T>();
+    int64_t numel = out_t->numel();
+    int64_t num_chunks = (numel + kChunkSize - 1) / kChunkSize;
+    T num_vars = static_cast<T>(vars.size());
+#ifdef PADDLE_WITH_MKLML
+#pragma omp parallel for schedule(static) if (num_chunks > 1)
+#endif
+    for (int64_t c = 0; c < num_chunks; ++c) {
+      int64_t begin = c * kChunkSize;
+      int64_t size = std::min(kChunkSize, numel - begin);
+      T *out = out_data + begin;
+      std::copy(in_data[0] + begin, in_data[0] + begin + size, out);
+      for (size_t k = 1; k < in_data.size(); ++k) {
+        const T *in = in_data[k] + begin;
+        for (int64_t j = 0; j < size; ++j) {
+          out[j] += in[j];
+        }
+      }
+      if (!merge_add) {
+        for (int64_t j = 0; j < size; ++j) {
+          out[j] /= num_vars;
+        }
+      }
     }
   } else if (var0->IsType<phi::SelectedRows>()) {
     auto &slr0 = var0->Get<phi::SelectedRows>();
@@ -497,7 +644,7 @@ class AsyncCommunicator : public Communicator {
 
  protected:
   std::unordered_map<std::string,
-                     std::shared_ptr<BlockingQueue<std::shared_ptr<Variable>>>>
+                     std::shared_ptr<MpscQueue<std::shared_ptr<Variable>>>>
       send_varname_to_queue_;
   std::unique_ptr<::ThreadPool> send_threadpool_{nullptr};
 
@@ -13,6 +13,10 @@
 // limitations under the License.
 
 #include "paddle/fluid/distributed/ps/service/ps_local_client.h"
+
+#include <algorithm>
+#include <vector>
+
 #include "paddle/fluid/distributed/ps/table/table.h"
 
 namespace paddle::distributed {
@@ -224,6 +228,36 @@ int32_t PsLocalClient::Initialize() {
   return done();
 }
 
+::std::future<int32_t> PsLocalClient::PullSparse(float** select_values,
+                                                 size_t table_id,
+                                                 const uint64_t* keys,
+                                                 size_t num,
+                                                 bool is_training) {
+  // Selects the values the same way as the brpc server does.
+  auto* accessor = GetTableAccessor(table_id);
+  auto* table_ptr = GetTable(table_id);
+  size_t select_dim = accessor->GetAccessorInfo().select_dim;
+
+  std::vector<uint64_t> feasigns(keys, keys + num);
+  std::vector<uint32_t> frequencies(num, 1);
+  PullSparseValue pull_value(feasigns, frequencies, select_dim);
+  pull_value.is_training_ = is_training;
+  std::vector<float> values(num * select_dim);
+
+  TableContext table_context;
+  table_context.value_type = Sparse;
+  table_context.pull_context.pull_value = pull_value;
+  table_context.pull_context.values = values.data();
+  table_context.num = num;
+  table_ptr->Pull(table_context);
+
+  for (size_t i = 0; i < num; ++i) {
+    std::copy_n(
+        values.data() + i * select_dim, select_dim, select_values[i]);
+  }
+  return done();
+}
+
 ::std::future<int32_t> PsLocalClient::PullSparsePtr(
     int shard_id,
     char** select_values,
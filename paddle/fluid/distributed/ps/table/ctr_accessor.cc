@@ -34,6 +34,17 @@ int CtrCommonAccessor::Initialize() {
   common_feature_value.embed_sgd_dim = _embed_sgd_rule->Dim();
   common_feature_value.embedx_dim = _config.embedx_dim();
   common_feature_value.embedx_sgd_dim = _embedx_sgd_rule->Dim();
+  _embedx_value_type = ParseCompressedValueType(
+      _config.ctr_accessor_param().embedx_value_type());
+  _embedx_sgd_compressed_dim =
+      EmbedxCompressed() ? _embedx_sgd_rule->CompressibleDim() : 0;
+  common_feature_value.embedx_w_col =
+      CompressedDim(_embedx_value_type, common_feature_value.embedx_dim);
+  common_feature_value.embedx_sgd_col =
+      CompressedDim(CompressedValueType::kBFloat16,
+                    static_cast<int>(_embedx_sgd_compressed_dim)) +
+      common_feature_value.embedx_sgd_dim -
+      static_cast<int>(_embedx_sgd_compressed_dim);
   _show_click_decay_rate = _config.ctr_accessor_param().show_click_decay_rate();
   _ssd_unseenday_threshold =
       _config.ctr_accessor_param().ssd_unseenday_threshold();
@@ -55,8 +66,47 @@ void CtrCommonAccessor::InitAccessorInfo() {
   _accessor_info.select_size = _accessor_info.select_dim * sizeof(float);
   _accessor_info.update_dim = 4 + embedx_dim;
   _accessor_info.update_size = _accessor_info.update_dim * sizeof(float);
-  _accessor_info.mf_size =
-      (embedx_dim + common_feature_value.embedx_sgd_dim) * sizeof(float);
+  _accessor_info.mf_size = (common_feature_value.embedx_w_col +
+                            common_feature_value.embedx_sgd_col) *
+                           sizeof(float);
+  VLOG(1) << "CtrCommonAccessor stores "
+          << _config.ctr_accessor_param().embedx_value_type()
+          << " embedx, " << _accessor_info.size << " bytes per feasign with "
+          << "embedx, " << _accessor_info.size - _accessor_info.mf_size
+          << " bytes without.";
+}
+
+void CtrCommonAccessor::DecodeEmbedx(const float* value,
+                                     float* embedx_w,
+                                     float* embedx_sgd) {
+  DecodeValues(_embedx_value_type,
+               value + common_feature_value.EmbedxWIndex(),
+               common_feature_value.embedx_dim,
+               embedx_w);
+  const float* sgd = value + common_feature_value.EmbedxG2SumIndex();
+  int compressed_dim = static_cast<int>(_embedx_sgd_compressed_dim);
+  DecodeValues(
+      CompressedValueType::kBFloat16, sgd, compressed_dim, embedx_sgd);
+  memcpy(embedx_sgd + compressed_dim,
+         sgd + CompressedDim(CompressedValueType::kBFloat16, compressed_dim),
+         (common_feature_value.embedx_sgd_dim - compressed_dim) *
+             sizeof(float));
+}
+
+void CtrCommonAccessor::EncodeEmbedx(const float* embedx_w,
+                                     const float* embedx_sgd,
+                                     float* value) {
+  EncodeValues(_embedx_value_type,
+               embedx_w,
+               common_feature_value.embedx_dim,
+               value + common_feature_value.EmbedxWIndex());
+  float* sgd = value + common_feature_value.EmbedxG2SumIndex();
+  int compressed_dim = static_cast<int>(_embedx_sgd_compressed_dim);
+  EncodeValues(CompressedValueType::kBFloat16, embedx_sgd, compressed_dim, sgd);
+  memcpy(sgd + CompressedDim(CompressedValueType::kBFloat16, compressed_dim),
+         embedx_sgd + compressed_dim,
+         (common_feature_value.embedx_sgd_dim - compressed_dim) *
+             sizeof(float));
 }
 
 bool CtrCommonAccessor::Shrink(float* value) {
@@ -180,9 +230,19 @@ int32_t CtrCommonAccessor::Create(float** values, size_t num) {
     _embed_sgd_rule->InitValue(value + common_feature_value.EmbedWIndex(),
                                value + common_feature_value.EmbedG2SumIndex(),
                                zero_init);
-    _embedx_sgd_rule->InitValue(value + common_feature_value.EmbedxWIndex(),
-                                value + common_feature_value.EmbedxG2SumIndex(),
-                                false);
+    if (EmbedxCompressed()) {
+      thread_local std::vector<float> embedx_w;
+      thread_local std::vector<float> embedx_sgd;
+      embedx_w.resize(common_feature_value.embedx_dim);
+      embedx_sgd.resize(common_feature_value.embedx_sgd_dim);
+      _embedx_sgd_rule->InitValue(embedx_w.data(), embedx_sgd.data(), false);
+      EncodeEmbedx(embedx_w.data(), embedx_sgd.data(), value);
+    } else {
+      _embedx_sgd_rule->InitValue(
+          value + common_feature_value.EmbedxWIndex(),
+          value + common_feature_value.EmbedxG2SumIndex(),
+          false);
+    }
   }
   return 0;
 }
@@ -213,9 +273,11 @@ int32_t CtrCommonAccessor::Select(float** select_values,
         value[common_feature_value.ClickIndex()];
     select_value[CtrCommonPullValue::EmbedWIndex()] =
         value[common_feature_value.EmbedWIndex()];
-    memcpy(select_value + CtrCommonPullValue::EmbedxWIndex(),
-           value + common_feature_value.EmbedxWIndex(),
-           embedx_dim * sizeof(float));
+    // The compressed embedx is dequantized on the fly.
+    DecodeValues(_embedx_value_type,
+                 value + common_feature_value.EmbedxWIndex(),
+                 embedx_dim,
+                 select_value + CtrCommonPullValue::EmbedxWIndex());
   }
   return 0;
 }
@@ -270,11 +332,25 @@ int32_t CtrCommonAccessor::Update(float** update_values,
         update_value + common_feature_value.EmbedG2SumIndex(),
         push_value + CtrCommonPushValue::EmbedGIndex(),
         push_show);
-    _embedx_sgd_rule->UpdateValue(
-        update_value + common_feature_value.EmbedxWIndex(),
-        update_value + common_feature_value.EmbedxG2SumIndex(),
-        push_value + CtrCommonPushValue::EmbedxGIndex(),
-        push_show);
+    if (EmbedxCompressed()) {
+      thread_local std::vector<float> embedx_w;
+      thread_local std::vector<float> embedx_sgd;
+      embedx_w.resize(common_feature_value.embedx_dim);
+      embedx_sgd.resize(common_feature_value.embedx_sgd_dim);
+      DecodeEmbedx(update_value, embedx_w.data(), embedx_sgd.data());
+      _embedx_sgd_rule->UpdateValue(
+          embedx_w.data(),
+          embedx_sgd.data(),
+          push_value + CtrCommonPushValue::EmbedxGIndex(),
+          push_show);
+      EncodeEmbedx(embedx_w.data(), embedx_sgd.data(), update_value);
+    } else {
+      _embedx_sgd_rule->UpdateValue(
+          update_value + common_feature_value.EmbedxWIndex(),
+          update_value + common_feature_value.EmbedxG2SumIndex(),
+          push_value + CtrCommonPushValue::EmbedxGIndex(),
+          push_show);
+    }
   }
   return 0;
 }
@@ -324,16 +400,58 @@ std::string CtrCommonAccessor::ParseToString(const float* v, int param) {
   auto score = ShowClickScore(show, click);
   if (score >= _config.embedx_threshold() &&
       param > common_feature_value.EmbedxWIndex()) {
-    for (auto i = common_feature_value.EmbedxWIndex();
-         i < common_feature_value.Dim();
-         ++i) {
-      os << " " << v[i];
+    if (EmbedxCompressed()) {
+      // Saved in float32, the same format as the uncompressed tables.
+      thread_local std::vector<float> embedx_w;
+      thread_local std::vector<float> embedx_sgd;
+      embedx_w.resize(common_feature_value.embedx_dim);
+      embedx_sgd.resize(common_feature_value.embedx_sgd_dim);
+      DecodeEmbedx(v, embedx_w.data(), embedx_sgd.data());
+      for (auto x : embedx_w) {
+        os << " " << x;
+      }
+      for (auto x : embedx_sgd) {
+        os << " " << x;
+      }
+    } else {
+      for (auto i = common_feature_value.EmbedxWIndex();
+           i < common_feature_value.Dim();
+           ++i) {
+        os << " " << v[i];
+      }
     }
   }
   return os.str();
 }
 
 int CtrCommonAccessor::ParseFromString(const std::string& str, float* value) {
+  if (EmbedxCompressed()) {
+    // The saved values are float32, parsed in a buffer then compressed.
+    int embedx_w_index = common_feature_value.EmbedxWIndex();
+    int embedx_dim = common_feature_value.embedx_dim;
+    thread_local std::vector<float> buffer;
+    buffer.resize(embedx_w_index + embedx_dim +
+                  common_feature_value.embedx_sgd_dim);
+    _embedx_sgd_rule->InitValue(buffer.data() + embedx_w_index,
+                                buffer.data() + embedx_w_index + embedx_dim);
+    auto ret = paddle::string::str_to_float(str.data(), buffer.data());
+    PADDLE_ENFORCE_GE(
+        ret,
+        6UL,
+        common::errors::InvalidArgument(
+            "Invalid return value. Expect more than 6. But recieved %d.",
+            ret));
+    memcpy(value,
+           buffer.data(),
+           std::min<int>(ret, embedx_w_index) * sizeof(float));
+    if (static_cast<int>(ret) <= embedx_w_index) {
+      return ret;
+    }
+    EncodeEmbedx(buffer.data() + embedx_w_index,
+                 buffer.data() + embedx_w_index + embedx_dim,
+                 value);
+    return common_feature_value.Dim();
+  }
   _embedx_sgd_rule->InitValue(value + common_feature_value.EmbedxWIndex(),
                               value + common_feature_value.EmbedxG2SumIndex());
   auto ret = paddle::string::str_to_float(str.data(), value);
@@ -20,6 +20,7 @@
 
 #include "paddle/fluid/distributed/common/registerer.h"
 #include "paddle/fluid/distributed/ps/table/accessor.h"
+#include "paddle/fluid/distributed/ps/table/depends/compressed_value.h"
 #include "paddle/fluid/distributed/ps/table/sparse_sgd_rule.h"
 #include "paddle/fluid/distributed/the_one_ps.pb.h"
 
@@ -41,8 +42,10 @@ class CtrCommonAccessor : public ValueAccessor {
        std::vector<float> embedx_w;
        std::<vector>float embedx_g2sum;
        */
+    // embedx_w and embedx_g2sum take embedx_w_col and embedx_sgd_col floats,
+    // less than embedx_dim and embedx_sgd_dim when they are compressed.
 
-    int Dim() { return 6 + embed_sgd_dim + embedx_sgd_dim + embedx_dim; }
+    int Dim() { return 6 + embed_sgd_dim + embedx_sgd_col + embedx_w_col; }
     int DimSize(size_t dim, int embedx_dim) { return sizeof(float); }
     int Size() { return Dim() * sizeof(float); }
     int SlotIndex() { return 0; }
@@ -53,7 +56,7 @@ class CtrCommonAccessor : public ValueAccessor {
     int EmbedWIndex() { return ClickIndex() + 1; }
     int EmbedG2SumIndex() { return EmbedWIndex() + 1; }
     int EmbedxWIndex() { return EmbedG2SumIndex() + embed_sgd_dim; }
-    int EmbedxG2SumIndex() { return EmbedxWIndex() + embedx_dim; }
+    int EmbedxG2SumIndex() { return EmbedxWIndex() + embedx_w_col; }
 
     float& UnseenDays(float* val) { return val[UnseenDaysIndex()]; }
     float& DeltaScore(float* val) { return val[DeltaScoreIndex()]; }
@@ -68,6 +71,8 @@ class CtrCommonAccessor : public ValueAccessor {
     int embed_sgd_dim;
     int embedx_dim;
     int embedx_sgd_dim;
+    int embedx_w_col;
+    int embedx_sgd_col;
   };
 
   struct CtrCommonPushValue {
@@ -203,6 +208,22 @@ class CtrCommonAccessor : public ValueAccessor {
   float ShowClickScore(float show, float click);
   SparseValueSGDRule* _embed_sgd_rule;
   SparseValueSGDRule* _embedx_sgd_rule;
+
+ private:
+  bool EmbedxCompressed() const {
+    return _embedx_value_type != CompressedValueType::kFloat32;
+  }
+  // Converts the embedx_w and embedx_g2sum of `value` from and to float.
+  void DecodeEmbedx(const float* value, float* embedx_w, float* embedx_sgd);
+  void EncodeEmbedx(const float* embedx_w,
+                    const float* embedx_sgd,
+                    float* value);
+
+  CompressedValueType _embedx_value_type = CompressedValueType::kFloat32;
+  // The per dimension statistics of the embedx optimizer, e.g. the moments
+  // of adam, are kept in bfloat16 when the embedx is compressed. The other
+  // ones, e.g. the beta pows, stay in float32.
+  size_t _embedx_sgd_compressed_dim = 0;
 };
 }  // namespace distributed
 }  // namespace paddle
@@ -16,6 +16,7 @@
 
 #include "glog/logging.h"
 #include "paddle/common/flags.h"
+#include "paddle/fluid/distributed/ps/table/depends/compressed_value.h"
 #include "paddle/fluid/platform/enforce.h"
 #include "paddle/utils/string/string_helper.h"
 
@@ -35,6 +36,15 @@ int CtrDymfAccessor::Initialize() {
   common_feature_value.embed_sgd_dim = _embed_sgd_rule->Dim();
   common_feature_value.embedx_dim = _config.embedx_dim();
   common_feature_value.embedx_sgd_dim = _embedx_sgd_rule->Dim();
+  // The values are read in place by the GPU PS, which only knows float32.
+  PADDLE_ENFORCE_EQ(ParseCompressedValueType(
+                        _config.ctr_accessor_param().embedx_value_type()) ==
+                        CompressedValueType::kFloat32,
+                    true,
+                    common::errors::InvalidArgument(
+                        "CtrDymfAccessor only stores a float32 embedx, but "
+                        "embedx_value_type is %s.",
+                        _config.ctr_accessor_param().embedx_value_type()));
   _show_click_decay_rate = _config.ctr_accessor_param().show_click_decay_rate();
   _ssd_unseenday_threshold =
       _config.ctr_accessor_param().ssd_unseenday_threshold();
@@ -0,0 +1,200 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#include "paddle/common/enforce.h"
+#include "paddle/fluid/distributed/common/local_random.h"
+#include "paddle/phi/common/float16.h"
+
+namespace paddle {
+namespace distributed {
+
+// How a block of values, e.g. the embedx of a feasign, is stored in the
+// float array of a feature value. The compressed blocks are packed in as
+// few floats as possible, an int8 block starts with its scale.
+enum class CompressedValueType { kFloat32, kFloat16, kBFloat16, kInt8 };
+
+inline CompressedValueType ParseCompressedValueType(const std::string& name) {
+  if (name.empty() || name == "float32") {
+    return CompressedValueType::kFloat32;
+  } else if (name == "float16") {
+    return CompressedValueType::kFloat16;
+  } else if (name == "bfloat16") {
+    return CompressedValueType::kBFloat16;
+  } else if (name == "int8") {
+    return CompressedValueType::kInt8;
+  }
+  PADDLE_THROW(common::errors::InvalidArgument(
+      "The compressed value type should be float32, float16, bfloat16 or "
+      "int8, but got %s.",
+      name));
+}
+
+// Number of floats holding `dim` values of `type`.
+inline int CompressedDim(CompressedValueType type, int dim) {
+  switch (type) {
+    case CompressedValueType::kFloat16:
+    case CompressedValueType::kBFloat16:
+      return (dim + 1) / 2;
+    case CompressedValueType::kInt8:
+      return 1 + (dim + 3) / 4;
+    default:
+      return dim;
+  }
+}
+
+// Uniform in [0, 1), the noise of the stochastic rounding.
+inline float StochasticRoundingNoise() {
+  return local_uniform_real_distribution<float>()(local_random_engine());
+}
+
+// The float16 next to `bits`, towards +inf if `up`, towards -inf otherwise.
+inline uint16_t NextFloat16Bits(uint16_t bits, bool up) {
+  bool negative = bits & 0x8000;
+  if ((bits & 0x7fff) == 0) {
+    return up ? 0x0001 : 0x8001;
+  }
+  return negative == up ? bits - 1 : bits + 1;
+}
+
+// Rounds to one of the two float16 around `x`, with the probabilities that
+// make the rounding unbiased: small updates are not all rounded away.
+inline uint16_t Float16StochasticRound(float x) {
+  phi::dtype::float16 nearest(x);
+  float y = static_cast<float>(nearest);
+  if (y == x || !std::isfinite(y)) {
+    return nearest.x;
+  }
+  phi::dtype::float16 other;
+  other.x = NextFloat16Bits(nearest.x, x > y);
+  float z = static_cast<float>(other);
+  if (!std::isfinite(z)) {
+    return nearest.x;
+  }
+  return StochasticRoundingNoise() < (x - y) / (z - y) ? other.x : nearest.x;
+}
+
+inline uint16_t BFloat16StochasticRound(float x) {
+  uint32_t bits;
+  std::memcpy(&bits, &x, sizeof(bits));
+  if (std::isfinite(x)) {
+    bits += static_cast<uint32_t>(StochasticRoundingNoise() * 65536.0f);
+  }
+  return static_cast<uint16_t>(bits >> 16);
+}
+
+inline float BFloat16ToFloat(uint16_t half) {
+  uint32_t bits = static_cast<uint32_t>(half) << 16;
+  float x;
+  std::memcpy(&x, &bits, sizeof(x));
+  return x;
+}
+
+inline void DecodeValues(CompressedValueType type,
+                         const float* src,
+                         int dim,
+                         float* dst) {
+  switch (type) {
+    case CompressedValueType::kFloat16: {
+      const auto* halves = reinterpret_cast<const uint16_t*>(src);
+      phi::dtype::float16 h;
+      for (int i = 0; i < dim; ++i) {
+        h.x = halves[i];
+        dst[i] = static_cast<float>(h);
+      }
+      return;
+    }
+    case CompressedValueType::kBFloat16: {
+      const auto* halves = reinterpret_cast<const uint16_t*>(src);
+      for (int i = 0; i < dim; ++i) {
+        dst[i] = BFloat16ToFloat(halves[i]);
+      }
+      return;
+    }
+    case CompressedValueType::kInt8: {
+      float scale = src[0];
+      const auto* q = reinterpret_cast<const int8_t*>(src + 1);
+      for (int i = 0; i < dim; ++i) {
+        dst[i] = scale * static_cast<float>(q[i]);
+      }
+      return;
+    }
+    default:
+      std::memcpy(dst, src, dim * sizeof(float));
+  }
+}
+
+// Rounds stochastically, so that the repeated small updates of the
+// optimizer accumulate in expectation like in float32.
+inline void EncodeValues(CompressedValueType type,
+                         const float* src,
+                         int dim,
+                         float* dst) {
+  switch (type) {
+    case CompressedValueType::kFloat16: {
+      auto* halves = reinterpret_cast<uint16_t*>(dst);
+      for (int i = 0; i < dim; ++i) {
+        halves[i] = Float16StochasticRound(src[i]);
+      }
+      if (dim % 2) {
+        halves[dim] = 0;
+      }
+      return;
+    }
+    case CompressedValueType::kBFloat16: {
+      auto* halves = reinterpret_cast<uint16_t*>(dst);
+      for (int i = 0; i < dim; ++i) {
+        halves[i] = BFloat16StochasticRound(src[i]);
+      }
+      if (dim % 2) {
+        halves[dim] = 0;
+      }
+      return;
+    }
+    case CompressedValueType::kInt8: {
+      // One scale per row, so that the rows of rare and frequent feasigns,
+      // whose magnitudes differ a lot, are both quantized finely.
+      float max_abs = 0;
+      for (int i = 0; i < dim; ++i) {
+        max_abs = std::max(max_abs, std::abs(src[i]));
+      }
+      float scale = max_abs / 127.0f;
+      dst[0] = scale;
+      auto* q = reinterpret_cast<int8_t*>(dst + 1);
+      std::fill(q, q + CompressedDim(type, dim) * 4 - 4, 0);
+      if (scale == 0 || !std::isfinite(scale)) {
+        dst[0] = 0;
+        return;
+      }
+      float inv_scale = 1.0f / scale;
+      for (int i = 0; i < dim; ++i) {
+        float v = std::floor(src[i] * inv_scale + StochasticRoundingNoise());
+        q[i] = static_cast<int8_t>(std::min(127.0f, std::max(-127.0f, v)));
+      }
+      return;
+    }
+    default:
+      std::memcpy(dst, src, dim * sizeof(float));
+  }
+}
+
+}  // namespace distributed
+}  // namespace paddle
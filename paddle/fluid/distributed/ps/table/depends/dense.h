@@ -30,11 +30,16 @@ namespace distributed {
 
 // dense optimizer
 // TODO(tangwei12) integrate with sparse optimizer later.
+// The table calls BeginUpdate once per pushed gradient, then Update on the
+// disjoint ranges [begin, end) of its shards in parallel, so the state
+// shared by all the elements is only updated in BeginUpdate. Every rule
+// reads and writes its arrays in a single fused loop.
 class DenseOptimizer {
  public:
   DenseOptimizer() {}
   explicit DenseOptimizer(const CommonAccessorParameter& accessor,
                           std::vector<std::vector<float>>* values) {}
+  virtual void BeginUpdate() {}
   virtual void Update(const float* update_values,
                       size_t num,
                       int begin,
@@ -62,9 +67,9 @@ class DSUM : public DenseOptimizer {
               size_t num,
               int begin,
               int end) override {
-    auto update_numel = end - begin;
-    GetBlas<float>().VADD(
-        update_numel, update_values + begin, param + begin, param + begin);
+    for (int i = begin; i < end; ++i) {
+      param[i] += update_values[i];
+    }
   }
 
   float* param;
@@ -90,15 +95,10 @@ class DSGD : public DenseOptimizer {
               size_t num,
               int begin,
               int end) override {
-    auto update_numel = end - begin;
-    std::vector<float> grads;
-    grads.resize(update_numel);
-
-    auto blas = GetBlas<float>();
     float lr = *(global_learning_rate_) * (*learning_rate);
-    blas.VCOPY(update_numel, update_values + begin, grads.data());
-    blas.SCAL(update_numel, lr, grads.data());
-    blas.VSUB(update_numel, param + begin, grads.data(), param + begin);
+    for (int i = begin; i < end; ++i) {
+      param[i] -= lr * update_values[i];
+    }
   }
 
   float* learning_rate;
@@ -106,7 +106,6 @@ class DSGD : public DenseOptimizer {
 };
 
 // adam optimizer for dense tensor
-// TODO(zhaocaibei123): add CHECK(memory_dense_table.task_pool_size_) == 1
 class DAdam : public DenseOptimizer {
  public:
   explicit DAdam(const CommonAccessorParameter& accessor,
@@ -139,46 +138,27 @@ class DAdam : public DenseOptimizer {
     epsilon = 1.0e-8;
   }
 
-  // make sure memory_dense_table.task_pool_size_ == 1;
-  // otherwise, task_pool_size_ times beta1_pow/beta2_pow multiplication
-  void Update(const float* update_values,
-              size_t num,
-              int begin,
-              int end) override {
-    auto update_numel = end - begin;
-    std::vector<float> grad, grad2, tmp;
-    grad.resize(update_numel);
-    grad2.resize(update_numel);
-    tmp.resize(update_numel);
-
-    auto blas = GetBlas<float>();
-    blas.VCOPY(update_numel, update_values + begin, grad.data());
-    blas.VCOPY(update_numel, update_values + begin, grad2.data());
-
-    blas.SCAL(update_numel, 1 - beta1, grad.data());
-    blas.VSQUARE(update_numel, grad2.data(), grad2.data());
-    blas.SCAL(update_numel, 1 - beta2, grad2.data());
-
-    blas.SCAL(update_numel, beta1, moment1 + begin);
-    blas.VADD(update_numel, moment1 + begin, grad.data(), moment1 + begin);
-    blas.SCAL(update_numel, beta2, moment2 + begin);
-    blas.VADD(update_numel, moment2 + begin, grad2.data(), moment2 + begin);
-
+  // The powers of the betas are advanced once per pushed gradient, not once
+  // per shard.
+  void BeginUpdate() override {
     beta1_pow[0] = beta1_pow[0] * beta1;
     beta2_pow[0] = beta2_pow[0] * beta2;
 
-    float lr_ = *(global_learning_rate_)*learning_rate[0];
+    lr_ = *(global_learning_rate_)*learning_rate[0];
     lr_ *= sqrt(1 - beta2_pow[0]) / (1 - beta1_pow[0]);
+    eps_ = epsilon * sqrt(1 - beta2_pow[0]);
+  }
 
-    float* tmp_ = tmp.data();
-    float eps_ = epsilon * sqrt(1 - beta2_pow[0]);
-
-    SQRT<float>(update_numel, moment2 + begin, tmp_);
-    ADD<float>(update_numel, tmp_, eps_, tmp_);
-
-    blas.VDIV(update_numel, moment1 + begin, tmp_, tmp_);
-    blas.SCAL(update_numel, lr_, tmp_);
-    blas.VSUB(update_numel, param + begin, tmp_, param + begin);
+  void Update(const float* update_values,
+              size_t num,
+              int begin,
+              int end) override {
+    for (int i = begin; i < end; ++i) {
+      float g = update_values[i];
+      moment1[i] = beta1 * moment1[i] + (1 - beta1) * g;
+      moment2[i] = beta2 * moment2[i] + (1 - beta2) * g * g;
+      param[i] -= lr_ * moment1[i] / (sqrtf(moment2[i]) + eps_);
+    }
   }
 
   float* learning_rate;
@@ -193,6 +173,10 @@ class DAdam : public DenseOptimizer {
   float beta1;
   float beta2;
   float epsilon;
+
+  // Of the current update, set by BeginUpdate.
+  float lr_ = 0;
+  float eps_ = 0;
 };
 
 // adam optimizer for dense tensor
@@ -227,36 +211,22 @@ class DAdamD2Sum : public DenseOptimizer {
               size_t num,
               int begin,
               int end) override {
-    auto update_numel = end - begin;
-    Eigen::Map<Eigen::MatrixXf> mat_ada_g2sum(
-        ada_g2sum + begin, 1, update_numel);
-
-    Eigen::Map<Eigen::MatrixXf> mat_ada_d2sum(
-        ada_d2sum + begin, 1, update_numel);
-    Eigen::Map<Eigen::MatrixXf> mat_mom_velocity(
-        mom_velocity + begin, 1, update_numel);
-    Eigen::Map<Eigen::MatrixXf> mat_w(param + begin, 1, update_numel);
-
-    Eigen::Map<const Eigen::MatrixXf> mat_grad(
-        update_values + begin, 1, update_numel);
-
-    mat_ada_d2sum = (mat_ada_d2sum * ada_decay_rate[0]).array() + 1;
-    mat_ada_g2sum =
-        (mat_ada_g2sum * ada_decay_rate[0]) + mat_grad.cwiseProduct(mat_grad);
-
-    thread_local std::vector<float> scale_vec;
-    scale_vec.resize(update_numel);
-    Eigen::Map<Eigen::MatrixXf> scale(scale_vec.data(), 1, update_numel);
-    memcpy(
-        scale_vec.data(), mat_ada_d2sum.data(), sizeof(float) * update_numel);
-
-    scale = scale.array() * ada_epsilon[0];
-    scale = (mat_ada_d2sum + scale).cwiseQuotient(mat_ada_g2sum + scale);
-    scale = scale.cwiseSqrt();
-    mat_mom_velocity =
-        (mat_mom_velocity + mat_grad) * mom_decay_rate[0] - mat_grad;
-
-    mat_w += learning_rate[0] * mat_mom_velocity.cwiseProduct(scale);
+    float ada_decay = ada_decay_rate[0];
+    float mom_decay = mom_decay_rate[0];
+    float epsilon = ada_epsilon[0];
+    float lr = learning_rate[0];
+    for (int i = begin; i < end; ++i) {
+      float g = update_values[i];
+      float d2sum = ada_d2sum[i] * ada_decay + 1;
+      float g2sum = ada_g2sum[i] * ada_decay + g * g;
+      ada_d2sum[i] = d2sum;
+      ada_g2sum[i] = g2sum;
+      float eps = d2sum * epsilon;
+      float scale = sqrtf((d2sum + eps) / (g2sum + eps));
+      float mom = (mom_velocity[i] + g) * mom_decay - g;
+      mom_velocity[i] = mom;
+      param[i] += lr * mom * scale;
+    }
   }
 
   float* learning_rate;
@@ -291,11 +261,10 @@ class DSummary : public DenseOptimizer {
               size_t num,
               int begin,
               int end) override {
-    auto update_numel = end - begin;
-    Eigen::Map<Eigen::MatrixXf> mat_w(param + begin, 1, update_numel);
-    Eigen::Map<const Eigen::MatrixXf> mat_grad(
-        update_values + begin, 1, update_numel);
-    mat_w = mat_w * summary_decay_rate_d + mat_grad;
+    auto decay_rate = static_cast<float>(summary_decay_rate_d);
+    for (int i = begin; i < end; ++i) {
+      param[i] = param[i] * decay_rate + update_values[i];
+    }
   }
 
   float* summary_decay_rate;
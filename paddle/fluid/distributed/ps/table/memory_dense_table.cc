@@ -14,7 +14,12 @@
 
 #include "paddle/fluid/distributed/ps/table/memory_dense_table.h"
 
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+
 #include "paddle/fluid/platform/enforce.h"
+#include "paddle/phi/core/scope_guard.h"
 
 namespace paddle::distributed {
 
@@ -49,10 +54,56 @@ int32_t MemoryDenseTable::Initialize() {
   _global_lr = new float(1.0);
 
   InitializeValue();
+  InitializeShardRanges();
   InitializeOptimizer();
   return 0;
 }
 
+void MemoryDenseTable::InitializeShardRanges() {
+  // Floats per cache line of 64 bytes.
+  constexpr int kLineSize = 16;
+  shard_ranges_.assign(task_pool_size_ + 1, 0);
+  if (param_dim_ <= 0) {
+    return;
+  }
+  auto address = reinterpret_cast<uintptr_t>(values_[param_idx_].data());
+  int head = static_cast<int>(
+      (kLineSize - address / sizeof(float) % kLineSize) % kLineSize);
+  head = std::min(head, param_dim_);
+  int num_lines = (param_dim_ - head + kLineSize - 1) / kLineSize;
+  std::vector<int> line_buckets = bucket(num_lines, task_pool_size_);
+  for (int i = 1; i < task_pool_size_; ++i) {
+    shard_ranges_[i] =
+        std::min(param_dim_, head + line_buckets[i] * kLineSize);
+  }
+  shard_ranges_[task_pool_size_] = param_dim_;
+}
+
+std::shared_ptr<std::vector<float>> MemoryDenseTable::NewParamSnapshot() {
+  std::unique_ptr<std::vector<float>> buffer;
+  {
+    std::lock_guard<std::mutex> lock(snapshot_mutex_);
+    buffer = std::move(spare_snapshot_);
+  }
+  if (buffer == nullptr) {
+    buffer = std::make_unique<std::vector<float>>();
+  }
+  buffer->resize(param_dim_);
+  return std::shared_ptr<std::vector<float>>(
+      buffer.release(), [this](std::vector<float> *released) {
+        std::lock_guard<std::mutex> lock(snapshot_mutex_);
+        spare_snapshot_.reset(released);
+      });
+}
+
+void MemoryDenseTable::PublishParamSnapshot() {
+  auto snapshot = NewParamSnapshot();
+  if (param_dim_ > 0) {
+    std::copy_n(values_[param_idx_].begin(), param_dim_, snapshot->begin());
+  }
+  std::atomic_store(&param_snapshot_, snapshot);
+}
+
 int32_t MemoryDenseTable::InitializeValue() {
   auto common = _config.common();
   int size = static_cast<int>(common.params().size());
@@ -95,6 +146,9 @@ int32_t MemoryDenseTable::InitializeValue() {
           << " fixed_len_params_dim: " << fixed_len_params_dim_;
 
   pull_reservoir_ = ReservoirValue<float>(param_dim_);
+  merged_grad_.resize(param_dim_);
+  applying_grad_.resize(param_dim_);
+  PublishParamSnapshot();
   return 0;
 }
 
@@ -154,8 +208,9 @@ int32_t MemoryDenseTable::Push(TableContext &context) {
 }
 
 int32_t MemoryDenseTable::PullDense(float *pull_values, size_t num) {
-  std::copy(
-      values_[param_idx_].begin(), values_[param_idx_].end(), pull_values);
+  // Never sees a param half updated by a push.
+  auto snapshot = std::atomic_load(&param_snapshot_);
+  std::copy(snapshot->begin(), snapshot->end(), pull_values);
   return 0;
 }
 
@@ -165,7 +220,9 @@ int32_t MemoryDenseTable::PushDenseParam(const float *values, size_t num) {
       param_dim_,
       common::errors::InvalidArgument(
           "update dense param numel expected %d, but got %d", param_dim_, num));
+  std::lock_guard<std::mutex> lock(update_mutex_);
   std::copy_n(values, param_dim_, values_[param_idx_].begin());
+  PublishParamSnapshot();
   return 0;
 }
 
@@ -184,8 +241,51 @@ int32_t MemoryDenseTable::PushDense(const float *values, size_t num) {
           return 0;
         });
     task.wait();
+    return 0;
+  }
+
+  PADDLE_ENFORCE_GE(
+      num,
+      param_dim_,
+      common::errors::InvalidArgument(
+          "update dense numel expected %d, but got %d", param_dim_, num));
+  std::unique_lock<std::mutex> lock(merge_mutex_);
+  uint64_t batch = merging_batch_;
+  if (num_merged_ == 0) {
+    std::copy_n(values, param_dim_, merged_grad_.begin());
   } else {
-    _PushDense(values, num);
+    float *merged = merged_grad_.data();
+    for (int i = 0; i < param_dim_; ++i) {
+      merged[i] += values[i];
+    }
+  }
+  ++num_merged_;
+  if (applying_) {
+    merge_cond_.wait(lock, [this, batch] { return applied_batch_ >= batch; });
+    return 0;
+  }
+
+  applying_ = true;
+  // If an update throws, the next push applies the gradients merged since,
+  // and the threads waiting for the failed batch are released.
+  DEFINE_PADDLE_SCOPE_GUARD([this, &lock] {
+    if (!lock.owns_lock()) {
+      lock.lock();
+      applied_batch_ = merging_batch_ - 1;
+      merge_cond_.notify_all();
+    }
+    applying_ = false;
+  });
+  while (num_merged_ > 0) {
+    merged_grad_.swap(applying_grad_);
+    VLOG(3) << "MemoryDenseTable push " << num_merged_ << " merged gradients";
+    num_merged_ = 0;
+    uint64_t applying_batch = merging_batch_++;
+    lock.unlock();
+    _PushDense(applying_grad_.data(), applying_grad_.size());
+    lock.lock();
+    applied_batch_ = applying_batch;
+    merge_cond_.notify_all();
   }
   return 0;
 }
@@ -197,15 +297,22 @@ int32_t MemoryDenseTable::_PushDense(const float *values, size_t num) {
       common::errors::InvalidArgument(
           "update dense numel expected %d, but got %d", param_dim_, num));
 
-  std::vector<int> buckets = bucket(param_dim_, task_pool_size_);
+  std::lock_guard<std::mutex> lock(update_mutex_);
+  optimizer_->BeginUpdate();
+  auto snapshot = NewParamSnapshot();
+  const float *param = values_[param_idx_].data();
+  float *snapshot_data = snapshot->data();
   std::vector<std::future<int>> tasks(task_pool_size_);
 
   for (int shard_id = 0; shard_id < task_pool_size_; ++shard_id) {
     tasks[shard_id] = _shards_task_pool[shard_id]->enqueue(
-        [this, shard_id, &buckets, &values]() -> int {
-          auto begin = buckets[shard_id];
-          auto end = buckets[shard_id + 1];
-          optimizer_->Update(values, param_dim_, begin, end);
+        [this, shard_id, values, param, snapshot_data]() -> int {
+          auto begin = shard_ranges_[shard_id];
+          auto end = shard_ranges_[shard_id + 1];
+          if (begin < end) {
+            optimizer_->Update(values, param_dim_, begin, end);
+            std::copy(param + begin, param + end, snapshot_data + begin);
+          }
           return 0;
         });
   }
@@ -213,6 +320,7 @@ int32_t MemoryDenseTable::_PushDense(const float *values, size_t num) {
   for (auto &task : tasks) {
     task.wait();
   }
+  std::atomic_store(&param_snapshot_, snapshot);
   VLOG(2) << "debug MemoryDenseTable::_push_dense done";
   return 0;
 }
@@ -324,6 +432,7 @@ int32_t MemoryDenseTable::Load(const std::string &path,
                  << channel_config.path;
     }
   } while (is_read_failed);
+  PublishParamSnapshot();
   return 0;
 }
 
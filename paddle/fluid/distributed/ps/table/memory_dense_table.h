@@ -18,7 +18,12 @@
 #include <assert.h>
 #include <pthread.h>
 
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <vector>
 
 #include "Eigen/Dense"
 #include "paddle/common/enforce.h"
@@ -68,13 +73,44 @@ class MemoryDenseTable : public Table {
   int32_t _PushDense(const float* values, size_t num);
 
  private:
+  // Splits [0, param_dim_) into one range per shard task, the boundaries
+  // fall on cache lines of the param so that no two tasks write the same
+  // line.
+  void InitializeShardRanges();
+  // A buffer of param_dim_ floats for the next snapshot, the buffer goes
+  // back to spare_snapshot_ when the last pull holding it is done.
+  std::shared_ptr<std::vector<float>> NewParamSnapshot();
+  void PublishParamSnapshot();
+
   const int task_pool_size_ = 10;
   bool sync = true;
   std::vector<std::shared_ptr<::ThreadPool>> _shards_task_pool;
+  std::vector<int> shard_ranges_;
   int param_dim_ = 0;
   int param_idx_ = 0;
   std::shared_ptr<DenseOptimizer> optimizer_;
   std::vector<std::vector<float>> values_;
+  // Serializes the updates of values_.
+  std::mutex update_mutex_;
+
+  // The gradients pushed while an update runs are summed here and applied
+  // at once by the pushing thread that runs the update, the other pushing
+  // threads wait until the batch they joined is applied.
+  std::mutex merge_mutex_;
+  std::condition_variable merge_cond_;
+  std::vector<float> merged_grad_;
+  std::vector<float> applying_grad_;
+  int num_merged_ = 0;
+  bool applying_ = false;
+  uint64_t merging_batch_ = 1;
+  uint64_t applied_batch_ = 0;
+
+  // The param after the last update, the pulls copy it while the next
+  // update writes the spare buffer.
+  std::mutex snapshot_mutex_;
+  std::unique_ptr<std::vector<float>> spare_snapshot_;
+  std::shared_ptr<std::vector<float>> param_snapshot_;
+
   ReservoirValue<float> pull_reservoir_;
   std::unordered_map<std::string, Initializer*> initializers_;
   std::unordered_map<std::string, int> names_index_;
@@ -41,6 +41,9 @@ class SparseValueSGDRule {
                                float scale) = 0;
   virtual void InitValueWork(float* value, float* sgd, bool zero_init) = 0;
   virtual size_t Dim() = 0;
+  // Number of leading floats of the state that are statistics of each
+  // dimension, which tolerate a reduced precision.
+  virtual size_t CompressibleDim() { return 0; }
   const std::string& GetName() const { return _name; }
   void InitValue(float* value, float* sgd, bool zero_init = true) {
     InitValueWork(value, sgd, zero_init);
@@ -136,6 +139,7 @@ class StdAdaGradSGDRule : public SparseValueSGDRule {
                                float scale);
   virtual void InitValueWork(float* value, float* sgd, bool zero_init);
   virtual size_t Dim() { return _embedding_dim; }
+  virtual size_t CompressibleDim() { return _embedding_dim; }
   size_t G2SumIndex() { return 0; }
 
  private:
@@ -153,6 +157,7 @@ class SparseAdamSGDRule : public SparseValueSGDRule {
                                float scale);
   virtual void InitValueWork(float* value, float* sgd, bool zero_init);
   virtual size_t Dim() { return _embedding_dim * 2 + 2; }
+  virtual size_t CompressibleDim() { return _embedding_dim * 2; }
   size_t GSumIndex() { return 0; }
   size_t G2SumIndex() { return GSumIndex() + _embedding_dim; }
   size_t Beta1PowIndex() { return G2SumIndex() + _embedding_dim; }
@@ -0,0 +1,332 @@
+/* Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include "paddle/fluid/distributed/ps/service/communicator/communicator.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "paddle/fluid/distributed/ps/service/env.h"
+#include "paddle/fluid/distributed/ps/service/ps_client.h"
+#include "paddle/fluid/distributed/the_one_ps.pb.h"
+
+namespace paddle::distributed {
+
+template <typename Queue>
+double PushAndPop(Queue *queue, int num_producers, int num_per_producer) {
+  auto start = std::chrono::steady_clock::now();
+  std::vector<std::thread> producers;
+  for (int p = 0; p < num_producers; ++p) {
+    producers.emplace_back([queue, p, num_per_producer] {
+      for (int i = 0; i < num_per_producer; ++i) {
+        queue->Push(std::make_shared<int>(p * num_per_producer + i));
+      }
+    });
+  }
+  for (int i = 0; i < num_producers * num_per_producer; ++i) {
+    queue->Pop();
+  }
+  for (auto &producer : producers) {
+    producer.join();
+  }
+  return std::chrono::duration<double, std::milli>(
+             std::chrono::steady_clock::now() - start)
+      .count();
+}
+
+TEST(MpscQueue, many_producers) {
+  int num_producers = 4;
+  int num_per_producer = 10000;
+  MpscQueue<std::shared_ptr<int>> queue(16);
+  std::vector<std::thread> producers;
+  for (int p = 0; p < num_producers; ++p) {
+    producers.emplace_back([&queue, p, num_per_producer] {
+      for (int i = 0; i < num_per_producer; ++i) {
+        queue.Push(std::make_shared<int>(p * num_per_producer + i));
+      }
+    });
+  }
+
+  // Every element is popped once, in the order of its producer.
+  std::vector<int> next(num_producers, 0);
+  std::vector<std::shared_ptr<int>> batch;
+  int num_popped = 0;
+  while (num_popped < num_producers * num_per_producer) {
+    batch.clear();
+    // Only the published elements are counted, so they can all be taken.
+    size_t size = queue.Size();
+    size_t num = queue.PopBatch(8, &batch);
+    EXPECT_GE(num, std::min<size_t>(size, 8));
+    if (num == 0) {
+      batch.push_back(queue.Pop());
+    }
+    EXPECT_LE(batch.size(), 8u);
+    for (auto &elem : batch) {
+      int p = *elem / num_per_producer;
+      ASSERT_EQ(*elem % num_per_producer, next[p]);
+      ++next[p];
+    }
+    num_popped += static_cast<int>(batch.size());
+  }
+  for (auto &producer : producers) {
+    producer.join();
+  }
+  EXPECT_EQ(queue.Size(), 0u);
+}
+
+TEST(MergeVars, dense) {
+  std::vector<std::shared_ptr<Variable>> vars;
+  int64_t numel = 10000;
+  for (int k = 0; k < 3; ++k) {
+    vars.push_back(std::make_shared<Variable>());
+    auto *tensor = vars.back()->GetMutable<phi::DenseTensor>();
+    float *data = tensor->mutable_data<float>({numel}, phi::CPUPlace());
+    for (int64_t i = 0; i < numel; ++i) {
+      data[i] = static_cast<float>(k + i);
+    }
+  }
+  Scope scope;
+  for (bool merge_add : {true, false}) {
+    MergeVars<float>("out", vars, &scope, merge_add);
+    const float *out =
+        scope.FindVar("out")->Get<phi::DenseTensor>().data<float>();
+    for (int64_t i = 0; i < numel; ++i) {
+      float sum = static_cast<float>(3 + 3 * i);
+      ASSERT_EQ(out[i], merge_add ? sum : sum / 3);
+    }
+  }
+}
+
+// Many trainer threads pushing the gradients of one variable to its queue.
+TEST(DISABLED_MpscQueue, benchmark_against_blocking_queue) {
+  int num_producers =
+      std::max(2, static_cast<int>(std::thread::hardware_concurrency()));
+  int num_per_producer = 100000;
+  BlockingQueue<std::shared_ptr<int>> blocking_queue(20);
+  MpscQueue<std::shared_ptr<int>> mpsc_queue(20);
+  double blocking_ms =
+      PushAndPop(&blocking_queue, num_producers, num_per_producer);
+  double mpsc_ms = PushAndPop(&mpsc_queue, num_producers, num_per_producer);
+  LOG(INFO) << num_producers << " producers pushing " << num_per_producer
+            << " elements each: " << blocking_ms << "ms with BlockingQueue, "
+            << mpsc_ms << "ms with MpscQueue.";
+}
+
+const int kDenseTableId = 0;
+const int kSparseTableId = 1;
+const int64_t kDenseDim = 1 << 16;
+const int kEmbedxDim = 8;
+
+void GetDenseTableProto(TableParameter *table_proto) {
+  table_proto->set_table_id(kDenseTableId);
+  table_proto->set_table_class("MemoryDenseTable");
+  table_proto->set_shard_num(1);
+  auto *accessor_config = table_proto->mutable_accessor();
+  accessor_config->set_accessor_class("CommMergeAccessor");
+  accessor_config->set_fea_dim(kDenseDim);
+  auto *common_config = table_proto->mutable_common();
+  common_config->set_name("sgd");
+  common_config->set_table_name("dense_table");
+  common_config->set_trainer_num(1);
+  common_config->set_sync(false);
+  common_config->add_params("Param");
+  common_config->add_dims(kDenseDim);
+  common_config->add_initializers("fill_constant&0.0");
+  common_config->add_params("LearningRate");
+  common_config->add_dims(1);
+  common_config->add_initializers("fill_constant&1.0");
+}
+
+void GetSparseTableProto(TableParameter *table_proto) {
+  table_proto->set_table_id(kSparseTableId);
+  table_proto->set_table_class("MemorySparseTable");
+  table_proto->set_shard_num(10);
+  auto *accessor_config = table_proto->mutable_accessor();
+  accessor_config->set_accessor_class("SparseAccessor");
+  accessor_config->set_fea_dim(kEmbedxDim + 1);
+  accessor_config->set_embedx_dim(kEmbedxDim);
+  accessor_config->set_embedx_threshold(0);
+  for (auto *sgd_param : {accessor_config->mutable_embed_sgd_param(),
+                          accessor_config->mutable_embedx_sgd_param()}) {
+    sgd_param->set_name("SparseNaiveSGDRule");
+    auto *naive_param = sgd_param->mutable_naive();
+    naive_param->set_learning_rate(0.1);
+    naive_param->set_initial_range(0.3);
+    naive_param->add_weight_bounds(-10.0);
+    naive_param->add_weight_bounds(10.0);
+  }
+}
+
+// PsLocalClient holds the tables in the process, so that the benchmark
+// measures the communicator and not the network.
+PSParameter GetLocalPSProto() {
+  PSParameter ps_param;
+  auto *server_proto = ps_param.mutable_server_param();
+  auto *downpour_server_proto = server_proto->mutable_downpour_server_param();
+  downpour_server_proto->mutable_service_param()->set_client_class(
+      "PsLocalClient");
+  auto *downpour_worker_proto =
+      ps_param.mutable_worker_param()->mutable_downpour_worker_param();
+  GetDenseTableProto(downpour_server_proto->add_downpour_table_param());
+  GetSparseTableProto(downpour_server_proto->add_downpour_table_param());
+  GetDenseTableProto(downpour_worker_proto->add_downpour_table_param());
+  GetSparseTableProto(downpour_worker_proto->add_downpour_table_param());
+  return ps_param;
+}
+
+class LocalAsyncCommunicator : public AsyncCommunicator {
+ public:
+  explicit LocalAsyncCommunicator(
+      const std::map<std::string, std::string> &envs)
+      : AsyncCommunicator(envs) {}
+
+  size_t NumQueued() const {
+    size_t num = 0;
+    for (auto &iter : send_varname_to_queue_) {
+      num += iter.second->Size();
+    }
+    return num;
+  }
+};
+
+// Send thread throughput of trainers pushing a dense and a sparse gradient
+// per step to a PsLocalClient.
+TEST(DISABLED_AsyncCommunicator, benchmark_local_client) {
+  PSParameter ps_param = GetLocalPSProto();
+  std::shared_ptr<PSClient> client(PSClientFactory::Create(ps_param));
+  ASSERT_NE(client, nullptr);
+  PaddlePSEnvironment ps_env;
+  std::map<uint64_t, std::vector<Region>> regions;
+  ASSERT_EQ(client->Configure(ps_param, regions, ps_env, 0), 0);
+  int sparse_width = static_cast<int>(
+      client->GetTableAccessor(kSparseTableId)->GetAccessorInfo().update_dim);
+
+  std::map<std::string, std::string> envs = {
+      {"communicator_independent_recv_thread", "0"},
+      {"communicator_min_send_grad_num_before_recv", "1"},
+      {"communicator_thread_pool_size", "2"},
+      {"communicator_max_merge_var_num", "20"},
+      {"communicator_send_wait_times", "1"},
+      {"communicator_send_queue_size", "20"},
+      {"need_global_step", "0"}};
+  LocalAsyncCommunicator communicator(envs);
+  communicator.InitEnvs();
+  communicator._worker_ptr = client;
+  RpcCtxMap send_ctx;
+  send_ctx["dense@GRAD"] = CommContext("dense@GRAD",
+                                       {"dense@GRAD"},
+                                       {"127.0.0.1:0"},
+                                       {kDenseDim},
+                                       {"dense@GRAD"},
+                                       0,
+                                       true,
+                                       false,
+                                       false,
+                                       kDenseTableId);
+  send_ctx["sparse@GRAD"] = CommContext("sparse@GRAD",
+                                        {"sparse@GRAD"},
+                                        {"127.0.0.1:0"},
+                                        {1000000},
+                                        {"sparse@GRAD"},
+                                        0,
+                                        true,
+                                        true,
+                                        false,
+                                        kSparseTableId);
+  Scope recv_scope;
+  communicator.InitImpl(send_ctx, RecvCtxMap(), &recv_scope);
+
+  int num_trainers =
+      std::max(2, static_cast<int>(std::thread::hardware_concurrency()));
+  int num_steps = 200;
+  int64_t num_ids = 1024;
+  std::vector<std::unique_ptr<Scope>> scopes;
+  for (int t = 0; t < num_trainers; ++t) {
+    scopes.push_back(std::make_unique<Scope>());
+    auto *dense =
+        scopes.back()->Var("dense@GRAD")->GetMutable<phi::DenseTensor>();
+    float *dense_data =
+        dense->mutable_data<float>({kDenseDim}, phi::CPUPlace());
+    std::fill(dense_data, dense_data + kDenseDim, 1.0f);
+
+    auto *sparse =
+        scopes.back()->Var("sparse@GRAD")->GetMutable<phi::SelectedRows>();
+    std::mt19937_64 rng(t);
+    std::uniform_int_distribution<int64_t> id_dist(0, 1000000 - 1);
+    std::vector<int64_t> rows(num_ids);
+    for (auto &row : rows) {
+      row = id_dist(rng);
+    }
+    sparse->set_rows(rows);
+    sparse->set_height(1000000);
+    float *sparse_data = sparse->mutable_value()->mutable_data<float>(
+        {num_ids, sparse_width}, phi::CPUPlace());
+    for (int64_t i = 0; i < num_ids; ++i) {
+      float *value = sparse_data + i * sparse_width;
+      // slot, show, click and the gradients.
+      value[0] = 0;
+      value[1] = 1;
+      value[2] = 0;
+      std::fill(value + 3, value + sparse_width, 0.01f);
+    }
+  }
+
+  std::atomic<int> num_running{num_trainers};
+  auto start = std::chrono::steady_clock::now();
+  std::thread sender([&] {
+    while (num_running > 0 || communicator.NumQueued() > 0) {
+      communicator.SendByCommunicator();
+    }
+  });
+  std::vector<std::thread> trainers;
+  for (int t = 0; t < num_trainers; ++t) {
+    trainers.emplace_back([&, t] {
+      for (int step = 0; step < num_steps; ++step) {
+        communicator.Send({"dense@GRAD", "sparse@GRAD"}, *scopes[t]);
+      }
+      --num_running;
+    });
+  }
+  for (auto &trainer : trainers) {
+    trainer.join();
+  }
+  sender.join();
+  double ms = std::chrono::duration<double, std::milli>(
+                  std::chrono::steady_clock::now() - start)
+                  .count();
+
+  // The merged gradients sum to one per step and trainer, whatever the
+  // batches taken by the send thread.
+  std::vector<float> param(kDenseDim);
+  Region region(param.data(), param.size());
+  client->PullDense(&region, 1, kDenseTableId).wait();
+  EXPECT_EQ(param[0], -static_cast<float>(num_trainers * num_steps));
+  EXPECT_EQ(param[kDenseDim - 1],
+            -static_cast<float>(num_trainers * num_steps));
+  LOG(INFO) << num_trainers << " trainers sent " << num_steps
+            << " steps of a dense gradient of " << kDenseDim
+            << " floats and a sparse gradient of " << num_ids
+            << " ids in " << ms << "ms, "
+            << num_trainers * num_steps * 1000.0 / ms << " steps/s.";
+}
+
+}  // namespace paddle::distributed
@@ -14,6 +14,9 @@ limitations under the License. */
 
 #include <ThreadPool.h>
 
+#include <atomic>
+#include <cmath>
+#include <thread>  // NOLINT
 #include <vector>
 
 #include "gtest/gtest.h"
@@ -226,4 +229,150 @@ TEST(MemoryDenseTable, SGD) {
   }
 }
 
+// MemoryDenseTable + Adam, the param is split in shards updated in parallel
+TEST(MemoryDenseTable, AdamShards) {
+  int fea_dim = 1000;
+  float lr = 0.01;
+
+  TableParameter table_config;
+  table_config.set_table_class("MemoryDenseTable");
+  FsClientParameter fs_config;
+  Table *table = new MemoryDenseTable();
+  TableAccessorParameter *accessor_config = table_config.mutable_accessor();
+  accessor_config->set_accessor_class("CommMergeAccessor");
+  CommonAccessorParameter *common_config = table_config.mutable_common();
+  common_config->set_name("adam");
+  common_config->set_table_name("adam_shards_test_table");
+  common_config->set_trainer_num(1);
+  common_config->add_params("Param");
+  common_config->add_dims(fea_dim);
+  common_config->add_initializers("fill_constant&1.0");
+  for (auto *name : {"Moment1", "Moment2"}) {
+    common_config->add_params(name);
+    common_config->add_dims(fea_dim);
+    common_config->add_initializers("fill_constant&0.0");
+  }
+  for (auto *name : {"Beta1Pow", "Beta2Pow"}) {
+    common_config->add_params(name);
+    common_config->add_dims(1);
+    common_config->add_initializers("fill_constant&1.0");
+  }
+  common_config->add_params("LearningRate");
+  common_config->add_dims(1);
+  common_config->add_initializers("fill_constant&0.01");
+  auto ret = table->Initialize(table_config, fs_config);
+  ASSERT_EQ(ret, 0);
+
+  std::vector<float> param(fea_dim, 1.0), moment1(fea_dim, 0.0),
+      moment2(fea_dim, 0.0);
+  float beta1_pow = 1.0, beta2_pow = 1.0;
+  for (int step = 0; step < 3; ++step) {
+    std::vector<float> grad(fea_dim);
+    for (int j = 0; j < fea_dim; ++j) {
+      grad[j] = static_cast<float>((j + step) % 7) - 3.0f;
+    }
+    TableContext table_context;
+    table_context.value_type = Dense;
+    table_context.push_context.values = grad.data();
+    table_context.num = grad.size();
+    table->Push(table_context);
+
+    // The powers of the betas advance once per push, whatever the shards.
+    beta1_pow *= 0.9;
+    beta2_pow *= 0.999;
+    float lr_t = lr * sqrt(1 - beta2_pow) / (1 - beta1_pow);
+    float eps_t = 1.0e-8 * sqrt(1 - beta2_pow);
+    for (int j = 0; j < fea_dim; ++j) {
+      moment1[j] = 0.9 * moment1[j] + 0.1 * grad[j];
+      moment2[j] = 0.999 * moment2[j] + 0.001 * grad[j] * grad[j];
+      param[j] -= lr_t * moment1[j] / (sqrt(moment2[j]) + eps_t);
+    }
+  }
+
+  std::vector<float> pull_values(fea_dim);
+  TableContext table_context;
+  table_context.value_type = Dense;
+  table_context.pull_context.values = pull_values.data();
+  table_context.num = fea_dim;
+  table->Pull(table_context);
+  for (int j = 0; j < fea_dim; j++) {
+    ASSERT_NEAR(param[j], pull_values[j], 1e-5);
+  }
+}
+
+// MemoryDenseTable + SGD, concurrent pushes are merged and every pull sees
+// the param between two updates
+TEST(MemoryDenseTable, ConcurrentPushAndPull) {
+  int fea_dim = 100003;
+  int trainers = 8;
+  int steps = 50;
+
+  TableParameter table_config;
+  table_config.set_table_class("MemoryDenseTable");
+  FsClientParameter fs_config;
+  Table *table = new MemoryDenseTable();
+  TableAccessorParameter *accessor_config = table_config.mutable_accessor();
+  accessor_config->set_accessor_class("CommMergeAccessor");
+  CommonAccessorParameter *common_config = table_config.mutable_common();
+  common_config->set_name("sgd");
+  common_config->set_table_name("sgd_concurrent_test_table");
+  common_config->set_trainer_num(trainers);
+  common_config->add_params("Param");
+  common_config->add_dims(fea_dim);
+  common_config->add_initializers("fill_constant&0.0");
+  common_config->add_params("LearningRate");
+  common_config->add_dims(1);
+  common_config->add_initializers("fill_constant&1.0");
+  auto ret = table->Initialize(table_config, fs_config);
+  ASSERT_EQ(ret, 0);
+
+  std::atomic<int> running{trainers};
+  std::atomic<int> torn_pulls{0};
+  std::thread puller([&] {
+    std::vector<float> pull_values(fea_dim);
+    while (running > 0) {
+      TableContext table_context;
+      table_context.value_type = Dense;
+      table_context.pull_context.values = pull_values.data();
+      table_context.num = fea_dim;
+      table->Pull(table_context);
+      for (int j = 1; j < fea_dim; j++) {
+        if (pull_values[j] != pull_values[0]) {
+          ++torn_pulls;
+          break;
+        }
+      }
+    }
+  });
+  std::vector<std::thread> pushers;
+  for (int i = 0; i < trainers; i++) {
+    pushers.emplace_back([&] {
+      std::vector<float> push_values(fea_dim, 1.0);
+      for (int step = 0; step < steps; step++) {
+        TableContext table_context;
+        table_context.value_type = Dense;
+        table_context.push_context.values = push_values.data();
+        table_context.num = push_values.size();
+        table->Push(table_context);
+      }
+      --running;
+    });
+  }
+  for (auto &pusher : pushers) {
+    pusher.join();
+  }
+  puller.join();
+  EXPECT_EQ(torn_pulls, 0);
+
+  std::vector<float> pull_values(fea_dim);
+  TableContext table_context;
+  table_context.value_type = Dense;
+  table_context.pull_context.values = pull_values.data();
+  table_context.num = fea_dim;
+  table->Pull(table_context);
+  for (int j = 0; j < fea_dim; j++) {
+    ASSERT_EQ(pull_values[j], -static_cast<float>(trainers * steps));
+  }
+}
+
 }  // namespace paddle::distributed
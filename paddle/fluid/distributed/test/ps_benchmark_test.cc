@@ -0,0 +1,493 @@
+/* Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+// Throughput benchmark of the parameter server on one box: the servers run
+// in the process, either as tables held by a PsLocalClient or as
+// BrpcPsServers on loopback ports, and client threads drive pull, push,
+// save and load workloads over keys drawn from a Zipf distribution. The
+// workloads are reproducible for a given set of flags, e.g.
+//
+//   ps_benchmark_test --gtest_also_run_disabled_tests \
+//       --gtest_filter=DISABLED_PsBenchmark.Run --ps_benchmark_servers=brpc \
+//       --ps_benchmark_accessors=CtrCommonAccessor \
+//       --ps_benchmark_num_keys=10000000 --ps_benchmark_num_threads=16
+//
+// and QPS, p50/p99 latency and the resident memory per key are logged.
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "paddle/common/flags.h"
+#include "paddle/fluid/distributed/ps/service/brpc_ps_client.h"
+#include "paddle/fluid/distributed/ps/service/brpc_ps_server.h"
+#include "paddle/fluid/distributed/ps/service/env.h"
+#include "paddle/fluid/distributed/ps/service/ps_client.h"
+#include "paddle/fluid/distributed/the_one_ps.pb.h"
+#include "paddle/fluid/framework/program_desc.h"
+#include "paddle/utils/string/split.h"
+
+PD_DEFINE_string(ps_benchmark_servers,
+                 "local,brpc",
+                 "The servers to benchmark, local and/or brpc.");
+PD_DEFINE_string(ps_benchmark_accessors,
+                 "CtrCommonAccessor,SparseAccessor",
+                 "The accessors of the sparse table to benchmark.");
+PD_DEFINE_string(ps_benchmark_workloads,
+                 "pull,push,save,load",
+                 "The workloads to run, in order, after the table is filled.");
+PD_DEFINE_int64(ps_benchmark_num_keys,
+                100000,
+                "The number of keys in the table.");
+PD_DEFINE_double(ps_benchmark_zipf_exponent,
+                 1.0,
+                 "The exponent of the Zipf distribution of the keys, 0 for "
+                 "uniform keys.");
+PD_DEFINE_int32(ps_benchmark_batch_size,
+                1000,
+                "The number of keys of a pull or push request.");
+PD_DEFINE_int32(ps_benchmark_num_batches,
+                50,
+                "The number of requests of a client thread per workload.");
+PD_DEFINE_int32(ps_benchmark_num_threads, 2, "The number of client threads.");
+PD_DEFINE_int32(ps_benchmark_num_brpc_servers,
+                2,
+                "The number of brpc servers, on consecutive ports.");
+PD_DEFINE_int32(ps_benchmark_port, 4219, "The port of the first brpc server.");
+PD_DEFINE_int32(ps_benchmark_embedx_dim, 8, "The embedx dim of the table.");
+PD_DEFINE_uint64(ps_benchmark_seed, 0, "The seed of the keys drawn.");
+PD_DEFINE_string(ps_benchmark_save_dir,
+                 "./ps_benchmark_model",
+                 "The directory the save workload writes to.");
+
+namespace paddle::distributed {
+
+constexpr int kTableId = 0;
+
+// Draws the ranks of keys in [0, num_keys) with P(rank) ~ 1 / (rank + 1)^s.
+class ZipfKeys {
+ public:
+  ZipfKeys(int64_t num_keys, double exponent) : cdf_(num_keys) {
+    double sum = 0;
+    for (int64_t i = 0; i < num_keys; ++i) {
+      sum += 1.0 / std::pow(static_cast<double>(i + 1), exponent);
+      cdf_[i] = sum;
+    }
+    for (auto &p : cdf_) {
+      p /= sum;
+    }
+  }
+
+  // The hot ranks are scattered over the shards, as real feasigns are.
+  static uint64_t Key(int64_t rank) {
+    return static_cast<uint64_t>(rank) * 0x9E3779B97F4A7C15ULL;
+  }
+
+  template <typename Engine>
+  uint64_t operator()(Engine *engine) const {
+    double u = std::uniform_real_distribution<double>(0, 1)(*engine);
+    int64_t rank = std::lower_bound(cdf_.begin(), cdf_.end(), u) - cdf_.begin();
+    return Key(std::min<int64_t>(rank, cdf_.size() - 1));
+  }
+
+ private:
+  std::vector<double> cdf_;
+};
+
+size_t ResidentBytes() {
+  std::ifstream statm("/proc/self/statm");
+  size_t size = 0, resident = 0;
+  statm >> size >> resident;
+  return resident * sysconf(_SC_PAGESIZE);
+}
+
+void GetSparseTableProto(const std::string &accessor_class,
+                         TableParameter *table_proto) {
+  table_proto->set_table_id(kTableId);
+  table_proto->set_table_class("MemorySparseTable");
+  table_proto->set_shard_num(10);
+  auto *accessor_config = table_proto->mutable_accessor();
+  accessor_config->set_accessor_class(accessor_class);
+  accessor_config->set_fea_dim(FLAGS_ps_benchmark_embedx_dim + 1);
+  accessor_config->set_embedx_dim(FLAGS_ps_benchmark_embedx_dim);
+  accessor_config->set_embedx_threshold(0);
+  auto *ctr_param = accessor_config->mutable_ctr_accessor_param();
+  ctr_param->set_nonclk_coeff(0.1);
+  ctr_param->set_click_coeff(1);
+  ctr_param->set_base_threshold(1.5);
+  ctr_param->set_delta_threshold(0.25);
+  ctr_param->set_delta_keep_days(16);
+  ctr_param->set_show_click_decay_rate(0.98);
+  ctr_param->set_delete_threshold(0.8);
+  ctr_param->set_delete_after_unseen_days(30);
+  ctr_param->set_ssd_unseenday_threshold(1);
+
+  for (auto *sgd_param : {accessor_config->mutable_embed_sgd_param(),
+                          accessor_config->mutable_embedx_sgd_param()}) {
+    sgd_param->set_name("SparseAdaGradSGDRule");
+    auto *adagrad_param = sgd_param->mutable_adagrad();
+    adagrad_param->set_learning_rate(0.05);
+    adagrad_param->set_initial_g2sum(3.0);
+    adagrad_param->set_initial_range(0.0001);
+    adagrad_param->add_weight_bounds(-10.0);
+    adagrad_param->add_weight_bounds(10.0);
+  }
+}
+
+PSParameter GetPSProto(const std::string &server,
+                       const std::string &accessor_class) {
+  PSParameter ps_param;
+  auto *downpour_server_proto =
+      ps_param.mutable_server_param()->mutable_downpour_server_param();
+  auto *service_proto = downpour_server_proto->mutable_service_param();
+  if (server == "brpc") {
+    service_proto->set_service_class("BrpcPsService");
+    service_proto->set_server_class("BrpcPsServer");
+    service_proto->set_client_class("BrpcPsClient");
+    service_proto->set_start_server_port(0);
+    service_proto->set_server_thread_num(12);
+  } else {
+    service_proto->set_server_class("PsLocalServer");
+    service_proto->set_client_class("PsLocalClient");
+  }
+  GetSparseTableProto(accessor_class,
+                      downpour_server_proto->add_downpour_table_param());
+  GetSparseTableProto(accessor_class,
+                      ps_param.mutable_worker_param()
+                          ->mutable_downpour_worker_param()
+                          ->add_downpour_table_param());
+  return ps_param;
+}
+
+// The servers and the client of one benchmark, the tables of the local
+// server are held by the client.
+class PsCluster {
+ public:
+  PsCluster(const std::string &server, const std::string &accessor_class)
+      : is_brpc_(server == "brpc"),
+        ps_param_(GetPSProto(server, accessor_class)) {}
+
+  ~PsCluster() {
+    if (!is_brpc_) {
+      return;
+    }
+    if (client_ != nullptr) {
+      client_->StopServer().wait();
+      client_->FinalizeWorker();
+    } else {
+      for (auto &server : servers_) {
+        server->Stop();
+      }
+    }
+    for (auto &thread : server_threads_) {
+      thread.join();
+    }
+  }
+
+  void Start() {
+    std::vector<framework::ProgramDesc> empty_programs(1);
+    if (is_brpc_) {
+      setenv("http_proxy", "", 1);
+      setenv("https_proxy", "", 1);
+      int num_servers = FLAGS_ps_benchmark_num_brpc_servers;
+      for (int rank = 0; rank < num_servers; ++rank) {
+        host_sign_list_.push_back(
+            PSHost("127.0.0.1", FLAGS_ps_benchmark_port + rank, rank)
+                .SerializeToString());
+      }
+      for (int rank = 0; rank < num_servers; ++rank) {
+        // The servers keep a pointer to their environment.
+        server_envs_.push_back(std::make_unique<PaddlePSEnvironment>());
+        server_envs_.back()->SetPsServers(&host_sign_list_, num_servers);
+        servers_.emplace_back(PSServerFactory::Create(ps_param_));
+        ASSERT_EQ(servers_.back()->Configure(
+                      ps_param_, *server_envs_.back(), rank, empty_programs),
+                  0);
+      }
+      for (int rank = 0; rank < num_servers; ++rank) {
+        server_threads_.emplace_back([this, rank] {
+          servers_[rank]->Start("127.0.0.1", FLAGS_ps_benchmark_port + rank);
+        });
+      }
+      sleep(1);
+      client_env_.SetPsServers(&host_sign_list_, num_servers);
+    }
+    client_.reset(PSClientFactory::Create(ps_param_));
+    ASSERT_NE(client_, nullptr);
+    std::map<uint64_t, std::vector<Region>> regions;
+    ASSERT_EQ(client_->Configure(ps_param_, regions, client_env_, 0), 0);
+  }
+
+  size_t SelectDim() {
+    return client_->GetTableAccessor(kTableId)->GetAccessorInfo().select_dim;
+  }
+
+  size_t UpdateDim() {
+    return client_->GetTableAccessor(kTableId)->GetAccessorInfo().update_dim;
+  }
+
+  // `values` has one buffer of SelectDim() floats per key.
+  int32_t Pull(const std::vector<uint64_t> &keys,
+               std::vector<float *> *values) {
+    return client_
+        ->PullSparse(values->data(), kTableId, keys.data(), keys.size(), true)
+        .get();
+  }
+
+  int32_t Push(const std::vector<uint64_t> &keys,
+               const std::vector<const float *> &grads) {
+    if (!is_brpc_) {
+      return client_
+          ->PushSparse(kTableId,
+                       keys.data(),
+                       const_cast<const float **>(grads.data()),
+                       keys.size())
+          .get();
+    }
+    auto *closure = new DownpourBrpcClosure(1, [](void *done) {
+      auto *closure = reinterpret_cast<DownpourBrpcClosure *>(done);
+      closure->set_promise_value(
+          closure->check_response(0, PS_PUSH_SPARSE_TABLE) == 0 ? 0 : -1);
+    });
+    return client_
+        ->PushSparseRawGradient(kTableId,
+                                keys.data(),
+                                const_cast<const float **>(grads.data()),
+                                keys.size(),
+                                closure)
+        .get();
+  }
+
+  int32_t Save(const std::string &dirname) {
+    return client_->Save(kTableId, dirname, "0").get();
+  }
+
+  int32_t Load(const std::string &dirname) {
+    return client_->Load(kTableId, dirname, "0").get();
+  }
+
+ private:
+  bool is_brpc_;
+  PSParameter ps_param_;
+  std::vector<std::string> host_sign_list_;
+  std::vector<std::unique_ptr<PaddlePSEnvironment>> server_envs_;
+  std::vector<std::unique_ptr<PSServer>> servers_;
+  std::vector<std::thread> server_threads_;
+  PaddlePSEnvironment client_env_;
+  std::unique_ptr<PSClient> client_;
+};
+
+struct WorkloadStats {
+  double seconds = 0;
+  // Latencies of the requests, in ms.
+  std::vector<double> latencies;
+
+  double Percentile(double p) const {
+    if (latencies.empty()) {
+      return 0;
+    }
+    size_t idx = static_cast<size_t>(p * (latencies.size() - 1));
+    return latencies[idx];
+  }
+};
+
+// Runs `request(thread_id, keys)` from all the client threads, the keys of
+// each request are drawn from `zipf` before it is timed.
+template <typename Request>
+WorkloadStats RunRequests(const ZipfKeys &zipf, const Request &request) {
+  int num_threads = FLAGS_ps_benchmark_num_threads;
+  std::vector<std::vector<double>> latencies(num_threads);
+  std::vector<std::thread> threads;
+  auto start = std::chrono::steady_clock::now();
+  for (int t = 0; t < num_threads; ++t) {
+    threads.emplace_back([&, t] {
+      std::mt19937_64 engine(FLAGS_ps_benchmark_seed * 1000003 + t);
+      std::vector<uint64_t> keys(FLAGS_ps_benchmark_batch_size);
+      for (int b = 0; b < FLAGS_ps_benchmark_num_batches; ++b) {
+        for (auto &key : keys) {
+          key = zipf(&engine);
+        }
+        auto request_start = std::chrono::steady_clock::now();
+        EXPECT_EQ(request(t, keys), 0);
+        latencies[t].push_back(
+            std::chrono::duration<double, std::milli>(
+                std::chrono::steady_clock::now() - request_start)
+                .count());
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  WorkloadStats stats;
+  stats.seconds = std::chrono::duration<double>(
+                      std::chrono::steady_clock::now() - start)
+                      .count();
+  for (auto &thread_latencies : latencies) {
+    stats.latencies.insert(stats.latencies.end(),
+                           thread_latencies.begin(),
+                           thread_latencies.end());
+  }
+  std::sort(stats.latencies.begin(), stats.latencies.end());
+  return stats;
+}
+
+void LogStats(const std::string &name, const WorkloadStats &stats) {
+  double num_requests = static_cast<double>(stats.latencies.size());
+  LOG(INFO) << name << ": " << num_requests / stats.seconds << " QPS, "
+            << num_requests * FLAGS_ps_benchmark_batch_size / stats.seconds
+            << " keys/s, p50 " << stats.Percentile(0.5) << "ms, p99 "
+            << stats.Percentile(0.99) << "ms";
+}
+
+void RunBenchmark(const std::string &server,
+                  const std::string &accessor_class) {
+  std::string name = server + "/" + accessor_class;
+  PsCluster cluster(server, accessor_class);
+  cluster.Start();
+  if (::testing::Test::HasFatalFailure()) {
+    return;
+  }
+  ZipfKeys zipf(FLAGS_ps_benchmark_num_keys,
+                FLAGS_ps_benchmark_zipf_exponent);
+  int num_threads = FLAGS_ps_benchmark_num_threads;
+  int batch_size = FLAGS_ps_benchmark_batch_size;
+  size_t select_dim = cluster.SelectDim();
+  size_t update_dim = cluster.UpdateDim();
+
+  // Buffers of the pulled values and of the pushed gradients per thread.
+  std::vector<std::vector<float>> pull_buffers(num_threads);
+  std::vector<std::vector<float *>> pull_values(num_threads);
+  std::vector<std::vector<float>> grad_buffers(num_threads);
+  std::vector<std::vector<const float *>> grads(num_threads);
+  for (int t = 0; t < num_threads; ++t) {
+    pull_buffers[t].resize(batch_size * select_dim);
+    grad_buffers[t].resize(batch_size * update_dim);
+    for (int i = 0; i < batch_size; ++i) {
+      pull_values[t].push_back(pull_buffers[t].data() + i * select_dim);
+      float *grad = grad_buffers[t].data() + i * update_dim;
+      // slot, show, click and the gradients.
+      grad[0] = 0;
+      grad[1] = 1;
+      grad[2] = i % 10 == 0 ? 1 : 0;
+      std::fill(grad + 3, grad + update_dim, 0.01f);
+      grads[t].push_back(grad);
+    }
+  }
+  auto pull = [&](int t, const std::vector<uint64_t> &keys) {
+    return cluster.Pull(keys, &pull_values[t]);
+  };
+  auto push = [&](int t, const std::vector<uint64_t> &keys) {
+    return cluster.Push(keys, grads[t]);
+  };
+
+  // Every key is created by a pull first, so that the memory per key does
+  // not depend on how many keys the Zipf distribution reached.
+  size_t resident_bytes = ResidentBytes();
+  std::vector<uint64_t> keys;
+  std::vector<float *> fill_values(pull_values[0]);
+  for (int64_t rank = 0; rank < FLAGS_ps_benchmark_num_keys; ++rank) {
+    keys.push_back(ZipfKeys::Key(rank));
+    if (static_cast<int>(keys.size()) == batch_size ||
+        rank + 1 == FLAGS_ps_benchmark_num_keys) {
+      fill_values.resize(keys.size());
+      ASSERT_EQ(cluster.Pull(keys, &fill_values), 0);
+      keys.clear();
+    }
+  }
+  auto log_memory = [&](const std::string &after) {
+    double bytes = static_cast<double>(ResidentBytes()) -
+                   static_cast<double>(resident_bytes);
+    LOG(INFO) << name << ": " << bytes / FLAGS_ps_benchmark_num_keys
+              << " resident bytes per key after " << after;
+  };
+  log_memory("fill");
+
+  for (auto &workload :
+       paddle::string::Split(FLAGS_ps_benchmark_workloads, ',')) {
+    if (workload == "pull") {
+      LogStats(name + " pull", RunRequests(zipf, pull));
+    } else if (workload == "push") {
+      LogStats(name + " push", RunRequests(zipf, push));
+      log_memory("push");
+    } else if (workload == "save" || workload == "load") {
+      auto start = std::chrono::steady_clock::now();
+      if (workload == "save") {
+        ASSERT_EQ(cluster.Save(FLAGS_ps_benchmark_save_dir), 0);
+      } else {
+        ASSERT_EQ(cluster.Load(FLAGS_ps_benchmark_save_dir), 0);
+      }
+      double seconds = std::chrono::duration<double>(
+                           std::chrono::steady_clock::now() - start)
+                           .count();
+      LOG(INFO) << name << " " << workload << ": " << seconds << "s, "
+                << FLAGS_ps_benchmark_num_keys / seconds << " keys/s";
+    } else {
+      ADD_FAILURE() << "Unknown workload " << workload;
+    }
+  }
+}
+
+TEST(PsBenchmark, ZipfKeys) {
+  ZipfKeys zipf(1000, 1.0);
+  std::mt19937_64 engine(0);
+  int num_hot = 0;
+  for (int i = 0; i < 10000; ++i) {
+    if (zipf(&engine) == ZipfKeys::Key(0)) {
+      ++num_hot;
+    }
+  }
+  // P(rank 0) = 1 / H(1000) ~= 0.134.
+  EXPECT_NEAR(num_hot / 10000.0, 0.134, 0.02);
+
+  ZipfKeys uniform(1000, 0.0);
+  std::mt19937_64 other_engine(0);
+  num_hot = 0;
+  for (int i = 0; i < 10000; ++i) {
+    if (uniform(&other_engine) == ZipfKeys::Key(0)) {
+      ++num_hot;
+    }
+  }
+  EXPECT_LT(num_hot, 50);
+}
+
+// Throughput of every server and accessor of the ps_benchmark_* flags.
+TEST(DISABLED_PsBenchmark, Run) {
+  for (auto &server :
+       paddle::string::Split(FLAGS_ps_benchmark_servers, ',')) {
+    for (auto &accessor_class :
+         paddle::string::Split(FLAGS_ps_benchmark_accessors, ',')) {
+      RunBenchmark(server, accessor_class);
+    }
+  }
+  auto workloads = paddle::string::Split(FLAGS_ps_benchmark_workloads, ',');
+  if (std::find(workloads.begin(), workloads.end(), "save") !=
+      workloads.end()) {
+    std::error_code error;
+    std::filesystem::remove_all(FLAGS_ps_benchmark_save_dir, error);
+  }
+}
+
+}  // namespace paddle::distributed
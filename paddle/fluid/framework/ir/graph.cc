@@ -351,6 +351,42 @@ std::shared_ptr<Graph> Graph::Clone() {
   }
 }
 
+const std::unordered_set<ir::Node *> &Graph::OpNodesOfType(
+    const std::string &op_type) const {
+  if (FLAGS_convert_all_blocks) {
+    if (IsMainGraph()) {
+      return GetSubGraph(0)->OpNodesOfType(op_type);
+    }
+  }
+  uint64_t retype_count = OpDesc::RetypeCount();
+  if (op_type_index_retype_count_ != retype_count) {
+    VLOG(4) << "rebuild the op type index of the graph, ops were retyped";
+    op_type_index_.clear();
+    for (auto *node : node_set_) {
+      if (node->IsOp() && node->Op()) {
+        op_type_index_[node->Op()->Type()].insert(node);
+      }
+    }
+    op_type_index_retype_count_ = retype_count;
+  }
+  // Op nodes created with an empty OpDesc get their type afterwards.
+  if (op_type_index_.count("")) {
+    auto &untyped = op_type_index_.at("");
+    for (auto it = untyped.begin(); it != untyped.end();) {
+      std::string type = (*it)->Op()->Type();
+      if (type.empty()) {
+        ++it;
+      } else {
+        op_type_index_[type].insert(*it);
+        it = untyped.erase(it);
+      }
+    }
+  }
+  static const std::unordered_set<ir::Node *> empty;
+  auto it = op_type_index_.find(op_type);
+  return it == op_type_index_.end() ? empty : it->second;
+}
+
 std::unique_ptr<Graph> Graph::CloneSubGraph(const size_t idx) {
   PADDLE_ENFORCE_EQ(
       this->IsMainGraph(),
@@ -17,6 +17,7 @@ limitations under the License. */
 #include <map>
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
@@ -311,6 +312,7 @@ class Graph {
     }
     nodes_.clear();
     node_set_.clear();
+    op_type_index_.clear();
     return ret;
   }
 
@@ -328,6 +330,15 @@ class Graph {
     ret.reset(nodes_.at(node).release());
     nodes_.erase(node);
     node_set_.erase(node);
+    if (node->IsOp() && node->Op()) {
+      // An op node created with an empty OpDesc may be indexed as untyped.
+      for (const auto &type : {node->Op()->Type(), std::string()}) {
+        auto it = op_type_index_.find(type);
+        if (it != op_type_index_.end()) {
+          it->second.erase(node);
+        }
+      }
+    }
     return ret;
   }
 
@@ -372,9 +383,18 @@ class Graph {
                           "The node to be added already exists."));
     nodes_[node].reset(node);
     node_set_.insert(node);
+    if (node->IsOp() && node->Op()) {
+      op_type_index_[node->Op()->Type()].insert(node);
+    }
     return node;
   }
 
+  // The op nodes of type `op_type`. The index is updated as nodes are added
+  // and removed, so that the pattern detectors of a sequence of passes only
+  // visit the ops their patterns may match instead of the whole graph.
+  const std::unordered_set<ir::Node *> &OpNodesOfType(
+      const std::string &op_type) const;
+
   void ResolveHazard(
       const std::map<std::string, std::vector<ir::Node *>> &var_nodes);
 
@@ -475,6 +495,11 @@ class Graph {
   std::map<std::string, std::function<void(void)>> attr_dels_;
   std::map<ir::Node *, std::unique_ptr<ir::Node>> nodes_;
   std::unordered_set<ir::Node *> node_set_;
+  // Op type => op nodes of that type, see OpNodesOfType. Rebuilt if ops were
+  // retyped in place since op_type_index_retype_count_.
+  mutable std::unordered_map<std::string, std::unordered_set<ir::Node *>>
+      op_type_index_;
+  mutable uint64_t op_type_index_retype_count_{0};
   size_t num_node_created_{0};  // help to generate a unique node id.
   // NOTE(Aurelius84): Whether is constructed with partial ProgramDesc.
   // In case of @to_static, whole training program is splited into two
@@ -14,12 +14,19 @@
 
 #include "paddle/fluid/framework/ir/graph_pattern_detector.h"
 
+#include "paddle/common/flags.h"
 #include "paddle/fluid/framework/ir/graph_traits.h"
 #include "paddle/fluid/framework/ir/graph_viz_pass.h"
 #include "paddle/fluid/framework/operator.h"
 #include "paddle/fluid/platform/enforce.h"
 #include "paddle/utils/string/pretty_log.h"
 
+PHI_DEFINE_EXPORTED_bool(
+    graph_pattern_detector_use_op_index,
+    true,
+    "Only visit the nodes around the ops of the types a pattern asserts, "
+    "found by the op type index of the graph, to detect the pattern.");
+
 namespace paddle::framework::ir {
 
 size_t PDPattern::id_ = 0UL;
@@ -106,13 +113,28 @@ bool GraphPatternDetector::MarkPDNodesInGraph(const ir::Graph &graph) {
   VLOG(3) << "mark pdnodes in graph";
   if (graph.Nodes().empty()) return false;
 
-  for (auto &node : GraphTraits::DFS(graph)) {
-    if (node.Name().rfind("__control_var") == 0) continue;
+  std::unordered_map<const PDNode *, std::unordered_set<Node *>> candidates;
+  if (FLAGS_graph_pattern_detector_use_op_index &&
+      CollectCandidates(graph, &candidates)) {
     for (const auto &pdnode : pattern_.nodes()) {
-      if (pdnode->Tell(&node)) {
-        VLOG(4) << "Node " << node.Name() << "(" << node.id() << ")"
-                << " marked as " << pdnode->name();
-        pdnodes2nodes_[pdnode.get()].insert(&node);
+      for (auto *node : candidates[pdnode.get()]) {
+        if (node->Name().rfind("__control_var") == 0) continue;
+        if (pdnode->Tell(node)) {
+          VLOG(4) << "Node " << node->Name() << "(" << node->id() << ")"
+                  << " marked as " << pdnode->name();
+          pdnodes2nodes_[pdnode.get()].insert(node);
+        }
+      }
+    }
+  } else {
+    for (auto &node : GraphTraits::DFS(graph)) {
+      if (node.Name().rfind("__control_var") == 0) continue;
+      for (const auto &pdnode : pattern_.nodes()) {
+        if (pdnode->Tell(&node)) {
+          VLOG(4) << "Node " << node.Name() << "(" << node.id() << ")"
+                  << " marked as " << pdnode->name();
+          pdnodes2nodes_[pdnode.get()].insert(&node);
+        }
       }
     }
   }
@@ -128,6 +150,61 @@ bool GraphPatternDetector::MarkPDNodesInGraph(const ir::Graph &graph) {
   return !pdnodes2nodes_.empty();
 }
 
+bool GraphPatternDetector::CollectCandidates(
+    const ir::Graph &graph,
+    std::unordered_map<const PDNode *, std::unordered_set<Node *>>
+        *candidates) {
+  auto ops_of_types = [&graph](const std::unordered_set<std::string> &types) {
+    std::vector<Node *> ops;
+    for (const auto &type : types) {
+      const auto &nodes = graph.OpNodesOfType(type);
+      ops.insert(ops.end(), nodes.begin(), nodes.end());
+    }
+    return ops;
+  };
+  for (const auto &pdnode : pattern_.nodes()) {
+    if (pdnode->op_types()) {
+      auto ops = ops_of_types(*pdnode->op_types());
+      (*candidates)[pdnode.get()].insert(ops.begin(), ops.end());
+    } else if (pdnode->consumer_op_types()) {
+      auto &vars = (*candidates)[pdnode.get()];
+      for (auto *op : ops_of_types(*pdnode->consumer_op_types())) {
+        vars.insert(op->inputs.begin(), op->inputs.end());
+      }
+    } else if (pdnode->producer_op_types()) {
+      auto &vars = (*candidates)[pdnode.get()];
+      for (auto *op : ops_of_types(*pdnode->producer_op_types())) {
+        vars.insert(op->outputs.begin(), op->outputs.end());
+      }
+    }
+  }
+
+  // The other PDNodes are linked to a narrowed down one, the nodes fitting
+  // them are among the neighbors of its candidates.
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    for (const auto &edge : pattern_.edges()) {
+      bool has_source = candidates->count(edge.first);
+      bool has_target = candidates->count(edge.second);
+      if (has_source == has_target) continue;
+      if (has_source) {
+        auto &targets = (*candidates)[edge.second];
+        for (auto *source : candidates->at(edge.first)) {
+          targets.insert(source->outputs.begin(), source->outputs.end());
+        }
+      } else {
+        auto &sources = (*candidates)[edge.first];
+        for (auto *target : candidates->at(edge.second)) {
+          sources.insert(target->inputs.begin(), target->inputs.end());
+        }
+      }
+      changed = true;
+    }
+  }
+  return candidates->size() == pattern_.nodes().size();
+}
+
 // The intermediate Nodes can only link to the nodes inside the pattern, or this
 // subgraph will be dropped.
 void GraphPatternDetector::ValidateByNodeRole(
@@ -408,12 +485,36 @@ PDNode &PDNode::LinksFrom(const std::vector<PDNode *> &others) {
   return *this;
 }
 
+void PDNode::RestrictOpTypes(
+    std::optional<std::unordered_set<std::string>> *known,
+    const std::unordered_set<std::string> &types) {
+  if (!*known) {
+    *known = types;
+    return;
+  }
+  for (auto it = (*known)->begin(); it != (*known)->end();) {
+    it = types.count(*it) ? std::next(it) : (*known)->erase(it);
+  }
+}
+
+void PDNode::RestrictLinkedOpTypes(
+    std::optional<std::unordered_set<std::string>> *known,
+    const std::unordered_set<std::string> &types) {
+  // A var may be linked to several ops, each asserted to be of other types,
+  // so the sets are not intersected. Any one of them is a superset filter,
+  // the smallest one visits the fewest ops.
+  if (!*known || types.size() < (*known)->size()) {
+    *known = types;
+  }
+}
+
 PDNode *PDNode::assert_is_op() {
   asserts_.emplace_back([](Node *x) { return x && x->IsOp(); });
   return this;
 }
 
 PDNode *PDNode::assert_is_op(const std::string &op_type) {
+  RestrictOpTypes(&op_types_, {op_type});
   asserts_.emplace_back([op_type](Node *x) {
     return x && x->IsOp() && x->Op()->Type() == op_type;
   });
@@ -478,6 +579,7 @@ PDNode *PDNode::assert_is_op_nth_output(const std::string &op_type,
                                         const std::string &argument,
                                         int nth) {
   assert_is_var();
+  RestrictLinkedOpTypes(&producer_op_types_, {op_type});
   asserts_.emplace_back([=](Node *x) {
     for (auto *op : x->inputs) {
       if (op->IsOp() && op->Op()->Type() == op_type &&
@@ -491,6 +593,7 @@ PDNode *PDNode::assert_is_op_nth_output(const std::string &op_type,
 
 PDNode *PDNode::assert_is_only_input_of_op(const std::string &op_type) {
   assert_is_var();
+  RestrictLinkedOpTypes(&consumer_op_types_, {op_type});
   asserts_.emplace_back([=](Node *x) {
     for (auto *op : x->outputs) {
       if (op && op->IsOp() && op->Op() && op->Op()->Type() == op_type &&
@@ -505,6 +608,7 @@ PDNode *PDNode::assert_is_only_input_of_op(const std::string &op_type) {
 
 PDNode *PDNode::assert_is_only_output_of_op(const std::string &op_type) {
   assert_is_var();
+  RestrictLinkedOpTypes(&producer_op_types_, {op_type});
   asserts_.emplace_back([=](Node *x) {
     for (auto *op : x->inputs) {
       if (op && op->IsOp() && op->Op() && op->Op()->Type() == op_type &&
@@ -519,6 +623,7 @@ PDNode *PDNode::assert_is_only_output_of_op(const std::string &op_type) {
 
 PDNode *PDNode::assert_is_op_output(const std::string &op_type) {
   assert_is_var();
+  RestrictLinkedOpTypes(&producer_op_types_, {op_type});
   asserts_.emplace_back([=](Node *x) {
     for (auto *op : x->inputs) {
       if (op && op->IsOp() && op->Op() && op->Op()->Type() == op_type) {
@@ -539,6 +644,7 @@ PDNode *PDNode::assert_is_op_output(const std::string &op_type,
 
 PDNode *PDNode::assert_is_op_input(const std::string &op_type) {
   assert_is_var();
+  RestrictLinkedOpTypes(&consumer_op_types_, {op_type});
   asserts_.emplace_back([=](Node *x) {
     for (auto *op : x->outputs) {
       if (op && op->IsOp() && op->Op() && op->Op()->Type() == op_type) {
@@ -595,6 +701,7 @@ PDNode *PDNode::assert_more(PDNode::teller_t &&teller) {
 }
 
 PDNode *PDNode::assert_is_ops(const std::unordered_set<std::string> &op_types) {
+  RestrictOpTypes(&op_types_, op_types);
   asserts_.emplace_back([op_types](Node *x) {
     return x && x->IsOp() && op_types.count(x->Op()->Type());
   });
@@ -623,6 +730,7 @@ PDNode *PDNode::assert_is_ops_nth_output(
     const std::string &argument,
     int nth) {
   assert_is_var();
+  RestrictLinkedOpTypes(&producer_op_types_, op_types);
   asserts_.emplace_back([=](Node *x) {
     for (auto *op : x->inputs) {
       if (op->IsOp() && op_types.count(op->Op()->Type()) &&
@@ -636,6 +744,7 @@ PDNode *PDNode::assert_is_ops_nth_output(
 PDNode *PDNode::assert_is_ops_output(
     const std::unordered_set<std::string> &op_types) {
   assert_is_var();
+  RestrictLinkedOpTypes(&producer_op_types_, op_types);
   asserts_.emplace_back([=](Node *x) {
     for (auto *op : x->inputs) {
       if (op && op->IsOp() && op->Op() && op_types.count(op->Op()->Type())) {
@@ -658,6 +767,7 @@ PDNode *PDNode::assert_is_ops_output(
 PDNode *PDNode::assert_is_ops_input(
     const std::unordered_set<std::string> &op_types) {
   assert_is_var();
+  RestrictLinkedOpTypes(&consumer_op_types_, op_types);
   asserts_.emplace_back([=](Node *x) {
     for (auto *op : x->outputs) {
       if (op && op->IsOp() && op->Op() && op_types.count(op->Op()->Type())) {
@@ -680,6 +790,7 @@ PDNode *PDNode::assert_is_ops_input(
 PDNode *PDNode::assert_is_only_input_of_ops(
     const std::unordered_set<std::string> &op_types) {
   assert_is_var();
+  RestrictLinkedOpTypes(&consumer_op_types_, op_types);
   asserts_.emplace_back([=](Node *x) {
     for (auto *op : x->outputs) {
       if (op && op->IsOp() && op->Op() && op_types.count(op->Op()->Type()) &&
@@ -695,6 +806,7 @@ PDNode *PDNode::assert_is_only_input_of_ops(
 PDNode *PDNode::assert_is_only_output_of_ops(
     const std::unordered_set<std::string> &op_types) {
   assert_is_var();
+  RestrictLinkedOpTypes(&producer_op_types_, op_types);
   asserts_.emplace_back([=](Node *x) {
     for (auto *op : x->inputs) {
       if (op && op->IsOp() && op->Op() && op_types.count(op->Op()->Type()) &&
@@ -21,6 +21,7 @@
 #include <map>
 #include <memory>
 #include <numeric>
+#include <optional>
 #include <set>
 #include <string>
 #include <unordered_map>
@@ -80,6 +81,19 @@ struct PDNode {
   bool IsOp() const { return type_ == Type::kOp; }
   bool IsVar() const { return type_ == Type::kVar; }
 
+  // The types the matched op has to be of, known from the assertions, or
+  // null if unknown. Likewise for an op consuming or producing the matched
+  // var. The detector only visits the nodes around the ops of these types.
+  const std::unordered_set<std::string>* op_types() const {
+    return teller_ || !op_types_ ? nullptr : &*op_types_;
+  }
+  const std::unordered_set<std::string>* consumer_op_types() const {
+    return teller_ || !consumer_op_types_ ? nullptr : &*consumer_op_types_;
+  }
+  const std::unordered_set<std::string>* producer_op_types() const {
+    return teller_ || !producer_op_types_ ? nullptr : &*producer_op_types_;
+  }
+
   const std::string& name() const { return name_; }
   const PDPattern* pdpattern() const { return pattern_; }
 
@@ -188,6 +202,16 @@ struct PDNode {
 
   PDNode(PDNode&& other) = default;
 
+  // Intersects the op types already known with `types`.
+  static void RestrictOpTypes(
+      std::optional<std::unordered_set<std::string>>* known,
+      const std::unordered_set<std::string>& types);
+  // Keeps the smaller of the consumer (or producer) op types already known
+  // and `types`.
+  static void RestrictLinkedOpTypes(
+      std::optional<std::unordered_set<std::string>>* known,
+      const std::unordered_set<std::string>& types);
+
   friend class PDPattern;
 
   // Will removed latter.
@@ -197,6 +221,9 @@ struct PDNode {
   std::string name_;
   Type type_;
   Role role_{Role::kUnknown};
+  std::optional<std::unordered_set<std::string>> op_types_;
+  std::optional<std::unordered_set<std::string>> consumer_op_types_;
+  std::optional<std::unordered_set<std::string>> producer_op_types_;
 };
 
 /*
@@ -338,6 +365,13 @@ class GraphPatternDetector {
   // Mark the nodes that fits the pattern.
   bool MarkPDNodesInGraph(const ir::Graph& graph);
 
+  // Collect the nodes that may fit each PDNode from the op type index of the
+  // graph. Returns false if some PDNode can't be narrowed down this way.
+  bool CollectCandidates(
+      const ir::Graph& graph,
+      std::unordered_map<const PDNode*, std::unordered_set<Node*>>*
+          candidates);
+
   // Detect all the pattern and output the hit records.
   std::vector<subgraph_t> DetectPatterns();
 
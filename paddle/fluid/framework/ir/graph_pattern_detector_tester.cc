@@ -14,7 +14,16 @@
 
 #include <gtest/gtest.h>
 
+#include <chrono>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "paddle/common/flags.h"
 #include "paddle/fluid/framework/ir/graph_pattern_detector.h"
+#include "paddle/fluid/framework/ir/pass_tester_helper.h"
+
+COMMON_DECLARE_bool(graph_pattern_detector_use_op_index);
 
 namespace paddle::framework::ir {
 
@@ -205,4 +214,168 @@ TEST(GraphPatternDetector, IntermediateCheck) {
   ASSERT_EQ(count, 1);
 }
 
+// A transformer encoder with `num_layers` layers, as exported for inference.
+ProgramDesc BuildTransformerProgram(int num_layers) {
+  Layers layers;
+  auto* x = layers.data("x", {1, 128, 768});
+  for (int i = 0; i < num_layers; ++i) {
+    auto prefix = "layer" + std::to_string(i) + "_";
+    auto linear = [&](VarDesc* in, const std::string& name) {
+      auto* w = layers.data(prefix + name + "_w", {768, 768}, true);
+      auto* b = layers.data(prefix + name + "_b", {768}, true);
+      return layers.elementwise_add(layers.matmul_v2(in, w), b);
+    };
+    std::vector<VarDesc*> qkv;
+    for (auto name : {"q", "k", "v"}) {
+      auto* reshaped = layers.reshape2(linear(x, name), {1, 128, 12, 64});
+      qkv.push_back(layers.transpose2(reshaped, {0, 2, 1, 3}));
+    }
+    auto* qk = layers.matmul_v2(qkv[0], qkv[1], nullptr, false, true);
+    auto* probs = layers.softmax(layers.scale(qk, 0.125), -1);
+    auto* context = layers.transpose2(layers.matmul_v2(probs, qkv[2]),
+                                      {0, 2, 1, 3});
+    auto* attention = linear(layers.reshape2(context, {1, 128, 768}), "o");
+    auto* ln1 = layers.layer_norm(layers.elementwise_add(x, attention))[0];
+    auto* ffn = linear(layers.gelu(linear(ln1, "ffn1")), "ffn2");
+    x = layers.layer_norm(layers.elementwise_add(ln1, ffn))[0];
+  }
+  return layers.main_program();
+}
+
+// Detects first_op -> var -> second_op the way the fuse passes define their
+// patterns, returns the number of hits.
+int DetectOpPair(Graph* graph,
+                 const std::string& first_op,
+                 const std::string& second_op) {
+  GraphPatternDetector detector;
+  auto* pattern = detector.mutable_pattern();
+  auto* first = pattern->NewNode("first")->assert_is_op(first_op);
+  auto* var = pattern->NewNode("var")
+                  ->assert_is_op_output(first_op)
+                  ->assert_is_op_input(second_op)
+                  ->AsIntermediate();
+  auto* second = pattern->NewNode("second")->assert_is_op(second_op);
+  first->LinksTo({var});
+  var->LinksTo({second});
+  int count = 0;
+  detector(graph, [&](const GraphPatternDetector::subgraph_t& subgraph,
+                      Graph* g) { ++count; });
+  return count;
+}
+
+// Pairs of ops fused by the inference passes, most of which are not in a
+// given model.
+const std::vector<std::pair<std::string, std::string>>& FusedOpPairs() {
+  static const std::vector<std::pair<std::string, std::string>> pairs = {
+      {"matmul_v2", "elementwise_add"},
+      {"elementwise_add", "layer_norm"},
+      {"elementwise_add", "gelu"},
+      {"reshape2", "transpose2"},
+      {"transpose2", "reshape2"},
+      {"scale", "softmax"},
+      {"matmul_v2", "scale"},
+      {"conv2d", "batch_norm"},
+      {"conv2d", "elementwise_add"},
+      {"batch_norm", "relu"},
+      {"mul", "elementwise_add"},
+      {"fc", "relu"},
+      {"matmul", "elementwise_add"},
+      {"lookup_table_v2", "elementwise_add"},
+      {"pool2d", "conv2d"},
+      {"elementwise_add", "relu"},
+      {"layer_norm", "matmul_v2"},
+      {"squeeze2", "matmul"},
+      {"reshape2", "matmul"},
+      {"flatten2", "matmul"},
+  };
+  return pairs;
+}
+
+TEST(GraphPatternDetector, OpTypeIndex) {
+  Graph graph(BuildTransformerProgram(2));
+  EXPECT_EQ(graph.OpNodesOfType("matmul_v2").size(), 16UL);
+  EXPECT_EQ(graph.OpNodesOfType("layer_norm").size(), 4UL);
+  EXPECT_TRUE(graph.OpNodesOfType("conv2d").empty());
+
+  // Retyped in place.
+  auto* gelu = *graph.OpNodesOfType("gelu").begin();
+  gelu->Op()->SetType("relu");
+  EXPECT_EQ(graph.OpNodesOfType("gelu").size(), 1UL);
+  EXPECT_EQ(graph.OpNodesOfType("relu").size(), 1UL);
+  EXPECT_EQ(DetectOpPair(&graph, "elementwise_add", "relu"), 1);
+
+  // Added, typed after being created, and removed.
+  OpDesc empty_desc;
+  auto* op = graph.CreateOpNode(&empty_desc);
+  op->Op()->SetType("conv2d");
+  EXPECT_EQ(graph.OpNodesOfType("conv2d").size(), 1UL);
+  graph.RemoveNode(op);
+  graph.RemoveNode(gelu);
+  EXPECT_TRUE(graph.OpNodesOfType("conv2d").empty());
+  EXPECT_TRUE(graph.OpNodesOfType("relu").empty());
+  EXPECT_EQ(graph.OpNodesOfType("gelu").size(), 1UL);
+}
+
+TEST(GraphPatternDetector, OpTypeIndexMatchesFullScan) {
+  Graph graph(BuildTransformerProgram(4));
+  for (auto& pair : FusedOpPairs()) {
+    FLAGS_graph_pattern_detector_use_op_index = false;
+    int expected = DetectOpPair(&graph, pair.first, pair.second);
+    FLAGS_graph_pattern_detector_use_op_index = true;
+    EXPECT_EQ(DetectOpPair(&graph, pair.first, pair.second), expected)
+        << pair.first << " -> " << pair.second;
+  }
+  FLAGS_graph_pattern_detector_use_op_index = false;
+  EXPECT_EQ(DetectOpPair(&graph, "matmul_v2", "elementwise_add"), 24);
+  FLAGS_graph_pattern_detector_use_op_index = true;
+}
+
+TEST(GraphPatternDetector, OpTypeIndexVarOfTwoConsumers) {
+  // The input of every layer feeds both the matmul_v2 of a linear and the
+  // elementwise_add of the residual.
+  Graph graph(BuildTransformerProgram(2));
+  auto detect = [&graph]() {
+    GraphPatternDetector detector;
+    auto* pattern = detector.mutable_pattern();
+    auto* var = pattern->NewNode("var")
+                    ->assert_is_op_input("matmul_v2", "X")
+                    ->assert_is_op_input("elementwise_add", "X");
+    auto* matmul = pattern->NewNode("matmul")->assert_is_op("matmul_v2");
+    auto* add = pattern->NewNode("add")->assert_is_op("elementwise_add");
+    var->LinksTo({matmul, add});
+    int count = 0;
+    detector(&graph, [&](const GraphPatternDetector::subgraph_t& subgraph,
+                         Graph* g) { ++count; });
+    return count;
+  };
+  FLAGS_graph_pattern_detector_use_op_index = false;
+  int expected = detect();
+  FLAGS_graph_pattern_detector_use_op_index = true;
+  EXPECT_GT(expected, 0);
+  EXPECT_EQ(detect(), expected);
+}
+
+// Pattern detection time of about a hundred passes on a large transformer.
+TEST(DISABLED_GraphPatternDetector, BenchmarkLargeTransformer) {
+  Graph graph(BuildTransformerProgram(48));
+  for (bool use_op_index : {false, true}) {
+    FLAGS_graph_pattern_detector_use_op_index = use_op_index;
+    int hits = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int pass = 0; pass < 5; ++pass) {
+      for (auto& pair : FusedOpPairs()) {
+        hits += DetectOpPair(&graph, pair.first, pair.second);
+      }
+    }
+    double ms = std::chrono::duration<double, std::milli>(
+                    std::chrono::steady_clock::now() - start)
+                    .count();
+    LOG(INFO) << graph.Nodes().size() << " nodes, "
+              << 5 * FusedOpPairs().size() << " patterns, " << hits
+              << " hits, " << (use_op_index ? "op type index: " : "full scan: ")
+              << ms << "ms.";
+  }
+  FLAGS_graph_pattern_detector_use_op_index = true;
+}
+
 }  // namespace paddle::framework::ir
@@ -24,6 +24,7 @@
 #include "paddle/phi/core/kernel_context.h"
 #include "paddle/phi/core/os_info.h"
 #include "paddle/phi/core/platform/device/gpu/gpu_info.h"
+#include "paddle/phi/core/platform/metrics.h"
 #include "paddle/phi/core/platform/profiler/event_tracing.h"
 #include "paddle/phi/core/sparse_coo_tensor.h"
 #include "paddle/phi/core/sparse_csr_tensor.h"
@@ -1186,6 +1187,8 @@ void ProgramInterpreter::RunInstruction(const Instruction& instr_node) {
   auto* op = instr_node.OpBase();
   phi::RecordEvent instruction_event(
       op->Type(), phi::TracerEventType::Operator, 1);
+  platform::ScopedLatencyTimer op_latency(
+      platform::OpLatencyHistogram(op->Type()));
 
   SetDeviceId(instr_node.DeviceContext().GetPlace());
 
@@ -14,6 +14,7 @@ limitations under the License. */
 
 #include "paddle/fluid/framework/op_desc.h"
 
+#include <atomic>
 #include <string>
 
 #include "glog/logging.h"
@@ -454,7 +455,7 @@ OpDesc::OpDesc(const OpDesc &other, BlockDesc *block) {
 }
 
 void OpDesc::CopyFrom(const OpDesc &op_desc) {
-  desc_.set_type(op_desc.Type());
+  SetType(op_desc.Type());
   inputs_ = op_desc.inputs_;
   outputs_ = op_desc.outputs_;
   attrs_ = op_desc.attrs_;
@@ -531,7 +532,16 @@ proto::OpDesc *OpDesc::Proto() {
   return &desc_;
 }
 
-void OpDesc::SetType(const std::string &type) { desc_.set_type(type); }
+static std::atomic<uint64_t> retype_count{0};
+
+uint64_t OpDesc::RetypeCount() { return retype_count.load(); }
+
+void OpDesc::SetType(const std::string &type) {
+  if (!desc_.type().empty() && desc_.type() != type) {
+    ++retype_count;
+  }
+  desc_.set_type(type);
+}
 
 const std::vector<std::string> &OpDesc::Input(const std::string &name) const {
   auto it = inputs_.find(name);
@@ -66,6 +66,11 @@ class TEST_API OpDesc {
 
   void SetType(const std::string &type);
 
+  // Number of times an op was retyped, i.e. got a type other than the one
+  // it already had. The indexes of the op nodes by type, see ir::Graph,
+  // are rebuilt when it changes.
+  static uint64_t RetypeCount();
+
   const std::vector<std::string> &Input(const std::string &name) const;
 
   std::vector<std::string> Input(const std::string &name,
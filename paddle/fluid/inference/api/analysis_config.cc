@@ -532,6 +532,11 @@ AnalysisConfig::AnalysisConfig(const AnalysisConfig &other) {
   CP_MEMBER(trt_allow_build_at_runtime_);
   CP_MEMBER(collect_shape_range_info_);
   CP_MEMBER(shape_range_info_path_);
+  CP_MEMBER(use_shape_bucketing_);
+  CP_MEMBER(shape_bucket_boundaries_);
+  CP_MEMBER(shape_bucket_axis_);
+  CP_MEMBER(shape_bucket_pad_value_);
+  CP_MEMBER(use_packed_gemm_weight_);
   CP_MEMBER(trt_use_inspector_);
   CP_MEMBER(trt_inspector_serialize_);
   CP_MEMBER(trt_use_explicit_quantization_);
@@ -1466,6 +1471,9 @@ std::string AnalysisConfig::Summary() {
   os.InsertRow({"enable_log", with_glog_info_ ? "true" : "false"});
   os.InsertRow({"collect_shape_range_info",
                 collect_shape_range_info_ ? shape_range_info_path_ : "false"});
+  os.InsertRow({"shape_bucketing", use_shape_bucketing_ ? "true" : "false"});
+  os.InsertRow(
+      {"packed_gemm_weight", use_packed_gemm_weight_ ? "true" : "false"});
 
   return os.PrintTable();
 }
@@ -1485,6 +1493,21 @@ void AnalysisConfig::CollectShapeRangeInfo(
   shape_range_info_path_ = shape_range_info_path;
 }
 
+void AnalysisConfig::EnableShapeBucketing(const std::vector<int> &boundaries,
+                                          int axis,
+                                          float pad_value) {
+  PADDLE_ENFORCE_GE(axis,
+                    1,
+                    common::errors::InvalidArgument(
+                        "The axis of shape bucketing should not be the batch "
+                        "dim 0, but got %d.",
+                        axis));
+  use_shape_bucketing_ = true;
+  shape_bucket_boundaries_ = boundaries;
+  shape_bucket_axis_ = axis;
+  shape_bucket_pad_value_ = pad_value;
+}
+
 const std::string &AnalysisConfig::shape_range_info_path() const {
   return shape_range_info_path_;
 }
@@ -58,19 +58,23 @@
 #include "paddle/fluid/primitive/base/decomp_trans.h"
 #include "paddle/phi/api/include/context_pool.h"
 #include "paddle/phi/api/include/tensor.h"
+#include "paddle/phi/api/profiler/flight_recorder.h"
 #include "paddle/phi/backends/context_pool.h"
 #include "paddle/phi/common/backend.h"
 #include "paddle/phi/common/data_type.h"
 #include "paddle/phi/common/place.h"
 #include "paddle/phi/core/memory/memcpy.h"
+#include "paddle/phi/core/os_info.h"
 #include "paddle/phi/core/platform/cpu_helper.h"
 #include "paddle/phi/core/platform/device/gpu/gpu_info.h"
 #include "paddle/phi/core/platform/device/gpu/gpu_types.h"
 #include "paddle/phi/core/platform/device_context.h"
+#include "paddle/phi/core/platform/metrics_exporter.h"
 #include "paddle/phi/core/platform/profiler.h"
 
 #include "paddle/phi/core/generator.h"
 #include "paddle/phi/kernels/funcs/data_type_transform.h"
+#include "paddle/phi/kernels/funcs/packed_gemm_cache.h"
 #include "paddle/utils/string/split.h"
 
 #ifdef PADDLE_WITH_MKLML
@@ -440,6 +444,9 @@ bool AnalysisPredictor::Init(
   // no matter with or without OneDNN
   paddle::platform::SetNumThreads(config_.cpu_math_library_num_threads());
 
+  // Serves FLAGS_metrics_http_port / FLAGS_metrics_file, once per process.
+  platform::MetricsExporter::GetInstance().StartFromFlags();
+
   std::string model_path = config_.prog_file();
   if (!model_path.empty()) {
     load_pir_model_ =
@@ -513,11 +520,19 @@ bool AnalysisPredictor::Init(
 
   PrepareFeedFetch();
 
+  if (config_.shape_bucketing_enabled()) {
+    InitShapeBucketer();
+  }
+
   // Prepare executor, create local variables.
   if (!PrepareExecutor()) {
     return true;
   }
 
+  if (config_.packed_gemm_weight_enabled()) {
+    RegisterConstantWeights();
+  }
+
 #if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
   // TODO(inference): Now only gpu with external stream support private
   // device_context.
@@ -2574,6 +2589,13 @@ std::unique_ptr<ZeroCopyTensor> AnalysisPredictor::GetOutputTensor(
 }
 
 bool AnalysisPredictor::ZeroCopyRun(bool switch_stream) {
+  // Latency of the run is reported to the flight recorder, which dumps its
+  // events when the run breaks FLAGS_flight_recorder_slo_ms, and to the
+  // metrics registry.
+  const uint64_t run_start_ns =
+      FLAGS_enable_flight_recorder || platform::MetricsRegistry::IsEnabled()
+          ? phi::PosixInNsec()
+          : 0;
   inference::DisplayMemoryInfo(place_, "before run");
   if (private_context_) {
     phi::DeviceContextPool::SetDeviceContexts(&device_contexts_);
@@ -2581,6 +2603,9 @@ bool AnalysisPredictor::ZeroCopyRun(bool switch_stream) {
     pool.SyncDeviceContext(place_);
   }
   paddle::platform::SetNumThreads(config_.cpu_math_library_num_threads());
+  if (shape_bucketer_) {
+    shape_bucketer_->PadInputs(GetScopeTensors(GetInputNames()));
+  }
 #ifdef PADDLE_WITH_DNNL
   if (config_.use_mkldnn_) {
     std::vector<std::vector<int>> shape_vector;
@@ -2641,6 +2666,10 @@ bool AnalysisPredictor::ZeroCopyRun(bool switch_stream) {
   } else {
     executor_->Run();
   }
+  if (shape_bucketer_) {
+    shape_bucketer_->CutOutputs(GetScopeTensors(GetOutputNames()));
+    shape_bucketer_->RestoreInputs();
+  }
   inference::DisplayMemoryInfo(place_, "after run");
 
 #ifdef PADDLE_WITH_XPU
@@ -2681,6 +2710,20 @@ bool AnalysisPredictor::ZeroCopyRun(bool switch_stream) {
   // https://software.intel.com/en-us/mkl-developer-reference-c-mkl-free-buffers
   phi::dynload::MKL_Free_Buffers();
 #endif
+  if (run_start_ns != 0) {
+    const uint64_t latency_ns = phi::PosixInNsec() - run_start_ns;
+    if (FLAGS_enable_flight_recorder) {
+      phi::FlightRecorder::GetInstance().ReportLatency(
+          "AnalysisPredictor::ZeroCopyRun", latency_ns);
+    }
+    if (platform::MetricsRegistry::IsEnabled()) {
+      static platform::MetricHistogram *run_latency =
+          platform::MetricsRegistry::GetInstance().GetHistogram(
+              "paddle_predictor_run_latency_seconds",
+              "Latency of AnalysisPredictor::ZeroCopyRun.");
+      run_latency->Observe(static_cast<double>(latency_ns) * 1e-9);
+    }
+  }
   return true;
 }
 
@@ -2848,6 +2891,98 @@ bool AnalysisPredictor::ExpRunWithRuntimeConfig(void *config) {
   return false;
 }
 
+void AnalysisPredictor::RegisterConstantWeights() {
+  if (!phi::is_cpu_place(place_)) {
+    LOG(WARNING) << "Packed weights only work on cpu, it is ignored.";
+    return;
+  }
+  std::vector<std::string> param_names;
+  if (config_.new_ir_enabled()) {
+    for (auto op : pir_program_->block()->ops()) {
+      if (op->isa<::pir::ParameterOp>()) {
+        param_names.push_back(op->dyn_cast<::pir::ParameterOp>().param_name());
+      } else if (op->isa<::pir::ConstantTensorOp>()) {
+        param_names.push_back(
+            op->dyn_cast<::pir::ConstantTensorOp>().tensor_name());
+      }
+    }
+  } else {
+    // Other persistable vars, e.g. states updated by the ops, may be written
+    // by a run, so only the parameters are registered.
+    for (auto *var_desc : inference_program_->Block(0).AllVars()) {
+      if (var_desc->Persistable() && var_desc->IsParameter()) {
+        param_names.push_back(var_desc->Name());
+      }
+    }
+  }
+  // The parameters are loaded by now and are not written by any run.
+  auto &cache = phi::funcs::PackedWeightCache::Instance();
+  for (auto &name : param_names) {
+    auto *var = sub_scope_->FindVar(name);
+    if (var && var->IsType<phi::DenseTensor>() &&
+        var->Get<phi::DenseTensor>().initialized()) {
+      cache.RegisterConstant(var->Get<phi::DenseTensor>());
+    }
+  }
+}
+
+void AnalysisPredictor::InitShapeBucketer() {
+  if (!phi::is_cpu_place(place_)) {
+    LOG(WARNING) << "Shape bucketing only works on cpu, it is ignored.";
+    return;
+  }
+  int axis = config_.shape_bucket_axis();
+  // Cap the padded length by the max length seen when collecting the shape
+  // range info, so that the tail bucket is not much larger than needed.
+  int max_length = 0;
+  const auto &shape_range_info_path = config_.shape_range_info_path();
+  if (config_.shape_bucket_boundaries().empty() &&
+      !shape_range_info_path.empty() && FileExists(shape_range_info_path) &&
+      !GetInputNames().empty()) {
+    std::map<std::string, std::vector<int32_t>> min_shapes;
+    std::map<std::string, std::vector<int32_t>> max_shapes;
+    std::map<std::string, std::vector<int32_t>> opt_shapes;
+    std::map<std::string, std::vector<int32_t>> min_values;
+    std::map<std::string, std::vector<int32_t>> max_values;
+    std::map<std::string, std::vector<int32_t>> opt_values;
+    inference::DeserializeShapeRangeInfo(shape_range_info_path,
+                                         &min_shapes,
+                                         &max_shapes,
+                                         &opt_shapes,
+                                         &min_values,
+                                         &max_values,
+                                         &opt_values);
+    for (const auto &name : GetInputNames()) {
+      auto iter = max_shapes.find(name);
+      if (iter != max_shapes.end() &&
+          static_cast<int>(iter->second.size()) > axis) {
+        max_length = iter->second[axis];
+        break;
+      }
+    }
+  }
+  VLOG(3) << "Enable shape bucketing on axis " << axis
+          << " with max length " << max_length;
+  shape_bucketer_ = std::make_unique<details::ShapeBucketer>(
+      config_.shape_bucket_boundaries(),
+      axis,
+      config_.shape_bucket_pad_value(),
+      max_length);
+}
+
+std::vector<phi::DenseTensor *> AnalysisPredictor::GetScopeTensors(
+    const std::vector<std::string> &names) {
+  auto *scope = executor_->GetScope();
+  std::vector<phi::DenseTensor *> tensors;
+  for (const auto &name : names) {
+    auto *var = scope->FindVar(name);
+    if (var != nullptr && var->IsType<phi::DenseTensor>()) {
+      tensors.push_back(var->GetMutable<phi::DenseTensor>());
+    }
+  }
+  return tensors;
+}
+
 void AnalysisPredictor::StatisticShapeRangeInfo() {
   std::map<std::string, std::vector<int32_t>> min_shapes;
   std::map<std::string, std::vector<int32_t>> max_shapes;
@@ -25,6 +25,7 @@
 #include "paddle/fluid/inference/analysis/analyzer.h"
 #include "paddle/fluid/inference/api/api_impl.h"
 #include "paddle/fluid/inference/api/details/reset_tensor_array.h"
+#include "paddle/fluid/inference/api/details/shape_bucketer.h"
 #include "paddle/fluid/inference/api/helper.h"
 #include "paddle/fluid/inference/api/paddle_inference_api.h"
 #include "paddle/fluid/inference/api/resource_manager.h"
@@ -503,6 +504,11 @@ class AnalysisPredictor : public PaddlePredictor {
  private:
   void StatisticShapeRangeInfo();
   void HookCollectShapeRangeInfo();
+  void InitShapeBucketer();
+  // Lets the cpu matmul and fc kernels pack the parameters once.
+  void RegisterConstantWeights();
+  std::vector<phi::DenseTensor *> GetScopeTensors(
+      const std::vector<std::string> &names);
   void InitPlace();
   void InitDeviceContexts();
   void InitResourceManager(void *stream);
@@ -537,6 +543,8 @@ class AnalysisPredictor : public PaddlePredictor {
   // concurrency problems, wrong results and memory leak, so cache them.
   std::vector<phi::DenseTensor> feed_tensors_;
   details::TensorArrayBatchCleaner tensor_array_batch_cleaner_;
+  // Pads the inputs to bucketed shapes if shape bucketing is enabled.
+  std::unique_ptr<details::ShapeBucketer> shape_bucketer_;
   // A mutex help to make Clone thread safe.
   std::mutex clone_mutex_;
   static int clone_num_;
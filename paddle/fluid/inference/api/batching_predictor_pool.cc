@@ -0,0 +1,523 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <future>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "glog/logging.h"
+#include "paddle/fluid/inference/api/paddle_inference_api.h"
+#include "paddle/fluid/platform/enforce.h"
+#include "paddle/phi/common/bfloat16.h"
+#include "paddle/phi/common/float16.h"
+
+namespace paddle_infer {
+namespace services {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// 2^31 us is more than half an hour, which is long enough for a request.
+constexpr size_t kLatencyBuckets = 32;
+
+template <typename Visitor>
+void VisitDataType(DataType dtype, Visitor&& visitor) {
+  switch (dtype) {
+    case DataType::FLOAT32:
+      visitor(float());
+      break;
+    case DataType::INT64:
+      visitor(int64_t());
+      break;
+    case DataType::INT32:
+      visitor(int32_t());
+      break;
+    case DataType::UINT8:
+      visitor(uint8_t());
+      break;
+    case DataType::INT8:
+      visitor(int8_t());
+      break;
+    case DataType::FLOAT16:
+      visitor(phi::dtype::float16());
+      break;
+    case DataType::BOOL:
+      visitor(bool());
+      break;
+    case DataType::FLOAT64:
+      visitor(double());
+      break;
+    case DataType::BFLOAT16:
+      visitor(phi::dtype::bfloat16());
+      break;
+    default:
+      PADDLE_THROW(common::errors::Unimplemented(
+          "Unsupported data type %d in BatchingPredictorPool.",
+          static_cast<int>(dtype)));
+  }
+}
+
+size_t SizeOfDataType(DataType dtype) {
+  size_t size = 0;
+  VisitDataType(dtype, [&](auto tag) { size = sizeof(tag); });
+  return size;
+}
+
+int64_t Numel(const std::vector<int>& shape) {
+  int64_t numel = 1;
+  for (int dim : shape) {
+    numel *= dim;
+  }
+  return numel;
+}
+
+size_t LatencyBucket(int64_t latency_us) {
+  size_t bucket = 0;
+  while (latency_us > 1 && bucket + 1 < kLatencyBuckets) {
+    latency_us >>= 1;
+    ++bucket;
+  }
+  return bucket;
+}
+
+// Zero pad the second dim of `tensor` to the smallest bucket not less than it.
+void PadToBucket(const std::vector<int>& buckets, ServingTensor* tensor) {
+  if (buckets.empty() || tensor->shape.size() < 2) {
+    return;
+  }
+  int length = tensor->shape[1];
+  auto bucket = std::lower_bound(buckets.begin(), buckets.end(), length);
+  if (bucket == buckets.end() || *bucket == length) {
+    return;
+  }
+  int64_t outer = tensor->shape[0];
+  int64_t inner = Numel(tensor->shape) / outer / std::max(length, 1) *
+                  static_cast<int64_t>(SizeOfDataType(tensor->dtype));
+  std::vector<char> padded(outer * (*bucket) * inner, 0);
+  for (int64_t i = 0; i < outer; ++i) {
+    std::memcpy(padded.data() + i * (*bucket) * inner,
+                tensor->data.data() + i * length * inner,
+                length * inner);
+  }
+  tensor->data.swap(padded);
+  tensor->shape[1] = *bucket;
+}
+
+}  // namespace
+
+int64_t ServingStats::TotalLatencyPercentile(double percent) const {
+  uint64_t total = 0;
+  for (auto count : total_latency_us) {
+    total += count;
+  }
+  if (total == 0) {
+    return 0;
+  }
+  uint64_t target = static_cast<uint64_t>(
+      std::ceil(static_cast<double>(total) * percent / 100.0));
+  uint64_t seen = 0;
+  for (size_t i = 0; i < total_latency_us.size(); ++i) {
+    seen += total_latency_us[i];
+    if (seen >= std::max<uint64_t>(target, 1)) {
+      return int64_t(1) << (i + 1);
+    }
+  }
+  return int64_t(1) << total_latency_us.size();
+}
+
+class BatchingPredictorPool::Impl {
+ public:
+  Impl(const Config& config, const BatchingOptions& options)
+      : options_(options),
+        pool_(config, options.num_workers),
+        queue_latency_us_(kLatencyBuckets, 0),
+        total_latency_us_(kLatencyBuckets, 0) {
+    PADDLE_ENFORCE_GE(options_.max_batch_size,
+                      1,
+                      common::errors::InvalidArgument(
+                          "The max_batch_size should be at least 1, but got "
+                          "%d.",
+                          options_.max_batch_size));
+    PADDLE_ENFORCE_GE(options_.max_queue_size,
+                      1UL,
+                      common::errors::InvalidArgument(
+                          "The max_queue_size should be at least 1, but got "
+                          "%d.",
+                          options_.max_queue_size));
+    std::sort(options_.seq_len_buckets.begin(), options_.seq_len_buckets.end());
+    for (size_t i = 0; i < options_.num_workers; ++i) {
+      workers_.emplace_back([this, i] { WorkLoop(pool_.Retrieve(i)); });
+    }
+  }
+
+  ~Impl() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    not_empty_.notify_all();
+    not_full_.notify_all();
+    for (auto& worker : workers_) {
+      worker.join();
+    }
+  }
+
+  std::future<std::vector<ServingTensor>> Submit(
+      std::vector<ServingTensor> inputs) {
+    auto request = std::make_unique<Request>();
+    request->enqueue_time = Clock::now();
+    request->rows = Validate(&inputs);
+    for (auto& input : inputs) {
+      PadToBucket(options_.seq_len_buckets, &input);
+      request->key += input.name + ":" +
+                      std::to_string(static_cast<int>(input.dtype)) + "[";
+      for (size_t i = 1; i < input.shape.size(); ++i) {
+        request->key += std::to_string(input.shape[i]) + ",";
+      }
+      request->key += "];";
+    }
+    request->inputs = std::move(inputs);
+    auto future = request->promise.get_future();
+
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      not_full_.wait(lock, [this] {
+        return stop_ || queue_.size() < options_.max_queue_size;
+      });
+      PADDLE_ENFORCE_EQ(stop_,
+                        false,
+                        common::errors::PreconditionNotMet(
+                            "The BatchingPredictorPool is stopped."));
+      queue_.emplace_back(std::move(request));
+    }
+    not_empty_.notify_all();
+    return future;
+  }
+
+  ServingStats GetStats() const {
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    ServingStats stats;
+    stats.num_requests = num_requests_;
+    stats.num_batches = num_batches_;
+    stats.num_rows = num_rows_;
+    stats.queue_latency_us = queue_latency_us_;
+    stats.total_latency_us = total_latency_us_;
+    return stats;
+  }
+
+ private:
+  struct Request {
+    std::vector<ServingTensor> inputs;
+    int rows{0};
+    // The inputs of requests with the same key can be concatenated.
+    std::string key;
+    Clock::time_point enqueue_time;
+    std::promise<std::vector<ServingTensor>> promise;
+  };
+
+  // The host buffers of a worker, reused across batches.
+  struct Workspace {
+    std::vector<std::vector<char>> inputs;
+    std::vector<char> output;
+  };
+
+  int Validate(std::vector<ServingTensor>* inputs) {
+    PADDLE_ENFORCE_EQ(inputs->empty(),
+                      false,
+                      common::errors::InvalidArgument(
+                          "The request of BatchingPredictorPool should have "
+                          "at least one input."));
+    int rows = -1;
+    for (const auto& input : *inputs) {
+      PADDLE_ENFORCE_EQ(
+          input.shape.empty(),
+          false,
+          common::errors::InvalidArgument(
+              "The input %s should have the batch dim.", input.name));
+      PADDLE_ENFORCE_GT(input.shape[0],
+                        0,
+                        common::errors::InvalidArgument(
+                            "The batch dim of input %s should be positive.",
+                            input.name));
+      if (rows == -1) {
+        rows = input.shape[0];
+      }
+      PADDLE_ENFORCE_EQ(input.shape[0],
+                        rows,
+                        common::errors::InvalidArgument(
+                            "All the inputs of a request should have the same "
+                            "batch dim, but input %s has %d while others have "
+                            "%d.",
+                            input.name,
+                            input.shape[0],
+                            rows));
+      size_t bytes = Numel(input.shape) * SizeOfDataType(input.dtype);
+      PADDLE_ENFORCE_EQ(
+          input.data.size(),
+          bytes,
+          common::errors::InvalidArgument(
+              "The input %s should have %d bytes of data, but got %d.",
+              input.name,
+              bytes,
+              input.data.size()));
+    }
+    return rows;
+  }
+
+  // Pop the oldest request and the later requests which can be batched with
+  // it. It waits until the batch is full or the oldest request times out.
+  std::vector<std::unique_ptr<Request>> NextBatch() {
+    std::vector<std::unique_ptr<Request>> batch;
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (batch.empty()) {
+      not_empty_.wait(lock, [this] { return stop_ || !queue_.empty(); });
+      if (queue_.empty()) {
+        return batch;
+      }
+      const Request* oldest = queue_.front().get();
+      auto deadline = oldest->enqueue_time +
+                      std::chrono::microseconds(options_.max_queue_delay_us);
+      while (!stop_ && Clock::now() < deadline &&
+             BatchableRows(*oldest) < options_.max_batch_size) {
+        not_empty_.wait_until(lock, deadline);
+        // Another worker may take the oldest request while waiting.
+        if (queue_.empty() || queue_.front().get() != oldest) {
+          break;
+        }
+      }
+      if (queue_.empty() || queue_.front().get() != oldest) {
+        continue;
+      }
+
+      int rows = 0;
+      for (auto iter = queue_.begin(); iter != queue_.end();) {
+        bool fits = rows + (*iter)->rows <= options_.max_batch_size;
+        if (iter == queue_.begin() || ((*iter)->key == oldest->key && fits)) {
+          rows += (*iter)->rows;
+          batch.emplace_back(std::move(*iter));
+          iter = queue_.erase(iter);
+        } else {
+          ++iter;
+        }
+        if (rows >= options_.max_batch_size) {
+          break;
+        }
+      }
+    }
+    lock.unlock();
+    not_full_.notify_all();
+    return batch;
+  }
+
+  int BatchableRows(const Request& oldest) const {
+    int rows = 0;
+    for (const auto& request : queue_) {
+      if (request->key == oldest.key) {
+        rows += request->rows;
+        if (rows >= options_.max_batch_size) {
+          break;
+        }
+      }
+    }
+    return rows;
+  }
+
+  void WorkLoop(Predictor* predictor) {
+    Workspace workspace;
+    while (true) {
+      auto batch = NextBatch();
+      if (batch.empty()) {
+        return;
+      }
+      auto start_time = Clock::now();
+      try {
+        RunBatch(predictor, batch, &workspace);
+      } catch (...) {
+        for (auto& request : batch) {
+          request->promise.set_exception(std::current_exception());
+        }
+      }
+      RecordStats(batch, start_time);
+    }
+  }
+
+  void RunBatch(Predictor* predictor,
+                const std::vector<std::unique_ptr<Request>>& batch,
+                Workspace* workspace) {
+    int total_rows = 0;
+    for (const auto& request : batch) {
+      total_rows += request->rows;
+    }
+    VLOG(4) << "BatchingPredictorPool runs " << batch.size()
+            << " requests with " << total_rows << " rows.";
+
+    // 1. Concatenate the inputs along the batch dim
+    const auto& first_inputs = batch.front()->inputs;
+    workspace->inputs.resize(first_inputs.size());
+    for (size_t i = 0; i < first_inputs.size(); ++i) {
+      std::vector<int> shape = first_inputs[i].shape;
+      shape[0] = total_rows;
+      const char* data = first_inputs[i].data.data();
+      if (batch.size() > 1) {
+        auto& buffer = workspace->inputs[i];
+        buffer.resize(Numel(shape) * SizeOfDataType(first_inputs[i].dtype));
+        size_t offset = 0;
+        for (const auto& request : batch) {
+          const auto& input = request->inputs[i];
+          std::memcpy(
+              buffer.data() + offset, input.data.data(), input.data.size());
+          offset += input.data.size();
+        }
+        data = buffer.data();
+      }
+
+      auto handle = predictor->GetInputHandle(first_inputs[i].name);
+      VisitDataType(first_inputs[i].dtype, [&](auto tag) {
+        using T = decltype(tag);
+        if (handle->place() == PlaceType::kCPU) {
+          // The host buffer outlives the run, so share it without a copy.
+          handle->ShareExternalData<T>(
+              reinterpret_cast<const T*>(data), shape, PlaceType::kCPU);
+        } else {
+          handle->Reshape(shape);
+          handle->CopyFromCpu<T>(reinterpret_cast<const T*>(data));
+        }
+      });
+    }
+
+    // 2. Run the batch
+    PADDLE_ENFORCE_EQ(predictor->Run(),
+                      true,
+                      common::errors::External(
+                          "Failed to run a batch of %d requests.",
+                          batch.size()));
+
+    // 3. Split the outputs back to the requests
+    std::vector<std::vector<ServingTensor>> outputs(batch.size());
+    for (const auto& name : predictor->GetOutputNames()) {
+      auto handle = predictor->GetOutputHandle(name);
+      std::vector<int> shape = handle->shape();
+      PADDLE_ENFORCE_EQ(
+          !shape.empty() && shape[0] == total_rows,
+          true,
+          common::errors::PreconditionNotMet(
+              "The first dim of output %s should be the batch dim %d.",
+              name,
+              total_rows));
+      DataType dtype = handle->type();
+      size_t row_bytes = Numel(shape) / total_rows * SizeOfDataType(dtype);
+
+      const char* data = nullptr;
+      VisitDataType(dtype, [&](auto tag) {
+        using T = decltype(tag);
+        PlaceType place;
+        int size = 0;
+        if (handle->place() == PlaceType::kCPU) {
+          data = reinterpret_cast<const char*>(handle->data<T>(&place, &size));
+        } else {
+          workspace->output.resize(row_bytes * total_rows);
+          handle->CopyToCpu<T>(reinterpret_cast<T*>(workspace->output.data()));
+          data = workspace->output.data();
+        }
+      });
+
+      // Copy every slice straight into the output owned by its request.
+      size_t offset = 0;
+      for (size_t i = 0; i < batch.size(); ++i) {
+        size_t bytes = row_bytes * batch[i]->rows;
+        ServingTensor output;
+        output.name = name;
+        output.shape = shape;
+        output.shape[0] = batch[i]->rows;
+        output.dtype = dtype;
+        output.data.assign(data + offset, data + offset + bytes);
+        outputs[i].emplace_back(std::move(output));
+        offset += bytes;
+      }
+    }
+
+    for (size_t i = 0; i < batch.size(); ++i) {
+      batch[i]->promise.set_value(std::move(outputs[i]));
+    }
+  }
+
+  void RecordStats(const std::vector<std::unique_ptr<Request>>& batch,
+                   Clock::time_point start_time) {
+    auto end_time = Clock::now();
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    ++num_batches_;
+    for (const auto& request : batch) {
+      ++num_requests_;
+      num_rows_ += request->rows;
+      auto queue_us = std::chrono::duration_cast<std::chrono::microseconds>(
+                          start_time - request->enqueue_time)
+                          .count();
+      auto total_us = std::chrono::duration_cast<std::chrono::microseconds>(
+                          end_time - request->enqueue_time)
+                          .count();
+      ++queue_latency_us_[LatencyBucket(queue_us)];
+      ++total_latency_us_[LatencyBucket(total_us)];
+    }
+  }
+
+  BatchingOptions options_;
+  PredictorPool pool_;
+  std::vector<std::thread> workers_;
+
+  std::mutex mutex_;
+  std::condition_variable not_empty_;
+  std::condition_variable not_full_;
+  std::deque<std::unique_ptr<Request>> queue_;
+  bool stop_{false};
+
+  mutable std::mutex stats_mutex_;
+  uint64_t num_requests_{0};
+  uint64_t num_batches_{0};
+  uint64_t num_rows_{0};
+  std::vector<uint64_t> queue_latency_us_;
+  std::vector<uint64_t> total_latency_us_;
+};
+
+BatchingPredictorPool::BatchingPredictorPool(const Config& config,
+                                             const BatchingOptions& options)
+    : impl_(new Impl(config, options)) {}
+
+BatchingPredictorPool::~BatchingPredictorPool() = default;
+
+std::future<std::vector<ServingTensor>> BatchingPredictorPool::Submit(
+    std::vector<ServingTensor> inputs) {
+  return impl_->Submit(std::move(inputs));
+}
+
+std::vector<ServingTensor> BatchingPredictorPool::Run(
+    std::vector<ServingTensor> inputs) {
+  return Submit(std::move(inputs)).get();
+}
+
+ServingStats BatchingPredictorPool::GetStats() const {
+  return impl_->GetStats();
+}
+
+}  // namespace services
+}  // namespace paddle_infer
@@ -0,0 +1,206 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/inference/api/details/shape_bucketer.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "glog/logging.h"
+#include "paddle/phi/common/place.h"
+#include "paddle/phi/core/enforce.h"
+#include "paddle/phi/core/visit_type.h"
+
+namespace paddle::details {
+
+namespace {
+
+// Copy the overlapped block of two row-major tensors of the same rank.
+void CopyBlock(const char* src,
+               const phi::DDim& src_dims,
+               char* dst,
+               const phi::DDim& dst_dims,
+               size_t element_size) {
+  int rank = src_dims.size();
+  if (rank == 0) {
+    std::memcpy(dst, src, element_size);
+    return;
+  }
+  std::vector<int64_t> extent(rank);
+  std::vector<int64_t> src_stride(rank);
+  std::vector<int64_t> dst_stride(rank);
+  int64_t src_step = static_cast<int64_t>(element_size);
+  int64_t dst_step = static_cast<int64_t>(element_size);
+  for (int i = rank - 1; i >= 0; --i) {
+    extent[i] = std::min(src_dims[i], dst_dims[i]);
+    src_stride[i] = src_step;
+    dst_stride[i] = dst_step;
+    src_step *= src_dims[i];
+    dst_step *= dst_dims[i];
+  }
+
+  // Copy the innermost dim row by row, walking the outer dims like an
+  // odometer.
+  int64_t row_bytes = extent[rank - 1] * static_cast<int64_t>(element_size);
+  int64_t rows = 1;
+  for (int i = 0; i < rank - 1; ++i) {
+    rows *= extent[i];
+  }
+  std::vector<int64_t> index(rank, 0);
+  for (int64_t row = 0; row < rows; ++row) {
+    int64_t src_offset = 0;
+    int64_t dst_offset = 0;
+    for (int i = 0; i < rank - 1; ++i) {
+      src_offset += index[i] * src_stride[i];
+      dst_offset += index[i] * dst_stride[i];
+    }
+    std::memcpy(dst + dst_offset, src + src_offset, row_bytes);
+    for (int i = rank - 2; i >= 0; --i) {
+      if (++index[i] < extent[i]) {
+        break;
+      }
+      index[i] = 0;
+    }
+  }
+}
+
+// Return `dims` with every non-batch dim equal to `from` changed to `to`.
+phi::DDim ReplaceDims(const phi::DDim& dims, int64_t from, int64_t to) {
+  phi::DDim result = dims;
+  for (int i = 1; i < dims.size(); ++i) {
+    if (dims[i] == from) {
+      result[i] = to;
+    }
+  }
+  return result;
+}
+
+}  // namespace
+
+ShapeBucketer::ShapeBucketer(std::vector<int> boundaries,
+                             int axis,
+                             float pad_value,
+                             int max_length)
+    : boundaries_(std::move(boundaries)),
+      axis_(axis),
+      pad_value_(pad_value),
+      max_length_(max_length) {
+  PADDLE_ENFORCE_GE(axis_,
+                    1,
+                    common::errors::InvalidArgument(
+                        "The bucketed axis should not be the batch dim 0, but "
+                        "got %d.",
+                        axis_));
+  std::sort(boundaries_.begin(), boundaries_.end());
+}
+
+int ShapeBucketer::Bucket(int length) const {
+  if (!boundaries_.empty()) {
+    auto iter =
+        std::lower_bound(boundaries_.begin(), boundaries_.end(), length);
+    return iter == boundaries_.end() ? length : *iter;
+  }
+  if (max_length_ > 0 && length >= max_length_) {
+    return length;
+  }
+  int bucket = 1;
+  while (bucket < length) {
+    bucket <<= 1;
+  }
+  return max_length_ > 0 ? std::min(bucket, max_length_) : bucket;
+}
+
+void ShapeBucketer::PadInputs(const std::vector<phi::DenseTensor*>& inputs) {
+  length_ = -1;
+  padded_length_ = -1;
+  for (auto* input : inputs) {
+    if (input->dims().size() > axis_) {
+      length_ = static_cast<int>(input->dims()[axis_]);
+      break;
+    }
+  }
+  if (length_ <= 0) {
+    return;
+  }
+  padded_length_ = Bucket(length_);
+  ++bucket_runs_[padded_length_];
+  VLOG(4) << "Bucket length " << length_ << " to " << padded_length_
+          << ", which has run " << bucket_runs_[padded_length_] << " times.";
+  if (padded_length_ == length_) {
+    return;
+  }
+
+  for (auto* input : inputs) {
+    if (!input->initialized() || !input->lod().empty() ||
+        input->place().GetType() != phi::AllocationType::CPU) {
+      continue;
+    }
+    phi::DDim padded_dims = ReplaceDims(input->dims(), length_, padded_length_);
+    if (padded_dims == input->dims()) {
+      continue;
+    }
+    phi::DenseTensor padded;
+    padded.Resize(padded_dims);
+    PD_VISIT_ALL_TYPES(input->dtype(), "ShapeBucketer::PadInputs", ([&] {
+                         auto* data = padded.mutable_data<data_t>(
+                             phi::CPUPlace());
+                         std::fill_n(data,
+                                     padded.numel(),
+                                     static_cast<data_t>(pad_value_));
+                       }));
+    CopyBlock(static_cast<const char*>(input->data()),
+              input->dims(),
+              static_cast<char*>(padded.data()),
+              padded_dims,
+              phi::SizeOf(input->dtype()));
+    saved_inputs_.emplace_back(input, *input);
+    *input = std::move(padded);
+  }
+}
+
+void ShapeBucketer::CutOutputs(
+    const std::vector<phi::DenseTensor*>& outputs) const {
+  if (length_ <= 0 || padded_length_ == length_) {
+    return;
+  }
+  for (auto* output : outputs) {
+    if (!output->initialized() ||
+        output->place().GetType() != phi::AllocationType::CPU) {
+      continue;
+    }
+    phi::DDim cut_dims = ReplaceDims(output->dims(), padded_length_, length_);
+    if (cut_dims == output->dims()) {
+      continue;
+    }
+    phi::DenseTensor cut;
+    cut.Resize(cut_dims);
+    cut.mutable_data(phi::CPUPlace(), output->dtype());
+    CopyBlock(static_cast<const char*>(output->data()),
+              output->dims(),
+              static_cast<char*>(cut.data()),
+              cut_dims,
+              phi::SizeOf(output->dtype()));
+    cut.set_lod(output->lod());
+    *output = std::move(cut);
+  }
+}
+
+void ShapeBucketer::RestoreInputs() {
+  for (auto& item : saved_inputs_) {
+    *item.first = std::move(item.second);
+  }
+  saved_inputs_.clear();
+}
+
+}  // namespace paddle::details
@@ -0,0 +1,75 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "paddle/phi/core/dense_tensor.h"
+
+namespace paddle {
+namespace details {
+
+// Pad the dynamic length of the inputs up to bucket boundaries, so that runs
+// with close lengths share the same shapes. Within a bucket the predictor then
+// reuses the buffers allocated by the previous runs and hits the cached oneDNN
+// primitives instead of creating new ones for every length.
+//
+// The length is the `axis` dim of the first input whose rank is larger than
+// `axis`. Every non-batch dim of the inputs equal to the length is padded with
+// `pad_value`, and every non-batch dim of the outputs equal to the padded
+// length is cut back after the run.
+class ShapeBucketer {
+ public:
+  // If `boundaries` is empty, the length is padded to the next power of 2,
+  // which is capped by `max_length` when it is positive.
+  ShapeBucketer(std::vector<int> boundaries,
+                int axis,
+                float pad_value,
+                int max_length = 0);
+
+  // The padded length of `length`.
+  int Bucket(int length) const;
+
+  // Pad the cpu inputs in place. The unpadded tensors are kept until
+  // RestoreInputs.
+  void PadInputs(const std::vector<phi::DenseTensor*>& inputs);
+
+  // Cut the padded dims of the cpu outputs of the last run back.
+  void CutOutputs(const std::vector<phi::DenseTensor*>& outputs) const;
+
+  // Put the unpadded inputs back, so that the inputs look untouched to users.
+  void RestoreInputs();
+
+  int length() const { return length_; }
+  int padded_length() const { return padded_length_; }
+
+ private:
+  std::vector<int> boundaries_;
+  int axis_;
+  float pad_value_;
+  int max_length_;
+
+  int length_{-1};
+  int padded_length_{-1};
+  std::vector<std::pair<phi::DenseTensor*, phi::DenseTensor>> saved_inputs_;
+  // The number of runs of every bucket.
+  std::unordered_map<int, uint64_t> bucket_runs_;
+};
+
+}  // namespace details
+}  // namespace paddle
@@ -0,0 +1,100 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/inference/api/details/shape_bucketer.h"
+
+#include <gtest/gtest.h>
+
+#include "paddle/phi/common/place.h"
+
+namespace paddle {
+namespace details {
+
+namespace {
+
+phi::DenseTensor MakeTensor(const std::vector<int64_t>& dims) {
+  phi::DenseTensor tensor;
+  tensor.Resize(common::make_ddim(dims));
+  auto* data = tensor.mutable_data<float>(phi::CPUPlace());
+  for (int64_t i = 0; i < tensor.numel(); ++i) {
+    data[i] = static_cast<float>(i + 1);
+  }
+  return tensor;
+}
+
+}  // namespace
+
+TEST(ShapeBucketer, bucket) {
+  ShapeBucketer with_boundaries({64, 16, 32}, 1, 0.f);
+  EXPECT_EQ(with_boundaries.Bucket(1), 16);
+  EXPECT_EQ(with_boundaries.Bucket(16), 16);
+  EXPECT_EQ(with_boundaries.Bucket(17), 32);
+  EXPECT_EQ(with_boundaries.Bucket(100), 100);
+
+  ShapeBucketer power_of_two({}, 1, 0.f, 48);
+  EXPECT_EQ(power_of_two.Bucket(5), 8);
+  EXPECT_EQ(power_of_two.Bucket(32), 32);
+  EXPECT_EQ(power_of_two.Bucket(33), 48);
+  EXPECT_EQ(power_of_two.Bucket(60), 60);
+}
+
+TEST(ShapeBucketer, pad_and_cut) {
+  ShapeBucketer bucketer({8}, 1, -1.f);
+  // ids [batch, length] and mask [batch, 1, length, length]
+  phi::DenseTensor ids = MakeTensor({2, 5});
+  phi::DenseTensor mask = MakeTensor({2, 1, 5, 5});
+  bucketer.PadInputs({&ids, &mask});
+  EXPECT_EQ(bucketer.length(), 5);
+  EXPECT_EQ(bucketer.padded_length(), 8);
+  EXPECT_EQ(ids.dims(), common::make_ddim({2, 8}));
+  EXPECT_EQ(mask.dims(), common::make_ddim({2, 1, 8, 8}));
+
+  const float* ids_data = ids.data<float>();
+  for (int i = 0; i < 2; ++i) {
+    for (int j = 0; j < 8; ++j) {
+      float expected = j < 5 ? static_cast<float>(i * 5 + j + 1) : -1.f;
+      EXPECT_EQ(ids_data[i * 8 + j], expected);
+    }
+  }
+  const float* mask_data = mask.data<float>();
+  EXPECT_EQ(mask_data[0], 1.f);
+  EXPECT_EQ(mask_data[8 + 4], 10.f);
+  EXPECT_EQ(mask_data[8 + 5], -1.f);
+  EXPECT_EQ(mask_data[5 * 8], -1.f);
+
+  // out [batch, length, hidden] whose hidden happens to be 3
+  phi::DenseTensor out = MakeTensor({2, 8, 3});
+  bucketer.CutOutputs({&out});
+  EXPECT_EQ(out.dims(), common::make_ddim({2, 5, 3}));
+  const float* out_data = out.data<float>();
+  EXPECT_EQ(out_data[0], 1.f);
+  EXPECT_EQ(out_data[5 * 3], 25.f);
+
+  bucketer.RestoreInputs();
+  EXPECT_EQ(ids.dims(), common::make_ddim({2, 5}));
+  EXPECT_EQ(mask.dims(), common::make_ddim({2, 1, 5, 5}));
+  EXPECT_EQ(ids.data<float>()[9], 10.f);
+}
+
+TEST(ShapeBucketer, length_on_boundary) {
+  ShapeBucketer bucketer({4, 8}, 1, 0.f);
+  phi::DenseTensor ids = MakeTensor({1, 8});
+  bucketer.PadInputs({&ids});
+  EXPECT_EQ(ids.dims(), common::make_ddim({1, 8}));
+  bucketer.RestoreInputs();
+  EXPECT_EQ(ids.dims(), common::make_ddim({1, 8}));
+}
+
+}  // namespace details
+}  // namespace paddle
@@ -738,6 +738,57 @@ struct PD_INFER_DECL AnalysisConfig {
   ///
   bool shape_range_info_collected() const;
 
+  ///
+  /// \brief Pad the dynamic length of the inputs to bucket boundaries on cpu,
+  /// so that runs with close lengths share the same shapes, buffers and
+  /// OneDNN primitives, and the latency is stable across lengths.
+  ///
+  /// The length is the \param axis dim of the first input. Every non-batch
+  /// dim of the inputs equal to the length is padded with \param pad_value,
+  /// and every non-batch dim of the outputs equal to the padded length is cut
+  /// back. It only suits models in which the padded positions do not change
+  /// the others, e.g. transformers whose attention mask is an input padded
+  /// with 0.
+  ///
+  /// \param boundaries The sorted bucket boundaries. If it is empty, the
+  /// length is padded to the next power of 2, capped by the max length in
+  /// shape_range_info_path() if it exists.
+  /// \param axis The dim of the length.
+  /// \param pad_value The value to pad the inputs with.
+  ///
+  void EnableShapeBucketing(const std::vector<int>& boundaries = {},
+                            int axis = 1,
+                            float pad_value = 0.f);
+
+  ///
+  /// \brief A boolean state telling whether the input shapes are bucketed.
+  ///
+  /// \return bool Whether the input shapes are bucketed.
+  ///
+  bool shape_bucketing_enabled() const { return use_shape_bucketing_; }
+  const std::vector<int>& shape_bucket_boundaries() const {
+    return shape_bucket_boundaries_;
+  }
+  int shape_bucket_axis() const { return shape_bucket_axis_; }
+  float shape_bucket_pad_value() const { return shape_bucket_pad_value_; }
+
+  ///
+  /// \brief Pack the weights of the fp32 and fp64 matmul and fc on cpu once,
+  /// so that their GEMMs, especially the small batch ones, skip repacking the
+  /// weights at every run. It costs the memory of a packed copy of each
+  /// weight, which lives as long as the parameters of the predictor.
+  ///
+  /// \param x Whether to pack the weights.
+  ///
+  void EnablePackedGemmWeight(bool x = true) { use_packed_gemm_weight_ = x; }
+
+  ///
+  /// \brief A boolean state telling whether the GEMM weights are packed.
+  ///
+  /// \return bool Whether the GEMM weights are packed.
+  ///
+  bool packed_gemm_weight_enabled() const { return use_packed_gemm_weight_; }
+
   ///
   /// \brief Prevent ops running in Paddle-TRT
   /// NOTE: just experimental, not an official stable API, easy to be broken.
@@ -1237,6 +1288,15 @@ struct PD_INFER_DECL AnalysisConfig {
   bool collect_shape_range_info_{false};
   std::string shape_range_info_path_;
 
+  // Pad the dynamic length of the inputs to bucket boundaries.
+  bool use_shape_bucketing_{false};
+  std::vector<int> shape_bucket_boundaries_;
+  int shape_bucket_axis_{1};
+  float shape_bucket_pad_value_{0.f};
+
+  // Pack the weights of the cpu GEMMs once.
+  bool use_packed_gemm_weight_{false};
+
   // memory reuse related.
   bool enable_memory_optim_{false};
   bool trt_engine_memory_sharing_{true};
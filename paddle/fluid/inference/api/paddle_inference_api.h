@@ -22,6 +22,8 @@ limitations under the License. */
 #pragma once
 
 #include <cassert>
+#include <cstdint>
+#include <future>
 #include <map>
 #include <memory>
 #include <string>
@@ -272,6 +274,102 @@ class PD_INFER_DECL PredictorPool {
   std::shared_ptr<Predictor> main_pred_;
   std::vector<std::unique_ptr<Predictor>> preds_;
 };
+
+///
+/// \brief The options of BatchingPredictorPool.
+///
+struct PD_INFER_DECL BatchingOptions {
+  /// The number of worker threads, each of which owns one predictor.
+  size_t num_workers{1};
+  /// The max number of requests waiting in the queue. Submit blocks when the
+  /// queue is full.
+  size_t max_queue_size{1024};
+  /// The max number of rows (the sum of the first dims of the requests) that
+  /// are run in one batch.
+  int max_batch_size{8};
+  /// The max time in microseconds the oldest request of a batch waits for
+  /// other requests before the batch is run.
+  int64_t max_queue_delay_us{1000};
+  /// The candidate lengths of the second dim of the inputs. If it is not
+  /// empty, the second dim of every input is zero padded to the smallest
+  /// candidate which is not less than it, so that requests of close lengths
+  /// are batched together. The outputs keep the padded lengths.
+  std::vector<int> seq_len_buckets;
+};
+
+///
+/// \brief A host tensor of a request served by BatchingPredictorPool. The
+/// first dim of the shape is the batch dim.
+///
+struct PD_INFER_DECL ServingTensor {
+  std::string name;
+  std::vector<int> shape;
+  DataType dtype{DataType::FLOAT32};
+  std::vector<char> data;
+};
+
+///
+/// \brief The statistics of BatchingPredictorPool. The i-th bucket of a
+/// latency histogram counts the requests whose latency in microseconds is in
+/// [2^i, 2^(i+1)).
+///
+struct PD_INFER_DECL ServingStats {
+  uint64_t num_requests{0};
+  uint64_t num_batches{0};
+  uint64_t num_rows{0};
+  /// The time from Submit to the start of the batch.
+  std::vector<uint64_t> queue_latency_us;
+  /// The time from Submit to the outputs being ready.
+  std::vector<uint64_t> total_latency_us;
+
+  /// \brief The upper bound of the \param percent (0~100) percentile of the
+  /// total latency in microseconds.
+  int64_t TotalLatencyPercentile(double percent) const;
+};
+
+///
+/// \class BatchingPredictorPool
+///
+/// \brief BatchingPredictorPool serves requests from many threads with a
+/// pool of cloned predictors. Requests are put into a bounded queue, and the
+/// requests whose inputs have the same names, dtypes and non-batch dims are
+/// concatenated along the batch dim and run together. A batch is run once it
+/// has max_batch_size rows or its oldest request has waited for
+/// max_queue_delay_us. The outputs are split along the batch dim back to the
+/// requests, so every output must have the batch dim first.
+///
+/// Usage:
+///
+/// \code{.cpp}
+/// BatchingOptions options;
+/// options.num_workers = 4;
+/// BatchingPredictorPool pool(config, options);
+/// auto outputs = pool.Submit(std::move(inputs)).get();
+/// \endcode
+///
+class PD_INFER_DECL BatchingPredictorPool {
+ public:
+  BatchingPredictorPool(const Config& config, const BatchingOptions& options);
+  BatchingPredictorPool(const BatchingPredictorPool&) = delete;
+  BatchingPredictorPool& operator=(const BatchingPredictorPool&) = delete;
+
+  /// \brief Wait for the queued requests to finish and stop the workers.
+  ~BatchingPredictorPool();
+
+  /// \brief Queue a request. The future holds the outputs of the request, or
+  /// the error raised when running its batch.
+  std::future<std::vector<ServingTensor>> Submit(
+      std::vector<ServingTensor> inputs);
+
+  /// \brief Queue a request and wait for its outputs.
+  std::vector<ServingTensor> Run(std::vector<ServingTensor> inputs);
+
+  ServingStats GetStats() const;
+
+ private:
+  class Impl;
+  std::unique_ptr<Impl> impl_;
+};
 }  // namespace services
 
 }  // namespace paddle_infer
@@ -677,9 +677,13 @@ const std::vector<std::string> kPirMkldnnBf16Passes{
     "cpu_bf16_quantize_squash_pass",
 };
 
-const std::vector<std::string> kPirCpuPasses{
-    "add_shadow_output_after_dead_parameter_pass",
-    "delete_quant_dequant_linear_op_pass",
-    "delete_weight_dequant_linear_op_pass"};
+const std::vector<std::string> kPirCpuPasses {
+  "add_shadow_output_after_dead_parameter_pass",
+      "delete_quant_dequant_linear_op_pass",   //
+      "delete_weight_dequant_linear_op_pass",  //
+#if defined(PADDLE_WITH_AVX512F) && defined(PADDLE_WITH_MKLML)
+      "add_norm_cpu_fuse_pass",  //
+#endif
+      "embedding_seqpool_cvm_fuse_pass"};
 
 }  // namespace paddle
@@ -192,6 +192,7 @@ NO_NEED_GEN_STATIC_ONLY_APIS = [
     'fused_elementwise_mul',
     'fused_elementwise_sub',
     'fused_embedding_fc_lstm',
+    'fused_embedding_seqpool_cvm',
     'fused_gate_attention',
     'fused_multi_transformer_int8',
     'fused_seqpool_cvm',
@@ -17,9 +17,11 @@
 #include <memory>
 #include <unordered_map>
 #include <unordered_set>
+#include <utility>
 #include <vector>
 
 #include "paddle/fluid/pir/drr/include/drr_pattern_context.h"
+#include "paddle/pir/include/core/op_info.h"
 #include "paddle/pir/include/pattern_rewrite/pattern_match.h"
 
 namespace pir {
@@ -49,9 +51,28 @@ class DrrRewritePattern : public pir::RewritePattern {
       pir::Operation* op,
       pir::PatternRewriter& rewriter) const override;  // // NOLINT
 
+  int64_t MatchRadius() const override { return match_radius_; }
+
  private:
-  bool PatternGraphMatch(pir::Operation* op,
-                         MatchContextImpl* source_pattern_match_ctx) const;
+  // The containers of a match attempt, reused by the attempts of a thread.
+  struct MatchScratch;
+
+  // What the anchor op and its operands must look like for the source
+  // pattern to match, checked before any other work.
+  struct AnchorOperand {
+    bool is_none;
+    // Whether the operand is produced by an op of the pattern, then it has
+    // `use_count` uses and, unless null, is produced by a `producer` op.
+    bool has_producer;
+    pir::OpInfo producer;
+    size_t use_count;
+  };
+
+  void InitAnchorSignature(pir::IrContext* context);
+
+  bool MatchAnchor(pir::Operation* op) const;
+
+  bool PatternGraphMatch(pir::Operation* op, MatchScratch* scratch) const;
 
   std::unordered_map<const OpCall*, std::unordered_set<pir::Operation*>>
   FindCandidateIrOutputOp(pir::Operation* op,
@@ -66,10 +87,11 @@ class DrrRewritePattern : public pir::RewritePattern {
       std::unordered_map<const OpCall*, std::unordered_set<pir::Operation*>>*
           output_op_bind_map) const;
 
+  // Matches into scratch->match_ctx.
   bool MatchFromOutputToInput(
-      std::unordered_map<const OpCall*, pir::Operation*> output_op_map,
+      const std::vector<std::pair<const OpCall*, pir::Operation*>>& output_ops,
       const SourcePatternGraph& source_pattern_graph,
-      const std::shared_ptr<MatchContextImpl>& source_pattern_match_ctx) const;
+      MatchScratch* scratch) const;
 
   void PatternGraphRewrite(const MatchContextImpl& source_pattern_match_ctx,
                            pir::PatternRewriter& rewriter) const;  // NOLINT
@@ -101,6 +123,12 @@ class DrrRewritePattern : public pir::RewritePattern {
   const std::vector<PostProcess> post_processes_;
   const std::shared_ptr<ResultPatternGraph> result_pattern_graph_;
 
+  const std::unordered_set<const OpCall*> output_op_set_;
+  const OpCall* anchor_;
+  std::vector<AnchorOperand> anchor_operands_;
+  size_t anchor_num_results_;
+  int64_t match_radius_;
+
   // Not used, just for hold it's life cycle.
   const std::shared_ptr<const DrrPatternBase> drr_pattern_owner_;
 };
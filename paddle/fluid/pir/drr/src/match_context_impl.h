@@ -97,6 +97,13 @@ class MatchContextImpl final {
     return tensor_map_;
   }
 
+  // Unbinds everything, the maps keep their buckets for the next match.
+  void Clear() {
+    tensor_map_.clear();
+    operation_map_.clear();
+    attr_map_.clear();
+  }
+
   void BindIrValue(const std::string& value_name, const pir::Value& value) {
     tensor_map_.emplace(value_name, value);
   }
@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include <glog/logging.h>
+#include <algorithm>
 #include <queue>
 #include <utility>
 
@@ -43,12 +44,17 @@ DrrRewritePattern::DrrRewritePattern(
       constraints_(drr_context.constraints()),
       post_processes_(drr_context.post_processes()),
       result_pattern_graph_(drr_context.result_pattern_graph()),
+      output_op_set_(source_pattern_graph_->OutputNodes()),
+      anchor_(*output_op_set_.begin()),
+      anchor_num_results_(0),
+      match_radius_(-1),
       drr_pattern_owner_(std::move(drr_pattern_owner)) {
   PADDLE_ENFORCE_NE(source_pattern_graph_->owned_op_call().empty(),
                     true,
                     common::errors::InvalidArgument(
                         "Source pattern graph is empty. Suggested fix: please "
                         "check the drr source pattern definition code."));
+  InitAnchorSignature(context);
   if (VLOG_IS_ON(4)) {
     std::cout << "\nThe source pattern graph in [" << pattern_name << "]:\n"
               << *source_pattern_graph_ << std::endl;
@@ -57,13 +63,111 @@ DrrRewritePattern::DrrRewritePattern(
   }
 }
 
+struct DrrRewritePattern::MatchScratch {
+  MatchContextImpl match_ctx;
+  std::vector<std::pair<const OpCall*, pir::Operation*>> output_ops;
+  std::unordered_set<const OpCall*> drr_visited;
+  std::unordered_set<pir::Operation*> ir_visited;
+  // Used as queues, popped by moving `queue_head`.
+  std::vector<const OpCall*> drr_queue;
+  std::vector<pir::Operation*> ir_queue;
+  size_t queue_head = 0;
+};
+
+void DrrRewritePattern::InitAnchorSignature(pir::IrContext* context) {
+  anchor_num_results_ = anchor_->outputs().size();
+  for (const Tensor* input : anchor_->inputs()) {
+    AnchorOperand operand{input->is_none(), false, nullptr, 0};
+    if (!operand.is_none && input->producer() != nullptr) {
+      operand.has_producer = true;
+      operand.use_count = input->consumers().size();
+      // With several output ops, the producer may be matched from another
+      // output op, then it is not necessarily the defining op of the
+      // operand.
+      if (output_op_set_.size() == 1) {
+        operand.producer =
+            context->GetRegisteredOpInfo(input->producer()->name());
+      }
+    }
+    anchor_operands_.push_back(operand);
+  }
+
+  // The radius is the eccentricity of the anchor in the source pattern, in
+  // which two op calls are adjacent if one consumes an output of the other
+  // or if both consume the same tensor: a match rooted at an op only
+  // involves ops within the radius of it.
+  std::unordered_map<const OpCall*, int64_t> distance{{anchor_, 0}};
+  std::queue<const OpCall*> queue;
+  queue.push(anchor_);
+  int64_t radius = 0;
+  while (!queue.empty()) {
+    const OpCall* op_call = queue.front();
+    queue.pop();
+    int64_t next_distance = distance.at(op_call) + 1;
+    auto visit = [&](const OpCall* next) {
+      if (next != nullptr && distance.emplace(next, next_distance).second) {
+        radius = std::max(radius, next_distance);
+        queue.push(next);
+      }
+    };
+    for (const Tensor* input : op_call->inputs()) {
+      if (input->is_none()) {
+        continue;
+      }
+      visit(input->producer());
+      for (const OpCall* consumer : input->consumers()) {
+        visit(consumer);
+      }
+    }
+    for (const Tensor* output : op_call->outputs()) {
+      for (const OpCall* consumer : output->consumers()) {
+        visit(consumer);
+      }
+    }
+  }
+  if (distance.size() == source_pattern_graph_->CountOfOpCalls()) {
+    match_radius_ = radius;
+  }
+}
+
+bool DrrRewritePattern::MatchAnchor(pir::Operation* op) const {
+  if (op->num_operands() != anchor_operands_.size() ||
+      op->num_results() != anchor_num_results_) {
+    return false;
+  }
+  for (uint32_t i = 0; i < op->num_operands(); ++i) {
+    const AnchorOperand& expected = anchor_operands_[i];
+    pir::Value value = op->operand_source(i);
+    if (expected.is_none) {
+      if (value) {
+        return false;
+      }
+      continue;
+    }
+    if (!expected.has_producer) {
+      continue;
+    }
+    if (!value || value.use_count() != expected.use_count) {
+      return false;
+    }
+    pir::Operation* producer = value.defining_op();
+    if (producer == nullptr ||
+        (expected.producer && producer->info() != expected.producer)) {
+      return false;
+    }
+  }
+  return true;
+}
+
 bool DrrRewritePattern::MatchAndRewrite(
     pir::Operation* op,
     pir::PatternRewriter& rewriter) const {  // NOLINT
-  std::shared_ptr<MatchContextImpl> src_match_ctx =
-      std::make_shared<MatchContextImpl>();
-  if (PatternGraphMatch(op, src_match_ctx.get())) {
+  // Most attempts fail, reusing the containers keeps them from allocating.
+  thread_local MatchScratch scratch;
+  if (PatternGraphMatch(op, &scratch)) {
     VLOG(4) << "DRR pattern (" << pattern_name_ << ") is matched in program.";
+    auto src_match_ctx =
+        std::make_shared<MatchContextImpl>(std::move(scratch.match_ctx));
     MatchContext match_context{src_match_ctx};
     for (const auto& post_process : post_processes_) {
       post_process(match_context);
@@ -75,19 +179,26 @@ bool DrrRewritePattern::MatchAndRewrite(
   return false;
 }
 
-bool DrrRewritePattern::PatternGraphMatch(
-    pir::Operation* op, MatchContextImpl* source_pattern_match_ctx) const {
+bool DrrRewritePattern::PatternGraphMatch(pir::Operation* op,
+                                          MatchScratch* scratch) const {
   VLOG(6) << "PatternGraphMatch Start: op(" << op->name() << ")";
-  const OpCall* anchor = *source_pattern_graph_->OutputNodes().begin();
+  if (!MatchAnchor(op)) {
+    return false;
+  }
+  if (output_op_set_.size() == 1) {
+    scratch->output_ops.clear();
+    scratch->output_ops.emplace_back(anchor_, op);
+    return MatchFromOutputToInput(
+        scratch->output_ops, *source_pattern_graph_, scratch);
+  }
   std::unordered_map<const OpCall*, std::unordered_set<pir::Operation*>>
-      bind_map = FindCandidateIrOutputOp(op, anchor, *source_pattern_graph_);
+      bind_map = FindCandidateIrOutputOp(op, anchor_, *source_pattern_graph_);
   if (bind_map.empty()) {
     return false;
   }
   std::vector<const OpCall*> drr_output_sequence;
   drr_output_sequence.reserve(bind_map.size());
   std::vector<pir::Operation*> ir_output_sequence;
-  std::unordered_map<const OpCall*, pir::Operation*> output_op_map;
   for (const auto& pair : bind_map) {
     drr_output_sequence.push_back(pair.first);
   }
@@ -102,22 +213,13 @@ bool DrrRewritePattern::PatternGraphMatch(
           return false;
         }
       }
-      // new match_ctx
-      std::shared_ptr<MatchContextImpl> match_ctx =
-          std::make_shared<MatchContextImpl>();
-      std::transform(drr_output_sequence.begin(),
-                     drr_output_sequence.end(),
-                     ir_output_sequence.begin(),
-                     std::inserter(output_op_map, output_op_map.end()),
-                     [](const OpCall* drr_op, pir::Operation* ir_op) {
-                       return std::make_pair(drr_op, ir_op);
-                     });
-      if (MatchFromOutputToInput(
-              output_op_map, *source_pattern_graph_, match_ctx)) {
-        *source_pattern_match_ctx = *match_ctx;
-        return true;
+      scratch->output_ops.clear();
+      for (size_t i = 0; i < drr_output_sequence.size(); ++i) {
+        scratch->output_ops.emplace_back(drr_output_sequence[i],
+                                         ir_output_sequence[i]);
       }
-      return false;
+      return MatchFromOutputToInput(
+          scratch->output_ops, *source_pattern_graph_, scratch);
     }
     for (auto* ir_op : bind_map[drr_output_sequence[index]]) {
       ir_output_sequence.push_back(ir_op);
@@ -137,9 +239,7 @@ DrrRewritePattern::FindCandidateIrOutputOp(
     pir::Operation* op,
     const OpCall* anchor,
     const SourcePatternGraph& source_pattern_graph) const {
-  // get source pattern output op
-  std::unordered_set<const OpCall*> drr_output_op_set =
-      source_pattern_graph.OutputNodes();
+  const auto& drr_output_op_set = output_op_set_;
   std::unordered_map<const OpCall*, std::unordered_set<pir::Operation*>>
       output_op_bind_map{{anchor, {op}}};
   if (drr_output_op_set.size() == 1) {
@@ -262,22 +362,30 @@ void DrrRewritePattern::DfsVisitor(
 }
 
 bool DrrRewritePattern::MatchFromOutputToInput(
-    std::unordered_map<const OpCall*, pir::Operation*> output_op_map,
+    const std::vector<std::pair<const OpCall*, pir::Operation*>>& output_ops,
     const SourcePatternGraph& source_pattern_graph,
-    const std::shared_ptr<MatchContextImpl>& source_pattern_match_ctx) const {
+    MatchScratch* scratch) const {
   VLOG(6) << "MatchFromOutputToInput Start";
-  std::unordered_set<const OpCall*> drr_visited;
-  std::unordered_set<pir::Operation*> ir_visited;
-  std::queue<const OpCall*> drr_q;
-  std::queue<pir::Operation*> ir_q;
+  MatchContextImpl* source_pattern_match_ctx = &scratch->match_ctx;
+  source_pattern_match_ctx->Clear();
+  auto& drr_visited = scratch->drr_visited;
+  auto& ir_visited = scratch->ir_visited;
+  auto& drr_q = scratch->drr_queue;
+  auto& ir_q = scratch->ir_queue;
+  auto& q_head = scratch->queue_head;
+  drr_visited.clear();
+  ir_visited.clear();
+  drr_q.clear();
+  ir_q.clear();
+  q_head = 0;
   // Initialize DRR matched queue.
   const auto& InitDrrQueue = [&]() -> void {
-    for (const auto& [first, second] : output_op_map) {
+    for (const auto& [first, second] : output_ops) {
       VLOG(6) << "match (" << first->name() << " @" << first << " : @" << second
               << ") in source_pattern_graph ";
-      drr_q.push(first);
+      drr_q.push_back(first);
       drr_visited.insert(first);
-      ir_q.push(second);
+      ir_q.push_back(second);
       ir_visited.insert(second);
     }
   };
@@ -328,8 +436,8 @@ bool DrrRewritePattern::MatchFromOutputToInput(
     // insert map if both not visited.
     if (!drr_visited.count(drr_producer_op) &&
         !ir_visited.count(ir_producer_op)) {
-      drr_q.push(drr_producer_op);
-      ir_q.push(ir_producer_op);
+      drr_q.push_back(drr_producer_op);
+      ir_q.push_back(ir_producer_op);
       drr_visited.insert(drr_producer_op);
       ir_visited.insert(ir_producer_op);
       return true;
@@ -346,12 +454,11 @@ bool DrrRewritePattern::MatchFromOutputToInput(
   size_t step = 0;
   InitDrrQueue();
 
-  while (!drr_q.empty()) {
+  while (q_head < drr_q.size()) {
     if (!matched) break;
-    auto* drr_node = drr_q.front();
-    auto* ir_node = ir_q.front();
-    drr_q.pop();
-    ir_q.pop();
+    auto* drr_node = drr_q[q_head];
+    auto* ir_node = ir_q[q_head];
+    ++q_head;
     if (!IsSameOperandsAndResults(drr_node, ir_node)) {
       matched = false;
       break;
@@ -436,7 +543,9 @@ bool DrrRewritePattern::MatchFromOutputToInput(
     return matched;
   }
 
-  MatchContext match_context{source_pattern_match_ctx};
+  // Does not own the scratch context, which outlives the constraints.
+  MatchContext match_context{std::shared_ptr<const MatchContextImpl>(
+      std::shared_ptr<void>(), source_pattern_match_ctx)};
   for (const auto& constraint : constraints_) {
     matched = constraint(match_context);
     if (!matched) {
@@ -0,0 +1,170 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/pir/transforms/general/embedding_seqpool_cvm_fuse_pass.h"
+
+#include "paddle/fluid/pir/dialect/operator/ir/op_type.h"
+#include "paddle/fluid/pir/dialect/operator/ir/pd_op.h"
+#include "paddle/fluid/pir/utils/general_functions.h"
+
+#include "paddle/pir/include/core/builtin_op.h"
+#include "paddle/pir/include/pass/pass.h"
+#include "paddle/pir/include/pass/pass_registry.h"
+
+namespace {
+
+// The fused kernel reads float, float16 and int8 tables, but embedding only
+// feeds the pooling ops a float output when its table is float.
+bool IsFusableEmbedding(paddle::dialect::EmbeddingOp embedding) {
+  if (!embedding || !embedding.out().HasOneUse()) return false;
+  if (!embedding.weight().type().isa<paddle::dialect::DenseTensorType>()) {
+    return false;
+  }
+  return pir::GetDataTypeFromValue(embedding.weight())
+      .isa<pir::Float32Type>();
+}
+
+int64_t PaddingIdx(paddle::dialect::EmbeddingOp embedding) {
+  return embedding->attribute<pir::Int64Attribute>("padding_idx").data();
+}
+
+// combine(embedding(ids_0, w), ..., embedding(ids_n, w)) -> fused_seqpool_cvm
+// =>
+// fused_embedding_seqpool_cvm(combine(ids_0, ..., ids_n), w)
+//
+// i.e. the slots of a CTR model looking up the same table.
+class EmbeddingFusedSeqpoolCvmPattern
+    : public pir::OpRewritePattern<paddle::dialect::FusedSeqpoolCvmOp> {
+ public:
+  using pir::OpRewritePattern<
+      paddle::dialect::FusedSeqpoolCvmOp>::OpRewritePattern;
+
+  bool MatchAndRewrite(
+      paddle::dialect::FusedSeqpoolCvmOp op,
+      pir::PatternRewriter &rewriter) const override {  // NOLINT
+    auto combine_op = op.x().defining_op<pir::CombineOp>();
+    if (!combine_op || !op.x().HasOneUse()) return false;
+
+    std::vector<paddle::dialect::EmbeddingOp> embedding_ops;
+    std::vector<pir::Value> ids;
+    for (auto input : combine_op.inputs()) {
+      auto embedding_op = input.defining_op<paddle::dialect::EmbeddingOp>();
+      if (!IsFusableEmbedding(embedding_op)) return false;
+      if (!embedding_ops.empty() &&
+          (embedding_op.weight() != embedding_ops[0].weight() ||
+           PaddingIdx(embedding_op) != PaddingIdx(embedding_ops[0]))) {
+        return false;
+      }
+      embedding_ops.push_back(embedding_op);
+      ids.push_back(embedding_op.x());
+    }
+    if (embedding_ops.empty()) return false;
+
+    auto ids_combine_op = rewriter.Build<pir::CombineOp>(ids);
+    // Like the kernels of fused_seqpool_cvm, the rows are summed whatever the
+    // pooltype.
+    auto fused_op =
+        rewriter.Build<paddle::dialect::FusedEmbeddingSeqpoolCvmOp>(
+            ids_combine_op.out(),
+            embedding_ops[0].weight(),
+            pir::Value(),
+            "SUM",
+            op->attribute<pir::FloatAttribute>("pad_value").data(),
+            op->attribute<pir::BoolAttribute>("use_cvm").data(),
+            op->attribute<pir::Int32Attribute>("cvm_offset").data(),
+            PaddingIdx(embedding_ops[0]));
+    rewriter.ReplaceAllUsesWith(op.out(), fused_op.out());
+    rewriter.EraseOp(op);
+    rewriter.EraseOp(combine_op);
+    for (auto embedding_op : embedding_ops) {
+      rewriter.EraseOp(embedding_op);
+    }
+    return true;
+  }
+};
+
+// embedding(ids, w) -> sequence_pool
+// =>
+// fused_embedding_seqpool_cvm(combine(ids), w) -> split
+//
+// The fused op starts each pooled row at pad_value, sequence_pool only uses
+// it for empty sequences, so both agree when it is 0.
+class EmbeddingSequencePoolPattern
+    : public pir::OpRewritePattern<paddle::dialect::SequencePoolOp> {
+ public:
+  using pir::OpRewritePattern<
+      paddle::dialect::SequencePoolOp>::OpRewritePattern;
+
+  bool MatchAndRewrite(
+      paddle::dialect::SequencePoolOp op,
+      pir::PatternRewriter &rewriter) const override {  // NOLINT
+    auto embedding_op = op.x().defining_op<paddle::dialect::EmbeddingOp>();
+    if (!IsFusableEmbedding(embedding_op)) return false;
+    if (!op.max_index().use_empty()) return false;
+
+    auto pooltype = op->attribute<pir::StrAttribute>("pooltype").AsString();
+    if (pooltype != "SUM" && pooltype != "AVERAGE" && pooltype != "SQRT") {
+      return false;
+    }
+    if (op->attribute<pir::FloatAttribute>("pad_value").data() != 0.0f) {
+      return false;
+    }
+    // The fused op outputs [batch_size, width], like sequence_pool only when
+    // the ids are a vector.
+    if (pir::GetShapeFromValue(embedding_op.out()).size() != 2) return false;
+
+    auto ids_combine_op = rewriter.Build<pir::CombineOp>(
+        std::vector<pir::Value>{embedding_op.x()});
+    auto fused_op =
+        rewriter.Build<paddle::dialect::FusedEmbeddingSeqpoolCvmOp>(
+            ids_combine_op.out(),
+            embedding_op.weight(),
+            pir::Value(),
+            pooltype,
+            0.0f,
+            false,
+            0,
+            PaddingIdx(embedding_op));
+    auto split_op = rewriter.Build<pir::SplitOp>(fused_op.out());
+    rewriter.ReplaceAllUsesWith(op.out(), split_op.outputs()[0]);
+    rewriter.EraseOp(op);
+    rewriter.EraseOp(embedding_op);
+    return true;
+  }
+};
+
+class EmbeddingSeqpoolCvmFusePass : public pir::PatternRewritePass {
+ public:
+  EmbeddingSeqpoolCvmFusePass()
+      : pir::PatternRewritePass("embedding_seqpool_cvm_fuse_pass", 2) {}
+
+  pir::RewritePatternSet InitializePatterns(pir::IrContext *context) override {
+    pir::RewritePatternSet ps(context);
+    ps.Add<EmbeddingFusedSeqpoolCvmPattern>(context);
+    ps.Add<EmbeddingSequencePoolPattern>(context);
+    return ps;
+  }
+};
+
+}  // namespace
+
+namespace pir {
+
+std::unique_ptr<Pass> CreateEmbeddingSeqpoolCvmFusePass() {
+  return std::make_unique<EmbeddingSeqpoolCvmFusePass>();
+}
+
+}  // namespace pir
+
+REGISTER_IR_PASS(embedding_seqpool_cvm_fuse_pass, EmbeddingSeqpoolCvmFusePass);
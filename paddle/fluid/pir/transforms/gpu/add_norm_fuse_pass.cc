@@ -20,6 +20,7 @@
 #include "paddle/fluid/pir/drr/include/drr_pattern_base.h"
 
 #include "paddle/fluid/pir/utils/general_functions.h"
+#include "paddle/phi/backends/cpu/cpu_info.h"
 #include "paddle/pir/include/core/builtin_op.h"
 #include "paddle/pir/include/core/value.h"
 #include "paddle/pir/include/pass/pass.h"
@@ -27,13 +28,27 @@
 
 namespace {
 
+// The rms_norm and fused_bias_residual_layernorm CPU kernels are AVX512
+// kernels that support float32, float16 and bfloat16 inputs, and add the
+// residual elementwise, without broadcast.
+bool IsCpuSupportedNormType(pir::Value value) {
+  auto dtype = pir::GetDataTypeFromValue(value);
+  return dtype.isa<pir::Float32Type>() || dtype.isa<pir::Float16Type>() ||
+         dtype.isa<pir::BFloat16Type>();
+}
+
+bool HasSameShape(pir::Value x, pir::Value residual) {
+  return pir::GetShapeFromValue(x) == pir::GetShapeFromValue(residual);
+}
+
 class RmsNormFusePattern : public paddle::drr::DrrPatternBase {
  private:
   const bool is_half_weight_;
+  const bool on_cpu_;
 
  public:
-  explicit RmsNormFusePattern(bool is_half_weight)
-      : is_half_weight_(is_half_weight) {}
+  RmsNormFusePattern(bool is_half_weight, bool on_cpu)
+      : is_half_weight_(is_half_weight), on_cpu_(on_cpu) {}
 
   std::string name() const override { return "RmsNormFusePattern"; }
 
@@ -80,6 +95,9 @@ class RmsNormFusePattern : public paddle::drr::DrrPatternBase {
       if (axis.size() > 1) {
         return false;
       }
+      if (this->on_cpu_ && !IsCpuSupportedNormType(match_ctx.Tensor("x"))) {
+        return false;
+      }
       if (this->is_half_weight_) {
         auto w_type = pir::GetDataTypeFromValue(match_ctx.Tensor("w"));
         if (!(w_type.isa<pir::Float16Type>() ||
@@ -142,10 +160,13 @@ class AddRmsNormFusePattern : public paddle::drr::DrrPatternBase {
  private:
   const bool extra_add_;
   const bool trans_extra_add_;
+  const bool on_cpu_;
 
  public:
-  AddRmsNormFusePattern(bool extra_add, bool trans_extra_add)
-      : extra_add_(extra_add), trans_extra_add_{trans_extra_add} {}
+  AddRmsNormFusePattern(bool extra_add, bool trans_extra_add, bool on_cpu)
+      : extra_add_(extra_add),
+        trans_extra_add_{trans_extra_add},
+        on_cpu_(on_cpu) {}
 
   uint32_t benefit() const override { return extra_add_ ? 4 : 3; }
 
@@ -182,6 +203,14 @@ class AddRmsNormFusePattern : public paddle::drr::DrrPatternBase {
               ? add1(pat.Tensor("any_tensor"), pat.Tensor("add_out"))
               : add1(pat.Tensor("add_out"), pat.Tensor("any_tensor"));
     }
+    pat.AddConstraint([this](const paddle::drr::MatchContext &match_ctx) {
+      if (this->on_cpu_) {
+        return IsCpuSupportedNormType(match_ctx.Tensor("x")) &&
+               HasSameShape(match_ctx.Tensor("x"),
+                            match_ctx.Tensor("residual"));
+      }
+      return true;
+    });
     paddle::drr::ResultPattern res = pat.ResultPattern();
     const auto &res_rms_norm =
         res.Op(paddle::dialect::RmsNormOp::name(),
@@ -212,10 +241,13 @@ class AddLayerNormFusePattern : public paddle::drr::DrrPatternBase {
  private:
   const bool extra_add_;
   const bool trans_extra_add_;
+  const bool on_cpu_;
 
  public:
-  AddLayerNormFusePattern(bool extra_add, bool trans_extra_add)
-      : extra_add_(extra_add), trans_extra_add_{trans_extra_add} {}
+  AddLayerNormFusePattern(bool extra_add, bool trans_extra_add, bool on_cpu)
+      : extra_add_(extra_add),
+        trans_extra_add_{trans_extra_add},
+        on_cpu_(on_cpu) {}
 
   uint32_t benefit() const override { return extra_add_ ? 4 : 3; }
   std::string name() const override { return "AddLayerNormFusePattern"; }
@@ -241,7 +273,12 @@ class AddLayerNormFusePattern : public paddle::drr::DrrPatternBase {
               ? add1(pat.Tensor("any_tensor"), pat.Tensor("add_out"))
               : add1(pat.Tensor("add_out"), pat.Tensor("any_tensor"));
     }
-    pat.AddConstraint([](const paddle::drr::MatchContext &match_ctx) {
+    pat.AddConstraint([this](const paddle::drr::MatchContext &match_ctx) {
+      if (this->on_cpu_) {
+        return IsCpuSupportedNormType(match_ctx.Tensor("x")) &&
+               HasSameShape(match_ctx.Tensor("x"),
+                            match_ctx.Tensor("residual"));
+      }
       auto x_shape = pir::GetShapeFromValue(match_ctx.Tensor("x"));
       auto r_shape = pir::GetShapeFromValue(match_ctx.Tensor("residual"));
       if (x_shape[0] != r_shape[0]) {
@@ -407,6 +444,42 @@ class AddGroupNormWithActPattern : public paddle::drr::DrrPatternBase {
   }
 };
 
+// x-pow-mean-scale->rsqrt-
+//                          mul--
+// x-----------------------
+//                                mul --->rms_norm
+// w-----------------------------
+//
+// x--------
+//           add-rms_norm ---> rms_norm
+// residual-
+//
+// x--------
+//           add-layer_norm ----> fused_bias_residual_layernorm
+// residual-
+void AddRmsAndLayerNormPatterns(pir::IrContext *context,
+                                bool on_cpu,
+                                pir::RewritePatternSet *ps) {
+  bool is_half_weight = true;
+  bool extra_add = true;
+  ps->Add(paddle::drr::Create<RmsNormFusePattern>(
+      context, !is_half_weight, on_cpu));
+  ps->Add(
+      paddle::drr::Create<RmsNormFusePattern>(context, is_half_weight, on_cpu));
+  ps->Add(paddle::drr::Create<AddRmsNormFusePattern>(
+      context, !extra_add, false, on_cpu));
+  ps->Add(paddle::drr::Create<AddRmsNormFusePattern>(
+      context, extra_add, true, on_cpu));
+  ps->Add(paddle::drr::Create<AddRmsNormFusePattern>(
+      context, extra_add, false, on_cpu));
+  ps->Add(paddle::drr::Create<AddLayerNormFusePattern>(
+      context, !extra_add, false, on_cpu));
+  ps->Add(paddle::drr::Create<AddLayerNormFusePattern>(
+      context, extra_add, true, on_cpu));
+  ps->Add(paddle::drr::Create<AddLayerNormFusePattern>(
+      context, extra_add, false, on_cpu));
+}
+
 class AddNormFusePass : public pir::PatternRewritePass {
  public:
   AddNormFusePass() : pir::PatternRewritePass("add_norm_fuse_pass", 2) {}
@@ -419,34 +492,9 @@ class AddNormFusePass : public pir::PatternRewritePass {
       enable_gpu_mixed = Get<bool>("enable_gpu_mixed");
     }
 
-    // x-pow-mean-scale->rsqrt-
-    //                          mul--
-    // x-----------------------
-    //                                mul --->rms_norm
-    // w-----------------------------
-    bool is_half_weight = true;
-    bool extra_add = true;
-    ps.Add(paddle::drr::Create<RmsNormFusePattern>(context, !is_half_weight));
-    ps.Add(paddle::drr::Create<RmsNormFusePattern>(context, is_half_weight));
-    // x--------
-    //           add-rms_norm ---> rms_norm
-    // residual-
-    ps.Add(
-        paddle::drr::Create<AddRmsNormFusePattern>(context, !extra_add, false));
-    ps.Add(
-        paddle::drr::Create<AddRmsNormFusePattern>(context, extra_add, true));
-    ps.Add(
-        paddle::drr::Create<AddRmsNormFusePattern>(context, extra_add, false));
+    AddRmsAndLayerNormPatterns(context, /*on_cpu=*/false, &ps);
 
-    // x--------
-    //           add-layer_norm ----> fused_bias_residual_layernorm
-    // residual-
-    ps.Add(paddle::drr::Create<AddLayerNormFusePattern>(
-        context, !extra_add, false));
-    ps.Add(
-        paddle::drr::Create<AddLayerNormFusePattern>(context, extra_add, true));
-    ps.Add(paddle::drr::Create<AddLayerNormFusePattern>(
-        context, extra_add, false));
+    bool extra_add = true;
 
     // x--------
     //           add-group_norm ----> add_group_norm_silu
@@ -465,12 +513,42 @@ class AddNormFusePass : public pir::PatternRewritePass {
     return ps;
   }
 };
+
+// The rms_norm and add + norm patterns above, applied on CPU where the
+// AVX512 rms_norm and fused_bias_residual_layernorm kernels are built and
+// can run.
+class AddNormCpuFusePass : public pir::PatternRewritePass {
+ public:
+  AddNormCpuFusePass() : pir::PatternRewritePass("add_norm_cpu_fuse_pass", 2) {}
+
+  pir::RewritePatternSet InitializePatterns(pir::IrContext *context) override {
+    pir::RewritePatternSet ps(context);
+    AddRmsAndLayerNormPatterns(context, /*on_cpu=*/true, &ps);
+    return ps;
+  }
+
+  bool CanApplyOn(pir::Operation *op) const override {
+#if !defined(PADDLE_WITH_AVX512F) || !defined(PADDLE_WITH_MKLML)
+    LOG(WARNING) << "No-avx512 or MKL supported!";
+    return false;
+#endif
+    if (!phi::backends::cpu::MayIUse(phi::backends::cpu::cpu_isa_t::avx512f)) {
+      return false;
+    }
+    return op->num_regions() > 0;
+  }
+};
 }  // namespace
 
 namespace pir {
 std::unique_ptr<Pass> CreateAddNormFusePass() {
   return std::make_unique<AddNormFusePass>();
 }
+
+std::unique_ptr<Pass> CreateAddNormCpuFusePass() {
+  return std::make_unique<AddNormCpuFusePass>();
+}
 }  // namespace pir
 
 REGISTER_IR_PASS(add_norm_fuse_pass, AddNormFusePass);
+REGISTER_IR_PASS(add_norm_cpu_fuse_pass, AddNormCpuFusePass);
@@ -22,5 +22,6 @@ namespace pir {
 class Pass;
 
 IR_API std::unique_ptr<Pass> CreateAddNormFusePass();
+IR_API std::unique_ptr<Pass> CreateAddNormCpuFusePass();
 
 }  // namespace pir
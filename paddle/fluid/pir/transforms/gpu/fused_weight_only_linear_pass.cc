@@ -36,6 +36,15 @@ int getSMVersion() {
   return sm_version;
 }
 
+// sm_version 0 means the weight is quantized for the CPU weight_only_linear
+// kernel, which computes in float32 and also takes float32 weights.
+bool IsSupportedWeightType(pir::Type w_dtype, int sm_version) {
+  if (sm_version == 0 && w_dtype.isa<pir::Float32Type>()) {
+    return true;
+  }
+  return w_dtype.isa<pir::Float16Type>() || w_dtype.isa<pir::BFloat16Type>();
+}
+
 class FusedWeightOnlyLinearWithBiasPattern
     : public paddle::drr::DrrPatternBase {
  private:
@@ -76,7 +85,8 @@ class FusedWeightOnlyLinearWithBiasPattern
     //
     // Constraints.
     //
-    src.AddConstraint([](const paddle::drr::MatchContext &match_ctx) -> bool {
+    int sm_version = sm_version_;
+    src.AddConstraint([sm_version](const paddle::drr::MatchContext &match_ctx) {
       if (!pir::ValueIsPersistable(match_ctx.Tensor("w"))) {
         return false;
       }
@@ -85,8 +95,7 @@ class FusedWeightOnlyLinearWithBiasPattern
       if (matmul_trans_x || matmul_trans_y) return false;
 
       auto w_dtype = pir::GetDataTypeFromValue(match_ctx.Tensor("w"));
-      if (!w_dtype.isa<pir::Float16Type>() &&
-          !w_dtype.isa<pir::BFloat16Type>()) {
+      if (!IsSupportedWeightType(w_dtype, sm_version)) {
         return false;
       }
 
@@ -108,7 +117,7 @@ class FusedWeightOnlyLinearWithBiasPattern
     //
     paddle::drr::ResultPattern res = src.ResultPattern();
 
-    if (algo_ == "weight_only_int4") {
+    if (algo_ == "weight_only_int4" && sm_version_ != 0) {
       // TODO(liuyuanle): When the operator weight_quantize supports
       // weight_only_int4 on gpu version, delete the memory copy.
       const auto &memcpy_d2h =
@@ -190,7 +199,8 @@ class FusedWeightOnlyLinearNoBiasPattern : public paddle::drr::DrrPatternBase {
     //
     // Constraints.
     //
-    src.AddConstraint([](const paddle::drr::MatchContext &match_ctx) -> bool {
+    int sm_version = sm_version_;
+    src.AddConstraint([sm_version](const paddle::drr::MatchContext &match_ctx) {
       if (!pir::ValueIsPersistable(match_ctx.Tensor("w"))) {
         return false;
       }
@@ -207,8 +217,7 @@ class FusedWeightOnlyLinearNoBiasPattern : public paddle::drr::DrrPatternBase {
       if (w_dims.at(0) % 64 != 0 || w_dims.at(1) % 16 != 0) return false;
 
       auto w_dtype = pir::GetDataTypeFromValue(match_ctx.Tensor("w"));
-      if (!w_dtype.isa<pir::Float16Type>() && !w_dtype.isa<pir::BFloat16Type>())
-        return false;
+      if (!IsSupportedWeightType(w_dtype, sm_version)) return false;
 
       if (x_dims.at(x_dims.size() - 1) != w_dims.at(0)) return false;
 
@@ -219,7 +228,7 @@ class FusedWeightOnlyLinearNoBiasPattern : public paddle::drr::DrrPatternBase {
     //
     paddle::drr::ResultPattern res = src.ResultPattern();
 
-    if (algo_ == "weight_only_int4") {
+    if (algo_ == "weight_only_int4" && sm_version_ != 0) {
       // TODO(liuyuanle): When the operator weight_quantize supports
       // weight_only_int4 on gpu version, delete the memory copy.
       const auto &memcpy_d2h =
@@ -288,6 +297,14 @@ class FusedWeightOnlyLinearPass : public pir::PatternRewritePass {
                           "weight_only_int8 or weight_only_int4, but get %s.",
                           algo));
 
+    // On CPU the weight is quantized into the plain layout of the CPU
+    // kernel, and no copy between devices is needed for int4.
+    if (Has(pir::Pass::kPlaceAttr) &&
+        Get<phi::Place>(pir::Pass::kPlaceAttr).GetType() ==
+            phi::AllocationType::CPU) {
+      sm_version_ = 0;
+    }
+
     pir::RewritePatternSet ps(context);
     ps.Add(paddle::drr::Create<FusedWeightOnlyLinearWithBiasPattern>(
         context, true, algo, sm_version_));
@@ -310,8 +327,9 @@ class FusedWeightOnlyLinearPass : public pir::PatternRewritePass {
   }
 
   bool CanApplyOn(pir::Operation *op) const override {
-    if (sm_version_ != 70 && sm_version_ != 75 && sm_version_ != 80 &&
-        sm_version_ != 86 && sm_version_ != 89 && sm_version_ != 90) {
+    if (sm_version_ != 0 && sm_version_ != 70 && sm_version_ != 75 &&
+        sm_version_ != 80 && sm_version_ != 86 && sm_version_ != 89 &&
+        sm_version_ != 90) {
       return false;
     }
     return op->num_regions() > 0;
@@ -37,7 +37,9 @@ USE_PIR_PASS(conv2d_bn_fuse_pass);
 USE_PIR_PASS(conv2d_add_fuse_pass);
 USE_PIR_PASS(conv2d_add_act_fuse_pass);
 USE_PIR_PASS(embedding_eltwise_layernorm_fuse_pass);
+USE_PIR_PASS(embedding_seqpool_cvm_fuse_pass);
 USE_PIR_PASS(add_norm_fuse_pass);
+USE_PIR_PASS(add_norm_cpu_fuse_pass);
 USE_PIR_PASS(group_norm_silu_fuse_pass);
 USE_PIR_PASS(fused_dot_product_attention_pass);
 USE_PIR_PASS(fused_flash_attn_pass);
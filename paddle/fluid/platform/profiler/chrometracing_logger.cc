@@ -224,7 +224,8 @@ void ChromeTracingLogger::LogHostTraceEventNode(
       "end_time": "%.3f us",
       "input_shapes": %s,
       "input_dtypes": %s,
-      "callstack": "%s"
+      "callstack": "%s",
+      "perf_counters": %s
     }
   },
   )JSON"),
@@ -239,7 +240,8 @@ void ChromeTracingLogger::LogHostTraceEventNode(
           nsToUsFloat(host_node.EndNs(), start_time_),
           json_dict(input_shapes).c_str(),
           json_dict(input_dtypes).c_str(),
-          callstack.c_str());
+          callstack.c_str(),
+          json_perf_counters(host_node.PerfCounters()).c_str());
       break;
     case TracerEventType::CudaRuntime:
     case TracerEventType::Kernel:
@@ -30,6 +30,8 @@ using CommonEvent = phi::CommonEvent;
 
 using CommonMemEvent = phi::CommonMemEvent;
 
+using PerfCounterEvent = phi::PerfCounterEvent;
+
 struct OperatorSupplementOriginEvent {
  public:
   OperatorSupplementOriginEvent(
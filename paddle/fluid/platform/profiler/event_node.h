@@ -197,6 +197,9 @@ class HostTraceEventNode {
   uint64_t Duration() const {
     return host_event_.end_ns - host_event_.start_ns;
   }
+  const PerfCounterValues& PerfCounters() const {
+    return host_event_.perf_counters;
+  }
 
   // member function
   void AddChild(HostTraceEventNode* node) { children_.push_back(node); }
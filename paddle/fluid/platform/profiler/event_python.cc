@@ -47,6 +47,7 @@ HostPythonNode* ProfilerResult::CopyTree(HostTraceEventNode* root) {
   host_python_node->end_ns = root->EndNs();
   host_python_node->process_id = root->ProcessId();
   host_python_node->thread_id = root->ThreadId();
+  host_python_node->perf_counters = root->PerfCounters();
   for (auto child : root->GetChildren()) {
     host_python_node->children_node_ptrs.push_back(CopyTree(child));
   }
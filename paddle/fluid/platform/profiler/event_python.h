@@ -125,6 +125,9 @@ struct HostPythonNode {
   framework::AttributeMap attributes;
   // op id
   uint64_t op_id;
+  // CPU performance counters, valid only if FLAGS_enable_host_perf_counters
+  // was set while profiling
+  PerfCounterValues perf_counters;
   // children node
   std::vector<HostPythonNode*> children_node_ptrs;
   // runtime node
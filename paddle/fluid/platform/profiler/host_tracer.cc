@@ -13,7 +13,10 @@
 // limitations under the License.
 #include "paddle/fluid/platform/profiler/host_tracer.h"
 
+#include <map>
 #include <sstream>
+#include <unordered_map>
+#include <utility>
 
 #include "glog/logging.h"
 #include "paddle/fluid/framework/op_proto_maker.h"
@@ -24,13 +27,34 @@ namespace paddle::platform {
 
 namespace {
 
+// Performance counters of every thread, keyed by the start and end time of
+// the event they were read for.
+using PerfCountersMap = std::unordered_map<
+    uint64_t,
+    std::map<std::pair<uint64_t, uint64_t>, PerfCounterValues>>;
+
+PerfCountersMap GroupPerfCounters(
+    const HostEventSection<PerfCounterEvent>& perf_counter_events) {
+  PerfCountersMap result;
+  for (const auto& thr_sec : perf_counter_events.thr_sections) {
+    auto& thread_counters = result[thr_sec.thread_id];
+    for (const auto& evt : thr_sec.events) {
+      thread_counters.emplace(std::make_pair(evt.start_ns, evt.end_ns),
+                              evt.values);
+    }
+  }
+  return result;
+}
+
 void ProcessHostEvents(const HostEventSection<CommonEvent>& host_events,
+                       const PerfCountersMap& perf_counters,
                        TraceEventCollector* collector) {
   for (const auto& thr_sec : host_events.thr_sections) {
     uint64_t tid = thr_sec.thread_id;
     if (thr_sec.thread_name != phi::kDefaultThreadName) {
       collector->AddThreadName(tid, thr_sec.thread_name);
     }
+    auto thread_counters = perf_counters.find(tid);
     for (const auto& evt : thr_sec.events) {
       HostTraceEvent event;
       event.name = evt.name;
@@ -39,6 +63,13 @@ void ProcessHostEvents(const HostEventSection<CommonEvent>& host_events,
       event.end_ns = evt.end_ns;
       event.process_id = host_events.process_id;
       event.thread_id = tid;
+      if (thread_counters != perf_counters.end()) {
+        auto counters = thread_counters->second.find(
+            std::make_pair(evt.start_ns, evt.end_ns));
+        if (counters != thread_counters->second.end()) {
+          event.perf_counters = counters->second;
+        }
+      }
       collector->AddHostEvent(std::move(event));
     }
   }
@@ -146,6 +177,7 @@ void HostTracer::StartTracing() {
   HostEventRecorder<CommonMemEvent>::GetInstance().GatherEvents();
   HostEventRecorder<OperatorSupplementOriginEvent>::GetInstance()
       .GatherEvents();
+  HostEventRecorder<PerfCounterEvent>::GetInstance().GatherEvents();
   HostTraceLevel::GetInstance().SetLevel(options_.trace_level);
   state_ = TracerState::STARTED;
 }
@@ -166,7 +198,10 @@ void HostTracer::CollectTraceData(TraceEventCollector* collector) {
       common::errors::PreconditionNotMet("TracerState must be STOPED"));
   HostEventSection<CommonEvent> host_events =
       HostEventRecorder<CommonEvent>::GetInstance().GatherEvents();
-  ProcessHostEvents(host_events, collector);
+  HostEventSection<PerfCounterEvent> perf_counter_events =
+      HostEventRecorder<PerfCounterEvent>::GetInstance().GatherEvents();
+  ProcessHostEvents(
+      host_events, GroupPerfCounters(perf_counter_events), collector);
   HostEventSection<CommonMemEvent> host_mem_events =
       HostEventRecorder<CommonMemEvent>::GetInstance().GatherEvents();
   ProcessHostMemEvents(host_mem_events, collector);
@@ -29,6 +29,7 @@ using TracerMemEventType = phi::TracerMemEventType;
 using KernelEventInfo = phi::KernelEventInfo;
 using MemcpyEventInfo = phi::MemcpyEventInfo;
 using MemsetEventInfo = phi::MemsetEventInfo;
+using PerfCounterValues = phi::PerfCounterValues;
 using HostTraceEvent = phi::HostTraceEvent;
 using RuntimeTraceEvent = phi::RuntimeTraceEvent;
 using DeviceTraceEvent = phi::DeviceTraceEvent;
@@ -931,6 +931,17 @@ void BindAnalysisConfig(py::module *m) {
       .def("shape_range_info_path", &AnalysisConfig::shape_range_info_path)
       .def("shape_range_info_collected",
            &AnalysisConfig::shape_range_info_collected)
+      .def("enable_shape_bucketing",
+           &AnalysisConfig::EnableShapeBucketing,
+           py::arg("boundaries") = std::vector<int>({}),
+           py::arg("axis") = 1,
+           py::arg("pad_value") = 0.f)
+      .def("shape_bucketing_enabled", &AnalysisConfig::shape_bucketing_enabled)
+      .def("enable_packed_gemm_weight",
+           &AnalysisConfig::EnablePackedGemmWeight,
+           py::arg("x") = true)
+      .def("packed_gemm_weight_enabled",
+           &AnalysisConfig::packed_gemm_weight_enabled)
       .def("enable_tuned_tensorrt_dynamic_shape",
            &AnalysisConfig::EnableTunedTensorRtDynamicShape,
            py::arg("shape_range_info_path") = "",
@@ -226,7 +226,9 @@ limitations under the License. */
 #include "paddle/phi/api/ext/op_meta_info.h"
 #include "paddle/phi/api/include/operants_manager.h"
 #include "paddle/phi/api/include/tensor_operants.h"
+#include "paddle/phi/api/profiler/flight_recorder.h"
 #include "paddle/phi/common/type_promotion.h"
+#include "paddle/phi/core/platform/metrics_exporter.h"
 #include "paddle/phi/kernels/autotune/cache.h"
 #include "paddle/phi/kernels/autotune/switch_autotune.h"
 #include "paddle/pir/include/core/program.h"
@@ -3002,6 +3004,20 @@ All parameter, weight, gradient are variables in Paddle.
         return ostr.str();
       });
 
+  py::class_<phi::PerfCounterValues>(m, "PerfCounterValues")
+      .def(py::init<>())
+      .def_readwrite("valid", &phi::PerfCounterValues::valid)
+      .def_readwrite("hardware", &phi::PerfCounterValues::hardware)
+      .def_readwrite("cycles", &phi::PerfCounterValues::cycles)
+      .def_readwrite("instructions", &phi::PerfCounterValues::instructions)
+      .def_readwrite("cache_references",
+                     &phi::PerfCounterValues::cache_references)
+      .def_readwrite("cache_misses", &phi::PerfCounterValues::cache_misses)
+      .def_readwrite("task_clock_ns", &phi::PerfCounterValues::task_clock_ns)
+      .def_readwrite("page_faults", &phi::PerfCounterValues::page_faults)
+      .def_property_readonly("bytes_moved",
+                             &phi::PerfCounterValues::BytesMoved);
+
   py::class_<paddle::platform::HostPythonNode>(m, "HostPythonNode")
       .def(py::init<>())
       .def_readwrite("name", &paddle::platform::HostPythonNode::name)
@@ -3020,6 +3036,8 @@ All parameter, weight, gradient are variables in Paddle.
       .def_readwrite("attributes",
                      &paddle::platform::HostPythonNode::attributes)
       .def_readwrite("op_id", &paddle::platform::HostPythonNode::op_id)
+      .def_readwrite("perf_counters",
+                     &paddle::platform::HostPythonNode::perf_counters)
       .def_readwrite("children_node",
                      &paddle::platform::HostPythonNode::children_node_ptrs)
       .def_readwrite("runtime_node",
@@ -3097,6 +3115,21 @@ All parameter, weight, gradient are variables in Paddle.
   m.def("disable_memory_recorder", &paddle::platform::DisableMemoryRecorder);
   m.def("enable_op_info_recorder", &phi::EnableOpInfoRecorder);
   m.def("disable_op_info_recorder", &phi::DisableOpInfoRecorder);
+  m.def(
+      "dump_flight_recorder",
+      [](const std::string &path) {
+        return phi::FlightRecorder::GetInstance().Dump(path);
+      },
+      py::arg("path") = "");
+  m.def("get_metrics_text", []() {
+    return paddle::platform::ToPrometheusText(
+        paddle::platform::MetricsRegistry::GetInstance().Snapshot());
+  });
+  m.def("start_metrics_exporter", []() {
+    paddle::platform::MetricsExporter::GetInstance().StartFromFlags();
+  });
+  m.def("stop_metrics_exporter",
+        []() { paddle::platform::MetricsExporter::GetInstance().Stop(); });
 
 #if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
   m.def("set_cublas_switch", phi::SetAllowTF32Cublas);
@@ -14,6 +14,7 @@ limitations under the License. */
 
 #include "paddle/phi/api/lib/data_transform.h"
 
+#include <algorithm>
 #include <sstream>
 
 #include "glog/logging.h"
@@ -23,6 +24,7 @@ limitations under the License. */
 #include "paddle/phi/api/lib/utils/allocator.h"
 #include "paddle/phi/backends/context_pool.h"
 #include "paddle/phi/core/distributed/auto_parallel/dist_tensor.h"
+#include "paddle/phi/core/distributed/auto_parallel/reshard/p_to_r_reshard_function.h"
 #include "paddle/phi/core/distributed/auto_parallel/reshard/reshard_function.h"
 #include "paddle/phi/core/distributed/auto_parallel/reshard/reshard_function_registry.h"
 #include "paddle/phi/core/distributed/auto_parallel/reshard/reshard_utils.h"
@@ -772,10 +774,14 @@ ReshardApiInputToKernelInput(phi::DeviceContext* dev_ctx,
                     common::errors::InvalidArgument(
                         "Tensor's size should be equal to dist_attrs' size."));
 
-  std::vector<std::shared_ptr<phi::distributed::DistTensor>> out;
+  std::vector<std::shared_ptr<phi::distributed::DistTensor>> out(
+      tensors.size(), nullptr);
+  // Partial to replicated reshards which share the process mesh, dtype and
+  // reduce type are grouped, so that each group needs only one all_reduce.
+  std::vector<std::vector<size_t>> p_to_r_groups;
   for (size_t i = 0; i < tensors.size(); i++) {
     auto tensor_in = tensors[i].impl();
-    auto dist_attr = tensor_dist_attrs[i];
+    const auto& dist_attr = tensor_dist_attrs[i];
     if (tensor_in) {
       phi::distributed::DistTensor* dist_tensor =
           static_cast<phi::distributed::DistTensor*>(tensor_in.get());
@@ -791,15 +797,50 @@ ReshardApiInputToKernelInput(phi::DeviceContext* dev_ctx,
                 << ") " << ReshardDebugInfo(*dist_tensor, dist_attr);
         auto* func = phi::distributed::ChooseProperReshardFunction(*dist_tensor,
                                                                    dist_attr);
-        out.push_back(func->Eval(dev_ctx, *dist_tensor, dist_attr));
+        if (dynamic_cast<phi::distributed::PToRReshardFunction*>(func) &&
+            dist_tensor->value().initialized()) {
+          const auto& in_dist_attr = dist_tensor->dist_attr();
+          auto group = std::find_if(
+              p_to_r_groups.begin(),
+              p_to_r_groups.end(),
+              [&](const std::vector<size_t>& indices) {
+                auto* first = static_cast<phi::distributed::DistTensor*>(
+                    tensors[indices[0]].impl().get());
+                return first->dtype() == dist_tensor->dtype() &&
+                       first->dist_attr().process_mesh() ==
+                           in_dist_attr.process_mesh() &&
+                       first->dist_attr().partial_status().at(0) ==
+                           in_dist_attr.partial_status().at(0);
+              });
+          if (group == p_to_r_groups.end()) {
+            p_to_r_groups.push_back({i});
+          } else {
+            group->push_back(i);
+          }
+        } else {
+          out[i] = func->Eval(dev_ctx, *dist_tensor, dist_attr);
+        }
       } else {
-        out.push_back(
-            std::static_pointer_cast<phi::distributed::DistTensor>(tensor_in));
+        out[i] = std::static_pointer_cast<phi::distributed::DistTensor>(
+            tensor_in);
       }
-    } else {
-      out.push_back(nullptr);
     }
   }
+
+  for (const auto& indices : p_to_r_groups) {
+    std::vector<const phi::distributed::DistTensor*> ins;
+    std::vector<phi::distributed::TensorDistAttr> out_dist_attrs;
+    std::vector<phi::distributed::DistTensor*> outs;
+    for (size_t i : indices) {
+      ins.push_back(static_cast<phi::distributed::DistTensor*>(
+          tensors[i].impl().get()));
+      out_dist_attrs.push_back(tensor_dist_attrs[i]);
+      out[i] = std::make_shared<phi::distributed::DistTensor>();
+      outs.push_back(out[i].get());
+    }
+    phi::distributed::PToRReshardFunction func;
+    func.EvalBatch(dev_ctx, ins, out_dist_attrs, outs);
+  }
   return out;
 }
 
@@ -74,6 +74,19 @@ struct CommonEvent {
   const char *attr = nullptr;  // not owned, designed for performance
 };
 
+// Performance counters of a CommonEvent recorded on the same thread with the
+// same start and end time.
+struct PerfCounterEvent {
+ public:
+  PerfCounterEvent(uint64_t start_ns,
+                   uint64_t end_ns,
+                   const PerfCounterValues &values)
+      : start_ns(start_ns), end_ns(end_ns), values(values) {}
+  uint64_t start_ns;
+  uint64_t end_ns;
+  PerfCounterValues values;
+};
+
 struct CommonMemEvent {
  public:
   CommonMemEvent(uint64_t timestamp_ns,
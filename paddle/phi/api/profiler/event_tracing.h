@@ -92,6 +92,14 @@ class TEST_API RecordEvent {
   TracerEventType type_{TracerEventType::UserDefined};
   std::string* attr_{nullptr};
   bool finished_{false};
+  // Name and start time of the event kept by the FlightRecorder, nullptr if
+  // the flight recorder is disabled.
+  const char* flight_name_{nullptr};
+  uint64_t flight_start_ns_{0};
+  // Performance counters at the start of the event, only read for
+  // operators when FLAGS_enable_host_perf_counters is set.
+  bool read_perf_counters_{false};
+  PerfCounterValues perf_counters_start_;
 };
 
 }  // namespace phi
@@ -0,0 +1,639 @@
+/* Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include "paddle/phi/api/profiler/flight_recorder.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <thread>
+#include <unordered_map>
+
+#ifndef _WIN32
+#include <csignal>
+#include <unistd.h>
+#endif
+
+#include "glog/logging.h"
+
+#include "paddle/common/enforce.h"
+#include "paddle/phi/core/os_info.h"
+
+PHI_DEFINE_EXPORTED_bool(
+    enable_flight_recorder,
+    false,
+    "Keep the most recent host events in per-thread ring buffers, so they "
+    "can be dumped after an incident without a profiling session.");
+
+PHI_DEFINE_EXPORTED_int32(
+    flight_recorder_trace_level,
+    1,
+    "Host events whose trace level is not greater than this value are kept "
+    "by the flight recorder, see RecordEvent for the levels.");
+
+PHI_DEFINE_EXPORTED_int32(
+    flight_recorder_events_per_thread,
+    16384,
+    "Capacity of the ring buffer of every thread, rounded up to a power of "
+    "2. One slot is reserved for the event being written. It takes effect "
+    "for threads that record their first event after it is set.");
+
+PHI_DEFINE_EXPORTED_double(
+    flight_recorder_window_s,
+    10.0,
+    "A flight recorder dump keeps the events of the last "
+    "flight_recorder_window_s seconds.");
+
+PHI_DEFINE_EXPORTED_string(flight_recorder_dump_dir,
+                           ".",
+                           "Directory of the flight recorder dumps which are "
+                           "not given an explicit path.");
+
+PHI_DEFINE_EXPORTED_int32(
+    flight_recorder_dump_signal,
+    0,
+    "Write a flight recorder dump when the process receives this signal, "
+    "e.g. 12 for SIGUSR2 on Linux. 0 means no signal handler is installed.");
+
+PHI_DEFINE_EXPORTED_double(
+    flight_recorder_slo_ms,
+    0.0,
+    "Write a flight recorder dump when a reported latency, e.g. of one "
+    "inference run, exceeds this many milliseconds. 0 means disabled.");
+
+namespace phi {
+
+namespace {
+
+constexpr char kDumpMagic[8] = {'P', 'D', 'F', 'L', 'R', 'E', 'C', '1'};
+
+// Upper bound of interned names, a guard against names which embed ids.
+constexpr size_t kMaxInternedNames = 1 << 16;
+constexpr const char* kNameOverflow = "flight_recorder_name_overflow";
+
+#ifndef _WIN32
+volatile int g_dump_signal_fd = -1;
+
+void OnDumpSignal(int) {
+  if (g_dump_signal_fd >= 0) {
+    char reason = 's';
+    // write() is async-signal-safe, the dump itself runs on the dump thread.
+    ssize_t ret = write(g_dump_signal_fd, &reason, 1);
+    (void)ret;
+  }
+}
+#endif
+
+const char* EventTypeName(uint8_t kind, uint8_t type) {
+  static const char* kEventTypeNames[] = {
+#define EVENT_TYPE_NAME(name) #name,
+      FOR_EACH_TRACER_EVENT_TYPES(EVENT_TYPE_NAME)
+#undef EVENT_TYPE_NAME
+  };
+  static const char* kMemEventTypeNames[] = {
+#define MEM_EVENT_TYPE_NAME(name) #name,
+      FOR_EACH_TRACER_MEM_EVENT_TYPES(MEM_EVENT_TYPE_NAME)
+#undef MEM_EVENT_TYPE_NAME
+  };
+  if (kind == FlightRecorderEvent::kMemory) {
+    return type < std::size(kMemEventTypeNames) ? kMemEventTypeNames[type]
+                                                : "Memory";
+  }
+  return type < std::size(kEventTypeNames) ? kEventTypeNames[type]
+                                           : "UserDefined";
+}
+
+std::string EscapeJson(const char* str) {
+  std::string result;
+  for (const char* p = str; *p != '\0'; ++p) {
+    char c = *p;
+    if (c == '"' || c == '\\') {
+      result.push_back('\\');
+      result.push_back(c);
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      char buf[8];
+      snprintf(buf, sizeof(buf), "\\u%04x", c);
+      result.append(buf);
+    } else {
+      result.push_back(c);
+    }
+  }
+  return result;
+}
+
+template <typename T>
+void WritePod(std::ostream& os, T value) {
+  os.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+void WriteString(std::ostream& os, const std::string& str) {
+  WritePod<uint32_t>(os, static_cast<uint32_t>(str.size()));
+  os.write(str.data(), static_cast<std::streamsize>(str.size()));
+}
+
+template <typename T>
+T ReadPod(std::istream& is) {
+  T value{};
+  is.read(reinterpret_cast<char*>(&value), sizeof(T));
+  return value;
+}
+
+std::string ReadString(std::istream& is) {
+  std::string str(ReadPod<uint32_t>(is), '\0');
+  is.read(&str[0], static_cast<std::streamsize>(str.size()));
+  return str;
+}
+
+void WriteBinaryDump(const std::vector<FlightRecorderThreadEvents>& threads,
+                     uint64_t now_ns,
+                     uint64_t begin_ns,
+                     std::ostream& os) {
+  std::unordered_map<const char*, uint32_t> name_ids;
+  std::vector<const char*> names;
+  for (auto& thread : threads) {
+    for (auto& event : thread.events) {
+      if (name_ids.emplace(event.name, names.size()).second) {
+        names.push_back(event.name);
+      }
+    }
+  }
+  os.write(kDumpMagic, sizeof(kDumpMagic));
+  WritePod<uint64_t>(os, now_ns);
+  WritePod<uint64_t>(os, begin_ns);
+  WritePod<uint32_t>(os, static_cast<uint32_t>(names.size()));
+  for (const char* name : names) {
+    WriteString(os, name);
+  }
+  WritePod<uint32_t>(os, static_cast<uint32_t>(threads.size()));
+  for (auto& thread : threads) {
+    WritePod<uint64_t>(os, thread.thread_id);
+    WriteString(os, thread.thread_name);
+    WritePod<uint32_t>(os, static_cast<uint32_t>(thread.events.size()));
+    for (auto& event : thread.events) {
+      WritePod<uint32_t>(os, name_ids[event.name]);
+      WritePod<uint8_t>(os, event.kind);
+      WritePod<uint8_t>(os, event.type);
+      WritePod<uint16_t>(os, 0);
+      WritePod<uint64_t>(os, event.start_ns);
+      WritePod<uint64_t>(os, event.end_ns);
+      WritePod<uint64_t>(os, event.arg);
+    }
+  }
+}
+
+void WriteChromeTrace(const std::vector<FlightRecorderThreadEvents>& threads,
+                      std::ostream& os) {
+  const uint32_t pid = GetProcessId();
+  os << "{\n\"displayTimeUnit\": \"ns\",\n\"traceEvents\": [\n";
+  bool first = true;
+  auto separator = [&]() -> const char* {
+    const char* sep = first ? "" : ",\n";
+    first = false;
+    return sep;
+  };
+  char buf[64];
+  for (auto& thread : threads) {
+    os << separator() << "{\"name\": \"thread_name\", \"ph\": \"M\", "
+       << "\"pid\": " << pid << ", \"tid\": " << thread.thread_id
+       << ", \"args\": {\"name\": \""
+       << EscapeJson(thread.thread_name.c_str()) << "\"}}";
+    for (auto& event : thread.events) {
+      os << separator() << "{\"name\": \"" << EscapeJson(event.name)
+         << "\", \"cat\": \"" << EventTypeName(event.kind, event.type)
+         << "\", \"pid\": " << pid << ", \"tid\": " << thread.thread_id;
+      // Chrome trace timestamps are in microseconds.
+      snprintf(buf, sizeof(buf), "%.3f", event.start_ns / 1000.0);
+      os << ", \"ts\": " << buf;
+      if (event.kind == FlightRecorderEvent::kHost) {
+        snprintf(buf,
+                 sizeof(buf),
+                 "%.3f",
+                 (event.end_ns - event.start_ns) / 1000.0);
+        os << ", \"ph\": \"X\", \"dur\": " << buf << "}";
+      } else {
+        os << ", \"ph\": \"i\", \"s\": \"t\", \"args\": {\""
+           << (event.kind == FlightRecorderEvent::kMemory ? "bytes"
+                                                          : "latency_ns")
+           << "\": " << event.arg << "}}";
+      }
+    }
+  }
+  os << "\n]\n}\n";
+}
+
+}  // namespace
+
+// Ring buffer of one thread. Only the owning thread appends, any thread may
+// read. Every slot is overwritten in place, so the reader validates what it
+// copied against the write index afterwards, like the reader of a seqlock.
+class FlightRecorder::ThreadBuffer {
+ public:
+  explicit ThreadBuffer(size_t capacity)
+      : thread_id_(GetCurrentThreadSysId()),
+        thread_name_(GetCurrentThreadName()) {
+    size_t size = 1;
+    while (size < capacity) {
+      size <<= 1;
+    }
+    mask_ = size - 1;
+    slots_.reset(new Slot[size]);
+  }
+
+  void Append(const char* name,
+              uint64_t start_ns,
+              uint64_t end_ns,
+              uint64_t arg,
+              uint8_t kind,
+              uint8_t type) {
+    uint64_t index = head_.load(std::memory_order_relaxed);
+    // Orders the previous store of head_ before the slot is overwritten, so
+    // a reader that sees the new content also sees that the slot was reused.
+    std::atomic_thread_fence(std::memory_order_release);
+    Slot& slot = slots_[index & mask_];
+    slot.name.store(name, std::memory_order_relaxed);
+    slot.start_ns.store(start_ns, std::memory_order_relaxed);
+    slot.end_ns.store(end_ns, std::memory_order_relaxed);
+    slot.arg.store(arg, std::memory_order_relaxed);
+    slot.kind_type.store(static_cast<uint32_t>(kind) << 8 | type,
+                         std::memory_order_relaxed);
+    head_.store(index + 1, std::memory_order_release);
+  }
+
+  // Appends the events that ended at or after begin_ns to `events`.
+  void Read(uint64_t begin_ns, std::vector<FlightRecorderEvent>* events) const {
+    const uint64_t capacity = mask_ + 1;
+    const uint64_t head = head_.load(std::memory_order_acquire);
+    const uint64_t first = head > capacity ? head - capacity : 0;
+    std::vector<FlightRecorderEvent> copied;
+    copied.reserve(head - first);
+    for (uint64_t i = first; i < head; ++i) {
+      const Slot& slot = slots_[i & mask_];
+      uint32_t kind_type = slot.kind_type.load(std::memory_order_relaxed);
+      copied.push_back({slot.name.load(std::memory_order_relaxed),
+                        slot.start_ns.load(std::memory_order_relaxed),
+                        slot.end_ns.load(std::memory_order_relaxed),
+                        slot.arg.load(std::memory_order_relaxed),
+                        static_cast<uint8_t>(kind_type >> 8),
+                        static_cast<uint8_t>(kind_type & 0xff)});
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    // The writer may have been overwriting the slots of the indices up to
+    // new_head - capacity while they were copied.
+    const uint64_t new_head = head_.load(std::memory_order_relaxed);
+    const uint64_t valid = new_head >= capacity ? new_head - capacity + 1 : 0;
+    for (uint64_t i = std::max(first, valid); i < head; ++i) {
+      const FlightRecorderEvent& event = copied[i - first];
+      if (event.end_ns >= begin_ns) {
+        events->push_back(event);
+      }
+    }
+  }
+
+  uint64_t thread_id() const { return thread_id_; }
+  const std::string& thread_name() const { return thread_name_; }
+
+  // End time of the newest event, only meaningful once the thread exited.
+  uint64_t last_end_ns() const {
+    uint64_t head = head_.load(std::memory_order_acquire);
+    return head == 0 ? 0
+                     : slots_[(head - 1) & mask_].end_ns.load(
+                           std::memory_order_relaxed);
+  }
+
+  bool exited() const { return exited_.load(); }
+  void set_exited() { exited_.store(true); }
+
+ private:
+  struct Slot {
+    std::atomic<const char*> name{nullptr};
+    std::atomic<uint64_t> start_ns{0};
+    std::atomic<uint64_t> end_ns{0};
+    std::atomic<uint64_t> arg{0};
+    std::atomic<uint32_t> kind_type{0};
+  };
+
+  uint64_t thread_id_;
+  std::string thread_name_;
+  uint64_t mask_;
+  std::unique_ptr<Slot[]> slots_;
+  std::atomic<uint64_t> head_{0};
+  std::atomic<bool> exited_{false};
+};
+
+FlightRecorder& FlightRecorder::GetInstance() {
+  // Never destroyed: threads may still record while the process exits.
+  static FlightRecorder* instance = new FlightRecorder();
+  return *instance;
+}
+
+FlightRecorder::ThreadBuffer* FlightRecorder::GetThreadBuffer() {
+  // Marks the buffer as orphaned when its thread exits. The events of an
+  // exited thread are still dumped until they leave the window.
+  struct BufferHolder {
+    std::shared_ptr<ThreadBuffer> buffer;
+    ~BufferHolder() {
+      if (buffer != nullptr) {
+        buffer->set_exited();
+      }
+    }
+  };
+  thread_local BufferHolder holder;
+  auto& buffer = holder.buffer;
+  if (UNLIKELY(buffer == nullptr)) {
+    PADDLE_ENFORCE_GT(FLAGS_flight_recorder_events_per_thread,
+                      0,
+                      common::errors::InvalidArgument(
+                          "FLAGS_flight_recorder_events_per_thread should be "
+                          "greater than 0, but received %d.",
+                          FLAGS_flight_recorder_events_per_thread));
+    buffer = std::make_shared<ThreadBuffer>(
+        static_cast<size_t>(FLAGS_flight_recorder_events_per_thread));
+    {
+      const uint64_t now_ns = PosixInNsec();
+      const auto window_ns =
+          static_cast<uint64_t>(FLAGS_flight_recorder_window_s * 1e9);
+      std::lock_guard<std::mutex> lock(buffers_mutex_);
+      // Drop the buffers of exited threads that have nothing left to dump,
+      // otherwise short-lived threads would leak one buffer each.
+      buffers_.erase(
+          std::remove_if(buffers_.begin(),
+                         buffers_.end(),
+                         [&](const std::shared_ptr<ThreadBuffer>& b) {
+                           return b->exited() &&
+                                  b->last_end_ns() + window_ns < now_ns;
+                         }),
+          buffers_.end());
+      buffers_.push_back(buffer);
+    }
+    if (FLAGS_flight_recorder_dump_signal > 0) {
+      StartDumpThread();
+    }
+  }
+  return buffer.get();
+}
+
+void FlightRecorder::Append(const char* name,
+                            uint64_t start_ns,
+                            uint64_t end_ns,
+                            uint64_t arg,
+                            uint8_t kind,
+                            uint8_t type) {
+  GetThreadBuffer()->Append(name, start_ns, end_ns, arg, kind, type);
+}
+
+void FlightRecorder::RecordMemEvent(uint64_t time_ns,
+                                    uint64_t bytes,
+                                    TracerMemEventType type) {
+  static const char* kMemEventNames[] = {
+#define MEM_EVENT_NAME(name) "Memory" #name,
+      FOR_EACH_TRACER_MEM_EVENT_TYPES(MEM_EVENT_NAME)
+#undef MEM_EVENT_NAME
+  };
+  Append(kMemEventNames[static_cast<int>(type)],
+         time_ns,
+         time_ns,
+         bytes,
+         FlightRecorderEvent::kMemory,
+         static_cast<uint8_t>(type));
+}
+
+const char* FlightRecorder::InternName(const std::string& name) {
+  thread_local std::unordered_map<std::string, const char*> cache;
+  auto it = cache.find(name);
+  if (LIKELY(it != cache.end())) {
+    return it->second;
+  }
+  const char* interned = kNameOverflow;
+  {
+    std::lock_guard<std::mutex> lock(names_mutex_);
+    auto found = names_.find(name);
+    if (found != names_.end()) {
+      interned = found->c_str();
+    } else if (names_.size() < kMaxInternedNames) {
+      interned = names_.insert(name).first->c_str();
+    }
+  }
+  if (cache.size() < kMaxInternedNames) {
+    cache.emplace(name, interned);
+  }
+  return interned;
+}
+
+void FlightRecorder::ReportLatency(const char* name, uint64_t latency_ns) {
+  uint64_t now_ns = PosixInNsec();
+  Append(name,
+         now_ns,
+         now_ns,
+         latency_ns,
+         FlightRecorderEvent::kInstant,
+         static_cast<uint8_t>(TracerEventType::UserDefined));
+  if (FLAGS_flight_recorder_slo_ms <= 0 ||
+      latency_ns <= FLAGS_flight_recorder_slo_ms * 1e6) {
+    return;
+  }
+  // Automatic dumps are at least one window apart, so a burst of slow
+  // requests produces one dump instead of one per request.
+  const auto window_ns =
+      static_cast<uint64_t>(FLAGS_flight_recorder_window_s * 1e9);
+  uint64_t last = last_auto_dump_ns_.load();
+  if (last != 0 && now_ns - last < window_ns) {
+    return;
+  }
+  if (!last_auto_dump_ns_.compare_exchange_strong(last, now_ns)) {
+    return;
+  }
+  LOG(WARNING) << name << " took " << latency_ns / 1e6
+               << " ms, which exceeds FLAGS_flight_recorder_slo_ms ("
+               << FLAGS_flight_recorder_slo_ms
+               << " ms), dump the flight recorder.";
+  TriggerDump("slo");
+}
+
+void FlightRecorder::TriggerDump(const char* reason) {
+#ifndef _WIN32
+  StartDumpThread();
+  if (dump_pipe_[1] >= 0) {
+    char code = reason[0];
+    if (write(dump_pipe_[1], &code, 1) == 1) {
+      return;
+    }
+  }
+#endif
+  Dump();
+}
+
+void FlightRecorder::StartDumpThread() {
+#ifndef _WIN32
+  std::call_once(dump_thread_once_, [this]() {
+    if (pipe(dump_pipe_) != 0) {
+      LOG(WARNING) << "Failed to create the pipe of the flight recorder, "
+                      "dumps are written by the triggering thread.";
+      dump_pipe_[0] = dump_pipe_[1] = -1;
+      return;
+    }
+    std::thread(&FlightRecorder::DumpThreadLoop, this).detach();
+    if (FLAGS_flight_recorder_dump_signal > 0) {
+      g_dump_signal_fd = dump_pipe_[1];
+      struct sigaction action;
+      std::memset(&action, 0, sizeof(action));
+      action.sa_handler = OnDumpSignal;
+      sigemptyset(&action.sa_mask);
+      action.sa_flags = SA_RESTART;
+      if (sigaction(FLAGS_flight_recorder_dump_signal, &action, nullptr) !=
+          0) {
+        LOG(WARNING) << "Failed to install the flight recorder handler of "
+                        "signal "
+                     << FLAGS_flight_recorder_dump_signal;
+      } else {
+        VLOG(1) << "The flight recorder dumps on signal "
+                << FLAGS_flight_recorder_dump_signal;
+      }
+    }
+  });
+#endif
+}
+
+void FlightRecorder::DumpThreadLoop() {
+#ifndef _WIN32
+  SetCurrentThreadName("FlightRecorder");
+  char code;
+  while (true) {
+    ssize_t ret = read(dump_pipe_[0], &code, 1);
+    if (ret == 1) {
+      VLOG(1) << "Flight recorder dump triggered by "
+              << (code == 's' ? "signal" : "latency SLO");
+      Dump();
+    } else if (ret == 0 || errno != EINTR) {
+      break;
+    }
+  }
+#endif
+}
+
+std::vector<FlightRecorderThreadEvents> FlightRecorder::Snapshot() const {
+  const uint64_t now_ns = PosixInNsec();
+  const auto window_ns =
+      static_cast<uint64_t>(FLAGS_flight_recorder_window_s * 1e9);
+  const uint64_t begin_ns = std::max(
+      now_ns > window_ns ? now_ns - window_ns : 0, clear_ns_.load());
+  std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+  {
+    std::lock_guard<std::mutex> lock(buffers_mutex_);
+    buffers = buffers_;
+  }
+  std::vector<FlightRecorderThreadEvents> result;
+  for (auto& buffer : buffers) {
+    FlightRecorderThreadEvents thread;
+    thread.thread_id = buffer->thread_id();
+    thread.thread_name = buffer->thread_name();
+    buffer->Read(begin_ns, &thread.events);
+    if (!thread.events.empty()) {
+      result.push_back(std::move(thread));
+    }
+  }
+  return result;
+}
+
+std::string FlightRecorder::Dump(const std::string& path) {
+  std::lock_guard<std::mutex> lock(dump_mutex_);
+  const uint64_t now_ns = PosixInNsec();
+  std::string file = path;
+  if (file.empty()) {
+    file = FLAGS_flight_recorder_dump_dir + "/flight_recorder." +
+           std::to_string(GetProcessId()) + "." + std::to_string(now_ns) +
+           ".pdfr";
+  }
+  const auto window_ns =
+      static_cast<uint64_t>(FLAGS_flight_recorder_window_s * 1e9);
+  auto threads = Snapshot();
+  // Dumps run on the dump thread or out of a predictor run, so a failure is
+  // logged rather than thrown.
+  std::ofstream ofs(file, std::ios::out | std::ios::binary);
+  if (!ofs.is_open()) {
+    LOG(WARNING) << "Cannot open file " << file
+                 << " to dump the flight recorder.";
+    return "";
+  }
+  const std::string json_suffix = ".json";
+  if (file.size() >= json_suffix.size() &&
+      file.compare(file.size() - json_suffix.size(),
+                   json_suffix.size(),
+                   json_suffix) == 0) {
+    WriteChromeTrace(threads, ofs);
+  } else {
+    WriteBinaryDump(threads,
+                    now_ns,
+                    now_ns > window_ns ? now_ns - window_ns : 0,
+                    ofs);
+  }
+  ofs.close();
+  if (ofs.fail()) {
+    LOG(WARNING) << "Failed to write the flight recorder dump " << file;
+    return "";
+  }
+  ++num_dumps_;
+  LOG(INFO) << "Flight recorder dumped the events of " << threads.size()
+            << " threads to " << file;
+  return file;
+}
+
+std::vector<FlightRecorderThreadEvents> FlightRecorder::LoadDump(
+    const std::string& path) {
+  std::ifstream ifs(path, std::ios::in | std::ios::binary);
+  PADDLE_ENFORCE_EQ(
+      ifs.is_open(),
+      true,
+      common::errors::NotFound("Cannot open flight recorder dump %s.", path));
+  char magic[sizeof(kDumpMagic)];
+  ifs.read(magic, sizeof(magic));
+  PADDLE_ENFORCE_EQ(
+      ifs.good() && std::memcmp(magic, kDumpMagic, sizeof(magic)) == 0,
+      true,
+      common::errors::InvalidArgument(
+          "%s is not a binary flight recorder dump.", path));
+  ReadPod<uint64_t>(ifs);  // dump time
+  ReadPod<uint64_t>(ifs);  // window begin
+  std::vector<const char*> names(ReadPod<uint32_t>(ifs));
+  for (auto& name : names) {
+    name = InternName(ReadString(ifs));
+  }
+  std::vector<FlightRecorderThreadEvents> threads(ReadPod<uint32_t>(ifs));
+  for (auto& thread : threads) {
+    thread.thread_id = ReadPod<uint64_t>(ifs);
+    thread.thread_name = ReadString(ifs);
+    thread.events.resize(ReadPod<uint32_t>(ifs));
+    for (auto& event : thread.events) {
+      uint32_t name_id = ReadPod<uint32_t>(ifs);
+      event.name = name_id < names.size() ? names[name_id] : kNameOverflow;
+      event.kind = ReadPod<uint8_t>(ifs);
+      event.type = ReadPod<uint8_t>(ifs);
+      ReadPod<uint16_t>(ifs);
+      event.start_ns = ReadPod<uint64_t>(ifs);
+      event.end_ns = ReadPod<uint64_t>(ifs);
+      event.arg = ReadPod<uint64_t>(ifs);
+    }
+  }
+  PADDLE_ENFORCE_EQ(ifs.fail(),
+                    false,
+                    common::errors::InvalidArgument(
+                        "Flight recorder dump %s is truncated.", path));
+  return threads;
+}
+
+void FlightRecorder::Clear() { clear_ns_.store(PosixInNsec()); }
+
+}  // namespace phi
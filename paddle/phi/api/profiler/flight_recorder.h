@@ -0,0 +1,171 @@
+/* Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "paddle/common/flags.h"
+#include "paddle/phi/api/profiler/trace_event.h"
+#include "paddle/utils/test_macros.h"
+
+COMMON_DECLARE_bool(enable_flight_recorder);
+COMMON_DECLARE_int32(flight_recorder_trace_level);
+
+namespace phi {
+
+// One event kept by the flight recorder. Memory events are instants
+// (start_ns == end_ns) and carry the number of bytes in `arg`.
+struct FlightRecorderEvent {
+  enum Kind : uint8_t { kHost = 0, kMemory = 1, kInstant = 2 };
+
+  const char* name;
+  uint64_t start_ns;
+  uint64_t end_ns;
+  uint64_t arg;
+  uint8_t kind;
+  // TracerEventType for host and instant events, TracerMemEventType for
+  // memory events.
+  uint8_t type;
+};
+
+struct FlightRecorderThreadEvents {
+  uint64_t thread_id;
+  std::string thread_name;
+  // Sorted by end time.
+  std::vector<FlightRecorderEvent> events;
+};
+
+// Always-on, low overhead recorder of the most recent host events.
+//
+// Unlike HostEventRecorder, which keeps every event of an explicit profiling
+// session, every thread owns a fixed size ring buffer of events which is
+// written without locks and silently overwrites its oldest entries. A dump
+// keeps the events that ended within the last
+// FLAGS_flight_recorder_window_s seconds, so the moments before an incident
+// can be inspected after the fact. A dump is taken
+// - on demand, through Dump(),
+// - when the process receives FLAGS_flight_recorder_dump_signal,
+// - when ReportLatency() sees a latency above FLAGS_flight_recorder_slo_ms.
+//
+// Dumps whose path ends with ".json" are written in the Chrome trace format,
+// which Perfetto UI and chrome://tracing load. Other dumps use the compact
+// binary format below, all integers are little endian:
+//   char[8] magic "PDFLREC1"
+//   u64 dump time (ns), u64 window begin (ns)
+//   u32 number of names, then per name: u32 size, bytes
+//   u32 number of threads, then per thread:
+//     u64 thread id, u32 name size, bytes, u32 number of events,
+//     then per event: u32 name index, u8 kind, u8 type, u16 reserved,
+//                     u64 start (ns), u64 end (ns), u64 arg
+class FlightRecorder {
+ public:
+  TEST_API static FlightRecorder& GetInstance();
+
+  static bool IsEnabled(uint32_t level) {
+    return FLAGS_enable_flight_recorder &&
+           level <= static_cast<uint32_t>(FLAGS_flight_recorder_trace_level);
+  }
+
+  // `name` must outlive the recorder, e.g. a string literal or a name
+  // returned by InternName().
+  void RecordEvent(const char* name,
+                   uint64_t start_ns,
+                   uint64_t end_ns,
+                   TracerEventType type) {
+    Append(name,
+           start_ns,
+           end_ns,
+           0,
+           FlightRecorderEvent::kHost,
+           static_cast<uint8_t>(type));
+  }
+
+  TEST_API void RecordMemEvent(uint64_t time_ns,
+                               uint64_t bytes,
+                               TracerMemEventType type);
+
+  // Returns a copy of `name` that lives as long as the process. Names are
+  // cached per thread, so repeated names only take the global lock once.
+  TEST_API const char* InternName(const std::string& name);
+
+  // Records `latency_ns` as an instant event named `name` and triggers an
+  // asynchronous dump if it exceeds FLAGS_flight_recorder_slo_ms. Automatic
+  // dumps are at least one window apart.
+  TEST_API void ReportLatency(const char* name, uint64_t latency_ns);
+
+  // Writes the current window to `path`, or to a new file in
+  // FLAGS_flight_recorder_dump_dir if `path` is empty. Returns the path
+  // written, or an empty string if the file cannot be written.
+  TEST_API std::string Dump(const std::string& path = "");
+
+  // Events of every thread that ended within the window.
+  TEST_API std::vector<FlightRecorderThreadEvents> Snapshot() const;
+
+  // Reads a dump written in the binary format. Names are owned by the
+  // recorder's name table.
+  TEST_API std::vector<FlightRecorderThreadEvents> LoadDump(
+      const std::string& path);
+
+  // Hides all events recorded so far from later dumps, mainly for tests.
+  TEST_API void Clear();
+
+  // Number of dumps written so far.
+  uint64_t NumDumps() const { return num_dumps_.load(); }
+
+ private:
+  class ThreadBuffer;
+
+  FlightRecorder() = default;
+
+  void Append(const char* name,
+              uint64_t start_ns,
+              uint64_t end_ns,
+              uint64_t arg,
+              uint8_t kind,
+              uint8_t type);
+
+  ThreadBuffer* GetThreadBuffer();
+
+  // Asks the dump thread to write a dump, or writes it directly if there
+  // is no dump thread.
+  void TriggerDump(const char* reason);
+
+  void StartDumpThread();
+
+  void DumpThreadLoop();
+
+  mutable std::mutex buffers_mutex_;
+  std::vector<std::shared_ptr<ThreadBuffer>> buffers_;
+
+  std::mutex names_mutex_;
+  // Node based, so the interned strings never move.
+  std::unordered_set<std::string> names_;
+
+  std::mutex dump_mutex_;
+  std::once_flag dump_thread_once_;
+  int dump_pipe_[2] = {-1, -1};
+  std::atomic<uint64_t> last_auto_dump_ns_{0};
+  // Events that ended before Clear() are not dumped.
+  std::atomic<uint64_t> clear_ns_{0};
+  std::atomic<uint64_t> num_dumps_{0};
+};
+
+}  // namespace phi
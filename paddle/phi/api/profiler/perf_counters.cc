@@ -0,0 +1,204 @@
+/* Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include "paddle/phi/api/profiler/perf_counters.h"
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <vector>
+#endif
+
+#include "glog/logging.h"
+
+PHI_DEFINE_EXPORTED_bool(
+    enable_host_perf_counters,
+    false,
+    "Attach CPU performance counters (cycles, instructions, cache misses) "
+    "to the operator events of the profiler. Uses perf_event_open on Linux "
+    "and falls back to software counters when the hardware counters are not "
+    "available.");
+
+namespace phi {
+
+#ifdef __linux__
+namespace {
+
+// Position of a counter in PerfCounterValues.
+enum class Counter {
+  kCycles,
+  kInstructions,
+  kCacheReferences,
+  kCacheMisses,
+  kTaskClock,
+  kPageFaults
+};
+
+uint64_t* CounterField(PerfCounterValues* values, Counter counter) {
+  switch (counter) {
+    case Counter::kCycles:
+      return &values->cycles;
+    case Counter::kInstructions:
+      return &values->instructions;
+    case Counter::kCacheReferences:
+      return &values->cache_references;
+    case Counter::kCacheMisses:
+      return &values->cache_misses;
+    case Counter::kTaskClock:
+      return &values->task_clock_ns;
+    case Counter::kPageFaults:
+      return &values->page_faults;
+  }
+  return nullptr;
+}
+
+// The perf_event_open group of one thread.
+class PerfEventGroup {
+ public:
+  PerfEventGroup() {
+    hardware_ =
+        Open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES, Counter::kCycles);
+    if (hardware_) {
+      Open(PERF_TYPE_HARDWARE,
+           PERF_COUNT_HW_INSTRUCTIONS,
+           Counter::kInstructions);
+      Open(PERF_TYPE_HARDWARE,
+           PERF_COUNT_HW_CACHE_REFERENCES,
+           Counter::kCacheReferences);
+      Open(PERF_TYPE_HARDWARE,
+           PERF_COUNT_HW_CACHE_MISSES,
+           Counter::kCacheMisses);
+    }
+    Open(PERF_TYPE_SOFTWARE, PERF_COUNT_SW_TASK_CLOCK, Counter::kTaskClock);
+    Open(PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS, Counter::kPageFaults);
+    if (leader_fd_ < 0) {
+      LOG_FIRST_N(WARNING, 1)
+          << "perf_event_open failed (" << std::strerror(errno)
+          << "), CPU performance counters are not collected.";
+      return;
+    }
+    if (!hardware_) {
+      LOG_FIRST_N(WARNING, 1)
+          << "Hardware performance counters are not available, only "
+             "software counters are collected.";
+    }
+    ioctl(leader_fd_, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(leader_fd_, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    buffer_.resize(3 + counters_.size());
+  }
+
+  ~PerfEventGroup() {
+    for (int fd : fds_) {
+      close(fd);
+    }
+  }
+
+  bool Read(PerfCounterValues* values) {
+    if (leader_fd_ < 0) {
+      return false;
+    }
+    // Layout of PERF_FORMAT_GROUP with the total times:
+    // nr, time_enabled, time_running, value[nr].
+    const size_t size = buffer_.size() * sizeof(uint64_t);
+    if (read(leader_fd_, buffer_.data(), size) != static_cast<ssize_t>(size)) {
+      return false;
+    }
+    const uint64_t enabled = buffer_[1];
+    const uint64_t running = buffer_[2];
+    for (size_t i = 0; i < counters_.size() && i < buffer_[0]; ++i) {
+      uint64_t value = buffer_[3 + i];
+      // The kernel multiplexes the counters if there are not enough of
+      // them, extrapolate to the whole enabled time.
+      if (running > 0 && running < enabled) {
+        value = static_cast<uint64_t>(static_cast<double>(value) * enabled /
+                                      running);
+      }
+      *CounterField(values, counters_[i]) = value;
+    }
+    values->valid = true;
+    values->hardware = hardware_;
+    return true;
+  }
+
+ private:
+  bool Open(uint32_t type, uint64_t config, Counter counter) {
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.disabled = leader_fd_ < 0 ? 1 : 0;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED |
+                       PERF_FORMAT_TOTAL_TIME_RUNNING;
+    // Count the calling thread on any CPU.
+    int fd = static_cast<int>(
+        syscall(__NR_perf_event_open, &attr, 0, -1, leader_fd_, 0));
+    if (fd < 0) {
+      return false;
+    }
+    if (leader_fd_ < 0) {
+      leader_fd_ = fd;
+    }
+    fds_.push_back(fd);
+    counters_.push_back(counter);
+    return true;
+  }
+
+  int leader_fd_ = -1;
+  bool hardware_ = false;
+  std::vector<int> fds_;
+  std::vector<Counter> counters_;
+  std::vector<uint64_t> buffer_;
+};
+
+}  // namespace
+#endif
+
+bool PerfCounterReader::Read(PerfCounterValues* values) {
+#ifdef __linux__
+  thread_local PerfEventGroup group;
+  return group.Read(values);
+#else
+  return false;
+#endif
+}
+
+PerfCounterValues PerfCounterReader::Diff(const PerfCounterValues& begin,
+                                          const PerfCounterValues& end) {
+  PerfCounterValues result;
+  if (!begin.valid || !end.valid) {
+    return result;
+  }
+  // Scaled counters are estimates, never report a negative delta.
+  auto delta = [](uint64_t a, uint64_t b) { return b > a ? b - a : 0; };
+  result.valid = true;
+  result.hardware = begin.hardware && end.hardware;
+  result.cycles = delta(begin.cycles, end.cycles);
+  result.instructions = delta(begin.instructions, end.instructions);
+  result.cache_references =
+      delta(begin.cache_references, end.cache_references);
+  result.cache_misses = delta(begin.cache_misses, end.cache_misses);
+  result.task_clock_ns = delta(begin.task_clock_ns, end.task_clock_ns);
+  result.page_faults = delta(begin.page_faults, end.page_faults);
+  return result;
+}
+
+}  // namespace phi
@@ -0,0 +1,47 @@
+/* Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#pragma once
+
+#include "paddle/common/flags.h"
+#include "paddle/phi/api/profiler/trace_event.h"
+#include "paddle/utils/test_macros.h"
+
+COMMON_DECLARE_bool(enable_host_perf_counters);
+
+namespace phi {
+
+// Reads the CPU performance counters of the calling thread.
+//
+// On Linux, every thread opens one perf_event_open group on first use:
+// cycles, instructions, last level cache references and misses, task clock
+// and page faults, all counted in user space only. When the hardware
+// counters are not available, e.g. in a container or a VM without a
+// virtual PMU, or with kernel.perf_event_paranoid > 2, only the software
+// counters (task clock and page faults) are opened. Counters multiplexed by
+// the kernel are scaled by their enabled / running time.
+class PerfCounterReader {
+ public:
+  static bool IsEnabled() { return FLAGS_enable_host_perf_counters; }
+
+  // Stores the current counters of the calling thread in `values`. Returns
+  // false, and leaves values->valid false, if no counter could be opened.
+  TEST_API static bool Read(PerfCounterValues* values);
+
+  // Counters accumulated between two reads of the same thread.
+  TEST_API static PerfCounterValues Diff(const PerfCounterValues& begin,
+                                         const PerfCounterValues& end);
+};
+
+}  // namespace phi
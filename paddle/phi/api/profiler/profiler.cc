@@ -24,8 +24,10 @@ limitations under the License. */
 
 #include "paddle/phi/api/profiler/common_event.h"
 #include "paddle/phi/api/profiler/device_tracer.h"
+#include "paddle/phi/api/profiler/flight_recorder.h"
 #include "paddle/phi/api/profiler/host_event_recorder.h"
 #include "paddle/phi/api/profiler/host_tracer.h"
+#include "paddle/phi/api/profiler/perf_counters.h"
 #include "paddle/phi/api/profiler/profiler_helper.h"
 #include "paddle/phi/core/enforce.h"
 #include "paddle/phi/core/os_info.h"
@@ -43,6 +45,25 @@ PHI_DEFINE_bool(enable_record_op_info,
 
 namespace phi {
 
+namespace {
+
+// Reads the performance counters at the start of an operator event if they
+// are enabled. Returns whether they were read.
+bool ReadStartPerfCounters(TracerEventType type, PerfCounterValues *values) {
+  if (LIKELY(!PerfCounterReader::IsEnabled())) {
+    return false;
+  }
+  if (type != TracerEventType::Operator &&
+      type != TracerEventType::OperatorInner &&
+      type != TracerEventType::DygraphKernelLaunch &&
+      type != TracerEventType::StaticKernelLaunch) {
+    return false;
+  }
+  return PerfCounterReader::Read(values);
+}
+
+}  // namespace
+
 ProfilerState ProfilerHelper::g_state = ProfilerState::kDisabled;
 bool ProfilerHelper::g_enable_nvprof_hook = false;
 thread_local uint64_t ProfilerHelper::g_thread_id;
@@ -108,6 +129,11 @@ RecordEvent::RecordEvent(const char *name,
   }
 #endif
 #endif
+  if (UNLIKELY(FlightRecorder::IsEnabled(level))) {
+    flight_name_ = name;
+    type_ = type;
+    flight_start_ns_ = PosixInNsec();
+  }
   if (UNLIKELY(HostTraceLevel::GetInstance().NeedTrace(level) == false)) {
     return;
   }
@@ -128,6 +154,7 @@ RecordEvent::RecordEvent(const char *name,
   role_ = role;
   type_ = type;
   start_ns_ = PosixInNsec();
+  read_perf_counters_ = ReadStartPerfCounters(type, &perf_counters_start_);
 }
 
 RecordEvent::RecordEvent(const std::string &name,
@@ -142,6 +169,11 @@ RecordEvent::RecordEvent(const std::string &name,
   }
 #endif
 #endif
+  if (UNLIKELY(FlightRecorder::IsEnabled(level))) {
+    flight_name_ = FlightRecorder::GetInstance().InternName(name);
+    type_ = type;
+    flight_start_ns_ = PosixInNsec();
+  }
   if (UNLIKELY(HostTraceLevel::GetInstance().NeedTrace(level) == false)) {
     return;
   }
@@ -160,6 +192,7 @@ RecordEvent::RecordEvent(const std::string &name,
   role_ = role;
   type_ = type;
   start_ns_ = PosixInNsec();
+  read_perf_counters_ = ReadStartPerfCounters(type, &perf_counters_start_);
 }
 
 RecordEvent::RecordEvent(const std::string &name,
@@ -176,6 +209,11 @@ RecordEvent::RecordEvent(const std::string &name,
 #endif
 #endif
 
+  if (UNLIKELY(FlightRecorder::IsEnabled(level))) {
+    flight_name_ = FlightRecorder::GetInstance().InternName(name);
+    type_ = type;
+    flight_start_ns_ = PosixInNsec();
+  }
   if (UNLIKELY(HostTraceLevel::GetInstance().NeedTrace(level) == false)) {
     return;
   }
@@ -194,6 +232,7 @@ RecordEvent::RecordEvent(const std::string &name,
   name_ = new std::string(name);
   start_ns_ = PosixInNsec();
   attr_ = new std::string(attr);
+  read_perf_counters_ = ReadStartPerfCounters(type, &perf_counters_start_);
 }
 
 void RecordEvent::OriginalConstruct(const std::string &name,
@@ -224,8 +263,24 @@ void RecordEvent::End() {
   }
 #endif
 #endif
+  if (UNLIKELY(flight_name_ != nullptr)) {
+    FlightRecorder::GetInstance().RecordEvent(
+        flight_name_, flight_start_ns_, PosixInNsec(), type_);
+    flight_name_ = nullptr;
+  }
   if (LIKELY(FLAGS_enable_host_event_recorder_hook && is_enabled_)) {
+    PerfCounterValues perf_counters_end;
+    if (UNLIKELY(read_perf_counters_)) {
+      PerfCounterReader::Read(&perf_counters_end);
+    }
     uint64_t end_ns = PosixInNsec();
+    if (UNLIKELY(read_perf_counters_)) {
+      HostEventRecorder<PerfCounterEvent>::GetInstance().RecordEvent(
+          start_ns_,
+          end_ns,
+          PerfCounterReader::Diff(perf_counters_start_, perf_counters_end));
+      read_perf_counters_ = false;
+    }
     if (LIKELY(shallow_copy_name_ != nullptr)) {
       HostEventRecorder<CommonEvent>::GetInstance().RecordEvent(
           shallow_copy_name_, start_ns_, end_ns, role_, type_);
@@ -267,6 +322,7 @@ void RecordEvent::End() {
 
 bool RecordEvent::IsEnabled() {
   return FLAGS_enable_host_event_recorder_hook ||
+         FLAGS_enable_flight_recorder ||
          ProfilerHelper::g_enable_nvprof_hook ||
          ProfilerHelper::g_state != ProfilerState::kDisabled;
 }
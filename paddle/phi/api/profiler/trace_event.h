@@ -148,6 +148,30 @@ struct MemsetEventInfo {
   uint32_t value;
 };
 
+// CPU performance counters of the thread running a host event, accumulated
+// from its start to its end. See PerfCounterReader.
+struct PerfCounterValues {
+  // Size of a cache line, used to estimate the memory traffic.
+  static constexpr uint64_t kCacheLineBytes = 64;
+
+  // Whether the counters were collected for the event.
+  bool valid = false;
+  // Whether the hardware counters (cycles, instructions and cache) were
+  // available. Otherwise only the software counters are set.
+  bool hardware = false;
+  uint64_t cycles = 0;
+  uint64_t instructions = 0;
+  // Last level cache references and misses.
+  uint64_t cache_references = 0;
+  uint64_t cache_misses = 0;
+  // Time the thread was running on a CPU.
+  uint64_t task_clock_ns = 0;
+  uint64_t page_faults = 0;
+
+  // Estimated bytes moved between the last level cache and the memory.
+  uint64_t BytesMoved() const { return cache_misses * kCacheLineBytes; }
+};
+
 struct HostTraceEvent {
   HostTraceEvent() = default;
   HostTraceEvent(const std::string& name,
@@ -174,6 +198,9 @@ struct HostTraceEvent {
   uint64_t process_id;
   // thread id of the record
   uint64_t thread_id;
+  // performance counters of the record, only collected for operators when
+  // FLAGS_enable_host_perf_counters is set
+  PerfCounterValues perf_counters;
 };
 
 struct RuntimeTraceEvent {
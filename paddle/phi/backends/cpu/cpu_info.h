@@ -88,6 +88,7 @@ typedef enum {
   avx512_mic,
   avx512_mic_4ops,
   avx512_bf16,
+  fma,
 } cpu_isa_t;  // Instruction set architecture
 
 // May I use some instruction
@@ -14,6 +14,10 @@
 #ifdef PADDLE_WITH_DNNL
 #include "paddle/phi/backends/onednn/onednn_context.h"
 
+#include <algorithm>
+#include <deque>
+
+#include "paddle/common/flags.h"
 #include "paddle/phi/common/place.h"
 #include "paddle/phi/core/enforce.h"
 #include "paddle/utils/flat_hash_map.h"
@@ -23,12 +27,31 @@
 
 #include "glog/logging.h"
 
+PHI_DEFINE_EXPORTED_int64(
+    onednn_primitive_cache_capacity,
+    16384,
+    "The max number of oneDNN objects kept in the hashed primitive cache of "
+    "OneDNNContext for the non-default sessions. The least recently used "
+    "handlers are dropped when it is full. 0 means unbounded. The default "
+    "session is never bounded. It is read when the context is created.");
+
 namespace phi {
 
+namespace {
+
+uint64_t HashShapeStr(const std::string& shape_str) {
+  OneDNNKeyHasher hasher;
+  hasher.Add(shape_str);
+  return hasher.Key().lo;
+}
+
+}  // namespace
+
 OneDNNContextThreadLocals::Body::Body()
     : cur_engine(dnnl::engine::kind::cpu, 0), cur_stream(cur_engine) {
   cur_mkldnn_session_id = kMKLDNNSessionID_Default;
   cur_input_shape_str = "";
+  cur_input_shape_hash = HashShapeStr(cur_input_shape_str);
   cur_input_shape_cache_capacity = 1;
   cur_paddle_data_layout = DataLayout::kNCHW;
 }
@@ -58,7 +81,8 @@ size_t OneDNNContextThreadLocals::Body::get_cur_mkldnn_session_id() {
 
 void OneDNNContextThreadLocals::Body::set_cur_input_shape_str(
     std::string input_shape_str) {
-  cur_input_shape_str = input_shape_str;
+  cur_input_shape_hash = HashShapeStr(input_shape_str);
+  cur_input_shape_str = std::move(input_shape_str);
 }
 void OneDNNContextThreadLocals::Body::set_cur_input_shape_cache_capacity(
     int input_shape_cache_capacity) {
@@ -89,7 +113,11 @@ OneDNNContextThreadLocals::Body& OneDNNContextThreadLocals::fetch() {
 }
 
 struct OneDNNContext::Impl {
-  Impl() : p_blobmap_() {
+  Impl()
+      : p_blobmap_(),
+        default_primitive_cache_(0),
+        primitive_cache_(static_cast<size_t>(
+            std::max<int64_t>(FLAGS_onednn_primitive_cache_capacity, 0))) {
     p_blobmap_.reset(new BlobMap());
     p_exec_items_.reset(new ExecShape());
     p_mutex_.reset(new std::mutex());
@@ -107,7 +135,12 @@ struct OneDNNContext::Impl {
       // objects allocated when using given executor
       if (ptr == nullptr) {
         p_blobmap_->clear();
+        default_primitive_cache_.Clear();
+        primitive_cache_.Clear();
+        clearing_shapes_.clear();
       } else {
+        default_primitive_cache_.EraseOwner(ptr);
+        primitive_cache_.EraseOwner(ptr);
         // Iterate through all shapes and release
         // for each shape and active executor all entries
         // of this executor
@@ -170,14 +203,22 @@ struct OneDNNContext::Impl {
   size_t GetShapeBlobSize() const {
     std::lock_guard<decltype(*p_mutex_)> lock(*p_mutex_);
     BlobMap* pMap = p_blobmap_.get();
-    auto map_it =
-        pMap->find(OneDNNContext::tls().cur_mkldnn_session_id);  // NOLINT
+    size_t sid = OneDNNContext::tls().cur_mkldnn_session_id;
+    // Shapes of the hashed cache are only tracked in cache clearing mode
+    size_t hashed_shapes =
+        sid == OneDNNContextThreadLocals::kMKLDNNSessionID_CacheClearing
+            ? clearing_shapes_.size()
+            : 0;
+    auto map_it = pMap->find(sid);  // NOLINT
     if (map_it == pMap->end()) {
+      if (hashed_shapes > 0) {
+        return hashed_shapes;
+      }
       PADDLE_THROW(common::errors::NotFound(
           "OneDNNContext don't find cur_mkldnn_session_id: %d.",
           OneDNNContext::tls().cur_mkldnn_session_id));
     }
-    return map_it->second->size();
+    return std::max(map_it->second->size(), hashed_shapes);
   }
 
   void SetBlob(const std::string& name, BlobPtr_t<void> data) const {
@@ -240,8 +281,52 @@ struct OneDNNContext::Impl {
     return;
   }
 
+  void SetBlob(const OneDNNCacheKey& key, BlobPtr_t<void> data) {
+    auto& tls = OneDNNContext::tls();
+    size_t sid = tls.get_cur_mkldnn_session_id();
+    uint64_t shape = tls.cur_input_shape_hash;
+    if (sid == OneDNNContextThreadLocals::kMKLDNNSessionID_CacheClearing) {
+      // In cache clearing mode, cur_input_shape_cache_capacity defines
+      // max number of input shapes kept, the oldest shape is dropped first
+      std::lock_guard<decltype(*p_mutex_)> lock(*p_mutex_);
+      if (std::find(clearing_shapes_.begin(), clearing_shapes_.end(), shape) ==
+          clearing_shapes_.end()) {
+        if (!clearing_shapes_.empty() &&
+            clearing_shapes_.size() >=
+                static_cast<size_t>(tls.cur_input_shape_cache_capacity)) {
+          VLOG(2) << "sid=" << sid << ", remove hashed blobs of shape hash "
+                  << clearing_shapes_.front();
+          primitive_cache_.EraseShape(sid, clearing_shapes_.front());
+          clearing_shapes_.pop_front();
+        }
+        clearing_shapes_.push_back(shape);
+      }
+    }
+    PrimitiveCacheOf(sid).Set(
+        key, sid, shape, std::move(data), tls.get_curr_exec());
+  }
+
+  OneDNNPrimitiveCache& PrimitiveCacheOf(size_t sid) {
+    return sid == OneDNNContextThreadLocals::kMKLDNNSessionID_Default
+               ? default_primitive_cache_
+               : primitive_cache_;
+  }
+
+  const OneDNNPrimitiveCache& PrimitiveCacheOf(size_t sid) const {
+    return sid == OneDNNContextThreadLocals::kMKLDNNSessionID_Default
+               ? default_primitive_cache_
+               : primitive_cache_;
+  }
+
+  BlobPtr_t<void> GetBlob(const OneDNNCacheKey& key) const {
+    auto& tls = OneDNNContext::tls();
+    size_t sid = tls.get_cur_mkldnn_session_id();
+    return PrimitiveCacheOf(sid).Get(key, sid, tls.cur_input_shape_hash);
+  }
+
   unsigned int GetCachedObjectsNumber() const {
-    unsigned int num_entries = 0;
+    unsigned int num_entries =
+        default_primitive_cache_.Size() + primitive_cache_.Size();
     for (auto const& l3 : *p_blobmap_) {
       for (auto const& l2 : *(l3.second)) {
         num_entries += (l2.second)->size();
@@ -365,6 +450,17 @@ struct OneDNNContext::Impl {
   // 0 - clearing is allowed. x > 0 do not clear.
   unsigned int block_next_cache_clearing_ = 0;
 
+  // The hashed cache of the default session, which is unbounded like the
+  // string keyed cache has always been.
+  OneDNNPrimitiveCache default_primitive_cache_;
+  // Objects cached by hashed keys in the other sessions, bounded by
+  // FLAGS_onednn_primitive_cache_capacity. The caches have their own per
+  // shard locks.
+  OneDNNPrimitiveCache primitive_cache_;
+  // Hashes of the input shapes in the hashed cache for the cache clearing
+  // session, oldest first. Guarded by p_mutex_.
+  std::deque<uint64_t> clearing_shapes_;
+
   // Holds some attributes only used by the onednn kernel calculation
   // Since original onednn op kernel directly adds the operations that require
   // fusion to the native kernel operations, and uses the attribute `fuse_xxx`
@@ -422,6 +518,28 @@ OneDNNContext::BlobPtr_t<void> OneDNNContext::GetBlob(
   return impl_->GetBlob(name);
 }
 
+void OneDNNContext::SetBlob(const OneDNNCacheKey& key,
+                            BlobPtr_t<void> data) const {
+  impl_->SetBlob(key, std::move(data));
+}
+
+OneDNNContext::BlobPtr_t<void> OneDNNContext::GetBlob(
+    const OneDNNCacheKey& key) const {
+  return impl_->GetBlob(key);
+}
+
+std::map<std::string, OneDNNCacheStats> OneDNNContext::GetPrimitiveCacheStats()
+    const {
+  auto stats = impl_->default_primitive_cache_.Stats();
+  for (const auto& item : impl_->primitive_cache_.Stats()) {
+    auto& merged = stats[item.first];
+    merged.hits += item.second.hits;
+    merged.misses += item.second.misses;
+    merged.evictions += item.second.evictions;
+  }
+  return stats;
+}
+
 bool OneDNNContext::HasDnnAttr(const std::string& attr_name) const {
   return impl_->HasDnnAttr(attr_name);
 }
@@ -19,6 +19,7 @@ limitations under the License. */
 #include "dnnl.hpp"  // NOLINT
 #include "paddle/common/layout.h"
 #include "paddle/phi/backends/cpu/cpu_context.h"
+#include "paddle/phi/backends/onednn/onednn_primitive_cache.h"
 #include "paddle/phi/common/place.h"
 #include "paddle/phi/core/attribute.h"
 #include "paddle/utils/test_macros.h"
@@ -38,6 +39,8 @@ class OneDNNContextThreadLocals {
     // - For fixed-shape, it's a null string in default.
     // - For dynamic-shape, it's user specific.
     std::string cur_input_shape_str;
+    // Hash of cur_input_shape_str, used by the hashed primitive cache.
+    uint64_t cur_input_shape_hash;
     // the cache capacity of different input shapes for OneDNN.
     // Default 1 means fixed input shape, not dynamic shape.
     int cur_input_shape_cache_capacity;
@@ -131,6 +134,16 @@ class OneDNNContext : public CPUContext {
   // Find a saved blob. Return nullptr if not found
   std::shared_ptr<void> GetBlob(const std::string& name) const;
 
+  // Hashed key variants of SetBlob/GetBlob. The blobs are kept in a sharded
+  // LRU cache which counts hits and misses per key tag. It is bounded by
+  // FLAGS_onednn_primitive_cache_capacity except in the default session.
+  void SetBlob(const OneDNNCacheKey& key, std::shared_ptr<void> data) const;
+  std::shared_ptr<void> GetBlob(const OneDNNCacheKey& key) const;
+
+  // Hit/miss/eviction counters of the hashed cache grouped by key tag.
+  TEST_API std::map<std::string, OneDNNCacheStats> GetPrimitiveCacheStats()
+      const;
+
   static auto tls() -> decltype(OneDNNContextThreadLocals::fetch()) {
     return OneDNNContextThreadLocals::fetch();
   }
@@ -14,7 +14,9 @@
 
 #pragma once
 
+#include <cstring>
 #include <thread>
+#include <type_traits>
 #include "dnnl.hpp"  // NOLINT
 #include "glog/logging.h"
 
@@ -227,6 +229,62 @@ inline std::string CreateKey(const OneDNNContext& dev_ctx UNUSED,
   return key;
 }
 
+// HashKey mirrors AppendKey for the hashed OneDNNCacheKey, fields are mixed
+// into the hasher as raw values instead of being printed into a string.
+template <typename T>
+inline void HashKey(OneDNNKeyHasher* hasher, const T& value) {
+  static_assert(std::is_arithmetic<T>::value || std::is_enum<T>::value,
+                "HashKey only supports arithmetic and enum values, strings, "
+                "vectors and oneDNN memory descriptors.");
+  if constexpr (std::is_floating_point<T>::value) {
+    double d = static_cast<double>(value);
+    uint64_t bits;
+    std::memcpy(&bits, &d, sizeof(bits));
+    hasher->Add(bits);
+  } else {
+    hasher->Add(static_cast<uint64_t>(value));
+  }
+}
+
+inline void HashKey(OneDNNKeyHasher* hasher, const std::string& str) {
+  hasher->Add(str);
+}
+
+inline void HashKey(OneDNNKeyHasher* hasher, const char* str) {
+  hasher->Add(str);
+}
+
+template <typename T>
+inline void HashKey(OneDNNKeyHasher* hasher, const std::vector<T>& values) {
+  for (const auto& value : values) {
+    HashKey(hasher, value);
+  }
+  hasher->Add(static_cast<uint64_t>(values.size()));
+}
+
+inline void HashKey(OneDNNKeyHasher* hasher, const dnnl::memory::desc& md) {
+  HashKey(hasher, md.get_dims());
+  HashKey(hasher, md.get_data_type());
+  HashKey(hasher, md.get_format_kind());
+  HashKey(hasher, md.get_inner_blks());
+  HashKey(hasher, md.get_inner_idxs());
+  HashKey(hasher, md.get_inner_nblks());
+  HashKey(hasher, md.get_padded_dims());
+  HashKey(hasher, md.get_strides());
+}
+
+// Hashed counterpart of CreateKey. `tag` names the kernel for the counters
+// of the primitive cache and must be a string literal.
+template <typename... ArgTypes>
+inline OneDNNCacheKey CreateHashedKey(const OneDNNContext& dev_ctx UNUSED,
+                                      const char* tag,
+                                      ArgTypes&&... args) {
+  OneDNNKeyHasher hasher(tag);
+  ((void)HashKey(&hasher, std::forward<ArgTypes>(args)), ...);
+  hasher.Add(OneDNNContext::tls().get_key_suffix());
+  return hasher.Key();
+}
+
 // The function adjusts the vector of weight dimensions for group convolutions
 inline void GetGroupConvWeightsTz(std::vector<int64_t>& weights_tz,  // NOLINT
                                   const int groups) {
@@ -316,6 +374,18 @@ inline std::string ExtendKeyWithThreadInfoIfNeeded(
              : key;
 }
 
+inline OneDNNCacheKey ExtendKeyWithThreadInfoIfNeeded(
+    const OneDNNContext& dev_ctx UNUSED, const OneDNNCacheKey& key) {
+  if (OneDNNContext::tls().is_tid_used_in_key() == false) {
+    return key;
+  }
+  OneDNNKeyHasher hasher(key.tag);
+  hasher.Add(key.hi);
+  hasher.Add(key.lo);
+  hasher.Add(std::hash<std::thread::id>()(std::this_thread::get_id()));
+  return hasher.Key();
+}
+
 enum class RNNReorderType { PP_NTC, PP_TNC, NTC_PP, TNC_PP };
 
 }  // namespace funcs
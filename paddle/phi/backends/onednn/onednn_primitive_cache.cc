@@ -0,0 +1,208 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/phi/backends/onednn/onednn_primitive_cache.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <ostream>
+
+#include "glog/logging.h"
+
+#include "paddle/common/enforce.h"
+
+namespace phi {
+
+OneDNNCacheKey OneDNNCacheKey::Derive(const char* suffix) const {
+  OneDNNKeyHasher hasher(tag);
+  hasher.Add(hi);
+  hasher.Add(lo);
+  hasher.Add(suffix);
+  OneDNNCacheKey derived = hasher.Key();
+  derived.group = Group();
+  return derived;
+}
+
+std::ostream& operator<<(std::ostream& os, const OneDNNCacheKey& key) {
+  const auto flags = os.flags();
+  const auto fill = os.fill('0');
+  os << key.tag << "#" << std::hex << std::setw(16) << key.hi
+     << std::setw(16) << key.lo;
+  os.fill(fill);
+  os.flags(flags);
+  return os;
+}
+
+void OneDNNKeyHasher::Add(const char* data, size_t size) {
+  size_t i = 0;
+  for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+    uint64_t word;
+    std::memcpy(&word, data + i, sizeof(word));
+    Add(word);
+  }
+  if (i < size) {
+    uint64_t word = 0;
+    std::memcpy(&word, data + i, size - i);
+    Add(word);
+  }
+  Add(static_cast<uint64_t>(size));
+}
+
+OneDNNPrimitiveCache::OneDNNPrimitiveCache(size_t capacity, size_t num_shards)
+    : capacity_(capacity) {
+  PADDLE_ENFORCE_GT(num_shards,
+                    0,
+                    common::errors::InvalidArgument(
+                        "The number of shards of OneDNNPrimitiveCache should "
+                        "be greater than 0, but received %d.",
+                        num_shards));
+  // A tiny cache is kept in one shard, otherwise every shard would round its
+  // share up and the cache would hold far more entries than asked for.
+  if (capacity > 0 && capacity < num_shards * 4) {
+    num_shards = 1;
+  }
+  shard_capacity_ =
+      capacity == 0 ? 0 : (capacity + num_shards - 1) / num_shards;
+  shards_.reserve(num_shards);
+  for (size_t i = 0; i < num_shards; ++i) {
+    shards_.emplace_back(std::make_unique<Shard>());
+  }
+}
+
+std::shared_ptr<void> OneDNNPrimitiveCache::Get(const OneDNNCacheKey& key,
+                                                uint64_t session,
+                                                uint64_t shape) const {
+  GroupKey group_key{key.Group(), session, shape};
+  Shard& shard = ShardOf(group_key);
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  auto it = shard.index.find(group_key);
+  if (it != shard.index.end()) {
+    for (const Entry& entry : it->second->entries) {
+      if (entry.hi == key.hi && entry.lo == key.lo) {
+        ++shard.stats[key.tag].hits;
+        // Move the group to the front of the LRU list.
+        shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+        return entry.data;
+      }
+    }
+  }
+  ++shard.stats[key.tag].misses;
+  return nullptr;
+}
+
+void OneDNNPrimitiveCache::Set(const OneDNNCacheKey& key,
+                               uint64_t session,
+                               uint64_t shape,
+                               std::shared_ptr<void> data,
+                               void* owner) {
+  GroupKey group_key{key.Group(), session, shape};
+  Shard& shard = ShardOf(group_key);
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  auto it = shard.index.find(group_key);
+  if (it == shard.index.end()) {
+    shard.lru.push_front(Group{group_key, {}});
+    it = shard.index.emplace(group_key, shard.lru.begin()).first;
+  } else {
+    shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+  }
+  auto& entries = it->second->entries;
+  auto entry = std::find_if(
+      entries.begin(), entries.end(), [&key](const Entry& entry) {
+        return entry.hi == key.hi && entry.lo == key.lo;
+      });
+  if (entry != entries.end()) {
+    entry->data = std::move(data);
+    return;
+  }
+  entries.push_back(Entry{key.hi, key.lo, key.tag, owner, std::move(data)});
+  ++shard.size;
+  // The group just used is at the front, so it is never the victim.
+  while (shard_capacity_ > 0 && shard.size > shard_capacity_ &&
+         shard.lru.size() > 1) {
+    const Group& victim = shard.lru.back();
+    VLOG(3) << "OneDNNPrimitiveCache is full, evict a group of "
+            << victim.entries.size() << " entries";
+    for (const Entry& evicted : victim.entries) {
+      ++shard.stats[evicted.tag].evictions;
+    }
+    shard.size -= victim.entries.size();
+    shard.index.erase(victim.key);
+    shard.lru.pop_back();
+  }
+}
+
+template <typename Pred>
+void OneDNNPrimitiveCache::EraseIf(Pred pred) {
+  for (auto& shard : shards_) {
+    std::lock_guard<std::mutex> lock(shard->mutex);
+    for (auto it = shard->lru.begin(); it != shard->lru.end();) {
+      if (pred(*it)) {
+        shard->size -= it->entries.size();
+        shard->index.erase(it->key);
+        it = shard->lru.erase(it);
+      } else {
+        ++it;
+      }
+    }
+  }
+}
+
+void OneDNNPrimitiveCache::EraseOwner(void* owner) {
+  EraseIf([owner](const Group& group) {
+    return std::any_of(
+        group.entries.begin(),
+        group.entries.end(),
+        [owner](const Entry& entry) { return entry.owner == owner; });
+  });
+}
+
+void OneDNNPrimitiveCache::EraseShape(uint64_t session, uint64_t shape) {
+  EraseIf([session, shape](const Group& group) {
+    return group.key.session == session && group.key.shape == shape;
+  });
+}
+
+void OneDNNPrimitiveCache::Clear() {
+  for (auto& shard : shards_) {
+    std::lock_guard<std::mutex> lock(shard->mutex);
+    shard->index.clear();
+    shard->lru.clear();
+    shard->size = 0;
+  }
+}
+
+size_t OneDNNPrimitiveCache::Size() const {
+  size_t size = 0;
+  for (auto& shard : shards_) {
+    std::lock_guard<std::mutex> lock(shard->mutex);
+    size += shard->size;
+  }
+  return size;
+}
+
+std::map<std::string, OneDNNCacheStats> OneDNNPrimitiveCache::Stats() const {
+  std::map<std::string, OneDNNCacheStats> result;
+  for (auto& shard : shards_) {
+    std::lock_guard<std::mutex> lock(shard->mutex);
+    for (auto& item : shard->stats) {
+      auto& stats = result[common::demangle(item.first)];
+      stats.hits += item.second.hits;
+      stats.misses += item.second.misses;
+      stats.evictions += item.second.evictions;
+    }
+  }
+  return result;
+}
+
+}  // namespace phi
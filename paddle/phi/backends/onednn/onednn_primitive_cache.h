@@ -0,0 +1,213 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <iosfwd>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "paddle/utils/test_macros.h"
+
+namespace phi {
+
+// 128-bit hashed key of a cached oneDNN object. It replaces the string keys
+// built by funcs::CreateKey on hot paths: hashing the key fields costs a few
+// multiplications per field instead of one std::to_string and one append.
+// `tag` names the kernel owning the object and is only used to group the
+// hit/miss counters, so it must have static storage duration.
+struct OneDNNCacheKey {
+  uint64_t hi = 0;
+  uint64_t lo = 0;
+  const char* tag = "";
+  // lo of the key this one is derived from, 0 if it is not derived. The
+  // objects of a handler are used together, e.g. a reorder with its memories,
+  // so the cache keeps or evicts all the keys of a group at once.
+  uint64_t group = 0;
+
+  // Key of an object derived from this one, e.g. "@fwd_p" of a handler. It
+  // belongs to the group of this key.
+  TEST_API OneDNNCacheKey Derive(const char* suffix) const;
+
+  uint64_t Group() const { return group != 0 ? group : lo; }
+
+  bool operator==(const OneDNNCacheKey& other) const {
+    return hi == other.hi && lo == other.lo;
+  }
+  bool operator!=(const OneDNNCacheKey& other) const {
+    return !(*this == other);
+  }
+};
+
+// Prints the tag and the hash of the key, for error and log messages.
+TEST_API std::ostream& operator<<(std::ostream& os, const OneDNNCacheKey& key);
+
+// Incrementally hashes the fields of a key into two independently seeded
+// 64-bit lanes. Variable length fields mix in their length as well, so
+// ("ab", "c") and ("a", "bc") hash differently.
+class OneDNNKeyHasher {
+ public:
+  explicit OneDNNKeyHasher(const char* tag = "") { key_.tag = tag; }
+
+  void Add(uint64_t value) {
+    key_.lo = Mix(key_.lo ^ (value * kMulLo));
+    key_.hi = Mix((key_.hi + value) * kMulHi + kAddHi);
+  }
+
+  TEST_API void Add(const char* data, size_t size);
+
+  void Add(const std::string& str) { Add(str.data(), str.size()); }
+
+  void Add(const char* str) { Add(str, std::strlen(str)); }
+
+  template <typename T>
+  void Add(const std::vector<T>& values) {
+    for (const auto& v : values) {
+      Add(static_cast<uint64_t>(v));
+    }
+    Add(static_cast<uint64_t>(values.size()));
+  }
+
+  const OneDNNCacheKey& Key() const { return key_; }
+
+ private:
+  static constexpr uint64_t kMulLo = 0x9e3779b97f4a7c15ULL;
+  static constexpr uint64_t kMulHi = 0xc2b2ae3d27d4eb4fULL;
+  static constexpr uint64_t kAddHi = 0x165667b19e3779f9ULL;
+
+  // Finalizer of MurmurHash3, every input bit affects every output bit.
+  static uint64_t Mix(uint64_t x) {
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53ULL;
+    x ^= x >> 33;
+    return x;
+  }
+
+  OneDNNCacheKey key_{0x243f6a8885a308d3ULL, 0x13198a2e03707344ULL, ""};
+};
+
+struct OneDNNCacheStats {
+  uint64_t hits = 0;
+  uint64_t misses = 0;
+  uint64_t evictions = 0;
+};
+
+// Sharded, bounded LRU cache of oneDNN primitives, primitive descriptors
+// and memories. Besides the key, an entry is addressed by the oneDNN session
+// id and the hash of the current input shape string, mirroring the
+// BlobMap/ShapeBlob levels of the string keyed cache. Every shard has its own
+// lock, so kernels running on different threads rarely contend. The entries
+// of a key group are kept in one shard and used, evicted and erased together,
+// since the handlers expect all of them once one is found. When a shard is
+// full, its least recently used group is dropped.
+class OneDNNPrimitiveCache {
+ public:
+  // `capacity` is the max number of entries of the whole cache, 0 means
+  // unbounded. A single group larger than a shard is kept anyway.
+  TEST_API explicit OneDNNPrimitiveCache(size_t capacity,
+                                         size_t num_shards = 16);
+
+  TEST_API std::shared_ptr<void> Get(const OneDNNCacheKey& key,
+                                     uint64_t session,
+                                     uint64_t shape) const;
+
+  // `owner` is the executor the entry was created by, see EraseOwner.
+  TEST_API void Set(const OneDNNCacheKey& key,
+                    uint64_t session,
+                    uint64_t shape,
+                    std::shared_ptr<void> data,
+                    void* owner);
+
+  // Drop the groups with an entry created by the given executor.
+  TEST_API void EraseOwner(void* owner);
+
+  // Drop all entries of one input shape of a session.
+  TEST_API void EraseShape(uint64_t session, uint64_t shape);
+
+  TEST_API void Clear();
+
+  TEST_API size_t Size() const;
+
+  size_t Capacity() const { return capacity_; }
+
+  // Counters grouped by the (demangled) tag of the keys.
+  TEST_API std::map<std::string, OneDNNCacheStats> Stats() const;
+
+ private:
+  struct GroupKey {
+    uint64_t group;
+    uint64_t session;
+    uint64_t shape;
+
+    bool operator==(const GroupKey& other) const {
+      return group == other.group && session == other.session &&
+             shape == other.shape;
+    }
+  };
+
+  struct GroupKeyHash {
+    size_t operator()(const GroupKey& key) const {
+      return static_cast<size_t>(key.group ^
+                                 (key.shape * 0x9e3779b97f4a7c15ULL) ^
+                                 key.session);
+    }
+  };
+
+  struct Entry {
+    uint64_t hi;
+    uint64_t lo;
+    const char* tag;
+    void* owner;
+    std::shared_ptr<void> data;
+  };
+
+  // A handler caches a few objects, so they are searched linearly.
+  struct Group {
+    GroupKey key;
+    std::vector<Entry> entries;
+  };
+
+  struct Shard {
+    mutable std::mutex mutex;
+    // Most recently used groups are at the front.
+    mutable std::list<Group> lru;
+    std::unordered_map<GroupKey, std::list<Group>::iterator, GroupKeyHash>
+        index;
+    // Number of entries of all the groups.
+    size_t size = 0;
+    mutable std::unordered_map<const char*, OneDNNCacheStats> stats;
+  };
+
+  Shard& ShardOf(const GroupKey& key) const {
+    return *shards_[(key.group >> 7) % shards_.size()];
+  }
+
+  template <typename Pred>
+  void EraseIf(Pred pred);
+
+  size_t capacity_;
+  size_t shard_capacity_;
+  std::vector<std::unique_ptr<Shard>> shards_;
+};
+
+}  // namespace phi
@@ -145,19 +145,18 @@ class OneDNNHandlerT {
   OneDNNHandlerT(const OneDNNContext& dev_ctx,
                  dnnl::engine engine,
                  Place cpu_place,
-                 const std::string& base_key)
+                 const OneDNNCacheKey& base_key)
       : dev_ctx_(dev_ctx),
         engine_(engine),
         place_(cpu_place),
-        key_common_(base_key),
-        key_(ExtendKeyWithThreadInfoIfNeeded(dev_ctx, base_key)),
+        hkey_(ExtendKeyWithThreadInfoIfNeeded(dev_ctx, base_key)),
         fwd_pd_(nullptr),
         bwd_pd_(nullptr) {
     OneDNNContext::tls().log_lib_version();
   }
 
   std::shared_ptr<TForward> AcquireForwardPrimitive() {
-    const std::string key_p = key_ + "@fwd_p";
+    const auto key_p = hkey_.Derive("@fwd_p");
     auto forward_p =
         std::static_pointer_cast<TForward>(dev_ctx_.GetBlob(key_p));
     if (forward_p == nullptr) {
@@ -168,7 +167,7 @@ class OneDNNHandlerT {
   }
 
   std::shared_ptr<TBackward> AcquireBackwardPrimitive() {
-    const std::string key_p = key_ + "@bwd_p";
+    const auto key_p = hkey_.Derive("@bwd_p");
     auto backward_p =
         std::static_pointer_cast<TBackward>(dev_ctx_.GetBlob(key_p));
     if (backward_p == nullptr) {
@@ -179,14 +178,14 @@ class OneDNNHandlerT {
   }
 
   std::shared_ptr<TBackward_params> AcquireBackwardWeightsPrimitive() {
-    const std::string key_p = key_ + "@bwd_w_p";
+    const auto key_p = hkey_.Derive("@bwd_w_p");
     auto backward_p =
         std::static_pointer_cast<TBackward_params>(dev_ctx_.GetBlob(key_p));
     if (backward_p == nullptr) {
       PADDLE_ENFORCE_NOT_NULL(
           bwd_w_pd_,
           errors::Unavailable("BWD_PD should be set when "
-                              "getting BWD prim witk key: %s .",
+                              "getting BWD prim with key: %s .",
                               key_p));
       backward_p = std::make_shared<TBackward_params>(*bwd_w_pd_);
       dev_ctx_.SetBlob(key_p, backward_p);
@@ -260,7 +259,7 @@ class OneDNNHandlerT {
 
  protected:
   bool isCached() {
-    const std::string key_pd = key_ + "@fwd_pd";
+    const auto key_pd = hkey_.Derive("@fwd_pd");
     fwd_pd_ = std::static_pointer_cast<typename TForward::primitive_desc>(
         dev_ctx_.GetBlob(key_pd));
 
@@ -268,7 +267,7 @@ class OneDNNHandlerT {
   }
 
   bool isBwdCached() {
-    const std::string key_pd = key_ + "@bwd_pd";
+    const auto key_pd = hkey_.Derive("@bwd_pd");
     bwd_pd_ = std::static_pointer_cast<typename TBackward::primitive_desc>(
         dev_ctx_.GetBlob(key_pd));
 
@@ -277,14 +276,14 @@ class OneDNNHandlerT {
     } else {
       if (std::is_same<TBackward_params, onednn_dummy_primitive>::value ==
           false) {
-        const std::string key_bw_w_pd = key_ + "@bwd_w_pd";
+        const auto key_bw_w_pd = hkey_.Derive("@bwd_w_pd");
         bwd_w_pd_ =
             std::static_pointer_cast<typename TBackward_params::primitive_desc>(
                 dev_ctx_.GetBlob(key_bw_w_pd));
       }
 
       // When BWD is cached then still we need to Get FWD PD
-      const std::string key_fpd = key_ + "@fwd_pd";
+      const auto key_fpd = hkey_.Derive("@fwd_pd");
       fwd_pd_ = std::static_pointer_cast<typename TForward::primitive_desc>(
           dev_ctx_.GetBlob(key_fpd));
       PADDLE_ENFORCE_NOT_NULL(
@@ -303,7 +302,7 @@ class OneDNNHandlerT {
   void AcquireForwardPrimitiveDescriptor(Arg&& first_arg, Args&&... args) {
     // This is used when we can recreate FWD PD in BWD so
     // we do not need to pass FWD to BWD
-    const std::string key_pd = key_ + "@fwd_pd";
+    const auto key_pd = hkey_.Derive("@fwd_pd");
     fwd_pd_ = std::static_pointer_cast<typename TForward::primitive_desc>(
         dev_ctx_.GetBlob(key_pd));
     if (fwd_pd_ == nullptr) {
@@ -337,8 +336,8 @@ class OneDNNHandlerT {
     PADDLE_ENFORCE_NOT_NULL(
         fwd_pd_,
         errors::Unavailable("Get OneDNN Forward primitive %s failed.",
-                            key_ + "@fwd_pd"));
-    const std::string key_pd = key_ + "@bwd_pd";
+                            hkey_.Derive("@fwd_pd")));
+    const auto key_pd = hkey_.Derive("@bwd_pd");
     bwd_pd_ = std::static_pointer_cast<typename TBackward::primitive_desc>(
         dev_ctx_.GetBlob(key_pd));
     if (bwd_pd_ == nullptr) {
@@ -355,8 +354,8 @@ class OneDNNHandlerT {
     PADDLE_ENFORCE_NOT_NULL(
         fwd_pd_,
         errors::Unavailable("Get OneDNN Forward primitive %s failed.",
-                            key_ + "@fwd_pd"));
-    const std::string key_pd = key_ + "@bwd_w_pd";
+                            hkey_.Derive("@fwd_pd")));
+    const auto key_pd = hkey_.Derive("@bwd_w_pd");
     bwd_w_pd_ =
         std::static_pointer_cast<typename TBackward_params::primitive_desc>(
             dev_ctx_.GetBlob(key_pd));
@@ -370,12 +369,12 @@ class OneDNNHandlerT {
   std::shared_ptr<dnnl::memory> AcquireMemoryFromPrimitive(
       const std::string& suffix) {
     return std::static_pointer_cast<dnnl::memory>(
-        dev_ctx_.GetBlob(key_ + suffix));
+        dev_ctx_.GetBlob(hkey_.Derive(suffix.c_str())));
   }
 
   std::shared_ptr<dnnl::memory> AcquireMemoryFromPrimitive(
       dnnl::memory::desc md, void* ptr, const std::string& suffix) {
-    const auto local_key = key_ + suffix;
+    const auto local_key = hkey_.Derive(suffix.c_str());
     auto mem_p =
         std::static_pointer_cast<dnnl::memory>(dev_ctx_.GetBlob(local_key));
     if (mem_p == nullptr) {
@@ -389,7 +388,7 @@ class OneDNNHandlerT {
 
   std::shared_ptr<dnnl::memory> AcquireMemoryFromPrimitive(
       dnnl::memory::desc md, const std::string& suffix) {
-    const auto local_key = key_ + suffix;
+    const auto local_key = hkey_.Derive(suffix.c_str());
     auto mem_p =
         std::static_pointer_cast<dnnl::memory>(dev_ctx_.GetBlob(local_key));
     if (mem_p == nullptr) {
@@ -422,9 +421,10 @@ class OneDNNHandlerT {
       std::function<std::shared_ptr<F>(const F*)> custom_reorder_func = {},
       const std::vector<float>& scale_data = {1.0f},
       int mask = 0) {
-    const auto target_key = key_ + suffix + "_target";
-    const auto key_reorder_p = key_ + suffix + "reorder_p";
-    const auto user_key = key_ + suffix + "_user";
+    const auto suffix_key = hkey_.Derive(suffix.c_str());
+    const auto target_key = TargetMemoryKey(suffix_key);
+    const auto key_reorder_p = suffix_key.Derive("reorder_p");
+    const auto user_key = UserMemoryKey(suffix_key);
 
     auto target_memory_p =
         std::static_pointer_cast<dnnl::memory>(dev_ctx_.GetBlob(target_key));
@@ -433,7 +433,8 @@ class OneDNNHandlerT {
       if (custom_reorder_func) {
         auto reordered_data =
             custom_reorder_func(reinterpret_cast<const F*>(ptr));
-        dev_ctx_.SetBlob(key_reorder_p + "-custom_reorder", reordered_data);
+        dev_ctx_.SetBlob(key_reorder_p.Derive("-custom_reorder"),
+                         reordered_data);
         ptr = reinterpret_cast<void*>(reordered_data.get());
       }
       auto user_memory_p =
@@ -498,22 +499,43 @@ class OneDNNHandlerT {
   }
 
   std::shared_ptr<dnnl::memory> AcquireMemory(const std::string& suffix) {
-    const auto local_key = key_ + suffix;
+    const auto local_key = hkey_.Derive(suffix.c_str());
     return std::static_pointer_cast<dnnl::memory>(dev_ctx_.GetBlob(local_key));
   }
 
+  // Memories cached by AcquireMemoryWithReorder under the given suffix, null
+  // if it has not run yet. The target one is the reordered memory passed to
+  // the primitive, the user one wraps the buffer of the tensor.
+  std::shared_ptr<dnnl::memory> AcquireTargetMemory(const std::string& suffix) {
+    return std::static_pointer_cast<dnnl::memory>(
+        dev_ctx_.GetBlob(TargetMemoryKey(hkey_.Derive(suffix.c_str()))));
+  }
+
+  std::shared_ptr<dnnl::memory> AcquireUserMemory(const std::string& suffix) {
+    return std::static_pointer_cast<dnnl::memory>(
+        dev_ctx_.GetBlob(UserMemoryKey(hkey_.Derive(suffix.c_str()))));
+  }
+
   void CacheMemory(const std::string& suffix,
                    const std::shared_ptr<dnnl::memory>& mem_p) {
-    const auto local_key = key_ + suffix;
+    const auto local_key = hkey_.Derive(suffix.c_str());
     dev_ctx_.SetBlob(local_key, mem_p);
     return;
   }
 
+  static OneDNNCacheKey TargetMemoryKey(const OneDNNCacheKey& suffix_key) {
+    return suffix_key.Derive("_target");
+  }
+
+  static OneDNNCacheKey UserMemoryKey(const OneDNNCacheKey& suffix_key) {
+    return suffix_key.Derive("_user");
+  }
+
   const OneDNNContext& dev_ctx_;
   dnnl::engine engine_;
   Place place_;
-  std::string key_common_;
-  std::string key_;
+  // The cached objects of the handler are derived from this key
+  OneDNNCacheKey hkey_;
   std::shared_ptr<typename TForward::primitive_desc> fwd_pd_;
   std::shared_ptr<typename TBackward::primitive_desc> bwd_pd_;
   std::shared_ptr<typename TBackward_params::primitive_desc> bwd_w_pd_;
@@ -1753,11 +1775,12 @@ class PoolingOneDNNHandler
     // Pooling Workspace has to be passed to Grad op that
     // may be executed by diffrent thread, hence
     // for that one we use key that does not contain TID
-    std::string workspace_key = CreateKey(dev_ctx,
-                                          workspace_md.get_dims(),
-                                          workspace_md.get_data_type(),
-                                          unique_name,
-                                          "@wrk");
+    const auto workspace_key = CreateHashedKey(dev_ctx,
+                                               "pool2d",
+                                               workspace_md.get_dims(),
+                                               workspace_md.get_data_type(),
+                                               unique_name,
+                                               "@wrk");
     auto mem_p =
         std::static_pointer_cast<dnnl::memory>(dev_ctx.GetBlob(workspace_key));
     if (mem_p == nullptr) {
@@ -24,6 +24,7 @@
 #include "paddle/phi/core/distributed/auto_parallel/reshard/r_to_s_reshard_function.h"
 #include "paddle/phi/core/distributed/auto_parallel/reshard/reshard_utils.h"
 #include "paddle/phi/core/distributed/auto_parallel/reshard/s_to_r_reshard_function.h"
+#include "paddle/phi/core/distributed/auto_parallel/reshard/s_to_s_reshard_function.h"
 #include "paddle/phi/core/distributed/auto_parallel/reshard/same_status_reshard_function.h"
 #include "paddle/phi/core/distributed/store/store_utils.h"
 
@@ -92,6 +93,10 @@ void SameNdMeshReshardFunction::Eval(phi::DeviceContext* dev_ctx,
                                      const TensorDistAttr& out_dist_attr,
                                      DistTensor* out) {
   VLOG(3) << "Call " << Name();
+  if (EvalByAllToAll(dev_ctx, in, out_dist_attr, out)) {
+    return;
+  }
+
   const auto& in_dist_attr = in.dist_attr();
   const auto& process_mesh = out_dist_attr.process_mesh();
 
@@ -272,6 +277,107 @@ void SameNdMeshReshardFunction::Eval(phi::DeviceContext* dev_ctx,
   }
 }
 
+bool SameNdMeshReshardFunction::EvalByAllToAll(
+    DeviceContext* dev_ctx,
+    const DistTensor& in,
+    const TensorDistAttr& out_dist_attr,
+    DistTensor* out) {
+  // There is no all_to_all kernel on cpu.
+  if (phi::CPUContext::classof(dev_ctx)) {
+    return false;
+  }
+  const auto& in_dist_attr = in.dist_attr();
+  if (in_dist_attr.is_partial() || out_dist_attr.is_partial()) {
+    return false;
+  }
+
+  const auto& process_mesh = out_dist_attr.process_mesh();
+  const auto& in_dims_mapping = in_dist_attr.dims_mapping();
+  const auto& out_dims_mapping = out_dist_attr.dims_mapping();
+  const auto& global_dims = in.dims();
+
+  // The tensor dim sharded by each mesh axis before and after the transform.
+  std::vector<int64_t> src_dims(process_mesh.ndim(), -1);
+  std::vector<int64_t> dst_dims(process_mesh.ndim(), -1);
+  for (size_t i = 0; i < in_dims_mapping.size(); ++i) {
+    if (in_dims_mapping[i] != -1) {
+      src_dims[in_dims_mapping[i]] = static_cast<int64_t>(i);
+    }
+    if (out_dims_mapping[i] != -1) {
+      dst_dims[out_dims_mapping[i]] = static_cast<int64_t>(i);
+    }
+  }
+
+  // Every changed mesh axis must move from one tensor dim to another one,
+  // which is free in the input and will be free in the output.
+  std::vector<int64_t> moved_axes;
+  for (int64_t axis = 0; axis < process_mesh.ndim(); ++axis) {
+    int64_t src = src_dims[axis];
+    int64_t dst = dst_dims[axis];
+    if (src == dst) {
+      continue;
+    }
+    if (src == -1 || dst == -1 || in_dims_mapping[dst] != -1 ||
+        out_dims_mapping[src] != -1) {
+      return false;
+    }
+    int64_t degree = process_mesh.dim_size(axis);
+    if (global_dims[src] % degree != 0 || global_dims[dst] % degree != 0) {
+      return false;
+    }
+    moved_axes.emplace_back(axis);
+  }
+  if (moved_axes.empty()) {
+    return false;
+  }
+
+  SetValue(out, in.value());
+  SetDistProps(out, global_dims, in_dist_attr);
+  for (int64_t axis : moved_axes) {
+    int64_t src = src_dims[axis];
+    int64_t dst = dst_dims[axis];
+    VLOG(3) << "Move mesh axis " << axis << " from tensor dim " << src
+            << " to " << dst << " by all_to_all";
+
+    TensorDistAttr real_out_dist_attr(out->dist_attr());
+    std::vector<int64_t> real_dims_mapping = real_out_dist_attr.dims_mapping();
+    real_dims_mapping[src] = -1;
+    real_dims_mapping[dst] = axis;
+    real_out_dist_attr.set_dims_mapping(real_dims_mapping);
+
+    // Only the moved mesh axis is visible to the one dim transform, so its
+    // logical shape is the local shape with the source dim gathered back.
+    ProcessMesh sub_mesh = GetSubProcessMesh(process_mesh, axis);
+    std::vector<int64_t> one_dim_shape = common::vectorize(out->local_dims());
+    one_dim_shape[src] *= process_mesh.dim_size(axis);
+
+    TensorDistAttr in_one_dim_dist_attr(one_dim_shape);
+    in_one_dim_dist_attr.set_process_mesh(sub_mesh);
+    std::vector<int64_t> in_one_dims_mapping(one_dim_shape.size(), -1);
+    in_one_dims_mapping[src] = 0;
+    in_one_dim_dist_attr.set_dims_mapping(in_one_dims_mapping);
+
+    TensorDistAttr out_one_dim_dist_attr(one_dim_shape);
+    out_one_dim_dist_attr.set_process_mesh(sub_mesh);
+    std::vector<int64_t> out_one_dims_mapping(one_dim_shape.size(), -1);
+    out_one_dims_mapping[dst] = 0;
+    out_one_dim_dist_attr.set_dims_mapping(out_one_dims_mapping);
+
+    DistTensor one_dim_in(in.dtype());
+    SetValue(&one_dim_in, out->value());
+    SetDistProps(
+        &one_dim_in, common::make_ddim(one_dim_shape), in_one_dim_dist_attr);
+
+    DistTensor tmp_result;
+    SToSReshardFunction func;
+    func.Eval(dev_ctx, one_dim_in, out_one_dim_dist_attr, &tmp_result);
+
+    SetValue(out, tmp_result.value());
+    SetDistProps(out, global_dims, real_out_dist_attr);
+  }
+  return true;
+}
+
 bool CrossNdMeshReshardFunction::IsSuitable(
     const DistTensor& in, const TensorDistAttr& out_dist_attr) {
   const ProcessMesh& in_process_mesh = in.dist_attr().process_mesh();
@@ -30,6 +30,15 @@ class SameNdMeshReshardFunction final : public ReshardFunction {
             DistTensor* out) override;
 
   std::string Name() override { return "SameNdMeshReshard"; }
+
+ private:
+  // Move the shard of mesh axes between tensor dims with one all-to-all per
+  // axis instead of all-gather followed by a slice. Return false and leave
+  // `out` untouched when the transform is not such a pure move.
+  bool EvalByAllToAll(DeviceContext* dev_ctx,
+                      const DistTensor& in,
+                      const TensorDistAttr& out_dist_attr,
+                      DistTensor* out);
 };
 
 class CrossNdMeshReshardFunction final : public ReshardFunction {
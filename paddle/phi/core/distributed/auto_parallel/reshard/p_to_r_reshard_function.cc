@@ -16,14 +16,17 @@
 
 #include "glog/logging.h"
 
+#include "paddle/phi/common/int_array.h"
 #include "paddle/phi/core/distributed/auto_parallel/dist_attr.h"
 #include "paddle/phi/core/distributed/auto_parallel/dist_tensor.h"
 #include "paddle/phi/core/distributed/auto_parallel/reshard/reshard_utils.h"
 #include "paddle/phi/core/distributed/auto_parallel/reshard/same_status_reshard_function.h"
 #include "paddle/phi/core/distributed/store/store_utils.h"
 #include "paddle/phi/kernels/all_reduce_kernel.h"
+#include "paddle/phi/kernels/concat_kernel.h"
 #include "paddle/phi/kernels/elementwise_divide_kernel.h"
 #include "paddle/phi/kernels/full_kernel.h"
+#include "paddle/phi/kernels/split_kernel.h"
 
 namespace phi::distributed {
 
@@ -92,6 +95,86 @@ void PToRReshardFunction::Eval(DeviceContext* dev_ctx,
   SetDistProps(out, in.dims(), out_dist_attr);
 }
 
+void PToRReshardFunction::EvalBatch(
+    DeviceContext* dev_ctx,
+    const std::vector<const DistTensor*>& ins,
+    const std::vector<TensorDistAttr>& out_dist_attrs,
+    const std::vector<DistTensor*>& outs) {
+  VLOG(3) << "Call " << Name() << " for a batch of " << ins.size()
+          << " tensors";
+  PADDLE_ENFORCE_EQ(
+      ins.size() == out_dist_attrs.size() && ins.size() == outs.size(),
+      true,
+      common::errors::InvalidArgument(
+          "The number of inputs, output dist_attrs and outputs should be the "
+          "same, but got %d, %d and %d.",
+          ins.size(),
+          out_dist_attrs.size(),
+          outs.size()));
+  if (ins.size() == 1) {
+    Eval(dev_ctx, *ins[0], out_dist_attrs[0], outs[0]);
+    return;
+  }
+
+  const auto& in_dist_attr = ins[0]->dist_attr();
+  auto in_reduce_type = in_dist_attr.partial_status().at(0);
+  auto dtype = ins[0]->dtype();
+
+  // 1. Flatten every local value and pack them into one buffer
+  std::vector<DenseTensor> flat_ins(ins.size());
+  std::vector<const DenseTensor*> concat_input_vec;
+  std::vector<int64_t> sections;
+  for (size_t i = 0; i < ins.size(); ++i) {
+    PADDLE_ENFORCE_EQ(
+        ins[i]->dtype() == dtype &&
+            ins[i]->dist_attr().process_mesh() ==
+                in_dist_attr.process_mesh() &&
+            ins[i]->dist_attr().partial_status().at(0) == in_reduce_type,
+        true,
+        common::errors::InvalidArgument(
+            "All the tensors in a batch should have the same dtype, process "
+            "mesh and reduce type, but the %d-th one is %s.",
+            i,
+            ins[i]->dist_attr().to_string()));
+    int64_t numel = ins[i]->value().numel();
+    flat_ins[i].ShareDataNoCheckWith(ins[i]->value());
+    flat_ins[i].Resize({numel});
+    concat_input_vec.emplace_back(&flat_ins[i]);
+    sections.emplace_back(numel);
+  }
+  DenseTensor packed;
+  RESHARD_FUNCTOR(
+      dev_ctx, Concat, dtype, concat_input_vec, /*axis*/ 0, &packed);
+
+  // 2. Reduce the packed buffer once
+  TensorDistAttr packed_in_dist_attr(common::vectorize(packed.dims()));
+  packed_in_dist_attr.set_process_mesh(in_dist_attr.process_mesh());
+  packed_in_dist_attr.set_partial_status(std::vector<int64_t>{0},
+                                         in_reduce_type);
+  DistTensor packed_in(dtype);
+  SetValue(&packed_in, packed);
+  SetDistProps(&packed_in, packed.dims(), packed_in_dist_attr);
+  TensorDistAttr packed_out_dist_attr(common::vectorize(packed.dims()));
+  packed_out_dist_attr.set_process_mesh(in_dist_attr.process_mesh());
+  DistTensor packed_out(dtype);
+  Eval(dev_ctx, packed_in, packed_out_dist_attr, &packed_out);
+
+  // 3. Unpack the result into every output
+  std::vector<DenseTensor> split_out_vec;
+  RESHARD_FUNCTOR(dev_ctx,
+                  Split,
+                  dtype,
+                  packed_out.value(),
+                  IntArray(sections),
+                  /*split_axis*/ 0,
+                  &split_out_vec);
+  for (size_t i = 0; i < ins.size(); ++i) {
+    split_out_vec[i].Resize(ins[i]->value().dims());
+    SetValue(outs[i], split_out_vec[i]);
+    SetDistProps(outs[i], ins[i]->dims(), out_dist_attrs[i]);
+  }
+}
+
 bool PToRReshardFunctionCrossMesh::IsSuitable(
     const DistTensor& in, const TensorDistAttr& out_dist_attr) {
   const auto& in_dist_attr = in.dist_attr();
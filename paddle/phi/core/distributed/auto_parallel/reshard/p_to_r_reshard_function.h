@@ -32,6 +32,14 @@ class PToRReshardFunction final : public ReshardFunction {
             const TensorDistAttr& out_dist_attr,
             DistTensor* out) override;
 
+  // Reshard a group of partial tensors to replicated with one all_reduce on
+  // their flattened concatenation. All the inputs must be suitable for this
+  // function and share the process mesh, dtype and reduce type.
+  void EvalBatch(DeviceContext* dev_ctx,
+                 const std::vector<const DistTensor*>& ins,
+                 const std::vector<TensorDistAttr>& out_dist_attrs,
+                 const std::vector<DistTensor*>& outs);
+
   std::string Name() override { return "PToRReshard"; }
 };
 
@@ -14,8 +14,12 @@
 
 #include "paddle/phi/core/distributed/auto_parallel/reshard/reshard_function_registry.h"
 
+#include <mutex>
+#include <unordered_map>
+
 #include "glog/logging.h"
 
+#include "paddle/common/flags.h"
 #include "paddle/phi/core/distributed/auto_parallel/dist_tensor.h"
 #include "paddle/phi/core/distributed/auto_parallel/reshard/global_and_sub_mesh_reshard_function.h"
 #include "paddle/phi/core/distributed/auto_parallel/reshard/nd_mesh_reshard_function.h"
@@ -30,9 +34,104 @@
 #include "paddle/phi/core/distributed/auto_parallel/reshard/same_status_reshard_function.h"
 #include "paddle/phi/core/distributed/auto_parallel/reshard/x_to_r_reshard_function.h"
 
+PHI_DEFINE_EXPORTED_int64(
+    reshard_plan_cache_capacity,
+    4096,
+    "The max number of (in_dist_attr, out_dist_attr, shape) entries kept in "
+    "the cache of chosen reshard functions. The cache is reset when it is "
+    "full. 0 means disable the cache.");
+
 namespace phi::distributed {
 
-ReshardFunction* ChooseProperReshardFunction(
+namespace {
+
+inline void HashCombine(size_t* seed, size_t value) {
+  *seed ^= value + 0x9e3779b9 + (*seed << 6) + (*seed >> 2);
+}
+
+size_t HashDistAttr(const TensorDistAttr& dist_attr) {
+  size_t seed = 0;
+  const auto& process_mesh = dist_attr.process_mesh();
+  for (auto dim : process_mesh.shape()) {
+    HashCombine(&seed, std::hash<int64_t>()(dim));
+  }
+  for (auto id : process_mesh.process_ids()) {
+    HashCombine(&seed, std::hash<int64_t>()(id));
+  }
+  for (auto dim : dist_attr.dims_mapping()) {
+    HashCombine(&seed, std::hash<int64_t>()(dim));
+  }
+  // flat_hash_map has no stable iteration order, so fold the partial status
+  // with a commutative operation.
+  size_t partial_seed = 0;
+  for (const auto& item : dist_attr.partial_status()) {
+    size_t item_seed = 0;
+    HashCombine(&item_seed, std::hash<int64_t>()(item.first));
+    HashCombine(&item_seed,
+                std::hash<int64_t>()(static_cast<int64_t>(item.second)));
+    partial_seed += item_seed;
+  }
+  HashCombine(&seed, partial_seed);
+  HashCombine(&seed, std::hash<int64_t>()(dist_attr.chunk_id()));
+  return seed;
+}
+
+// The choice of a reshard function only depends on the dist_attrs (which
+// include the process meshes) and the shape of the input, so it is cached to
+// avoid running the IsSuitable checks of every registered function on each
+// reshard.
+struct ReshardPlanKey {
+  TensorDistAttr in_dist_attr;
+  TensorDistAttr out_dist_attr;
+  DDim dims;
+
+  bool operator==(const ReshardPlanKey& other) const {
+    return dims == other.dims && in_dist_attr == other.in_dist_attr &&
+           out_dist_attr == other.out_dist_attr;
+  }
+};
+
+struct ReshardPlanKeyHash {
+  size_t operator()(const ReshardPlanKey& key) const {
+    size_t seed = HashDistAttr(key.in_dist_attr);
+    HashCombine(&seed, HashDistAttr(key.out_dist_attr));
+    for (int i = 0; i < key.dims.size(); ++i) {
+      HashCombine(&seed, std::hash<int64_t>()(key.dims[i]));
+    }
+    return seed;
+  }
+};
+
+class ReshardPlanCache {
+ public:
+  static ReshardPlanCache& Instance() {
+    static ReshardPlanCache cache;
+    return cache;
+  }
+
+  ReshardFunction* Get(const ReshardPlanKey& key) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto iter = plans_.find(key);
+    return iter == plans_.end() ? nullptr : iter->second;
+  }
+
+  void Put(ReshardPlanKey&& key, ReshardFunction* func) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (static_cast<int64_t>(plans_.size()) >=
+        FLAGS_reshard_plan_cache_capacity) {
+      VLOG(4) << "Reshard plan cache is full, reset it.";
+      plans_.clear();
+    }
+    plans_.emplace(std::move(key), func);
+  }
+
+ private:
+  std::mutex mutex_;
+  std::unordered_map<ReshardPlanKey, ReshardFunction*, ReshardPlanKeyHash>
+      plans_;
+};
+
+ReshardFunction* ChooseProperReshardFunctionImpl(
     const DistTensor& in, const TensorDistAttr& out_dist_attr) {
   for (const auto& func : GetReshardFunctionList()) {
     if (func->IsSuitable(in, out_dist_attr)) {
@@ -46,6 +145,24 @@ ReshardFunction* ChooseProperReshardFunction(
       out_dist_attr.to_string()));
 }
 
+}  // namespace
+
+ReshardFunction* ChooseProperReshardFunction(
+    const DistTensor& in, const TensorDistAttr& out_dist_attr) {
+  if (FLAGS_reshard_plan_cache_capacity <= 0) {
+    return ChooseProperReshardFunctionImpl(in, out_dist_attr);
+  }
+  ReshardPlanKey key{in.dist_attr(), out_dist_attr, in.dims()};
+  auto& cache = ReshardPlanCache::Instance();
+  if (auto* func = cache.Get(key)) {
+    VLOG(4) << "Choose cached ReshardFunction: " << func->Name();
+    return func;
+  }
+  auto* func = ChooseProperReshardFunctionImpl(in, out_dist_attr);
+  cache.Put(std::move(key), func);
+  return func;
+}
+
 std::vector<std::unique_ptr<ReshardFunction>>& GetReshardFunctionList() {
   static std::vector<std::unique_ptr<ReshardFunction>> func_list;
   return func_list;
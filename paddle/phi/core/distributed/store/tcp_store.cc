@@ -14,6 +14,11 @@
 
 #include "paddle/phi/core/distributed/store/tcp_store.h"
 
+#ifdef __linux__
+#include <sys/epoll.h>
+#endif
+
+#include <algorithm>
 #include <chrono>
 #include <iostream>
 #include <thread>
@@ -26,6 +31,9 @@
 namespace phi::distributed::detail {
 
 constexpr int INFTIME = 10000;  // 10 seconds
+#ifdef __linux__
+constexpr int kMaxEpollEvents = 1024;
+#endif
 
 std::unique_ptr<MasterDaemon> MasterDaemon::start(SocketType socket,
                                                   int nranks,
@@ -49,6 +57,11 @@ MasterDaemon::~MasterDaemon() {  // NOLINT
     tcputils::close_socket(socket);
   }
   CloseControlFd();
+#ifdef __linux__
+  if (_epoll_fd != -1) {
+    ::close(_epoll_fd);
+  }
+#endif
 }
 
 void MasterDaemon::_do_add(SocketType socket) {
@@ -83,15 +96,30 @@ void MasterDaemon::_do_set(SocketType socket) {
 }
 
 void MasterDaemon::_notify_waiting_sockets(const std::string& key) {
-  if (_waiting_sockets.find(key) != _waiting_sockets.end()) {
-    for (auto waiting_socket : _waiting_sockets.at(key)) {
-      auto reply = ReplyType::STOP_WAIT;
-      VLOG(7) << "TCPStore: notify the socket: " << GetSockName(waiting_socket)
-              << " that key: " << key << " is ready.";
+  auto iter = _waiting_sockets.find(key);
+  if (iter == _waiting_sockets.end()) {
+    return;
+  }
+  for (auto waiting_socket : iter->second) {
+    auto reply = ReplyType::STOP_WAIT;
+    VLOG(7) << "TCPStore: notify the socket: " << GetSockName(waiting_socket)
+            << " that key: " << key << " is ready.";
+    auto keys_iter = _socket_waiting_keys.find(waiting_socket);
+    if (keys_iter != _socket_waiting_keys.end()) {
+      keys_iter->second.erase(key);
+      if (keys_iter->second.empty()) {
+        _socket_waiting_keys.erase(keys_iter);
+      }
+    }
+    // A broken waiter must not be blamed on the socket that set the key, it
+    // is closed when its own hang-up event is processed.
+    try {
       tcputils::send_value<ReplyType>(waiting_socket, reply);
+    } catch (const std::exception& ex) {
+      VLOG(5) << "TCPStore: failed to notify waiting socket: " << ex.what();
     }
-    _waiting_sockets.erase(key);
   }
+  _waiting_sockets.erase(iter);
 }
 
 void MasterDaemon::_do_get(SocketType socket) {
@@ -120,6 +148,46 @@ void MasterDaemon::_do_check(SocketType socket) {
   }
 }
 
+void MasterDaemon::_do_multi_get(SocketType socket) {
+  auto num_keys = tcputils::receive_value<size_t>(socket);
+  VLOG(8) << "MasterDaemon::_do_multi_get num_keys(" << num_keys << ") "
+          << GetSockName(socket);
+
+  std::vector<std::string> keys;
+  keys.reserve(num_keys);
+  for (size_t i = 0; i < num_keys; ++i) {
+    keys.emplace_back(tcputils::receive_string(socket));
+  }
+  tcputils::send_value<size_t>(socket, num_keys);
+  for (const auto& key : keys) {
+    auto iter = _store.find(key);
+    PADDLE_ENFORCE_NE(
+        iter,
+        _store.end(),
+        common::errors::InvalidArgument("Key %s not found in TCPStore.", key));
+    tcputils::send_vector<uint8_t>(socket, iter->second);
+  }
+}
+
+void MasterDaemon::_do_multi_set(SocketType socket) {
+  auto num_keys = tcputils::receive_value<size_t>(socket);
+  VLOG(8) << "MasterDaemon::_do_multi_set num_keys(" << num_keys << ") "
+          << GetSockName(socket);
+
+  std::vector<std::string> keys;
+  keys.reserve(num_keys);
+  for (size_t i = 0; i < num_keys; ++i) {
+    std::string key = tcputils::receive_string(socket);
+    _store[key] = tcputils::receive_vector<uint8_t>(socket);
+    keys.emplace_back(std::move(key));
+  }
+  // Publish only after the whole batch is stored, so waiters woken by the
+  // first key can read every other key of the batch.
+  for (const auto& key : keys) {
+    _notify_waiting_sockets(key);
+  }
+}
+
 #ifndef _WIN32
 void MasterDaemon::InitControlFd() {
   PADDLE_ENFORCE_NE(
@@ -166,6 +234,7 @@ void MasterDaemon::_do_wait(SocketType socket) {
   if (iter == _store.end()) {
     // The key can not be found in store currently. Record and check later.
     _waiting_sockets[key].emplace_back(socket);
+    _socket_waiting_keys[socket].insert(key);
   } else {
     auto reply = ReplyType::STOP_WAIT;
     VLOG(7) << "TCPStore: wait reply (" << static_cast<int>(reply)
@@ -174,88 +243,158 @@ void MasterDaemon::_do_wait(SocketType socket) {
   }
 }
 
-void MasterDaemon::ProcessCommands(std::vector<struct pollfd>* p_fds) {
-  std::vector<struct pollfd>& fds = *p_fds;
-  // FIXME(gongwb): Don't loop all fds of set just the fds who have event.
-#ifdef _WIN32
-  // 0: listen socket, so loop from 1.
-  for (size_t i = 1; i < fds.size(); i++) {
-#else
-  // 0: listen socket, 1:controller pipe, so loop from 2.
-  for (uint i = 2; i < fds.size(); i++) {
-#endif
-    try {
-      if (fds[i].revents == 0) {
+void MasterDaemon::ProcessCommand(SocketType socket, Command command) {
+  VLOG(7) << "TCPStore: recv command: " << static_cast<int>(command) << ".";
+  switch (command) {
+    case Command::ADD:
+      _do_add(socket);
+      break;
+    case Command::GET:
+      _do_get(socket);
+      break;
+    case Command::CHECK:
+      _do_check(socket);
+      break;
+    case Command::SET:
+      _do_set(socket);
+      break;
+    case Command::WAIT:
+      _do_wait(socket);
+      break;
+    case Command::MULTI_GET:
+      _do_multi_get(socket);
+      break;
+    case Command::MULTI_SET:
+      _do_multi_set(socket);
+      break;
+    default:
+      VLOG(8) << "Unknown command: " << static_cast<int>(command)
+              << " from addr info:" << GetSockName(socket);
+  }
+}
+
+void MasterDaemon::ProcessSocket(SocketType socket) {
+  try {
+    VLOG(8) << "Plan to receive command from " << GetSockName(socket);
+    do {
+      ProcessCommand(socket, tcputils::receive_value<Command>(socket));
+      // Keep serving while the client has more requests in flight.
+    } while (tcputils::has_pending_data(socket));
+  } catch (const std::exception& ex) {
+    CloseClientSocket(socket);
+    std::string s(ex.what());
+    if (s.find("TCP connection reset by peer") != std::string::npos) {
+      VLOG(5) << "TCP connection reset by peer";
+    } else {
+      VLOG(5) << "Meet some exceptions during run:" << ex.what();
+    }
+  }
+}
+
+void MasterDaemon::CloseClientSocket(SocketType socket) {
+  auto keys_iter = _socket_waiting_keys.find(socket);
+  if (keys_iter != _socket_waiting_keys.end()) {
+    for (const auto& key : keys_iter->second) {
+      auto waiting_iter = _waiting_sockets.find(key);
+      if (waiting_iter == _waiting_sockets.end()) {
         continue;
       }
-
-      VLOG(8) << "Plan to receive command from " << GetSockName(fds[i].fd);
-      Command command = tcputils::receive_value<Command>(fds[i].fd);
-      VLOG(7) << "TCPStore: recv command: " << static_cast<int>(command) << ".";
-
-      switch (command) {
-        case Command::ADD:
-          _do_add(fds[i].fd);
-          break;
-        case Command::GET:
-          _do_get(fds[i].fd);
-          break;
-        case Command::CHECK:
-          _do_check(fds[i].fd);
-          break;
-        case Command::SET:
-          _do_set(fds[i].fd);
-          break;
-        case Command::WAIT:
-          _do_wait(fds[i].fd);
-          break;
-        default:
-          VLOG(8) << "Unknown command: " << static_cast<int>(command)
-                  << " from addr info:" << GetSockName(fds[i].fd);
-      }
-    } catch (const std::exception& ex) {
-      auto map_iter = _waiting_sockets.begin();
-      while (map_iter != _waiting_sockets.end()) {
-        auto vec_iter = map_iter->second.begin();
-        while (vec_iter != map_iter->second.end()) {
-          if (*vec_iter == fds[i].fd) {
-            vec_iter = map_iter->second.erase(vec_iter);
-          } else {
-            ++vec_iter;
-          }
-        }
-        if (map_iter->second.empty()) {
-          map_iter = _waiting_sockets.erase(map_iter);
-        } else {
-          ++map_iter;
-        }
+      auto& waiting = waiting_iter->second;
+      waiting.erase(std::remove(waiting.begin(), waiting.end(), socket),
+                    waiting.end());
+      if (waiting.empty()) {
+        _waiting_sockets.erase(waiting_iter);
       }
+    }
+    _socket_waiting_keys.erase(keys_iter);
+  }
+#ifdef __linux__
+  ::epoll_ctl(_epoll_fd, EPOLL_CTL_DEL, socket, nullptr);
+#endif
+  tcputils::close_socket(socket);
+  _sockets.erase(socket);
+}
 
-      tcputils::close_socket(fds[i].fd);
-      fds.erase(fds.begin() + i);
-#ifdef _WIN32
-      _sockets.erase(_sockets.begin() + i - 1);
+void MasterDaemon::run() {
+#ifdef __linux__
+  RunEpoll();
 #else
-      _sockets.erase(_sockets.begin() + i - 2);
+  RunPoll();
 #endif
-      std::string s(ex.what());
-      if (s.find("TCP connection reset by peer") != std::string::npos) {
-        VLOG(5) << "TCP connection reset by peer";
-      } else {
-        VLOG(5) << "Meet some exceptions during run:" << ex.what();
+}
+
+#ifdef __linux__
+void MasterDaemon::RunEpoll() {
+  _epoll_fd = ::epoll_create1(EPOLL_CLOEXEC);
+  PADDLE_ENFORCE_NE(
+      _epoll_fd,
+      -1,
+      common::errors::Fatal("failed to create epoll fd errno:%d", errno));
+
+  auto add_fd = [this](int fd, uint32_t events) {
+    struct epoll_event ev {};
+    ev.events = events;
+    ev.data.fd = fd;
+    PADDLE_ENFORCE_NE(
+        ::epoll_ctl(_epoll_fd, EPOLL_CTL_ADD, fd, &ev),
+        -1,
+        common::errors::Fatal("failed to add fd to epoll errno:%d", errno));
+  };
+  add_fd(_listen_socket, EPOLLIN);
+  add_fd(_control_fd[0], EPOLLIN | EPOLLHUP);
+
+  // Only the sockets with pending events are returned, so the cost of one
+  // iteration no longer grows with the number of connected ranks.
+  std::vector<struct epoll_event> events(kMaxEpollEvents);
+  bool finished = false;
+  while (!finished) {
+    int num_events = ::epoll_wait(
+        _epoll_fd, events.data(), static_cast<int>(events.size()), INFTIME);
+    if (num_events < 0) {
+      PADDLE_ENFORCE_EQ(
+          errno,
+          EINTR,
+          common::errors::Fatal("epoll_wait failed errno:%d", errno));
+      continue;
+    }
+    VLOG(9) << "epoll_wait returned events:"
+            << paddle::string::Sprintf("%d", num_events);
+
+    for (int i = 0; i < num_events; ++i) {
+      int fd = events[i].data.fd;
+      if (fd == _control_fd[0]) {
+        if (events[i].events & ~(EPOLLIN | EPOLLHUP)) {
+          PADDLE_THROW(common::errors::Fatal("Undefined event type:%d",
+                                             events[i].events));
+        }
+        VLOG(0)
+            << "receive shutdown event and so quit from MasterDaemon run loop";
+        finished = true;
+        break;
       }
+      if (fd == _listen_socket) {
+        auto socket = tcputils::tcp_accept(_listen_socket);
+        _sockets.insert(socket);
+        add_fd(socket, EPOLLIN | EPOLLRDHUP);
+        continue;
+      }
+      ProcessSocket(fd);
     }
   }
 }
-
-void MasterDaemon::run() {
+#else
+void MasterDaemon::RunPoll() {
   std::vector<struct pollfd> fds;
 #ifdef _WIN32
   fds.push_back({_listen_socket, POLLIN});
+  // 0: listen socket.
+  constexpr size_t kNumReservedFds = 1;
 #else
   fds.push_back({.fd = _listen_socket, .events = POLLIN, .revents = 0});
   fds.push_back(
       {.fd = _control_fd[0], .events = POLLIN | POLLHUP, .revents = 0});
+  // 0: listen socket, 1:controller pipe.
+  constexpr size_t kNumReservedFds = 2;
 #endif
 
   bool finished = false;
@@ -294,20 +433,32 @@ void MasterDaemon::run() {
     }
 #endif
 
+    for (size_t i = kNumReservedFds; i < fds.size(); i++) {
+      if (fds[i].revents != 0) {
+        ProcessSocket(fds[i].fd);
+      }
+    }
+    // Drop the sockets closed while processing commands.
+    fds.erase(std::remove_if(fds.begin() + kNumReservedFds,
+                             fds.end(),
+                             [this](const struct pollfd& item) {
+                               return _sockets.count(item.fd) == 0;
+                             }),
+              fds.end());
+
     // accept connect request.
     if (fds[0].revents != 0) {
       auto socket = tcputils::tcp_accept(_listen_socket);
-      _sockets.emplace_back(socket);
+      _sockets.insert(socket);
 #ifdef _WIN32
       fds.push_back({socket, POLLIN});
 #else
       fds.push_back({.fd = socket, .events = POLLIN, .revents = 0});
 #endif
     }
-
-    ProcessCommands(&fds);
   }
 }
+#endif
 
 std::unique_ptr<TCPServer> TCPServer::create(uint16_t port,
                                              int nranks,
@@ -333,6 +484,10 @@ void TCPClient::send_command_for_key(Command type, const std::string& key) {
   tcputils::send_string(_socket, key);
 }
 
+void TCPClient::send_string(const std::string& s) {
+  tcputils::send_string(_socket, s);
+}
+
 template <typename T>
 void TCPClient::send_value(const T& value) {
   tcputils::send_bytes<T>(_socket, &value, 1);
@@ -462,6 +617,61 @@ void TCPStore::wait(const std::string& key) {
       common::errors::InvalidArgument("Stop_waiting response is expected"));
 }
 
+std::vector<std::vector<uint8_t>> TCPStore::multi_get(
+    const std::vector<std::string>& keys) {
+  VLOG(7) << "TCPStore multi_get.";
+  if (keys.empty()) {
+    return {};
+  }
+  // Pipeline the waits so that the whole batch costs one round trip, every
+  // STOP_WAIT reply is identical so the order they come back in is irrelevant.
+  for (const auto& key : keys) {
+    _client->send_command_for_key(Command::WAIT, _key_prefix + key);
+  }
+  for (size_t i = 0; i < keys.size(); ++i) {
+    auto reply = _client->receive_value<ReplyType>();
+    PADDLE_ENFORCE_EQ(
+        reply == ReplyType::STOP_WAIT,
+        true,
+        common::errors::InvalidArgument("Stop_waiting response is expected"));
+  }
+
+  _client->send_command_for_key(Command::MULTI_GET, "");
+  _client->send_value<size_t>(keys.size());
+  for (const auto& key : keys) {
+    _client->send_string(_key_prefix + key);
+  }
+  auto num_values = _client->receive_value<size_t>();
+  std::vector<std::vector<uint8_t>> values;
+  values.reserve(num_values);
+  for (size_t i = 0; i < num_values; ++i) {
+    values.emplace_back(_client->receive_vector<uint8_t>());
+  }
+  return values;
+}
+
+void TCPStore::multi_set(const std::vector<std::string>& keys,
+                         const std::vector<std::vector<uint8_t>>& values) {
+  VLOG(7) << "TCPStore multi_set.";
+  PADDLE_ENFORCE_EQ(
+      keys.size(),
+      values.size(),
+      common::errors::InvalidArgument(
+          "The number of keys (%d) and values (%d) passed to multi_set must "
+          "be equal.",
+          keys.size(),
+          values.size()));
+  if (keys.empty()) {
+    return;
+  }
+  _client->send_command_for_key(Command::MULTI_SET, "");
+  _client->send_value<size_t>(keys.size());
+  for (size_t i = 0; i < keys.size(); ++i) {
+    _client->send_string(_key_prefix + keys[i]);
+    _client->send_vector<uint8_t>(values[i]);
+  }
+}
+
 TCPStore::~TCPStore() { VLOG(7) << "TCPStore destructure"; }
 
 }  // namespace phi::distributed
@@ -29,6 +29,7 @@
 #include <mutex>
 #include <thread>
 #include <unordered_map>
+#include <unordered_set>
 
 #include "paddle/phi/core/distributed/store/socket.h"
 #include "paddle/phi/core/distributed/store/store.h"
@@ -38,7 +39,18 @@ namespace phi {
 namespace distributed {
 
 enum class ReplyType { WAITING, STOP_WAIT, READY, NOT_READY };
-enum class Command { ADD, GET, CHECK, SET, WAIT, STOP };
+// NOTE: new commands must be appended so that the wire values of the
+// existing ones stay stable across versions.
+enum class Command {
+  ADD,
+  GET,
+  CHECK,
+  SET,
+  WAIT,
+  STOP,
+  MULTI_GET,
+  MULTI_SET
+};
 
 namespace detail {
 
@@ -55,21 +67,34 @@ class MasterDaemon {
 
  private:
   void run();
-  void ProcessCommands(std::vector<struct pollfd>* p_fds);
+#ifdef __linux__
+  void RunEpoll();
+#else
+  void RunPoll();
+#endif
+  // Serve every command already buffered on the socket, so a client that
+  // pipelines requests is drained in one wake-up instead of one per command.
+  void ProcessSocket(SocketType socket);
+  void ProcessCommand(SocketType socket, Command command);
+  void CloseClientSocket(SocketType socket);
   void _do_add(SocketType socket);
   void _do_wait(SocketType socket);
   void _do_get(SocketType socket);
   void _do_check(SocketType socket);
   void _do_set(SocketType socket);
+  void _do_multi_get(SocketType socket);
+  void _do_multi_set(SocketType socket);
   void _notify_waiting_sockets(const std::string&);
   SocketType _listen_socket;
-  std::vector<SocketType> _sockets;
+  std::unordered_set<SocketType> _sockets;
   std::unordered_map<std::string, std::vector<uint8_t>> _store;
   std::thread _background_thread{};
   int _nranks = -1;
   int _timeout = 0;
   std::unordered_map<std::string, std::vector<SocketType>>
       _waiting_sockets;  // key -> list of waiting sockets
+  std::unordered_map<SocketType, std::unordered_set<std::string>>
+      _socket_waiting_keys;  // socket -> keys it is waiting for
 
   void InitControlFd();
   void CloseControlFd();
@@ -79,6 +104,9 @@ class MasterDaemon {
 #else
   std::array<int, 2> _control_fd{{-1, -1}};
 #endif
+#ifdef __linux__
+  int _epoll_fd = -1;
+#endif
 };
 
 class TCPServer {
@@ -99,6 +127,7 @@ class TCPClient {
                                             uint16_t port);
   ~TCPClient() { tcputils::close_socket(_socket); }
   void send_command_for_key(Command type, const std::string& key);
+  void send_string(const std::string& s);
 
   template <typename T>
   void send_value(const T& value);
@@ -134,6 +163,10 @@ class TCPStore : public Store {
   bool check(const std::string& key) override;
   void wait(const std::string& key) override;
   void set(const std::string& key, const std::vector<uint8_t>& value) override;
+  std::vector<std::vector<uint8_t>> multi_get(
+      const std::vector<std::string>& keys) override;
+  void multi_set(const std::vector<std::string>& keys,
+                 const std::vector<std::vector<uint8_t>>& values) override;
 
  private:
   void waitWorkers();
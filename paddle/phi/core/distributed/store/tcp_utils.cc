@@ -101,6 +101,18 @@ SocketType tcp_connect(const std::string host,
                             socket_error().message()));
 
       if (::connect(sockfd, cur->ai_addr, cur->ai_addrlen) == 0) {
+        // Requests are written field by field, don't let Nagle's algorithm
+        // hold the tail of a request back until the previous part is acked.
+        auto value = 1;
+#ifdef _WIN32
+        ::setsockopt(sockfd,
+                     IPPROTO_TCP,
+                     TCP_NODELAY,
+                     reinterpret_cast<const char*>(&value),
+                     sizeof(value));
+#else
+        ::setsockopt(sockfd, IPPROTO_TCP, TCP_NODELAY, &value, sizeof(value));
+#endif
         retry = false;
         break;
       }
@@ -223,6 +235,19 @@ std::string receive_string(SocketType socket) {
   return std::string(v.data(), v.size());
 }
 
+bool has_pending_data(SocketType socket) {
+#ifdef _WIN32
+  u_long available = 0;
+  if (::ioctlsocket(socket, FIONREAD, &available) != 0) {
+    return false;
+  }
+  return available > 0;
+#else
+  char buffer;
+  return ::recv(socket, &buffer, 1, MSG_PEEK | MSG_DONTWAIT) > 0;
+#endif
+}
+
 }  // namespace tcputils
 }  // namespace distributed
 }  // namespace phi
@@ -68,6 +68,8 @@ SocketType tcp_accept(SocketType socket);
 
 void send_string(SocketType socket, const std::string& s);
 std::string receive_string(SocketType socket);
+// Whether some bytes can be received from the socket without blocking.
+bool has_pending_data(SocketType socket);
 
 template <typename T>
 void send_bytes(SocketType socket, const T* buffer, size_t len) {
@@ -0,0 +1,448 @@
+//   Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/phi/core/platform/metrics.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <sstream>
+#include <thread>
+#include <unordered_map>
+
+#include "paddle/common/enforce.h"
+#include "paddle/common/errors.h"
+#include "paddle/phi/core/memory/stats.h"
+#include "paddle/phi/core/platform/monitor.h"
+
+PHI_DEFINE_EXPORTED_bool(
+    enable_metrics,
+    false,
+    "Record runtime metrics (operator latency, predictor latency, parameter "
+    "server latency and queue depth) in the metrics registry. Allocator and "
+    "STAT_* statistics are exported regardless of this flag.");
+
+namespace paddle {
+namespace platform {
+
+size_t MetricCounter::ShardIndex() {
+  thread_local size_t index =
+      std::hash<std::thread::id>()(std::this_thread::get_id()) % kNumShards;
+  return index;
+}
+
+double HistogramSnapshot::Quantile(double q) const {
+  if (count == 0) {
+    return 0;
+  }
+  double rank = std::min(std::max(q, 0.0), 1.0) * static_cast<double>(count);
+  for (size_t i = 0; i < bucket_counts.size(); ++i) {
+    if (static_cast<double>(bucket_counts[i]) < rank) {
+      continue;
+    }
+    // The +Inf bucket has no upper bound, report the largest finite one.
+    if (i == bounds.size()) {
+      return bounds.empty() ? 0 : bounds.back();
+    }
+    double lower = i == 0 ? 0 : bounds[i - 1];
+    uint64_t below = i == 0 ? 0 : bucket_counts[i - 1];
+    uint64_t in_bucket = bucket_counts[i] - below;
+    if (in_bucket == 0) {
+      return bounds[i];
+    }
+    return lower + (bounds[i] - lower) *
+                       (rank - static_cast<double>(below)) /
+                       static_cast<double>(in_bucket);
+  }
+  return bounds.empty() ? 0 : bounds.back();
+}
+
+MetricHistogram::MetricHistogram(std::vector<double> bounds)
+    : bounds_(std::move(bounds)) {
+  PADDLE_ENFORCE_EQ(
+      std::is_sorted(bounds_.begin(), bounds_.end()),
+      true,
+      common::errors::InvalidArgument(
+          "The bucket bounds of a histogram must be sorted."));
+  buckets_.reset(new std::atomic<uint64_t>[bounds_.size() + 1]);
+  for (size_t i = 0; i <= bounds_.size(); ++i) {
+    buckets_[i].store(0, std::memory_order_relaxed);
+  }
+}
+
+void MetricHistogram::Observe(double value) {
+  size_t index = std::lower_bound(bounds_.begin(), bounds_.end(), value) -
+                 bounds_.begin();
+  buckets_[index].fetch_add(1, std::memory_order_relaxed);
+  double sum = sum_.load(std::memory_order_relaxed);
+  while (!sum_.compare_exchange_weak(
+      sum, sum + value, std::memory_order_relaxed)) {
+  }
+  count_.fetch_add(1, std::memory_order_relaxed);
+}
+
+HistogramSnapshot MetricHistogram::Snapshot() const {
+  HistogramSnapshot snapshot;
+  snapshot.bounds = bounds_;
+  snapshot.bucket_counts.resize(bounds_.size() + 1);
+  uint64_t cumulative = 0;
+  for (size_t i = 0; i <= bounds_.size(); ++i) {
+    cumulative += buckets_[i].load(std::memory_order_relaxed);
+    snapshot.bucket_counts[i] = cumulative;
+  }
+  // The buckets are read one by one while being written, derive the count
+  // from them so that the snapshot is consistent.
+  snapshot.count = cumulative;
+  snapshot.sum = sum_.load(std::memory_order_relaxed);
+  return snapshot;
+}
+
+const std::vector<double>& MetricHistogram::LatencyBounds() {
+  static const std::vector<double> bounds = [] {
+    std::vector<double> result;
+    for (double decade = 1e-5; decade < 100; decade *= 10) {
+      result.push_back(decade);
+      result.push_back(decade * 2.5);
+      result.push_back(decade * 5);
+    }
+    result.push_back(100);
+    return result;
+  }();
+  return bounds;
+}
+
+struct MetricsRegistry::Family {
+  std::string name;
+  std::string help;
+  MetricType type;
+  // Keyed by the formatted labels.
+  std::map<std::string, std::pair<MetricLabels, std::shared_ptr<void>>>
+      metrics;
+};
+
+namespace {
+
+std::string EscapeLabelValue(const std::string& value) {
+  std::string result;
+  result.reserve(value.size());
+  for (char c : value) {
+    switch (c) {
+      case '\\':
+        result += "\\\\";
+        break;
+      case '"':
+        result += "\\\"";
+        break;
+      case '\n':
+        result += "\\n";
+        break;
+      default:
+        result += c;
+    }
+  }
+  return result;
+}
+
+// {name="value",...}, or an empty string without labels.
+std::string FormatLabels(const MetricLabels& labels,
+                         const std::string& extra_name = "",
+                         const std::string& extra_value = "") {
+  if (labels.empty() && extra_name.empty()) {
+    return "";
+  }
+  std::string result = "{";
+  for (auto& label : labels) {
+    if (result.size() > 1) {
+      result += ',';
+    }
+    result += label.first + "=\"" + EscapeLabelValue(label.second) + '"';
+  }
+  if (!extra_name.empty()) {
+    if (result.size() > 1) {
+      result += ',';
+    }
+    result += extra_name + "=\"" + extra_value + '"';
+  }
+  return result + '}';
+}
+
+std::string FormatValue(double value) {
+  if (std::isinf(value)) {
+    return value > 0 ? "+Inf" : "-Inf";
+  }
+  if (std::isnan(value)) {
+    return "NaN";
+  }
+  std::ostringstream os;
+  os.precision(17);
+  os << value;
+  return os.str();
+}
+
+const char* TypeName(MetricType type) {
+  switch (type) {
+    case MetricType::kCounter:
+      return "counter";
+    case MetricType::kGauge:
+      return "gauge";
+    case MetricType::kHistogram:
+      return "histogram";
+  }
+  return "untyped";
+}
+
+// Samples the STAT_* values of monitor.h and the allocator statistics.
+void CollectRuntimeStats(MetricsRegistry* registry) {
+  for (auto& stat : StatRegistry<int64_t>::Instance().publish()) {
+    registry
+        ->GetGauge("paddle_stat", "Values of the STAT_* monitor statistics.",
+                   {{"name", stat.key}})
+        ->Set(static_cast<double>(stat.value));
+  }
+  for (auto& stat : StatRegistry<float>::Instance().publish()) {
+    registry
+        ->GetGauge("paddle_stat", "Values of the STAT_* monitor statistics.",
+                   {{"name", stat.key}})
+        ->Set(stat.value);
+  }
+
+  const std::string current_help = "Bytes currently held by the allocator.";
+  const std::string peak_help = "Peak bytes held by the allocator.";
+  for (const char* stat_type : {"Allocated", "Reserved"}) {
+    MetricLabels labels = {{"device", "cpu"}, {"stat", stat_type}};
+    registry->GetGauge("paddle_memory_bytes", current_help, labels)
+        ->Set(static_cast<double>(
+            memory::HostMemoryStatCurrentValue(stat_type, 0)));
+    registry->GetGauge("paddle_memory_peak_bytes", peak_help, labels)
+        ->Set(static_cast<double>(
+            memory::HostMemoryStatPeakValue(stat_type, 0)));
+    // Device ids without stats are skipped, devices are not enumerated
+    // here to keep this file free of device runtime dependencies.
+    for (int dev_id = 0; dev_id < 16; ++dev_id) {
+      int64_t peak = memory::DeviceMemoryStatPeakValue(stat_type, dev_id);
+      if (peak == 0) {
+        continue;
+      }
+      labels[0].second = "gpu:" + std::to_string(dev_id);
+      registry->GetGauge("paddle_memory_bytes", current_help, labels)
+          ->Set(static_cast<double>(
+              memory::DeviceMemoryStatCurrentValue(stat_type, dev_id)));
+      registry->GetGauge("paddle_memory_peak_bytes", peak_help, labels)
+          ->Set(static_cast<double>(peak));
+    }
+  }
+}
+
+}  // namespace
+
+MetricsRegistry& MetricsRegistry::GetInstance() {
+  // Leaked on purpose, metrics may be updated by threads that outlive
+  // static destruction.
+  static MetricsRegistry* registry = new MetricsRegistry();
+  return *registry;
+}
+
+MetricsRegistry::MetricsRegistry() {
+  collectors_.push_back(CollectRuntimeStats);
+}
+
+MetricsRegistry::Family* MetricsRegistry::GetFamily(const std::string& name,
+                                                    const std::string& help,
+                                                    MetricType type) {
+  auto it = families_.find(name);
+  if (it == families_.end()) {
+    auto family = std::make_unique<Family>();
+    family->name = name;
+    family->help = help;
+    family->type = type;
+    it = families_.emplace(name, std::move(family)).first;
+  }
+  PADDLE_ENFORCE_EQ(
+      it->second->type == type,
+      true,
+      common::errors::AlreadyExists(
+          "The metric %s is already registered as a %s.",
+          name,
+          TypeName(it->second->type)));
+  return it->second.get();
+}
+
+template <typename T, typename... Args>
+T* MetricsRegistry::GetMetric(Family* family,
+                              const MetricLabels& labels,
+                              Args&&... args) {
+  auto& entry = family->metrics[FormatLabels(labels)];
+  if (entry.second == nullptr) {
+    entry.first = labels;
+    entry.second = std::make_shared<T>(std::forward<Args>(args)...);
+  }
+  return static_cast<T*>(entry.second.get());
+}
+
+MetricCounter* MetricsRegistry::GetCounter(const std::string& name,
+                                           const std::string& help,
+                                           const MetricLabels& labels) {
+  std::string key = FormatLabels(labels);
+  {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    auto it = families_.find(name);
+    if (it != families_.end() && it->second->type == MetricType::kCounter) {
+      auto metric = it->second->metrics.find(key);
+      if (metric != it->second->metrics.end()) {
+        return static_cast<MetricCounter*>(metric->second.second.get());
+      }
+    }
+  }
+  std::unique_lock<std::shared_mutex> lock(mutex_);
+  return GetMetric<MetricCounter>(
+      GetFamily(name, help, MetricType::kCounter), labels);
+}
+
+MetricGauge* MetricsRegistry::GetGauge(const std::string& name,
+                                       const std::string& help,
+                                       const MetricLabels& labels) {
+  std::string key = FormatLabels(labels);
+  {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    auto it = families_.find(name);
+    if (it != families_.end() && it->second->type == MetricType::kGauge) {
+      auto metric = it->second->metrics.find(key);
+      if (metric != it->second->metrics.end()) {
+        return static_cast<MetricGauge*>(metric->second.second.get());
+      }
+    }
+  }
+  std::unique_lock<std::shared_mutex> lock(mutex_);
+  return GetMetric<MetricGauge>(GetFamily(name, help, MetricType::kGauge),
+                                labels);
+}
+
+MetricHistogram* MetricsRegistry::GetHistogram(
+    const std::string& name,
+    const std::string& help,
+    const MetricLabels& labels,
+    const std::vector<double>& bounds) {
+  std::string key = FormatLabels(labels);
+  {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    auto it = families_.find(name);
+    if (it != families_.end() && it->second->type == MetricType::kHistogram) {
+      auto metric = it->second->metrics.find(key);
+      if (metric != it->second->metrics.end()) {
+        return static_cast<MetricHistogram*>(metric->second.second.get());
+      }
+    }
+  }
+  std::unique_lock<std::shared_mutex> lock(mutex_);
+  return GetMetric<MetricHistogram>(
+      GetFamily(name, help, MetricType::kHistogram),
+      labels,
+      bounds.empty() ? MetricHistogram::LatencyBounds() : bounds);
+}
+
+void MetricsRegistry::RegisterCollector(Collector collector) {
+  std::lock_guard<std::mutex> lock(collectors_mutex_);
+  collectors_.push_back(std::move(collector));
+}
+
+std::vector<MetricFamilySnapshot> MetricsRegistry::Snapshot() {
+  {
+    std::lock_guard<std::mutex> lock(collectors_mutex_);
+    for (auto& collector : collectors_) {
+      collector(this);
+    }
+  }
+  std::shared_lock<std::shared_mutex> lock(mutex_);
+  std::vector<MetricFamilySnapshot> result;
+  result.reserve(families_.size());
+  for (auto& name_and_family : families_) {
+    const Family& family = *name_and_family.second;
+    MetricFamilySnapshot snapshot;
+    snapshot.name = family.name;
+    snapshot.help = family.help;
+    snapshot.type = family.type;
+    for (auto& key_and_metric : family.metrics) {
+      MetricSample sample;
+      sample.labels = key_and_metric.second.first;
+      void* metric = key_and_metric.second.second.get();
+      switch (family.type) {
+        case MetricType::kCounter:
+          sample.value = static_cast<double>(
+              static_cast<MetricCounter*>(metric)->Value());
+          break;
+        case MetricType::kGauge:
+          sample.value = static_cast<MetricGauge*>(metric)->Value();
+          break;
+        case MetricType::kHistogram:
+          sample.histogram = static_cast<MetricHistogram*>(metric)->Snapshot();
+          break;
+      }
+      snapshot.samples.push_back(std::move(sample));
+    }
+    result.push_back(std::move(snapshot));
+  }
+  return result;
+}
+
+std::string ToPrometheusText(
+    const std::vector<MetricFamilySnapshot>& families) {
+  std::ostringstream os;
+  for (auto& family : families) {
+    os << "# HELP " << family.name << ' ' << family.help << '\n';
+    os << "# TYPE " << family.name << ' ' << TypeName(family.type) << '\n';
+    for (auto& sample : family.samples) {
+      if (family.type != MetricType::kHistogram) {
+        os << family.name << FormatLabels(sample.labels) << ' '
+           << FormatValue(sample.value) << '\n';
+        continue;
+      }
+      const HistogramSnapshot& histogram = sample.histogram;
+      for (size_t i = 0; i < histogram.bucket_counts.size(); ++i) {
+        double bound = i < histogram.bounds.size()
+                           ? histogram.bounds[i]
+                           : std::numeric_limits<double>::infinity();
+        os << family.name << "_bucket"
+           << FormatLabels(sample.labels, "le", FormatValue(bound)) << ' '
+           << histogram.bucket_counts[i] << '\n';
+      }
+      std::string labels = FormatLabels(sample.labels);
+      os << family.name << "_sum" << labels << ' '
+         << FormatValue(histogram.sum) << '\n';
+      os << family.name << "_count" << labels << ' ' << histogram.count
+         << '\n';
+    }
+  }
+  return os.str();
+}
+
+MetricHistogram* OpLatencyHistogram(const std::string& op_type) {
+  if (!MetricsRegistry::IsEnabled()) {
+    return nullptr;
+  }
+  // Avoids the registry lock on every operator run.
+  thread_local std::unordered_map<std::string, MetricHistogram*> cache;
+  auto it = cache.find(op_type);
+  if (it != cache.end()) {
+    return it->second;
+  }
+  MetricHistogram* histogram = MetricsRegistry::GetInstance().GetHistogram(
+      "paddle_op_latency_seconds",
+      "Host side latency of running an operator.",
+      {{"op", op_type}});
+  cache.emplace(op_type, histogram);
+  return histogram;
+}
+
+}  // namespace platform
+}  // namespace paddle
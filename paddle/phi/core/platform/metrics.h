@@ -0,0 +1,242 @@
+//   Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <shared_mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "paddle/common/flags.h"
+#include "paddle/common/macros.h"
+#include "paddle/utils/test_macros.h"
+
+COMMON_DECLARE_bool(enable_metrics);
+
+namespace paddle {
+namespace platform {
+
+// Label names and values of one time series, e.g. {{"op", "matmul"}}.
+using MetricLabels = std::vector<std::pair<std::string, std::string>>;
+
+enum class MetricType { kCounter, kGauge, kHistogram };
+
+// A monotonically increasing counter. Increments go to one of several cache
+// line sized shards chosen by the calling thread, so concurrent writers do
+// not contend on a single atomic.
+class MetricCounter {
+ public:
+  MetricCounter() = default;
+
+  void Increment(int64_t value = 1) {
+    shards_[ShardIndex()].value.fetch_add(value, std::memory_order_relaxed);
+  }
+
+  int64_t Value() const {
+    int64_t sum = 0;
+    for (auto& shard : shards_) {
+      sum += shard.value.load(std::memory_order_relaxed);
+    }
+    return sum;
+  }
+
+ private:
+  static constexpr size_t kNumShards = 16;
+
+  struct alignas(64) Shard {
+    std::atomic<int64_t> value{0};
+  };
+
+  TEST_API static size_t ShardIndex();
+
+  Shard shards_[kNumShards];
+
+  DISABLE_COPY_AND_ASSIGN(MetricCounter);
+};
+
+// A value that can go up and down, e.g. a queue depth or allocated bytes.
+class MetricGauge {
+ public:
+  MetricGauge() = default;
+
+  void Set(double value) { value_.store(value, std::memory_order_relaxed); }
+
+  void Add(double value) {
+    double old_value = value_.load(std::memory_order_relaxed);
+    while (!value_.compare_exchange_weak(
+        old_value, old_value + value, std::memory_order_relaxed)) {
+    }
+  }
+
+  double Value() const { return value_.load(std::memory_order_relaxed); }
+
+ private:
+  std::atomic<double> value_{0};
+
+  DISABLE_COPY_AND_ASSIGN(MetricGauge);
+};
+
+struct HistogramSnapshot {
+  // Upper bounds of the buckets, the last bucket (+Inf) is implicit.
+  std::vector<double> bounds;
+  // Cumulative counts, bucket_counts[i] observations were <= bounds[i].
+  // bucket_counts.back() == count.
+  std::vector<uint64_t> bucket_counts;
+  uint64_t count = 0;
+  double sum = 0;
+
+  // Estimates the q-th quantile (0 <= q <= 1) by linear interpolation in
+  // the bucket which contains it.
+  TEST_API double Quantile(double q) const;
+};
+
+// A histogram with fixed bucket bounds. Observe() is lock free: it finds the
+// bucket by binary search and updates three relaxed atomics.
+class MetricHistogram {
+ public:
+  TEST_API explicit MetricHistogram(std::vector<double> bounds);
+
+  TEST_API void Observe(double value);
+
+  TEST_API HistogramSnapshot Snapshot() const;
+
+  // Exponential buckets from 10us to 100s, for latencies in seconds.
+  TEST_API static const std::vector<double>& LatencyBounds();
+
+ private:
+  std::vector<double> bounds_;
+  // bounds_.size() + 1 buckets, not cumulative.
+  std::unique_ptr<std::atomic<uint64_t>[]> buckets_;
+  std::atomic<uint64_t> count_{0};
+  std::atomic<double> sum_{0};
+
+  DISABLE_COPY_AND_ASSIGN(MetricHistogram);
+};
+
+struct MetricSample {
+  MetricLabels labels;
+  // Value of a counter or gauge.
+  double value = 0;
+  HistogramSnapshot histogram;
+};
+
+struct MetricFamilySnapshot {
+  std::string name;
+  std::string help;
+  MetricType type;
+  std::vector<MetricSample> samples;
+};
+
+// Process wide registry of metrics.
+//
+// A metric is identified by its name and labels. Get*() creates it on first
+// use and returns a pointer that stays valid for the lifetime of the
+// process, so hot paths should look a metric up once and keep the pointer.
+// Lookups of existing metrics only take a shared lock.
+//
+// Statistics kept elsewhere (StatRegistry, the allocator stats) are sampled
+// by collectors, which run before every Snapshot().
+class MetricsRegistry {
+ public:
+  using Collector = std::function<void(MetricsRegistry*)>;
+
+  TEST_API static MetricsRegistry& GetInstance();
+
+  static bool IsEnabled() { return FLAGS_enable_metrics; }
+
+  TEST_API MetricCounter* GetCounter(const std::string& name,
+                                     const std::string& help,
+                                     const MetricLabels& labels = {});
+
+  TEST_API MetricGauge* GetGauge(const std::string& name,
+                                 const std::string& help,
+                                 const MetricLabels& labels = {});
+
+  // `bounds` is only used when the histogram is created, defaults to
+  // MetricHistogram::LatencyBounds().
+  TEST_API MetricHistogram* GetHistogram(
+      const std::string& name,
+      const std::string& help,
+      const MetricLabels& labels = {},
+      const std::vector<double>& bounds = {});
+
+  TEST_API void RegisterCollector(Collector collector);
+
+  // Runs the collectors and returns all metrics, sorted by name.
+  TEST_API std::vector<MetricFamilySnapshot> Snapshot();
+
+ private:
+  struct Family;
+
+  MetricsRegistry();
+
+  Family* GetFamily(const std::string& name,
+                    const std::string& help,
+                    MetricType type);
+
+  template <typename T, typename... Args>
+  T* GetMetric(Family* family, const MetricLabels& labels, Args&&... args);
+
+  std::shared_mutex mutex_;
+  std::map<std::string, std::unique_ptr<Family>> families_;
+
+  std::mutex collectors_mutex_;
+  std::vector<Collector> collectors_;
+
+  DISABLE_COPY_AND_ASSIGN(MetricsRegistry);
+};
+
+// Formats a snapshot in the Prometheus text exposition format 0.0.4.
+TEST_API std::string ToPrometheusText(
+    const std::vector<MetricFamilySnapshot>& families);
+
+// Observes the seconds elapsed between construction and destruction in
+// `histogram`, does nothing if `histogram` is null.
+class ScopedLatencyTimer {
+ public:
+  explicit ScopedLatencyTimer(MetricHistogram* histogram)
+      : histogram_(histogram) {
+    if (histogram_ != nullptr) {
+      start_ = std::chrono::steady_clock::now();
+    }
+  }
+
+  ~ScopedLatencyTimer() {
+    if (histogram_ != nullptr) {
+      std::chrono::duration<double> elapsed =
+          std::chrono::steady_clock::now() - start_;
+      histogram_->Observe(elapsed.count());
+    }
+  }
+
+ private:
+  MetricHistogram* histogram_;
+  std::chrono::steady_clock::time_point start_;
+
+  DISABLE_COPY_AND_ASSIGN(ScopedLatencyTimer);
+};
+
+// Latency histogram of the operator `op_type`, shared by the executors.
+// Returns null if FLAGS_enable_metrics is off.
+TEST_API MetricHistogram* OpLatencyHistogram(const std::string& op_type);
+
+}  // namespace platform
+}  // namespace paddle
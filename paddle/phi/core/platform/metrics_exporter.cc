@@ -0,0 +1,272 @@
+//   Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/phi/core/platform/metrics_exporter.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+
+#ifndef _WIN32
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+#include "glog/logging.h"
+
+PHI_DEFINE_EXPORTED_int32(
+    metrics_http_port,
+    0,
+    "Serve the runtime metrics in the Prometheus text format at "
+    "http://<FLAGS_metrics_http_host>:<port>/metrics, 0 to disable.");
+PHI_DEFINE_EXPORTED_string(metrics_http_host,
+                           "127.0.0.1",
+                           "The address the metrics endpoint listens on.");
+PHI_DEFINE_EXPORTED_string(
+    metrics_file,
+    "",
+    "Periodically write the runtime metrics in the Prometheus text format to "
+    "this file, empty to disable.");
+PHI_DEFINE_EXPORTED_int32(
+    metrics_export_interval_s,
+    10,
+    "Interval in seconds between two writes of FLAGS_metrics_file.");
+
+namespace paddle {
+namespace platform {
+
+void FileMetricsSink::Export(
+    const std::vector<MetricFamilySnapshot>& families) {
+  std::string tmp_path = path_ + ".tmp";
+  {
+    std::ofstream ofs(tmp_path, std::ios::out | std::ios::trunc);
+    if (!ofs.is_open()) {
+      LOG_FIRST_N(WARNING, 1) << "Can not open " << tmp_path
+                              << " to export metrics.";
+      return;
+    }
+    ofs << ToPrometheusText(families);
+  }
+  if (std::rename(tmp_path.c_str(), path_.c_str()) != 0) {
+    LOG_FIRST_N(WARNING, 1) << "Can not rename " << tmp_path << " to "
+                            << path_ << ".";
+  }
+}
+
+#ifndef _WIN32
+bool MetricsHttpServer::Start(const std::string& host, int port) {
+  if (listen_fd_ >= 0) {
+    return true;
+  }
+  sockaddr_in addr{};
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(static_cast<uint16_t>(port));
+  if (inet_pton(AF_INET, host.c_str(), &addr.sin_addr) != 1) {
+    LOG(WARNING) << "Invalid metrics http host " << host << ".";
+    return false;
+  }
+  int fd = socket(AF_INET, SOCK_STREAM, 0);
+  if (fd < 0) {
+    return false;
+  }
+  int one = 1;
+  setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+  socklen_t len = sizeof(addr);
+  if (bind(fd, reinterpret_cast<sockaddr*>(&addr), len) != 0 ||
+      listen(fd, 16) != 0 ||
+      getsockname(fd, reinterpret_cast<sockaddr*>(&addr), &len) != 0) {
+    LOG(WARNING) << "Can not listen on " << host << ":" << port
+                 << " for metrics.";
+    close(fd);
+    return false;
+  }
+  listen_fd_ = fd;
+  port_ = ntohs(addr.sin_port);
+  stop_ = false;
+  thread_ = std::thread([this]() { Loop(); });
+  VLOG(1) << "Serving metrics at http://" << host << ":" << port_
+          << "/metrics";
+  return true;
+}
+
+void MetricsHttpServer::Stop() {
+  if (listen_fd_ < 0) {
+    return;
+  }
+  stop_ = true;
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+  close(listen_fd_);
+  listen_fd_ = -1;
+  port_ = 0;
+}
+
+void MetricsHttpServer::Loop() {
+  while (!stop_) {
+    // Wakes up regularly to check stop_.
+    pollfd pfd{listen_fd_, POLLIN, 0};
+    if (poll(&pfd, 1, 100) <= 0) {
+      continue;
+    }
+    int fd = accept(listen_fd_, nullptr, nullptr);
+    if (fd >= 0) {
+      HandleConnection(fd);
+      close(fd);
+    }
+  }
+}
+
+void MetricsHttpServer::HandleConnection(int fd) {
+  // Only the request line matters, read until the end of the headers.
+  std::string request;
+  char buffer[1024];
+  while (request.find("\r\n\r\n") == std::string::npos &&
+         request.size() < 8192) {
+    pollfd pfd{fd, POLLIN, 0};
+    if (poll(&pfd, 1, 1000) <= 0) {
+      return;
+    }
+    ssize_t n = recv(fd, buffer, sizeof(buffer), 0);
+    if (n <= 0) {
+      return;
+    }
+    request.append(buffer, n);
+  }
+
+  std::string status = "200 OK";
+  std::string body;
+  if (request.compare(0, 13, "GET /metrics ") == 0 ||
+      request.compare(0, 14, "GET /metrics? ") == 0) {
+    body = ToPrometheusText(MetricsRegistry::GetInstance().Snapshot());
+  } else {
+    status = "404 Not Found";
+    body = "Only GET /metrics is supported.\n";
+  }
+  std::string response = "HTTP/1.1 " + status +
+                         "\r\nContent-Type: text/plain; version=0.0.4"
+                         "\r\nContent-Length: " +
+                         std::to_string(body.size()) +
+                         "\r\nConnection: close\r\n\r\n" + body;
+  size_t sent = 0;
+  while (sent < response.size()) {
+    ssize_t n = send(fd, response.data() + sent, response.size() - sent, 0);
+    if (n <= 0) {
+      return;
+    }
+    sent += n;
+  }
+}
+#else
+bool MetricsHttpServer::Start(const std::string& host, int port) {
+  LOG(WARNING) << "The metrics http endpoint is not supported on Windows, "
+                  "use FLAGS_metrics_file instead.";
+  return false;
+}
+
+void MetricsHttpServer::Stop() {}
+
+void MetricsHttpServer::Loop() {}
+
+void MetricsHttpServer::HandleConnection(int fd) {}
+#endif
+
+MetricsExporter& MetricsExporter::GetInstance() {
+  // Leaked on purpose, the threads may still be running at exit.
+  static MetricsExporter* exporter = new MetricsExporter();
+  return *exporter;
+}
+
+void MetricsExporter::StartFromFlags() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (started_from_flags_) {
+      return;
+    }
+    started_from_flags_ = true;
+  }
+  if (FLAGS_metrics_http_port > 0) {
+    StartHttpServer(FLAGS_metrics_http_host, FLAGS_metrics_http_port);
+  }
+  if (!FLAGS_metrics_file.empty()) {
+    AddSink(std::make_unique<FileMetricsSink>(FLAGS_metrics_file));
+  }
+}
+
+bool MetricsExporter::StartHttpServer(const std::string& host, int port) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return http_server_.Start(host, port);
+}
+
+void MetricsExporter::AddSink(std::unique_ptr<MetricsSink> sink) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  sinks_.push_back(std::move(sink));
+  if (!export_thread_.joinable()) {
+    stop_ = false;
+    export_thread_ = std::thread([this]() { ExportLoop(); });
+  }
+}
+
+void MetricsExporter::ExportOnce() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (sinks_.empty()) {
+    return;
+  }
+  auto families = MetricsRegistry::GetInstance().Snapshot();
+  for (auto& sink : sinks_) {
+    sink->Export(families);
+  }
+}
+
+void MetricsExporter::ExportLoop() {
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      cv_.wait_for(
+          lock,
+          std::chrono::seconds(std::max(FLAGS_metrics_export_interval_s, 1)),
+          [this]() { return stop_; });
+      if (stop_) {
+        break;
+      }
+    }
+    ExportOnce();
+  }
+}
+
+void MetricsExporter::Stop() {
+  std::thread export_thread;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+    export_thread = std::move(export_thread_);
+    http_server_.Stop();
+  }
+  cv_.notify_all();
+  if (export_thread.joinable()) {
+    export_thread.join();
+  }
+  // Leaves the final values behind.
+  ExportOnce();
+  std::lock_guard<std::mutex> lock(mutex_);
+  sinks_.clear();
+  started_from_flags_ = false;
+}
+
+}  // namespace platform
+}  // namespace paddle
@@ -0,0 +1,131 @@
+//   Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "paddle/common/flags.h"
+#include "paddle/common/macros.h"
+#include "paddle/phi/core/platform/metrics.h"
+#include "paddle/utils/test_macros.h"
+
+COMMON_DECLARE_int32(metrics_http_port);
+COMMON_DECLARE_string(metrics_http_host);
+COMMON_DECLARE_string(metrics_file);
+COMMON_DECLARE_int32(metrics_export_interval_s);
+
+namespace paddle {
+namespace platform {
+
+// Destination of the periodic metrics export.
+class MetricsSink {
+ public:
+  virtual ~MetricsSink() = default;
+
+  virtual void Export(const std::vector<MetricFamilySnapshot>& families) = 0;
+};
+
+// Rewrites `path` with the Prometheus text format on every export, e.g. for
+// the textfile collector of the node exporter. The file is replaced
+// atomically, readers never see a partial export.
+class FileMetricsSink : public MetricsSink {
+ public:
+  explicit FileMetricsSink(const std::string& path) : path_(path) {}
+
+  TEST_API void Export(
+      const std::vector<MetricFamilySnapshot>& families) override;
+
+ private:
+  std::string path_;
+};
+
+// Serves the registry in the Prometheus text format at GET /metrics.
+class MetricsHttpServer {
+ public:
+  MetricsHttpServer() = default;
+  ~MetricsHttpServer() { Stop(); }
+
+  // Listens on `host`:`port`, an ephemeral port if `port` is 0. Returns
+  // false if the socket can not be bound.
+  TEST_API bool Start(const std::string& host, int port);
+
+  TEST_API void Stop();
+
+  // The port listened on, 0 if the server is not running.
+  int Port() const { return port_; }
+
+ private:
+  void Loop();
+
+  void HandleConnection(int fd);
+
+  int listen_fd_ = -1;
+  int port_ = 0;
+  std::atomic<bool> stop_{false};
+  std::thread thread_;
+
+  DISABLE_COPY_AND_ASSIGN(MetricsHttpServer);
+};
+
+// Owns the HTTP endpoint and the sinks of the process.
+//
+// StartFromFlags() starts what the flags ask for:
+// - FLAGS_metrics_http_port > 0: an HTTP endpoint on
+//   FLAGS_metrics_http_host,
+// - FLAGS_metrics_file not empty: a FileMetricsSink,
+// and exports to the sinks every FLAGS_metrics_export_interval_s seconds.
+class MetricsExporter {
+ public:
+  TEST_API static MetricsExporter& GetInstance();
+
+  // Idempotent, called by the predictor and the Python frontend.
+  TEST_API void StartFromFlags();
+
+  TEST_API bool StartHttpServer(const std::string& host, int port);
+
+  int HttpPort() const { return http_server_.Port(); }
+
+  // Adds a sink and starts the export thread if needed.
+  TEST_API void AddSink(std::unique_ptr<MetricsSink> sink);
+
+  // Exports to every sink now.
+  TEST_API void ExportOnce();
+
+  TEST_API void Stop();
+
+ private:
+  MetricsExporter() = default;
+
+  void ExportLoop();
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  bool started_from_flags_ = false;
+  bool stop_ = false;
+  std::vector<std::unique_ptr<MetricsSink>> sinks_;
+  std::thread export_thread_;
+  MetricsHttpServer http_server_;
+
+  DISABLE_COPY_AND_ASSIGN(MetricsExporter);
+};
+
+}  // namespace platform
+}  // namespace paddle
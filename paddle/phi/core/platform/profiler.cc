@@ -25,6 +25,7 @@
 #include "paddle/fluid/platform/profiler/host_tracer.h"
 #include "paddle/fluid/platform/profiler/profiler.h"
 #include "paddle/phi/api/profiler/device_tracer.h"
+#include "paddle/phi/api/profiler/flight_recorder.h"
 #include "paddle/phi/core/platform/profiler/host_event_recorder.h"
 #include "paddle/phi/core/platform/profiler_helper.h"
 #ifdef PADDLE_WITH_CUDA
@@ -128,6 +129,10 @@ RecordMemEvent::RecordMemEvent(const void *ptr,
                                const phi::Place &place,
                                size_t size,
                                const phi::TracerMemEventType type) {
+  if (UNLIKELY(FLAGS_enable_flight_recorder)) {
+    phi::FlightRecorder::GetInstance().RecordMemEvent(
+        phi::PosixInNsec(), size, type);
+  }
   if (phi::ProfilerHelper::g_state == ProfilerState::kDisabled &&
       FLAGS_enable_host_event_recorder_hook == false) {
     return;
@@ -170,4 +170,22 @@ const char* StringTracerEventType(phi::TracerEventType type) {
   }
 }
 
+std::string json_perf_counters(const phi::PerfCounterValues& counters) {
+  if (!counters.valid) {
+    return "null";
+  }
+  std::ostringstream res_stream;
+  res_stream << "{";
+  if (counters.hardware) {
+    res_stream << "\"cycles\":" << counters.cycles
+               << ",\"instructions\":" << counters.instructions
+               << ",\"cache_references\":" << counters.cache_references
+               << ",\"cache_misses\":" << counters.cache_misses
+               << ",\"bytes_moved\":" << counters.BytesMoved() << ",";
+  }
+  res_stream << "\"task_clock_ns\":" << counters.task_clock_ns
+             << ",\"page_faults\":" << counters.page_faults << "}";
+  return res_stream.str();
+}
+
 }  // namespace paddle::platform
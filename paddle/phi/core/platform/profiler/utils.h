@@ -117,6 +117,10 @@ const char* StringTracerMemEventType(phi::TracerMemEventType type);
 
 const char* StringTracerEventType(phi::TracerEventType type);
 
+// JSON object of the performance counters of a host event, "null" if they
+// were not collected.
+std::string json_perf_counters(const phi::PerfCounterValues& counters);
+
 static float nsToUsFloat(uint64_t end_ns, uint64_t start_ns = 0) {
   return static_cast<float>(end_ns - start_ns) / 1000;
 }
@@ -4935,6 +4935,60 @@ void FusedSeqpoolCvmGradInferMeta(
   }
 }
 
+void FusedEmbeddingSeqpoolCvmInferMeta(
+    const std::vector<const MetaTensor*>& ids,
+    const MetaTensor& w,
+    const MetaTensor& w_scale,
+    const std::string& pooltype,
+    float pad_value,
+    bool use_cvm,
+    int cvm_offset,
+    int64_t padding_idx,
+    std::vector<MetaTensor*> out) {
+  PADDLE_ENFORCE_GE(
+      ids.size(),
+      1UL,
+      common::errors::InvalidArgument(
+          "Inputs(Ids) of FusedEmbeddingSeqpoolCvmOp should not be empty."));
+  const auto& w_dims = w.dims();
+  PADDLE_ENFORCE_EQ(w_dims.size(),
+                    2,
+                    common::errors::InvalidArgument(
+                        "The rank of Input(W) should be 2, but received %d.",
+                        w_dims.size()));
+  if (w_scale) {
+    PADDLE_ENFORCE_EQ(w.dtype(),
+                      DataType::INT8,
+                      common::errors::InvalidArgument(
+                          "Input(WScale) is only used by an int8 Input(W), "
+                          "but Input(W) is %s.",
+                          w.dtype()));
+  }
+  int64_t width = w_dims[1];
+  if (use_cvm) {
+    PADDLE_ENFORCE_GT(width,
+                      2,
+                      common::errors::InvalidArgument(
+                          "The width of Input(W) should be larger than 2 to "
+                          "use CVM, but received %d.",
+                          width));
+  }
+  for (size_t i = 0; i < ids.size(); ++i) {
+    PADDLE_ENFORCE_EQ(
+        ids[i]->dtype() == DataType::INT32 ||
+            ids[i]->dtype() == DataType::INT64,
+        true,
+        common::errors::InvalidArgument(
+            "The dtype of Input(Ids) should be int32 or int64, but the dtype "
+            "of the %d-th ids is %s.",
+            i,
+            ids[i]->dtype()));
+    // The batch size is given by the lod of the ids, only known at runtime.
+    out[i]->set_dims({-1, use_cvm ? width : width - cvm_offset});
+    out[i]->set_dtype(DataType::FLOAT32);
+  }
+}
+
 void FusionSeqpoolCvmConcatInferMeta(const std::vector<const MetaTensor*>& x,
                                      const MetaTensor& cvm,
                                      const std::string& pooltype,
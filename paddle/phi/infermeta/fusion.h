@@ -1192,6 +1192,17 @@ void FusedSeqpoolCvmGradInferMeta(
     MetaTensor* cvm_grad,
     MetaConfig config = MetaConfig());
 
+void FusedEmbeddingSeqpoolCvmInferMeta(
+    const std::vector<const MetaTensor*>& ids,
+    const MetaTensor& w,
+    const MetaTensor& w_scale,
+    const std::string& pooltype,
+    float pad_value,
+    bool use_cvm,
+    int cvm_offset,
+    int64_t padding_idx,
+    std::vector<MetaTensor*> out);
+
 void FusionSeqpoolConcatInferMeta(const std::vector<const MetaTensor*>& x,
                                   const std::string& pooltype,
                                   int axis,
@@ -79,23 +79,23 @@ struct SparseAdagradFunctor<phi::CPUContext, T> {
     auto& merge_rows = grad_merge.rows();
     auto* grad_merge_data = grad_merge.mutable_value()->template data<T>();
 
-    // 2. m += g_m * g_m
-    auto grad_square =
-        SquareSelectedRows<phi::CPUContext, T>(context, grad_merge);
-
-    phi::funcs::SelectedRowsAddToTensor<phi::CPUContext, T> functor;
-    functor(context, grad_square, moment);
-
-    // 3. update parameter
+    // 2. m += g_m * g_m and update parameter, only the merged rows are
+    // touched. They are unique, so they are updated in parallel.
     auto* lr = learning_rate.data<T>();
     auto* param_data = param->data<T>();
     auto* moment_data = moment->data<T>();
-
-    for (size_t i = 0; i < merge_rows.size(); i++) {
+    int64_t row_count = static_cast<int64_t>(merge_rows.size());
+
+#ifdef PADDLE_WITH_MKLML
+#pragma omp parallel for
+#endif
+    for (int64_t i = 0; i < row_count; i++) {
+      const T* g = grad_merge_data + i * grad_width;
+      int64_t offset = merge_rows[i] * grad_width;
       for (int64_t j = 0; j < grad_width; j++) {
-        param_data[merge_rows[i] * grad_width + j] -=
-            lr[0] * grad_merge_data[i * grad_width + j] /
-            (std::sqrt(moment_data[merge_rows[i] * grad_width + j]) + epsilon);
+        T m = moment_data[offset + j] + g[j] * g[j];
+        moment_data[offset + j] = m;
+        param_data[offset + j] -= lr[0] * g[j] / (std::sqrt(m) + epsilon);
       }
     }
   }
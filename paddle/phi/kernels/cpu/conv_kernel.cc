@@ -16,6 +16,9 @@
 
 #include "paddle/phi/backends/cpu/cpu_context.h"
 #include "paddle/phi/core/kernel_registry.h"
+#include "paddle/phi/kernels/cpu/conv_util.h"
+#include "paddle/phi/kernels/funcs/direct_conv_cpu.h"
+#include "paddle/phi/kernels/funcs/packed_gemm_cache.h"
 #include "paddle/phi/kernels/impl/conv_kernel_impl.h"
 
 namespace phi {
@@ -31,6 +34,65 @@ void ConvKernel(const Context& dev_ctx,
                 int groups,
                 const std::string& data_format,
                 DenseTensor* out) {
+  if (FLAGS_use_direct_conv_cpu && input.dims().size() == 4) {
+    const bool channel_last = data_format == "NHWC";
+    const auto& in_dims = input.dims();
+    const auto& out_dims = out->dims();
+    const auto& filter_dims = filter.dims();
+    const DDim in_data_dims = channel_last ? slice_ddim(in_dims, 1, 3)
+                                           : slice_ddim(in_dims, 2, 4);
+    std::vector<int> ksize = {static_cast<int>(filter_dims[2]),
+                              static_cast<int>(filter_dims[3])};
+    std::vector<int> new_paddings = paddings;
+    std::vector<int> new_dilations = dilations;
+    UpdatePaddingAndDilation(&new_paddings,
+                             &new_dilations,
+                             padding_algorithm,
+                             in_data_dims,
+                             strides,
+                             ksize);
+    funcs::Conv2dShape shape;
+    shape.batch = in_dims[0];
+    shape.in_c = channel_last ? in_dims[3] : in_dims[1];
+    shape.in_h = in_data_dims[0];
+    shape.in_w = in_data_dims[1];
+    shape.out_c = filter_dims[0];
+    shape.out_h = channel_last ? out_dims[1] : out_dims[2];
+    shape.out_w = channel_last ? out_dims[2] : out_dims[3];
+    shape.kernel_h = ksize[0];
+    shape.kernel_w = ksize[1];
+    shape.stride_h = strides[0];
+    shape.stride_w = strides[1];
+    // The paddings are [top, bottom, left, right] now.
+    shape.pad_top = new_paddings[0];
+    shape.pad_left = new_paddings[2];
+    shape.dilation_h = new_dilations[0];
+    shape.dilation_w = new_dilations[1];
+    shape.groups = groups;
+    auto algo = funcs::SelectDirectConvAlgo(
+        shape,
+        channel_last,
+        funcs::DirectConvThreads(),
+        funcs::PackedWeightCache::Instance().IsConstant(filter));
+#if !defined(_OPENMP)
+    // Without OpenMP the direct convolution runs on one thread, while the
+    // GEMM of im2col runs on the threads of the BLAS.
+    if (algo != funcs::DirectConvAlgo::kGemm) {
+      algo = funcs::DirectConvAlgo::kNone;
+    }
+#endif
+    if (algo != funcs::DirectConvAlgo::kNone) {
+      T* out_data = dev_ctx.template Alloc<T>(out);
+      funcs::DirectConv2d<T>(dev_ctx,
+                             shape,
+                             channel_last,
+                             algo,
+                             input.data<T>(),
+                             filter,
+                             out_data);
+      return;
+    }
+  }
   ConvKernelImpl<T>(dev_ctx,
                     input,
                     filter,
@@ -15,19 +15,13 @@
 #include "paddle/phi/kernels/fused_adam_kernel.h"
 #include <vector>
 
+#include "paddle/phi/backends/cpu/cpu_context.h"
 #include "paddle/phi/core/kernel_registry.h"
 #include "paddle/phi/core/tensor_utils.h"
-
-#include "paddle/phi/kernels/adam_kernel.h"
-#include "paddle/phi/kernels/adamw_kernel.h"
+#include "paddle/phi/kernels/cpu/multi_tensor_adam_impl.h"
 
 namespace phi {
 
-static paddle::optional<DenseTensor> TensorPtrToOptionalTensor(
-    const paddle::optional<std::vector<const DenseTensor*>>& t, size_t idx) {
-  return t ? paddle::optional<DenseTensor>(*(t.get()[idx])) : paddle::none;
-}
-
 template <typename T, typename Context>
 void FusedAdamKernel(
     const Context& dev_ctx,
@@ -110,71 +104,77 @@ void FusedAdamKernel(
                         beta2_pows.size(),
                         params_num));
 
-  for (size_t idx = 0; idx < params_num; idx++) {
-    auto master_params_tmp = TensorPtrToOptionalTensor(master_params, idx);
-    auto moments2_max_tmp = TensorPtrToOptionalTensor(moments2_max, idx);
-
-    if (!use_adamw) {
-      AdamDenseKernel<T, Context>(
-          dev_ctx,
-          *params[idx],
-          *grads[idx],
-          learning_rate,
-          *moments1[idx],
-          *moments2[idx],
-          moments2_max_tmp,
-          *beta1_pows[idx],
-          *beta2_pows[idx],
-          master_params_tmp,
-          skip_update,
-          beta1,
-          beta2,
-          epsilon,
-          false,
-          1000,
-          multi_precision,
-          use_global_beta_pow,
-          amsgrad,
-          params_out[idx],
-          moments1_out[idx],
-          moments2_out[idx],
-          amsgrad ? moments2_max_out[idx] : nullptr,
-          beta1_pows_out[idx],
-          beta2_pows_out[idx],
-          master_params_out.empty() ? nullptr : master_params_out[idx]);
-    } else {
-      AdamwDenseKernel<T, Context>(
-          dev_ctx,
-          *params[idx],
-          *grads[idx],
-          learning_rate,
-          *moments1[idx],
-          *moments2[idx],
-          moments2_max_tmp,
-          *beta1_pows[idx],
-          *beta2_pows[idx],
-          master_params_tmp,
-          skip_update,
-          beta1,
-          beta2,
-          epsilon,
-          1.0,
-          weight_decay,
-          use_adamw,
-          false,
-          1000,
-          multi_precision,
-          use_global_beta_pow,
-          amsgrad,
-          params_out[idx],
-          moments1_out[idx],
-          moments2_out[idx],
-          amsgrad ? moments2_max_out[idx] : nullptr,
-          beta1_pows_out[idx],
-          beta2_pows_out[idx],
-          master_params_out.empty() ? nullptr : master_params_out[idx]);
+  bool skip_update_ = false;
+  if (skip_update.is_initialized()) {
+    PADDLE_ENFORCE_EQ(
+        skip_update->numel(),
+        1,
+        errors::InvalidArgument("Input(SkipUpdate) size must be 1, but get %d",
+                                skip_update->numel()));
+    std::vector<bool> skip_update_vec;
+    phi::TensorToVector(*skip_update, dev_ctx, &skip_update_vec);
+    skip_update_ = skip_update_vec[0];
+  }
+  if (skip_update_) {
+    VLOG(4) << "FusedAdam skip update";
+    for (size_t idx = 0; idx < params_num; idx++) {
+      phi::Copy(
+          dev_ctx, *params[idx], dev_ctx.GetPlace(), false, params_out[idx]);
+      phi::Copy(dev_ctx,
+                *moments1[idx],
+                dev_ctx.GetPlace(),
+                false,
+                moments1_out[idx]);
+      phi::Copy(dev_ctx,
+                *moments2[idx],
+                dev_ctx.GetPlace(),
+                false,
+                moments2_out[idx]);
+      if (amsgrad) {
+        phi::Copy(dev_ctx,
+                  *moments2_max.get()[idx],
+                  dev_ctx.GetPlace(),
+                  false,
+                  moments2_max_out[idx]);
+      }
+      if (!use_global_beta_pow) {
+        phi::Copy(dev_ctx,
+                  *beta1_pows[idx],
+                  beta1_pows[idx]->place(),
+                  false,
+                  beta1_pows_out[idx]);
+        phi::Copy(dev_ctx,
+                  *beta2_pows[idx],
+                  beta2_pows[idx]->place(),
+                  false,
+                  beta2_pows_out[idx]);
+      }
     }
+    return;
   }
+
+  MultiTensorAdamCPU<T, Context>(dev_ctx,
+                                 params,
+                                 grads,
+                                 {&learning_rate},
+                                 moments1,
+                                 moments2,
+                                 moments2_max,
+                                 beta1_pows,
+                                 beta2_pows,
+                                 beta1.to<T>(),
+                                 beta2.to<T>(),
+                                 epsilon.to<T>(),
+                                 use_adamw,
+                                 static_cast<T>(weight_decay),
+                                 use_global_beta_pow,
+                                 amsgrad,
+                                 params_out,
+                                 moments1_out,
+                                 moments2_out,
+                                 moments2_max_out,
+                                 beta1_pows_out,
+                                 beta2_pows_out);
 }
 
 }  // namespace phi
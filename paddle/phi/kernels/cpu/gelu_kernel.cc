@@ -25,80 +25,84 @@
 #include "paddle/phi/kernels/funcs/blas/blas_impl.h"
 #include "paddle/phi/kernels/funcs/eigen/common.h"
 #include "paddle/phi/kernels/funcs/eigen/eigen_function.h"
+#include "paddle/phi/kernels/funcs/jit/kernels.h"
 
 namespace phi {
 
 template <typename T>
 struct GeluFunctor {
   template <typename Device, typename X, typename Out>
-  void operator()(Device d, X x, Out out, bool approximate) const {
-    if (approximate) {
-      // gelu(x) = 0.5 * x * (1 + tanh(sqrt(2 / \pi) * (x + 0.044715 * x^{3})))
-      if (std::is_same<T, dtype::float16>::value) {
-        VLOG(4) << "cast from float16 to float before computing";
-        auto casted_x = x.template cast<float>();
-        auto temp =
-            (static_cast<float>(M_2_SQRTPI * M_SQRT1_2) *
-             (casted_x + static_cast<float>(GELU_CONSTANT) * casted_x.cube()))
-                .tanh();
-        out.device(d) = (casted_x * static_cast<float>(0.5) *
-                         (static_cast<float>(1) + temp))
-                            .template cast<T>();
-      } else {
-        auto temp = (static_cast<T>(M_2_SQRTPI * M_SQRT1_2) *
-                     (x + static_cast<T>(GELU_CONSTANT) * x.cube()))
-                        .tanh();
-        out.device(d) = x * static_cast<T>(0.5) * (static_cast<T>(1) + temp);
-      }
-    } else {
+  void operator()(Device d, X x, Out out) const {
 #if defined(PADDLE_WITH_MKLML) && !defined(_WIN32) && !defined(__APPLE__) && \
     !defined(__OSX__) && !defined(PADDLE_WITH_CUDA) &&                       \
     !defined(PADDLE_WITH_HIP)
-      auto x_data = x.data();
-      auto out_data = out.data();
-      int n = std::min(x.size(), out.size());
+    auto x_data = x.data();
+    auto out_data = out.data();
+    int n = std::min(x.size(), out.size());
 
-      std::memset(out_data, 0, n * sizeof(T));
-      phi::funcs::CBlas<T>::AXPY(
-          n, static_cast<T>(M_SQRT1_2), x_data, 1, out_data, 1);
-      phi::funcs::CBlas<T>::VMERF(n, out_data, out_data, VML_LA);
-      for (int i = 0; i < n; i++) {
-        out_data[i] += static_cast<T>(1);
-      }
-      phi::funcs::CBlas<T>::VMUL(n, x_data, out_data, out_data);
-      for (int i = 0; i < n; i++) {
-        out_data[i] *= static_cast<T>(0.5);
-      }
+    std::memset(out_data, 0, n * sizeof(T));
+    phi::funcs::CBlas<T>::AXPY(
+        n, static_cast<T>(M_SQRT1_2), x_data, 1, out_data, 1);
+    phi::funcs::CBlas<T>::VMERF(n, out_data, out_data, VML_LA);
+    for (int i = 0; i < n; i++) {
+      out_data[i] += static_cast<T>(1);
+    }
+    phi::funcs::CBlas<T>::VMUL(n, x_data, out_data, out_data);
+    for (int i = 0; i < n; i++) {
+      out_data[i] *= static_cast<T>(0.5);
+    }
 #else
-      // gelu(x) = 0.5 * x *  (1 + erf(x / sqrt(2)))
-      if (std::is_same<T, dtype::float16>::value) {
-        VLOG(4) << "cast from float16 to float before computing";
-        auto casted_x = x.template cast<float>();
-        auto temp = (casted_x * static_cast<float>(M_SQRT1_2)).erf();
-        out.device(d) = (casted_x * static_cast<float>(0.5) *
-                         (static_cast<float>(1) + temp))
-                            .template cast<T>();
-      } else {
-        auto temp = (x * static_cast<T>(M_SQRT1_2)).erf();
-        out.device(d) = x * static_cast<T>(0.5) * (static_cast<T>(1) + temp);
-      }
-#endif
+    // gelu(x) = 0.5 * x *  (1 + erf(x / sqrt(2)))
+    if (std::is_same<T, dtype::float16>::value) {
+      VLOG(4) << "cast from float16 to float before computing";
+      auto casted_x = x.template cast<float>();
+      auto temp = (casted_x * static_cast<float>(M_SQRT1_2)).erf();
+      out.device(d) = (casted_x * static_cast<float>(0.5) *
+                       (static_cast<float>(1) + temp))
+                          .template cast<T>();
+    } else {
+      auto temp = (x * static_cast<T>(M_SQRT1_2)).erf();
+      out.device(d) = x * static_cast<T>(0.5) * (static_cast<T>(1) + temp);
     }
+#endif
   }
 };
 
+// The jit code of VGelu is unrolled over its length, so the data is run in
+// blocks of kGeluTanhBlock to bound the code generated.
+constexpr int kGeluTanhBlock = 256;
+
+// gelu(x) = 0.5 * x * (1 + tanh(sqrt(2 / \pi) * (x + 0.044715 * x^{3})))
+template <typename T>
+void GeluTanh(const T* x, T* out, int64_t numel) {
+  auto& cache = jit::KernelFuncs<jit::VGeluTuple<T>, CPUPlace>::Cache();
+  auto gelu = cache.At(kGeluTanhBlock);
+  int64_t i = 0;
+  for (; i + kGeluTanhBlock <= numel; i += kGeluTanhBlock) {
+    gelu(x + i, out + i, kGeluTanhBlock);
+  }
+  if (i < numel) {
+    const int tail = static_cast<int>(numel - i);
+    cache.At(tail)(x + i, out + i, tail);
+  }
+}
+
 template <typename T, typename Context>
 void GeluKernel(const Context& dev_ctx,
                 const DenseTensor& x,
                 bool approximate,
                 DenseTensor* out) {
   dev_ctx.template Alloc<T>(out);
+  if (approximate) {
+    GeluTanh<T>(x.data<T>(), out->data<T>(), x.numel());
+    return;
+  }
   auto eigen_out = EigenVector<T>::Flatten(*out);
   auto eigen_x = EigenVector<T>::Flatten(x);
   auto& dev = *dev_ctx.eigen_device();
 
   GeluFunctor<T> functor;
-  functor(dev, eigen_x, eigen_out, approximate);
+  functor(dev, eigen_x, eigen_out);
 }
 
 }  // namespace phi
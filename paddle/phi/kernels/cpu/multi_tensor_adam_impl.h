@@ -0,0 +1,166 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cmath>
+#include <vector>
+
+#include "glog/logging.h"
+
+#include "paddle/phi/core/dense_tensor.h"
+#include "paddle/phi/kernels/funcs/cpu_multi_tensor_apply.h"
+#include "paddle/phi/kernels/funcs/jit/kernels.h"
+#include "paddle/utils/optional.h"
+
+namespace phi {
+
+// Same chunk size as the adam and adamw CPU kernels, so the multi tensor
+// update gives bitwise the same results as one kernel per tensor.
+static constexpr int64_t kMultiTensorAdamChunkSize = 512;
+
+// Updates every tensor of the list with Adam, or AdamW with the decay
+// coefficient `coeff` if `use_adamw`, in one parallel pass over the chunks
+// of all tensors. `learning_rates` holds either one learning rate shared by
+// all tensors or one per tensor.
+template <typename T, typename Context>
+void MultiTensorAdamCPU(
+    const Context& dev_ctx,
+    const std::vector<const DenseTensor*>& params,
+    const std::vector<const DenseTensor*>& grads,
+    const std::vector<const DenseTensor*>& learning_rates,
+    const std::vector<const DenseTensor*>& moments1,
+    const std::vector<const DenseTensor*>& moments2,
+    const paddle::optional<std::vector<const DenseTensor*>>& moments2_max,
+    const std::vector<const DenseTensor*>& beta1_pows,
+    const std::vector<const DenseTensor*>& beta2_pows,
+    T beta1,
+    T beta2,
+    T epsilon,
+    bool use_adamw,
+    T coeff,
+    bool use_global_beta_pow,
+    bool amsgrad,
+    const std::vector<DenseTensor*>& params_out,
+    const std::vector<DenseTensor*>& moments1_out,
+    const std::vector<DenseTensor*>& moments2_out,
+    const std::vector<DenseTensor*>& moments2_max_out,
+    const std::vector<DenseTensor*>& beta1_pows_out,
+    const std::vector<DenseTensor*>& beta2_pows_out) {
+  struct TensorArgs {
+    T lr;
+    T eps;
+    T old_lr;
+    const T* grad;
+    const T* mom1;
+    const T* mom2;
+    const T* mom2_max;
+    const T* param;
+    T* mom1_out;
+    T* mom2_out;
+    T* mom2_max_out;
+    T* param_out;
+  };
+
+  size_t n = params.size();
+  std::vector<T> beta1_ps(n);
+  std::vector<T> beta2_ps(n);
+  std::vector<TensorArgs> args(n);
+  for (size_t i = 0; i < n; ++i) {
+    // The pows may be updated in place, read them before any write.
+    beta1_ps[i] = beta1_pows[i]->data<T>()[0];
+    beta2_ps[i] = beta2_pows[i]->data<T>()[0];
+    T lr = learning_rates[learning_rates.size() == 1 ? 0 : i]->data<T>()[0];
+
+    auto& arg = args[i];
+    arg.old_lr = lr;
+    arg.lr = lr * (sqrt(1 - beta2_ps[i]) / (1 - beta1_ps[i]));
+    arg.eps = epsilon * sqrt(1 - beta2_ps[i]);
+    arg.param_out = dev_ctx.template Alloc<T>(params_out[i]);
+    arg.mom1_out = dev_ctx.template Alloc<T>(moments1_out[i]);
+    arg.mom2_out = dev_ctx.template Alloc<T>(moments2_out[i]);
+    arg.mom2_max_out =
+        amsgrad ? dev_ctx.template Alloc<T>(moments2_max_out[i]) : nullptr;
+    arg.grad = grads[i]->data<T>();
+    arg.mom1 = moments1[i]->data<T>();
+    arg.mom2 = moments2[i]->data<T>();
+    arg.mom2_max = amsgrad ? moments2_max.get()[i]->data<T>() : nullptr;
+    arg.param = params[i]->data<T>();
+  }
+
+  auto chunks =
+      funcs::SplitTensorsIntoChunks(params, kMultiTensorAdamChunkSize);
+  VLOG(4) << "Update " << n << " tensors in " << chunks.size()
+          << " chunks, use_adamw: " << use_adamw;
+
+  if (use_adamw) {
+    auto adamw =
+        phi::jit::KernelFuncs<phi::jit::AdamWTuple<T>, phi::CPUPlace>::Cache()
+            .At(phi::jit::adamw_attr_t(beta1, beta2, coeff, amsgrad));
+    funcs::CPUMultiTensorApply(chunks, [&](const funcs::CPUTensorChunk& c) {
+      const auto& arg = args[c.tensor_id];
+      int64_t offset = c.offset;
+      adamw(beta1,
+            beta2,
+            -arg.lr,
+            arg.eps,
+            arg.old_lr,
+            static_cast<T>(1.0),
+            coeff,
+            c.numel,
+            arg.grad + offset,
+            arg.mom1 + offset,
+            arg.mom2 + offset,
+            amsgrad ? arg.mom2_max + offset : nullptr,
+            arg.param + offset,
+            arg.mom1_out + offset,
+            arg.mom2_out + offset,
+            amsgrad ? arg.mom2_max_out + offset : nullptr,
+            arg.param_out + offset,
+            amsgrad);
+    });
+  } else {
+    auto adam =
+        phi::jit::KernelFuncs<phi::jit::AdamTuple<T>, phi::CPUPlace>::Cache()
+            .At(phi::jit::adam_attr_t(beta1, beta2, amsgrad));
+    funcs::CPUMultiTensorApply(chunks, [&](const funcs::CPUTensorChunk& c) {
+      const auto& arg = args[c.tensor_id];
+      int64_t offset = c.offset;
+      adam(beta1,
+           beta2,
+           -arg.lr,
+           arg.eps,
+           c.numel,
+           arg.grad + offset,
+           arg.mom1 + offset,
+           arg.mom2 + offset,
+           amsgrad ? arg.mom2_max + offset : nullptr,
+           arg.param + offset,
+           arg.mom1_out + offset,
+           arg.mom2_out + offset,
+           amsgrad ? arg.mom2_max_out + offset : nullptr,
+           arg.param_out + offset,
+           amsgrad);
+    });
+  }
+
+  if (!use_global_beta_pow) {
+    for (size_t i = 0; i < n; ++i) {
+      dev_ctx.template Alloc<T>(beta1_pows_out[i])[0] = beta1 * beta1_ps[i];
+      dev_ctx.template Alloc<T>(beta2_pows_out[i])[0] = beta2 * beta2_ps[i];
+    }
+  }
+}
+
+}  // namespace phi
@@ -15,25 +15,42 @@
 #include "paddle/phi/kernels/swiglu_kernel.h"
 #include "paddle/phi/backends/cpu/cpu_context.h"
 #include "paddle/phi/core/kernel_registry.h"
-#include "paddle/phi/kernels/funcs/activation_functor.h"
+#include "paddle/phi/kernels/funcs/jit/kernels.h"
 
 namespace phi {
 
+// The jit code of VSwiGLU is unrolled over its length, so each row is run in
+// blocks of kSwiGLUBlock to bound the code generated.
+constexpr int kSwiGLUBlock = 256;
+
 template <typename T, typename Context>
 void SwiGLUKernelImpl(
     const Context &ctx, const T *x, const T *y, T *z, int64_t m, int64_t n) {
-  funcs::SwiGLUFunctor<T> functor;
   int64_t stride;
   if (y) {
+    // x, y and z are contiguous, so they are run as one row
+    n *= m;
+    m = 1;
     stride = n;
   } else {
     stride = 2 * n;
     y = x + n;
   }
 
+  auto &cache = jit::KernelFuncs<jit::VSwiGLUTuple<T>, CPUPlace>::Cache();
+  auto swiglu = cache.At(kSwiGLUBlock);
+  const int tail = static_cast<int>(n % kSwiGLUBlock);
+  auto swiglu_tail = tail > 0 ? cache.At(tail) : nullptr;
   for (int64_t i = 0; i < m; ++i) {
-    for (int64_t j = 0; j < n; ++j) {
-      z[i * n + j] = functor(x[i * stride + j], y[i * stride + j]);
+    const T *x_row = x + i * stride;
+    const T *y_row = y + i * stride;
+    T *z_row = z + i * n;
+    int64_t j = 0;
+    for (; j + kSwiGLUBlock <= n; j += kSwiGLUBlock) {
+      swiglu(x_row + j, y_row + j, z_row + j, kSwiGLUBlock);
+    }
+    if (tail > 0) {
+      swiglu_tail(x_row + j, y_row + j, z_row + j, tail);
     }
   }
 }
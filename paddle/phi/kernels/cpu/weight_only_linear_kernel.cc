@@ -0,0 +1,134 @@
+/* Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include "paddle/phi/kernels/weight_only_linear_kernel.h"
+
+#include <type_traits>
+
+#include "paddle/phi/backends/cpu/cpu_context.h"
+#include "paddle/phi/core/kernel_registry.h"
+#include "paddle/phi/kernels/funcs/blas/blas.h"
+#include "paddle/phi/kernels/funcs/weight_only_gemm_cpu.h"
+
+namespace phi {
+
+namespace {
+
+// Returns `t` as float data, converting it into `buffer` if needed.
+template <typename T>
+const float* ToFloat(const CPUContext& dev_ctx,
+                     const DenseTensor& t,
+                     DenseTensor* buffer) {
+  if (std::is_same<T, float>::value) {
+    return reinterpret_cast<const float*>(t.data<T>());
+  }
+  buffer->Resize({t.numel()});
+  float* dst = dev_ctx.template Alloc<float>(buffer);
+  const T* src = t.data<T>();
+  for (int64_t i = 0; i < t.numel(); ++i) {
+    dst[i] = static_cast<float>(src[i]);
+  }
+  return dst;
+}
+
+}  // namespace
+
+template <typename T, typename Context>
+void WeightOnlyLinearKernel(const Context& dev_ctx,
+                            const DenseTensor& x,
+                            const DenseTensor& weight,
+                            const paddle::optional<DenseTensor>& bias,
+                            const DenseTensor& weight_scale,
+                            const std::string& weight_dtype,
+                            const int32_t arch,
+                            const int32_t group_size,
+                            DenseTensor* out) {
+  PADDLE_ENFORCE_EQ(
+      arch,
+      0,
+      common::errors::InvalidArgument(
+          "The CPU weight_only_linear kernel only supports the weight "
+          "quantized with arch = 0, but received arch = %d.",
+          arch));
+  PADDLE_ENFORCE_EQ(
+      (weight_dtype == "int8" || weight_dtype == "int4"),
+      true,
+      common::errors::InvalidArgument(
+          "weight_dtype must be int8 or int4, but received %s.", weight_dtype));
+
+  funcs::WeightOnlyGemmArgs args;
+  args.bits = weight_dtype == "int8" ? 8 : 4;
+  args.group_size = group_size;
+  args.k = weight.dims()[1];
+  args.n = group_size > 0 ? weight_scale.dims()[1] : weight_scale.dims()[0];
+  args.m = args.k == 0 ? 0 : x.numel() / args.k;
+
+  DenseTensor x_fp32, scale_fp32, bias_fp32, out_fp32;
+  args.x = ToFloat<T>(dev_ctx, x, &x_fp32);
+  args.weight = weight.data<int8_t>();
+  args.scale = ToFloat<T>(dev_ctx, weight_scale, &scale_fp32);
+  args.bias = bias ? ToFloat<T>(dev_ctx, bias.get(), &bias_fp32) : nullptr;
+  if (std::is_same<T, float>::value) {
+    args.out = reinterpret_cast<float*>(dev_ctx.template Alloc<T>(out));
+  } else {
+    out_fp32.Resize({args.m, args.n});
+    args.out = dev_ctx.template Alloc<float>(&out_fp32);
+  }
+
+  if (args.m <= funcs::kWeightOnlyGemvMaxM) {
+    // Decoding: the weight is read once and the kernel is bound by memory
+    // bandwidth, so dequantize it in registers.
+    funcs::WeightOnlyGemm(args);
+  } else {
+    // Prefill: the dequantization is amortized over many rows.
+    DenseTensor w_fp32;
+    w_fp32.Resize({args.n, args.k});
+    float* w = dev_ctx.template Alloc<float>(&w_fp32);
+    funcs::WeightOnlyDequantize(args, w);
+    auto blas = funcs::GetBlas<Context, float>(dev_ctx);
+    blas.GEMM(CblasNoTrans,
+              CblasTrans,
+              static_cast<int>(args.m),
+              static_cast<int>(args.n),
+              static_cast<int>(args.k),
+              1.f,
+              args.x,
+              w,
+              0.f,
+              args.out);
+    if (args.bias) {
+      for (int64_t r = 0; r < args.m; ++r) {
+        blas.AXPY(
+            static_cast<int>(args.n), 1.f, args.bias, args.out + r * args.n);
+      }
+    }
+  }
+
+  if (!std::is_same<T, float>::value) {
+    T* out_data = dev_ctx.template Alloc<T>(out);
+    for (int64_t i = 0; i < out->numel(); ++i) {
+      out_data[i] = static_cast<T>(args.out[i]);
+    }
+  }
+}
+
+}  // namespace phi
+
+PD_REGISTER_KERNEL(weight_only_linear,
+                   CPU,
+                   ALL_LAYOUT,
+                   phi::WeightOnlyLinearKernel,
+                   float,
+                   phi::dtype::float16,
+                   phi::dtype::bfloat16) {}
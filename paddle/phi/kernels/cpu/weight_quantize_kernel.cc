@@ -36,11 +36,11 @@ void quant_compute(const DeviceContext& dev_ctx,
                    const int32_t group_size) {
 #ifndef PADDLE_WITH_HIP
   PADDLE_ENFORCE_EQ(
-      ((arch == 70) || (arch == 75) || (arch == 80) || (arch == 86) ||
-       (arch == 89) || (arch == 90)),
+      ((arch == 0) || (arch == 70) || (arch == 75) || (arch == 80) ||
+       (arch == 86) || (arch == 89) || (arch == 90)),
       true,
       common::errors::InvalidArgument(
-          "Currently, arch only support 70, 75, 80, 86, 89, 90."));
+          "Currently, arch only support 0 (CPU), 70, 75, 80, 86, 89, 90."));
 
 #endif
   const auto x_dims = x.dims();
@@ -62,8 +62,8 @@ void quant_compute(const DeviceContext& dev_ctx,
 #ifdef PADDLE_WITH_HIP
   x_int.Resize({static_cast<int64_t>(m), static_cast<int64_t>(n)});
 #else
-  if ((arch == 80) || (arch == 75) || (arch == 86) || (arch == 89) ||
-      (arch == 90)) {
+  if ((arch == 0) || (arch == 80) || (arch == 75) || (arch == 86) ||
+      (arch == 89) || (arch == 90)) {
     x_int.Resize({static_cast<int64_t>(m), static_cast<int64_t>(n)});
   } else {
     // phi::Copy may change tensor meta info, here we transpose the quanted
@@ -124,7 +124,17 @@ void quant_compute(const DeviceContext& dev_ctx,
       trans(dev_ctx, x_int_tmp, out, axis);
     }
 #else
-    if (arch == 70) {
+    if (arch == 0) {
+      // Plain layout read by the CPU weight_only_linear kernel, see
+      // funcs/weight_only_gemm_cpu.h: the quantized [k, n * bits / 8] bytes
+      // are transposed, so each row holds one (int4: two) output channels.
+      DenseTensor x_int_bytes(x_int);
+      x_int_bytes.Resize({static_cast<int64_t>(m),
+                          static_cast<int64_t>(n * bits / 8)});
+      std::vector<int> axis = {1, 0};
+      funcs::Transpose<DeviceContext, int8_t, 2> trans;
+      trans(dev_ctx, x_int_bytes, out, axis);
+    } else if (arch == 70) {
       // Note(Zhengzekang): In sm70, we only need RowMajor layout, just add bias
       // to make it unsigned.
       add_bias_and_interleave_inplace<bits>(x_int_data, num);
@@ -182,5 +192,6 @@ PD_REGISTER_KERNEL(weight_quantize,
                    CPU,
                    ALL_LAYOUT,
                    phi::WeightQuantizeKernel,
+                   float,
                    phi::dtype::float16,
                    phi::dtype::bfloat16) {}
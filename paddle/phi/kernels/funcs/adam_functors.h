@@ -575,6 +575,40 @@ class SparseAdamFunctor<T, CPUAdam, T> {
     param_out_[i] = p;
   }
 
+  // Lazy mode: only the rows of the gradient are updated, the moments of
+  // the other rows are left as they are. The bias correction depends on the
+  // step only, so it is computed once instead of for every element. The
+  // rows must be unique, they are updated in parallel.
+  inline void lazy_update() const {
+    T lr = *lr_;
+    T beta1_pow = *beta1_pow_;
+    T beta2_pow = *beta2_pow_;
+    lr *= sqrt(1 - beta2_pow) / (1 - beta1_pow);
+    T eps = epsilon_ * sqrt(1 - beta2_pow);
+
+#ifdef PADDLE_WITH_MKLML
+#pragma omp parallel for
+#endif
+    for (int64_t j = 0; j < row_count_; ++j) {
+      const T* g = grad_ + j * row_numel_;
+      int64_t offset = rows_[j] * row_numel_;
+      for (int64_t k = 0; k < row_numel_; ++k) {
+        int64_t i = offset + k;
+        T mom1 = beta1_ * moment1_[i] + (1 - beta1_) * g[k];
+        T mom2 = beta2_ * moment2_[i] + (1 - beta2_) * g[k] * g[k];
+        if (amsgrad_) {
+          T mom2_max = std::max(mom2, moment2_max_[i]);
+          param_out_[i] = param_[i] - lr * (mom1 / (sqrt(mom2_max) + eps));
+          moment2_max_out_[i] = mom2_max;
+        } else {
+          param_out_[i] = param_[i] - lr * (mom1 / (sqrt(mom2) + eps));
+        }
+        moment1_out_[i] = mom1;
+        moment2_out_[i] = mom2;
+      }
+    }
+  }
+
   inline void operator()(size_t numel) const {
     // lr could be reuse
     T lr = *lr_;
@@ -0,0 +1,81 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <algorithm>
+#include <vector>
+
+#include "paddle/phi/core/dense_tensor.h"
+
+namespace phi {
+namespace funcs {
+
+// The CPU counterpart of multi_tensor_apply.h: the elements of a list of
+// tensors are cut into chunks and all chunks are processed in a single
+// parallel loop, instead of one parallel region per tensor. Lists of many
+// small tensors (biases, norms) no longer pay one fork/join per tensor, and
+// a few large tensors are still spread over all the threads.
+
+struct CPUTensorChunk {
+  int tensor_id;
+  int64_t offset;
+  int64_t numel;
+};
+
+// Chunks start at the multiples of `chunk_size` of every tensor, so a chunk
+// covers the same elements as in a per tensor loop with the same chunk size.
+inline std::vector<CPUTensorChunk> SplitTensorsIntoChunks(
+    const std::vector<int64_t> &numels, int64_t chunk_size) {
+  std::vector<CPUTensorChunk> chunks;
+  int64_t chunk_num = 0;
+  for (auto numel : numels) {
+    chunk_num += (numel + chunk_size - 1) / chunk_size;
+  }
+  chunks.reserve(chunk_num);
+  for (size_t i = 0; i < numels.size(); ++i) {
+    for (int64_t offset = 0; offset < numels[i]; offset += chunk_size) {
+      chunks.push_back({static_cast<int>(i),
+                        offset,
+                        std::min(chunk_size, numels[i] - offset)});
+    }
+  }
+  return chunks;
+}
+
+inline std::vector<CPUTensorChunk> SplitTensorsIntoChunks(
+    const std::vector<const DenseTensor *> &tensors, int64_t chunk_size) {
+  std::vector<int64_t> numels(tensors.size());
+  for (size_t i = 0; i < tensors.size(); ++i) {
+    numels[i] = tensors[i]->numel();
+  }
+  return SplitTensorsIntoChunks(numels, chunk_size);
+}
+
+// Calls `func(chunk)` for every chunk. The tail chunks are shorter than the
+// others, so the chunks are handed out dynamically. `func` must not throw.
+template <typename Func>
+void CPUMultiTensorApply(const std::vector<CPUTensorChunk> &chunks,
+                         Func &&func) {
+  const int64_t chunk_num = static_cast<int64_t>(chunks.size());
+#ifdef PADDLE_WITH_MKLML
+#pragma omp parallel for schedule(dynamic, 4)
+#endif
+  for (int64_t i = 0; i < chunk_num; ++i) {
+    func(chunks[i]);
+  }
+}
+
+}  // namespace funcs
+}  // namespace phi
@@ -0,0 +1,561 @@
+/* Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include "paddle/phi/kernels/funcs/direct_conv_cpu.h"
+
+#if defined(_OPENMP)
+#include <omp.h>
+#endif
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include "paddle/phi/kernels/funcs/blas/blas.h"
+#include "paddle/phi/kernels/funcs/packed_gemm_cache.h"
+
+PHI_DEFINE_EXPORTED_bool(
+    use_direct_conv_cpu,
+    true,
+    "Whether the cpu conv2d kernel computes by the im2col free algorithms of "
+    "direct_conv_cpu.h where they suit, instead of im2col + GEMM.");
+
+namespace phi {
+namespace funcs {
+
+namespace {
+
+// Output channels of a block, which is the vector the micro kernel
+// accumulates, and the filters are packed by.
+constexpr int kOcBlock = 16;
+// Output pixels (or Winograd tiles) computed together, sharing the loads of
+// the packed filter.
+constexpr int kPixels = 4;
+// Elements of the Winograd buffers of one chunk of tiles, to keep them in L2.
+constexpr int64_t kWinogradChunkElems = 64 * 1024;
+// The least tiles of a Winograd chunk. The 16 transformed filter matrices are
+// read once per chunk, so smaller chunks are bound by the reads, e.g. 512
+// channels of a 7x7 output are 2x slower than im2col + GEMM.
+constexpr int64_t kWinogradMinChunk = 8;
+// The least 2x2 tiles of a batch for which Winograd beats im2col + GEMM when
+// the filter is transformed at the call, which takes about as long as a few
+// dozen tiles. With a cached filter, a 256 channel 14x14 output is faster by
+// Winograd too.
+constexpr int64_t kWinogradMinTiles = 128;
+
+inline int64_t CeilDiv(int64_t a, int64_t b) { return (a + b - 1) / b; }
+
+// The 2x2 tiles of a Winograd chunk, as many as the buffers of which fit in
+// L2, but fewer if the threads would not all have a chunk of the image.
+int64_t WinogradChunk(const Conv2dShape& s, int threads) {
+  const int64_t icg = s.in_c / s.groups;
+  const int64_t ocp = CeilDiv(s.out_c / s.groups, kOcBlock) * kOcBlock;
+  const int64_t tiles = CeilDiv(s.out_h, 2) * CeilDiv(s.out_w, 2);
+  int64_t chunk = kWinogradChunkElems / (16 * (icg + ocp));
+  chunk = std::min(chunk, CeilDiv(tiles, CeilDiv(threads, s.groups)));
+  chunk = std::max<int64_t>(kPixels, std::min<int64_t>(64, chunk));
+  return chunk / kPixels * kPixels;
+}
+
+// acc[r][c] += sum_{j < k} a[r][j] * b[j * kOcBlock + c] for the kPixels rows
+// of a. Every row sums in its own local array, which the compiler holds in
+// vector registers, a 2D array would be spilled to the stack.
+template <typename T>
+inline void MicroKernel(const T* const* a,
+                        const T* b,
+                        int64_t k,
+                        T (*acc)[kOcBlock]) {
+  static_assert(kPixels == 4, "MicroKernel computes 4 rows.");
+  const T* a0 = a[0];
+  const T* a1 = a[1];
+  const T* a2 = a[2];
+  const T* a3 = a[3];
+  T s0[kOcBlock] = {};
+  T s1[kOcBlock] = {};
+  T s2[kOcBlock] = {};
+  T s3[kOcBlock] = {};
+  for (int64_t j = 0; j < k; ++j) {
+    const T* bj = b + j * kOcBlock;
+    const T x0 = a0[j];
+    const T x1 = a1[j];
+    const T x2 = a2[j];
+    const T x3 = a3[j];
+    for (int c = 0; c < kOcBlock; ++c) {
+      s0[c] += x0 * bj[c];
+      s1[c] += x1 * bj[c];
+      s2[c] += x2 * bj[c];
+      s3[c] += x3 * bj[c];
+    }
+  }
+  for (int c = 0; c < kOcBlock; ++c) {
+    acc[0][c] += s0[c];
+    acc[1][c] += s1[c];
+    acc[2][c] += s2[c];
+    acc[3][c] += s3[c];
+  }
+}
+
+// dst[j * rows + i] = src[i * cols + j], in blocks that fit in L1.
+template <typename T>
+void TransposeImage(const T* src, int64_t rows, int64_t cols, T* dst) {
+  constexpr int64_t kBlock = 32;
+  const int64_t row_blocks = CeilDiv(rows, kBlock);
+  const int64_t col_blocks = CeilDiv(cols, kBlock);
+#if defined(_OPENMP)
+#pragma omp parallel for
+#endif
+  for (int64_t blk = 0; blk < row_blocks * col_blocks; ++blk) {
+    const int64_t i0 = blk / col_blocks * kBlock;
+    const int64_t j0 = blk % col_blocks * kBlock;
+    const int64_t i1 = std::min(rows, i0 + kBlock);
+    const int64_t j1 = std::min(cols, j0 + kBlock);
+    for (int64_t j = j0; j < j1; ++j) {
+      for (int64_t i = i0; i < i1; ++i) {
+        dst[j * rows + i] = src[i * cols + j];
+      }
+    }
+  }
+}
+
+// Packs the [out_c, in_c / groups, kh, kw] filter to
+// [groups][oc blocks][kh][kw][in_c / groups][kOcBlock], zero padding the last
+// block of every group.
+template <typename T>
+void PackDirectFilter(const Conv2dShape& s, const T* filter, T* packed) {
+  const int64_t icg = s.in_c / s.groups;
+  const int64_t ocg = s.out_c / s.groups;
+  const int64_t ocbs = CeilDiv(ocg, kOcBlock);
+  const int64_t ksize = s.kernel_h * s.kernel_w;
+#if defined(_OPENMP)
+#pragma omp parallel for
+#endif
+  for (int64_t gb = 0; gb < s.groups * ocbs; ++gb) {
+    const int64_t g = gb / ocbs;
+    const int64_t b = gb % ocbs;
+    T* dst = packed + gb * ksize * icg * kOcBlock;
+    for (int64_t k = 0; k < ksize; ++k) {
+      for (int64_t ic = 0; ic < icg; ++ic) {
+        for (int c = 0; c < kOcBlock; ++c) {
+          const int64_t oc = b * kOcBlock + c;
+          dst[(k * icg + ic) * kOcBlock + c] =
+              oc < ocg ? filter[((g * ocg + oc) * icg + ic) * ksize + k]
+                       : static_cast<T>(0);
+        }
+      }
+    }
+  }
+}
+
+// One NHWC image, every (group, output row, oc block) is a task, which walks
+// the row kPixels outputs at a time.
+template <typename T>
+void DirectConvImage(const Conv2dShape& s,
+                     const T* in,
+                     const T* packed,
+                     const T* zeros,
+                     T* out) {
+  const int64_t icg = s.in_c / s.groups;
+  const int64_t ocg = s.out_c / s.groups;
+  const int64_t ocbs = CeilDiv(ocg, kOcBlock);
+  const int64_t ksize = s.kernel_h * s.kernel_w;
+  const int64_t tasks = s.groups * s.out_h * ocbs;
+#if defined(_OPENMP)
+#pragma omp parallel for
+#endif
+  for (int64_t task = 0; task < tasks; ++task) {
+    const int64_t g = task / (s.out_h * ocbs);
+    const int64_t oh = task / ocbs % s.out_h;
+    const int64_t b = task % ocbs;
+    const T* filter = packed + (g * ocbs + b) * ksize * icg * kOcBlock;
+    const int64_t width = std::min<int64_t>(kOcBlock, ocg - b * kOcBlock);
+    for (int64_t ow0 = 0; ow0 < s.out_w; ow0 += kPixels) {
+      T acc[kPixels][kOcBlock] = {};
+      for (int kh = 0; kh < s.kernel_h; ++kh) {
+        const int64_t ih = oh * s.stride_h - s.pad_top + kh * s.dilation_h;
+        if (ih < 0 || ih >= s.in_h) {
+          continue;
+        }
+        for (int kw = 0; kw < s.kernel_w; ++kw) {
+          const T* a[kPixels];
+          for (int r = 0; r < kPixels; ++r) {
+            const int64_t ow = ow0 + r;
+            const int64_t iw = ow * s.stride_w - s.pad_left + kw * s.dilation_w;
+            a[r] = ow < s.out_w && iw >= 0 && iw < s.in_w
+                       ? in + (ih * s.in_w + iw) * s.in_c + g * icg
+                       : zeros;
+          }
+          MicroKernel(a,
+                      filter + (kh * s.kernel_w + kw) * icg * kOcBlock,
+                      icg,
+                      acc);
+        }
+      }
+      for (int r = 0; r < kPixels && ow0 + r < s.out_w; ++r) {
+        T* dst =
+            out + (oh * s.out_w + ow0 + r) * s.out_c + g * ocg + b * kOcBlock;
+        std::copy(acc[r], acc[r] + width, dst);
+      }
+    }
+  }
+}
+
+// Transforms the 3x3 filters to U = G f G^T, stored as
+// [groups][16][oc blocks][in_c / groups][kOcBlock] so that every one of the 16
+// elements is a packed GEMM operand.
+template <typename T>
+void PackWinogradFilter(const Conv2dShape& s, const T* filter, T* packed) {
+  // Input channels transformed together, so that the 16 matrices are written
+  // kIcBlock * kOcBlock contiguous elements at a time. They are far apart, so
+  // elements written one by one would thrash the cache.
+  constexpr int64_t kIcBlock = 16;
+  const int64_t icg = s.in_c / s.groups;
+  const int64_t ocg = s.out_c / s.groups;
+  const int64_t ocbs = CeilDiv(ocg, kOcBlock);
+  const int64_t xs = ocbs * icg * kOcBlock;
+  const int64_t icbs = CeilDiv(icg, kIcBlock);
+#if defined(_OPENMP)
+#pragma omp parallel for
+#endif
+  for (int64_t task = 0; task < s.groups * ocbs * icbs; ++task) {
+    const int64_t g = task / (ocbs * icbs);
+    const int64_t b = task / icbs % ocbs;
+    const int64_t ic0 = task % icbs * kIcBlock;
+    const int64_t ics = std::min(kIcBlock, icg - ic0);
+    T u[16][kIcBlock][kOcBlock] = {};
+    for (int c = 0; c < kOcBlock && b * kOcBlock + c < ocg; ++c) {
+      const int64_t oc = g * ocg + b * kOcBlock + c;
+      for (int64_t i = 0; i < ics; ++i) {
+        const T* f = filter + (oc * icg + ic0 + i) * 9;
+        // G = [[1, 0, 0], [1/2, 1/2, 1/2], [1/2, -1/2, 1/2], [0, 0, 1]]
+        T gf[4][3];
+        for (int j = 0; j < 3; ++j) {
+          gf[0][j] = f[j];
+          gf[1][j] = (f[j] + f[3 + j] + f[6 + j]) / 2;
+          gf[2][j] = (f[j] - f[3 + j] + f[6 + j]) / 2;
+          gf[3][j] = f[6 + j];
+        }
+        for (int r = 0; r < 4; ++r) {
+          u[r * 4 + 0][i][c] = gf[r][0];
+          u[r * 4 + 1][i][c] = (gf[r][0] + gf[r][1] + gf[r][2]) / 2;
+          u[r * 4 + 2][i][c] = (gf[r][0] - gf[r][1] + gf[r][2]) / 2;
+          u[r * 4 + 3][i][c] = gf[r][2];
+        }
+      }
+    }
+    T* dst = packed + g * 16 * xs + (b * icg + ic0) * kOcBlock;
+    for (int xi = 0; xi < 16; ++xi) {
+      std::copy(u[xi][0], u[xi][0] + ics * kOcBlock, dst + xi * xs);
+    }
+  }
+}
+
+// One NHWC image by Winograd F(2x2, 3x3). The 2x2 output tiles are processed
+// in chunks, each a task: the input tiles of the chunk are transformed to
+// V = B^T d B, multiplied by the 16 filter matrices, and the products M are
+// transformed back to A^T M A. The buffers of a chunk stay in L2.
+template <typename T>
+void WinogradConvImage(const Conv2dShape& s,
+                       int threads,
+                       const T* in,
+                       const T* packed,
+                       const T* zeros,
+                       T* out) {
+  const int64_t icg = s.in_c / s.groups;
+  const int64_t ocg = s.out_c / s.groups;
+  const int64_t ocbs = CeilDiv(ocg, kOcBlock);
+  const int64_t ocp = ocbs * kOcBlock;
+  const int64_t tiles_h = CeilDiv(s.out_h, 2);
+  const int64_t tiles_w = CeilDiv(s.out_w, 2);
+  const int64_t tiles = tiles_h * tiles_w;
+  const int64_t chunk = WinogradChunk(s, threads);
+  const int64_t chunks = CeilDiv(tiles, chunk);
+#if defined(_OPENMP)
+#pragma omp parallel
+#endif
+  {
+    std::vector<T> d(16 * icg);
+    std::vector<T> e(16 * icg);
+    std::vector<T> v(16 * chunk * icg);
+    std::vector<T> m(16 * chunk * ocp);
+    std::vector<T> y(4 * ocp);
+#if defined(_OPENMP)
+#pragma omp for
+#endif
+    for (int64_t task = 0; task < s.groups * chunks; ++task) {
+      const int64_t g = task / chunks;
+      const int64_t t0 = task % chunks * chunk;
+      const int64_t nt = std::min(chunk, tiles - t0);
+
+      // V[xi][t][ic]
+      for (int64_t t = 0; t < nt; ++t) {
+        const int64_t y0 = (t0 + t) / tiles_w * 2 - s.pad_top;
+        const int64_t x0 = (t0 + t) % tiles_w * 2 - s.pad_left;
+        for (int i = 0; i < 4; ++i) {
+          for (int j = 0; j < 4; ++j) {
+            const int64_t y = y0 + i;
+            const int64_t x = x0 + j;
+            const T* src = y >= 0 && y < s.in_h && x >= 0 && x < s.in_w
+                               ? in + (y * s.in_w + x) * s.in_c + g * icg
+                               : zeros;
+            std::copy(src, src + icg, d.data() + (i * 4 + j) * icg);
+          }
+        }
+        // B^T = [[1, 0, -1, 0], [0, 1, 1, 0], [0, -1, 1, 0], [0, 1, 0, -1]],
+        // every step is a loop over the channels, which is vectorized.
+        for (int j = 0; j < 4; ++j) {
+          const T* d0 = d.data() + j * icg;
+          const T* d1 = d0 + 4 * icg;
+          const T* d2 = d0 + 8 * icg;
+          const T* d3 = d0 + 12 * icg;
+          T* bd = e.data() + j * icg;
+          for (int64_t ic = 0; ic < icg; ++ic) {
+            bd[ic] = d0[ic] - d2[ic];
+            bd[4 * icg + ic] = d1[ic] + d2[ic];
+            bd[8 * icg + ic] = d2[ic] - d1[ic];
+            bd[12 * icg + ic] = d1[ic] - d3[ic];
+          }
+        }
+        const int64_t vs = chunk * icg;
+        for (int i = 0; i < 4; ++i) {
+          const T* e0 = e.data() + i * 4 * icg;
+          const T* e1 = e0 + icg;
+          const T* e2 = e0 + 2 * icg;
+          const T* e3 = e0 + 3 * icg;
+          T* vt = v.data() + i * 4 * vs + t * icg;
+          for (int64_t ic = 0; ic < icg; ++ic) {
+            vt[ic] = e0[ic] - e2[ic];
+            vt[vs + ic] = e1[ic] + e2[ic];
+            vt[2 * vs + ic] = e2[ic] - e1[ic];
+            vt[3 * vs + ic] = e1[ic] - e3[ic];
+          }
+        }
+      }
+
+      // M[xi][t][oc] = V[xi][t] * U[xi]
+      for (int xi = 0; xi < 16; ++xi) {
+        const T* vx = v.data() + xi * chunk * icg;
+        T* mx = m.data() + xi * chunk * ocp;
+        for (int64_t b = 0; b < ocbs; ++b) {
+          const T* u = packed + ((g * 16 + xi) * ocbs + b) * icg * kOcBlock;
+          for (int64_t t = 0; t < nt; t += kPixels) {
+            const T* a[kPixels];
+            for (int r = 0; r < kPixels; ++r) {
+              a[r] = t + r < nt ? vx + (t + r) * icg : zeros;
+            }
+            T acc[kPixels][kOcBlock] = {};
+            MicroKernel(a, u, icg, acc);
+            for (int r = 0; r < kPixels && t + r < nt; ++r) {
+              std::copy(
+                  acc[r], acc[r] + kOcBlock, mx + (t + r) * ocp + b * kOcBlock);
+            }
+          }
+        }
+      }
+
+      // out = A^T M A, A^T = [[1, 1, 1, 0], [0, 1, -1, -1]]
+      const int64_t ms = chunk * ocp;
+      for (int64_t t = 0; t < nt; ++t) {
+        const int64_t y0 = (t0 + t) / tiles_w * 2;
+        const int64_t x0 = (t0 + t) % tiles_w * 2;
+        const T* mt = m.data() + t * ocp;
+        // The 2x2 outputs go to y[i * 2 + j] first, so that the loop over
+        // the channels has no branches on the borders.
+        for (int i = 0; i < 2; ++i) {
+          // Rows i, i + 1 and i + 2 of M, A^T row i is [1, 1, 1, 0] or
+          // [0, 1, -1, -1].
+          const T* m0 = mt + 4 * i * ms;
+          const T* m1 = m0 + 4 * ms;
+          const T* m2 = m0 + 8 * ms;
+          T* y0i = y.data() + 2 * i * ocp;
+          T* y1i = y0i + ocp;
+          const T sign = i == 0 ? 1 : -1;
+          for (int64_t oc = 0; oc < ocg; ++oc) {
+            T am[4];
+            for (int j = 0; j < 4; ++j) {
+              am[j] =
+                  m0[j * ms + oc] + sign * (m1[j * ms + oc] + m2[j * ms + oc]);
+            }
+            y0i[oc] = am[0] + am[1] + am[2];
+            y1i[oc] = am[1] - am[2] - am[3];
+          }
+        }
+        for (int i = 0; i < 2 && y0 + i < s.out_h; ++i) {
+          for (int j = 0; j < 2 && x0 + j < s.out_w; ++j) {
+            const T* src = y.data() + (i * 2 + j) * ocp;
+            std::copy(src,
+                      src + ocg,
+                      out + ((y0 + i) * s.out_w + x0 + j) * s.out_c + g * ocg);
+          }
+        }
+      }
+    }
+  }
+}
+
+}  // namespace
+
+int DirectConvThreads() {
+#if defined(_OPENMP)
+  return omp_get_max_threads();
+#else
+  return 1;
+#endif
+}
+
+DirectConvAlgo SelectDirectConvAlgo(const Conv2dShape& s,
+                                    bool channel_last,
+                                    int threads,
+                                    bool cached_filter) {
+  if (s.batch <= 0 || s.groups <= 0 || s.in_c % s.groups != 0 ||
+      s.out_c % s.groups != 0 || s.out_h <= 0 || s.out_w <= 0) {
+    return DirectConvAlgo::kNone;
+  }
+  const int64_t icg = s.in_c / s.groups;
+  const int64_t ocg = s.out_c / s.groups;
+  const bool unit_stride = s.stride_h == 1 && s.stride_w == 1;
+  if (s.kernel_h == 1 && s.kernel_w == 1 && unit_stride && s.pad_top == 0 &&
+      s.pad_left == 0 && s.out_h == s.in_h && s.out_w == s.in_w) {
+    return channel_last && s.groups == 1 ? DirectConvAlgo::kGemm
+                                         : DirectConvAlgo::kNone;
+  }
+  // Most lanes of an oc block would idle, e.g. for depthwise convolutions.
+  if (ocg < kOcBlock / 2 || !unit_stride) {
+    return DirectConvAlgo::kNone;
+  }
+  threads = std::max(threads, 1);
+  if (s.kernel_h == 3 && s.kernel_w == 3 && s.dilation_h == 1 &&
+      s.dilation_w == 1) {
+    const int64_t tiles = s.batch * CeilDiv(s.out_h, 2) * CeilDiv(s.out_w, 2);
+    return icg >= 8 && WinogradChunk(s, threads) >= kWinogradMinChunk &&
+                   (cached_filter || tiles >= kWinogradMinTiles)
+               ? DirectConvAlgo::kWinograd
+               : DirectConvAlgo::kNone;
+  }
+  // The im2col buffer of larger filters is many times the input, and the
+  // micro kernel needs enough input channels to run at full speed. An image
+  // is split by output rows and oc blocks, which must keep the threads busy.
+  const int64_t tasks = s.groups * s.out_h * CeilDiv(ocg, kOcBlock);
+  return s.kernel_h * s.kernel_w > 9 && icg >= kOcBlock && tasks >= threads
+             ? DirectConvAlgo::kDirect
+             : DirectConvAlgo::kNone;
+}
+
+template <typename T>
+void DirectConv2d(const CPUContext& ctx,
+                  const Conv2dShape& s,
+                  bool channel_last,
+                  DirectConvAlgo algo,
+                  const T* input,
+                  const DenseTensor& filter,
+                  T* output) {
+  PADDLE_ENFORCE_EQ(
+      algo != DirectConvAlgo::kNone,
+      true,
+      common::errors::InvalidArgument(
+          "The conv2d of a %d x %d filter with %d groups does not suit the "
+          "direct convolution.",
+          s.kernel_h,
+          s.kernel_w,
+          s.groups));
+  if (algo == DirectConvAlgo::kGemm) {
+    auto blas = GetBlas<CPUContext, T>(ctx);
+    blas.GEMM(CblasNoTrans,
+              CblasTrans,
+              s.batch * s.in_h * s.in_w,
+              s.out_c,
+              s.in_c,
+              static_cast<T>(1),
+              input,
+              filter.data<T>(),
+              static_cast<T>(0),
+              output);
+    return;
+  }
+
+  const int64_t icg = s.in_c / s.groups;
+  const int64_t ocbs = CeilDiv(s.out_c / s.groups, kOcBlock);
+  const bool winograd = algo == DirectConvAlgo::kWinograd;
+  auto pack = [&]() -> std::shared_ptr<const void> {
+    auto packed = std::make_shared<std::vector<T>>();
+    if (winograd) {
+      packed->resize(s.groups * 16 * ocbs * icg * kOcBlock);
+      PackWinogradFilter(s, filter.data<T>(), packed->data());
+    } else {
+      packed->resize(s.groups * ocbs * s.kernel_h * s.kernel_w * icg *
+                     kOcBlock);
+      PackDirectFilter(s, filter.data<T>(), packed->data());
+    }
+    return packed;
+  };
+  // The packed filter only depends on the groups besides the filter dims.
+  auto packed = PackedWeightCache::Instance().GetOrPack(
+      filter,
+      winograd ? PackedLayout::kWinogradFilter : PackedLayout::kDirectFilter,
+      s.groups,
+      0,
+      pack);
+  if (!packed) {
+    packed = pack();
+  }
+  const T* packed_filter =
+      static_cast<const std::vector<T>*>(packed.get())->data();
+  // Stands for the input outside of the paddings.
+  std::vector<T> zeros(icg, static_cast<T>(0));
+
+  const int threads = DirectConvThreads();
+  const int64_t in_size = s.in_c * s.in_h * s.in_w;
+  const int64_t out_size = s.out_c * s.out_h * s.out_w;
+  DenseTensor in_image, out_image;
+  if (!channel_last) {
+    in_image.Resize({in_size});
+    out_image.Resize({out_size});
+    ctx.template Alloc<T>(&in_image);
+    ctx.template Alloc<T>(&out_image);
+  }
+  for (int64_t n = 0; n < s.batch; ++n) {
+    const T* in = input + n * in_size;
+    T* out = output + n * out_size;
+    if (!channel_last) {
+      TransposeImage(in, s.in_c, s.in_h * s.in_w, in_image.data<T>());
+      in = in_image.data<T>();
+      out = out_image.data<T>();
+    }
+    if (winograd) {
+      WinogradConvImage(s, threads, in, packed_filter, zeros.data(), out);
+    } else {
+      DirectConvImage(s, in, packed_filter, zeros.data(), out);
+    }
+    if (!channel_last) {
+      TransposeImage(out, s.out_h * s.out_w, s.out_c, output + n * out_size);
+    }
+  }
+}
+
+template TEST_API void DirectConv2d<float>(const CPUContext&,
+                                           const Conv2dShape&,
+                                           bool,
+                                           DirectConvAlgo,
+                                           const float*,
+                                           const DenseTensor&,
+                                           float*);
+template TEST_API void DirectConv2d<double>(const CPUContext&,
+                                            const Conv2dShape&,
+                                            bool,
+                                            DirectConvAlgo,
+                                            const double*,
+                                            const DenseTensor&,
+                                            double*);
+
+}  // namespace funcs
+}  // namespace phi
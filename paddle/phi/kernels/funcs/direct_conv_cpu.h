@@ -0,0 +1,92 @@
+/* Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#pragma once
+
+#include <cstdint>
+
+#include "paddle/common/flags.h"
+#include "paddle/phi/backends/cpu/cpu_context.h"
+#include "paddle/phi/core/dense_tensor.h"
+#include "paddle/utils/test_macros.h"
+
+PHI_DECLARE_bool(use_direct_conv_cpu);
+
+namespace phi {
+namespace funcs {
+
+// The shape of a 2D convolution with a [out_c, in_c / groups, kernel_h,
+// kernel_w] filter, the paddings are already resolved.
+struct Conv2dShape {
+  int64_t batch;
+  int64_t in_c;
+  int64_t in_h;
+  int64_t in_w;
+  int64_t out_c;
+  int64_t out_h;
+  int64_t out_w;
+  int kernel_h;
+  int kernel_w;
+  int stride_h;
+  int stride_w;
+  int pad_top;
+  int pad_left;
+  int dilation_h;
+  int dilation_w;
+  int groups;
+};
+
+// The ways of DirectConv2d, none of which materializes the im2col buffer:
+// - kGemm: 1x1 filters with stride 1 and no padding on NHWC data are a single
+//   GEMM.
+// - kWinograd: 3x3 filters with stride 1 and no dilation use Winograd
+//   F(2x2, 3x3), transforming a chunk of tiles at a time. The chunks must be
+//   large enough for the reads of the transformed filter, which rules out
+//   many channels or few tiles per thread.
+// - kDirect: larger filters with stride 1 accumulate blocks of 4 output pixels
+//   x 16 output channels over the filter window, with the filter packed by
+//   channel blocks.
+// kNone means the im2col path is better, e.g. for depthwise or strided
+// convolutions, outputs too small to keep the threads busy, or 1x1 NCHW
+// convolutions which are a GEMM on the input already.
+enum class DirectConvAlgo { kNone, kGemm, kWinograd, kDirect };
+
+// The threads DirectConv2d computes an image with, which is 1 without OpenMP.
+TEST_API int DirectConvThreads();
+
+// Picks the algo for threads, see DirectConvThreads. cached_filter tells if
+// the packed filter is cached, as the constant filters of the inference
+// predictors are, see PackedWeightCache. Otherwise it is packed at every
+// call, which only pays off for enough outputs.
+TEST_API DirectConvAlgo SelectDirectConvAlgo(const Conv2dShape& shape,
+                                             bool channel_last,
+                                             int threads,
+                                             bool cached_filter);
+
+// Computes the convolution of shape by algo, which SelectDirectConvAlgo
+// picked and is not kNone. input and output are NHWC if channel_last,
+// otherwise NCHW, which is transposed one image at a time, so the extra
+// memory is one input and one output image instead of the im2col buffer of
+// in_c * kernel_h * kernel_w * out_h * out_w.
+template <typename T>
+TEST_API void DirectConv2d(const CPUContext& ctx,
+                           const Conv2dShape& shape,
+                           bool channel_last,
+                           DirectConvAlgo algo,
+                           const T* input,
+                           const DenseTensor& filter,
+                           T* output);
+
+}  // namespace funcs
+}  // namespace phi
@@ -0,0 +1,236 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "paddle/common/enforce.h"
+#include "paddle/phi/common/float16.h"
+
+namespace phi {
+namespace funcs {
+
+enum class EmbSeqPoolCVMType { kSum, kAvg, kSqrt };
+
+inline EmbSeqPoolCVMType GetEmbSeqPoolCVMType(const std::string& pooltype) {
+  if (pooltype == "SUM") {
+    return EmbSeqPoolCVMType::kSum;
+  } else if (pooltype == "AVERAGE") {
+    return EmbSeqPoolCVMType::kAvg;
+  } else if (pooltype == "SQRT") {
+    return EmbSeqPoolCVMType::kSqrt;
+  }
+  PADDLE_THROW(common::errors::Unimplemented(
+      "The pooltype of the fused embedding sequence pool should be SUM, "
+      "AVERAGE or SQRT, but got %s.",
+      pooltype));
+}
+
+struct EmbSeqPoolCVMAttr {
+  EmbSeqPoolCVMType pool_type;
+  // Initial value of every pooled row, an empty sequence pools to it.
+  float pad_value;
+  // Replaces the show and click columns by log(show + 1) and
+  // log(click + 1) - log(show + 1) if true, drops the first `cvm_offset`
+  // columns otherwise.
+  bool use_cvm;
+  int cvm_offset;
+  // Width of the rows of the tables.
+  int64_t width;
+  // Ids equal to it are skipped, as the embedding of the padding id is zero.
+  int64_t padding_idx;
+
+  int64_t out_width() const { return use_cvm ? width : width - cvm_offset; }
+};
+
+// One slot of a batch. The rows pooled for the instance i of the batch are
+// the rows ids[lod[i]], ..., ids[lod[i + 1] - 1] of `table`, or the rows
+// lod[i], ..., lod[i + 1] - 1 of `table` itself when `ids` is null, i.e.
+// when the embeddings of the slot were already gathered.
+template <typename TableT, typename IdT>
+struct EmbSeqPoolCVMSlot {
+  const TableT* table;
+  // Per row scale of an int8 table, null for the other tables.
+  const float* row_scale;
+  int64_t table_height;
+  const IdT* ids;
+  const size_t* lod;
+  float* out;
+};
+
+// Rows are prefetched that many ids ahead of the row being added, which
+// hides the latency of the random accesses to a large table.
+static constexpr int kEmbSeqPoolPrefetchDistance = 4;
+
+template <typename TableT>
+inline void PrefetchEmbRow(const TableT* row, int64_t width) {
+#if defined(__GNUC__) || defined(__clang__)
+  const char* begin = reinterpret_cast<const char*>(row);
+  const char* end = reinterpret_cast<const char*>(row + width);
+  for (const char* line = begin; line < end; line += 64) {
+    __builtin_prefetch(line);
+  }
+#endif
+}
+
+template <typename TableT>
+inline void AddEmbRow(const TableT* row,
+                      float scale,
+                      int64_t width,
+                      float* out) {
+  for (int64_t j = 0; j < width; ++j) {
+    out[j] += static_cast<float>(row[j]);
+  }
+}
+
+template <>
+inline void AddEmbRow<int8_t>(const int8_t* row,
+                              float scale,
+                              int64_t width,
+                              float* out) {
+  for (int64_t j = 0; j < width; ++j) {
+    out[j] += scale * static_cast<float>(row[j]);
+  }
+}
+
+template <typename TableT, typename IdT>
+void CheckEmbSeqPoolCVMIds(const EmbSeqPoolCVMSlot<TableT, IdT>& slot,
+                           int64_t batch_size,
+                           int64_t padding_idx) {
+  if (slot.ids == nullptr) {
+    PADDLE_ENFORCE_LE(
+        slot.lod[batch_size],
+        static_cast<size_t>(slot.table_height),
+        common::errors::InvalidArgument(
+            "The lod of the input refers to row %d, but the input only has "
+            "%d rows.",
+            slot.lod[batch_size],
+            slot.table_height));
+    return;
+  }
+  for (size_t i = slot.lod[0]; i < slot.lod[batch_size]; ++i) {
+    int64_t id = static_cast<int64_t>(slot.ids[i]);
+    if (id == padding_idx) {
+      continue;
+    }
+    PADDLE_ENFORCE_EQ(
+        id >= 0 && id < slot.table_height,
+        true,
+        common::errors::InvalidArgument(
+            "Variable value (input) of OP(fused_embedding_seqpool_cvm) "
+            "expected >= 0 and < %ld, but got %ld. Please check input "
+            "value.",
+            slot.table_height,
+            id));
+  }
+}
+
+// Gathers, pools and applies CVM to every instance of every slot in one
+// pass, in parallel over the (slot, instance) pairs. The gathered rows are
+// never materialized: each one is added to the pooled row right away.
+template <typename TableT, typename IdT>
+void EmbSeqPoolCVM(const std::vector<EmbSeqPoolCVMSlot<TableT, IdT>>& slots,
+                   int64_t batch_size,
+                   const EmbSeqPoolCVMAttr& attr) {
+  int64_t num_slots = static_cast<int64_t>(slots.size());
+  int64_t width = attr.width;
+  int64_t out_width = attr.out_width();
+  PADDLE_ENFORCE_GT(out_width,
+                    0,
+                    common::errors::InvalidArgument(
+                        "The width of the output should be greater than 0, "
+                        "but got %d, the width of the embedding is %d and "
+                        "cvm_offset is %d.",
+                        out_width,
+                        width,
+                        attr.cvm_offset));
+  if (attr.use_cvm) {
+    PADDLE_ENFORCE_GT(
+        width,
+        2,
+        common::errors::InvalidArgument(
+            "The width of the embedding should be larger than 2 to use "
+            "CVM, but got %d.",
+            width));
+  }
+  // Checked ahead, so that no exception is thrown in the parallel region.
+  for (const auto& slot : slots) {
+    CheckEmbSeqPoolCVMIds(slot, batch_size, attr.padding_idx);
+  }
+
+#ifdef PADDLE_WITH_MKLML
+#pragma omp parallel
+#endif
+  {
+    std::vector<float> pooled(width);
+#ifdef PADDLE_WITH_MKLML
+#pragma omp for schedule(dynamic, 16)
+#endif
+    for (int64_t k = 0; k < num_slots * batch_size; ++k) {
+      const auto& slot = slots[k / batch_size];
+      int64_t ins = k % batch_size;
+      size_t begin = slot.lod[ins];
+      size_t end = slot.lod[ins + 1];
+      auto row_of = [&slot](size_t i) {
+        return slot.ids ? static_cast<int64_t>(slot.ids[i])
+                        : static_cast<int64_t>(i);
+      };
+
+      std::fill(pooled.begin(), pooled.end(), attr.pad_value);
+      for (size_t i = begin; i < end; ++i) {
+        if (i + kEmbSeqPoolPrefetchDistance < end) {
+          int64_t next = row_of(i + kEmbSeqPoolPrefetchDistance);
+          if (next != attr.padding_idx) {
+            PrefetchEmbRow(slot.table + next * width, width);
+          }
+        }
+        int64_t row = row_of(i);
+        if (row == attr.padding_idx) {
+          continue;
+        }
+        AddEmbRow(slot.table + row * width,
+                  slot.row_scale ? slot.row_scale[row] : 1.0f,
+                  width,
+                  pooled.data());
+      }
+
+      size_t length = end - begin;
+      if (length > 0 && attr.pool_type != EmbSeqPoolCVMType::kSum) {
+        float scale = attr.pool_type == EmbSeqPoolCVMType::kAvg
+                          ? 1.0f / static_cast<float>(length)
+                          : 1.0f / std::sqrt(static_cast<float>(length));
+        for (int64_t j = 0; j < width; ++j) {
+          pooled[j] *= scale;
+        }
+      }
+
+      float* out = slot.out + ins * out_width;
+      if (attr.use_cvm) {
+        out[0] = std::log(pooled[0] + 1);
+        out[1] = std::log(pooled[1] + 1) - out[0];
+        std::copy(pooled.begin() + 2, pooled.end(), out + 2);
+      } else {
+        std::copy(pooled.begin() + attr.cvm_offset, pooled.end(), out);
+      }
+    }
+  }
+}
+
+}  // namespace funcs
+}  // namespace phi
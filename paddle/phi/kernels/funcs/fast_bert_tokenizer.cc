@@ -0,0 +1,404 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/phi/kernels/funcs/fast_bert_tokenizer.h"
+
+#include <utf8proc.h>
+
+#include <algorithm>
+#include <functional>
+#include <mutex>  // NOLINT
+#include <set>
+#include <unordered_map>
+#include <utility>
+
+#include "glog/logging.h"
+
+namespace phi {
+namespace funcs {
+
+namespace {
+
+// Converts a vocabulary token to UTF-8, false if it holds an invalid code
+// point (such a token can never be matched by valid UTF-8 text).
+bool ToUtf8(const std::wstring& token, std::string* out) {
+  out->clear();
+  utf8proc_uint8_t buf[4];
+  for (wchar_t ch : token) {
+    utf8proc_ssize_t n =
+        utf8proc_encode_char(static_cast<utf8proc_int32_t>(ch), buf);
+    if (n <= 0) return false;
+    out->append(reinterpret_cast<const char*>(buf), n);
+  }
+  return true;
+}
+
+constexpr size_t kMaxCachedVocabs = 8;
+
+// Free slots tried for a node before the region is considered crowded.
+constexpr size_t kMaxFitTries = 64;
+
+// Tells a cached vocab apart from another one allocated at the same address:
+// a different vocab differs in size or, almost always, in the entry iterated
+// first. Unlike hashing every entry, it costs O(1) per tokenizer.
+uint64_t VocabStamp(const Vocab& vocab) {
+  uint64_t stamp = vocab.size() * 0x9e3779b97f4a7c15ULL;
+  if (vocab.size() > 0) {
+    auto first = vocab.begin();
+    stamp ^= std::hash<std::wstring>()(first->first) +
+             static_cast<uint64_t>(first->second);
+  }
+  return stamp;
+}
+
+}  // namespace
+
+WordPieceTrie::WordPieceTrie(const Vocab& vocab) {
+  std::vector<std::pair<std::string, int32_t>> keys;
+  keys.reserve(vocab.size());
+  std::string bytes;
+  for (auto& item : vocab) {
+    if (!item.first.empty() && ToUtf8(item.first, &bytes)) {
+      keys.emplace_back(bytes, item.second);
+    }
+  }
+  std::sort(keys.begin(), keys.end());
+
+  // Node 0 is the root. Free slots have check < 0; slot 0 is never a child
+  // since every base is at least 1.
+  base_.assign(1, 0);
+  check_.assign(1, -1);
+  value_.assign(1, -1);
+
+  // Keys [begin, end) share the prefix of length `depth` leading to `node`.
+  struct Range {
+    int32_t node;
+    size_t begin;
+    size_t end;
+    size_t depth;
+  };
+  struct Child {
+    uint8_t label;
+    size_t begin;
+    size_t end;
+  };
+  std::vector<Range> ranges{{0, 0, keys.size(), 0}};
+  std::vector<Child> children;
+  std::set<size_t> free_slots;
+  size_t crowded_end = 1;
+  while (!ranges.empty()) {
+    Range range = ranges.back();
+    ranges.pop_back();
+
+    size_t i = range.begin;
+    // The key equal to the prefix sorts first.
+    if (i < range.end && keys[i].first.size() == range.depth) {
+      value_[range.node] = keys[i].second;
+      ++i;
+    }
+    children.clear();
+    while (i < range.end) {
+      uint8_t label = static_cast<uint8_t>(keys[i].first[range.depth]);
+      size_t j = i + 1;
+      while (j < range.end &&
+             static_cast<uint8_t>(keys[j].first[range.depth]) == label) {
+        ++j;
+      }
+      children.push_back({label, i, j});
+      i = j;
+    }
+    if (children.empty()) continue;
+
+    // First fit: the smallest base placing every child in a free slot. The
+    // holes left behind are mostly too small for a node with many children,
+    // so such nodes skip the regions earlier searches found crowded.
+    size_t start = std::max<size_t>(children[0].label + 1,
+                                    children.size() > 1 ? crowded_end : 1);
+    size_t base = 0;
+    auto it = free_slots.lower_bound(start);
+    for (size_t num_tries = 0;; ++num_tries) {
+      // Every slot past the end is free, so the first one always fits.
+      size_t pos = it != free_slots.end() ? *it++
+                                          : std::max(start, check_.size());
+      base = pos - children[0].label;
+      bool fits = std::all_of(
+          children.begin(), children.end(), [&](const Child& child) {
+            size_t t = base + child.label;
+            return t >= check_.size() || check_[t] < 0;
+          });
+      if (fits) break;
+      if (num_tries == kMaxFitTries) crowded_end = pos;
+    }
+    size_t size = base + children.back().label + 1;
+    for (size_t t = check_.size(); t < size; ++t) {
+      free_slots.insert(free_slots.end(), t);
+    }
+    if (size > check_.size()) {
+      base_.resize(size, 0);
+      check_.resize(size, -1);
+      value_.resize(size, -1);
+    }
+    base_[range.node] = static_cast<int32_t>(base);
+    for (auto& child : children) {
+      int32_t t = static_cast<int32_t>(base + child.label);
+      check_[t] = range.node;
+      free_slots.erase(t);
+      ranges.push_back({t, child.begin, child.end, range.depth + 1});
+    }
+  }
+
+  int32_t node = Next(Root(), '#');
+  suffix_root_ = node < 0 ? -1 : Next(node, '#');
+  VLOG(3) << "Built the WordPiece trie of " << keys.size() << " tokens with "
+          << check_.size() << " slots.";
+}
+
+int32_t WordPieceTrie::Find(const char* data, size_t size) const {
+  int32_t node = Root();
+  for (size_t i = 0; i < size && node >= 0; ++i) {
+    node = Next(node, static_cast<uint8_t>(data[i]));
+  }
+  return node > 0 ? Value(node) : -1;
+}
+
+std::shared_ptr<const WordPieceTrie> WordPieceTrie::Get(const Vocab& vocab) {
+  // The vocab of faster_tokenizer is a persistable variable loaded once, so
+  // its address identifies it. The stamp catches a vocab that is reloaded,
+  // or freed and another one allocated at the same address.
+  static std::mutex mutex;
+  static std::unordered_map<
+      const Vocab*,
+      std::pair<uint64_t, std::shared_ptr<const WordPieceTrie>>>
+      cache;
+  uint64_t stamp = VocabStamp(vocab);
+  std::lock_guard<std::mutex> lock(mutex);
+  auto it = cache.find(&vocab);
+  if (it != cache.end() && it->second.first == stamp) {
+    return it->second.second;
+  }
+  // Only a few vocabs are alive at any time, drop stale tries of freed ones.
+  if (it == cache.end() && cache.size() >= kMaxCachedVocabs) {
+    cache.clear();
+  }
+  auto trie = std::make_shared<const WordPieceTrie>(vocab);
+  cache[&vocab] = std::make_pair(stamp, trie);
+  return trie;
+}
+
+FastBertTokenizer::FastBertTokenizer(const Vocab* vocab,
+                                     bool do_lower_case,
+                                     size_t max_input_chars_per_word)
+    : trie_(WordPieceTrie::Get(*vocab)),
+      do_lower_case_(do_lower_case),
+      max_input_chars_per_word_(max_input_chars_per_word) {
+  unk_token_id_ = vocab->at(L"[UNK]");
+  pad_token_id_ = vocab->at(L"[PAD]");
+  cls_token_id_ = vocab->at(L"[CLS]");
+  sep_token_id_ = vocab->at(L"[SEP]");
+}
+
+void FastBertTokenizer::WordPiece(const char* word,
+                                  size_t size,
+                                  size_t num_chars,
+                                  std::vector<int64_t>* ids) const {
+  if (num_chars > max_input_chars_per_word_) {
+    ids->push_back(unk_token_id_);
+    return;
+  }
+  // Greedy longest match first. A token is valid UTF-8, so a match always
+  // ends on a character boundary, like the substrings BertTokenizer tries.
+  const size_t num_ids = ids->size();
+  size_t start = 0;
+  while (start < size) {
+    int32_t node = start == 0 ? trie_->Root() : trie_->SuffixRoot();
+    int32_t match_id = -1;
+    size_t match_end = start;
+    for (size_t i = start; i < size && node >= 0; ++i) {
+      node = trie_->Next(node, static_cast<uint8_t>(word[i]));
+      if (node >= 0 && trie_->Value(node) >= 0) {
+        match_id = trie_->Value(node);
+        match_end = i + 1;
+      }
+    }
+    if (match_id < 0) {
+      ids->resize(num_ids);
+      ids->push_back(unk_token_id_);
+      return;
+    }
+    ids->push_back(match_id);
+    start = match_end;
+  }
+}
+
+void FastBertTokenizer::Tokenize(const std::string& text,
+                                 std::vector<int64_t>* ids) const {
+  const size_t num_ids = ids->size();
+  std::string word;
+  size_t word_chars = 0;
+  auto FlushWord = [&]() {
+    if (word_chars > 0) {
+      WordPiece(word.data(), word.size(), word_chars, ids);
+      word.clear();
+      word_chars = 0;
+    }
+  };
+
+  const auto* data = reinterpret_cast<const utf8proc_uint8_t*>(text.data());
+  utf8proc_ssize_t remaining = static_cast<utf8proc_ssize_t>(text.size());
+  utf8proc_uint8_t buf[4];
+  while (remaining > 0) {
+    utf8proc_int32_t ch = -1;
+    utf8proc_ssize_t len = utf8proc_iterate(data, remaining, &ch);
+    if (len <= 0 || ch < 0) {
+      // Like a failed conversion to std::wstring, drop the whole text.
+      ids->resize(num_ids);
+      return;
+    }
+    const utf8proc_uint8_t* bytes = data;
+    data += len;
+    remaining -= len;
+
+    if (ch == 0 || ch == 0xfffd || IsControl(ch)) continue;
+    if (do_lower_case_) {
+      utf8proc_int32_t lower = utf8proc_tolower(ch);
+      if (lower != ch) {
+        ch = lower;
+        len = utf8proc_encode_char(ch, buf);
+        bytes = buf;
+      }
+    }
+    if (IsChineseChar(ch) || IsPunctuation(ch)) {
+      FlushWord();
+      WordPiece(reinterpret_cast<const char*>(bytes), len, 1, ids);
+    } else if (IsWhiteSpace(ch)) {
+      FlushWord();
+    } else {
+      word.append(reinterpret_cast<const char*>(bytes), len);
+      ++word_chars;
+    }
+  }
+  FlushWord();
+}
+
+bool FastBertTokenizer::SplitChars(const std::string& text,
+                                   std::vector<int64_t>* ids) const {
+  const auto* data = reinterpret_cast<const utf8proc_uint8_t*>(text.data());
+  utf8proc_ssize_t remaining = static_cast<utf8proc_ssize_t>(text.size());
+  while (remaining > 0) {
+    utf8proc_int32_t ch = -1;
+    utf8proc_ssize_t len = utf8proc_iterate(data, remaining, &ch);
+    if (len <= 0 || ch < 0) return false;
+    int32_t id = trie_->Find(reinterpret_cast<const char*>(data), len);
+    ids->push_back(id >= 0 ? id : unk_token_id_);
+    data += len;
+    remaining -= len;
+  }
+  return true;
+}
+
+bool FastBertTokenizer::Encode(const std::string& text,
+                               const std::string* text_pair,
+                               bool is_split_into_words,
+                               size_t max_seq_len,
+                               bool pad_to_max_seq_len,
+                               std::vector<int64_t>* ids,
+                               std::vector<int64_t>* pair_ids,
+                               EncodedSequence* out) const {
+  ids->clear();
+  pair_ids->clear();
+  if (!is_split_into_words) {
+    Tokenize(text, ids);
+    if (ids->empty()) return false;
+    if (text_pair != nullptr && !text_pair->empty()) {
+      Tokenize(*text_pair, pair_ids);
+      if (pair_ids->empty()) return false;
+    }
+  } else if (!SplitChars(text, ids)) {
+    return false;
+  }
+
+  // Truncate the longer sequence one token at a time.
+  const size_t num_special_tokens = pair_ids->empty() ? 2 : 3;
+  size_t total_len = ids->size() + pair_ids->size() + num_special_tokens;
+  if (max_seq_len > 0 && total_len > max_seq_len) {
+    for (size_t i = total_len - max_seq_len;
+         i > 0 && !(ids->empty() && pair_ids->empty());
+         --i) {
+      if (pair_ids->empty() || ids->size() > pair_ids->size()) {
+        ids->pop_back();
+      } else {
+        pair_ids->pop_back();
+      }
+    }
+  }
+
+  std::vector<int64_t>& seq = out->ids;
+  seq.clear();
+  seq.reserve(ids->size() + pair_ids->size() + 3);
+  seq.push_back(cls_token_id_);
+  seq.insert(seq.end(), ids->begin(), ids->end());
+  seq.push_back(sep_token_id_);
+  out->first_segment_len = seq.size();
+  if (!pair_ids->empty()) {
+    seq.insert(seq.end(), pair_ids->begin(), pair_ids->end());
+    seq.push_back(sep_token_id_);
+  }
+  if (max_seq_len > 0 && seq.size() > max_seq_len) {
+    VLOG(3) << "There is something wrong with the input sequence length."
+               " Please check it.";
+    return false;
+  }
+  out->padded_len = pad_to_max_seq_len && max_seq_len > 0
+                        ? std::max(seq.size(), max_seq_len)
+                        : seq.size();
+  return true;
+}
+
+void FastBertTokenizer::BatchEncode(std::vector<EncodedSequence>* batch,
+                                    const Strings& batch_text,
+                                    const Strings& batch_text_pair,
+                                    bool is_split_into_words,
+                                    size_t max_seq_len,
+                                    bool pad_to_max_seq_len) const {
+  const bool has_text_pair = batch_text_pair.size() != 0;
+  const int64_t batch_size = static_cast<int64_t>(batch_text.size());
+  batch->resize(batch_size);
+#ifdef PADDLE_WITH_MKLML
+#pragma omp parallel for
+#endif
+  for (int64_t i = 0; i < batch_size; ++i) {
+    std::vector<int64_t> ids, pair_ids;
+    EncodedSequence& out = (*batch)[i];
+    bool status = Encode(batch_text[i],
+                         has_text_pair ? &batch_text_pair[i] : nullptr,
+                         is_split_into_words,
+                         max_seq_len,
+                         pad_to_max_seq_len,
+                         &ids,
+                         &pair_ids,
+                         &out);
+    if (!status) {
+      out.ids = has_text_pair ? std::vector<int64_t>{cls_token_id_,
+                                                     sep_token_id_,
+                                                     cls_token_id_}
+                              : std::vector<int64_t>{cls_token_id_,
+                                                     sep_token_id_};
+      out.first_segment_len = 2;
+      out.padded_len = out.ids.size();
+    }
+  }
+}
+
+}  // namespace funcs
+}  // namespace phi
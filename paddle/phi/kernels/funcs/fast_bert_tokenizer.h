@@ -0,0 +1,169 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <utf8proc.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "paddle/phi/core/vocab/string_array.h"
+#include "paddle/utils/test_macros.h"
+
+namespace phi {
+namespace funcs {
+
+inline bool IsControl(const wchar_t& ch) {
+  if (ch == L'\t' || ch == L'\n' || ch == L'\r') return false;
+  auto cat = utf8proc_category(ch);
+  if (cat == UTF8PROC_CATEGORY_CC || cat == UTF8PROC_CATEGORY_CF) return true;
+  return false;
+}
+
+inline bool IsChineseChar(const wchar_t& ch) {
+  if ((ch >= 0x4E00 && ch <= 0x9FFF) || (ch >= 0x3400 && ch <= 0x4DBF) ||
+      (ch >= 0x20000 && ch <= 0x2A6DF) || (ch >= 0x2A700 && ch <= 0x2B73F) ||
+      (ch >= 0x2B740 && ch <= 0x2B81F) || (ch >= 0x2B820 && ch <= 0x2CEAF) ||
+      (ch >= 0xF900 && ch <= 0xFAFF) || (ch >= 0x2F800 && ch <= 0x2FA1F))
+    return true;
+  return false;
+}
+
+inline bool IsWhiteSpace(const wchar_t& ch) {
+  if (ch == L' ' || ch == L'\t' || ch == L'\n' || ch == L'\r') return true;
+  auto cat = utf8proc_category(ch);
+  if (cat == UTF8PROC_CATEGORY_ZS) return true;
+  return false;
+}
+
+inline bool IsPunctuation(const wchar_t& ch) {
+  if ((ch >= 33 && ch <= 47) || (ch >= 58 && ch <= 64) ||
+      (ch >= 91 && ch <= 96) || (ch >= 123 && ch <= 126))
+    return true;
+  auto cat = utf8proc_category(ch);
+  if (cat == UTF8PROC_CATEGORY_PD || cat == UTF8PROC_CATEGORY_PS ||
+      cat == UTF8PROC_CATEGORY_PE || cat == UTF8PROC_CATEGORY_PC ||
+      cat == UTF8PROC_CATEGORY_PO  // sometimes ¶ belong SO
+      || cat == UTF8PROC_CATEGORY_PI || cat == UTF8PROC_CATEGORY_PF)
+    return true;
+  return false;
+}
+
+// Double-array trie over the UTF-8 bytes of a WordPiece vocabulary. The
+// child of node s along byte c is t = base[s] + c if check[t] == s, so a
+// transition costs one addition and one compare. Continuation pieces are
+// stored with their "##" prefix, matching inside a word starts from the node
+// of "##".
+class WordPieceTrie {
+ public:
+  TEST_API explicit WordPieceTrie(const Vocab& vocab);
+
+  // Returns the trie of `vocab`. Building it walks the whole vocabulary, so
+  // it is cached and shared by all later calls with the same vocab. The
+  // cache is keyed on the address, size and first entry of the vocab, so a
+  // vocab must not be edited in place once it is used.
+  TEST_API static std::shared_ptr<const WordPieceTrie> Get(const Vocab& vocab);
+
+  int32_t Root() const { return 0; }
+
+  // Node of "##", -1 if no token starts with it.
+  int32_t SuffixRoot() const { return suffix_root_; }
+
+  // Child of `node` along `byte`, -1 if there is none.
+  int32_t Next(int32_t node, uint8_t byte) const {
+    size_t t = static_cast<size_t>(base_[node]) + byte;
+    return t < check_.size() && check_[t] == node ? static_cast<int32_t>(t)
+                                                  : -1;
+  }
+
+  // Id of the token ending at `node`, -1 if no token ends there.
+  int32_t Value(int32_t node) const { return value_[node]; }
+
+  // Id of the token data[0, size), -1 if it is not in the vocabulary.
+  TEST_API int32_t Find(const char* data, size_t size) const;
+
+  size_t NumNodes() const { return check_.size(); }
+
+ private:
+  std::vector<int32_t> base_;
+  std::vector<int32_t> check_;
+  std::vector<int32_t> value_;
+  int32_t suffix_root_ = -1;
+};
+
+// One encoded sequence: [CLS] a [SEP] or [CLS] a [SEP] b [SEP].
+struct EncodedSequence {
+  std::vector<int64_t> ids;
+  // Tokens [0, first_segment_len) have token type 0, the rest of `ids` 1.
+  size_t first_segment_len = 0;
+  // Length after padding to max_seq_len, ids beyond `ids` are the pad id.
+  size_t padded_len = 0;
+};
+
+// BERT tokenizer working on UTF-8 bytes, producing exactly the same ids as
+// the former std::wstring based BertTokenizer. The text is never converted
+// to std::wstring and no string is allocated per token: words are split
+// while decoding, and each wordpiece is the longest match found by one walk
+// down the WordPieceTrie instead of one hash lookup per candidate substring.
+class FastBertTokenizer {
+ public:
+  TEST_API FastBertTokenizer(const Vocab* vocab,
+                             bool do_lower_case,
+                             size_t max_input_chars_per_word = 100);
+
+  // Appends the wordpiece ids of `text`. Nothing is appended for text that
+  // is not valid UTF-8.
+  TEST_API void Tokenize(const std::string& text,
+                         std::vector<int64_t>* ids) const;
+
+  // Encodes every text (and text pair, if `batch_text_pair` is not empty)
+  // in parallel, truncating and padding each one to `max_seq_len`.
+  TEST_API void BatchEncode(std::vector<EncodedSequence>* batch,
+                            const Strings& batch_text,
+                            const Strings& batch_text_pair,
+                            bool is_split_into_words,
+                            size_t max_seq_len,
+                            bool pad_to_max_seq_len) const;
+
+  int64_t GetPadTokenID() const { return pad_token_id_; }
+
+ private:
+  void WordPiece(const char* word,
+                 size_t size,
+                 size_t num_chars,
+                 std::vector<int64_t>* ids) const;
+
+  // Looks every character up on its own, see `is_split_into_words`.
+  bool SplitChars(const std::string& text, std::vector<int64_t>* ids) const;
+
+  bool Encode(const std::string& text,
+              const std::string* text_pair,
+              bool is_split_into_words,
+              size_t max_seq_len,
+              bool pad_to_max_seq_len,
+              std::vector<int64_t>* ids,
+              std::vector<int64_t>* pair_ids,
+              EncodedSequence* out) const;
+
+  std::shared_ptr<const WordPieceTrie> trie_;
+  bool do_lower_case_;
+  size_t max_input_chars_per_word_;
+  int64_t unk_token_id_, pad_token_id_, cls_token_id_, sep_token_id_;
+};
+
+}  // namespace funcs
+}  // namespace phi
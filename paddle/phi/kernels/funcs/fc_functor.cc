@@ -17,10 +17,34 @@ limitations under the License. */
 #include "paddle/phi/backends/all_context.h"
 #include "paddle/phi/kernels/funcs/blas/blas.h"
 #include "paddle/phi/kernels/funcs/jit/kernels.h"
+#include "paddle/phi/kernels/funcs/packed_gemm_cache.h"
 
 namespace phi {
 namespace funcs {
 
+// Y = src + B, with relu if asked, where the rows of src are src_stride apart.
+template <typename T>
+static void AddBias(const int M,
+                    const int N,
+                    const T* src,
+                    int src_stride,
+                    const T* B,
+                    bool relu,
+                    T* Y) {
+  auto compute = relu ? phi::jit::KernelFuncs<phi::jit::VAddReluTuple<T>,
+                                              phi::CPUPlace>::Cache()
+                            .At(N)
+                      : phi::jit::KernelFuncs<phi::jit::VAddTuple<T>,
+                                              phi::CPUPlace>::Cache()
+                            .At(N);
+#ifdef PADDLE_WITH_MKLML
+#pragma omp parallel for
+#endif
+  for (int i = 0; i < M; i++) {
+    compute(B, src + i * src_stride, Y + i * N, N);
+  }
+}
+
 template <typename DeviceContext, typename T>
 void FCFunctor<DeviceContext, T>::operator()(const DeviceContext& context,
                                              const int M,
@@ -81,20 +105,37 @@ void FCFunctor<DeviceContext, T>::operator()(const DeviceContext& context,
         errors::PermissionDenied("When bias is NULL, relu can not be true."));
     return;
   }
-  auto compute = relu ? phi::jit::KernelFuncs<phi::jit::VAddReluTuple<T>,
-                                              phi::CPUPlace>::Cache()
-                            .At(N)
-                      : phi::jit::KernelFuncs<phi::jit::VAddTuple<T>,
-                                              phi::CPUPlace>::Cache()
-                            .At(N);
-#ifdef PADDLE_WITH_MKLML
-#pragma omp parallel for
-#endif
-  for (int i = 0; i < M; i++) {
-    T* dst = Y + i * N;
-    T* src = (padding_weights) ? Y1_data + i * (N + 4) : dst;
-    compute(B, src, dst, N);
+  if (padding_weights) {
+    AddBias(M, N, Y1_data, N + 4, B, relu, Y);
+  } else {
+    AddBias(M, N, Y, N, B, relu, Y);
+  }
+}
+
+template <typename DeviceContext, typename T>
+void FCFunctor<DeviceContext, T>::operator()(const DeviceContext& context,
+                                             const int M,
+                                             const int N,
+                                             const int K,
+                                             const T* X,
+                                             const DenseTensor& W,
+                                             T* Y,
+                                             const T* B,
+                                             bool relu,
+                                             bool padding_weights) {
+  if (padding_weights ||
+      !PackedGemm(context, M, N, K, X, W, false, static_cast<T>(0), Y)) {
+    (*this)(context, M, N, K, X, W.data<T>(), Y, B, relu, padding_weights);
+    return;
+  }
+  if (B == nullptr) {
+    PADDLE_ENFORCE_EQ(
+        relu,
+        false,
+        errors::PermissionDenied("When bias is NULL, relu can not be true."));
+    return;
   }
+  AddBias(M, N, Y, N, B, relu, Y);
 }
 
 template class FCFunctor<CPUContext, float>;
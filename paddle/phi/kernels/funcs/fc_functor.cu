@@ -369,6 +369,20 @@ void FCFunctor<DeviceContext, T>::operator()(const DeviceContext& context,
   AddReluKernel(context.stream(), M, N, Y, B, relu);
 }
 
+template <typename DeviceContext, typename T>
+void FCFunctor<DeviceContext, T>::operator()(const DeviceContext& context,
+                                             const int M,
+                                             const int N,
+                                             const int K,
+                                             const T* X,
+                                             const DenseTensor& W,
+                                             T* Y,
+                                             const T* B,
+                                             bool relu,
+                                             bool padding_weights) {
+  (*this)(context, M, N, K, X, W.data<T>(), Y, B, relu, padding_weights);
+}
+
 template class FCFunctor<GPUContext, float16>;
 template class FCFunctor<GPUContext, float>;
 template class FCFunctor<GPUContext, double>;
@@ -35,6 +35,19 @@ class FCFunctor {
                   const T* B = nullptr,
                   bool relu = false,
                   bool weight_pass = false);
+
+  // The same as above for a constant W, whose packed copy is reused by the
+  // later calls on CPU, see packed_gemm_cache.h.
+  void operator()(const DeviceContext& context,
+                  const int M,
+                  const int N,
+                  const int K,
+                  const T* X,
+                  const DenseTensor& W,
+                  T* Y,
+                  const T* B = nullptr,
+                  bool relu = false,
+                  bool weight_pass = false);
 };
 
 template <typename DeviceContext, typename T>
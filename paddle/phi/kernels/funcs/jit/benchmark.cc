@@ -426,6 +426,22 @@ void BenchKernelLayerNorm() {
   }
 }
 
+template <typename KernelTuple, typename PlaceType>
+void BenchKernelSoftmax() {
+  using T = typename KernelTuple::data_type;
+  for (int bs : {1, 2, 16}) {
+    for (int n : TestSizes()) {
+      phi::DenseTensor x, y;
+      x.Resize({bs, n});
+      y.Resize({bs, n});
+      RandomVec<T>(bs * n, x.mutable_data<T>(PlaceType()), -2.f, 2.f);
+      const T* x_data = x.data<T>();
+      T* y_data = y.mutable_data<T>(PlaceType());
+      BenchAllImpls<KernelTuple, PlaceType>(n, x_data, y_data, n, bs);
+    }
+  }
+}
+
 template <typename KernelTuple, typename PlaceType>
 void BenchKernelCRFDecoding() {
   using T = typename KernelTuple::data_type;
@@ -476,6 +492,7 @@ void BenchKernelVBroadcast() {
 #define BenchKernelVAdd BenchKernelXYZN
 #define BenchKernelVAddRelu BenchKernelXYZN
 #define BenchKernelVSub BenchKernelXYZN
+#define BenchKernelVSwiGLU BenchKernelXYZN
 
 #define BenchKernelVScal BenchKernelAXYN
 #define BenchKernelVAddBias BenchKernelAXYN
@@ -486,6 +503,7 @@ void BenchKernelVBroadcast() {
 #define BenchKernelVExp BenchKernelXYN
 #define BenchKernelVSigmoid BenchKernelXYN
 #define BenchKernelVTanh BenchKernelXYN
+#define BenchKernelVGelu BenchKernelXYN
 #define BenchKernelVCopy BenchKernelXYN
 
 #define BenchKernelLSTMCtHt BenchKernelLSTM
@@ -507,6 +525,7 @@ BENCH_FP32_CPU(VMul);
 BENCH_FP32_CPU(VAdd);
 BENCH_FP32_CPU(VAddRelu);
 BENCH_FP32_CPU(VSub);
+BENCH_FP32_CPU(VSwiGLU);
 
 // axyn
 BENCH_FP32_CPU(VScal);
@@ -519,6 +538,7 @@ BENCH_FP32_CPU(VSquare);
 BENCH_FP32_CPU(VExp);
 BENCH_FP32_CPU(VSigmoid);
 BENCH_FP32_CPU(VTanh);
+BENCH_FP32_CPU(VGelu);
 BENCH_FP32_CPU(VCopy);
 
 // LSTM
@@ -531,6 +551,7 @@ BENCH_FP32_CPU(GRUHtPart1);
 BENCH_FP32_CPU(GRUHtPart2);
 
 BENCH_FP32_CPU(LayerNorm);
+BENCH_FP32_CPU(Softmax);
 BENCH_FP32_CPU(CRFDecoding);
 
 BENCH_FP32_CPU(SeqPool);
@@ -539,7 +560,7 @@ BENCH_FP32_CPU(MatMul);
 BENCH_FP32_CPU(Sgd);
 BENCH_FP32_CPU(VBroadcast);
 
-// Benchmark all jit kernels including jitcode, mkl and refer.
+// Benchmark all jit kernels including jitcode, mkl, mixed and refer.
 // To use this tool, run command: ./benchmark [options...]
 // Options:
 //     --burning: the burning time before count
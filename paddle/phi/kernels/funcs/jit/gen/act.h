@@ -59,6 +59,8 @@ extern int g_tmp_mem[];
 #define OFFSET_EXP_MAX_INPUT 14 * YMM_FLOAT_BLOCK * sizeof(float)
 #define OFFSET_SIGMOID_MAX 15 * YMM_FLOAT_BLOCK * sizeof(float)
 #define OFFSET_SIGMOID_MIN 16 * YMM_FLOAT_BLOCK * sizeof(float)
+#define OFFSET_GELU_SQRT_2_PI 17 * YMM_FLOAT_BLOCK * sizeof(float)
+#define OFFSET_GELU_COEFF 18 * YMM_FLOAT_BLOCK * sizeof(float)
 
 class VActFunc : public JitCode {
  public:
@@ -232,6 +234,37 @@ class VActFunc : public JitCode {
     pop(reg_ptr_global);
   }
 
+  // compute GELU with ymm, xmm, src should not be dst
+  template <typename JMM>
+  void gelu_jmm(JMM& dst,          // NOLINT
+                JMM& src,          // NOLINT
+                int src_idx = 11,  // NOLINT
+                int fx_idx = 12,
+                int fy_idx = 13,
+                int mask_idx = 14,
+                int tmp_idx = 15) {
+    // y = 0.5 * x * (1 + tanh(sqrt(2 / pi) * (x + 0.044715 * x^3)))
+    JMM jmm_tmp = JMM(tmp_idx);
+    reg64_t reg_ptr_global = rax;
+    push(reg_ptr_global);
+    mov(reg_ptr_global, reinterpret_cast<size_t>(exp_float_consts));
+    vmulps(dst, src, src);
+    vmovaps(jmm_tmp, ptr[reg_ptr_global + OFFSET_GELU_COEFF]);
+    vmulps(dst, dst, jmm_tmp);
+    vmovaps(jmm_tmp, ptr[reg_ptr_global + OFFSET_EXP_ONE]);
+    vaddps(dst, dst, jmm_tmp);
+    vmulps(dst, dst, src);
+    vmovaps(jmm_tmp, ptr[reg_ptr_global + OFFSET_GELU_SQRT_2_PI]);
+    vmulps(dst, dst, jmm_tmp);
+    tanh_jmm<JMM>(dst, dst, src_idx, fx_idx, fy_idx, mask_idx, tmp_idx);
+    vmovaps(jmm_tmp, ptr[reg_ptr_global + OFFSET_EXP_ONE]);
+    vaddps(dst, dst, jmm_tmp);
+    vmulps(dst, dst, src);
+    vmovaps(jmm_tmp, ptr[reg_ptr_global + OFFSET_EXP_0P5]);
+    vmulps(dst, dst, jmm_tmp);
+    pop(reg_ptr_global);
+  }
+
   // compute IDENTITY with ymm, xmm
   template <typename JMM>
   void identity_jmm(JMM& dst, JMM& src, int zero_idx) {  // NOLINT
@@ -264,6 +297,9 @@ class VActFunc : public JitCode {
       case operand_type::IDENTITY:
         identity_jmm<JMM>(dst, src, 15);
         break;
+      case operand_type::GELU:
+        gelu_jmm<JMM>(dst, src, 11, 12, 13, 14, 15);
+        break;
       default:
         PADDLE_THROW(common::errors::Unimplemented(
             "Do not support operand type code: %d.", type));
@@ -281,7 +317,8 @@ class VActJitCode : public VActFunc {
       : VActFunc(code_size, code_ptr), num_(d), type_(type) {
     if (!(type_ == operand_type::RELU || type_ == operand_type::EXP ||
           type_ == operand_type::SIGMOID || type_ == operand_type::TANH ||
-          type_ == operand_type::IDENTITY || type_ == operand_type::SQUARE)) {
+          type_ == operand_type::IDENTITY || type_ == operand_type::SQUARE ||
+          type_ == operand_type::GELU)) {
       PADDLE_THROW(common::errors::Unimplemented(
           "Do not support operand type code: %d.", type));
     }
@@ -309,6 +346,9 @@ class VActJitCode : public VActFunc {
       case operand_type::IDENTITY:
         base += "_Identity";
         break;
+      case operand_type::GELU:
+        base += "_Gelu";
+        break;
       default:
         break;
     }
@@ -342,6 +382,7 @@ DECLARE_ACT_JITCODE(VIdentity, operand_type::IDENTITY);
 DECLARE_ACT_JITCODE(VExp, operand_type::EXP);
 DECLARE_ACT_JITCODE(VSigmoid, operand_type::SIGMOID);
 DECLARE_ACT_JITCODE(VTanh, operand_type::TANH);
+DECLARE_ACT_JITCODE(VGelu, operand_type::GELU);
 
 #undef DECLARE_ACT_JITCODE
 
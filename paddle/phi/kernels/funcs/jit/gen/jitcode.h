@@ -61,7 +61,8 @@ typedef enum {
   SQUARE,
   SIGMOID,
   TANH,
-  IDENTITY
+  IDENTITY,
+  GELU
 } operand_type;
 
 #define DECLARE_JIT_CODE(codename) \
@@ -32,16 +32,29 @@ void MatMulJitCode::genCode() {
                                       "be larger than 0. But it is %d.",
                                       groups.front()));
 
-  const int block_len = sizeof(float) * block;  // NOLINT
-  const int x_reg_idx = (block == ZMM_FLOAT_BLOCK ? 32 : 16) - 1;
-  const int w_reg_idx = x_reg_idx - 1;
   // from packed mov(reg_ptr_wgt, ptr[param_attr + offsetof(matmul_attr_t,
   // packed_weight)]);
   mov(reg_ptr_wgt, param_y);
-  size_t z_offset = 0;
+  // the rows are unrolled as m is baked into the code
+  for (int row = 0; row < m_; ++row) {
+    genRowCode(row, groups, block, rest);
+  }
+
+  postCode();
+}
+
+void MatMulJitCode::genRowCode(int row,
+                               const std::vector<int>& groups,
+                               int block,
+                               int rest) {
+  const int block_len = sizeof(float) * block;  // NOLINT
+  const int x_reg_idx = (block == ZMM_FLOAT_BLOCK ? 32 : 16) - 1;
+  const int w_reg_idx = x_reg_idx - 1;
+  const size_t row_z_offset = row * n_ * sizeof(float);
+  size_t z_offset = row_z_offset;
   size_t wgt_offset = 0;
   for (size_t g = 0; g < groups.size(); ++g) {
-    size_t x_offset = 0;
+    size_t x_offset = row * k_ * sizeof(float);
     size_t wgt_offset_tmp = 0;
     for (size_t i = 0; i < g; ++i) {
       wgt_offset_tmp += groups[i] * block_len;
@@ -79,7 +92,7 @@ void MatMulJitCode::genCode() {
   if (rest != 0) {
     // below should refine with mask
     int reg_idx = groups.back() - 1;
-    z_offset = (n_ - rest) * sizeof(float);
+    z_offset = row_z_offset + (n_ - rest) * sizeof(float);
     int inner_block = 8;
     while (rest > 0) {
       if (rest >= 8) {
@@ -100,23 +113,22 @@ void MatMulJitCode::genCode() {
       rest -= inner_block;
     }
   }
-
-  postCode();
 }
 
 class MatMulCreator : public JitCodeCreator<matmul_attr_t> {
  public:
   bool CanBeUsed(const matmul_attr_t& attr) const override {
-    return attr.m == 1 &&
+    // small gemm, whose rows are unrolled
+    return attr.m <= 8 &&
            phi::backends::cpu::MayIUse(phi::backends::cpu::avx512f) &&
-           attr.n % ZMM_FLOAT_BLOCK == 0 && attr.k < 512;
+           attr.n % ZMM_FLOAT_BLOCK == 0 && attr.m * attr.k < 512;
   }
   size_t CodeSize(const matmul_attr_t& attr) const override {
     int block = YMM_FLOAT_BLOCK;
     if (phi::backends::cpu::MayIUse(phi::backends::cpu::avx512f)) {
       block = ZMM_FLOAT_BLOCK;
     }
-    return 96 + 4 * attr.k * (attr.n / block + 1) * 8;
+    return 96 + 4 * attr.m * attr.k * (attr.n / block + 1) * 8;
   }
   std::unique_ptr<GenBase> CreateJitCode(
       const matmul_attr_t& attr) const override {
@@ -33,12 +33,6 @@ class MatMulJitCode : public JitCode {
                          size_t code_size = 256 * 1024,
                          void* code_ptr = nullptr)
       : JitCode(code_size, code_ptr), m_(attr.m), n_(attr.n), k_(attr.k) {
-    PADDLE_ENFORCE_EQ(m_,
-                      1,
-                      common::errors::Unimplemented(
-                          "Jitcode of matmul only support m==1 (first "
-                          "matrix's row) now. But m is %d.",
-                          m_));
     this->genCode();
   }
 
@@ -51,6 +45,8 @@ class MatMulJitCode : public JitCode {
   void genCode() override;
 
  private:
+  void genRowCode(int row, const std::vector<int>& groups, int block, int rest);
+
   int m_, n_, k_;
 
   reg64_t param_x{abi_param1};
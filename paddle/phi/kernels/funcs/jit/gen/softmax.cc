@@ -0,0 +1,134 @@
+/* Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. */
+
+#include "paddle/phi/kernels/funcs/jit/gen/softmax.h"
+
+#include "paddle/phi/backends/cpu/cpu_info.h"
+#include "paddle/phi/kernels/funcs/jit/registry.h"
+
+namespace phi::jit::gen {
+
+template <typename ReduceOp>
+void SoftmaxJitCode::reduce(ymm_t& jmm,  // NOLINT
+                            xmm_t& tail,  // NOLINT
+                            const ReduceOp& op) {
+  xmm_t xmm = xmm_t(jmm.getIdx());
+  vextractf128(xmm_tmp, jmm, 1);
+  op(xmm, xmm, xmm_tmp);
+  op(xmm, xmm, tail);
+  // {a, b, c, d} to {a op c, b op d, ...} to all of (a op b op c op d)
+  vshufps(xmm_tmp, xmm, xmm, 0x4E);
+  op(xmm, xmm, xmm_tmp);
+  vshufps(xmm_tmp, xmm, xmm, 0xB1);
+  op(xmm, xmm, xmm_tmp);
+  vinsertf128(jmm, jmm, xmm, 1);
+}
+
+void SoftmaxJitCode::genCode() {
+  using Addr = Xbyak::Address;
+  auto max_op = [&](xmm_t& dst, xmm_t& a, xmm_t& b) { vmaxps(dst, a, b); };
+  auto add_op = [&](xmm_t& dst, xmm_t& a, xmm_t& b) { vaddps(dst, a, b); };
+  Label l_next_row, l_end;
+  cmp(param_bs, 0);
+  jle(l_end, T_NEAR);
+  L(l_next_row);
+  {
+    // max of the row
+    vbroadcastss(ymm_max, ptr[param_x]);
+    vmovaps(xmm_tail, xmm_max);
+    forEachBlock(
+        [&](const Addr& x, const Addr&) { vmaxps(ymm_max, ymm_max, x); },
+        [&](const Addr& x, const Addr&) { vmaxps(xmm_tail, xmm_tail, x); },
+        [&](const Addr& x, const Addr&) { vmaxss(xmm_tail, xmm_tail, x); });
+    reduce(ymm_max, xmm_tail, max_op);
+
+    // y = exp(x - max) and the sum of y, the floats out of the tail should
+    // not be added
+    vxorps(ymm_sum, ymm_sum, ymm_sum);
+    vxorps(xmm_tail, xmm_tail, xmm_tail);
+    forEachBlock(
+        [&](const Addr& x, const Addr& y) {
+          vmovups(ymm_src, x);
+          vsubps(ymm_src, ymm_src, ymm_max);
+          exp_jmm<ymm_t>(ymm_dst, ymm_src, 11, 12, 13, 14, 15);
+          vmovups(y, ymm_dst);
+          vaddps(ymm_sum, ymm_sum, ymm_dst);
+        },
+        [&](const Addr& x, const Addr& y) {
+          vmovups(xmm_src, x);
+          vsubps(xmm_src, xmm_src, xmm_max);
+          exp_jmm<xmm_t>(xmm_dst, xmm_src, 11, 12, 13, 14, 15);
+          vmovups(y, xmm_dst);
+          vaddps(xmm_tail, xmm_tail, xmm_dst);
+        },
+        [&](const Addr& x, const Addr& y) {
+          vmovss(xmm_src, x);
+          vsubss(xmm_src, xmm_src, xmm_max);
+          exp_jmm<xmm_t>(xmm_dst, xmm_src, 11, 12, 13, 14, 15);
+          vmovss(y, xmm_dst);
+          vaddss(xmm_tail, xmm_tail, xmm_dst);
+        });
+    reduce(ymm_sum, xmm_tail, add_op);
+
+    // y = y * (1 / sum)
+    mov(reg_ptr_global, reinterpret_cast<size_t>(exp_float_consts));
+    vmovaps(ymm_tail, ptr[reg_ptr_global + OFFSET_EXP_ONE]);
+    vdivps(ymm_sum, ymm_tail, ymm_sum);
+    forEachBlock(
+        [&](const Addr&, const Addr& y) {
+          vmulps(ymm_dst, ymm_sum, y);
+          vmovups(y, ymm_dst);
+        },
+        [&](const Addr&, const Addr& y) {
+          vmulps(xmm_dst, xmm_sum, y);
+          vmovups(y, xmm_dst);
+        },
+        [&](const Addr&, const Addr& y) {
+          vmulss(xmm_dst, xmm_sum, y);
+          vmovss(y, xmm_dst);
+        });
+
+    add(param_x, sizeof(float) * num_);
+    add(param_y, sizeof(float) * num_);
+    dec(param_bs);
+    jnz(l_next_row, T_NEAR);
+  }
+  L(l_end);
+  ret();
+}
+
+class SoftmaxCreator : public JitCodeCreator<int> {
+ public:
+  bool CanBeUsed(const int& d) const override {
+    return phi::backends::cpu::MayIUse(phi::backends::cpu::avx);
+  }
+  size_t CodeSize(const int& d) const override {
+    // the ymm, xmm and at most 3 float blocks of exp, and the others
+    return 96 + 5 * 70 * 8 + 3 * 24 * 8;
+  }
+  std::unique_ptr<GenBase> CreateJitCode(const int& d) const override {
+    PADDLE_ENFORCE_GT(
+        d,
+        0,
+        common::errors::InvalidArgument(
+            "The width of Softmax should be larger than 0. But it is %d.", d));
+    return make_unique<SoftmaxJitCode>(d, CodeSize(d));
+  }
+};
+
+}  // namespace phi::jit::gen
+
+namespace gen = phi::jit::gen;
+
+REGISTER_JITKERNEL_GEN(kSoftmax, gen::SoftmaxCreator);
@@ -0,0 +1,105 @@
+/* Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. */
+
+#pragma once
+
+#include <string>
+
+#include "glog/logging.h"
+#include "paddle/phi/kernels/funcs/jit/gen/act.h"
+#include "paddle/phi/kernels/funcs/jit/gen/jitcode.h"
+
+namespace phi {
+namespace jit {
+namespace gen {
+
+// Softmax of each row, the width is baked into the code and the number of
+// rows is given when calling.
+class SoftmaxJitCode : public VActFunc {
+ public:
+  explicit SoftmaxJitCode(int d, size_t code_size, void* code_ptr = nullptr)
+      : VActFunc(code_size, code_ptr), num_(d) {
+    this->genCode();
+  }
+
+  std::string name() const override {
+    return "SoftmaxJitCode_D" + std::to_string(num_);
+  }
+  void genCode() override;
+
+ private:
+  // Loop ymm_op over the ymm blocks of the row with a fixed trip count, then
+  // apply xmm_op on one xmm block and float_op on every rest float. The ops
+  // get the addresses of x and y.
+  template <typename YmmOp, typename XmmOp, typename FloatOp>
+  void forEachBlock(const YmmOp& ymm_op,
+                    const XmmOp& xmm_op,
+                    const FloatOp& float_op) {
+    const int num_blocks = num_ / YMM_FLOAT_BLOCK;
+    if (num_blocks > 0) {
+      Label l_next_block;
+      mov(reg_ptr_x, param_x);
+      mov(reg_ptr_y, param_y);
+      mov(reg_num_blocks, num_blocks);
+      L(l_next_block);
+      ymm_op(ptr[reg_ptr_x], ptr[reg_ptr_y]);
+      add(reg_ptr_x, sizeof(float) * YMM_FLOAT_BLOCK);
+      add(reg_ptr_y, sizeof(float) * YMM_FLOAT_BLOCK);
+      dec(reg_num_blocks);
+      jnz(l_next_block, T_NEAR);
+    }
+    int offset = sizeof(float) * YMM_FLOAT_BLOCK * num_blocks;
+    int rest = num_ % YMM_FLOAT_BLOCK;
+    if (rest >= XMM_FLOAT_BLOCK) {
+      xmm_op(ptr[param_x + offset], ptr[param_y + offset]);
+      offset += sizeof(float) * XMM_FLOAT_BLOCK;
+      rest -= XMM_FLOAT_BLOCK;
+    }
+    for (; rest > 0; --rest) {
+      float_op(ptr[param_x + offset], ptr[param_y + offset]);
+      offset += sizeof(float);
+    }
+  }
+
+  // Reduce the ymm accumulator and the xmm one of the tail to all the
+  // elements of jmm.
+  template <typename ReduceOp>
+  void reduce(ymm_t& jmm, xmm_t& tail, const ReduceOp& op);  // NOLINT
+
+  int num_;
+  reg64_t param_x{abi_param1};
+  reg64_t param_y{abi_param2};
+  reg32_t param_bs{abi_param4};
+
+  reg64_t reg_ptr_x{r8};
+  reg64_t reg_ptr_y{r9};
+  reg64_t reg_num_blocks{r10};
+  reg64_t reg_ptr_global{r11};
+
+  xmm_t xmm_src = xmm_t(0);
+  ymm_t ymm_src = ymm_t(0);
+  xmm_t xmm_dst = xmm_t(1);
+  ymm_t ymm_dst = ymm_t(1);
+  xmm_t xmm_max = xmm_t(2);
+  ymm_t ymm_max = ymm_t(2);
+  xmm_t xmm_tmp = xmm_t(3);
+  xmm_t xmm_sum = xmm_t(4);
+  ymm_t ymm_sum = ymm_t(4);
+  xmm_t xmm_tail = xmm_t(5);
+  ymm_t ymm_tail = ymm_t(5);
+};
+
+}  // namespace gen
+}  // namespace jit
+}  // namespace phi
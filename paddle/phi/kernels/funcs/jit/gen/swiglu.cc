@@ -0,0 +1,87 @@
+/* Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. */
+
+#include "paddle/phi/kernels/funcs/jit/gen/swiglu.h"
+
+#include "paddle/phi/backends/cpu/cpu_info.h"
+#include "paddle/phi/kernels/funcs/jit/registry.h"
+
+namespace phi::jit::gen {
+
+void VSwiGLUJitCode::genCode() {
+  int offset = 0;
+  for (int i = 0; i < num_ / YMM_FLOAT_BLOCK; ++i) {
+    vmovups(ymm_src, ptr[param1 + offset]);
+    sigmoid_jmm<ymm_t>(ymm_dst, ymm_src, 11, 12, 13, 14, 15);
+    vmulps(ymm_dst, ymm_dst, ymm_src);
+    vmovups(ymm_y, ptr[param2 + offset]);
+    vmulps(ymm_dst, ymm_dst, ymm_y);
+    vmovups(ptr[param3 + offset], ymm_dst);
+    offset += sizeof(float) * YMM_FLOAT_BLOCK;
+  }
+  int rest = num_ % YMM_FLOAT_BLOCK;
+  while (rest > 0) {
+    int block = XMM_FLOAT_BLOCK;
+    if (rest >= 4) {
+      block = 4;
+      vmovups(xmm_src, ptr[param1 + offset]);
+      vmovups(xmm_y, ptr[param2 + offset]);
+    } else if (rest >= 2) {
+      block = 2;
+      vmovq(xmm_src, ptr[param1 + offset]);
+      vmovq(xmm_y, ptr[param2 + offset]);
+    } else {
+      block = 1;
+      vmovss(xmm_src, ptr[param1 + offset]);
+      vmovss(xmm_y, ptr[param2 + offset]);
+    }
+    sigmoid_jmm<xmm_t>(xmm_dst, xmm_src, 11, 12, 13, 14, 15);
+    vmulps(xmm_dst, xmm_dst, xmm_src);
+    vmulps(xmm_dst, xmm_dst, xmm_y);
+    if (rest >= 4) {
+      vmovups(ptr[param3 + offset], xmm_dst);
+    } else if (rest >= 2) {
+      vmovq(ptr[param3 + offset], xmm_dst);
+    } else {
+      vmovss(ptr[param3 + offset], xmm_dst);
+    }
+    offset += sizeof(float) * block;  // NOLINT
+    rest -= block;
+  }
+  ret();
+}
+
+class VSwiGLUCreator : public JitCodeCreator<int> {
+ public:
+  bool CanBeUsed(const int& d) const override {
+    return phi::backends::cpu::MayIUse(phi::backends::cpu::avx);
+  }
+  size_t CodeSize(const int& d) const override {
+    return 96 + (d / YMM_FLOAT_BLOCK + 3) * 90 * 8;
+  }
+  std::unique_ptr<GenBase> CreateJitCode(const int& d) const override {
+    PADDLE_ENFORCE_GT(
+        d,
+        0,
+        common::errors::InvalidArgument(
+            "The width of VSwiGLU should be larger than 0. But it is %d.", d));
+    return make_unique<VSwiGLUJitCode>(d, CodeSize(d));
+  }
+};
+
+}  // namespace phi::jit::gen
+
+namespace gen = phi::jit::gen;
+
+REGISTER_JITKERNEL_GEN(kVSwiGLU, gen::VSwiGLUCreator);
@@ -0,0 +1,58 @@
+/* Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. */
+
+#pragma once
+
+#include <string>
+
+#include "glog/logging.h"
+#include "paddle/phi/kernels/funcs/jit/gen/act.h"
+#include "paddle/phi/kernels/funcs/jit/gen/jitcode.h"
+
+namespace phi {
+namespace jit {
+namespace gen {
+
+// z = x * sigmoid(x) * y
+class VSwiGLUJitCode : public VActFunc {
+ public:
+  explicit VSwiGLUJitCode(int d, size_t code_size, void* code_ptr = nullptr)
+      : VActFunc(code_size, code_ptr), num_(d) {
+    this->genCode();
+  }
+
+  std::string name() const override {
+    return "VSwiGLUJitCode_D" + std::to_string(num_);
+  }
+  void genCode() override;
+
+ protected:
+  int num_;
+  reg64_t param1{abi_param1};
+  reg64_t param2{abi_param2};
+  reg64_t param3{abi_param3};
+
+  xmm_t xmm_src = xmm_t(0);
+  ymm_t ymm_src = ymm_t(0);
+
+  xmm_t xmm_dst = xmm_t(1);
+  ymm_t ymm_dst = ymm_t(1);
+
+  xmm_t xmm_y = xmm_t(2);
+  ymm_t ymm_y = ymm_t(2);
+};
+
+}  // namespace gen
+}  // namespace jit
+}  // namespace phi
@@ -26,6 +26,11 @@
 #endif
 
 PHI_DEFINE_bool(dump_jitcode, false, "Whether to dump the jitcode to file");
+PHI_DEFINE_int32(jit_code_cache_capacity,
+                 1024,
+                 "The max number of shapes of one jit kernel cached in one "
+                 "thread, the least recently used one is evicted when it is "
+                 "full. It is at least 64, 0 means no limit.");
 
 namespace phi::jit {
 
@@ -26,6 +26,7 @@
 #include "paddle/phi/kernels/funcs/jit/kernel_base.h"
 
 PHI_DECLARE_bool(dump_jitcode);
+PHI_DECLARE_int32(jit_code_cache_capacity);
 
 namespace phi {
 namespace jit {
@@ -43,8 +43,9 @@ GetJitCode(const typename KernelTuple::attr_type& attr) {
   using Attr = typename KernelTuple::attr_type;
   int64_t key = JitCodeKey<Attr>(attr);
   auto& codes = JitCodePool<KernelTuple::kernel_type>::Instance();
-  if (codes.Has(key)) {
-    return codes.AllKernels().at(key).get();
+  auto code = codes.Get(key);
+  if (code) {
+    return code.get();
   }
 
   // creator is not related with attr, so can use KernelKey as key
@@ -78,6 +79,26 @@ GetJitCode(const typename KernelTuple::attr_type& attr UNUSED) {
   return nullptr;
 }
 
+// The jit code of key, which is held by KernelFuncs to keep the code of a
+// cached function alive after JitCodePool evicts it.
+template <typename KernelTuple, typename PlaceType>
+inline typename std::enable_if<
+    std::is_same<typename KernelTuple::data_type, float>::value &&
+        std::is_same<PlaceType, phi::CPUPlace>::value,
+    std::shared_ptr<const GenBase>>::type
+GetJitCodeHolder(int64_t key) {
+  return JitCodePool<KernelTuple::kernel_type>::Instance().Get(key);
+}
+
+template <typename KernelTuple, typename PlaceType>
+inline typename std::enable_if<
+    !std::is_same<typename KernelTuple::data_type, float>::value ||
+        !std::is_same<PlaceType, phi::CPUPlace>::value,
+    std::shared_ptr<const GenBase>>::type
+GetJitCodeHolder(int64_t key UNUSED) {
+  return nullptr;
+}
+
 // Refer code do not related with attr, which is just for cast
 // Refer is always on CPUPlace
 template <typename KernelTuple>
@@ -216,13 +237,16 @@ class KernelFuncs {
     }
   }
 
-  // the exposed interface to use
+  // the exposed interface to use, the returned function is valid until
+  // FLAGS_jit_code_cache_capacity (at least kMinJitCodeCacheCapacity) other
+  // attrs of this kernel are used in the same thread.
   typename KernelTuple::func_type At(
       const typename KernelTuple::attr_type& attr) {
     // Maybe here is not good enough, not all kernels should have jitcode
     int64_t key = JitCodeKey<typename KernelTuple::attr_type>(attr);
-    if (Has(key)) {
-      return funcs_.at(key);
+    auto cached = funcs_.Get(key);
+    if (cached) {
+      return cached->first;
     }
     // If do not have this attr in cache then get the default best
     auto func = GetDefaultBestFunc<KernelTuple, PlaceType>(attr);
@@ -236,13 +260,18 @@ class KernelFuncs {
   }
 
  protected:
-  bool Has(int64_t key) const { return funcs_.find(key) != funcs_.end(); }
+  bool Has(int64_t key) const { return funcs_.Has(key); }
   void Insert(int64_t key, typename KernelTuple::func_type func) {
-    funcs_.emplace(key, func);
+    funcs_.Insert(
+        key,
+        std::make_pair(func, GetJitCodeHolder<KernelTuple, PlaceType>(key)));
   }
 
  private:
-  std::unordered_map<int64_t, typename KernelTuple::func_type> funcs_;
+  // the function and the jit code it may point to
+  LRUCodeMap<std::pair<typename KernelTuple::func_type,
+                       std::shared_ptr<const GenBase>>>
+      funcs_;
   DISABLE_COPY_AND_ASSIGN(KernelFuncs);
 };
 
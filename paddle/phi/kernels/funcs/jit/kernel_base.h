@@ -36,12 +36,14 @@ typedef enum {
   kLayerNorm,
   kMatMul,
   kSeqPool,
+  kSoftmax,
   kVAdd,
   kVAddBias,
   kVAddRelu,
   kVBroadcast,
   kVCopy,
   kVExp,
+  kVGelu,
   kVIdentity,
   kVMul,
   kVRelu,
@@ -50,6 +52,7 @@ typedef enum {
   kVSigmoid,
   kVSquare,
   kVSub,
+  kVSwiGLU,
   kVTanh,
 } KernelType;
 
@@ -107,6 +110,7 @@ DECLARE_KERNELTUPLE(XYZNTuple, VMul);
 DECLARE_KERNELTUPLE(XYZNTuple, VAdd);
 DECLARE_KERNELTUPLE(XYZNTuple, VAddRelu);
 DECLARE_KERNELTUPLE(XYZNTuple, VSub);
+DECLARE_KERNELTUPLE(XYZNTuple, VSwiGLU);
 
 DECLARE_KERNELTUPLE(AXYNTuple, VScal);
 DECLARE_KERNELTUPLE(AXYNTuple, VAddBias);
@@ -117,6 +121,7 @@ DECLARE_KERNELTUPLE(XYNTuple, VSquare);
 DECLARE_KERNELTUPLE(XYNTuple, VExp);
 DECLARE_KERNELTUPLE(XYNTuple, VSigmoid);
 DECLARE_KERNELTUPLE(XYNTuple, VTanh);
+DECLARE_KERNELTUPLE(XYNTuple, VGelu);
 DECLARE_KERNELTUPLE(XYNTuple, VCopy);
 
 typedef struct lstm_t {
@@ -360,6 +365,15 @@ struct LayerNormTuple {
       T*, T*, T*, T*, const T*, const T*, int, const float, int);
 };
 
+// x, y, n, bs: softmax of bs rows with n columns
+template <typename T>
+struct SoftmaxTuple {
+  static constexpr KernelType kernel_type = kSoftmax;
+  typedef T data_type;
+  typedef int attr_type;
+  typedef void (*func_type)(const T*, T*, int, int);
+};
+
 // Just for adding to kernel pool without template
 class Kernel {
  public:
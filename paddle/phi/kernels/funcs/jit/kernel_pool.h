@@ -14,6 +14,8 @@
 
 #pragma once
 
+#include <algorithm>
+#include <list>
 #include <map>
 #include <memory>  // for unique_ptr
 #include <string>
@@ -31,12 +33,66 @@ namespace jit {
 
 struct KernelKey;
 
+// The callers keep the functions of a few attrs of one kernel at a time, e.g.
+// fusion_squared_mat_sub holds three of them across its loops, so the caches
+// never evict below this many items, whatever FLAGS_jit_code_cache_capacity.
+constexpr size_t kMinJitCodeCacheCapacity = 64;
+
+// Map from the jit code key to Value, which evicts the least recently used
+// one when it holds FLAGS_jit_code_cache_capacity items, at least
+// kMinJitCodeCacheCapacity (0 means no limit). All the jit caches are thread
+// local, so it does not need any lock.
+template <typename Value>
+class LRUCodeMap {
+  typedef std::list<std::pair<int64_t, Value>> ItemList;
+
+ public:
+  size_t size() const { return items_.size(); }
+
+  bool Has(int64_t key) const { return index_.find(key) != index_.end(); }
+
+  // Return nullptr if key is not found, otherwise mark it as the most
+  // recently used one.
+  Value* Get(int64_t key) {
+    auto iter = index_.find(key);
+    if (iter == index_.end()) {
+      return nullptr;
+    }
+    items_.splice(items_.begin(), items_, iter->second);
+    return &(iter->second->second);
+  }
+
+  // Keep the old value if key exists.
+  void Insert(int64_t key, Value value) {
+    if (Get(key)) {
+      return;
+    }
+    size_t capacity =
+        FLAGS_jit_code_cache_capacity > 0
+            ? std::max(static_cast<size_t>(FLAGS_jit_code_cache_capacity),
+                       kMinJitCodeCacheCapacity)
+            : 0;
+    while (capacity > 0 && items_.size() >= capacity) {
+      index_.erase(items_.back().first);
+      items_.pop_back();
+    }
+    items_.emplace_front(key, std::move(value));
+    index_.emplace(key, items_.begin());
+  }
+
+ private:
+  ItemList items_;
+  std::unordered_map<int64_t, typename ItemList::iterator> index_;
+};
+
 extern std::map<size_t, std::shared_ptr<void>>& GetJITCodesMap();
 
+// The generated codes are shared with KernelFuncs, which keeps using the code
+// of a cached function even after it has been evicted from this pool.
 template <KernelType KT>
 class JitCodePool {
-  typedef std::unique_ptr<GenBase> GenBasePtr;
-  typedef std::unordered_map<int64_t, GenBasePtr> JitCodeMap;
+  typedef std::shared_ptr<GenBase> GenBasePtr;
+  typedef LRUCodeMap<GenBasePtr> JitCodeMap;
 
  public:
   JitCodePool() = default;
@@ -55,10 +111,16 @@ class JitCodePool {
 
   const JitCodeMap& AllKernels() { return codes_; }
 
-  bool Has(int64_t key) const { return codes_.find(key) != codes_.end(); }
+  bool Has(int64_t key) const { return codes_.Has(key); }
+
+  // Return nullptr if there is no code of this key.
+  GenBasePtr Get(int64_t key) {
+    auto code = codes_.Get(key);
+    return code ? *code : nullptr;
+  }
 
   void Insert(int64_t key, GenBasePtr value) {
-    codes_.emplace(key, std::move(value));
+    codes_.Insert(key, std::move(value));
   }
 
  private:
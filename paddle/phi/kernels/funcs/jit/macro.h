@@ -21,6 +21,9 @@ namespace jit {
 #define SIGMOID_THRESHOLD_MIN -40.0
 #define SIGMOID_THRESHOLD_MAX 13.0
 #define EXP_MAX_INPUT 40.0
+// gelu(x) = 0.5 * x * (1 + tanh(sqrt(2 / pi) * (x + 0.044715 * x^3)))
+#define GELU_SQRT_2_PI 0.79788456080286535588
+#define GELU_COEFF 0.044715
 
 #define XMM_FLOAT_BLOCK 4
 #define YMM_FLOAT_BLOCK 8
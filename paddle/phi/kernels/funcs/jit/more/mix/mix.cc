@@ -14,6 +14,8 @@
 
 #include "paddle/phi/kernels/funcs/jit/more/mix/mix.h"
 
+#include <algorithm>
+
 #include "paddle/phi/kernels/funcs/jit/kernels.h"
 #include "paddle/phi/kernels/funcs/jit/registry.h"
 
@@ -46,6 +48,65 @@ void VTanh(const T* x, T* y, int n) {
   compute_addbias(&b, y, y, n);
 }
 
+// the size of the buffer on stack, which holds the intermediate values of
+// the elementwise kernels as x and y could be the same one
+constexpr int kMixBlock = 256;
+
+void VGelu(const T* x, T* y, int n) {
+  // y = 0.5 * x * (1 + tanh(sqrt(2 / pi) * (x + 0.044715 * x^3)))
+  const T c0 = GELU_SQRT_2_PI, c1 = GELU_COEFF;
+  T tmp[kMixBlock];
+  for (int i = 0; i < n; i += kMixBlock) {
+    const int len = std::min(kMixBlock, n - i);
+    const T* px = x + i;
+    for (int j = 0; j < len; ++j) {
+      tmp[j] = c0 * (px[j] + c1 * px[j] * px[j] * px[j]);
+    }
+    auto compute_tanh = KernelFuncs<VTanhTuple<T>, CPUPlace>::Cache().At(len);
+    compute_tanh(tmp, tmp, len);
+    for (int j = 0; j < len; ++j) {
+      y[i + j] = static_cast<T>(0.5) * px[j] * (static_cast<T>(1) + tmp[j]);
+    }
+  }
+}
+
+void VSwiGLU(const T* x, const T* y, T* z, int n) {
+  // z = x * sigmoid(x) * y
+  T tmp[kMixBlock];
+  for (int i = 0; i < n; i += kMixBlock) {
+    const int len = std::min(kMixBlock, n - i);
+    auto compute_sigmoid =
+        KernelFuncs<VSigmoidTuple<T>, CPUPlace>::Cache().At(len);
+    auto compute_mul = KernelFuncs<VMulTuple<T>, CPUPlace>::Cache().At(len);
+    compute_sigmoid(x + i, tmp, len);
+    compute_mul(x + i, tmp, tmp, len);
+    compute_mul(tmp, y + i, z + i, len);
+  }
+}
+
+void Softmax(const T* x, T* y, int n, int bs) {
+  auto compute_addbias = KernelFuncs<VAddBiasTuple<T>, CPUPlace>::Cache().At(n);
+  auto compute_exp = KernelFuncs<VExpTuple<T>, CPUPlace>::Cache().At(n);
+  auto compute_scal = KernelFuncs<VScalTuple<T>, CPUPlace>::Cache().At(n);
+  for (int i = 0; i < bs; ++i) {
+    T scalar = x[0];
+    for (int j = 1; j < n; ++j) {
+      scalar = x[j] > scalar ? x[j] : scalar;
+    }
+    scalar = static_cast<T>(0) - scalar;
+    compute_addbias(&scalar, x, y, n);  // x - max
+    compute_exp(y, y, n);
+    T sum = static_cast<T>(0);
+    for (int j = 0; j < n; ++j) {
+      sum += y[j];
+    }
+    scalar = static_cast<T>(1) / sum;
+    compute_scal(&scalar, y, y, n);
+    x += n;
+    y += n;
+  }
+}
+
 void (*getActFunc(KernelType type, int d))(const T*, T*, int) {  // NOLINT
   if (type == kVSigmoid) {
     return KernelFuncs<VSigmoidTuple<T>, CPUPlace>::Cache().At(d);
@@ -183,6 +244,12 @@ bool VSigmoidKernel::CanBeUsed(const int& d) const { return true; }
 
 bool VTanhKernel::CanBeUsed(const int& d) const { return true; }
 
+bool VGeluKernel::CanBeUsed(const int& d) const { return true; }
+
+bool VSwiGLUKernel::CanBeUsed(const int& d) const { return true; }
+
+bool SoftmaxKernel::CanBeUsed(const int& d) const { return true; }
+
 bool LSTMCtHtKernel::CanBeUsed(const lstm_attr_t& attr) const { return true; }
 
 bool LSTMC1H1Kernel::CanBeUsed(const lstm_attr_t& attr) const { return true; }
@@ -202,6 +269,9 @@ namespace mix = phi::jit::more::mix;
 
 REGISTER_MORE_KERNEL(VSigmoid);
 REGISTER_MORE_KERNEL(VTanh);
+REGISTER_MORE_KERNEL(VGelu);
+REGISTER_MORE_KERNEL(VSwiGLU);
+REGISTER_MORE_KERNEL(Softmax);
 REGISTER_MORE_KERNEL(LSTMCtHt);
 REGISTER_MORE_KERNEL(LSTMC1H1);
 REGISTER_MORE_KERNEL(GRUH1);
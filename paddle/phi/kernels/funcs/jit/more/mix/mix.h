@@ -26,6 +26,9 @@ using T = float;
 
 void VSigmoid(const T* x, T* y, int n);
 void VTanh(const T* x, T* y, int n);
+void VGelu(const T* x, T* y, int n);
+void VSwiGLU(const T* x, const T* y, T* z, int n);
+void Softmax(const T* x, T* y, int n, int bs);
 
 void LSTMCtHt(lstm_t* step, const lstm_attr_t* attr);
 void LSTMC1H1(lstm_t* step, const lstm_attr_t* attr);
@@ -44,6 +47,12 @@ void GRUHtPart2(gru_t* step, const gru_attr_t* attr);
 // XYN
 DECLARE_MORE_KERNEL(VSigmoid);
 DECLARE_MORE_KERNEL(VTanh);
+DECLARE_MORE_KERNEL(VGelu);
+
+// XYZN
+DECLARE_MORE_KERNEL(VSwiGLU);
+
+DECLARE_MORE_KERNEL(Softmax);
 
 // XRN
 DECLARE_MORE_KERNEL(LSTMCtHt);
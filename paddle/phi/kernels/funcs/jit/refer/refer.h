@@ -135,6 +135,25 @@ void VTanh(const T* x, T* y, int n) {
   }
 }
 
+template <typename T>
+void VGelu(const T* x, T* y, int n) {
+  // y = 0.5 * x * (1 + tanh(sqrt(2 / pi) * (x + 0.044715 * x^3)))
+  const T c0 = static_cast<T>(GELU_SQRT_2_PI);
+  const T c1 = static_cast<T>(GELU_COEFF);
+  for (int i = 0; i < n; ++i) {
+    T u = c0 * (x[i] + c1 * x[i] * x[i] * x[i]);
+    y[i] = static_cast<T>(0.5) * x[i] * (static_cast<T>(1) + std::tanh(u));
+  }
+}
+
+template <typename T>
+void VSwiGLU(const T* x, const T* y, T* z, int n) {
+  // z = x * sigmoid(x) * y
+  for (int i = 0; i < n; ++i) {
+    z[i] = x[i] / (static_cast<T>(1) + std::exp(-x[i])) * y[i];
+  }
+}
+
 template <typename T>
 void (*getActFunc(KernelType type))(const T*, T*, int) {  // NOLINT
   if (type == kVSigmoid) {
@@ -375,6 +394,28 @@ void SeqPool(const T* x, T* y, const seq_pool_attr_t* attr) {
   }
 }
 
+// x and y shape: (bs, n), softmax on each row
+template <typename T>
+void Softmax(const T* x, T* y, int n, int bs) {
+  for (int i = 0; i < bs; ++i) {
+    T scalar = x[0];
+    for (int j = 1; j < n; ++j) {
+      scalar = x[j] > scalar ? x[j] : scalar;
+    }
+    scalar = static_cast<T>(0) - scalar;
+    VAddBias(&scalar, x, y, n);  // x - max
+    VExp(y, y, n);
+    T sum = static_cast<T>(0);
+    for (int j = 0; j < n; ++j) {
+      sum += y[j];
+    }
+    scalar = static_cast<T>(1) / sum;
+    VScal(&scalar, y, y, n);
+    x += n;
+    y += n;
+  }
+}
+
 // A(M,K) * B(K,N) = C(M,N)
 template <typename T>
 void MatMul(const T* A, const T* B, T* C, const matmul_attr_t* attr) {
@@ -600,6 +641,7 @@ DECLARE_REFER_KERNEL(VMul);
 DECLARE_REFER_KERNEL(VAdd);
 DECLARE_REFER_KERNEL(VAddRelu);
 DECLARE_REFER_KERNEL(VSub);
+DECLARE_REFER_KERNEL(VSwiGLU);
 
 // const T* a, const T* x, T* y, int n
 DECLARE_REFER_KERNEL(VScal);
@@ -611,6 +653,7 @@ DECLARE_REFER_KERNEL(VIdentity);
 DECLARE_REFER_KERNEL(VExp);
 DECLARE_REFER_KERNEL(VSigmoid);
 DECLARE_REFER_KERNEL(VTanh);
+DECLARE_REFER_KERNEL(VGelu);
 DECLARE_REFER_KERNEL(VSquare);
 DECLARE_REFER_KERNEL(VCopy);
 
@@ -626,6 +669,7 @@ DECLARE_REFER_KERNEL(GRUHtPart2);
 // others
 DECLARE_REFER_KERNEL(CRFDecoding);
 DECLARE_REFER_KERNEL(LayerNorm);
+DECLARE_REFER_KERNEL(Softmax);
 DECLARE_REFER_KERNEL(SeqPool);
 DECLARE_REFER_KERNEL(MatMul);
 DECLARE_REFER_KERNEL(EmbSeqPool);
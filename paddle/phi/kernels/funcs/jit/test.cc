@@ -487,6 +487,52 @@ void TestKernelLayerNorm() {
   }
 }
 
+template <typename KernelTuple, typename PlaceType>
+void TestKernelSoftmax() {
+  using T = typename KernelTuple::data_type;
+  VLOG(10) << "Test JITKernel: " << jit::to_string(KernelTuple::kernel_type);
+  for (int bs : {1, 2, 10}) {
+    for (int n : TestSizes()) {
+      auto ref = jit::GetReferFunc<KernelTuple>();
+      EXPECT_TRUE(ref != nullptr);
+      std::vector<T> x(bs * n), yref(bs * n);
+      std::vector<T> xinp(bs * n);  // inplace test
+      RandomVec<T>(bs * n, x.data());
+      std::copy(x.begin(), x.end(), xinp.begin());
+
+      const T* x_data = x.data();
+      T* yref_data = yref.data();
+      T* xinp_data = xinp.data();
+      // test refer code inplace
+      ref(x_data, yref_data, n, bs);
+      ref(xinp_data, xinp_data, n, bs);
+      ExpectEQ<T>(xinp_data, yref_data, bs * n);
+
+      auto verifier = [](const typename KernelTuple::func_type tgt,
+                         const std::vector<T>& x,
+                         const std::vector<T>& yref,
+                         int n,
+                         int bs) {
+        EXPECT_TRUE(tgt != nullptr);
+        EXPECT_EQ(yref.size(), x.size());
+        EXPECT_EQ(x.size(), static_cast<size_t>(n * bs));
+        const T* x_data = x.data();
+        const T* yref_data = yref.data();
+        std::vector<T> ytgt(n * bs);
+        T* ytgt_data = ytgt.data();
+        // test normal
+        tgt(x_data, ytgt_data, n, bs);
+        ExpectEQ<T>(ytgt_data, yref_data, n * bs);
+        // test inplace x
+        std::copy(x.begin(), x.end(), ytgt.begin());
+        tgt(ytgt_data, ytgt_data, n, bs);
+        ExpectEQ<T>(ytgt_data, yref_data, n * bs);
+      };
+      TestAllImpls<KernelTuple, PlaceType>(n, verifier, x, yref, n, bs);
+    }
+  }
+}
+
 template <typename KernelTuple, typename PlaceType>
 void TestKernelCRFDecoding() {
   using T = typename KernelTuple::data_type;
@@ -657,7 +703,7 @@ void TestKernelMatMul() {
   // export KMP_DETERMINISTIC_REDUCTION=yes would make the result deterministic
   FLAGS_acc = 1e-3;
   for (int m : {1, 2, 3, 4}) {
-    for (int n : {1, 2, 3, 4}) {
+    for (int n : {1, 2, 3, 4, 16, 32}) {
       for (int k : TestSizes()) {
         auto ref = jit::GetReferFunc<KernelTuple>();
         EXPECT_TRUE(ref != nullptr);
@@ -1115,7 +1161,7 @@ TEST(JITKernel_pool, jitcreator) {
 #if defined(_WIN32) || defined(__APPLE__) || defined(__OSX__)
   EXPECT_EQ(jitcreators.size(), 0UL);
 #else
-  EXPECT_EQ(jitcreators.size(), 24UL);
+  EXPECT_EQ(jitcreators.size(), 28UL);
 #endif
 }
 
@@ -1134,7 +1180,7 @@ TEST(JITKernel_pool, jitpool) {
 
 TEST(JITKernel_pool, more) {
   const auto& kers = jit::KernelPool::Instance().AllKernels();
-  size_t target_num = 7;
+  size_t target_num = 10;
 
 #ifdef __AVX__
   target_num += 2;
@@ -1149,7 +1195,7 @@ TEST(JITKernel_pool, more) {
 
 TEST(JITKernel_pool, refer) {
   const auto& kers = jit::ReferKernelPool::Instance().AllKernels();
-  EXPECT_EQ(kers.size(), 27UL);
+  EXPECT_EQ(kers.size(), 31UL);
 }
 
 // test helper
@@ -1215,6 +1261,50 @@ TEST(JITKernel_helper, KernelFuncs) {
 #endif
 }
 
+TEST(JITKernel_helper, KernelFuncsLRU) {
+  auto last_capacity = FLAGS_jit_code_cache_capacity;
+  // raised to kMinJitCodeCacheCapacity
+  FLAGS_jit_code_cache_capacity = 2;
+  const int capacity = static_cast<int>(jit::kMinJitCodeCacheCapacity);
+  auto& codes = jit::JitCodePool<jit::kVSub>::Instance();
+  auto& cache = jit::KernelFuncs<jit::VSubTuple<float>, CPUPlace>::Cache();
+  // the sizes which have not been used by the other tests
+  const int d = 40;
+  std::vector<float> x(d), y(d), zref(d), ztgt(d);
+  RandomVec<float>(d, x.data());
+  RandomVec<float>(d, y.data());
+  jit::GetReferFunc<jit::VSubTuple<float>>()(
+      x.data(), y.data(), zref.data(), d);
+
+  auto f = cache.At(d);
+  EXPECT_TRUE(f == cache.At(d));
+  // the functions of fewer attrs than the capacity stay valid
+  for (int i = 1; i < capacity; ++i) {
+    cache.At(d + i);
+  }
+  EXPECT_TRUE(f == cache.At(d));
+  f(x.data(), y.data(), ztgt.data(), d);
+  ExpectEQ<float>(ztgt.data(), zref.data(), d);
+
+  // evict the code of d from the pool, but the cached function keeps it alive
+  for (int i = 1; i <= capacity; ++i) {
+    jit::GetAllCandidateFuncs<jit::VSubTuple<float>, CPUPlace>(d + i);
+  }
+  EXPECT_LE(codes.AllKernels().size(), jit::kMinJitCodeCacheCapacity);
+  EXPECT_FALSE(codes.Has(d));
+  f(x.data(), y.data(), ztgt.data(), d);
+  ExpectEQ<float>(ztgt.data(), zref.data(), d);
+
+  // evict d from the cache, then it is got again
+  for (int i = 1; i <= capacity; ++i) {
+    cache.At(d + i);
+  }
+  f = cache.At(d);
+  f(x.data(), y.data(), ztgt.data(), d);
+  ExpectEQ<float>(ztgt.data(), zref.data(), d);
+  FLAGS_jit_code_cache_capacity = last_capacity;
+}
+
 TEST(JITKernel_helper, GetAllCandidateFuncs) {
   auto funcs = jit::GetAllCandidateFuncs<jit::VExpTuple<float>, CPUPlace>(10);
   auto kers = jit::GetAllCandidateKernels<jit::VExpTuple<float>, CPUPlace>(10);
@@ -1489,6 +1579,7 @@ TEST(JITKernel_key, sgd) {
 #define TestKernelVAdd TestKernelXYZN
 #define TestKernelVAddRelu TestKernelXYZN
 #define TestKernelVSub TestKernelXYZN
+#define TestKernelVSwiGLU TestKernelXYZN
 
 #define TestKernelVScal TestKernelAXYN
 #define TestKernelVAddBias TestKernelAXYN
@@ -1499,6 +1590,7 @@ TEST(JITKernel_key, sgd) {
 #define TestKernelVExp TestKernelXYN
 #define TestKernelVSigmoid TestKernelXYN
 #define TestKernelVTanh TestKernelXYN
+#define TestKernelVGelu TestKernelXYN
 #define TestKernelVCopy TestKernelXYN
 
 #define TestKernelLSTMCtHt TestKernelLSTM
@@ -1518,6 +1610,7 @@ TEST_CPU_KERNEL(VMul);
 TEST_CPU_KERNEL(VAdd);
 TEST_CPU_KERNEL(VAddRelu);
 TEST_CPU_KERNEL(VSub);
+TEST_CPU_KERNEL(VSwiGLU);
 
 TEST_CPU_KERNEL(VScal);
 TEST_CPU_KERNEL(VAddBias);
@@ -1528,6 +1621,7 @@ TEST_CPU_KERNEL(VSquare);
 TEST_CPU_KERNEL(VExp);
 TEST_CPU_KERNEL(VSigmoid);
 TEST_CPU_KERNEL(VTanh);
+TEST_CPU_KERNEL(VGelu);
 TEST_CPU_KERNEL(VCopy);
 
 TEST_CPU_KERNEL(LSTMCtHt);
@@ -1538,6 +1632,7 @@ TEST_CPU_KERNEL(GRUHtPart1);
 TEST_CPU_KERNEL(GRUHtPart2);
 
 TEST_CPU_KERNEL(LayerNorm);
+TEST_CPU_KERNEL(Softmax);
 TEST_CPU_KERNEL(CRFDecoding);
 
 TEST_CPU_KERNEL(SeqPool);
@@ -0,0 +1,336 @@
+/* Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include "paddle/phi/kernels/funcs/packed_gemm_cache.h"
+
+#include <algorithm>
+
+#include "glog/logging.h"
+#include "paddle/phi/kernels/funcs/blas/blas.h"
+
+namespace phi {
+namespace funcs {
+
+#ifndef PADDLE_WITH_MKLML
+namespace {
+
+// out[0:R, 0:width] = x[0:R] * panel + beta * out for R rows of x, keeping the
+// R x kPanelWidth sums in registers while the panel is read once.
+template <typename T, int R, int W>
+void PanelRows(const T* x,
+               const T* panel,
+               int k,
+               int width,
+               T beta,
+               T* out,
+               int ldx,
+               int ldo) {
+  T acc[R][W] = {};
+  for (int j = 0; j < k; ++j) {
+    const T* wj = panel + j * W;
+    for (int r = 0; r < R; ++r) {
+      const T xv = x[r * ldx + j];
+      for (int c = 0; c < W; ++c) {
+        acc[r][c] += xv * wj[c];
+      }
+    }
+  }
+  for (int r = 0; r < R; ++r) {
+    T* y = out + r * ldo;
+    for (int c = 0; c < width; ++c) {
+      y[c] = beta == static_cast<T>(0) ? acc[r][c] : acc[r][c] + beta * y[c];
+    }
+  }
+}
+
+}  // namespace
+#endif
+
+template <typename T>
+PackedWeight<T>::PackedWeight(
+    const CPUContext& ctx, const T* w, int k, int n, bool trans)
+    : k_(k), n_(n) {
+#ifdef PADDLE_WITH_MKLML
+  auto blas = GetBlas<CPUContext, T>(ctx);
+  data_ = blas.GEMM_ALLOC(CblasBMatrix, 1, n, k);
+  PADDLE_ENFORCE_NOT_NULL(
+      data_,
+      common::errors::ResourceExhausted(
+          "Failed to allocate the packed weight of a %d x %d GEMM.", k, n));
+  blas.GEMM_PACK(CblasBMatrix,
+                 trans ? CblasTrans : CblasNoTrans,
+                 1,
+                 n,
+                 k,
+                 static_cast<T>(1),
+                 w,
+                 trans ? k : n,
+                 data_);
+#else
+  const int panels = (n + kPanelWidth - 1) / kPanelWidth;
+  data_.assign(static_cast<size_t>(panels) * k * kPanelWidth,
+               static_cast<T>(0));
+  for (int p = 0; p < panels; ++p) {
+    const int col = p * kPanelWidth;
+    const int width = std::min(kPanelWidth, n - col);
+    T* panel = data_.data() + static_cast<size_t>(p) * k * kPanelWidth;
+    for (int j = 0; j < k; ++j) {
+      for (int c = 0; c < width; ++c) {
+        panel[j * kPanelWidth + c] =
+            trans ? w[static_cast<size_t>(col + c) * k + j]
+                  : w[static_cast<size_t>(j) * n + col + c];
+      }
+    }
+  }
+#endif
+}
+
+template <typename T>
+PackedWeight<T>::~PackedWeight() {
+#ifdef PADDLE_WITH_MKLML
+  if (data_) {
+    CBlas<T>::GEMM_FREE(data_);
+  }
+#endif
+}
+
+template <typename T>
+bool PackedWeight<T>::Suits(int m) {
+#ifdef PADDLE_WITH_MKLML
+  return m > 0;
+#else
+  return m > 0 && m <= kMaxPanelRows;
+#endif
+}
+
+template <typename T>
+void PackedWeight<T>::Compute(
+    const CPUContext& ctx, int m, const T* x, T beta, T* out) const {
+#ifdef PADDLE_WITH_MKLML
+  auto blas = GetBlas<CPUContext, T>(ctx);
+  blas.GEMM_COMPUTE(CblasNoTrans,
+                    CblasPacked,
+                    m,
+                    n_,
+                    k_,
+                    x,
+                    k_,
+                    data_,
+                    n_,
+                    beta,
+                    out,
+                    n_);
+#else
+  constexpr int kRows = 4;
+  const int panels = (n_ + kPanelWidth - 1) / kPanelWidth;
+  for (int p = 0; p < panels; ++p) {
+    const int col = p * kPanelWidth;
+    const int width = std::min(kPanelWidth, n_ - col);
+    const T* panel = data_.data() + static_cast<size_t>(p) * k_ * kPanelWidth;
+    int i = 0;
+    for (; i + kRows <= m; i += kRows) {
+      PanelRows<T, kRows, kPanelWidth>(
+          x + i * k_, panel, k_, width, beta, out + i * n_ + col, k_, n_);
+    }
+    for (; i < m; ++i) {
+      PanelRows<T, 1, kPanelWidth>(
+          x + i * k_, panel, k_, width, beta, out + i * n_ + col, k_, n_);
+    }
+  }
+#endif
+}
+
+template class PackedWeight<float>;
+template class PackedWeight<double>;
+
+PackedWeightCache& PackedWeightCache::Instance() {
+  static PackedWeightCache cache;
+  return cache;
+}
+
+void PackedWeightCache::RegisterConstant(const DenseTensor& w) {
+  const auto& holder = w.Holder();
+  if (!holder || holder->place().GetType() != AllocationType::CPU) {
+    return;
+  }
+  std::unique_lock<std::shared_mutex> guard(mutex_);
+  constants_[holder.get()] = holder;
+  MaybePrune();
+  num_constants_.store(constants_.size(), std::memory_order_release);
+}
+
+bool PackedWeightCache::IsConstant(const DenseTensor& w) const {
+  if (num_constants_.load(std::memory_order_acquire) == 0) {
+    return false;
+  }
+  std::shared_lock<std::shared_mutex> guard(mutex_);
+  return IsRegistered(w);
+}
+
+bool PackedWeightCache::IsRegistered(const DenseTensor& w) const {
+  const auto& holder = w.Holder();
+  if (!holder) {
+    return false;
+  }
+  auto iter = constants_.find(holder.get());
+  return iter != constants_.end() && iter->second.lock() == holder;
+}
+
+void PackedWeightCache::MaybePrune() {
+  // Predictors created and destroyed again and again would otherwise leave
+  // their released parameters and packed copies here.
+  const size_t size = constants_.size() + packed_.size();
+  if (size >= 2 * last_pruned_size_) {
+    Prune();
+    last_pruned_size_ =
+        std::max<size_t>(constants_.size() + packed_.size(), 1024);
+  }
+}
+
+void PackedWeightCache::Prune() {
+  for (auto iter = constants_.begin(); iter != constants_.end();) {
+    iter = iter->second.expired() ? constants_.erase(iter) : std::next(iter);
+  }
+  for (auto iter = packed_.begin(); iter != packed_.end();) {
+    iter =
+        iter->second.holder.expired() ? packed_.erase(iter) : std::next(iter);
+  }
+}
+
+std::shared_ptr<const void> PackedWeightCache::GetOrPack(
+    const DenseTensor& w,
+    PackedLayout layout,
+    int64_t d0,
+    int64_t d1,
+    const std::function<std::shared_ptr<const void>()>& pack) {
+  if (num_constants_.load(std::memory_order_acquire) == 0) {
+    return nullptr;
+  }
+  const Key key(w.data(), layout, d0, d1, w.dtype());
+  {
+    std::shared_lock<std::shared_mutex> guard(mutex_);
+    if (!IsRegistered(w)) {
+      return nullptr;
+    }
+    auto iter = packed_.find(key);
+    if (iter != packed_.end() && iter->second.holder.lock() == w.Holder()) {
+      return iter->second.packed;
+    }
+  }
+  // Pack outside of the lock, other weights are not blocked by it.
+  auto packed = pack();
+  std::unique_lock<std::shared_mutex> guard(mutex_);
+  auto& entry = packed_[key];
+  if (entry.packed && entry.holder.lock() == w.Holder()) {
+    // Packed by another thread meanwhile.
+    return entry.packed;
+  }
+  entry.holder = w.Holder();
+  entry.packed = packed;
+  VLOG(4) << "Pack the weight at " << w.data() << " to layout "
+          << static_cast<int>(layout) << " of " << d0 << ", " << d1 << ", "
+          << packed_.size() << " weights are packed.";
+  MaybePrune();
+  num_constants_.store(constants_.size(), std::memory_order_release);
+  return packed;
+}
+
+template <typename T>
+std::shared_ptr<const PackedWeight<T>> PackedWeightCache::Get(
+    const CPUContext& ctx, const DenseTensor& w, int k, int n, bool trans) {
+  auto packed = GetOrPack(
+      w,
+      trans ? PackedLayout::kGemmTrans : PackedLayout::kGemm,
+      k,
+      n,
+      [&]() -> std::shared_ptr<const void> {
+        return std::make_shared<const PackedWeight<T>>(
+            ctx, w.data<T>(), k, n, trans);
+      });
+  return std::static_pointer_cast<const PackedWeight<T>>(packed);
+}
+
+template TEST_API std::shared_ptr<const PackedWeight<float>>
+PackedWeightCache::Get<float>(
+    const CPUContext&, const DenseTensor&, int, int, bool);
+template TEST_API std::shared_ptr<const PackedWeight<double>>
+PackedWeightCache::Get<double>(
+    const CPUContext&, const DenseTensor&, int, int, bool);
+
+size_t PackedWeightCache::Size() const {
+  std::shared_lock<std::shared_mutex> guard(mutex_);
+  return packed_.size();
+}
+
+void PackedWeightCache::Clear() {
+  std::unique_lock<std::shared_mutex> guard(mutex_);
+  constants_.clear();
+  packed_.clear();
+  last_pruned_size_ = 0;
+  num_constants_.store(0, std::memory_order_release);
+}
+
+namespace {
+
+template <typename T>
+bool PackedGemmImpl(const CPUContext& ctx,
+                    int m,
+                    int n,
+                    int k,
+                    const T* x,
+                    const DenseTensor& w,
+                    bool trans_w,
+                    T beta,
+                    T* out) {
+  if (n <= 0 || k <= 0 || !PackedWeight<T>::Suits(m)) {
+    return false;
+  }
+  auto packed = PackedWeightCache::Instance().Get<T>(ctx, w, k, n, trans_w);
+  if (!packed) {
+    return false;
+  }
+  packed->Compute(ctx, m, x, beta, out);
+  return true;
+}
+
+}  // namespace
+
+template <>
+bool PackedGemm<CPUContext, float>(const CPUContext& ctx,
+                                   int m,
+                                   int n,
+                                   int k,
+                                   const float* x,
+                                   const DenseTensor& w,
+                                   bool trans_w,
+                                   float beta,
+                                   float* out) {
+  return PackedGemmImpl<float>(ctx, m, n, k, x, w, trans_w, beta, out);
+}
+
+template <>
+bool PackedGemm<CPUContext, double>(const CPUContext& ctx,
+                                    int m,
+                                    int n,
+                                    int k,
+                                    const double* x,
+                                    const DenseTensor& w,
+                                    bool trans_w,
+                                    double beta,
+                                    double* out) {
+  return PackedGemmImpl<double>(ctx, m, n, k, x, w, trans_w, beta, out);
+}
+
+}  // namespace funcs
+}  // namespace phi
@@ -0,0 +1,181 @@
+/* Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <map>
+#include <memory>
+#include <shared_mutex>
+#include <tuple>
+#include <vector>
+
+#include "paddle/phi/backends/cpu/cpu_context.h"
+#include "paddle/phi/core/dense_tensor.h"
+#include "paddle/utils/test_macros.h"
+
+namespace phi {
+namespace funcs {
+
+// The weight w of out(m x n) = x(m x k) * w packed for the GEMM, where w is
+// k x n, or n x k if trans. With MKL it is in the layout of
+// cblas_?gemm_pack and any m is computed by cblas_?gemm_compute. Otherwise w
+// is split into panels of kPanelWidth columns, each stored k-major, which are
+// streamed once per row block, and only small m is computed with it.
+template <typename T>
+class TEST_API PackedWeight {
+ public:
+  static constexpr int kPanelWidth = 16;
+  // The largest m computed with the panels in the builds without MKL, a BLAS
+  // GEMM with the unpacked weight is faster for larger ones.
+  static constexpr int kMaxPanelRows = 16;
+
+  PackedWeight(const CPUContext& ctx, const T* w, int k, int n, bool trans);
+  ~PackedWeight();
+
+  PackedWeight(const PackedWeight&) = delete;
+  PackedWeight& operator=(const PackedWeight&) = delete;
+
+  // Whether Compute is used for a GEMM of m rows.
+  static bool Suits(int m);
+
+  // out = x * w + beta * out.
+  void Compute(const CPUContext& ctx, int m, const T* x, T beta, T* out) const;
+
+ private:
+  int k_;
+  int n_;
+#ifdef PADDLE_WITH_MKLML
+  T* data_{nullptr};
+#else
+  std::vector<T> data_;
+#endif
+};
+
+// The layouts the constant weights are packed to.
+enum class PackedLayout {
+  kGemm,
+  kGemmTrans,
+  // The filters of direct_conv_cpu.h.
+  kWinogradFilter,
+  kDirectFilter,
+};
+
+// Packed copies of the constant weights, shared by all the GEMMs and
+// convolutions with them. A weight is constant once the allocation holding it
+// is registered, which the inference predictors do for their parameters, so
+// training and dygraph tensors are never packed. A new weight at the address
+// of a released one is repacked, and the packed copies of released weights
+// are dropped as the cache grows.
+class TEST_API PackedWeightCache {
+ public:
+  static PackedWeightCache& Instance();
+
+  // Marks the allocation of w as constant. Its content must not change while
+  // it is alive.
+  void RegisterConstant(const DenseTensor& w);
+
+  // Whether the allocation of w is registered, so its packed copies are
+  // cached.
+  bool IsConstant(const DenseTensor& w) const;
+
+  // Returns the packed copy of w, packing it at the first call, or nullptr if
+  // w is not constant.
+  template <typename T>
+  std::shared_ptr<const PackedWeight<T>> Get(
+      const CPUContext& ctx, const DenseTensor& w, int k, int n, bool trans);
+
+  // Returns the copy of w in layout, which is made by pack at the first call,
+  // or nullptr if w is not constant. d0 and d1 are the sizes the layout
+  // depends on besides the dims of w.
+  std::shared_ptr<const void> GetOrPack(
+      const DenseTensor& w,
+      PackedLayout layout,
+      int64_t d0,
+      int64_t d1,
+      const std::function<std::shared_ptr<const void>()>& pack);
+
+  // The number of packed weights.
+  size_t Size() const;
+
+  void Clear();
+
+ private:
+  PackedWeightCache() = default;
+
+  bool IsRegistered(const DenseTensor& w) const;
+  // Drops the registrations and packed copies of released allocations once
+  // their number doubles since the last time, so that the cost is amortised
+  // over the insertions.
+  void MaybePrune();
+  void Prune();
+
+  using Key =
+      std::tuple<const void*, PackedLayout, int64_t, int64_t, DataType>;
+  struct Entry {
+    std::weak_ptr<Allocation> holder;
+    std::shared_ptr<const void> packed;
+  };
+
+  mutable std::shared_mutex mutex_;
+  std::map<const Allocation*, std::weak_ptr<Allocation>> constants_;
+  std::map<Key, Entry> packed_;
+  size_t last_pruned_size_{0};
+  // The size of constants_, read without the lock to skip the lookup when
+  // nothing is registered, as in training and dygraph.
+  std::atomic<size_t> num_constants_{0};
+};
+
+// Computes out(m x n) = x(m x k) * w + beta * out with the packed copy of w,
+// where w is k x n, or n x k if trans_w. It returns false without computing
+// anything if w is not constant or the packed copy does not suit m, then the
+// caller runs its usual GEMM.
+template <typename Context, typename T>
+bool PackedGemm(const Context& ctx UNUSED,
+                int m UNUSED,
+                int n UNUSED,
+                int k UNUSED,
+                const T* x UNUSED,
+                const DenseTensor& w UNUSED,
+                bool trans_w UNUSED,
+                T beta UNUSED,
+                T* out UNUSED) {
+  return false;
+}
+
+template <>
+TEST_API bool PackedGemm<CPUContext, float>(const CPUContext& ctx,
+                                            int m,
+                                            int n,
+                                            int k,
+                                            const float* x,
+                                            const DenseTensor& w,
+                                            bool trans_w,
+                                            float beta,
+                                            float* out);
+
+template <>
+TEST_API bool PackedGemm<CPUContext, double>(const CPUContext& ctx,
+                                             int m,
+                                             int n,
+                                             int k,
+                                             const double* x,
+                                             const DenseTensor& w,
+                                             bool trans_w,
+                                             double beta,
+                                             double* out);
+
+}  // namespace funcs
+}  // namespace phi
@@ -0,0 +1,89 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "paddle/common/enforce.h"
+
+namespace phi {
+namespace funcs {
+
+// Stable LSD radix sort of int64 keys, 8 bits per pass, moving `values`
+// along with the keys. Passes in which every key has the same digit are
+// skipped, so ids below 2^24, e.g. the rows of an embedding, only need three
+// passes over the data.
+template <typename ValueT>
+void RadixSortPairs(std::vector<int64_t>* keys, std::vector<ValueT>* values) {
+  constexpr int kBits = 8;
+  constexpr int kBuckets = 1 << kBits;
+  constexpr int kPasses = 64 / kBits;
+  PADDLE_ENFORCE_EQ(keys->size(),
+                    values->size(),
+                    common::errors::InvalidArgument(
+                        "The keys and the values to sort should have the same "
+                        "size, but got %d keys and %d values.",
+                        keys->size(),
+                        values->size()));
+  size_t n = keys->size();
+  if (n < 2) {
+    return;
+  }
+
+  // Flipping the sign bit orders negative keys before positive ones.
+  constexpr uint64_t kSignBit = uint64_t(1) << 63;
+  std::vector<std::array<size_t, kBuckets>> counts(kPasses);
+  for (auto& count : counts) {
+    count.fill(0);
+  }
+  for (auto key : *keys) {
+    uint64_t ukey = static_cast<uint64_t>(key) ^ kSignBit;
+    for (int pass = 0; pass < kPasses; ++pass) {
+      ++counts[pass][(ukey >> (pass * kBits)) & (kBuckets - 1)];
+    }
+  }
+
+  std::vector<int64_t> keys_buffer(n);
+  std::vector<ValueT> values_buffer(n);
+  for (int pass = 0; pass < kPasses; ++pass) {
+    auto& count = counts[pass];
+    uint64_t digit =
+        ((static_cast<uint64_t>((*keys)[0]) ^ kSignBit) >> (pass * kBits)) &
+        (kBuckets - 1);
+    if (count[digit] == n) {
+      continue;
+    }
+    size_t offset = 0;
+    for (auto& c : count) {
+      size_t tmp = c;
+      c = offset;
+      offset += tmp;
+    }
+    for (size_t i = 0; i < n; ++i) {
+      uint64_t ukey = static_cast<uint64_t>((*keys)[i]) ^ kSignBit;
+      size_t pos = count[(ukey >> (pass * kBits)) & (kBuckets - 1)]++;
+      keys_buffer[pos] = (*keys)[i];
+      values_buffer[pos] = std::move((*values)[i]);
+    }
+    keys->swap(keys_buffer);
+    values->swap(values_buffer);
+  }
+}
+
+}  // namespace funcs
+}  // namespace phi
@@ -21,15 +21,12 @@ limitations under the License. */
 
 #include "paddle/common/ddim.h"
 #include "paddle/phi/core/mixed_vector.h"
+#include "paddle/phi/kernels/funcs/radix_sort.h"
 
 #ifdef PADDLE_WITH_XPU
 #include "paddle/phi/backends/xpu/enforce_xpu.h"
 #endif
 
-#ifdef PADDLE_WITH_DNNL
-#include "paddle/phi/backends/onednn/axpy_handler.h"
-#endif
-
 #include "glog/logging.h"
 
 namespace phi::funcs {
@@ -435,70 +432,6 @@ typename std::enable_if<std::is_integral<T>::value>::type elementwise_add_to(
   }
 }
 
-template <typename T, typename DeviceContext>
-typename std::enable_if<std::is_same<T, phi::dtype::bfloat16>::value>::type
-add_sparse_inputs(const std::vector<const phi::SelectedRows*>& inputs,
-                  const std::unordered_map<int64_t, size_t>& rows_to_id,
-                  int64_t input_width,
-                  const DeviceContext& context,
-                  T* out_data) {
-#ifndef PADDLE_WITH_DNNL
-  auto blas = phi::funcs::GetBlas<DeviceContext, T>(context);
-#endif
-  for (auto* input : inputs) {
-    if (input->rows().empty()) {
-      continue;
-    }
-    auto* input_data = input->value().data<T>();
-    auto& input_rows = input->rows();
-
-#ifdef PADDLE_WITH_DNNL
-    OneDNNContext onednn_context(context.GetPlace());
-    funcs::OneDNNAXPYHandler<T> axpy_handler(
-        input_width, T(1.f), onednn_context.GetEngine());
-    for (size_t i = 0; i < input_rows.size(); i++) {
-      size_t out_i = rows_to_id.at(input_rows[i]);
-      axpy_handler(&input_data[i * input_width],
-                   &out_data[out_i * input_width]);
-    }
-#else
-    for (size_t i = 0; i < input_rows.size(); i++) {
-      size_t out_i = rows_to_id.at(input_rows[i]);
-      elementwise_add_to<T, DeviceContext>(&blas,
-                                           static_cast<size_t>(input_width),
-                                           &input_data[i * input_width],
-                                           &out_data[out_i * input_width]);
-    }
-#endif
-  }
-}
-
-template <typename T, typename DeviceContext>
-typename std::enable_if<!std::is_same<T, phi::dtype::bfloat16>::value>::type
-add_sparse_inputs(const std::vector<const phi::SelectedRows*>& inputs,
-                  const std::unordered_map<int64_t, size_t>& rows_to_id,
-                  int64_t input_width,
-                  const DeviceContext& context,
-                  T* out_data) {
-  VLOG(4) << "[CPU] add_sparse_inputs <" << typeid(T).name();
-  auto blas = phi::funcs::GetBlas<DeviceContext, T>(context);
-  for (auto* input : inputs) {
-    if (input->rows().empty()) {
-      continue;
-    }
-    auto* input_data = input->value().data<T>();
-    auto& input_rows = input->rows();
-
-    for (size_t i = 0; i < input_rows.size(); i++) {
-      size_t out_i = rows_to_id.at(input_rows[i]);
-      elementwise_add_to<T, DeviceContext>(&blas,
-                                           static_cast<size_t>(input_width),
-                                           &input_data[i * input_width],
-                                           &out_data[out_i * input_width]);
-    }
-  }
-}
-
 template <typename DeviceContext, typename T>
 struct MergeAddImpl {
   phi::SelectedRows operator()(const DeviceContext& context,
@@ -540,7 +473,6 @@ struct MergeAddImpl {
     auto input_width = has_value_input->value().dims()[1];
     auto input_height = has_value_input->height();
     phi::SelectedRows& out = *output;
-    std::set<int64_t> merged_row_set;
     size_t row_num = 0;
     for (auto* input : inputs) {
       if (input->rows().empty()) {
@@ -556,16 +488,46 @@ struct MergeAddImpl {
                         common::errors::InvalidArgument(
                             "All inputs should have same height."));
       row_num += input->rows().size();
-      merged_row_set.insert(input->rows().begin(), input->rows().end());
     }
 
+    // Sort and segment: the input rows are sorted by id together with their
+    // data, then every run of equal ids is summed into one output row.
+    // Unlike a std::set and a hash map, this does no allocation per row, and
+    // the runs can be summed in parallel.
+    std::vector<int64_t> row_ids;
+    std::vector<const T*> row_data;
+    row_ids.reserve(row_num);
+    row_data.reserve(row_num);
+    for (auto* input : inputs) {
+      if (input->rows().empty()) {
+        continue;
+      }
+      auto* input_data = input->value().data<T>();
+      auto& input_rows = input->rows();
+      for (size_t i = 0; i < input_rows.size(); ++i) {
+        row_ids.push_back(input_rows[i]);
+        row_data.push_back(input_data + i * input_width);
+      }
+    }
+    RadixSortPairs(&row_ids, &row_data);
+
+    std::vector<size_t> segment_starts;
+    segment_starts.reserve(row_num + 1);
+    for (size_t i = 0; i < row_num; ++i) {
+      if (i == 0 || row_ids[i] != row_ids[i - 1]) {
+        segment_starts.push_back(i);
+      }
+    }
+    size_t merged_row_num = segment_starts.size();
+    segment_starts.push_back(row_num);
+
     out.set_height(input_height);
     DenseTensor* out_tensor = out.mutable_value();
     out_tensor->Resize(common::make_ddim(
-        {static_cast<int64_t>(merged_row_set.size()), input_width}));
+        {static_cast<int64_t>(merged_row_num), input_width}));
     auto* out_data = context.template Alloc<T>(out_tensor);
 
-    if (merged_row_set.size() == row_num && !sorted_result) {
+    if (merged_row_num == row_num && !sorted_result) {
       // no duplicated ids, just concat the result together
       std::vector<int64_t> merge_rows;
       merge_rows.reserve(row_num);
@@ -589,25 +551,30 @@ struct MergeAddImpl {
         copied_numel += static_cast<int64_t>(in_numel);
       }
     } else {
-      std::vector<int64_t> merge_rows(merged_row_set.begin(),
-                                      merged_row_set.end());
-
-      if (sorted_result) {
-        std::sort(merge_rows.begin(), merge_rows.end());
+      std::vector<int64_t> merge_rows(merged_row_num);
+      for (size_t i = 0; i < merged_row_num; ++i) {
+        merge_rows[i] = row_ids[segment_starts[i]];
       }
-
       out.set_rows(merge_rows);
 
-      phi::funcs::SetConstant<DeviceContext, T> constant_functor;
-      constant_functor(context, out.mutable_value(), static_cast<T>(0.f));
-
-      std::unordered_map<int64_t, size_t> rows_to_id;
-      for (size_t i = 0; i < merge_rows.size(); ++i) {
-        rows_to_id[merge_rows[i]] = i;
+      // Inside a segment the rows keep the input order, so they are summed
+      // in the same order as before.
+      int64_t segment_num = static_cast<int64_t>(merged_row_num);
+#ifdef PADDLE_WITH_MKLML
+#pragma omp parallel for schedule(dynamic, 64)
+#endif
+      for (int64_t i = 0; i < segment_num; ++i) {
+        T* out_row = out_data + i * input_width;
+        size_t start = segment_starts[i];
+        size_t end = segment_starts[i + 1];
+        std::copy(row_data[start], row_data[start] + input_width, out_row);
+        for (size_t j = start + 1; j < end; ++j) {
+          const T* in_row = row_data[j];
+          for (int64_t k = 0; k < input_width; ++k) {
+            out_row[k] += in_row[k];
+          }
+        }
       }
-
-      add_sparse_inputs<T, DeviceContext>(
-          inputs, rows_to_id, input_width, context, out_data);
     }
   }
 };
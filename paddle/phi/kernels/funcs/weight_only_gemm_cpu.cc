@@ -0,0 +1,114 @@
+/* Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include "paddle/phi/kernels/funcs/weight_only_gemm_cpu.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "paddle/phi/backends/cpu/cpu_info.h"
+
+namespace phi {
+namespace funcs {
+
+namespace {
+
+// Output channels handed to one OpenMP task.
+constexpr int64_t kChannelBlock = 16;
+
+inline int8_t LowNibble(int8_t byte) {
+  return static_cast<int8_t>(static_cast<int8_t>(byte << 4) >> 4);
+}
+
+inline int8_t HighNibble(int8_t byte) {
+  return static_cast<int8_t>(byte >> 4);
+}
+
+inline float ScaleOf(const WeightOnlyGemmArgs& args, int64_t c, int64_t i) {
+  return args.group_size > 0
+             ? args.scale[(i / args.group_size) * args.n + c]
+             : args.scale[c];
+}
+
+// Dequantizes output channel c into w[k].
+void DequantizeChannel(const WeightOnlyGemmArgs& args, int64_t c, float* w) {
+  const int64_t k = args.k;
+  if (args.bits == 8) {
+    const int8_t* q = args.weight + c * k;
+    for (int64_t i = 0; i < k; ++i) {
+      w[i] = static_cast<float>(q[i]) * ScaleOf(args, c, i);
+    }
+  } else {
+    const int8_t* q = args.weight + (c / 2) * k;
+    for (int64_t i = 0; i < k; ++i) {
+      int8_t v = c % 2 == 0 ? LowNibble(q[i]) : HighNibble(q[i]);
+      w[i] = static_cast<float>(v) * ScaleOf(args, c, i);
+    }
+  }
+}
+
+}  // namespace
+
+void WeightOnlyGemmRef(const WeightOnlyGemmArgs& args,
+                       int64_t n_begin,
+                       int64_t n_end) {
+  std::vector<float> w(args.k);
+  for (int64_t c = n_begin; c < n_end; ++c) {
+    DequantizeChannel(args, c, w.data());
+    for (int64_t r = 0; r < args.m; ++r) {
+      const float* x = args.x + r * args.k;
+      float sum = 0.f;
+      for (int64_t i = 0; i < args.k; ++i) {
+        sum += x[i] * w[i];
+      }
+      args.out[r * args.n + c] = sum + (args.bias ? args.bias[c] : 0.f);
+    }
+  }
+}
+
+void WeightOnlyGemm(const WeightOnlyGemmArgs& args) {
+  using phi::backends::cpu::MayIUse;
+  // The AVX512 kernel declines some shapes the AVX2 one computes, so every
+  // block tries the kernels from the widest down to the reference.
+  const bool use_avx512 = MayIUse(phi::backends::cpu::avx512f);
+  const bool use_avx2 = MayIUse(phi::backends::cpu::avx2) &&
+                        MayIUse(phi::backends::cpu::fma);
+  const int64_t num_blocks = (args.n + kChannelBlock - 1) / kChannelBlock;
+#ifdef PADDLE_WITH_MKLML
+#pragma omp parallel for
+#endif
+  for (int64_t b = 0; b < num_blocks; ++b) {
+    const int64_t n_begin = b * kChannelBlock;
+    const int64_t n_end = std::min(args.n, n_begin + kChannelBlock);
+    if (use_avx512 && WeightOnlyGemmAVX512(args, n_begin, n_end)) {
+      continue;
+    }
+    if (use_avx2 && WeightOnlyGemmAVX2(args, n_begin, n_end)) {
+      continue;
+    }
+    WeightOnlyGemmRef(args, n_begin, n_end);
+  }
+}
+
+void WeightOnlyDequantize(const WeightOnlyGemmArgs& args, float* w) {
+#ifdef PADDLE_WITH_MKLML
+#pragma omp parallel for
+#endif
+  for (int64_t c = 0; c < args.n; ++c) {
+    DequantizeChannel(args, c, w + c * args.k);
+  }
+}
+
+}  // namespace funcs
+}  // namespace phi
@@ -0,0 +1,71 @@
+/* Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#pragma once
+
+#include <cstdint>
+
+#include "paddle/utils/test_macros.h"
+
+namespace phi {
+namespace funcs {
+
+// out[m, n] = x[m, k] * W^T + bias, where W[n, k] = q[n, k] * scale is
+// dequantized on the fly. The weight is in the layout weight_quantize
+// produces on CPU (arch = 0):
+// - int8: q is [n, k] row major.
+// - int4: q is [n / 2, k], byte (j, i) holds q[2j, i] in its low nibble and
+//   q[2j + 1, i] in its high nibble, both signed.
+// scale is [n] for per-channel quantization (group_size = -1), otherwise
+// [ceil(k / group_size), n].
+struct WeightOnlyGemmArgs {
+  const float* x;
+  const int8_t* weight;
+  const float* scale;
+  const float* bias;  // [n], may be nullptr
+  float* out;
+  int64_t m;
+  int64_t n;
+  int64_t k;
+  int bits;
+  int group_size;
+};
+
+// Largest m computed by the dequantizing GEMV micro kernels. Larger inputs
+// dequantize the weight once and use a regular GEMM.
+constexpr int64_t kWeightOnlyGemvMaxM = 32;
+
+// Computes the output channels [n_begin, n_end) of `args`, n_begin and n_end
+// must be even. The SIMD variants return false when they are not compiled in
+// or do not support the shape, the caller then tries the narrower ones and
+// finally the reference.
+TEST_API void WeightOnlyGemmRef(const WeightOnlyGemmArgs& args,
+                                int64_t n_begin,
+                                int64_t n_end);
+bool WeightOnlyGemmAVX2(const WeightOnlyGemmArgs& args,
+                        int64_t n_begin,
+                        int64_t n_end);
+bool WeightOnlyGemmAVX512(const WeightOnlyGemmArgs& args,
+                          int64_t n_begin,
+                          int64_t n_end);
+
+// Picks the best micro kernel for the running CPU and computes all output
+// channels, split across OpenMP threads when available.
+TEST_API void WeightOnlyGemm(const WeightOnlyGemmArgs& args);
+
+// Dequantizes the weight of `args` into w[n, k].
+TEST_API void WeightOnlyDequantize(const WeightOnlyGemmArgs& args, float* w);
+
+}  // namespace funcs
+}  // namespace phi
@@ -0,0 +1,145 @@
+/* Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include "paddle/phi/kernels/funcs/weight_only_gemm_cpu.h"
+
+#if defined(__AVX512F__)
+#include <immintrin.h>
+#endif
+
+namespace phi {
+namespace funcs {
+
+#if defined(__AVX512F__)
+
+namespace {
+
+constexpr int kBlockK = 16;
+
+// Loads columns [i, i + 16) of output channels c and c + 1 as floats.
+template <int kBits>
+inline void LoadChannelPair(const WeightOnlyGemmArgs& args,
+                            int64_t c,
+                            int64_t i,
+                            __m512* w0,
+                            __m512* w1) {
+  if (kBits == 8) {
+    const int8_t* q = args.weight + c * args.k + i;
+    *w0 = _mm512_cvtepi32_ps(_mm512_cvtepi8_epi32(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(q))));
+    *w1 = _mm512_cvtepi32_ps(_mm512_cvtepi8_epi32(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(q + args.k))));
+  } else {
+    // Shift the nibble to the top of each lane, the arithmetic shift back
+    // sign-extends it.
+    const int8_t* q = args.weight + (c / 2) * args.k + i;
+    __m512i v = _mm512_cvtepi8_epi32(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(q)));
+    *w0 = _mm512_cvtepi32_ps(_mm512_srai_epi32(_mm512_slli_epi32(v, 28), 28));
+    *w1 = _mm512_cvtepi32_ps(_mm512_srai_epi32(_mm512_slli_epi32(v, 24), 28));
+  }
+}
+
+// Computes output channels c and c + 1 of rows [r0, r0 + kRows). The weights
+// are dequantized once and reused by all rows.
+template <int kBits, bool kGroupWise, int kRows>
+void ComputeChannelPair(const WeightOnlyGemmArgs& args, int64_t c, int64_t r0) {
+  __m512 acc0[kRows];
+  __m512 acc1[kRows];
+  for (int r = 0; r < kRows; ++r) {
+    acc0[r] = _mm512_setzero_ps();
+    acc1[r] = _mm512_setzero_ps();
+  }
+  const float* x = args.x + r0 * args.k;
+  for (int64_t i = 0; i < args.k; i += kBlockK) {
+    __m512 w0, w1;
+    LoadChannelPair<kBits>(args, c, i, &w0, &w1);
+    if (kGroupWise) {
+      const float* s = args.scale + (i / args.group_size) * args.n + c;
+      w0 = _mm512_mul_ps(w0, _mm512_set1_ps(s[0]));
+      w1 = _mm512_mul_ps(w1, _mm512_set1_ps(s[1]));
+    }
+    for (int r = 0; r < kRows; ++r) {
+      __m512 xv = _mm512_loadu_ps(x + r * args.k + i);
+      acc0[r] = _mm512_fmadd_ps(xv, w0, acc0[r]);
+      acc1[r] = _mm512_fmadd_ps(xv, w1, acc1[r]);
+    }
+  }
+  // Per-channel scales are applied once to the sums.
+  const float s0 = kGroupWise ? 1.f : args.scale[c];
+  const float s1 = kGroupWise ? 1.f : args.scale[c + 1];
+  const float b0 = args.bias ? args.bias[c] : 0.f;
+  const float b1 = args.bias ? args.bias[c + 1] : 0.f;
+  for (int r = 0; r < kRows; ++r) {
+    float* out = args.out + (r0 + r) * args.n + c;
+    out[0] = _mm512_reduce_add_ps(acc0[r]) * s0 + b0;
+    out[1] = _mm512_reduce_add_ps(acc1[r]) * s1 + b1;
+  }
+}
+
+template <int kBits, bool kGroupWise>
+void Compute(const WeightOnlyGemmArgs& args, int64_t n_begin, int64_t n_end) {
+  for (int64_t c = n_begin; c < n_end; c += 2) {
+    int64_t r = 0;
+    for (; r + 4 <= args.m; r += 4) {
+      ComputeChannelPair<kBits, kGroupWise, 4>(args, c, r);
+    }
+    switch (args.m - r) {
+      case 3:
+        ComputeChannelPair<kBits, kGroupWise, 3>(args, c, r);
+        break;
+      case 2:
+        ComputeChannelPair<kBits, kGroupWise, 2>(args, c, r);
+        break;
+      case 1:
+        ComputeChannelPair<kBits, kGroupWise, 1>(args, c, r);
+        break;
+      default:
+        break;
+    }
+  }
+}
+
+}  // namespace
+
+bool WeightOnlyGemmAVX512(const WeightOnlyGemmArgs& args,
+                        int64_t n_begin,
+                        int64_t n_end) {
+  const bool group_wise = args.group_size > 0;
+  if (args.k % kBlockK != 0 || n_begin % 2 != 0 || n_end % 2 != 0 ||
+      (group_wise && args.group_size % kBlockK != 0)) {
+    return false;
+  }
+  if (args.bits == 8) {
+    group_wise ? Compute<8, true>(args, n_begin, n_end)
+               : Compute<8, false>(args, n_begin, n_end);
+  } else {
+    group_wise ? Compute<4, true>(args, n_begin, n_end)
+               : Compute<4, false>(args, n_begin, n_end);
+  }
+  return true;
+}
+
+#else
+
+bool WeightOnlyGemmAVX512(const WeightOnlyGemmArgs& args,
+                        int64_t n_begin,
+                        int64_t n_end) {
+  return false;
+}
+
+#endif
+
+}  // namespace funcs
+}  // namespace phi
@@ -0,0 +1,182 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <string>
+#include <vector>
+
+#include "glog/logging.h"
+
+#include "paddle/phi/core/kernel_registry.h"
+#include "paddle/phi/kernels/funcs/embedding_seqpool_cvm.h"
+#include "paddle/phi/kernels/funcs/embedding_util.h"
+
+namespace phi {
+namespace fusion {
+
+template <typename T, typename IdT>
+void EmbeddingSeqpoolCvm(const std::vector<const DenseTensor*>& ids,
+                         const T* table,
+                         const float* row_scale,
+                         int64_t table_height,
+                         const std::vector<std::vector<size_t>>& lods,
+                         int64_t batch_size,
+                         const std::vector<float*>& outs,
+                         const funcs::EmbSeqPoolCVMAttr& attr) {
+  std::vector<funcs::EmbSeqPoolCVMSlot<T, IdT>> slots(ids.size());
+  for (size_t i = 0; i < ids.size(); ++i) {
+    auto& slot = slots[i];
+    slot.table = table;
+    slot.row_scale = row_scale;
+    slot.table_height = table_height;
+    slot.ids = ids[i]->data<IdT>();
+    slot.lod = lods[i].data();
+    slot.out = outs[i];
+  }
+  funcs::EmbSeqPoolCVM(slots, batch_size, attr);
+}
+
+// Looks up the embeddings of the ids of every slot in `w`, pools them per
+// sequence and applies CVM, without materializing the gathered embeddings.
+// It replaces embedding followed by sequence_pool or fused_seqpool_cvm. The
+// table may be float, float16, or int8 with one scale per row in `w_scale`;
+// the output is always float.
+template <typename T, typename Context>
+void FusedEmbeddingSeqpoolCvmKernel(
+    const Context& dev_ctx,
+    const std::vector<const DenseTensor*>& ids,
+    const DenseTensor& w,
+    const paddle::optional<DenseTensor>& w_scale,
+    const std::string& pooltype,
+    float pad_value,
+    bool use_cvm,
+    int cvm_offset,
+    int64_t padding_idx,
+    std::vector<DenseTensor*> out) {
+  int64_t table_height = w.dims()[0];
+  int64_t width = w.dims()[1];
+  const float* row_scale = nullptr;
+  if (w_scale) {
+    PADDLE_ENFORCE_EQ(w_scale->numel(),
+                      table_height,
+                      common::errors::InvalidArgument(
+                          "Input(WScale) should hold one scale per row of "
+                          "Input(W), but got %d scales for %d rows.",
+                          w_scale->numel(),
+                          table_height));
+    row_scale = w_scale->data<float>();
+  }
+
+  funcs::EmbSeqPoolCVMAttr attr;
+  attr.pool_type = funcs::GetEmbSeqPoolCVMType(pooltype);
+  attr.pad_value = pad_value;
+  attr.use_cvm = use_cvm;
+  attr.cvm_offset = cvm_offset;
+  attr.width = width;
+  attr.padding_idx = padding_idx;
+
+  // Each sequence is given by the last level of the lod of the ids, the ids
+  // without lod are sequences of one id.
+  int64_t batch_size = -1;
+  std::vector<std::vector<size_t>> lods(ids.size());
+  std::vector<float*> outs(ids.size());
+  for (size_t i = 0; i < ids.size(); ++i) {
+    PADDLE_ENFORCE_EQ(ids[i]->dtype(),
+                      ids[0]->dtype(),
+                      common::errors::InvalidArgument(
+                          "The ids of all slots should have the same dtype, "
+                          "but the %d-th ids is %s and the first ids is %s.",
+                          i,
+                          ids[i]->dtype(),
+                          ids[0]->dtype()));
+    const auto& lod = ids[i]->lod();
+    if (!lod.empty()) {
+      lods[i] = lod.back();
+    } else {
+      lods[i].resize(ids[i]->numel() + 1);
+      for (size_t j = 0; j < lods[i].size(); ++j) {
+        lods[i][j] = j;
+      }
+    }
+    int64_t cur_batch_size = static_cast<int64_t>(lods[i].size()) - 1;
+    if (batch_size == -1) {
+      batch_size = cur_batch_size;
+    } else {
+      PADDLE_ENFORCE_EQ(batch_size,
+                        cur_batch_size,
+                        common::errors::PreconditionNotMet(
+                            "The batch size of all input should be same, "
+                            "please check, last batch_size is %d, current "
+                            "batch_size is %d",
+                            batch_size,
+                            cur_batch_size));
+    }
+    PADDLE_ENFORCE_LE(
+        lods[i].back(),
+        static_cast<size_t>(ids[i]->numel()),
+        common::errors::InvalidArgument(
+            "The lod of the %d-th ids refers to %d ids, but it only has %d.",
+            i,
+            lods[i].back(),
+            ids[i]->numel()));
+
+    out[i]->Resize({batch_size, attr.out_width()});
+    // Like sequence_pool, a two level lod keeps its first level.
+    if (lod.size() > 1) {
+      phi::LegacyLoD out_lod;
+      out_lod.push_back(lod[0]);
+      out[i]->set_lod(out_lod);
+    }
+    outs[i] = dev_ctx.template Alloc<float>(out[i]);
+  }
+  VLOG(4) << "Pool " << ids.size() << " slots of " << batch_size
+          << " instances, pooltype: " << pooltype << ", use_cvm: " << use_cvm;
+
+  if (ids[0]->dtype() == DataType::INT64) {
+    EmbeddingSeqpoolCvm<T, int64_t>(ids,
+                                    w.data<T>(),
+                                    row_scale,
+                                    table_height,
+                                    lods,
+                                    batch_size,
+                                    outs,
+                                    attr);
+  } else if (ids[0]->dtype() == DataType::INT32) {
+    EmbeddingSeqpoolCvm<T, int>(ids,
+                                w.data<T>(),
+                                row_scale,
+                                table_height,
+                                lods,
+                                batch_size,
+                                outs,
+                                attr);
+  } else {
+    PADDLE_THROW(common::errors::Unimplemented(
+        "fused_embedding_seqpool_cvm ids only support int32 and int64, but "
+        "get %s",
+        ids[0]->dtype()));
+  }
+}
+
+}  // namespace fusion
+}  // namespace phi
+
+PD_REGISTER_KERNEL(fused_embedding_seqpool_cvm,
+                   CPU,
+                   ALL_LAYOUT,
+                   phi::fusion::FusedEmbeddingSeqpoolCvmKernel,
+                   float,
+                   phi::dtype::float16,
+                   int8_t) {
+  kernel->OutputAt(0).SetDataType(phi::DataType::FLOAT32);
+}
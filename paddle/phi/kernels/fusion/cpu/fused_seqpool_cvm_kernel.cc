@@ -13,10 +13,13 @@
 // limitations under the License.
 
 #include <memory>
+#include <string>
 #include <vector>
 
 #include "paddle/phi/core/kernel_registry.h"
 #include "paddle/phi/core/tensor_utils.h"
+#include "paddle/phi/kernels/funcs/embedding_seqpool_cvm.h"
+#include "paddle/phi/kernels/funcs/embedding_util.h"
 
 namespace phi {
 
@@ -29,9 +32,74 @@ void FusedSeqpoolCVMOpCPUKernel(const Context &dev_ctx,
                                 bool use_cvm,
                                 int cvm_offset,
                                 std::vector<DenseTensor *> out) {
-  PADDLE_THROW(common::errors::Unimplemented(
-      "Unimplemented CPU kernel for FusedSeqpoolCVMOp, only support GPU "
-      "now."));
+  const size_t slot_size = x.size();
+  int64_t embedding_size = x[0]->numel() / x[0]->dims()[0];
+  int64_t batch_size = -1;
+  // Like fused_embedding_seqpool_cvm, which replaces it on CPU inference, the
+  // last level of lod gives the sequences. The inputs without lod hold one
+  // embedding per instance.
+  std::vector<std::vector<size_t>> lods(slot_size);
+  std::vector<funcs::EmbSeqPoolCVMSlot<T, int64_t>> slots(slot_size);
+  for (size_t i = 0; i < slot_size; ++i) {
+    const auto *input = x[i];
+    if (!input->lod().empty()) {
+      lods[i] = input->lod().back();
+    } else {
+      lods[i].resize(input->dims()[0] + 1);
+      for (size_t j = 0; j < lods[i].size(); ++j) {
+        lods[i][j] = j;
+      }
+    }
+    int64_t cur_batch_size = static_cast<int64_t>(lods[i].size()) - 1;
+    if (batch_size == -1) {
+      batch_size = cur_batch_size;
+    } else {
+      PADDLE_ENFORCE_EQ(batch_size,
+                        cur_batch_size,
+                        common::errors::PreconditionNotMet(
+                            "The batch size of all input should be same, "
+                            "please check, last batch_size is %d, current "
+                            "batch_size is %d",
+                            batch_size,
+                            cur_batch_size));
+    }
+    PADDLE_ENFORCE_EQ(input->numel() / input->dims()[0],
+                      embedding_size,
+                      common::errors::InvalidArgument(
+                          "The embedding size of all inputs should be same, "
+                          "but got %d and %d.",
+                          embedding_size,
+                          input->numel() / input->dims()[0]));
+
+    auto *output = out[i];
+    if (use_cvm) {
+      output->Resize({batch_size, embedding_size});
+    } else {
+      output->Resize({batch_size, embedding_size - cvm_offset});
+    }
+    if (input->lod().size() > 1) {
+      phi::LegacyLoD out_lod;
+      out_lod.push_back(input->lod()[0]);
+      output->set_lod(out_lod);
+    }
+    auto &slot = slots[i];
+    slot.table = input->data<T>();
+    slot.row_scale = nullptr;
+    slot.table_height = input->dims()[0];
+    slot.ids = nullptr;
+    slot.lod = lods[i].data();
+    slot.out = dev_ctx.template Alloc<T>(output);
+  }
+
+  // Like the GPU kernel, the rows are summed whatever the pooltype.
+  funcs::EmbSeqPoolCVMAttr attr;
+  attr.pool_type = funcs::EmbSeqPoolCVMType::kSum;
+  attr.pad_value = pad_value;
+  attr.use_cvm = use_cvm;
+  attr.cvm_offset = cvm_offset;
+  attr.width = embedding_size;
+  attr.padding_idx = kNoPadding;
+  funcs::EmbSeqPoolCVM(slots, batch_size, attr);
 }
 
 }  // namespace phi
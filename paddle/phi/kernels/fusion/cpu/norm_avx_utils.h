@@ -0,0 +1,128 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <immintrin.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "paddle/phi/common/bfloat16.h"
+#include "paddle/phi/common/float16.h"
+
+// Load and store helpers of the AVX512 norm kernels. The kernels compute in
+// float, 16 lanes at a time, whatever the type of the tensors is. Only AVX512F
+// instructions are used, since these files are built with AVX512F_FLAG only,
+// so the 16-bit tails that would need the AVX512BW masked moves go through a
+// small buffer instead.
+
+namespace phi {
+namespace fusion {
+
+inline __mmask16 TailMask(int remain) {
+  return remain >= 16 ? 0xffff : static_cast<__mmask16>((1 << remain) - 1);
+}
+
+inline __m256i Load16Bits(const void* p, int remain) {
+  if (remain >= 16) {
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+  }
+  alignas(32) uint16_t buf[16] = {0};
+  memcpy(buf, p, remain * sizeof(uint16_t));
+  return _mm256_load_si256(reinterpret_cast<const __m256i*>(buf));
+}
+
+// Loads min(remain, 16) values as floats, the other lanes are zero.
+inline __m512 LoadFloats(const float* p, int remain) {
+  return _mm512_maskz_loadu_ps(TailMask(remain), p);
+}
+
+inline __m512 LoadFloats(const phi::dtype::bfloat16* p, int remain) {
+  __m512i v = _mm512_cvtepu16_epi32(Load16Bits(p, remain));
+  return _mm512_castsi512_ps(_mm512_slli_epi32(v, 16));
+}
+
+inline __m512 LoadFloats(const phi::dtype::float16* p, int remain) {
+  return _mm512_cvtph_ps(Load16Bits(p, remain));
+}
+
+// Stores the first min(remain, 16) lanes.
+inline void StoreFloats(float* p, int remain, __m512 v) {
+  _mm512_mask_storeu_ps(p, TailMask(remain), v);
+}
+
+// Rounds to nearest even as phi::dtype::bfloat16 does, NaN becomes 0x7FFF.
+inline void StoreFloats(phi::dtype::bfloat16* p, int remain, __m512 v) {
+  __m512i bits = _mm512_castps_si512(v);
+  __m512i lsb =
+      _mm512_and_si512(_mm512_srli_epi32(bits, 16), _mm512_set1_epi32(1));
+  bits = _mm512_add_epi32(bits,
+                          _mm512_add_epi32(lsb, _mm512_set1_epi32(0x7FFF)));
+  bits = _mm512_srli_epi32(bits, 16);
+  __mmask16 nan = _mm512_cmp_ps_mask(v, v, _CMP_UNORD_Q);
+  bits = _mm512_mask_mov_epi32(bits, nan, _mm512_set1_epi32(0x7FFF));
+  _mm512_mask_cvtepi32_storeu_epi16(p, TailMask(remain), bits);
+}
+
+inline void StoreFloats(phi::dtype::float16* p, int remain, __m512 v) {
+  __m256i half = _mm512_cvtps_ph(v, _MM_FROUND_TO_NEAREST_INT);
+  _mm512_mask_cvtepi32_storeu_epi16(
+      p, TailMask(remain), _mm512_cvtepu16_epi32(half));
+}
+
+// Stores the output of a norm in the type of its input.
+struct CastStore {
+  template <typename T>
+  void operator()(T* p, int remain, __m512 v) const {
+    StoreFloats(p, remain, v);
+  }
+};
+
+// Stores the output of a norm quantized to int8, which is
+// clip(round(max_bound * scale * v), min_bound, max_bound) where round_type 0
+// rounds half to even and 1 rounds half away from zero, the same as the GPU
+// kernels.
+class QuantStore {
+ public:
+  QuantStore(float scale, int round_type, float max_bound, float min_bound)
+      : scale_(_mm512_set1_ps(max_bound * scale)),
+        max_bound_(_mm512_set1_ps(max_bound)),
+        min_bound_(_mm512_set1_ps(min_bound)),
+        round_type_(round_type) {}
+
+  void operator()(int8_t* p, int remain, __m512 v) const {
+    v = _mm512_mul_ps(v, scale_);
+    if (round_type_ == 0) {
+      v = _mm512_roundscale_ps(v, _MM_FROUND_TO_NEAREST_INT);
+    } else {
+      __m512i sign = _mm512_and_si512(_mm512_castps_si512(v),
+                                      _mm512_set1_epi32(0x80000000));
+      __m512 half = _mm512_castsi512_ps(_mm512_or_si512(
+          sign, _mm512_castps_si512(_mm512_set1_ps(0.5f))));
+      v = _mm512_roundscale_ps(_mm512_add_ps(v, half), _MM_FROUND_TO_ZERO);
+    }
+    v = _mm512_min_ps(_mm512_max_ps(v, min_bound_), max_bound_);
+    _mm512_mask_cvtsepi32_storeu_epi8(
+        p, TailMask(remain), _mm512_cvttps_epi32(v));
+  }
+
+ private:
+  __m512 scale_;
+  __m512 max_bound_;
+  __m512 min_bound_;
+  int round_type_;
+};
+
+}  // namespace fusion
+}  // namespace phi
@@ -15,13 +15,91 @@
 #include <immintrin.h>
 #include <math.h>
 #include <omp.h>
+
+#include <vector>
+
 #include "paddle/phi/backends/cpu/cpu_context.h"
 #include "paddle/phi/core/kernel_registry.h"
 #include "paddle/phi/core/tensor_utils.h"
+#include "paddle/phi/kernels/fusion/cpu/norm_avx_utils.h"
 
 namespace phi {
 namespace fusion {
 
+// out = s * rsqrt(mean(s * s) + epsilon) * w + b with s = x + residual + bias,
+// where s is also written to residual_out when residual is given. The inputs
+// are read once, s is kept in float in a per thread row for the second pass.
+template <typename T, typename OutT, typename StoreFunc>
+void RmsNormFunc(const T* x_data,
+                 const T* residual_data,
+                 const T* bias_data,
+                 const T* norm_weight_data,
+                 const T* norm_bias_data,
+                 const float epsilon,
+                 const int rows,
+                 const int cols,
+                 const StoreFunc& store,
+                 OutT* out_data,
+                 T* residual_out_data,
+                 float* inv_var_data) {
+  const int size = cols;
+  const int istride = cols;
+  const int ostride = cols;
+#ifdef PADDLE_WITH_MKLML
+#pragma omp parallel
+#endif
+  {
+    std::vector<float> row(size);
+    float* pv = row.data();
+#ifdef PADDLE_WITH_MKLML
+#pragma omp for
+#endif
+    for (int r = 0; r < rows; ++r) {
+      const T* px = x_data + r * istride;
+      const T* pr = residual_data ? residual_data + r * istride : nullptr;
+      T* pr_out = residual_data ? residual_out_data + r * ostride : nullptr;
+      OutT* py = out_data + r * ostride;
+
+      __m512 vsqare = _mm512_setzero_ps();
+      for (int col = 0; col < size; col += 16) {
+        int remain = size - col;
+        // SUM(x*x)
+        __m512 vx = LoadFloats(px + col, remain);
+        if (residual_data) {
+          vx = _mm512_add_ps(vx, LoadFloats(pr + col, remain));
+          if (bias_data) {
+            vx = _mm512_add_ps(vx, LoadFloats(bias_data + col, remain));
+          }
+          StoreFloats(pr_out + col, remain, vx);
+        }
+        StoreFloats(pv + col, remain, vx);
+        vsqare = _mm512_fmadd_ps(vx, vx, vsqare);
+      }
+
+      float squareSum = _mm512_reduce_add_ps(vsqare);
+
+      // Variance
+      float var = 1 / sqrtf(squareSum / size + epsilon);
+      if (inv_var_data) {
+        inv_var_data[r] = var;
+      }
+      __m512 vvar = _mm512_set1_ps(var);
+
+      for (int col = 0; col < size; col += 16) {
+        int remain = size - col;
+        __m512 vx = LoadFloats(pv + col, remain);
+        __m512 vw = LoadFloats(norm_weight_data + col, remain);
+        // vy = vx * vvar * vw + vb
+        __m512 vy = _mm512_mul_ps(_mm512_mul_ps(vx, vvar), vw);
+        if (norm_bias_data) {
+          vy = _mm512_add_ps(vy, LoadFloats(norm_bias_data + col, remain));
+        }
+        store(py + col, remain, vy);
+      }
+    }  // end for rows
+  }
+}
+
 template <typename T, typename Context>
 void RmsNormAvxKernel(const Context& dev_ctx,
                       const DenseTensor& x,
@@ -38,10 +116,6 @@ void RmsNormAvxKernel(const Context& dev_ctx,
                       DenseTensor* out,
                       DenseTensor* residual_out,
                       DenseTensor* inv_var) {
-  if (quant_scale > 0.0f) {
-    PD_THROW("NOT supported quant int8. ");
-  }
-
   const T* x_data = x.data<T>();
   int32_t rows = 1;
   int32_t cols = 1;
@@ -52,116 +126,65 @@ void RmsNormAvxKernel(const Context& dev_ctx,
     cols *= x.dims()[i];
   }
 
-  int size = cols;
-  auto istride = cols;
-  auto ostride = cols;
   const T* norm_weight_data = norm_weight.data<T>();
   const T* norm_bias_data = norm_bias ? norm_bias.get().data<T>() : nullptr;
   const T* residual_data = residual ? residual.get().data<T>() : nullptr;
   const T* bias_data = bias ? bias.get().data<T>() : nullptr;
-  T* out_data = dev_ctx.template Alloc<T>(out);
   T* residual_out_data =
       residual ? dev_ctx.template Alloc<T>(residual_out) : nullptr;
+  float* inv_var_data =
+      inv_var ? dev_ctx.template Alloc<float>(inv_var) : nullptr;
 
-  __m512 vb = _mm512_setzero_ps();
-  const T* pb = bias_data;
-#ifdef PADDLE_WITH_MKLML
-#pragma omp parallel for
-#endif
-  for (int r = 0; r < rows; ++r) {
-    const T* px = x_data + r * istride;
-    const T* pr = residual ? residual_data + r * istride : nullptr;
-    T* pr_out = residual ? residual_out_data + r * ostride : nullptr;
-    T* py = out_data + r * ostride;
-
-    T squareSum = 0;
-
-    __m512 vsqare = _mm512_set1_ps(0);
-
-    int col = 0;
-    for (; col + 15 < size; col += 16) {
-      // SUM(x*x)
-      __m512 vx = _mm512_loadu_ps(px + col);
-      if (residual) {
-        __m512 residual_vx = _mm512_loadu_ps(pr + col);
-        vx = _mm512_add_ps(vx, residual_vx);
-        if (bias) {
-          __m512 vb = _mm512_loadu_ps(pb + col);
-          vx = _mm512_add_ps(vx, vb);
-        }
-        _mm512_storeu_ps(pr_out + col, vx);
-      }
-      __m512 tmp = _mm512_mul_ps(vx, vx);
-      vsqare = _mm512_add_ps(vsqare, tmp);
-    }
-    if (col < size) {
-      __mmask16 mask = (1 << (size - col)) - 1;
-      __m512 vx = _mm512_maskz_loadu_ps(mask, px + col);
-      if (residual) {
-        __m512 residual_vx = _mm512_maskz_loadu_ps(mask, pr + col);
-        vx = _mm512_mask_add_ps(vx, mask, vx, residual_vx);
-        if (bias) {
-          __m512 vb = _mm512_maskz_loadu_ps(mask, pb + col);
-          vx = _mm512_mask_add_ps(vx, mask, vx, vb);
-        }
-        _mm512_mask_storeu_ps(pr_out + col, mask, vx);
-      }
-      __m512 tmp = _mm512_mul_ps(vx, vx);
-      vsqare = _mm512_add_ps(vsqare, tmp);
-    }
-
-    squareSum = _mm512_reduce_add_ps(vsqare);
-
-    // Variance
-    T var = 1 / sqrt(squareSum / size + epsilon);
-    __m512 vvar = _mm512_set1_ps(var);
-
-    for (col = 0; col + 15 < size; col += 16) {
-      __m512 vx = _mm512_loadu_ps(px + col);
-      if (residual) {
-        __m512 residual_vx = _mm512_loadu_ps(pr + col);
-        vx = _mm512_add_ps(vx, residual_vx);
-        if (bias) {
-          __m512 vb = _mm512_loadu_ps(pb + col);
-          vx = _mm512_add_ps(vx, vb);
-        }
-      }
-      __m512 vw = _mm512_loadu_ps(norm_weight_data + col);
-      if (norm_bias_data) {
-        vb = _mm512_loadu_ps(norm_bias_data + col);
-      }
-
-      // vy = vx * vvar * vw + vb
-      vx = _mm512_mul_ps(vx, vvar);
-      vx = _mm512_mul_ps(vx, vw);
-      __m512 vy = _mm512_add_ps(vx, vb);
-      _mm512_storeu_ps(py + col, vy);
-    }
-    if (col < size) {
-      __mmask16 mask = (1 << (size - col)) - 1;
-      __m512 vx = _mm512_maskz_loadu_ps(mask, px + col);
-      if (residual) {
-        __m512 residual_vx = _mm512_maskz_loadu_ps(mask, pr + col);
-        vx = _mm512_mask_add_ps(vx, mask, vx, residual_vx);
-        if (bias) {
-          __m512 vb = _mm512_maskz_loadu_ps(mask, pb + col);
-          vx = _mm512_mask_add_ps(vx, mask, vx, vb);
-        }
-      }
-      __m512 vw = _mm512_maskz_loadu_ps(mask, norm_weight_data + col);
-      if (norm_bias_data) {
-        vb = _mm512_maskz_loadu_ps(mask, norm_bias_data + col);
-      }
-      // vx * vvar * vw + vb
-      vx = _mm512_mask_mul_ps(vx, mask, vx, vvar);
-      vx = _mm512_mask_mul_ps(vx, mask, vx, vw);
-      __m512 vy = _mm512_mask_add_ps(vx, mask, vx, vb);
-      _mm512_mask_storeu_ps(py + col, mask, vy);
-    }
-  }  // end for rows
+  if (quant_scale > 0.0f) {
+    PADDLE_ENFORCE_LT(
+        fabs(quant_max_bound - 127.0f),
+        0.000001,
+        common::errors::Unimplemented(
+            "Only int8 quantization, whose quant_max_bound is 127, is "
+            "supported by the CPU rms_norm, but got quant_max_bound %f.",
+            quant_max_bound));
+    int8_t* out_data = dev_ctx.template Alloc<int8_t>(out);
+    RmsNormFunc(x_data,
+                residual_data,
+                bias_data,
+                norm_weight_data,
+                norm_bias_data,
+                epsilon,
+                rows,
+                cols,
+                QuantStore(quant_scale,
+                           quant_round_type,
+                           quant_max_bound,
+                           quant_min_bound),
+                out_data,
+                residual_out_data,
+                inv_var_data);
+  } else {
+    T* out_data = dev_ctx.template Alloc<T>(out);
+    RmsNormFunc(x_data,
+                residual_data,
+                bias_data,
+                norm_weight_data,
+                norm_bias_data,
+                epsilon,
+                rows,
+                cols,
+                CastStore(),
+                out_data,
+                residual_out_data,
+                inv_var_data);
+  }
 }
 }  // namespace fusion
 }  // namespace phi
 
-PD_REGISTER_KERNEL(
-    rms_norm, CPU, ALL_LAYOUT, phi::fusion::RmsNormAvxKernel, float) {}
+PD_REGISTER_KERNEL(rms_norm,
+                   CPU,
+                   ALL_LAYOUT,
+                   phi::fusion::RmsNormAvxKernel,
+                   float,
+                   phi::dtype::float16,
+                   phi::dtype::bfloat16) {
+  kernel->OutputAt(0).SetDataType(phi::DataType::UNDEFINED);
+  kernel->OutputAt(2).SetDataType(phi::DataType::FLOAT32);
+}
@@ -300,13 +300,13 @@ class FCOneDNNHandler
 
   std::shared_ptr<dnnl::memory> AcquireWeightsMemoryWithReorder(
       const phi::DenseTensor* weights, const std::vector<float>& scale_data) {
-    const std::string weights_base_key = this->memory_key_ + "@weights";
-    std::string weights_key;
-    weights_key.reserve(128);
-    weights_key = phi::funcs::ExtendKeyWithThreadInfoIfNeeded(
+    const auto weights_key = phi::funcs::ExtendKeyWithThreadInfoIfNeeded(
         dev_ctx_,
-        phi::funcs::CreateKey(
-            dev_ctx_, weights_base_key, this->fwd_pd_->weights_desc()));
+        phi::funcs::CreateHashedKey(dev_ctx_,
+                                    "fc",
+                                    this->memory_key_,
+                                    "@weights",
+                                    this->fwd_pd_->weights_desc()));
     auto memory_p = std::static_pointer_cast<dnnl::memory>(
         this->dev_ctx_.GetBlob(weights_key));
 
@@ -428,15 +428,14 @@ void RunKernel(const phi::OneDNNContext& dev_ctx,
   std::shared_ptr<dnnl::memory> bias_memory_p;
   std::shared_ptr<dnnl::memory> dst_memory_p;
 
-  std::string cache_key;
-  cache_key.reserve(64);
-  cache_key = phi::funcs::ExtendKeyWithThreadInfoIfNeeded(
+  const auto cache_key = phi::funcs::ExtendKeyWithThreadInfoIfNeeded(
       dev_ctx,
-      phi::funcs::CreateKey(dev_ctx,
-                            dev_ctx.GetInputsName("Input")[0],
-                            dev_ctx.GetInputsName("W")[0],
-                            common::vectorize(input.dims()),
-                            common::vectorize(w.dims())));
+      phi::funcs::CreateHashedKey(dev_ctx,
+                                  "fc",
+                                  dev_ctx.GetInputsName("Input")[0],
+                                  dev_ctx.GetInputsName("W")[0],
+                                  common::vectorize(input.dims()),
+                                  common::vectorize(w.dims())));
 
   auto inner_product_cache =
       std::static_pointer_cast<InnerProductCache>(dev_ctx.GetBlob(cache_key));
@@ -24,7 +24,7 @@
 namespace phi::fusion {
 
 using phi::OneDNNContext;
-using phi::funcs::CreateKey;
+using phi::funcs::CreateHashedKey;
 using phi::funcs::OneDNNGetDataType;
 using phi::funcs::OneDNNMemDesc;
 using phi::funcs::RNNReorderType;
@@ -54,11 +54,12 @@ class GRUOneDNNHandler
             dev_ctx,
             dev_ctx.GetEngine(),
             cpu_place,
-            CreateKey(dev_ctx,
-                      dev_ctx.GetInputsName("X")[0] +
-                          dev_ctx.GetInputsName("WeightH")[0],
-                      OneDNNGetDataType<T>(),
-                      Ti)),
+            CreateHashedKey(dev_ctx,
+                            "fusion_gru",
+                            dev_ctx.GetInputsName("X")[0] +
+                                dev_ctx.GetInputsName("WeightH")[0],
+                            OneDNNGetDataType<T>(),
+                            Ti)),
         N(N),
         Ti(Ti),
         IC(IC),
@@ -69,7 +70,9 @@ class GRUOneDNNHandler
     // Create memory key without Ti because weights, bias and h0 memories
     // do not depend on Ti size but primitive and input/output memory do
     memory_key_ = phi::funcs::ExtendKeyWithThreadInfoIfNeeded(
-        dev_ctx, CreateKey(dev_ctx, unique_name, OneDNNGetDataType<T>()));
+        dev_ctx,
+        CreateHashedKey(
+            dev_ctx, "fusion_gru", unique_name, OneDNNGetDataType<T>()));
     // Is it int8 kernel
     const bool is_INT8 = std::is_same<T, uint8_t>::value;
     if (is_INT8) {
@@ -213,7 +216,7 @@ class GRUOneDNNHandler
 
   std::shared_ptr<dnnl::memory> AcquireInputMemoryWithReorder(
       const phi::DenseTensor* input, const bool is_reverse) {
-    const auto name = this->key_ + "@input_mem";
+    const auto name = this->hkey_.Derive("@input_mem");
     auto memory_p =
         std::static_pointer_cast<dnnl::memory>(this->dev_ctx_.GetBlob(name));
 
@@ -240,7 +243,7 @@ class GRUOneDNNHandler
   }
 
   std::shared_ptr<dnnl::memory> AcquireOutputMemory() {
-    const auto name = this->key_ + "@output_mem";
+    const auto name = this->hkey_.Derive("@output_mem");
     auto memory_p =
         std::static_pointer_cast<dnnl::memory>(this->dev_ctx_.GetBlob(name));
 
@@ -255,7 +258,7 @@ class GRUOneDNNHandler
   // H0 is for now persistable
   template <typename U>
   std::shared_ptr<dnnl::memory> AcquireH0Memory(const phi::DenseTensor* h0) {
-    const std::string h0_key = memory_key_ + "@h0";
+    const auto h0_key = memory_key_.Derive("@h0");
     auto memory_p =
         std::static_pointer_cast<dnnl::memory>(this->dev_ctx_.GetBlob(h0_key));
 
@@ -287,7 +290,7 @@ class GRUOneDNNHandler
   template <typename U>
   std::shared_ptr<dnnl::memory> AcquireWeightXMemory(
       const phi::DenseTensor* weight_x, const bool origin_mode) {
-    const std::string wx_key = this->memory_key_ + "@weight_x";
+    const auto wx_key = this->memory_key_.Derive("@weight_x");
     auto memory_p =
         std::static_pointer_cast<dnnl::memory>(this->dev_ctx_.GetBlob(wx_key));
 
@@ -327,7 +330,7 @@ class GRUOneDNNHandler
   template <typename U>
   std::shared_ptr<dnnl::memory> AcquireWeightHMemory(
       const phi::DenseTensor* weight_h, const bool origin_mode) {
-    const std::string wh_key = this->memory_key_ + "@weight_h";
+    const auto wh_key = this->memory_key_.Derive("@weight_h");
     auto memory_p =
         std::static_pointer_cast<dnnl::memory>(this->dev_ctx_.GetBlob(wh_key));
 
@@ -380,7 +383,7 @@ class GRUOneDNNHandler
 
   std::shared_ptr<dnnl::memory> AcquireBiasMemory(const phi::DenseTensor* bias,
                                                   const bool origin_mode) {
-    const std::string bias_key = this->memory_key_ + "@bias";
+    const auto bias_key = this->memory_key_.Derive("@bias");
     auto memory_p = std::static_pointer_cast<dnnl::memory>(
         this->dev_ctx_.GetBlob(bias_key));
 
@@ -419,7 +422,7 @@ class GRUOneDNNHandler
 
   // Memory size of weights, bias and h0 does not depend
   // on Ti size, thus we need another key to cache them
-  std::string memory_key_;
+  OneDNNCacheKey memory_key_;
   dnnl::primitive_attr attr_;
 };
 
@@ -175,7 +175,7 @@ class LSTMMKLDNNHandler
   template <typename U>
   std::shared_ptr<dnnl::memory> AcquireWeightXMemory(
       const phi::DenseTensor* weight_x) {
-    const std::string wx_key = this->memory_key_ + "@weight_x";
+    const auto wx_key = this->memory_key_.Derive("@weight_x");
     auto memory_p =
         std::static_pointer_cast<dnnl::memory>(this->dev_ctx_.GetBlob(wx_key));
 
@@ -207,7 +207,7 @@ class LSTMMKLDNNHandler
   template <typename U>
   std::shared_ptr<dnnl::memory> AcquireWeightHMemory(
       const phi::DenseTensor* weight_h) {
-    const std::string wh_key = this->memory_key_ + "@weight_h";
+    const auto wh_key = this->memory_key_.Derive("@weight_h");
     auto memory_p =
         std::static_pointer_cast<dnnl::memory>(this->dev_ctx_.GetBlob(wh_key));
 
@@ -238,7 +238,7 @@ class LSTMMKLDNNHandler
 
   std::shared_ptr<dnnl::memory> AcquireBiasMemory(
       const phi::DenseTensor* bias) {
-    const std::string bias_key = this->memory_key_ + "@bias";
+    const auto bias_key = this->memory_key_.Derive("@bias");
     auto memory_p = std::static_pointer_cast<dnnl::memory>(
         this->dev_ctx_.GetBlob(bias_key));
 
@@ -266,7 +266,7 @@ class LSTMMKLDNNHandler
 
   std::shared_ptr<dnnl::memory> AcquirePeepholeWeights(
       const phi::DenseTensor* bias) {
-    const std::string peepholes_key = this->memory_key_ + "@peepholes_weights";
+    const auto peepholes_key = this->memory_key_.Derive("@peepholes_weights");
     auto memory_p = std::static_pointer_cast<dnnl::memory>(
         this->dev_ctx_.GetBlob(peepholes_key));
 
@@ -292,7 +292,7 @@ class LSTMMKLDNNHandler
   }
 
   std::shared_ptr<dnnl::memory> AcquireC0Memory(const phi::DenseTensor* c0) {
-    const std::string c0_key = this->memory_key_ + "@c0";
+    const auto c0_key = this->memory_key_.Derive("@c0");
     auto memory_p =
         std::static_pointer_cast<dnnl::memory>(this->dev_ctx_.GetBlob(c0_key));
 
@@ -20,7 +20,7 @@
 namespace phi {
 namespace fusion {
 
-using phi::funcs::CreateKey;
+using phi::funcs::CreateHashedKey;
 using phi::funcs::OneDNNGetDataType;
 using phi::funcs::RNNReorderType;
 using OneDNNMemoryFormat = dnnl::memory::format_tag;
@@ -48,7 +48,11 @@ class RNNMKLDNNHandler : public phi::funcs::OneDNNHandlerT<T, T_alg> {
             dev_ctx,
             dev_ctx.GetEngine(),
             cpu_place,
-            CreateKey(dev_ctx, unique_name, OneDNNGetDataType<T>(), Ti)),
+            CreateHashedKey(dev_ctx,
+                            "fusion_lstm",
+                            unique_name,
+                            OneDNNGetDataType<T>(),
+                            Ti)),
         N(N),
         Ti(Ti),
         IC(IC),
@@ -57,7 +61,9 @@ class RNNMKLDNNHandler : public phi::funcs::OneDNNHandlerT<T, T_alg> {
     // Create memory key without Ti because weights, bias and h0 memories
     // do not depend on Ti size but primitive and input/output memory do
     memory_key_ = phi::funcs::ExtendKeyWithThreadInfoIfNeeded(
-        dev_ctx, CreateKey(dev_ctx, unique_name, OneDNNGetDataType<T>()));
+        dev_ctx,
+        CreateHashedKey(
+            dev_ctx, "fusion_lstm", unique_name, OneDNNGetDataType<T>()));
 
     // Is it int8 kernel
     const bool is_INT8 = std::is_same<T, uint8_t>::value;
@@ -151,7 +157,7 @@ class RNNMKLDNNHandler : public phi::funcs::OneDNNHandlerT<T, T_alg> {
 
   std::shared_ptr<dnnl::memory> AcquireInputMemoryWithReorder(
       const phi::DenseTensor* input, const bool is_reverse) {
-    const auto name = this->key_ + "@input_mem";
+    const auto name = this->hkey_.Derive("@input_mem");
     auto memory_p =
         std::static_pointer_cast<dnnl::memory>(this->dev_ctx_.GetBlob(name));
 
@@ -178,7 +184,7 @@ class RNNMKLDNNHandler : public phi::funcs::OneDNNHandlerT<T, T_alg> {
   }
 
   std::shared_ptr<dnnl::memory> AcquireOutputMemory() {
-    const auto name = this->key_ + "@output_mem";
+    const auto name = this->hkey_.Derive("@output_mem");
     auto memory_p =
         std::static_pointer_cast<dnnl::memory>(this->dev_ctx_.GetBlob(name));
 
@@ -193,7 +199,7 @@ class RNNMKLDNNHandler : public phi::funcs::OneDNNHandlerT<T, T_alg> {
   // H0 is for now persistable
   template <typename U>
   std::shared_ptr<dnnl::memory> AcquireH0Memory(const phi::DenseTensor* h0) {
-    const std::string h0_key = memory_key_ + "@h0";
+    const auto h0_key = memory_key_.Derive("@h0");
     auto memory_p =
         std::static_pointer_cast<dnnl::memory>(this->dev_ctx_.GetBlob(h0_key));
 
@@ -233,7 +239,7 @@ class RNNMKLDNNHandler : public phi::funcs::OneDNNHandlerT<T, T_alg> {
 
   // Memory size of weights, bias and h0 does not depend
   // on Ti size, thus we need another key to cache them
-  std::string memory_key_;
+  OneDNNCacheKey memory_key_;
   dnnl::primitive_attr attr_;
 };
 }  // namespace fusion
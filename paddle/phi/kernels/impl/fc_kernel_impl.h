@@ -48,7 +48,6 @@ void FCKernel(const Context& dev_ctx,
   int M = common::product(out_dims) / w_dims1;
 
   const T* input_data = input.data<T>();
-  const T* w_data = w.data<T>();
   auto* output_data = dev_ctx.template Alloc<T>(out, out->numel() * sizeof(T));
 
   phi::funcs::FCFunctor<Context, T> fc;
@@ -57,7 +56,7 @@ void FCKernel(const Context& dev_ctx,
      w_dims1,
      w_dims0,
      input_data,
-     w_data,
+     w,
      output_data,
      bias ? bias->data<T>() : NULL,
      with_relu,
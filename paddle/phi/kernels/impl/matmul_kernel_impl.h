@@ -27,6 +27,7 @@ limitations under the License. */
 #include "paddle/phi/kernels/funcs/blas/blaslt_impl.cu.h"
 #endif
 #include "paddle/phi/kernels/funcs/complex_functors.h"
+#include "paddle/phi/kernels/funcs/packed_gemm_cache.h"
 #include "paddle/phi/kernels/scale_kernel.h"
 #if defined(PADDLE_WITH_CUDA)
 #include "paddle/phi/kernels/funcs/cublaslt.h"
@@ -383,16 +384,27 @@ void MatMulFunctionImplWithBlas(
   if (out_batch_size == 0) return;
   if (x_batch_size == 1 && y_batch_size == 1) {
     VLOG(3) << "MatMul's case 8";
-    blas.GEMM(trans_x ? CblasTrans : CblasNoTrans,
-              trans_y ? CblasTrans : CblasNoTrans,
-              M,
-              N,
-              K,
-              static_cast<T>(1),
-              x_data,
-              y_data,
-              static_cast<T>(flag),
-              dev_ctx.template Alloc<T>(Out));
+    T* out_data = dev_ctx.template Alloc<T>(Out);
+    if (trans_x || !phi::funcs::PackedGemm(dev_ctx,
+                                           M,
+                                           N,
+                                           K,
+                                           x_data,
+                                           Y,
+                                           trans_y,
+                                           static_cast<T>(flag),
+                                           out_data)) {
+      blas.GEMM(trans_x ? CblasTrans : CblasNoTrans,
+                trans_y ? CblasTrans : CblasNoTrans,
+                M,
+                N,
+                K,
+                static_cast<T>(1),
+                x_data,
+                y_data,
+                static_cast<T>(flag),
+                out_data);
+    }
   } else if (x_batch_size == 1) {
     if (M == 1 && trans_y) {
       VLOG(3) << "MatMul's case 9";
@@ -423,16 +435,27 @@ void MatMulFunctionImplWithBlas(
   } else if (y_batch_size == 1) {
     if (!trans_x) {
       VLOG(3) << "MatMul's case 11";
-      blas.GEMM(CblasNoTrans,
-                trans_y ? CblasTrans : CblasNoTrans,
-                x_batch_size * M,
-                N,
-                K,
-                static_cast<T>(1),
-                x_data,
-                y_data,
-                static_cast<T>(flag),
-                dev_ctx.template Alloc<T>(Out));
+      T* out_data = dev_ctx.template Alloc<T>(Out);
+      if (!phi::funcs::PackedGemm(dev_ctx,
+                                  static_cast<int>(x_batch_size * M),
+                                  N,
+                                  K,
+                                  x_data,
+                                  Y,
+                                  trans_y,
+                                  static_cast<T>(flag),
+                                  out_data)) {
+        blas.GEMM(CblasNoTrans,
+                  trans_y ? CblasTrans : CblasNoTrans,
+                  x_batch_size * M,
+                  N,
+                  K,
+                  static_cast<T>(1),
+                  x_data,
+                  y_data,
+                  static_cast<T>(flag),
+                  out_data);
+      }
     } else {
       VLOG(3) << "MatMul's case 12";
       blas.BatchedGEMM(CblasTrans,
@@ -20,6 +20,7 @@
 #include "paddle/common/macros.h"
 #include "paddle/phi/common/amp_type_traits.h"
 #include "paddle/phi/core/dense_tensor.h"
+#include "paddle/phi/kernels/funcs/cpu_multi_tensor_apply.h"
 #include "paddle/phi/kernels/funcs/for_range.h"
 #include "paddle/phi/kernels/impl/momentum_kernel_impl.h"
 #include "paddle/phi/kernels/merged_momentum_kernel.h"
@@ -85,6 +86,62 @@ struct MergedMomentumKernelParam
   }
 };
 
+// The CPU version of MergedMomentumKernelParam: one parallel pass over the
+// chunks of all the parameters instead of one loop over the largest one.
+template <typename T, typename MT, typename MPType>
+void MergedMomentumCPUCompute(
+    const std::vector<const DenseTensor *> &params,
+    const std::vector<const DenseTensor *> &grads,
+    const DenseTensor *lr,
+    float mu,
+    float rescale_grad,
+    bool multi_precision,
+    const std::vector<DenseTensor *> &params_out,
+    const std::vector<DenseTensor *> &velocities_out,
+    const std::vector<DenseTensor *> &master_params_out) {
+  size_t n = params.size();
+  std::vector<T *> param_ptrs(n);
+  std::vector<const T *> grad_ptrs(n);
+  std::vector<MT *> velocity_ptrs(n);
+  std::vector<MT *> master_param_ptrs(n, nullptr);
+  for (size_t i = 0; i < n; ++i) {
+    param_ptrs[i] = params_out[i]->data<T>();
+    grad_ptrs[i] = grads[i]->data<T>();
+    velocity_ptrs[i] = velocities_out[i]->data<MT>();
+    if (multi_precision) {
+      master_param_ptrs[i] = master_params_out[i]->data<MT>();
+    }
+  }
+  const MT lr_val = static_cast<MT>(*lr->data<MPType>());
+  const MT mu_val = static_cast<MT>(mu);
+  const MT rescale_grad_val = static_cast<MT>(rescale_grad);
+
+  auto chunks = funcs::SplitTensorsIntoChunks(params, 4096);
+  funcs::CPUMultiTensorApply(chunks, [&](const funcs::CPUTensorChunk &c) {
+    T *param_p = param_ptrs[c.tensor_id] + c.offset;
+    const T *grad_p = grad_ptrs[c.tensor_id] + c.offset;
+    MT *velocity_p = velocity_ptrs[c.tensor_id] + c.offset;
+    MT *master_param_p = master_param_ptrs[c.tensor_id];
+    if (master_param_p) {
+      master_param_p += c.offset;
+    }
+    for (int64_t i = 0; i < c.numel; ++i) {
+      const MT param =
+          master_param_p ? master_param_p[i] : static_cast<MT>(param_p[i]);
+      const MT grad = static_cast<MT>(grad_p[i]) * rescale_grad_val;
+      const MT velocity_out = velocity_p[i] * mu_val + grad;
+      const MT param_out = param - lr_val * velocity_out;
+      velocity_p[i] = velocity_out;
+      param_p[i] = static_cast<T>(param_out);
+      if (master_param_p) {
+        master_param_p[i] = param_out;
+      }
+    }
+  });
+  VLOG(10) << "Launch MergedMomentum cpu kernel with " << chunks.size()
+           << " chunks.";
+}
+
 template <typename MT, typename Context, typename MPType, typename T>
 void MergedMomentumInnerCompute(
     const Context &ctx,
@@ -260,7 +317,17 @@ void MergedMomentumInnerCompute(
     VLOG(10) << "Launch MergedMomentum kernel " << i << " "                \
              << kernel_params.param_num;                                   \
   }
-    if (multi_precision) {
+    if (ctx.GetPlace().GetType() == phi::AllocationType::CPU) {
+      MergedMomentumCPUCompute<T, MT, MPType>(params,
+                                              grads,
+                                              lrs[0],
+                                              mu,
+                                              rescale_grad,
+                                              multi_precision,
+                                              params_out,
+                                              velocities_out,
+                                              master_params_out);
+    } else if (multi_precision) {
       PADDLE_LAUNCH_MERGED_MOMENTUM_KERNEL(true);
     } else {
       PADDLE_LAUNCH_MERGED_MOMENTUM_KERNEL(false);
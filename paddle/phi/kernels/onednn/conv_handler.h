@@ -67,8 +67,10 @@ class ConvOneDNNHandlerT
             dev_ctx,
             onednn_engine,
             cpu_place,
-            funcs::CreateKey(
-                dev_ctx, common::vectorize(input->dims()), unique_name)) {
+            funcs::CreateHashedKey(dev_ctx,
+                                   "conv2d",
+                                   common::vectorize(input->dims()),
+                                   unique_name)) {
     if (unlikely(!this->isCached())) {
       PADDLE_ENFORCE_EQ(
           input->layout(),
@@ -270,8 +272,10 @@ class ConvOneDNNHandlerT
             dev_ctx,
             dev_ctx.GetEngine(),
             cpu_place,
-            funcs::CreateKey(
-                dev_ctx, common::vectorize(in->dims()), unique_name)) {
+            funcs::CreateHashedKey(dev_ctx,
+                                   "conv2d",
+                                   common::vectorize(in->dims()),
+                                   unique_name)) {
     if (unlikely(!this->isBwdCached())) {
       PADDLE_ENFORCE_EQ(
           in->layout(),
@@ -480,68 +484,41 @@ class ConvOneDNNHandlerT
 
   std::shared_ptr<dnnl::memory> AcquireSrcMemoryWithReorder(
       const phi::DenseTensor* input) {
-    return this->AcquireMemoryWithReorderPrimitive(input,
-                                                   "@src_mem_p_user",
-                                                   "@src_mem_p_target",
-                                                   "@src_mem_p",
-                                                   this->fwd_pd_->src_desc());
+    return this->AcquireMemoryWithReorderPrimitive(
+        input, "@src_mem_p", this->fwd_pd_->src_desc());
   }
 
   std::shared_ptr<dnnl::memory> AcquireSrcMemoryWithReorderFromWeightsPrimitive(
       const phi::DenseTensor* input) {
-    return this->AcquireMemoryWithReorderPrimitive(input,
-                                                   "@src_mem_w_p_user",
-                                                   "@src_mem_w_p_target",
-                                                   "@src_mem_w_p",
-                                                   this->bwd_w_pd_->src_desc());
+    return this->AcquireMemoryWithReorderPrimitive(
+        input, "@src_mem_w_p", this->bwd_w_pd_->src_desc());
   }
 
   std::shared_ptr<dnnl::memory>
   AcquireDiffDstMemoryWithReorderFromWeightsPrimitive(
       const phi::DenseTensor* out_grad) {
     return this->AcquireMemoryWithReorderPrimitive(
-        out_grad,
-        "@diff_dst_mem_w_p_user",
-        "@diff_dst_mem_w_p_target",
-        "@diff_dst_mem_w_p",
-        this->bwd_w_pd_->diff_dst_desc());
+        out_grad, "@diff_dst_mem_w_p", this->bwd_w_pd_->diff_dst_desc());
   }
 
   std::shared_ptr<dnnl::memory>
   AcquireDiffDstMemoryWithReorderMemoryFromDataPrimitive(
       const phi::DenseTensor* out_grad) {
     return this->AcquireMemoryWithReorderPrimitive(
-        out_grad,
-        "@diff_dst_mem_p_user",
-        "@diff_dst_mem_p_target",
-        "@diff_dst_mem_p",
-        this->bwd_pd_->diff_dst_desc());
+        out_grad, "@diff_dst_mem_p", this->bwd_pd_->diff_dst_desc());
   }
 
+  // Once cached, the user memory is pointed at the new data and the cached
+  // reorder, if any, is run again by AcquireMemoryWithReorder
   std::shared_ptr<dnnl::memory> AcquireMemoryWithReorderPrimitive(
       const phi::DenseTensor* in_mem,
-      const char* key_mem_user,
-      const char* key_mem_target,
       const char* key_mem,
       const dnnl::memory::desc& mem_md) {
     const T* in_mem_data = in_mem->data<T>();
-    const std::string user_key_suffix{key_mem_user};
-    auto user_mem_p = this->AcquireMemory(user_key_suffix);
-
-    if (!user_mem_p) {
-      return this->AcquireMemoryWithReorder(in_mem->mem_desc(),
-                                            mem_md,
-                                            funcs::to_void_cast<T>(in_mem_data),
-                                            key_mem);
-    } else {
-      const std::string target_key_suffix{key_mem_target};
-      const auto target_mem_p = this->AcquireMemory(target_key_suffix);
-      user_mem_p->set_data_handle(funcs::to_void_cast<T>(in_mem_data));
-      if (user_mem_p != target_mem_p) {
-        this->AcquireReorder(user_mem_p, target_mem_p);
-      }
-      return target_mem_p;
-    }
+    return this->AcquireMemoryWithReorder(in_mem->mem_desc(),
+                                          mem_md,
+                                          funcs::to_void_cast<T>(in_mem_data),
+                                          key_mem);
   }
 
   std::shared_ptr<dnnl::memory> AcquireWeightsMemoryWithReorder(
@@ -553,7 +530,7 @@ class ConvOneDNNHandlerT
       int mask = 0) {
     // This is workaround to make execution faster, delete
     // if statement after including md inside Tensor
-    auto weights_mem_p = this->AcquireMemory("@weights_mem_p_target");
+    auto weights_mem_p = this->AcquireTargetMemory("@weights_mem_p");
     if (is_test && weights_mem_p) {
       return weights_mem_p;
     } else if (is_test) {
@@ -600,7 +577,7 @@ class ConvOneDNNHandlerT
       const bool is_test,
       const std::vector<float>& scale_data = {1.0f},
       int mask = 0) {
-    auto bias_mem_p = this->AcquireMemory("@bias_mem_p_target");
+    auto bias_mem_p = this->AcquireTargetMemory("@bias_mem_p");
     if (is_test && bias_mem_p) {
       return bias_mem_p;
     } else {
@@ -211,7 +211,7 @@ class ConvTransposeOneDNNHandlerT
 
   std::shared_ptr<dnnl::memory> AcquireWeightsMemoryWithReorder(
       const OneDNNContext& dev_ctx,
-      const std::string& key,
+      const OneDNNCacheKey& key,
       const phi::DenseTensor* filter,
       const int& groups) {
     const K* filter_data = filter->data<K>();
@@ -240,14 +240,15 @@ class ConvTransposeOneDNNHandlerT
       const dnnl::memory::desc& user_md,
       const dnnl::memory::desc& target_md,
       void* ptr,
-      const std::string& key,
+      const OneDNNCacheKey& key,
       const std::string& suffix,
       bool is_persistent = false,
       const std::vector<float>& scale_data = {1.0f},
       int mask = 0) {
-    const auto target_key = key + suffix + "_target";
-    const auto key_reorder_p = key + suffix + "reorder_p";
-    const auto user_key = key + suffix + "_user";
+    const auto suffix_key = key.Derive(suffix.c_str());
+    const auto target_key = suffix_key.Derive("_target");
+    const auto key_reorder_p = suffix_key.Derive("reorder_p");
+    const auto user_key = suffix_key.Derive("_user");
 
     auto target_memory_p =
         std::static_pointer_cast<dnnl::memory>(dev_ctx.GetBlob(target_key));
@@ -317,7 +318,7 @@ class ConvTransposeOneDNNHandlerT
 
   std::shared_ptr<dnnl::memory> AcquireBiasMemoryWithReorder(
       const OneDNNContext& dev_ctx,
-      const std::string& key,
+      const OneDNNCacheKey& key,
       const phi::DenseTensor* bias) {
     const K* bias_data = bias->data<K>();
     auto user_bias_md = funcs::OneDNNMemDesc(common::vectorize(bias->dims()),
@@ -370,11 +371,13 @@ void Execute(const OneDNNContext& dev_ctx,
   std::shared_ptr<dnnl::memory> dst_memory_p;
   std::unordered_map<int, dnnl::memory> args;
 
-  std::string cache_key = funcs::CreateKey(dev_ctx,
-                                           dev_ctx.GetInputsName("Input")[0],
-                                           dev_ctx.GetInputsName("Filter")[0],
-                                           common::vectorize(x->dims()),
-                                           common::vectorize(filter->dims()));
+  const auto cache_key =
+      funcs::CreateHashedKey(dev_ctx,
+                             "conv2d_transpose",
+                             dev_ctx.GetInputsName("Input")[0],
+                             dev_ctx.GetInputsName("Filter")[0],
+                             common::vectorize(x->dims()),
+                             common::vectorize(filter->dims()));
   const auto& onednn_engine = dev_ctx.GetEngine();
 
   auto deconvolution_cache =
@@ -423,11 +426,12 @@ void Execute(const OneDNNContext& dev_ctx,
                                           bias->dims().size()));
     }
     // Caching Key for weights is needed
-    std::string key =
-        funcs::CreateKey(dev_ctx,
-                         dev_ctx.GetInputsName("Input")[0],
-                         dev_ctx.GetInputsName("Filter")[0],
-                         (bias ? dev_ctx.GetInputsName("Bias")[0] : ""));
+    auto key =
+        funcs::CreateHashedKey(dev_ctx,
+                               "conv2d_transpose",
+                               dev_ctx.GetInputsName("Input")[0],
+                               dev_ctx.GetInputsName("Filter")[0],
+                               (bias ? dev_ctx.GetInputsName("Bias")[0] : ""));
 
     ConvTransposeOneDNNHandlerT<T, float, T_out> handler(dev_ctx,
                                                          x,
@@ -449,12 +449,14 @@ std::shared_ptr<MulPrimitiveFactory<XT, YT, OT>> GetPrimitiveFactory(
     const DenseTensor *input_x,
     const DenseTensor *input_y,
     const engine &onednn_engine) {
-  std::string key = funcs::CreateKey(dev_ctx,
-                                     phi::TransToProtoVarType(input_x->dtype()),
-                                     common::vectorize(input_x->dims()),
-                                     phi::TransToProtoVarType(input_y->dtype()),
-                                     common::vectorize(input_y->dims()),
-                                     dev_ctx.GetOutputsName("Out")[0]);
+  auto key =
+      funcs::CreateHashedKey(dev_ctx,
+                             "matmul(mul)",
+                             phi::TransToProtoVarType(input_x->dtype()),
+                             common::vectorize(input_x->dims()),
+                             phi::TransToProtoVarType(input_y->dtype()),
+                             common::vectorize(input_y->dims()),
+                             dev_ctx.GetOutputsName("Out")[0]);
   key = funcs::ExtendKeyWithThreadInfoIfNeeded(dev_ctx, key);
 
   auto prim_creator = std::static_pointer_cast<MulPrimitiveFactory<XT, YT, OT>>(
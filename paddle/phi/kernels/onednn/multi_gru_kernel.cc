@@ -41,6 +41,23 @@ constexpr Direction R2L = Direction::unidirectional_right2left;
 constexpr const char* dir2str(Direction dir) {
   return dir == L2R ? "LR" : "RL";
 }
+
+// Key of an object of one layer, e.g. the weights of one direction of it. It
+// belongs to the group of `key`.
+OneDNNCacheKey LayerKey(const OneDNNCacheKey& key,
+                        const char* suffix,
+                        const char* dir,
+                        int layer) {
+  OneDNNKeyHasher hasher(key.tag);
+  hasher.Add(key.hi);
+  hasher.Add(key.lo);
+  hasher.Add(suffix);
+  hasher.Add(dir);
+  hasher.Add(static_cast<uint64_t>(layer));
+  OneDNNCacheKey layer_key = hasher.Key();
+  layer_key.group = key.Group();
+  return layer_key;
+}
 }  // namespace
 
 template <typename T, typename T_out = T>
@@ -122,9 +139,12 @@ class MultiGRUHandler {
     // do not depend on Ti size but primitive and input/output memory do
     memory_key_ = phi::funcs::ExtendKeyWithThreadInfoIfNeeded(
         dev_ctx,
-        phi::funcs::CreateKey(dev_ctx, unique_name, OneDNNGetDataType<T>()));
-    key_ = memory_key_;
-    key_.append("T").append(std::to_string(Ti_));
+        phi::funcs::CreateHashedKey(
+            dev_ctx, "multi_gru", unique_name, OneDNNGetDataType<T>()));
+    key_ = phi::funcs::ExtendKeyWithThreadInfoIfNeeded(
+        dev_ctx,
+        phi::funcs::CreateHashedKey(
+            dev_ctx, "multi_gru", unique_name, OneDNNGetDataType<T>(), Ti_));
 
     // Is it int8 kernel
     const bool is_int8 = std::is_same<T, uint8_t>::value;
@@ -170,8 +190,7 @@ class MultiGRUHandler {
   }
 
   void AcquireGruPrimitiveDescriptor(int layer, Direction dir) {
-    auto pd_key = key_;
-    pd_key.append("@gru_pd").append(dir2str(dir)).append(std::to_string(layer));
+    const auto pd_key = LayerKey(key_, "@gru_pd", dir2str(dir), layer);
     auto pd = std::static_pointer_cast<dnnl::gru_forward::primitive_desc>(
         dev_ctx_.GetBlob(pd_key));
     if (pd == nullptr) {
@@ -223,8 +242,7 @@ class MultiGRUHandler {
   }
 
   void AcquireConcatPrimitiveDescriptor(int layer) {
-    auto pd_key = key_;
-    pd_key.append("@c_pd").append(std::to_string(layer));
+    const auto pd_key = LayerKey(key_, "@c_pd", "", layer);
     auto pd = std::static_pointer_cast<dnnl::concat::primitive_desc>(
         dev_ctx_.GetBlob(pd_key));
     if (pd == nullptr) {
@@ -244,8 +262,7 @@ class MultiGRUHandler {
   }
 
   std::shared_ptr<dnnl::memory> AcquireInputMemoryWithReorder() {
-    auto key = key_;
-    key.append("@x_m");
+    const auto key = key_.Derive("@x_m");
     auto memory_p =
         std::static_pointer_cast<dnnl::memory>(dev_ctx_.GetBlob(key));
 
@@ -333,8 +350,7 @@ class MultiGRUHandler {
 
   // H0 is for now persistable
   std::shared_ptr<dnnl::memory> AcquireH0Memory(int layer, Direction dir) {
-    auto key = memory_key_;
-    key.append("@h0").append(dir2str(dir)).append(std::to_string(layer));
+    const auto key = LayerKey(memory_key_, "@h0", dir2str(dir), layer);
     auto memory_p =
         std::static_pointer_cast<dnnl::memory>(dev_ctx_.GetBlob(key));
     if (!memory_p) {
@@ -358,8 +374,7 @@ class MultiGRUHandler {
   }
 
   std::shared_ptr<dnnl::memory> AcquireWeightXMemory(int layer, Direction dir) {
-    auto key = memory_key_;
-    key.append("@wx").append(dir2str(dir)).append(std::to_string(layer));
+    const auto key = LayerKey(memory_key_, "@wx", dir2str(dir), layer);
     auto memory_p =
         std::static_pointer_cast<dnnl::memory>(dev_ctx_.GetBlob(key));
 
@@ -398,8 +413,7 @@ class MultiGRUHandler {
   }
 
   std::shared_ptr<dnnl::memory> AcquireWeightHMemory(int layer, Direction dir) {
-    auto key = memory_key_;
-    key.append("@wh").append(dir2str(dir)).append(std::to_string(layer));
+    const auto key = LayerKey(memory_key_, "@wh", dir2str(dir), layer);
     auto memory_p =
         std::static_pointer_cast<dnnl::memory>(dev_ctx_.GetBlob(key));
 
@@ -455,8 +469,7 @@ class MultiGRUHandler {
   }
 
   std::shared_ptr<dnnl::memory> AcquireBiasMemory(int layer, Direction dir) {
-    auto key = memory_key_;
-    key.append("@b").append(dir2str(dir)).append(std::to_string(layer));
+    const auto key = LayerKey(memory_key_, "@b", dir2str(dir), layer);
     auto memory_p =
         std::static_pointer_cast<dnnl::memory>(dev_ctx_.GetBlob(key));
 
@@ -488,8 +501,7 @@ class MultiGRUHandler {
 
   std::shared_ptr<dnnl::memory> AcquireGruOutputMemory(int layer,
                                                        Direction dir) {
-    auto key = key_;
-    key.append("@h_m").append(dir2str(dir)).append(std::to_string(layer));
+    const auto key = LayerKey(key_, "@h_m", dir2str(dir), layer);
     auto memory_p =
         std::static_pointer_cast<dnnl::memory>(dev_ctx_.GetBlob(key));
 
@@ -503,8 +515,7 @@ class MultiGRUHandler {
 
   std::shared_ptr<dnnl::gru_forward> AcquireGruPrimitive(int layer,
                                                          Direction dir) {
-    auto key = key_;
-    key.append("@gru_p").append(dir2str(dir)).append(std::to_string(layer));
+    const auto key = LayerKey(key_, "@gru_p", dir2str(dir), layer);
     auto prim =
         std::static_pointer_cast<dnnl::gru_forward>(dev_ctx_.GetBlob(key));
     if (prim == nullptr) {
@@ -560,8 +571,7 @@ class MultiGRUHandler {
 
   std::shared_ptr<std::vector<dnnl::memory>> AcquireConcatInputMemories(
       int layer) {
-    auto key = key_;
-    key.append("@ci_m").append(std::to_string(layer));
+    const auto key = LayerKey(key_, "@ci_m", "", layer);
     auto memory_p = std::static_pointer_cast<std::vector<dnnl::memory>>(
         dev_ctx_.GetBlob(key));
 
@@ -576,8 +586,7 @@ class MultiGRUHandler {
   }
 
   std::shared_ptr<dnnl::memory> AcquireConcatOutputMemory(int layer) {
-    auto key = key_;
-    key.append("@co_m").append(std::to_string(layer));
+    const auto key = LayerKey(key_, "@co_m", "", layer);
     auto memory_p =
         std::static_pointer_cast<dnnl::memory>(dev_ctx_.GetBlob(key));
 
@@ -590,8 +599,7 @@ class MultiGRUHandler {
   }
 
   std::shared_ptr<dnnl::concat> AcquireConcatPrimitive(int layer) {
-    auto key = key_;
-    key.append("@c_p").append(std::to_string(layer));
+    const auto key = LayerKey(key_, "@c_p", "", layer);
     auto prim = std::static_pointer_cast<dnnl::concat>(dev_ctx_.GetBlob(key));
     if (prim == nullptr) {
       prim = std::make_shared<dnnl::concat>(*concat_pds_[layer]);
@@ -670,10 +678,10 @@ class MultiGRUHandler {
       gru_pds_;
   std::vector<std::shared_ptr<dnnl::concat::primitive_desc>> concat_pds_;
 
-  std::string key_;
+  OneDNNCacheKey key_;
   // Memory size of weights, bias and h0 does not depend
   // on Ti size, thus we need another key to cache them
-  std::string memory_key_;
+  OneDNNCacheKey memory_key_;
 
   const phi::DenseTensor* x_;
   const std::vector<const phi::DenseTensor*> weights_x_;
@@ -176,14 +176,7 @@ void AdamDenseParamSparseGradKernel(
   }
   if (lazy_mode) {
     VLOG(3) << "run cpu lazy mode";
-    size_t row_count = grad_merge.rows().size();
-    std::vector<int64_t> cpu_rows(grad_merge.rows());
-    for (size_t row_index = 0; row_index < row_count; ++row_index) {
-      for (size_t offset = 0; offset < row_numel; ++offset) {
-        size_t i = cpu_rows[row_index] * row_numel + offset;
-        functor.adam_update(i, grad_data[row_index * row_numel + offset]);
-      }
-    }
+    functor.lazy_update();
   }
 #ifndef _WIN32
   else if (FLAGS_inner_op_parallelism > 1 &&  // NOLINT
@@ -15,7 +15,9 @@
 #pragma once
 
 #include <cstdint>
+#include <functional>
 #include <memory>
+#include <string>
 #include <vector>
 
 #include "paddle/pir/include/pass/pass.h"
@@ -30,6 +32,7 @@ class PassInstrumentor;
 
 namespace detail {
 class PassAdaptor;
+class NestedPassAdaptor;
 }
 
 class IR_API PassManager {
@@ -52,6 +55,18 @@ class IR_API PassManager {
     passes_.emplace_back(std::move(pass));
   }
 
+  // Adds a pass running the passes added by `build_pipeline` to a nested
+  // pass manager on the outermost ops named `op_name`, e.g. the
+  // "cinn_op.group" or "pd_op.while" ops. The ops not sharing any value
+  // defined outside of them are independent and are processed in parallel,
+  // by up to `num_threads` threads, or the hardware concurrency if 0.
+  // `build_pipeline` is called once per thread, so that each thread has its
+  // own passes. The nested passes must only change the regions of the op
+  // they run on.
+  void AddNestedPipeline(const std::string &op_name,
+                         std::function<void(PassManager *)> build_pipeline,
+                         int num_threads = 0);
+
   class IRPrinterOption {
    public:
     using PrintCallBack = std::function<void()>;
@@ -143,6 +158,8 @@ class IR_API PassManager {
 
   // For access member of pass_adaptor_.
   friend class detail::PassAdaptor;
+  // For running the nested pipelines on an op.
+  friend class detail::NestedPassAdaptor;
 };
 
 }  // namespace pir
@@ -186,6 +186,12 @@ class IR_API RewritePattern : public Pattern {
 
   virtual void Initialize() {}
 
+  // A match rooted at an op only depends on the ops at most that many edges
+  // away from it, an edge linking the producer and the users of a value and
+  // the users of a value together. A driver only needs to revisit the ops
+  // within that distance of a change. -1 if unknown.
+  virtual int64_t MatchRadius() const { return -1; }
+
   template <typename T, typename... Args>
   static std::unique_ptr<T> Create(Args&&... args) {
     std::unique_ptr<T> pattern =
@@ -59,6 +59,11 @@ class IR_API GreedyRewriteConfig {
   /// - ExistingOps: only pre-existing ops are added to the worklist.
   GreedyRewriteStrictness strict_mode = GreedyRewriteStrictness::AnyOp;
 
+  /// After the first iteration, only rescan the ops near the ops changed by
+  /// the previous iteration, instead of the whole region. Only takes effect
+  /// if every pattern reports its `MatchRadius`, e.g. the DRR patterns.
+  bool incremental_rescan = true;
+
   // Hook function for replacing the value.
   VALUE_REPLACED_HOOK_FUNC value_replaced_hook = nullptr;
 
@@ -13,6 +13,13 @@
 // limitations under the License.
 
 #include <glog/logging.h>
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <numeric>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
 
 #include "paddle/pir/include/core/ir_context.h"
 #include "paddle/pir/include/core/operation.h"
@@ -181,6 +188,169 @@ bool detail::PassAdaptor::RunPass(Pass* pass,
   return !pass_failed;
 }
 
+//----------------------------------------------------------------------------------------------//
+// NestedPassAdaptor
+//----------------------------------------------------------------------------------------------//
+namespace {
+template <typename FuncT>
+void ForEachNestedBlock(Operation* op, const FuncT& func) {
+  for (size_t i = 0; i < op->num_regions(); ++i) {
+    for (auto& block : op->region(i)) {
+      func(&block);
+      for (auto& child : block) {
+        ForEachNestedBlock(&child, func);
+      }
+    }
+  }
+}
+}  // namespace
+
+detail::NestedPassAdaptor::NestedPassAdaptor(
+    IrContext* context,
+    const std::string& op_name,
+    std::function<void(PassManager*)> build_pipeline,
+    int num_threads,
+    uint8_t opt_level)
+    : Pass("nested_pipeline(" + op_name + ")", 0),
+      context_(context),
+      op_name_(op_name),
+      build_pipeline_(std::move(build_pipeline)),
+      num_threads_(num_threads > 0
+                       ? num_threads
+                       : std::max(1u, std::thread::hardware_concurrency())),
+      opt_level_(opt_level) {}
+
+detail::NestedPassAdaptor::~NestedPassAdaptor() = default;
+
+bool detail::NestedPassAdaptor::CanApplyOn(Operation* op) const {
+  if (op->num_regions() == 0) return false;
+  // The pass adaptor visits every op with regions, each one runs the nested
+  // pipeline on its direct children named op_name_. The ops nested in such
+  // an op have already been processed by the nested pipeline.
+  for (; op != nullptr; op = op->GetParentOp()) {
+    if (op->name() == op_name_) return false;
+  }
+  return true;
+}
+
+PassManager* detail::NestedPassAdaptor::GetPipeline(size_t index) {
+  while (pipelines_.size() <= index) {
+    auto pm = std::make_unique<PassManager>(context_, opt_level_);
+    build_pipeline_(pm.get());
+    PADDLE_ENFORCE_EQ(
+        pm->Initialize(context_),
+        true,
+        common::errors::PreconditionNotMet(
+            "Failed to initialize the nested pipeline of %s.", name()));
+    pipelines_.push_back(std::move(pm));
+  }
+  return pipelines_[index].get();
+}
+
+void detail::NestedPassAdaptor::Run(Operation* op) {
+  // The targets nested deeper, e.g. in the body of a while op, are left to
+  // the run on their parent op, so that each one is processed once.
+  std::vector<Operation*> targets;
+  for (size_t i = 0; i < op->num_regions(); ++i) {
+    for (auto& block : op->region(i)) {
+      for (auto& child : block) {
+        if (child.name() == op_name_) targets.push_back(&child);
+      }
+    }
+  }
+  if (targets.empty()) return;
+
+  // The passes on a target update the use lists of the values it uses, so
+  // the targets using a same value defined outside of them are grouped and
+  // processed by one thread.
+  std::vector<size_t> group_of(targets.size());
+  std::iota(group_of.begin(), group_of.end(), 0);
+  auto find = [&](size_t i) {
+    while (group_of[i] != i) i = group_of[i] = group_of[group_of[i]];
+    return i;
+  };
+  std::vector<size_t> num_ops(targets.size(), 0);
+  std::unordered_map<Value, size_t> first_user;
+  for (size_t i = 0; i < targets.size(); ++i) {
+    std::unordered_set<Value> defined;
+    ForEachNestedBlock(targets[i], [&](Block* block) {
+      for (auto arg : block->args()) defined.insert(arg);
+      for (auto& [_, kwarg] : block->kwargs()) defined.insert(kwarg);
+      for (auto& child : *block) {
+        for (auto result : child.results()) defined.insert(result);
+      }
+    });
+    ForEachNestedBlock(targets[i], [&](Block* block) {
+      for (auto& child : *block) {
+        ++num_ops[i];
+        for (auto operand : child.operands_source()) {
+          if (!operand || defined.count(operand)) continue;
+          auto [it, inserted] = first_user.emplace(operand, i);
+          if (!inserted) group_of[find(i)] = find(it->second);
+        }
+      }
+    });
+  }
+  std::unordered_map<size_t, size_t> group_index;
+  std::vector<std::vector<Operation*>> groups;
+  std::vector<size_t> group_ops;
+  for (size_t i = 0; i < targets.size(); ++i) {
+    auto [it, inserted] = group_index.emplace(find(i), groups.size());
+    if (inserted) {
+      groups.emplace_back();
+      group_ops.push_back(0);
+    }
+    groups[it->second].push_back(targets[i]);
+    group_ops[it->second] += num_ops[i];
+  }
+  // The largest groups first, for the threads to end at about the same
+  // time.
+  std::vector<size_t> order(groups.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+    return group_ops[a] > group_ops[b];
+  });
+
+  size_t num_workers = std::min(num_threads_, groups.size());
+  VLOG(4) << name() << ": " << targets.size() << " ops in " << groups.size()
+          << " independent groups, run by " << num_workers << " threads";
+  for (size_t i = 0; i < num_workers; ++i) {
+    GetPipeline(i);
+  }
+  std::atomic<size_t> next_group{0};
+  std::atomic<bool> failed{false};
+  std::vector<std::exception_ptr> errors(num_workers);
+  auto work = [&](size_t worker) {
+    try {
+      PassManager* pm = pipelines_[worker].get();
+      for (size_t i = next_group++; i < groups.size() && !failed;
+           i = next_group++) {
+        for (Operation* target : groups[order[i]]) {
+          if (!pm->Run(target)) {
+            failed = true;
+            break;
+          }
+        }
+      }
+    } catch (...) {
+      errors[worker] = std::current_exception();
+      failed = true;
+    }
+  };
+  std::vector<std::thread> threads;
+  for (size_t i = 1; i < num_workers; ++i) {
+    threads.emplace_back(work, i);
+  }
+  work(0);
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  for (auto& error : errors) {
+    if (error) std::rethrow_exception(error);
+  }
+  if (failed) SignalPassFailure();
+}
+
 //----------------------------------------------------------------------------------------------//
 // PassManager
 //----------------------------------------------------------------------------------------------//
@@ -215,6 +385,14 @@ bool PassManager::Initialize(IrContext* context) {
   return true;
 }
 
+void PassManager::AddNestedPipeline(
+    const std::string& op_name,
+    std::function<void(PassManager*)> build_pipeline,
+    int num_threads) {
+  AddPass(std::make_unique<detail::NestedPassAdaptor>(
+      context_, op_name, std::move(build_pipeline), num_threads, opt_level_));
+}
+
 void PassManager::AddInstrumentation(std::unique_ptr<PassInstrumentation> pi) {
   if (!instrumentor_) instrumentor_ = std::make_unique<PassInstrumentor>();
 
@@ -14,10 +14,16 @@
 
 #pragma once
 
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
 #include "paddle/pir/include/pass/pass.h"
 
 namespace pir {
 
+class IrContext;
 class Operation;
 class PassManager;
 
@@ -52,6 +58,35 @@ class PassAdaptor final : public Pass {
   // For accessing RunPipeline.
   friend class pir::PassManager;
 };
+
+// Used to run a nested pipeline over the outermost ops named `op_name`
+// nested in the op it runs on, see PassManager::AddNestedPipeline.
+class NestedPassAdaptor final : public Pass {
+ public:
+  NestedPassAdaptor(IrContext* context,
+                    const std::string& op_name,
+                    std::function<void(PassManager*)> build_pipeline,
+                    int num_threads,
+                    uint8_t opt_level);
+
+  ~NestedPassAdaptor() override;
+
+  bool CanApplyOn(Operation* op) const override;
+
+  void Run(Operation* op) override;
+
+ private:
+  PassManager* GetPipeline(size_t index);
+
+ private:
+  IrContext* context_;
+  std::string op_name_;
+  std::function<void(PassManager*)> build_pipeline_;
+  size_t num_threads_;
+  uint8_t opt_level_;
+  // One pipeline per thread, as the passes keep the state of their run.
+  std::vector<std::unique_ptr<PassManager>> pipelines_;
+};
 }  // namespace detail
 
 }  // namespace pir
@@ -72,10 +72,12 @@ bool PatternApplicator::MatchAndRewrite(
     std::function<bool(const Pattern&)> can_apply,
     std::function<void(const Pattern&)> on_failure,
     std::function<bool(const Pattern&)> on_success) {
-  // whether there are patterns matching this operation type.
-  std::vector<const RewritePattern*> op_patterns;
+  // whether there are patterns matching this operation type, not copied as
+  // this runs for every op visited by the driver.
+  static const std::vector<const RewritePattern*> kNoPatterns;
   auto pattern_it = patterns_.find(op->info());
-  if (pattern_it != patterns_.end()) op_patterns = pattern_it->second;
+  const auto& op_patterns =
+      pattern_it != patterns_.end() ? pattern_it->second : kNoPatterns;
 
   unsigned op_it = 0, op_e = op_patterns.size();
   unsigned any_it = 0, any_e = any_op_patterns_.size();
@@ -22,6 +22,7 @@
 #include <numeric>
 #include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 #include "paddle/pir/include/core/block.h"
 #include "paddle/pir/include/core/ir_context.h"
@@ -56,6 +57,16 @@ class GreedyPatternRewriteDriver : public pir::PatternRewriter {
     if (config.value_replaced_hook) {
       value_replaced_hook_fn_ = config.value_replaced_hook;
     }
+    if (config.incremental_rescan) {
+      rescan_radius_ = 0;
+      matcher_.WalkAllPatterns([this](const pir::Pattern& pattern) {
+        int64_t radius =
+            static_cast<const pir::RewritePattern&>(pattern).MatchRadius();
+        rescan_radius_ = radius < 0 || rescan_radius_ < 0
+                             ? -1
+                             : std::max(rescan_radius_, radius);
+      });
+    }
   }
 
   std::pair<bool, int64_t> Simplify() {
@@ -71,11 +82,25 @@ class GreedyPatternRewriteDriver : public pir::PatternRewriter {
       worklist_.clear();
       worklist_map_.clear();
 
-      for (auto& block_item : region_) {
-        for (auto& op_item : block_item) {
-          worklist_.push_back(&op_item);
+      if (iteration == 1 || rescan_radius_ < 0) {
+        for (auto& block_item : region_) {
+          for (auto& op_item : block_item) {
+            worklist_.push_back(&op_item);
+          }
+        }
+      } else {
+        // Only the ops near a change may match differently from the
+        // previous iteration, in which they did not match.
+        auto dirty_ops = CollectDirtyOps();
+        for (auto& block_item : region_) {
+          for (auto& op_item : block_item) {
+            if (dirty_ops.count(&op_item)) worklist_.push_back(&op_item);
+          }
         }
+        VLOG(6) << "Rescan " << worklist_.size() << " ops near the "
+                << touched_ops_.size() << " changed ops";
       }
+      touched_ops_.clear();
       if (config_.use_top_down_traversal) {
         // Reverse the list so out pop-back loop process them in-order.
         std::reverse(worklist_.begin(), worklist_.end());
@@ -124,28 +149,42 @@ class GreedyPatternRewriteDriver : public pir::PatternRewriter {
       auto result = op->result(i);
       for (auto it = result.use_begin(); it != result.use_end(); ++it) {
         AddToWorklist(it->owner());
+        Touch(it->owner());
       }
     }
   }
 
-  void FinalizeRootUpdate(pir::Operation* op) override { AddToWorklist(op); }
+  void FinalizeRootUpdate(pir::Operation* op) override {
+    AddToWorklist(op);
+    Touch(op);
+  }
 
   void NotifyOperationRemoved(pir::Operation* op) override {
     for (uint32_t i = 0; i < op->num_operands(); ++i) {
-      AddOperandToWorklist(op->operand_source(i));
+      auto operand = op->operand_source(i);
+      AddOperandToWorklist(operand);
+      if (!operand) continue;
+      // The use count of the operand changes for its producer and users.
+      Touch(operand.defining_op());
+      for (auto it = operand.use_begin(); it != operand.use_end(); ++it) {
+        if (it->owner() != op) Touch(it->owner());
+      }
     }
 
     if (op->num_regions() == 0) {
       RemoveFromWorklist(op);
+      touched_ops_.erase(op);
     } else {
       for (uint32_t i = 0; i < op->num_regions(); ++i) {
         auto& region = op->region(i);
         for (auto& block : region) {
           for (auto& op_item : block) {
             RemoveFromWorklist(&op_item);
+            touched_ops_.erase(&op_item);
           }
         }
       }
+      touched_ops_.erase(op);
     }
 
     if (config_.strict_mode != pir::GreedyRewriteStrictness::AnyOp) {
@@ -157,6 +196,7 @@ class GreedyPatternRewriteDriver : public pir::PatternRewriter {
     if (config_.strict_mode == pir::GreedyRewriteStrictness::ExistingAndNewOps)
       strict_mode_filtered_ops_.insert(op);
     AddToWorklist(op);
+    Touch(op);
   }
 
   void NotifyValueReplaced(pir::Value from, pir::Value to) override {
@@ -165,8 +205,21 @@ class GreedyPatternRewriteDriver : public pir::PatternRewriter {
     }
   }
 
-  /// Add the given operation to the worklist.
+  /// Whether the op is in the region, or nested in an op of the region.
+  bool IsInRegion(pir::Operation* op) const {
+    while (op != nullptr && op->GetParent() != nullptr) {
+      pir::Region* region = op->GetParent()->GetParent();
+      if (region == &region_) return true;
+      op = region != nullptr ? region->GetParent() : nullptr;
+    }
+    return false;
+  }
+
+  /// Add the given operation to the worklist. The ops outside of the region
+  /// are left alone, they may be processed by another thread, see
+  /// PassManager::AddNestedPipeline.
   void AddToWorklist(pir::Operation* op) {
+    if (!IsInRegion(op)) return;
     if (config_.strict_mode == pir::GreedyRewriteStrictness::AnyOp ||
         strict_mode_filtered_ops_.count(op)) {
       if (worklist_map_.count(op)) return;
@@ -192,6 +245,52 @@ class GreedyPatternRewriteDriver : public pir::PatternRewriter {
     }
   }
 
+  /// Record an op changed by a rewrite, for the next incremental rescan.
+  void Touch(pir::Operation* op) {
+    if (op != nullptr && rescan_radius_ >= 0 && IsInRegion(op)) {
+      touched_ops_.insert(op);
+    }
+  }
+
+  /// The ops within `rescan_radius_ + 1` edges of a touched op, an edge
+  /// linking an op to the producers of its operands, to the other users of
+  /// its operands and to the users of its results. One more than the radius
+  /// as a change next to a matched op, e.g. a new user of one of its
+  /// results, also changes the match.
+  std::unordered_set<pir::Operation*> CollectDirtyOps() const {
+    std::unordered_set<pir::Operation*> dirty(touched_ops_.begin(),
+                                              touched_ops_.end());
+    std::vector<pir::Operation*> frontier(touched_ops_.begin(),
+                                          touched_ops_.end());
+    std::vector<pir::Operation*> next;
+    auto visit = [&](pir::Operation* op) {
+      if (op != nullptr && IsInRegion(op) && dirty.insert(op).second) {
+        next.push_back(op);
+      }
+    };
+    auto visit_users = [&](pir::Value value) {
+      for (auto it = value.use_begin(); it != value.use_end(); ++it) {
+        visit(it->owner());
+      }
+    };
+    for (int64_t d = 0; d <= rescan_radius_ && !frontier.empty(); ++d) {
+      next.clear();
+      for (auto* op : frontier) {
+        for (uint32_t i = 0; i < op->num_operands(); ++i) {
+          auto operand = op->operand_source(i);
+          if (!operand) continue;
+          visit(operand.defining_op());
+          visit_users(operand);
+        }
+        for (uint32_t i = 0; i < op->num_results(); ++i) {
+          visit_users(op->result(i));
+        }
+      }
+      frontier.swap(next);
+    }
+    return dirty;
+  }
+
   /// Pop the next operation from the worklist
   pir::Operation* PopFromWorklist() {
     auto* op = worklist_.back();
@@ -217,6 +316,10 @@ class GreedyPatternRewriteDriver : public pir::PatternRewriter {
   pir::Region& region_;
   pir::PatternApplicator matcher_;
   pir::VALUE_REPLACED_HOOK_FUNC value_replaced_hook_fn_ = nullptr;
+  // The largest match radius of the patterns, -1 to rescan the whole region
+  // at every iteration.
+  int64_t rescan_radius_ = -1;
+  std::unordered_set<pir::Operation*> touched_ops_;
 };
 
 }  // namespace
@@ -73,6 +73,8 @@ class SummaryView(Enum):
     - **SummaryView.MemoryManipulationView** : The memory manipulation summary view.
 
     - **SummaryView.UDFView** : The user defined summary view.
+
+    - **SummaryView.CounterView** : The CPU performance counter summary view of operators, only shown if FLAGS_enable_host_perf_counters is set while profiling.
     """
 
     DeviceView = 0
@@ -84,6 +86,7 @@ class SummaryView(Enum):
     MemoryView = 6
     MemoryManipulationView = 7
     UDFView = 8
+    CounterView = 9
 
 
 class ProfilerState(Enum):
@@ -45,6 +45,10 @@ _AllTracerEventType = [
 
 _CommunicationOpName = ['allreduce', 'broadcast', 'rpc']
 
+# Last level cache misses per thousand instructions above which an operator
+# is reported as memory bound in the counter summary.
+_MemoryBoundMPKI = 10
+
 
 class SortedKeys(Enum):
     r"""
@@ -521,6 +525,15 @@ class EventSummary:
             self.min_general_gpu_time = float('inf')
             self.max_general_gpu_time = 0
             self._flops = 0
+            # CPU performance counters, see add_perf_counters
+            self.counter_call = 0
+            self.counter_cpu_time = 0
+            self.hardware_counters = True
+            self.cycles = 0
+            self.instructions = 0
+            self.cache_references = 0
+            self.cache_misses = 0
+            self.task_clock_ns = 0
 
         @property
         def flops(self):
@@ -565,6 +578,42 @@ class EventSummary:
         def add_flops(self, flops):
             self._flops += flops
 
+        def add_perf_counters(self, node):
+            counters = getattr(node, 'perf_counters', None)
+            if counters is None or not counters.valid:
+                return
+            self.counter_call += 1
+            self.counter_cpu_time += node.end_ns - node.start_ns
+            self.hardware_counters = (
+                self.hardware_counters and counters.hardware
+            )
+            self.cycles += counters.cycles
+            self.instructions += counters.instructions
+            self.cache_references += counters.cache_references
+            self.cache_misses += counters.cache_misses
+            self.task_clock_ns += counters.task_clock_ns
+
+        @property
+        def bytes_moved(self):
+            # Every last level cache miss moves one 64 bytes cache line.
+            return self.cache_misses * 64
+
+        @property
+        def ipc(self):
+            return self.instructions / self.cycles if self.cycles else 0
+
+        @property
+        def mpki(self):
+            if self.instructions == 0:
+                return 0
+            return self.cache_misses * 1000 / self.instructions
+
+        @property
+        def bound(self):
+            if not self.hardware_counters or self.instructions == 0:
+                return '-'
+            return 'Memory' if self.mpki >= _MemoryBoundMPKI else 'Compute'
+
         def add_item(self, node):
             raise NotImplementedError
 
@@ -580,6 +629,7 @@ class EventSummary:
             self.add_gpu_time(node.gpu_time)
             self.add_general_gpu_time(node.general_gpu_time)
             self.add_flops(node.flops)
+            self.add_perf_counters(node)
             for child in node.children_node:
                 if child.type != TracerEventType.Operator:
                     if child.name not in self.operator_inners:
@@ -1692,6 +1742,116 @@ def _build_table(
             append('')
             append('')
 
+    if views is None or SummaryView.CounterView in views:
+        # ----- Print Operator Counter Summary Report ----- #
+        counter_items = [
+            (name, item)
+            for name, item in statistic_data.event_summary.items.items()
+            if item.counter_call > 0
+        ]
+        if counter_items:
+            counter_items.sort(key=lambda x: x[1].counter_cpu_time, reverse=True)
+            hardware = all(item.hardware_counters for _, item in counter_items)
+            all_row_values = []
+            for name, item in counter_items[:row_limit]:
+                cpu_util = (
+                    item.task_clock_ns / item.counter_cpu_time
+                    if item.counter_cpu_time
+                    else 0
+                )
+                if item.hardware_counters:
+                    miss_ratio = (
+                        format_ratio(item.cache_misses / item.cache_references)
+                        if item.cache_references
+                        else '-'
+                    )
+                    # bytes per ns equals GB per second
+                    bandwidth = (
+                        item.bytes_moved / item.counter_cpu_time
+                        if item.counter_cpu_time
+                        else 0
+                    )
+                    intensity = (
+                        f'{item.flops / item.bytes_moved:.2f}'
+                        if item.flops > 0 and item.bytes_moved > 0
+                        else '-'
+                    )
+                    hardware_values = [
+                        _format_large_number(item.cycles),
+                        f'{item.ipc:.2f}',
+                        miss_ratio,
+                        f'{item.mpki:.2f}',
+                        _format_large_number(item.bytes_moved) + 'B',
+                        f'{bandwidth:.2f}',
+                        intensity,
+                    ]
+                else:
+                    hardware_values = ['-'] * 7
+                row_values = [
+                    name,
+                    item.counter_call,
+                    format_time(item.counter_cpu_time, unit=time_unit),
+                    format_ratio(cpu_util),
+                    *hardware_values,
+                    item.bound,
+                ]
+                all_row_values.append(row_values)
+
+            headers = [
+                'Name',
+                'Calls',
+                'CPU Total',
+                'CPU Util(%)',
+                'Cycles',
+                'IPC',
+                'LLC Miss(%)',
+                'MPKI',
+                'Bytes Moved',
+                'GB/s',
+                'FLOPs/Byte',
+                'Bound',
+            ]
+            row_format_list = [""]
+            header_sep_list = [""]
+            line_length_list = [-SPACING_SIZE]
+            name_column_width = 40
+            add_column(name_column_width)
+            add_column(6)
+            add_column(12)
+            add_column(11)
+            for _ in range(7):
+                add_column(11)
+            add_column(7)
+
+            row_format = row_format_list[0]
+            header_sep = header_sep_list[0]
+            line_length = line_length_list[0]
+
+            # construct table string
+            append(add_title(line_length, "Operator Counter Summary"))
+            append(f'Time unit: {time_unit}')
+            if not hardware:
+                append(
+                    'Hardware counters are not available, only software '
+                    'counters are shown.'
+                )
+            append(
+                'Bytes Moved is estimated by LLC misses * 64, an operator is '
+                f'memory bound if its MPKI >= {_MemoryBoundMPKI}.'
+            )
+            append(header_sep)
+            append(row_format.format(*headers))
+            append(header_sep)
+            for row_values in all_row_values:
+                if len(row_values[0]) > name_column_width:
+                    row_values[0] = (
+                        row_values[0][: name_column_width - 3] + '...'
+                    )
+                append(row_format.format(*row_values))
+            append(header_sep)
+            append('')
+            append('')
+
     if views is None or SummaryView.MemoryManipulationView in views:
         # ----- Print Memory Manipulation Summary Report ----- #
         if statistic_data.event_summary.memory_manipulation_items:
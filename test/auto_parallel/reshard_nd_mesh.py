@@ -160,6 +160,27 @@ class TestReshardNdMesh:
 
         assert np.equal(out.shape, input_tensor.shape).all()
 
+    def test_move_shard_between_dims(self, dev_ctx):
+        paddle.seed(self._seeds)
+        a = paddle.randn(self._shape).astype(self._dtype)
+
+        input_tensor = dist.shard_tensor(
+            a, self._mesh, [dist.Shard(0), dist.Replicate()]
+        )
+        out = dist.reshard(
+            input_tensor, self._mesh, [dist.Shard(1), dist.Replicate()]
+        )
+
+        out_expected_local_tensor_list = paddle.split(
+            a, num_or_sections=self._mesh.shape[0], axis=1
+        )
+        index = dist.get_rank() // self._mesh.shape[1]
+        np.testing.assert_equal(
+            out._local_value().numpy(),
+            out_expected_local_tensor_list[index].numpy(),
+        )
+        assert np.equal(out.shape, input_tensor.shape).all()
+
     def test_partial_replicate_to_shard_replicated(self, dev_ctx):
         paddle.seed(self._seeds)
         a = paddle.randn(self._shape).astype(self._dtype)
@@ -193,6 +214,7 @@ class TestReshardNdMesh:
 
         self.test_partial_to_partial(dev_ctx)
         self.test_shard_to_shard(dev_ctx)
+        self.test_move_shard_between_dims(dev_ctx)
         self.test_shard_partial_to_shard_replicated(dev_ctx)
         self.test_shard_partial_to_replicated(dev_ctx)
 
@@ -0,0 +1,98 @@
+# Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import os
+import time
+
+import numpy as np
+
+import paddle
+import paddle.distributed as dist
+
+
+class TestReshardPToRBatch:
+    def __init__(self):
+        self._shape = eval(os.getenv("shape"))
+        self._dtype = os.getenv("dtype")
+        self._seeds = eval(os.getenv("seeds"))
+        self._backend = os.getenv("backend")
+        self._mesh = dist.ProcessMesh([0, 1], dim_names=["x"])
+
+    def test_add_n_with_partial_inputs(self):
+        paddle.seed(self._seeds)
+        values = [
+            paddle.randn(self._shape).astype(self._dtype) for _ in range(4)
+        ]
+        # The replicated input makes add_n reshard every partial input to
+        # replicated, and the partial ones share a single all_reduce.
+        inputs = [
+            dist.shard_tensor(v, self._mesh, [dist.Partial()])
+            for v in values[:-1]
+        ]
+        inputs.append(
+            dist.shard_tensor(values[-1], self._mesh, [dist.Replicate()])
+        )
+        out = paddle.add_n(inputs)
+
+        expected = paddle.add_n(values)
+        np.testing.assert_allclose(
+            out._local_value().numpy(), expected.numpy(), rtol=1e-5
+        )
+
+    def test_add_n_with_mixed_reduce_types(self):
+        paddle.seed(self._seeds)
+        values = [
+            paddle.randn(self._shape).astype(self._dtype) for _ in range(3)
+        ]
+        inputs = [
+            dist.shard_tensor(values[0], self._mesh, [dist.Partial()]),
+            dist.shard_tensor(
+                values[1],
+                self._mesh,
+                [dist.Partial(dist.ReduceType.kRedAvg)],
+            ),
+            dist.shard_tensor(values[2], self._mesh, [dist.Replicate()]),
+        ]
+        out = paddle.add_n(inputs)
+
+        expected = paddle.add_n(values)
+        np.testing.assert_allclose(
+            out._local_value().numpy(), expected.numpy(), rtol=1e-5
+        )
+
+    def test_repeated_reshard(self):
+        a = paddle.ones(self._shape)
+        input_tensor = dist.shard_tensor(a, self._mesh, [dist.Partial()])
+
+        # The reshard plan is cached after the first call.
+        start = time.time()
+        for _ in range(100):
+            out = dist.reshard(input_tensor, self._mesh, [dist.Replicate()])
+        cost = time.time() - start
+        print(f"100 partial to replicated reshards cost {cost:.4f}s")
+        np.testing.assert_equal(out._local_value().numpy(), a.numpy())
+
+    def run_test_case(self):
+        if self._backend == "cpu":
+            paddle.set_device("cpu")
+        elif self._backend == "gpu":
+            paddle.set_device(f"gpu:{dist.get_rank()}")
+
+        self.test_add_n_with_partial_inputs()
+        self.test_add_n_with_mixed_reduce_types()
+        self.test_repeated_reshard()
+
+
+if __name__ == '__main__':
+    TestReshardPToRBatch().run_test_case()
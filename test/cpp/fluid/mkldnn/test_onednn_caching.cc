@@ -49,6 +49,10 @@ class CacheTester {
     return onednn_dev_ctx_->GetCachedObjectsNumber() == num_entries;
   }
 
+  phi::OneDNNCacheStats Stats(const std::string &tag) {
+    return onednn_dev_ctx_->GetPrimitiveCacheStats()[tag];
+  }
+
  private:
   phi::OneDNNContext *onednn_dev_ctx_;
 };
@@ -138,6 +142,19 @@ TEST(test_conv2d_reuse_cache, cpu_place) {
                         "Invalid number of cached oneDNN objects"));
 }
 
+TEST(test_conv2d_reuse_cache, cache_hits) {
+  phi::DDim dims({1, 16, 32, 64});
+  phi::CPUPlace p;
+  CacheTester ct;
+  RunOperator<float>(p, "conv2d", dims, "input_signal");
+  auto first = ct.Stats("conv2d");
+  RunOperator<float>(p, "conv2d", dims, "input_signal");
+  auto second = ct.Stats("conv2d");
+  // The second run finds every object cached by the first one
+  EXPECT_GT(second.hits, first.hits);
+  EXPECT_EQ(second.misses, first.misses);
+}
+
 TEST(test_conv2d_noreuse_cache, cpu_place) {
   phi::DDim dims({1, 16, 32, 64});
   phi::CPUPlace p;
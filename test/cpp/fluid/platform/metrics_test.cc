@@ -0,0 +1,162 @@
+//   Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/phi/core/platform/metrics.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "paddle/phi/core/platform/metrics_exporter.h"
+
+namespace paddle {
+namespace platform {
+
+TEST(Metrics, counter) {
+  auto* counter = MetricsRegistry::GetInstance().GetCounter(
+      "test_counter_total", "A test counter.", {{"kind", "a"}});
+  EXPECT_EQ(counter,
+            MetricsRegistry::GetInstance().GetCounter(
+                "test_counter_total", "A test counter.", {{"kind", "a"}}));
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 8; ++i) {
+    threads.emplace_back([counter]() {
+      for (int j = 0; j < 10000; ++j) {
+        counter->Increment();
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(counter->Value(), 80000);
+
+  // A name can not be reused for another type.
+  EXPECT_ANY_THROW(MetricsRegistry::GetInstance().GetGauge(
+      "test_counter_total", "A test counter."));
+}
+
+TEST(Metrics, histogram) {
+  MetricHistogram histogram({1, 2, 4});
+  for (double v : {0.5, 1.0, 1.5, 3.0, 10.0}) {
+    histogram.Observe(v);
+  }
+  HistogramSnapshot snapshot = histogram.Snapshot();
+  ASSERT_EQ(snapshot.bucket_counts.size(), 4UL);
+  EXPECT_EQ(snapshot.bucket_counts[0], 2UL);
+  EXPECT_EQ(snapshot.bucket_counts[1], 3UL);
+  EXPECT_EQ(snapshot.bucket_counts[2], 4UL);
+  EXPECT_EQ(snapshot.bucket_counts[3], 5UL);
+  EXPECT_EQ(snapshot.count, 5UL);
+  EXPECT_DOUBLE_EQ(snapshot.sum, 16.0);
+  EXPECT_DOUBLE_EQ(snapshot.Quantile(0.4), 1.0);
+  EXPECT_DOUBLE_EQ(snapshot.Quantile(0.5), 1.5);
+  // Observations above the last bound are reported as the last bound.
+  EXPECT_DOUBLE_EQ(snapshot.Quantile(1.0), 4.0);
+}
+
+TEST(Metrics, prometheus_text) {
+  auto& registry = MetricsRegistry::GetInstance();
+  registry.GetGauge("test_queue_depth", "A test gauge.", {{"q", "a\"b"}})
+      ->Set(3);
+  registry
+      .GetHistogram(
+          "test_latency_seconds", "A test histogram.", {}, {0.1, 1})
+      ->Observe(0.5);
+  std::string text = ToPrometheusText(registry.Snapshot());
+  EXPECT_NE(text.find("# TYPE test_queue_depth gauge\n"), std::string::npos);
+  EXPECT_NE(text.find("test_queue_depth{q=\"a\\\"b\"} 3\n"),
+            std::string::npos);
+  EXPECT_NE(text.find("test_latency_seconds_bucket{le=\"0.10000000000000001\"}"
+                      " 0\n"),
+            std::string::npos);
+  EXPECT_NE(text.find("test_latency_seconds_bucket{le=\"+Inf\"} 1\n"),
+            std::string::npos);
+  EXPECT_NE(text.find("test_latency_seconds_count 1\n"), std::string::npos);
+  // Allocator statistics are always collected.
+  EXPECT_NE(text.find("paddle_memory_bytes{device=\"cpu\",stat=\"Allocated\"}"),
+            std::string::npos);
+}
+
+TEST(Metrics, file_sink) {
+  std::string path = "metrics_test.prom";
+  MetricsRegistry::GetInstance()
+      .GetCounter("test_file_sink_total", "A test counter.")
+      ->Increment(5);
+  FileMetricsSink sink(path);
+  sink.Export(MetricsRegistry::GetInstance().Snapshot());
+  std::ifstream ifs(path);
+  std::stringstream content;
+  content << ifs.rdbuf();
+  EXPECT_NE(content.str().find("test_file_sink_total 5\n"), std::string::npos);
+  std::remove(path.c_str());
+}
+
+TEST(Metrics, http_server) {
+  MetricsRegistry::GetInstance()
+      .GetCounter("test_http_total", "A test counter.")
+      ->Increment(7);
+  MetricsHttpServer server;
+  ASSERT_TRUE(server.Start("127.0.0.1", 0));
+  ASSERT_GT(server.Port(), 0);
+
+  auto get = [&server](const std::string& path) {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(server.Port());
+    inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+    EXPECT_EQ(connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)),
+              0);
+    std::string request = "GET " + path + " HTTP/1.1\r\nHost: x\r\n\r\n";
+    EXPECT_EQ(send(fd, request.data(), request.size(), 0),
+              static_cast<ssize_t>(request.size()));
+    std::string response;
+    char buffer[4096];
+    ssize_t n;
+    while ((n = recv(fd, buffer, sizeof(buffer), 0)) > 0) {
+      response.append(buffer, n);
+    }
+    close(fd);
+    return response;
+  };
+  std::string response = get("/metrics");
+  EXPECT_EQ(response.compare(0, 15, "HTTP/1.1 200 OK"), 0);
+  EXPECT_NE(response.find("test_http_total 7\n"), std::string::npos);
+  EXPECT_EQ(get("/other").compare(0, 12, "HTTP/1.1 404"), 0);
+  server.Stop();
+  EXPECT_EQ(server.Port(), 0);
+}
+
+TEST(Metrics, op_latency) {
+  FLAGS_enable_metrics = false;
+  EXPECT_EQ(OpLatencyHistogram("matmul"), nullptr);
+  FLAGS_enable_metrics = true;
+  {
+    ScopedLatencyTimer timer(OpLatencyHistogram("matmul"));
+  }
+  EXPECT_EQ(OpLatencyHistogram("matmul")->Snapshot().count, 1UL);
+  FLAGS_enable_metrics = false;
+}
+
+}  // namespace platform
+}  // namespace paddle
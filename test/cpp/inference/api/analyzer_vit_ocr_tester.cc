@@ -17,6 +17,8 @@ limitations under the License. */
 
 #include "test/cpp/inference/api/tester_helper.h"
 
+COMMON_DECLARE_bool(graph_pattern_detector_use_op_index);
+
 namespace paddle {
 namespace inference {
 namespace analysis {
@@ -91,6 +93,29 @@ void compare(bool use_mkldnn = false) {
 
 TEST(Analyzer_vit_ocr, compare) { compare(); }
 
+// Predictor creation time, which runs the ir passes of the old ir, with the
+// op type index of GraphPatternDetector off and on.
+TEST(DISABLED_Analyzer_vit_ocr, startup_op_index) {
+  AnalysisConfig cfg;
+  SetConfig(&cfg);
+  cfg.EnableNewIR(false);
+  cfg.SwitchIrOptim();
+  CreatePaddlePredictor<AnalysisConfig>(cfg);
+
+  const int repeat = 3;
+  for (bool use_op_index : {false, true}) {
+    FLAGS_graph_pattern_detector_use_op_index = use_op_index;
+    Timer timer;
+    timer.tic();
+    for (int i = 0; i < repeat; ++i) {
+      CreatePaddlePredictor<AnalysisConfig>(cfg);
+    }
+    LOG(INFO) << (use_op_index ? "op type index: " : "full scan: ")
+              << timer.toc() / repeat << "ms per predictor.";
+  }
+  FLAGS_graph_pattern_detector_use_op_index = true;
+}
+
 #ifdef PADDLE_WITH_DNNL
 TEST(Analyzer_vit_ocr, compare_mkldnn) { compare(true /* use_mkldnn */); }
 #endif
@@ -0,0 +1,183 @@
+/* Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include <glog/logging.h>
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstring>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <numeric>
+#include <thread>
+
+#include "paddle/common/flags.h"
+#include "test/cpp/inference/api/tester_helper.h"
+
+namespace paddle_infer {
+
+namespace {
+
+Config GetConfig() {
+  std::string model_dir = FLAGS_infer_model + "/model";
+  Config config;
+  config.EnableNewIR(false);
+  config.SetModel(model_dir + "/model", model_dir + "/params");
+  config.DisableGpu();
+  config.SetCpuMathLibraryNumThreads(1);
+  return config;
+}
+
+services::ServingTensor MakeImage(const std::string& name, int seed) {
+  services::ServingTensor input;
+  input.name = name;
+  input.shape = {1, 3, 224, 224};
+  input.dtype = DataType::FLOAT32;
+  std::vector<float> data(3 * 224 * 224);
+  for (size_t i = 0; i < data.size(); ++i) {
+    data[i] = static_cast<float>((i * 7 + seed * 13) % 255) / 255.f;
+  }
+  input.data.resize(data.size() * sizeof(float));
+  std::memcpy(input.data.data(), data.data(), input.data.size());
+  return input;
+}
+
+std::vector<float> RunDirectly(Predictor* predictor,
+                               const services::ServingTensor& input) {
+  auto input_t = predictor->GetInputHandle(input.name);
+  input_t->Reshape(input.shape);
+  input_t->CopyFromCpu(reinterpret_cast<const float*>(input.data.data()));
+  predictor->Run();
+  auto output_t = predictor->GetOutputHandle(predictor->GetOutputNames()[0]);
+  std::vector<int> shape = output_t->shape();
+  std::vector<float> output(std::accumulate(
+      shape.begin(), shape.end(), 1, std::multiplies<int>()));
+  output_t->CopyToCpu(output.data());
+  return output;
+}
+
+}  // namespace
+
+TEST(BatchingPredictorPool, same_outputs_as_predictor) {
+  Config config = GetConfig();
+  auto predictor = CreatePredictor(config);
+  std::string input_name = predictor->GetInputNames()[0];
+
+  services::BatchingOptions options;
+  options.num_workers = 2;
+  options.max_batch_size = 4;
+  options.max_queue_delay_us = 2000;
+  services::BatchingPredictorPool pool(config, options);
+
+  const int num_requests = 16;
+  std::vector<std::future<std::vector<services::ServingTensor>>> futures;
+  for (int i = 0; i < num_requests; ++i) {
+    futures.emplace_back(pool.Submit({MakeImage(input_name, i)}));
+  }
+
+  for (int i = 0; i < num_requests; ++i) {
+    auto outputs = futures[i].get();
+    ASSERT_EQ(outputs.size(), 1UL);
+    ASSERT_EQ(outputs[0].shape[0], 1);
+    auto expected = RunDirectly(predictor.get(), MakeImage(input_name, i));
+    ASSERT_EQ(outputs[0].data.size(), expected.size() * sizeof(float));
+    const float* actual =
+        reinterpret_cast<const float*>(outputs[0].data.data());
+    for (size_t j = 0; j < expected.size(); ++j) {
+      EXPECT_NEAR(actual[j], expected[j], 1e-4);
+    }
+  }
+
+  auto stats = pool.GetStats();
+  EXPECT_EQ(stats.num_requests, static_cast<uint64_t>(num_requests));
+  EXPECT_EQ(stats.num_rows, static_cast<uint64_t>(num_requests));
+  EXPECT_LE(stats.num_batches, stats.num_requests);
+  EXPECT_GT(stats.TotalLatencyPercentile(99), 0);
+}
+
+TEST(BatchingPredictorPool, invalid_request) {
+  Config config = GetConfig();
+  services::BatchingOptions options;
+  services::BatchingPredictorPool pool(config, options);
+
+  auto input = MakeImage("image", 0);
+  input.data.resize(input.data.size() / 2);
+  EXPECT_ANY_THROW(pool.Submit({input}));
+}
+
+// Compare the throughput of concurrent clients sharing a batching pool with
+// the same clients each running its own predictor with batch 1.
+TEST(BatchingPredictorPool, throughput) {
+  Config config = GetConfig();
+  auto main_predictor = CreatePredictor(config);
+  std::string input_name = main_predictor->GetInputNames()[0];
+  const int num_clients = 8;
+  const int num_requests = 4;
+
+  std::vector<std::unique_ptr<Predictor>> predictors;
+  for (int i = 0; i < 2; ++i) {
+    predictors.emplace_back(main_predictor->Clone());
+  }
+  auto start = std::chrono::steady_clock::now();
+  std::vector<std::thread> threads;
+  std::vector<std::mutex> locks(predictors.size());
+  for (int c = 0; c < num_clients; ++c) {
+    threads.emplace_back([&, c] {
+      size_t idx = c % predictors.size();
+      for (int i = 0; i < num_requests; ++i) {
+        std::lock_guard<std::mutex> guard(locks[idx]);
+        RunDirectly(predictors[idx].get(), MakeImage(input_name, i));
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  double unbatched_ms = std::chrono::duration<double, std::milli>(
+                            std::chrono::steady_clock::now() - start)
+                            .count();
+
+  services::BatchingOptions options;
+  options.num_workers = 2;
+  options.max_batch_size = 8;
+  services::BatchingPredictorPool pool(config, options);
+  start = std::chrono::steady_clock::now();
+  threads.clear();
+  for (int c = 0; c < num_clients; ++c) {
+    threads.emplace_back([&] {
+      for (int i = 0; i < num_requests; ++i) {
+        pool.Run({MakeImage(input_name, i)});
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  double batched_ms = std::chrono::duration<double, std::milli>(
+                          std::chrono::steady_clock::now() - start)
+                          .count();
+
+  auto stats = pool.GetStats();
+  LOG(INFO) << "unbatched: " << unbatched_ms << " ms, batched: " << batched_ms
+            << " ms, average batch rows: "
+            << static_cast<double>(stats.num_rows) / stats.num_batches
+            << ", p50 latency <= " << stats.TotalLatencyPercentile(50)
+            << " us, p99 latency <= " << stats.TotalLatencyPercentile(99)
+            << " us";
+  EXPECT_EQ(stats.num_requests,
+            static_cast<uint64_t>(num_clients * num_requests));
+}
+
+}  // namespace paddle_infer
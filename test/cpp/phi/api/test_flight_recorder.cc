@@ -0,0 +1,207 @@
+/* Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "paddle/phi/api/profiler/flight_recorder.h"
+#include "paddle/phi/core/os_info.h"
+
+COMMON_DECLARE_int32(flight_recorder_events_per_thread);
+COMMON_DECLARE_double(flight_recorder_window_s);
+COMMON_DECLARE_double(flight_recorder_slo_ms);
+COMMON_DECLARE_string(flight_recorder_dump_dir);
+
+namespace phi {
+namespace tests {
+
+// Events of the thread `thread_id` in a snapshot.
+std::vector<FlightRecorderEvent> EventsOf(
+    const std::vector<FlightRecorderThreadEvents>& threads,
+    uint64_t thread_id) {
+  for (auto& thread : threads) {
+    if (thread.thread_id == thread_id) {
+      return thread.events;
+    }
+  }
+  return {};
+}
+
+TEST(FlightRecorder, record_and_snapshot) {
+  auto& recorder = FlightRecorder::GetInstance();
+  recorder.Clear();
+  uint64_t tid = 0;
+  std::thread worker([&]() {
+    tid = GetCurrentThreadSysId();
+    uint64_t start = PosixInNsec();
+    recorder.RecordEvent(
+        "matmul", start, start + 10, TracerEventType::Operator);
+    recorder.RecordEvent(recorder.InternName(std::string("relu")),
+                         start + 10,
+                         start + 20,
+                         TracerEventType::Operator);
+    recorder.RecordMemEvent(start + 20, 256, TracerMemEventType::Allocate);
+  });
+  worker.join();
+
+  auto events = EventsOf(recorder.Snapshot(), tid);
+  ASSERT_EQ(events.size(), 3UL);
+  EXPECT_STREQ(events[0].name, "matmul");
+  EXPECT_EQ(events[0].end_ns - events[0].start_ns, 10UL);
+  EXPECT_STREQ(events[1].name, "relu");
+  EXPECT_EQ(events[2].kind, FlightRecorderEvent::kMemory);
+  EXPECT_EQ(events[2].arg, 256UL);
+
+  recorder.Clear();
+  EXPECT_TRUE(EventsOf(recorder.Snapshot(), tid).empty());
+}
+
+TEST(FlightRecorder, keep_latest_events) {
+  auto& recorder = FlightRecorder::GetInstance();
+  recorder.Clear();
+  int32_t old_capacity = FLAGS_flight_recorder_events_per_thread;
+  FLAGS_flight_recorder_events_per_thread = 8;
+  uint64_t tid = 0;
+  std::thread worker([&]() {
+    tid = GetCurrentThreadSysId();
+    uint64_t now = PosixInNsec();
+    for (uint64_t i = 0; i < 20; ++i) {
+      recorder.RecordEvent("op", now + i, now + i, TracerEventType::Operator);
+    }
+  });
+  worker.join();
+  FLAGS_flight_recorder_events_per_thread = old_capacity;
+
+  auto events = EventsOf(recorder.Snapshot(), tid);
+  // One of the 8 slots may be being overwritten while a dump reads it.
+  ASSERT_EQ(events.size(), 7UL);
+  EXPECT_EQ(events.back().end_ns - events.front().end_ns, 6UL);
+
+  // Events older than the window are not dumped.
+  double old_window = FLAGS_flight_recorder_window_s;
+  FLAGS_flight_recorder_window_s = 1e-9;
+  std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  EXPECT_TRUE(EventsOf(recorder.Snapshot(), tid).empty());
+  FLAGS_flight_recorder_window_s = old_window;
+}
+
+// Readers never see an event which is being overwritten.
+TEST(FlightRecorder, concurrent_read) {
+  auto& recorder = FlightRecorder::GetInstance();
+  recorder.Clear();
+  int32_t old_capacity = FLAGS_flight_recorder_events_per_thread;
+  FLAGS_flight_recorder_events_per_thread = 64;
+  std::atomic<uint64_t> tid{0};
+  std::atomic<bool> stop{false};
+  std::thread writer([&]() {
+    tid = GetCurrentThreadSysId();
+    uint64_t now = PosixInNsec();
+    for (uint64_t i = 0; !stop; ++i) {
+      // Every field encodes i, so a torn event has mismatching fields.
+      recorder.RecordEvent(
+          "op", now + i, now + 2 * i, static_cast<TracerEventType>(i % 8));
+    }
+  });
+  while (tid == 0) {
+    std::this_thread::yield();
+  }
+  for (int round = 0; round < 200; ++round) {
+    auto events = EventsOf(recorder.Snapshot(), tid);
+    for (size_t j = 0; j < events.size(); ++j) {
+      uint64_t i = events[j].end_ns - events[j].start_ns;
+      ASSERT_EQ(events[j].type, i % 8);
+      if (j > 0) {
+        ASSERT_EQ(events[j].start_ns, events[j - 1].start_ns + 1);
+      }
+    }
+  }
+  stop = true;
+  writer.join();
+  FLAGS_flight_recorder_events_per_thread = old_capacity;
+}
+
+TEST(FlightRecorder, dump) {
+  auto& recorder = FlightRecorder::GetInstance();
+  recorder.Clear();
+  uint64_t now = PosixInNsec();
+  recorder.RecordEvent("conv2d", now, now + 100, TracerEventType::Operator);
+  recorder.RecordMemEvent(now + 100, 1024, TracerMemEventType::Free);
+
+  std::string path = recorder.Dump("flight_recorder_test.pdfr");
+  auto threads = recorder.LoadDump(path);
+  auto events = EventsOf(threads, GetCurrentThreadSysId());
+  ASSERT_EQ(events.size(), 2UL);
+  EXPECT_STREQ(events[0].name, "conv2d");
+  EXPECT_EQ(events[0].start_ns, now);
+  EXPECT_EQ(events[0].end_ns, now + 100);
+  EXPECT_EQ(events[1].kind, FlightRecorderEvent::kMemory);
+  EXPECT_EQ(events[1].type, static_cast<uint8_t>(TracerMemEventType::Free));
+  EXPECT_EQ(events[1].arg, 1024UL);
+  std::remove(path.c_str());
+
+  path = recorder.Dump("flight_recorder_test.json");
+  std::ifstream ifs(path);
+  std::stringstream json;
+  json << ifs.rdbuf();
+  EXPECT_NE(json.str().find("\"traceEvents\""), std::string::npos);
+  EXPECT_NE(json.str().find("\"name\": \"conv2d\""), std::string::npos);
+  std::remove(path.c_str());
+
+  // A dump that cannot be written is reported, not thrown.
+  uint64_t num_dumps = recorder.NumDumps();
+  EXPECT_EQ(recorder.Dump("no_such_dir/flight_recorder_test.pdfr"), "");
+  EXPECT_EQ(recorder.NumDumps(), num_dumps);
+}
+
+TEST(FlightRecorder, dump_on_slo_breach) {
+  auto& recorder = FlightRecorder::GetInstance();
+  recorder.Clear();
+  double old_slo = FLAGS_flight_recorder_slo_ms;
+  std::string old_dir = FLAGS_flight_recorder_dump_dir;
+  std::filesystem::path dir = std::filesystem::temp_directory_path() /
+                              ("flight_recorder_" +
+                               std::to_string(GetProcessId()));
+  std::filesystem::create_directories(dir);
+  FLAGS_flight_recorder_slo_ms = 5;
+  FLAGS_flight_recorder_dump_dir = dir.string();
+  uint64_t num_dumps = recorder.NumDumps();
+
+  recorder.ReportLatency("request", 1000000);
+  EXPECT_EQ(recorder.NumDumps(), num_dumps);
+
+  recorder.ReportLatency("request", 10000000);
+  for (int i = 0; i < 500 && recorder.NumDumps() == num_dumps; ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  EXPECT_EQ(recorder.NumDumps(), num_dumps + 1);
+  // A second breach within the same window does not dump again.
+  recorder.ReportLatency("request", 10000000);
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  EXPECT_EQ(recorder.NumDumps(), num_dumps + 1);
+  EXPECT_FALSE(std::filesystem::is_empty(dir));
+  FLAGS_flight_recorder_slo_ms = old_slo;
+  FLAGS_flight_recorder_dump_dir = old_dir;
+  std::filesystem::remove_all(dir);
+}
+
+}  // namespace tests
+}  // namespace phi
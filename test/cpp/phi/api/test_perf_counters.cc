@@ -0,0 +1,76 @@
+/* Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "paddle/phi/api/profiler/perf_counters.h"
+
+namespace phi {
+namespace tests {
+
+TEST(PerfCounterReader, read) {
+  PerfCounterValues begin;
+  if (!PerfCounterReader::Read(&begin)) {
+    // perf_event_open is not permitted, e.g. in a sandbox.
+    EXPECT_FALSE(begin.valid);
+    return;
+  }
+  ASSERT_TRUE(begin.valid);
+  std::vector<double> data(1 << 20, 1.0);
+  double sum = 0;
+  for (double v : data) {
+    sum += v;
+  }
+  EXPECT_EQ(sum, static_cast<double>(data.size()));
+  PerfCounterValues end;
+  ASSERT_TRUE(PerfCounterReader::Read(&end));
+
+  PerfCounterValues diff = PerfCounterReader::Diff(begin, end);
+  EXPECT_TRUE(diff.valid);
+  EXPECT_GT(diff.task_clock_ns, 0UL);
+  if (diff.hardware) {
+    EXPECT_GT(diff.cycles, 0UL);
+    EXPECT_GT(diff.instructions, data.size());
+  }
+}
+
+TEST(PerfCounterReader, diff) {
+  PerfCounterValues begin;
+  PerfCounterValues end;
+  EXPECT_FALSE(PerfCounterReader::Diff(begin, end).valid);
+
+  begin.valid = end.valid = true;
+  begin.hardware = end.hardware = true;
+  begin.cycles = 100;
+  end.cycles = 350;
+  begin.cache_misses = 10;
+  end.cache_misses = 12;
+  // Scaled counters may decrease.
+  begin.instructions = 500;
+  end.instructions = 400;
+  PerfCounterValues diff = PerfCounterReader::Diff(begin, end);
+  EXPECT_TRUE(diff.valid);
+  EXPECT_TRUE(diff.hardware);
+  EXPECT_EQ(diff.cycles, 250UL);
+  EXPECT_EQ(diff.instructions, 0UL);
+  EXPECT_EQ(diff.cache_misses, 2UL);
+  EXPECT_EQ(diff.BytesMoved(), 2 * PerfCounterValues::kCacheLineBytes);
+
+  end.hardware = false;
+  EXPECT_FALSE(PerfCounterReader::Diff(begin, end).hardware);
+}
+
+}  // namespace tests
+}  // namespace phi
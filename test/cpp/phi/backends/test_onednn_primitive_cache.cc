@@ -0,0 +1,148 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "paddle/phi/backends/onednn/onednn_primitive_cache.h"
+
+namespace phi {
+namespace tests {
+
+OneDNNCacheKey MakeKey(const char* tag, int64_t value) {
+  OneDNNKeyHasher hasher(tag);
+  hasher.Add(std::vector<int64_t>{value, 3, 224, 224});
+  hasher.Add("conv2d_out");
+  return hasher.Key();
+}
+
+TEST(OneDNNKeyHasher, distinct_fields) {
+  EXPECT_EQ(MakeKey("conv", 1), MakeKey("conv", 1));
+  EXPECT_NE(MakeKey("conv", 1), MakeKey("conv", 2));
+
+  OneDNNKeyHasher a, b;
+  a.Add("ab");
+  a.Add("c");
+  b.Add("a");
+  b.Add("bc");
+  EXPECT_NE(a.Key(), b.Key());
+
+  auto key = MakeKey("conv", 1);
+  EXPECT_EQ(key.Derive("@fwd_p"), key.Derive("@fwd_p"));
+  EXPECT_NE(key.Derive("@fwd_p"), key.Derive("@fwd_pd"));
+  EXPECT_STREQ(key.Derive("@fwd_p").tag, "conv");
+}
+
+TEST(OneDNNPrimitiveCache, get_set_and_stats) {
+  OneDNNPrimitiveCache cache(0);
+  auto key = MakeKey("conv", 1);
+  EXPECT_EQ(cache.Get(key, 0, 0), nullptr);
+  cache.Set(key, 0, 0, std::make_shared<int>(7), nullptr);
+  auto blob = std::static_pointer_cast<int>(cache.Get(key, 0, 0));
+  ASSERT_NE(blob, nullptr);
+  EXPECT_EQ(*blob, 7);
+  // Other sessions and input shapes do not see the entry.
+  EXPECT_EQ(cache.Get(key, 1, 0), nullptr);
+  EXPECT_EQ(cache.Get(key, 0, 1), nullptr);
+
+  auto stats = cache.Stats();
+  EXPECT_EQ(stats["conv"].hits, 1UL);
+  EXPECT_EQ(stats["conv"].misses, 3UL);
+}
+
+TEST(OneDNNPrimitiveCache, lru_eviction) {
+  OneDNNPrimitiveCache cache(4);
+  for (int i = 0; i < 4; ++i) {
+    cache.Set(MakeKey("fc", i), 0, 0, std::make_shared<int>(i), nullptr);
+  }
+  // Touch the oldest entry so that the second one is evicted next.
+  EXPECT_NE(cache.Get(MakeKey("fc", 0), 0, 0), nullptr);
+  cache.Set(MakeKey("fc", 4), 0, 0, std::make_shared<int>(4), nullptr);
+  EXPECT_EQ(cache.Size(), 4UL);
+  EXPECT_NE(cache.Get(MakeKey("fc", 0), 0, 0), nullptr);
+  EXPECT_EQ(cache.Get(MakeKey("fc", 1), 0, 0), nullptr);
+  EXPECT_EQ(cache.Stats()["fc"].evictions, 1UL);
+}
+
+TEST(OneDNNPrimitiveCache, group_eviction) {
+  OneDNNPrimitiveCache cache(4);
+  // A handler caching its primitive descriptor, primitive and a reorder.
+  auto handler = MakeKey("conv", 0);
+  const char* suffixes[] = {"@fwd_pd", "@fwd_p", "reorder_p"};
+  for (const char* suffix : suffixes) {
+    EXPECT_EQ(handler.Derive(suffix).Group(), handler.Group());
+    cache.Set(
+        handler.Derive(suffix), 0, 0, std::make_shared<int>(0), nullptr);
+  }
+  EXPECT_EQ(handler.Derive("@fwd_p").Derive("-custom_reorder").Group(),
+            handler.Group());
+  cache.Set(MakeKey("fc", 1), 0, 0, std::make_shared<int>(1), nullptr);
+  // Using one entry keeps the whole group.
+  EXPECT_NE(cache.Get(handler.Derive("@fwd_pd"), 0, 0), nullptr);
+  cache.Set(MakeKey("fc", 2), 0, 0, std::make_shared<int>(2), nullptr);
+  EXPECT_EQ(cache.Get(MakeKey("fc", 1), 0, 0), nullptr);
+  for (const char* suffix : suffixes) {
+    EXPECT_NE(cache.Get(handler.Derive(suffix), 0, 0), nullptr) << suffix;
+  }
+  // The group is the least recently used now and is dropped as a whole.
+  EXPECT_NE(cache.Get(MakeKey("fc", 2), 0, 0), nullptr);
+  cache.Set(MakeKey("fc", 3), 0, 0, std::make_shared<int>(3), nullptr);
+  EXPECT_EQ(cache.Size(), 2UL);
+  for (const char* suffix : suffixes) {
+    EXPECT_EQ(cache.Get(handler.Derive(suffix), 0, 0), nullptr) << suffix;
+  }
+  EXPECT_EQ(cache.Stats()["conv"].evictions, 3UL);
+}
+
+TEST(OneDNNPrimitiveCache, erase_owner_and_shape) {
+  OneDNNPrimitiveCache cache(0);
+  int exec_a, exec_b;
+  cache.Set(MakeKey("pool", 0), 0, 0, std::make_shared<int>(0), &exec_a);
+  cache.Set(MakeKey("pool", 1), 0, 0, std::make_shared<int>(1), &exec_b);
+  cache.Set(MakeKey("pool", 2), 0, 5, std::make_shared<int>(2), &exec_b);
+  cache.EraseOwner(&exec_a);
+  EXPECT_EQ(cache.Size(), 2UL);
+  EXPECT_EQ(cache.Get(MakeKey("pool", 0), 0, 0), nullptr);
+  cache.EraseShape(0, 5);
+  EXPECT_EQ(cache.Size(), 1UL);
+  EXPECT_NE(cache.Get(MakeKey("pool", 1), 0, 0), nullptr);
+  cache.Clear();
+  EXPECT_EQ(cache.Size(), 0UL);
+}
+
+TEST(OneDNNPrimitiveCache, concurrent_access) {
+  OneDNNPrimitiveCache cache(256);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([&cache, t]() {
+      for (int i = 0; i < 1000; ++i) {
+        auto key = MakeKey("matmul", t * 1000 + i % 100);
+        if (cache.Get(key, 0, 0) == nullptr) {
+          cache.Set(key, 0, 0, std::make_shared<int>(i), nullptr);
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  EXPECT_LE(cache.Size(), 256UL);
+  auto stats = cache.Stats()["matmul"];
+  EXPECT_EQ(stats.hits + stats.misses, 4000UL);
+}
+
+}  // namespace tests
+}  // namespace phi
@@ -18,6 +18,8 @@
 
 #ifdef _WIN32
 #include <windows.h>
+#else
+#include <arpa/inet.h>
 #endif
 
 namespace phi {
@@ -37,6 +39,40 @@ TEST(MasterDaemon, init) {
   d.reset();
 }
 
+#ifndef _WIN32
+static uint16_t GetListenPort(int socket) {
+  ::sockaddr_in addr{};
+  ::socklen_t addr_len = sizeof(addr);
+  ::getsockname(socket, reinterpret_cast<::sockaddr*>(&addr), &addr_len);
+  return ntohs(addr.sin_port);
+}
+
+TEST(TCPStore, multi_get_set) {
+  int socket = tcputils::tcp_listen("", std::to_string(0), AF_INET);
+  uint16_t port = GetListenPort(socket);
+  auto d = detail::MasterDaemon::start(socket, 2, 100);
+
+  TCPStore writer("127.0.0.1", port, false, 0);
+  TCPStore reader("127.0.0.1", port, false, 0);
+  std::thread t([&reader]() {
+    // Blocks until every key of the batch has been published.
+    auto values = reader.multi_get({"a", "b", "c"});
+    ASSERT_EQ(values.size(), 3UL);
+    EXPECT_EQ(values[0], std::vector<uint8_t>({1}));
+    EXPECT_EQ(values[1], std::vector<uint8_t>({2, 3}));
+    EXPECT_TRUE(values[2].empty());
+  });
+  writer.multi_set({"a", "b", "c"}, {{1}, {2, 3}, {}});
+  t.join();
+
+  EXPECT_EQ(writer.add("counter", 2), 2);
+  EXPECT_EQ(reader.add("counter", 3), 5);
+  EXPECT_TRUE(reader.check("a"));
+  EXPECT_FALSE(reader.check("d"));
+  d.reset();
+}
+#endif
+
 /* now for only c compile test
 TEST(TCPStore, init) {
   TCPStore store("127.0.0.1", 6170, true, 1);
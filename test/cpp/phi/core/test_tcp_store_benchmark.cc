@@ -0,0 +1,108 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <arpa/inet.h>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "glog/logging.h"
+#include "gtest/gtest.h"
+#include "paddle/common/flags.h"
+#include "paddle/phi/core/distributed/store/tcp_store.h"
+#include "paddle/phi/core/distributed/store/tcp_utils.h"
+#include "test/cpp/phi/core/timer.h"
+
+PD_DEFINE_int32(tcp_store_bench_ranks, 64, "Number of client ranks.");
+PD_DEFINE_int32(tcp_store_bench_rounds, 100, "Number of barriers to run.");
+
+namespace phi {
+namespace distributed {
+
+// Every rank increments the round counter, the last one to arrive publishes
+// the done key and all the others wait for it, which is the access pattern of
+// the rendezvous and barrier in collective initialization.
+static void Barrier(TCPStore* store, int nranks, int round) {
+  std::string key = "barrier/" + std::to_string(round);
+  if (store->add(key, 1) == nranks) {
+    store->set(key + "/done", {1});
+  }
+  store->wait(key + "/done");
+}
+
+TEST(TCPStore, barrier_benchmark) {
+  const int nranks = FLAGS_tcp_store_bench_ranks;
+  const int rounds = FLAGS_tcp_store_bench_rounds;
+
+  int socket = tcputils::tcp_listen("", std::to_string(0), AF_INET);
+  ::sockaddr_in addr{};
+  ::socklen_t addr_len = sizeof(addr);
+  ::getsockname(socket, reinterpret_cast<::sockaddr*>(&addr), &addr_len);
+  uint16_t port = ntohs(addr.sin_port);
+  auto daemon = detail::MasterDaemon::start(socket, nranks, 100);
+
+  std::vector<std::unique_ptr<TCPStore>> stores;
+  for (int rank = 0; rank < nranks; ++rank) {
+    stores.emplace_back(
+        std::make_unique<TCPStore>("127.0.0.1", port, false, 0));
+  }
+
+  phi::tests::Timer timer;
+  timer.tic();
+  std::vector<std::thread> threads;
+  for (int rank = 0; rank < nranks; ++rank) {
+    threads.emplace_back([&stores, rank, nranks, rounds]() {
+      for (int round = 0; round < rounds; ++round) {
+        Barrier(stores[rank].get(), nranks, round);
+      }
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+  double barrier_ms = timer.toc();
+
+  std::vector<std::string> keys;
+  std::vector<std::vector<uint8_t>> values;
+  for (int rank = 0; rank < nranks; ++rank) {
+    keys.emplace_back("addr/" + std::to_string(rank));
+    values.emplace_back(std::vector<uint8_t>(64, static_cast<uint8_t>(rank)));
+  }
+  stores[0]->multi_set(keys, values);
+
+  timer.tic();
+  for (int round = 0; round < rounds; ++round) {
+    for (const auto& key : keys) {
+      stores[0]->get(key);
+    }
+  }
+  double get_ms = timer.toc();
+  timer.tic();
+  for (int round = 0; round < rounds; ++round) {
+    auto got = stores[0]->multi_get(keys);
+    ASSERT_EQ(got.size(), keys.size());
+  }
+  double multi_get_ms = timer.toc();
+
+  LOG(INFO) << nranks << " ranks, " << rounds << " barriers: " << barrier_ms
+            << "ms in total, " << barrier_ms / rounds << "ms per barrier.";
+  LOG(INFO) << "Fetching " << nranks << " keys one by one: "
+            << get_ms / rounds << "ms, with multi_get: "
+            << multi_get_ms / rounds << "ms.";
+  daemon.reset();
+}
+
+}  // namespace distributed
+}  // namespace phi
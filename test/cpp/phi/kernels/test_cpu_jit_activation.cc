@@ -0,0 +1,165 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "paddle/phi/backends/context_pool.h"
+#include "paddle/phi/common/data_type.h"
+#include "paddle/phi/core/dense_tensor.h"
+#include "paddle/phi/core/kernel_context.h"
+#include "paddle/phi/core/kernel_factory.h"
+#include "paddle/phi/core/kernel_registry.h"
+
+PD_DECLARE_KERNEL(gelu, CPU, ALL_LAYOUT);
+PD_DECLARE_KERNEL(swiglu, CPU, ALL_LAYOUT);
+PD_DECLARE_KERNEL(softmax, CPU, ALL_LAYOUT);
+
+namespace phi {
+namespace tests {
+
+// The gelu and swiglu kernels run the jit code in blocks of 256 and a tail,
+// so the sizes cover a tail only, whole blocks and blocks with a tail.
+const std::vector<int64_t>& TestWidths() {
+  static const std::vector<int64_t> widths = {1, 7, 256, 300, 1000};
+  return widths;
+}
+
+template <typename T>
+DenseTensor RandomTensor(const std::vector<int64_t>& dims, uint64_t seed) {
+  DenseTensor tensor;
+  tensor.Resize(common::make_ddim(dims));
+  auto* dev_ctx = DeviceContextPool::Instance().Get(CPUPlace());
+  T* data = dev_ctx->template Alloc<T>(&tensor);
+  std::mt19937_64 rng(seed);
+  std::uniform_real_distribution<double> dist(-4., 4.);
+  for (int64_t i = 0; i < tensor.numel(); ++i) {
+    data[i] = static_cast<T>(dist(rng));
+  }
+  return tensor;
+}
+
+// Runs the registered CPU kernel `name` of T on the inputs; nullptr stands
+// for a missing optional input.
+template <typename T, typename... Attrs>
+DenseTensor RunKernel(const std::string& name,
+                      const std::vector<const DenseTensor*>& inputs,
+                      Attrs... attrs) {
+  KernelKey key(
+      Backend::CPU, DataLayout::ALL_LAYOUT, CppTypeToDataType<T>::Type());
+  auto kernel_result =
+      KernelFactory::Instance().SelectKernelOrThrowError(name, key);
+  KernelContext ctx(DeviceContextPool::Instance().Get(CPUPlace()));
+  for (const auto* input : inputs) {
+    ctx.EmplaceBackInput(input);
+  }
+  (ctx.EmplaceBackAttr(attrs), ...);
+  DenseTensor out;
+  ctx.EmplaceBackOutput(&out);
+  kernel_result.kernel(&ctx);
+  return out;
+}
+
+template <typename T>
+void ExpectNear(const DenseTensor& out, const std::vector<T>& expected) {
+  ASSERT_EQ(out.numel(), static_cast<int64_t>(expected.size()));
+  const T* data = out.data<T>();
+  for (size_t i = 0; i < expected.size(); ++i) {
+    ASSERT_NEAR(data[i], expected[i], 1e-5) << "at " << i;
+  }
+}
+
+template <typename T>
+void TestGeluTanh() {
+  for (int64_t width : TestWidths()) {
+    DenseTensor x = RandomTensor<T>({3, width}, width);
+    std::vector<T> expected(x.numel());
+    for (int64_t i = 0; i < x.numel(); ++i) {
+      double v = x.data<T>()[i];
+      double u = std::sqrt(2. / M_PI) * (v + 0.044715 * v * v * v);
+      expected[i] = static_cast<T>(0.5 * v * (1. + std::tanh(u)));
+    }
+    ExpectNear(RunKernel<T>("gelu", {&x}, true), expected);
+  }
+}
+
+TEST(cpu_jit_activation, gelu_tanh) {
+  TestGeluTanh<float>();
+  TestGeluTanh<double>();
+}
+
+double SwiGLU(double x, double y) { return x / (1. + std::exp(-x)) * y; }
+
+template <typename T>
+void TestSwiGLU() {
+  for (int64_t width : TestWidths()) {
+    // x and y
+    DenseTensor x = RandomTensor<T>({3, width}, width);
+    DenseTensor y = RandomTensor<T>({3, width}, width + 1);
+    std::vector<T> expected(x.numel());
+    for (int64_t i = 0; i < x.numel(); ++i) {
+      expected[i] = static_cast<T>(SwiGLU(x.data<T>()[i], y.data<T>()[i]));
+    }
+    ExpectNear(RunKernel<T>("swiglu", {&x, &y}), expected);
+
+    // the two halves of the last dim of x
+    DenseTensor xy = RandomTensor<T>({3, 2 * width}, width + 2);
+    for (int64_t i = 0; i < 3; ++i) {
+      const T* row = xy.data<T>() + i * 2 * width;
+      for (int64_t j = 0; j < width; ++j) {
+        expected[i * width + j] =
+            static_cast<T>(SwiGLU(row[j], row[width + j]));
+      }
+    }
+    ExpectNear(RunKernel<T>("swiglu", {&xy, nullptr}), expected);
+  }
+}
+
+TEST(cpu_jit_activation, swiglu) {
+  TestSwiGLU<float>();
+  TestSwiGLU<double>();
+}
+
+template <typename T>
+void TestSoftmax() {
+  for (int64_t width : TestWidths()) {
+    DenseTensor x = RandomTensor<T>({3, width}, width);
+    std::vector<T> expected(x.numel());
+    for (int64_t i = 0; i < 3; ++i) {
+      const T* row = x.data<T>() + i * width;
+      double max_val = *std::max_element(row, row + width);
+      double sum = 0.;
+      for (int64_t j = 0; j < width; ++j) {
+        sum += std::exp(row[j] - max_val);
+      }
+      for (int64_t j = 0; j < width; ++j) {
+        expected[i * width + j] =
+            static_cast<T>(std::exp(row[j] - max_val) / sum);
+      }
+    }
+    ExpectNear(RunKernel<T>("softmax", {&x}, -1), expected);
+  }
+}
+
+TEST(cpu_jit_activation, softmax) {
+  TestSoftmax<float>();
+  TestSoftmax<double>();
+}
+
+}  // namespace tests
+}  // namespace phi
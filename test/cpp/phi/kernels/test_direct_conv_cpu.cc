@@ -0,0 +1,459 @@
+/* Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#if defined(_OPENMP)
+#include <omp.h>
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "glog/logging.h"
+#include "gtest/gtest.h"
+#include "paddle/phi/backends/context_pool.h"
+#include "paddle/phi/common/port.h"
+#include "paddle/phi/infermeta/binary.h"
+#include "paddle/phi/kernels/conv_kernel.h"
+#include "paddle/phi/kernels/funcs/direct_conv_cpu.h"
+#include "paddle/phi/kernels/funcs/packed_gemm_cache.h"
+#include "paddle/phi/kernels/impl/conv_kernel_impl.h"
+
+namespace phi {
+namespace tests {
+
+using funcs::Conv2dShape;
+using funcs::DirectConvAlgo;
+
+inline double GetCurrentUS() {
+  struct timeval time = {};
+  gettimeofday(&time, nullptr);
+  return 1e+6 * time.tv_sec + time.tv_usec;  // NOLINT
+}
+
+const CPUContext& GetContext() {
+  return *static_cast<const CPUContext*>(
+      DeviceContextPool::Instance().Get(CPUPlace()));
+}
+
+Conv2dShape MakeShape(int64_t batch,
+                      int64_t in_c,
+                      int64_t in_h,
+                      int64_t in_w,
+                      int64_t out_c,
+                      int kernel_h,
+                      int kernel_w,
+                      int stride,
+                      int pad,
+                      int dilation,
+                      int groups) {
+  Conv2dShape s;
+  s.batch = batch;
+  s.in_c = in_c;
+  s.in_h = in_h;
+  s.in_w = in_w;
+  s.out_c = out_c;
+  s.kernel_h = kernel_h;
+  s.kernel_w = kernel_w;
+  s.stride_h = stride;
+  s.stride_w = stride;
+  s.pad_top = pad;
+  s.pad_left = pad;
+  s.dilation_h = dilation;
+  s.dilation_w = dilation;
+  s.groups = groups;
+  s.out_h = (in_h + 2 * pad - dilation * (kernel_h - 1) - 1) / stride + 1;
+  s.out_w = (in_w + 2 * pad - dilation * (kernel_w - 1) - 1) / stride + 1;
+  return s;
+}
+
+// The NCHW output of the convolution of the NCHW input.
+template <typename T>
+std::vector<T> Reference(const Conv2dShape& s, const T* in, const T* filter) {
+  const int64_t icg = s.in_c / s.groups;
+  const int64_t ocg = s.out_c / s.groups;
+  std::vector<T> out(s.batch * s.out_c * s.out_h * s.out_w);
+  for (int64_t n = 0; n < s.batch; ++n) {
+    for (int64_t oc = 0; oc < s.out_c; ++oc) {
+      const int64_t g = oc / ocg;
+      for (int64_t oh = 0; oh < s.out_h; ++oh) {
+        for (int64_t ow = 0; ow < s.out_w; ++ow) {
+          double sum = 0;
+          for (int64_t ic = 0; ic < icg; ++ic) {
+            for (int kh = 0; kh < s.kernel_h; ++kh) {
+              for (int kw = 0; kw < s.kernel_w; ++kw) {
+                const int64_t ih = oh * s.stride_h - s.pad_top +
+                                   kh * s.dilation_h;
+                const int64_t iw = ow * s.stride_w - s.pad_left +
+                                   kw * s.dilation_w;
+                if (ih < 0 || ih >= s.in_h || iw < 0 || iw >= s.in_w) {
+                  continue;
+                }
+                sum += in[((n * s.in_c + g * icg + ic) * s.in_h + ih) *
+                              s.in_w +
+                          iw] *
+                       filter[((oc * icg + ic) * s.kernel_h + kh) *
+                                  s.kernel_w +
+                              kw];
+              }
+            }
+          }
+          out[((n * s.out_c + oc) * s.out_h + oh) * s.out_w + ow] = sum;
+        }
+      }
+    }
+  }
+  return out;
+}
+
+// [n][c][hw] to [n][hw][c], or back if to_channel_last is false.
+template <typename T>
+std::vector<T> TransposeLayout(const std::vector<T>& x,
+                               int64_t n,
+                               int64_t c,
+                               int64_t hw,
+                               bool to_channel_last) {
+  std::vector<T> y(x.size());
+  for (int64_t i = 0; i < n; ++i) {
+    for (int64_t j = 0; j < c; ++j) {
+      for (int64_t k = 0; k < hw; ++k) {
+        const int64_t nchw = (i * c + j) * hw + k;
+        const int64_t nhwc = (i * hw + k) * c + j;
+        if (to_channel_last) {
+          y[nhwc] = x[nchw];
+        } else {
+          y[nchw] = x[nhwc];
+        }
+      }
+    }
+  }
+  return y;
+}
+
+template <typename T>
+void TestDirectConv(const Conv2dShape& s,
+                    bool channel_last,
+                    DirectConvAlgo expected_algo) {
+  ASSERT_EQ(funcs::SelectDirectConvAlgo(s, channel_last, 1, false),
+            expected_algo);
+  std::mt19937 rng(s.in_c * 131 + s.out_c * 7 + s.kernel_h);
+  std::uniform_real_distribution<T> dist(-1, 1);
+  std::vector<T> in(s.batch * s.in_c * s.in_h * s.in_w);
+  DenseTensor filter;
+  filter.Resize({s.out_c, s.in_c / s.groups, s.kernel_h, s.kernel_w});
+  T* filter_data = GetContext().template Alloc<T>(&filter);
+  for (auto& v : in) {
+    v = dist(rng);
+  }
+  std::generate_n(filter_data, filter.numel(), [&]() { return dist(rng); });
+  const std::vector<T> ref = Reference(s, in.data(), filter_data);
+
+  const int64_t in_hw = s.in_h * s.in_w;
+  const int64_t out_hw = s.out_h * s.out_w;
+  if (channel_last) {
+    in = TransposeLayout(in, s.batch, s.in_c, in_hw, true);
+  }
+  std::vector<T> out(ref.size());
+  funcs::DirectConv2d<T>(GetContext(),
+                         s,
+                         channel_last,
+                         expected_algo,
+                         in.data(),
+                         filter,
+                         out.data());
+  if (channel_last) {
+    out = TransposeLayout(out, s.batch, s.out_c, out_hw, false);
+  }
+  for (size_t i = 0; i < out.size(); ++i) {
+    ASSERT_NEAR(out[i], ref[i], 1e-4) << i;
+  }
+}
+
+TEST(DirectConvCPU, select_algo) {
+  auto select = [](const Conv2dShape& s,
+                   bool channel_last,
+                   int threads = 1,
+                   bool cached_filter = false) {
+    return funcs::SelectDirectConvAlgo(s, channel_last, threads, cached_filter);
+  };
+  // Depthwise.
+  EXPECT_EQ(select(MakeShape(1, 32, 56, 56, 32, 3, 3, 1, 1, 1, 32), false),
+            DirectConvAlgo::kNone);
+  // 1x1 is a GEMM on NCHW inputs already.
+  EXPECT_EQ(select(MakeShape(1, 64, 28, 28, 64, 1, 1, 1, 0, 1, 1), false),
+            DirectConvAlgo::kNone);
+  EXPECT_EQ(select(MakeShape(1, 64, 28, 28, 64, 1, 1, 1, 0, 1, 1), true),
+            DirectConvAlgo::kGemm);
+  EXPECT_EQ(select(MakeShape(1, 64, 56, 56, 64, 3, 3, 1, 1, 1, 1), false),
+            DirectConvAlgo::kWinograd);
+  // Too few tiles per thread.
+  EXPECT_EQ(
+      select(MakeShape(1, 64, 56, 56, 64, 3, 3, 1, 1, 1, 1), false, 128),
+      DirectConvAlgo::kNone);
+  // Too few tiles to transform the filter for, unless it is cached.
+  EXPECT_EQ(select(MakeShape(1, 256, 14, 14, 256, 3, 3, 1, 1, 1, 1), false),
+            DirectConvAlgo::kNone);
+  EXPECT_EQ(
+      select(
+          MakeShape(1, 256, 14, 14, 256, 3, 3, 1, 1, 1, 1), false, 1, true),
+      DirectConvAlgo::kWinograd);
+  // Too many channels for chunks of enough tiles.
+  EXPECT_EQ(
+      select(MakeShape(8, 512, 7, 7, 512, 3, 3, 1, 1, 1, 1), false, 1, true),
+      DirectConvAlgo::kNone);
+  EXPECT_EQ(select(MakeShape(1, 64, 56, 56, 128, 3, 3, 2, 1, 1, 1), false),
+            DirectConvAlgo::kNone);
+  EXPECT_EQ(select(MakeShape(1, 32, 112, 112, 64, 5, 5, 1, 2, 1, 1), true),
+            DirectConvAlgo::kDirect);
+  // Fewer rows x oc blocks than threads.
+  EXPECT_EQ(
+      select(MakeShape(1, 32, 12, 12, 16, 5, 5, 1, 2, 1, 1), true, 64),
+      DirectConvAlgo::kNone);
+}
+
+TEST(DirectConvCPU, gemm) {
+  TestDirectConv<float>(MakeShape(2, 24, 5, 7, 40, 1, 1, 1, 0, 1, 1),
+                        true,
+                        DirectConvAlgo::kGemm);
+  TestDirectConv<double>(MakeShape(1, 8, 3, 3, 16, 1, 1, 1, 0, 1, 1),
+                         true,
+                         DirectConvAlgo::kGemm);
+}
+
+TEST(DirectConvCPU, winograd) {
+  for (bool channel_last : {false, true}) {
+    TestDirectConv<float>(MakeShape(1, 16, 24, 24, 24, 3, 3, 1, 1, 1, 1),
+                          channel_last,
+                          DirectConvAlgo::kWinograd);
+    // Odd outputs, no padding and an incomplete oc block.
+    TestDirectConv<float>(MakeShape(2, 9, 19, 17, 13, 3, 3, 1, 0, 1, 1),
+                          channel_last,
+                          DirectConvAlgo::kWinograd);
+    TestDirectConv<float>(MakeShape(2, 32, 16, 16, 32, 3, 3, 1, 1, 1, 2),
+                          channel_last,
+                          DirectConvAlgo::kWinograd);
+    TestDirectConv<double>(MakeShape(1, 8, 23, 25, 16, 3, 3, 1, 1, 1, 1),
+                           channel_last,
+                           DirectConvAlgo::kWinograd);
+  }
+}
+
+TEST(DirectConvCPU, direct) {
+  for (bool channel_last : {false, true}) {
+    TestDirectConv<float>(MakeShape(1, 16, 12, 13, 20, 5, 5, 1, 2, 1, 1),
+                          channel_last,
+                          DirectConvAlgo::kDirect);
+    TestDirectConv<float>(MakeShape(2, 32, 11, 9, 32, 5, 3, 1, 1, 2, 2),
+                          channel_last,
+                          DirectConvAlgo::kDirect);
+    TestDirectConv<double>(MakeShape(1, 24, 10, 10, 8, 7, 7, 1, 3, 1, 1),
+                           channel_last,
+                           DirectConvAlgo::kDirect);
+  }
+}
+
+// Runs ConvKernel, which takes the direct paths where they suit, against
+// ConvKernelImpl, so that the padding algorithm and the [top, bottom, left,
+// right] paddings are passed to the direct paths as im2col sees them.
+void TestConvKernel(const std::vector<int64_t>& input_dims,
+                    const std::vector<int64_t>& filter_dims,
+                    const std::vector<int>& paddings,
+                    const std::string& padding_algorithm,
+                    const std::string& data_format,
+                    bool constant_filter = false) {
+  const auto& ctx = GetContext();
+  const std::vector<int> strides = {1, 1};
+  const std::vector<int> dilations = {1, 1};
+  DenseTensor input, filter, out, ref;
+  input.Resize(common::make_ddim(input_dims));
+  filter.Resize(common::make_ddim(filter_dims));
+  std::mt19937 rng(input.numel() + filter.numel());
+  std::uniform_real_distribution<float> dist(-1, 1);
+  std::generate_n(
+      ctx.Alloc<float>(&input), input.numel(), [&]() { return dist(rng); });
+  std::generate_n(
+      ctx.Alloc<float>(&filter), filter.numel(), [&]() { return dist(rng); });
+  MetaTensor meta_out(&out);
+  ConvInferMeta(input,
+                filter,
+                strides,
+                paddings,
+                padding_algorithm,
+                dilations,
+                1,
+                data_format,
+                &meta_out);
+  ref.Resize(out.dims());
+  ctx.Alloc<float>(&ref);
+
+  auto& cache = funcs::PackedWeightCache::Instance();
+  if (constant_filter) {
+    cache.RegisterConstant(filter);
+  }
+  const size_t cache_size = cache.Size();
+  ConvKernel<float, CPUContext>(ctx,
+                                input,
+                                filter,
+                                strides,
+                                paddings,
+                                padding_algorithm,
+                                dilations,
+                                1,
+                                data_format,
+                                &out);
+  ConvKernelImpl<float>(ctx,
+                        input,
+                        filter,
+                        strides,
+                        paddings,
+                        padding_algorithm,
+                        1,
+                        dilations,
+                        data_format,
+                        &ref);
+  const float* out_data = out.data<float>();
+  const float* ref_data = ref.data<float>();
+  for (int64_t i = 0; i < out.numel(); ++i) {
+    ASSERT_NEAR(out_data[i], ref_data[i], 1e-4)
+        << padding_algorithm << " " << data_format << " " << i;
+  }
+  // The filter is packed once, the second call takes the cached copy. Only
+  // the 1x1 GEMM, which needs no packing, is direct without OpenMP.
+#if defined(_OPENMP)
+  const size_t packed = constant_filter ? 1 : 0;
+#else
+  const size_t packed = 0;
+#endif
+  EXPECT_EQ(cache.Size(), cache_size + packed);
+  if (!constant_filter) {
+    return;
+  }
+  DenseTensor out2;
+  out2.Resize(out.dims());
+  ConvKernel<float, CPUContext>(ctx,
+                                input,
+                                filter,
+                                strides,
+                                paddings,
+                                padding_algorithm,
+                                dilations,
+                                1,
+                                data_format,
+                                &out2);
+  EXPECT_EQ(cache.Size(), cache_size + packed);
+  for (int64_t i = 0; i < out2.numel(); ++i) {
+    ASSERT_EQ(out2.data<float>()[i], out_data[i]) << i;
+  }
+}
+
+TEST(DirectConvCPU, conv_kernel) {
+  const bool use_direct_conv_cpu = FLAGS_use_direct_conv_cpu;
+  FLAGS_use_direct_conv_cpu = true;
+#if defined(_OPENMP)
+  // 3x3 convolutions take the winograd path, 5x5 ones the direct path, which
+  // needs OpenMP, and threads enough to split the small outputs across.
+  const int threads = omp_get_max_threads();
+  omp_set_num_threads(4);
+#endif
+  for (const std::string& padding_algorithm : {"SAME", "VALID"}) {
+    TestConvKernel(
+        {2, 16, 19, 24}, {24, 16, 3, 3}, {0, 0}, padding_algorithm, "NCHW");
+    TestConvKernel(
+        {2, 19, 24, 16}, {24, 16, 3, 3}, {0, 0}, padding_algorithm, "NHWC");
+    TestConvKernel(
+        {1, 16, 12, 13}, {20, 16, 5, 5}, {0, 0}, padding_algorithm, "NCHW");
+  }
+  // Asymmetric paddings.
+  TestConvKernel(
+      {2, 16, 20, 21}, {24, 16, 3, 3}, {0, 1, 2, 0}, "EXPLICIT", "NCHW");
+  TestConvKernel(
+      {2, 20, 21, 16}, {24, 16, 3, 3}, {1, 0, 0, 2}, "EXPLICIT", "NHWC");
+  TestConvKernel(
+      {1, 16, 12, 13}, {20, 16, 5, 5}, {1, 3, 2, 0}, "EXPLICIT", "NCHW");
+  TestConvKernel(
+      {1, 12, 13, 16}, {20, 16, 5, 5}, {3, 1, 0, 2}, "EXPLICIT", "NHWC");
+  // 120 tiles take the winograd path only with the filter cached.
+  TestConvKernel(
+      {1, 16, 19, 24}, {24, 16, 3, 3}, {1, 1}, "EXPLICIT", "NCHW", true);
+#if defined(_OPENMP)
+  omp_set_num_threads(threads);
+#endif
+  FLAGS_use_direct_conv_cpu = use_direct_conv_cpu;
+}
+
+TEST(DirectConvCPU, benchmark) {
+  struct Case {
+    int64_t in_c, size, out_c;
+    int kernel, pad;
+  };
+  const int repeat = 5;
+  const auto& ctx = GetContext();
+  for (const Case& c : {Case{64, 56, 64, 3, 1},
+                        Case{128, 28, 128, 3, 1},
+                        Case{32, 112, 64, 5, 2},
+                        Case{256, 14, 256, 3, 1}}) {
+    const Conv2dShape s = MakeShape(
+        1, c.in_c, c.size, c.size, c.out_c, c.kernel, c.kernel, 1, c.pad, 1, 1);
+    DenseTensor input, filter, output;
+    input.Resize({s.batch, s.in_c, s.in_h, s.in_w});
+    filter.Resize({s.out_c, s.in_c, s.kernel_h, s.kernel_w});
+    output.Resize({s.batch, s.out_c, s.out_h, s.out_w});
+    std::fill_n(ctx.Alloc<float>(&input), input.numel(), 0.5f);
+    std::fill_n(ctx.Alloc<float>(&filter), filter.numel(), 0.25f);
+    ctx.Alloc<float>(&output);
+
+    double start = GetCurrentUS();
+    for (int i = 0; i < repeat; ++i) {
+      ConvKernelImpl<float>(ctx,
+                            input,
+                            filter,
+                            {1, 1},
+                            {c.pad, c.pad},
+                            "EXPLICIT",
+                            1,
+                            {1, 1},
+                            "NCHW",
+                            &output);
+    }
+    double im2col_us = (GetCurrentUS() - start) / repeat;
+    const DirectConvAlgo algo = funcs::SelectDirectConvAlgo(
+        s, false, funcs::DirectConvThreads(), false);
+    double direct_us = 0;
+    if (algo != DirectConvAlgo::kNone) {
+      start = GetCurrentUS();
+      for (int i = 0; i < repeat; ++i) {
+        funcs::DirectConv2d<float>(ctx,
+                                   s,
+                                   false,
+                                   algo,
+                                   input.data<float>(),
+                                   filter,
+                                   output.data<float>());
+      }
+      direct_us = (GetCurrentUS() - start) / repeat;
+    }
+    const int64_t col_bytes = s.in_c * s.kernel_h * s.kernel_w * s.out_h *
+                              s.out_w * static_cast<int64_t>(sizeof(float));
+    VLOG(3) << "conv2d " << s.in_c << "x" << s.in_h << "x" << s.in_w << " -> "
+            << s.out_c << ", " << c.kernel << "x" << c.kernel
+            << ": im2col + GEMM " << im2col_us << " us with a " << col_bytes
+            << " bytes col buffer, algo " << static_cast<int>(algo) << " "
+            << direct_us << " us";
+  }
+}
+
+}  // namespace tests
+}  // namespace phi
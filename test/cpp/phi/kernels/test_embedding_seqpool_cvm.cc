@@ -0,0 +1,405 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "glog/logging.h"
+#include "gtest/gtest.h"
+#include "paddle/phi/backends/context_pool.h"
+#include "paddle/phi/core/dense_tensor.h"
+#include "paddle/phi/core/kernel_context.h"
+#include "paddle/phi/core/kernel_factory.h"
+#include "paddle/phi/core/kernel_registry.h"
+#include "paddle/phi/kernels/funcs/embedding_seqpool_cvm.h"
+#include "test/cpp/phi/core/timer.h"
+
+PD_DECLARE_KERNEL(fused_seqpool_cvm, CPU, ALL_LAYOUT);
+PD_DECLARE_KERNEL(fused_embedding_seqpool_cvm, CPU, ALL_LAYOUT);
+
+namespace phi {
+namespace tests {
+
+struct Batch {
+  std::vector<int64_t> ids;
+  std::vector<size_t> lod;
+};
+
+Batch RandomBatch(int64_t batch_size,
+                  int64_t max_length,
+                  int64_t height,
+                  uint64_t seed) {
+  std::mt19937_64 rng(seed);
+  std::uniform_int_distribution<int64_t> length_dist(0, max_length);
+  std::uniform_int_distribution<int64_t> id_dist(0, height - 1);
+  Batch batch;
+  batch.lod.push_back(0);
+  for (int64_t i = 0; i < batch_size; ++i) {
+    int64_t length = length_dist(rng);
+    for (int64_t j = 0; j < length; ++j) {
+      batch.ids.push_back(id_dist(rng));
+    }
+    batch.lod.push_back(batch.ids.size());
+  }
+  return batch;
+}
+
+// Gathers the rows, then pools them and applies CVM, one step at a time.
+std::vector<float> Reference(const std::vector<float>& table,
+                             const Batch& batch,
+                             const funcs::EmbSeqPoolCVMAttr& attr) {
+  int64_t width = attr.width;
+  int64_t batch_size = batch.lod.size() - 1;
+  std::vector<float> gathered(batch.ids.size() * width);
+  for (size_t i = 0; i < batch.ids.size(); ++i) {
+    for (int64_t j = 0; j < width; ++j) {
+      gathered[i * width + j] = batch.ids[i] == attr.padding_idx
+                                    ? 0.f
+                                    : table[batch.ids[i] * width + j];
+    }
+  }
+  std::vector<float> out;
+  for (int64_t ins = 0; ins < batch_size; ++ins) {
+    std::vector<float> pooled(width, attr.pad_value);
+    size_t length = batch.lod[ins + 1] - batch.lod[ins];
+    for (size_t i = batch.lod[ins]; i < batch.lod[ins + 1]; ++i) {
+      for (int64_t j = 0; j < width; ++j) {
+        pooled[j] += gathered[i * width + j];
+      }
+    }
+    for (auto& v : pooled) {
+      if (length > 0 && attr.pool_type == funcs::EmbSeqPoolCVMType::kAvg) {
+        v /= length;
+      } else if (length > 0 &&
+                 attr.pool_type == funcs::EmbSeqPoolCVMType::kSqrt) {
+        v /= std::sqrt(static_cast<float>(length));
+      }
+    }
+    if (attr.use_cvm) {
+      out.push_back(std::log(pooled[0] + 1));
+      out.push_back(std::log(pooled[1] + 1) - std::log(pooled[0] + 1));
+      out.insert(out.end(), pooled.begin() + 2, pooled.end());
+    } else {
+      out.insert(out.end(), pooled.begin() + attr.cvm_offset, pooled.end());
+    }
+  }
+  return out;
+}
+
+funcs::EmbSeqPoolCVMAttr MakeAttr(funcs::EmbSeqPoolCVMType pool_type,
+                                  bool use_cvm,
+                                  int64_t width,
+                                  int64_t padding_idx) {
+  funcs::EmbSeqPoolCVMAttr attr;
+  attr.pool_type = pool_type;
+  attr.pad_value = 0.f;
+  attr.use_cvm = use_cvm;
+  attr.cvm_offset = 2;
+  attr.width = width;
+  attr.padding_idx = padding_idx;
+  return attr;
+}
+
+template <typename TableT>
+std::vector<float> RunSlots(const std::vector<TableT>& table,
+                            const float* row_scale,
+                            int64_t height,
+                            const std::vector<Batch>& batches,
+                            const funcs::EmbSeqPoolCVMAttr& attr) {
+  int64_t batch_size = batches[0].lod.size() - 1;
+  int64_t out_width = attr.out_width();
+  std::vector<float> out(batches.size() * batch_size * out_width);
+  std::vector<funcs::EmbSeqPoolCVMSlot<TableT, int64_t>> slots;
+  for (size_t i = 0; i < batches.size(); ++i) {
+    slots.push_back({table.data(),
+                     row_scale,
+                     height,
+                     batches[i].ids.data(),
+                     batches[i].lod.data(),
+                     out.data() + i * batch_size * out_width});
+  }
+  funcs::EmbSeqPoolCVM(slots, batch_size, attr);
+  return out;
+}
+
+TEST(embedding_seqpool_cvm, float_table) {
+  int64_t height = 1000;
+  int64_t width = 11;
+  std::mt19937 rng(0);
+  std::uniform_real_distribution<float> dist(0.f, 1.f);
+  std::vector<float> table(height * width);
+  for (auto& v : table) {
+    v = dist(rng);
+  }
+  std::vector<Batch> batches;
+  for (int slot = 0; slot < 3; ++slot) {
+    batches.push_back(RandomBatch(64, 20, height, slot + 1));
+  }
+
+  for (auto pool_type : {funcs::EmbSeqPoolCVMType::kSum,
+                         funcs::EmbSeqPoolCVMType::kAvg,
+                         funcs::EmbSeqPoolCVMType::kSqrt}) {
+    for (bool use_cvm : {true, false}) {
+      for (int64_t padding_idx : {int64_t(-1), batches[0].ids[0]}) {
+        auto attr = MakeAttr(pool_type, use_cvm, width, padding_idx);
+        auto out = RunSlots(table, nullptr, height, batches, attr);
+        int64_t slot_size = out.size() / batches.size();
+        for (size_t slot = 0; slot < batches.size(); ++slot) {
+          auto expected = Reference(table, batches[slot], attr);
+          ASSERT_EQ(expected.size(), static_cast<size_t>(slot_size));
+          for (int64_t i = 0; i < slot_size; ++i) {
+            ASSERT_NEAR(out[slot * slot_size + i], expected[i], 1e-5);
+          }
+        }
+      }
+    }
+  }
+}
+
+TEST(embedding_seqpool_cvm, compressed_tables) {
+  int64_t height = 500;
+  int64_t width = 16;
+  std::mt19937 rng(1);
+  std::uniform_int_distribution<int> int8_dist(-127, 127);
+  std::vector<int8_t> int8_table(height * width);
+  std::vector<float> scales(height);
+  std::vector<phi::dtype::float16> fp16_table(height * width);
+  std::vector<float> dequantized(height * width);
+  std::vector<float> fp16_values(height * width);
+  for (int64_t row = 0; row < height; ++row) {
+    scales[row] = 0.01f * (row % 7 + 1);
+    for (int64_t j = 0; j < width; ++j) {
+      int64_t i = row * width + j;
+      int8_table[i] = static_cast<int8_t>(int8_dist(rng));
+      dequantized[i] = scales[row] * int8_table[i];
+      fp16_table[i] = static_cast<phi::dtype::float16>(dequantized[i]);
+      fp16_values[i] = static_cast<float>(fp16_table[i]);
+    }
+  }
+  std::vector<Batch> batches = {RandomBatch(32, 10, height, 2)};
+  auto attr =
+      MakeAttr(funcs::EmbSeqPoolCVMType::kSum, false, width, int64_t(-1));
+  auto int8_expected = Reference(dequantized, batches[0], attr);
+  auto fp16_expected = Reference(fp16_values, batches[0], attr);
+
+  auto int8_out = RunSlots(int8_table, scales.data(), height, batches, attr);
+  auto fp16_out = RunSlots(fp16_table, nullptr, height, batches, attr);
+  for (size_t i = 0; i < int8_expected.size(); ++i) {
+    ASSERT_NEAR(int8_out[i], int8_expected[i], 1e-4);
+    ASSERT_NEAR(fp16_out[i], fp16_expected[i], 1e-4);
+  }
+}
+
+template <typename T>
+DenseTensor MakeTensor(const std::vector<int64_t>& dims,
+                       const std::vector<T>& values,
+                       const LegacyLoD& lod) {
+  DenseTensor tensor;
+  tensor.Resize(common::make_ddim(dims));
+  tensor.set_lod(lod);
+  auto* dev_ctx = DeviceContextPool::Instance().Get(CPUPlace());
+  T* data = dev_ctx->template Alloc<T>(&tensor);
+  std::copy(values.begin(), values.end(), data);
+  return tensor;
+}
+
+// Runs the registered CPU kernel `name` on the slots `x` and its second input.
+std::vector<DenseTensor> RunSlotKernel(const std::string& name,
+                                       const std::vector<DenseTensor>& x,
+                                       const DenseTensor& second_input,
+                                       const funcs::EmbSeqPoolCVMAttr& attr,
+                                       const std::string& pooltype) {
+  auto kernel_result = KernelFactory::Instance().SelectKernelOrThrowError(
+      name, KernelKey(Backend::CPU, DataLayout::ALL_LAYOUT, DataType::FLOAT32));
+  const auto& kernel = kernel_result.kernel;
+  KernelContext ctx(DeviceContextPool::Instance().Get(CPUPlace()));
+  paddle::small_vector<const TensorBase*> inputs;
+  for (const auto& t : x) {
+    inputs.push_back(&t);
+  }
+  ctx.EmplaceBackInputs(inputs);
+  ctx.EmplaceBackInput(&second_input);
+  bool with_table = name == "fused_embedding_seqpool_cvm";
+  if (with_table) {
+    ctx.EmplaceBackInput(nullptr);
+  }
+  ctx.EmplaceBackAttr(pooltype);
+  ctx.EmplaceBackAttr(attr.pad_value);
+  ctx.EmplaceBackAttr(attr.use_cvm);
+  ctx.EmplaceBackAttr(attr.cvm_offset);
+  if (with_table) {
+    ctx.EmplaceBackAttr(attr.padding_idx);
+  }
+  std::vector<DenseTensor> out(x.size());
+  paddle::small_vector<TensorBase*> outputs;
+  for (auto& t : out) {
+    outputs.push_back(&t);
+  }
+  ctx.EmplaceBackOutputs(outputs);
+  kernel(&ctx);
+  return out;
+}
+
+std::vector<DenseTensor> FusedSeqpoolCvm(const std::vector<DenseTensor>& x,
+                                         const DenseTensor& cvm,
+                                         const funcs::EmbSeqPoolCVMAttr& attr) {
+  return RunSlotKernel("fused_seqpool_cvm", x, cvm, attr, "SUM");
+}
+
+std::vector<DenseTensor> FusedEmbeddingSeqpoolCvm(
+    const std::vector<DenseTensor>& ids,
+    const DenseTensor& w,
+    const funcs::EmbSeqPoolCVMAttr& attr,
+    const std::string& pooltype) {
+  return RunSlotKernel("fused_embedding_seqpool_cvm", ids, w, attr, pooltype);
+}
+
+void ExpectNear(const DenseTensor& out, const std::vector<float>& expected) {
+  ASSERT_EQ(out.numel(), static_cast<int64_t>(expected.size()));
+  for (size_t i = 0; i < expected.size(); ++i) {
+    ASSERT_NEAR(out.data<float>()[i], expected[i], 1e-5);
+  }
+}
+
+// The CPU kernel of fused_seqpool_cvm pools the embeddings of each slot, it
+// matches the lookup of the rows 0, 1, 2, ... of the same embeddings.
+TEST(embedding_seqpool_cvm, fused_seqpool_cvm_kernel) {
+  int64_t width = 6;
+  std::mt19937 rng(3);
+  std::uniform_real_distribution<float> dist(0.f, 1.f);
+  std::vector<DenseTensor> x;
+  std::vector<std::vector<float>> embeddings;
+  std::vector<Batch> batches;
+  for (int slot = 0; slot < 2; ++slot) {
+    Batch batch = RandomBatch(8, 5, 1, slot + 20);
+    for (size_t i = 0; i < batch.ids.size(); ++i) {
+      batch.ids[i] = i;
+    }
+    std::vector<float> values(batch.ids.size() * width);
+    for (auto& v : values) {
+      v = dist(rng);
+    }
+    int64_t num_ids = batch.ids.size();
+    x.push_back(MakeTensor<float>({num_ids, width}, values, {batch.lod}));
+    embeddings.push_back(values);
+    batches.push_back(batch);
+  }
+  auto cvm = MakeTensor<float>({8, 2}, std::vector<float>(16, 1.f), {});
+
+  for (bool use_cvm : {true, false}) {
+    auto attr =
+        MakeAttr(funcs::EmbSeqPoolCVMType::kSum, use_cvm, width, int64_t(-1));
+    auto out = FusedSeqpoolCvm(x, cvm, attr);
+    for (size_t slot = 0; slot < x.size(); ++slot) {
+      EXPECT_EQ(out[slot].dims(), common::make_ddim({8, attr.out_width()}));
+      ExpectNear(out[slot], Reference(embeddings[slot], batches[slot], attr));
+    }
+  }
+}
+
+// fused_embedding_seqpool_cvm pools the sequences of the last level of lod,
+// like sequence_pool and fused_seqpool_cvm on CPU, so the pass may replace
+// either of them.
+TEST(embedding_seqpool_cvm, fused_embedding_seqpool_cvm_lod) {
+  int64_t height = 50;
+  int64_t width = 5;
+  std::mt19937 rng(4);
+  std::uniform_real_distribution<float> dist(0.f, 1.f);
+  std::vector<float> table(height * width);
+  for (auto& v : table) {
+    v = dist(rng);
+  }
+  auto w = MakeTensor<float>({height, width}, table, {});
+  Batch batch = RandomBatch(6, 4, height, 5);
+  int64_t num_ids = batch.ids.size();
+  auto attr =
+      MakeAttr(funcs::EmbSeqPoolCVMType::kAvg, false, width, int64_t(-1));
+
+  // One level.
+  auto ids = MakeTensor<int64_t>({num_ids}, batch.ids, {batch.lod});
+  auto out = FusedEmbeddingSeqpoolCvm({ids}, w, attr, "AVERAGE");
+  EXPECT_EQ(out[0].dims(), common::make_ddim({6, attr.out_width()}));
+  EXPECT_TRUE(out[0].lod().empty());
+  ExpectNear(out[0], Reference(table, batch, attr));
+
+  // Two levels: the first one groups the 6 sequences into 2 and is kept.
+  std::vector<size_t> top_level = {0, 2, 6};
+  auto nested_ids =
+      MakeTensor<int64_t>({num_ids}, batch.ids, {top_level, batch.lod});
+  out = FusedEmbeddingSeqpoolCvm({nested_ids}, w, attr, "AVERAGE");
+  EXPECT_EQ(out[0].dims(), common::make_ddim({6, attr.out_width()}));
+  ASSERT_EQ(out[0].lod().size(), 1UL);
+  EXPECT_EQ(out[0].lod()[0], top_level);
+  ExpectNear(out[0], Reference(table, batch, attr));
+
+  // fused_seqpool_cvm agrees on the gathered embeddings of the same lod.
+  std::vector<float> gathered;
+  for (auto id : batch.ids) {
+    gathered.insert(gathered.end(),
+                    table.begin() + id * width,
+                    table.begin() + (id + 1) * width);
+  }
+  auto emb =
+      MakeTensor<float>({num_ids, width}, gathered, {top_level, batch.lod});
+  auto cvm = MakeTensor<float>({6, 2}, std::vector<float>(12, 1.f), {});
+  auto sum_attr =
+      MakeAttr(funcs::EmbSeqPoolCVMType::kSum, true, width, int64_t(-1));
+  auto pooled = FusedSeqpoolCvm({emb}, cvm, sum_attr);
+  out = FusedEmbeddingSeqpoolCvm({nested_ids}, w, sum_attr, "SUM");
+  ASSERT_EQ(pooled[0].dims(), out[0].dims());
+  EXPECT_EQ(pooled[0].lod(), out[0].lod());
+  const float* pooled_data = pooled[0].data<float>();
+  ExpectNear(out[0],
+             std::vector<float>(pooled_data, pooled_data + pooled[0].numel()));
+
+  // Without lod, every id is a sequence.
+  Batch single = batch;
+  single.lod.resize(num_ids + 1);
+  for (int64_t i = 0; i <= num_ids; ++i) {
+    single.lod[i] = i;
+  }
+  auto flat_ids = MakeTensor<int64_t>({num_ids}, batch.ids, {});
+  out = FusedEmbeddingSeqpoolCvm({flat_ids}, w, attr, "AVERAGE");
+  EXPECT_EQ(out[0].dims(), common::make_ddim({num_ids, attr.out_width()}));
+  ExpectNear(out[0], Reference(table, single, attr));
+}
+
+// Fused lookup and pooling of 26 slots against a gather then pool.
+TEST(DISABLED_embedding_seqpool_cvm, benchmark) {
+  int64_t height = 1 << 20;
+  int64_t width = 16;
+  std::vector<float> table(height * width, 0.5f);
+  std::vector<Batch> batches;
+  for (int slot = 0; slot < 26; ++slot) {
+    batches.push_back(RandomBatch(512, 30, height, slot + 10));
+  }
+  auto attr =
+      MakeAttr(funcs::EmbSeqPoolCVMType::kSum, true, width, int64_t(-1));
+  phi::tests::Timer timer;
+
+  timer.tic();
+  for (const auto& batch : batches) {
+    Reference(table, batch, attr);
+  }
+  double unfused_ms = timer.toc();
+  timer.tic();
+  RunSlots(table, nullptr, height, batches, attr);
+  double fused_ms = timer.toc();
+  LOG(INFO) << batches.size() << " slots: gather then pool " << unfused_ms
+            << "ms, fused " << fused_ms << "ms.";
+}
+
+}  // namespace tests
+}  // namespace phi
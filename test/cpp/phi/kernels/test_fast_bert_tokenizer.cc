@@ -0,0 +1,780 @@
+/* Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "glog/logging.h"
+#include "gtest/gtest.h"
+#include "paddle/phi/common/port.h"
+#include "paddle/phi/kernels/funcs/fast_bert_tokenizer.h"
+
+namespace phi {
+namespace tests {
+
+inline double GetCurrentUS() {
+  struct timeval time = {};
+  gettimeofday(&time, nullptr);
+  return 1e+6 * time.tv_sec + time.tv_usec;  // NOLINT
+}
+
+// The std::wstring based BERT tokenizer used by faster_tokenizer before the
+// trie based FastBertTokenizer, kept here as the reference the fast one is
+// tested and benchmarked against.
+
+using funcs::IsChineseChar;
+using funcs::IsControl;
+using funcs::IsPunctuation;
+using funcs::IsWhiteSpace;
+
+using InvVocab = std::unordered_map<int, std::wstring>;
+
+class BasicTokenizer {
+ public:
+  explicit BasicTokenizer(bool do_lower_case = true);
+  void Tokenize(const std::string& text, std::vector<std::wstring>* res) const;
+
+ private:
+  wchar_t do_lower_case(wchar_t ch) const;
+
+  bool do_lower_case_;
+};
+
+class WordPieceTokenizer {
+ public:
+  explicit WordPieceTokenizer(const Vocab* vocab,
+                              const std::wstring& unk_token = L"[UNK]",
+                              const size_t max_input_chars_per_word = 100);
+  void Tokenize(const std::wstring& text, std::vector<int64_t>* output) const;
+
+ private:
+  const Vocab* vocab_;
+  std::wstring unk_token_{L"[UNK]"};
+  int64_t unk_token_id_;
+  size_t max_input_chars_per_word_;
+};
+
+class BertTokenizer {
+ public:
+  explicit BertTokenizer(const Vocab* vocab,
+                         bool do_lower_case = false,
+                         const std::wstring& unk_token = L"[UNK]",
+                         const std::wstring& pad_token = L"[PAD]",
+                         const std::wstring& cls_token = L"[CLS]",
+                         const std::wstring& mask_token = L"[MASK]",
+                         const std::wstring& sep_token = L"[SEP]",
+                         const std::string& padding_site = "right");
+
+  void Tokenize(const std::string& text,
+                std::vector<int64_t>* split_tokens) const;
+  void BuildInputsWithSpecialTokens(
+      std::vector<int64_t>* res,
+      const std::vector<int64_t>& token_ids_0,
+      const std::vector<int64_t>& token_ids_1 = std::vector<int64_t>()) const;
+  void CreateTokenTypeIdsFromSequences(
+      std::vector<int64_t>* token_type_ids,
+      const std::vector<int64_t>& token_ids_0,
+      const std::vector<int64_t>& token_ids_1 = std::vector<int64_t>()) const;
+  void TruncateSequence(std::vector<int64_t>* ids,
+                        std::vector<int64_t>* pair_ids,
+                        const size_t num_tokens_to_remove = 0,
+                        const size_t stride = 0) const;
+  int64_t GetNumSpecialTokensToAdd(const bool pair = false) const;
+  int Encode(
+      std::unordered_map<std::string, std::vector<int64_t>>* encoded_inputs,
+      const std::string& text,
+      const std::string& text_pair = "",
+      bool is_split_into_words = false,
+      const size_t max_seq_len = 0,
+      bool pad_to_max_seq_len = false) const;
+  void BatchEncode(
+      std::vector<std::unordered_map<std::string, std::vector<int64_t>>>*
+          batch_encode_inputs,
+      const Strings& batch_text,
+      const Strings& batch_text_pair = Strings(),
+      bool is_split_into_words = false,
+      const size_t max_seq_len = 0,
+      bool pad_to_max_seq_len = false) const;
+
+  int64_t GetPadTokenID() const;
+
+ private:
+  bool do_lower_case_;
+  std::wstring unk_token_, pad_token_, cls_token_, mask_token_, sep_token_;
+  std::string padding_site_;
+  const Vocab* vocab_;
+  BasicTokenizer basic_tokenizer_;
+  WordPieceTokenizer word_piece_tokenizer_;
+  int64_t unk_token_id_, cls_token_id_, mask_token_id_, pad_token_id_,
+      sep_token_id_;
+  std::vector<std::wstring> all_special_tokens_;
+  std::unordered_set<int64_t> all_special_token_ids_;
+  InvVocab inv_vocab_;
+};
+
+BasicTokenizer::BasicTokenizer(bool do_lower_case /* = true */)
+    : do_lower_case_(do_lower_case) {}
+
+wchar_t BasicTokenizer::do_lower_case(wchar_t ch) const {
+  wchar_t new_ch = utf8proc_tolower(ch);
+  return new_ch;
+}
+
+void BasicTokenizer::Tokenize(const std::string& text,
+                              std::vector<std::wstring>* res) const {
+  std::wstring unicode_text;
+  bool status = ConvertStrToWstr(text, &unicode_text);
+  if (!status) {
+    // String is converted into std::wstring failedly.
+    return;
+  }
+  std::wstring cache_text = L"";
+  auto PushCacheText = [&]() {
+    if (!cache_text.empty()) {
+      res->emplace_back(cache_text);
+      cache_text = L"";
+    }
+  };
+  for (auto& ch : unicode_text) {
+    if (ch == 0 || ch == 0xfffd || IsControl(ch)) {
+      continue;
+    }
+    if (do_lower_case_) {
+      ch = do_lower_case(ch);
+    }
+    if (IsChineseChar(ch) || IsPunctuation(ch)) {
+      PushCacheText();
+      res->emplace_back(std::wstring{ch});
+    } else if (IsWhiteSpace(ch)) {
+      PushCacheText();
+    } else {
+      cache_text += ch;
+    }
+  }
+  PushCacheText();
+}
+
+WordPieceTokenizer::WordPieceTokenizer(
+    const Vocab* vocab,
+    const std::wstring& unk_token /* = L"[UNK]"*/,
+    const size_t max_input_chars_per_word /* = 100 */)
+    : vocab_(vocab),
+      unk_token_(unk_token),
+      max_input_chars_per_word_(max_input_chars_per_word) {
+  unk_token_id_ = vocab_->at(unk_token_);
+}
+
+void WordPieceTokenizer::Tokenize(const std::wstring& text,
+                                  std::vector<int64_t>* token_ids) const {
+  size_t len = text.size();
+  if (len > max_input_chars_per_word_) {
+    token_ids->emplace_back(unk_token_id_);
+    return;
+  }
+
+  auto it = vocab_->find(text);
+  if (it != vocab_->end()) {
+    token_ids->emplace_back(it->second);
+    return;
+  }
+
+  size_t start = 0;
+  std::vector<int64_t> wordpiece_ids;
+  while (start < len) {
+    size_t end = len;
+    std::wstring cur_substr;
+    int64_t cur_substr_id = 0;
+    while (start < end) {
+      std::wstring sub = text.substr(start, end - start);
+      if (start > 0) {
+        sub.insert(0, L"##");
+      }
+      auto it = vocab_->find(sub);
+      if (it != vocab_->end()) {
+        cur_substr = sub;
+        cur_substr_id = it->second;
+        break;
+      }
+      end -= 1;
+    }
+
+    if (cur_substr.empty()) {
+      token_ids->emplace_back(unk_token_id_);
+      return;
+    } else {
+      start = end;
+      wordpiece_ids.emplace_back(cur_substr_id);
+    }
+  }
+  for (auto& token_id : wordpiece_ids) {
+    token_ids->emplace_back(token_id);
+  }
+}
+
+BertTokenizer::BertTokenizer(const Vocab* vocab,
+                             bool do_lower_case /* = false */,
+                             const std::wstring& unk_token /* = L"[UNK]" */,
+                             const std::wstring& pad_token /* = L"[PAD]" */,
+                             const std::wstring& cls_token /* = L"[CLS]" */,
+                             const std::wstring& mask_token /* = L"[MASK]" */,
+                             const std::wstring& sep_token /* = L"[SEP]" */,
+                             const std::string& padding_site /* = "right" */)
+    : do_lower_case_(do_lower_case),
+      unk_token_(unk_token),
+      pad_token_(pad_token),
+      cls_token_(cls_token),
+      mask_token_(mask_token),
+      sep_token_(sep_token),
+      padding_site_(padding_site),
+      vocab_(vocab),
+      basic_tokenizer_(do_lower_case_),
+      word_piece_tokenizer_(vocab_, unk_token) {
+  unk_token_id_ = vocab_->at(unk_token_);
+  pad_token_id_ = vocab_->at(pad_token_);
+  cls_token_id_ = vocab_->at(cls_token_);
+  mask_token_id_ = vocab_->at(mask_token_);
+  sep_token_id_ = vocab_->at(sep_token_);
+
+  all_special_tokens_ = std::vector<std::wstring>(
+      {unk_token_, pad_token_, cls_token_, mask_token_, sep_token_});
+  all_special_token_ids_ = std::unordered_set<int64_t>({unk_token_id_,
+                                                        pad_token_id_,
+                                                        cls_token_id_,
+                                                        mask_token_id_,
+                                                        sep_token_id_});
+}
+
+void BertTokenizer::Tokenize(const std::string& text,
+                             std::vector<int64_t>* split_token_ids) const {
+  std::vector<std::wstring> tmp_tokens;
+  basic_tokenizer_.Tokenize(text, &tmp_tokens);
+  if (tmp_tokens.empty()) return;
+  split_token_ids->reserve(tmp_tokens.size());
+  for (auto& w_token : tmp_tokens) {
+    const auto& vec_size = w_token.size();
+    if (vec_size == 1) {
+      if (IsChineseChar(w_token[0])) {
+        auto vocab_it = vocab_->find(w_token);
+        if (vocab_it != vocab_->end()) {
+          split_token_ids->emplace_back(vocab_it->second);
+        } else {
+          split_token_ids->emplace_back(unk_token_id_);
+        }
+      } else {
+        word_piece_tokenizer_.Tokenize(w_token, split_token_ids);
+      }
+    } else if (vec_size > 1) {
+      word_piece_tokenizer_.Tokenize(w_token, split_token_ids);
+    } else {
+      continue;
+    }
+  }
+}
+
+void BertTokenizer::BuildInputsWithSpecialTokens(
+    std::vector<int64_t>* inputs,
+    const std::vector<int64_t>& token_ids_0,
+    const std::vector<int64_t>& token_ids_1 /* = vector<int64_t>() */) const {
+  if (token_ids_1.empty()) {
+    inputs->clear();
+    inputs->resize(token_ids_0.size() + 2);
+    inputs->at(0) = cls_token_id_;
+    size_t i = 1;
+    for (auto& token_id : token_ids_0) {
+      inputs->at(i) = token_id;
+      ++i;
+    }
+    inputs->at(i) = sep_token_id_;
+  } else {
+    inputs->clear();
+    inputs->resize(token_ids_0.size() + token_ids_1.size() + 3);
+    inputs->at(0) = cls_token_id_;
+    size_t i = 1;
+    for (auto& token_id : token_ids_0) {
+      inputs->at(i) = token_id;
+      ++i;
+    }
+    inputs->at(i) = sep_token_id_;
+    ++i;
+    for (auto& token_id : token_ids_1) {
+      inputs->at(i) = token_id;
+      ++i;
+    }
+    inputs->at(i) = sep_token_id_;
+  }
+}
+
+int64_t BertTokenizer::GetNumSpecialTokensToAdd(const bool pair) const {
+  if (pair) {
+    return 3;
+  } else {
+    return 2;
+  }
+}
+
+void BertTokenizer::CreateTokenTypeIdsFromSequences(
+    std::vector<int64_t>* token_type_ids,
+    const std::vector<int64_t>& token_ids_0,
+    const std::vector<int64_t>& token_ids_1 /* = vector<int64_t>() */) const {
+  if (token_ids_1.empty()) {
+    std::vector<int64_t> tmp(token_ids_0.size() + 2, 0);
+    token_type_ids->swap(tmp);
+  } else {
+    std::vector<int64_t> tmp(token_ids_0.size() + token_ids_1.size() + 3, 0);
+    for (size_t i = token_ids_0.size() + 2; i < tmp.size(); i++) {
+      tmp[i] = 1;
+    }
+    token_type_ids->swap(tmp);
+  }
+}
+
+void BertTokenizer::TruncateSequence(
+    std::vector<int64_t>* ids,
+    std::vector<int64_t>* pair_ids,
+    const size_t num_tokens_to_remove /* = 0 */,
+    const size_t stride /* = 0 */) const {
+  for (size_t i = 0; i < num_tokens_to_remove; i++) {
+    if ((pair_ids->empty()) || (ids->size() > pair_ids->size())) {
+      ids->pop_back();
+    } else {
+      pair_ids->pop_back();
+    }
+  }
+}
+
+int64_t BertTokenizer::GetPadTokenID() const { return pad_token_id_; }
+
+int BertTokenizer::Encode(
+    std::unordered_map<std::string, std::vector<int64_t>>* encoded_inputs,
+    const std::string& text,
+    const std::string& text_pair /* = "" */,
+    bool is_split_into_words /* = false */,
+    const size_t max_seq_len /* = 0 */,
+    bool pad_to_max_seq_len /* = false */) const {
+  std::vector<int64_t> ids;
+  std::vector<int64_t> pair_ids;
+  if (!is_split_into_words) {
+    Tokenize(text, &ids);
+    if (ids.empty()) return 0;
+    if (!text_pair.empty()) {
+      Tokenize(text_pair, &pair_ids);
+      if (pair_ids.empty()) return 0;
+    }
+  } else {
+    std::wstring unicode_text;
+    bool status_a = ConvertStrToWstr(text, &unicode_text);
+    if (!status_a) {
+      return 0;
+    }
+    for (size_t i = 0; i < unicode_text.size(); i++) {
+      std::wstring token = unicode_text.substr(i, 1);
+      auto it = vocab_->find(token);
+      if (it != vocab_->end()) {
+        ids.emplace_back(it->second);
+      } else {
+        ids.emplace_back(unk_token_id_);
+      }
+    }
+  }
+
+  bool pair = false;
+  if (!pair_ids.empty()) {
+    pair = true;
+  }
+
+  size_t len_ids = ids.size();
+  size_t len_pair_ids = pair_ids.size();
+
+  // Truncation: Handle max sequence length
+  // If max_seq_len == 0, then do nothing and keep the real length.
+  // If max_seq_len > 0 and
+  // all the input sequence len is over the max_seq_len,
+  // then we truncate it.
+  size_t total_len = len_ids + len_pair_ids + GetNumSpecialTokensToAdd(pair);
+  if (max_seq_len > 0 && total_len > max_seq_len) {
+    TruncateSequence(&ids, &pair_ids, total_len - max_seq_len);
+  }
+
+  // Add special tokens
+  std::vector<int64_t> sequence;
+  BuildInputsWithSpecialTokens(&sequence, ids, pair_ids);
+  size_t seq_len = sequence.size();
+  std::vector<int64_t> token_type_ids;
+  CreateTokenTypeIdsFromSequences(&token_type_ids, ids, pair_ids);
+
+  // Build output dictionary
+  encoded_inputs->emplace("input_ids", sequence);
+  encoded_inputs->emplace("token_type_ids", token_type_ids);
+  // Check lengths
+  if (max_seq_len > 0 && seq_len > max_seq_len) {
+    VLOG(3) << "There is something wrong with the input sequence length."
+               " Please check it.";
+    // Failed.
+    return 0;
+  }
+
+  // Padding
+  bool needs_to_be_padded = false;
+  if (pad_to_max_seq_len && max_seq_len > 0 && (seq_len < max_seq_len)) {
+    needs_to_be_padded = true;
+  }
+
+  if (needs_to_be_padded) {
+    int64_t difference = static_cast<int64_t>(max_seq_len - seq_len);
+    size_t pad_start = max_seq_len - 1 - difference;
+    encoded_inputs->at("token_type_ids").resize(max_seq_len);
+    for (size_t i = max_seq_len - 1; i > pad_start; i--) {
+      encoded_inputs->at("token_type_ids")[i] = pad_token_id_;
+    }
+
+    encoded_inputs->at("input_ids").resize(max_seq_len);
+    for (size_t i = max_seq_len - 1; i > pad_start; i--) {
+      encoded_inputs->at("input_ids")[i] = pad_token_id_;
+    }
+  }
+  return 1;
+}
+
+void BertTokenizer::BatchEncode(
+    std::vector<std::unordered_map<std::string, std::vector<int64_t>>>*
+        batch_encode_inputs,
+    const Strings& batch_text,
+    const Strings& batch_text_pair /* = std::vector<std::string>() */,
+    bool is_split_into_words /* = false */,
+    const size_t max_seq_len /* = 0 */,
+    bool pad_to_max_seq_len /* = false */) const {
+  bool has_text_pair = false;
+  if (batch_text_pair.size() != 0) {
+    has_text_pair = true;
+  }
+
+  size_t batch_size = batch_text.size();
+#ifdef PADDLE_WITH_MKLML
+#pragma omp parallel for
+#endif
+  for (size_t i = 0; i < batch_size; i++) {
+    std::unordered_map<std::string, std::vector<int64_t>> res;
+    if (has_text_pair) {
+      auto status = Encode(&res,
+                           batch_text[i],
+                           batch_text_pair[i],
+                           is_split_into_words,
+                           max_seq_len,
+                           pad_to_max_seq_len);
+      if (!status) {
+        res["input_ids"] =
+            std::vector<int64_t>{cls_token_id_, sep_token_id_, cls_token_id_};
+        res["token_type_ids"] = std::vector<int64_t>{0, 0, 1};
+      }
+    } else {
+      auto status = Encode(&res,
+                           batch_text[i],
+                           {},
+                           is_split_into_words,
+                           max_seq_len,
+                           pad_to_max_seq_len);
+
+      if (!status) {
+        res["input_ids"] = std::vector<int64_t>{cls_token_id_, sep_token_id_};
+        res["token_type_ids"] = std::vector<int64_t>{0, 0};
+      }
+    }
+    batch_encode_inputs->at(i) = std::move(res);
+  }
+}
+
+using Matrix = std::vector<std::vector<int64_t>>;
+
+Vocab MakeVocab(const std::vector<std::wstring>& tokens) {
+  Vocab vocab;
+  int32_t id = 0;
+  for (auto& token : {L"[PAD]", L"[UNK]", L"[CLS]", L"[SEP]", L"[MASK]"}) {
+    vocab.emplace(token, id++);
+  }
+  for (auto& token : tokens) {
+    vocab.emplace(token, id++);
+  }
+  return vocab;
+}
+
+Vocab MakeTestVocab() {
+  std::vector<std::wstring> tokens = {
+      L"the", L"quick", L"brown", L"fox", L"jump", L"##s", L"##ed",
+      L"##ing", L"un", L"##aff", L"##able", L"run", L"##ning", L"play",
+      L"##er", L"café", L"é", L"##é", L"中", L"国", L"人", L",", L".",
+      L"!", L"?", L"\u00b6", L"a b", L"##"};
+  // Every letter but 'q' is a token, so most words can be split.
+  for (wchar_t ch = L'a'; ch <= L'z'; ++ch) {
+    if (ch == L'q') continue;
+    tokens.emplace_back(1, ch);
+    tokens.emplace_back(std::wstring(L"##") + ch);
+  }
+  return MakeVocab(tokens);
+}
+
+std::string RandomText(std::mt19937* rng) {
+  static const std::vector<std::string> pieces = {"the",
+                                                  "The",
+                                                  "QUICK",
+                                                  "brown",
+                                                  "foxes",
+                                                  "jumped",
+                                                  "unaffable",
+                                                  "running",
+                                                  "player",
+                                                  "Café",
+                                                  "CAFÉ",
+                                                  "éa",
+                                                  "中国人",
+                                                  "好",
+                                                  ",",
+                                                  ".",
+                                                  "!?",
+                                                  "qq",
+                                                  "Aquarium",
+                                                  "a##b",
+                                                  "x",
+                                                  "\t",
+                                                  "\n",
+                                                  "  ",
+                                                  "\xc2\xa0",  // NBSP
+                                                  "\x01",
+                                                  "\xe2\x80\x8b",  // ZWSP
+                                                  "\xe3\x80\x82",
+                                                  "\xc2\xb6",
+                                                  "\xef\xbf\xbd",
+                                                  std::string(120, 'a'),
+                                                  std::string(100, 'b')};
+  std::uniform_int_distribution<size_t> piece(0, pieces.size() - 1);
+  std::uniform_int_distribution<int> num_pieces(0, 24);
+  std::uniform_int_distribution<int> space(0, 2);
+  std::string text;
+  for (int i = num_pieces(*rng); i > 0; --i) {
+    text += pieces[piece(*rng)];
+    if (space(*rng) != 0) text += ' ';
+  }
+  return text;
+}
+
+Matrix ToMatrix(const std::vector<std::vector<int64_t>>& rows, int64_t pad) {
+  size_t max_len = 0;
+  for (auto& row : rows) max_len = std::max(max_len, row.size());
+  Matrix result(rows);
+  for (auto& row : result) row.resize(max_len, pad);
+  return result;
+}
+
+// Runs the reference tokenizer, returns the input ids and segment ids.
+std::pair<Matrix, Matrix> RunReference(const Vocab& vocab,
+                                       const Strings& text,
+                                       const Strings& text_pair,
+                                       bool do_lower_case,
+                                       bool is_split_into_words,
+                                       size_t max_seq_len,
+                                       bool pad_to_max_seq_len) {
+  BertTokenizer tokenizer(&vocab, do_lower_case);
+  std::vector<std::unordered_map<std::string, std::vector<int64_t>>> batch(
+      text.size());
+  tokenizer.BatchEncode(&batch,
+                        text,
+                        text_pair,
+                        is_split_into_words,
+                        max_seq_len,
+                        pad_to_max_seq_len);
+  std::vector<std::vector<int64_t>> ids, seg_ids;
+  for (auto& encoded : batch) {
+    ids.push_back(encoded["input_ids"]);
+    seg_ids.push_back(encoded["token_type_ids"]);
+  }
+  int64_t pad = tokenizer.GetPadTokenID();
+  return {ToMatrix(ids, pad), ToMatrix(seg_ids, pad)};
+}
+
+std::pair<Matrix, Matrix> RunFast(const Vocab& vocab,
+                                  const Strings& text,
+                                  const Strings& text_pair,
+                                  bool do_lower_case,
+                                  bool is_split_into_words,
+                                  size_t max_seq_len,
+                                  bool pad_to_max_seq_len) {
+  funcs::FastBertTokenizer tokenizer(&vocab, do_lower_case);
+  std::vector<funcs::EncodedSequence> batch;
+  tokenizer.BatchEncode(&batch,
+                        text,
+                        text_pair,
+                        is_split_into_words,
+                        max_seq_len,
+                        pad_to_max_seq_len);
+  int64_t pad = tokenizer.GetPadTokenID();
+  std::vector<std::vector<int64_t>> ids, seg_ids;
+  for (auto& encoded : batch) {
+    std::vector<int64_t> row = encoded.ids;
+    row.resize(encoded.padded_len, pad);
+    ids.push_back(row);
+    std::vector<int64_t> seg(encoded.padded_len, pad);
+    for (size_t i = 0; i < encoded.ids.size(); ++i) {
+      seg[i] = i < encoded.first_segment_len ? 0 : 1;
+    }
+    seg_ids.push_back(seg);
+  }
+  return {ToMatrix(ids, pad), ToMatrix(seg_ids, pad)};
+}
+
+TEST(FastBertTokenizer, trie) {
+  Vocab vocab = MakeTestVocab();
+  funcs::WordPieceTrie trie(vocab);
+  for (auto& item : vocab) {
+    std::string token;
+    ConvertWstrToStr(item.first, &token);
+    EXPECT_EQ(trie.Find(token.data(), token.size()), item.second);
+  }
+  EXPECT_EQ(trie.Find("jum", 3), -1);
+  EXPECT_EQ(trie.Find("jumps", 5), -1);
+  EXPECT_EQ(trie.Find("", 0), -1);
+  EXPECT_GE(trie.SuffixRoot(), 0);
+  // The trie is built once per vocab.
+  auto cached = funcs::WordPieceTrie::Get(vocab);
+  EXPECT_EQ(funcs::WordPieceTrie::Get(vocab).get(), cached.get());
+  // Another vocab assigned to the same variable rebuilds it.
+  Vocab other = MakeTestVocab();
+  std::swap(other.find(L"y")->second, other.find(L"z")->second);
+  other.emplace(L"jum", static_cast<int32_t>(other.size()));
+  vocab = other;
+  EXPECT_NE(funcs::WordPieceTrie::Get(vocab).get(), cached.get());
+  EXPECT_EQ(funcs::WordPieceTrie::Get(vocab)->Find("y", 1),
+            cached->Find("z", 1));
+  EXPECT_EQ(funcs::WordPieceTrie::Get(vocab)->Find("jum", 3),
+            static_cast<int32_t>(vocab.size()) - 1);
+}
+
+TEST(FastBertTokenizer, same_as_reference) {
+  Vocab vocab = MakeTestVocab();
+  std::mt19937 rng(2024);
+  Strings text, text_pair;
+  for (int i = 0; i < 200; ++i) {
+    text.push_back(RandomText(&rng));
+    text_pair.push_back(RandomText(&rng));
+  }
+  text.push_back("");
+  text_pair.push_back("the fox");
+  text.push_back("\xff invalid utf-8");
+  text_pair.push_back("");
+  text.push_back("jumps");
+  text_pair.push_back(" \t ");
+
+  for (bool do_lower_case : {false, true}) {
+    for (bool is_split_into_words : {false, true}) {
+      for (bool with_pair : {false, true}) {
+        for (size_t max_seq_len : {0, 3, 5, 8, 64}) {
+          for (bool pad_to_max_seq_len : {false, true}) {
+            const Strings& pair = with_pair ? text_pair : Strings();
+            auto ref = RunReference(vocab,
+                                    text,
+                                    pair,
+                                    do_lower_case,
+                                    is_split_into_words,
+                                    max_seq_len,
+                                    pad_to_max_seq_len);
+            auto fast = RunFast(vocab,
+                                text,
+                                pair,
+                                do_lower_case,
+                                is_split_into_words,
+                                max_seq_len,
+                                pad_to_max_seq_len);
+            ASSERT_EQ(ref.first, fast.first)
+                << "do_lower_case=" << do_lower_case
+                << " is_split_into_words=" << is_split_into_words
+                << " with_pair=" << with_pair
+                << " max_seq_len=" << max_seq_len;
+            ASSERT_EQ(ref.second, fast.second);
+          }
+        }
+      }
+    }
+  }
+}
+
+TEST(FastBertTokenizer, benchmark) {
+  // A vocabulary about the size of bert-base with random pieces.
+  std::mt19937 rng(7);
+  std::uniform_int_distribution<int> letter(0, 25);
+  std::uniform_int_distribution<int> length(1, 8);
+  std::vector<std::wstring> tokens;
+  for (int i = 0; i < 30000; ++i) {
+    std::wstring token = i % 2 == 0 ? L"" : L"##";
+    for (int j = length(rng); j > 0; --j) {
+      token += static_cast<wchar_t>(L'a' + letter(rng));
+    }
+    tokens.push_back(token);
+  }
+  Vocab vocab = MakeVocab(tokens);
+
+  Strings text;
+  for (int i = 0; i < 256; ++i) {
+    std::string line;
+    for (int w = 0; w < 32; ++w) {
+      for (int j = length(rng); j > 0; --j) {
+        line += static_cast<char>('A' + letter(rng));
+      }
+      line += w % 8 == 7 ? ". " : " ";
+    }
+    text.push_back(line);
+  }
+
+  // The first call builds the trie.
+  RunFast(vocab, text, Strings(), true, false, 128, true);
+  const int repeat = 5;
+  double start = GetCurrentUS();
+  for (int i = 0; i < repeat; ++i) {
+    RunReference(vocab, text, Strings(), true, false, 128, true);
+  }
+  double ref_us = (GetCurrentUS() - start) / repeat;
+  start = GetCurrentUS();
+  for (int i = 0; i < repeat; ++i) {
+    RunFast(vocab, text, Strings(), true, false, 128, true);
+  }
+  double fast_us = (GetCurrentUS() - start) / repeat;
+  VLOG(3) << "Tokenize " << text.size() << " texts: reference " << ref_us
+          << " us, fast " << fast_us << " us";
+  EXPECT_EQ(RunReference(vocab, text, Strings(), true, false, 128, true),
+            RunFast(vocab, text, Strings(), true, false, 128, true));
+
+  // A single short text, where looking up the cached trie must not cost more
+  // than tokenizing.
+  Strings short_text;
+  short_text.push_back("Hello, world.");
+  const int short_repeat = 1000;
+  start = GetCurrentUS();
+  for (int i = 0; i < short_repeat; ++i) {
+    RunReference(vocab, short_text, Strings(), true, false, 128, false);
+  }
+  ref_us = (GetCurrentUS() - start) / short_repeat;
+  start = GetCurrentUS();
+  for (int i = 0; i < short_repeat; ++i) {
+    RunFast(vocab, short_text, Strings(), true, false, 128, false);
+  }
+  fast_us = (GetCurrentUS() - start) / short_repeat;
+  VLOG(3) << "Tokenize one short text: reference " << ref_us << " us, fast "
+          << fast_us << " us";
+  EXPECT_EQ(RunReference(vocab, short_text, Strings(), true, false, 128, false),
+            RunFast(vocab, short_text, Strings(), true, false, 128, false));
+}
+
+}  // namespace tests
+}  // namespace phi
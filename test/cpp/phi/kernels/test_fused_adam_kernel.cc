@@ -488,6 +488,20 @@ TEST(fused_adam, test_fp32_cpu) {
   }
 }
 
+TEST(fused_adam, test_fp32_cpu_multi_chunks) {
+  // Tensors smaller than, equal to and spanning several CPU chunks.
+  auto shapes = GenerateRandomShapes(20, 1, 4096);
+  shapes.push_back({512});
+  shapes.push_back({513});
+  shapes.push_back({100000});
+  float atol = 0.0f;
+  for (auto use_adamw : {false, true}) {
+    for (auto amsgrad : {false, true}) {
+      TestFusedAdamBase<float, CPUPlace>(shapes, atol, use_adamw, amsgrad);
+    }
+  }
+}
+
 #ifdef PADDLE_WITH_CUDA
 TEST(fused_adam, test_fp32_gpu) {
   auto shapes = GenerateRandomShapes(40, 0, 2 << 18);
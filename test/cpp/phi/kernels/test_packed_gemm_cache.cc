@@ -0,0 +1,151 @@
+/* Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "paddle/phi/backends/context_pool.h"
+#include "paddle/phi/kernels/funcs/packed_gemm_cache.h"
+
+namespace phi {
+namespace tests {
+
+template <typename T>
+void RandomFill(T* data, int64_t size, uint64_t seed) {
+  std::mt19937_64 rng(seed);
+  std::uniform_real_distribution<T> dist(-1, 1);
+  for (int64_t i = 0; i < size; ++i) {
+    data[i] = dist(rng);
+  }
+}
+
+template <typename T>
+std::vector<T> Reference(const T* x,
+                         const T* w,
+                         const T* out,
+                         int m,
+                         int n,
+                         int k,
+                         bool trans_w,
+                         T beta) {
+  std::vector<T> ref(m * n);
+  for (int i = 0; i < m; ++i) {
+    for (int j = 0; j < n; ++j) {
+      T sum = 0;
+      for (int l = 0; l < k; ++l) {
+        sum += x[i * k + l] * (trans_w ? w[j * k + l] : w[l * n + j]);
+      }
+      ref[i * n + j] = sum + beta * out[i * n + j];
+    }
+  }
+  return ref;
+}
+
+template <typename T>
+void TestPackedGemm(int m, int n, int k, bool trans_w, T beta) {
+  const auto& ctx = *static_cast<const CPUContext*>(
+      DeviceContextPool::Instance().Get(CPUPlace()));
+  DenseTensor x, w, out;
+  x.Resize({m, k});
+  w.Resize(trans_w ? common::make_ddim({n, k}) : common::make_ddim({k, n}));
+  out.Resize({m, n});
+  T* x_data = ctx.template Alloc<T>(&x);
+  T* w_data = ctx.template Alloc<T>(&w);
+  T* out_data = ctx.template Alloc<T>(&out);
+  RandomFill(x_data, x.numel(), m);
+  RandomFill(w_data, w.numel(), n);
+  RandomFill(out_data, out.numel(), k);
+  auto ref = Reference(x_data, w_data, out_data, m, n, k, trans_w, beta);
+
+  auto& cache = funcs::PackedWeightCache::Instance();
+  cache.Clear();
+  // Not registered, so it is not packed.
+  EXPECT_FALSE(funcs::PackedGemm(
+      ctx, m, n, k, x_data, w, trans_w, beta, out_data));
+  EXPECT_EQ(cache.Size(), 0UL);
+
+  cache.RegisterConstant(w);
+  for (int run = 0; run < 2; ++run) {
+    std::vector<T> init(out_data, out_data + out.numel());
+    ASSERT_TRUE(funcs::PackedGemm(
+        ctx, m, n, k, x_data, w, trans_w, beta, out_data));
+    EXPECT_EQ(cache.Size(), 1UL);
+    for (int64_t i = 0; i < out.numel(); ++i) {
+      ASSERT_NEAR(out_data[i], ref[i], 1e-4) << i;
+    }
+    // The second run uses the cached packed weight on the same out.
+    std::copy(init.begin(), init.end(), out_data);
+  }
+
+  // A weight allocated after w is released is not constant, even if it is at
+  // the same address.
+  auto w_dims = w.dims();
+  w.clear();
+  DenseTensor w2;
+  w2.Resize(w_dims);
+  ctx.template Alloc<T>(&w2);
+  EXPECT_FALSE(funcs::PackedGemm(
+      ctx, m, n, k, x_data, w2, trans_w, beta, out_data));
+  cache.Clear();
+}
+
+TEST(PackedGemmCache, fp32) {
+  for (bool trans_w : {false, true}) {
+    for (int m : {1, 3, 4, 16}) {
+      TestPackedGemm<float>(m, 33, 70, trans_w, 0.f);
+      TestPackedGemm<float>(m, 16, 8, trans_w, 1.f);
+    }
+  }
+}
+
+TEST(PackedGemmCache, fp64) {
+  for (bool trans_w : {false, true}) {
+    TestPackedGemm<double>(5, 100, 19, trans_w, 0.);
+    TestPackedGemm<double>(2, 1, 64, trans_w, 1.);
+  }
+}
+
+TEST(PackedGemmCache, released_weights) {
+  const auto& ctx = *static_cast<const CPUContext*>(
+      DeviceContextPool::Instance().Get(CPUPlace()));
+  auto& cache = funcs::PackedWeightCache::Instance();
+  cache.Clear();
+  float x = 1.f, out = 0.f;
+  // The packed copies of released weights are dropped as new ones are packed,
+  // as with predictors created and destroyed again and again.
+  for (int i = 0; i < 4096; ++i) {
+    DenseTensor w;
+    w.Resize({1, 1});
+    *ctx.Alloc<float>(&w) = static_cast<float>(i);
+    cache.RegisterConstant(w);
+    ASSERT_TRUE(funcs::PackedGemm(ctx, 1, 1, 1, &x, w, false, 0.f, &out));
+    ASSERT_EQ(out, static_cast<float>(i));
+  }
+  EXPECT_LE(cache.Size(), 1024UL);
+  cache.Clear();
+}
+
+TEST(PackedGemmCache, unsupported_rows) {
+  // Large GEMMs keep using BLAS with the unpacked weight without MKL.
+#ifndef PADDLE_WITH_MKLML
+  EXPECT_FALSE(funcs::PackedWeight<float>::Suits(
+      funcs::PackedWeight<float>::kMaxPanelRows + 1));
+#endif
+  EXPECT_FALSE(funcs::PackedWeight<float>::Suits(0));
+}
+
+}  // namespace tests
+}  // namespace phi
@@ -0,0 +1,281 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <random>
+#include <vector>
+
+#include "glog/logging.h"
+#include "gtest/gtest.h"
+#include "paddle/phi/backends/context_pool.h"
+#include "paddle/phi/backends/cpu/cpu_context.h"
+#include "paddle/phi/kernels/funcs/radix_sort.h"
+#include "paddle/phi/kernels/funcs/selected_rows_functor.h"
+#include "paddle/phi/kernels/selected_rows/adam_kernel.h"
+#include "test/cpp/phi/core/timer.h"
+
+namespace phi {
+namespace tests {
+
+// Ids following Zipf's law over [0, vocab_size), like the ids of a
+// recommendation or language model batch: a few hot ids repeat a lot, most
+// ids appear at most once.
+std::vector<int64_t> ZipfIds(int64_t vocab_size,
+                             int64_t num,
+                             double skew,
+                             uint64_t seed) {
+  std::vector<double> cdf(vocab_size);
+  double sum = 0;
+  for (int64_t i = 0; i < vocab_size; ++i) {
+    sum += 1.0 / std::pow(static_cast<double>(i + 1), skew);
+    cdf[i] = sum;
+  }
+  std::mt19937_64 rng(seed);
+  std::uniform_real_distribution<double> dist(0, sum);
+  // Scatters the hot ids over the whole table.
+  std::vector<int64_t> permutation(vocab_size);
+  for (int64_t i = 0; i < vocab_size; ++i) {
+    permutation[i] = i;
+  }
+  std::shuffle(permutation.begin(), permutation.end(), rng);
+  std::vector<int64_t> ids(num);
+  for (auto& id : ids) {
+    auto rank = std::lower_bound(cdf.begin(), cdf.end(), dist(rng)) -
+                cdf.begin();
+    id = permutation[std::min<int64_t>(rank, vocab_size - 1)];
+  }
+  return ids;
+}
+
+SelectedRows RandomSelectedRows(const CPUContext& ctx,
+                                const std::vector<int64_t>& rows,
+                                int64_t height,
+                                int64_t width,
+                                uint64_t seed) {
+  SelectedRows selected_rows(rows, height);
+  auto* value = selected_rows.mutable_value();
+  value->Resize({static_cast<int64_t>(rows.size()), width});
+  auto* data = ctx.template Alloc<float>(value);
+  std::mt19937 rng(seed);
+  std::uniform_real_distribution<float> dist(-1.f, 1.f);
+  for (int64_t i = 0; i < value->numel(); ++i) {
+    data[i] = dist(rng);
+  }
+  return selected_rows;
+}
+
+// Merges the rows with an ordered map, the reference of the results and of
+// the timings.
+std::map<int64_t, std::vector<float>> ReferenceMerge(const SelectedRows& in) {
+  int64_t width = in.value().dims()[1];
+  const float* data = in.value().data<float>();
+  std::map<int64_t, std::vector<float>> merged;
+  for (size_t i = 0; i < in.rows().size(); ++i) {
+    auto& row = merged[in.rows()[i]];
+    row.resize(width, 0.f);
+    for (int64_t j = 0; j < width; ++j) {
+      row[j] += data[i * width + j];
+    }
+  }
+  return merged;
+}
+
+const CPUContext& GetCPUContext() {
+  return *static_cast<const CPUContext*>(
+      DeviceContextPool::Instance().Get(CPUPlace()));
+}
+
+TEST(radix_sort, sort_pairs) {
+  std::mt19937_64 rng(0);
+  for (int64_t range : {int64_t(16), int64_t(1) << 20, int64_t(1) << 40}) {
+    std::uniform_int_distribution<int64_t> dist(-range, range);
+    std::vector<int64_t> keys(10000);
+    std::vector<int> values(keys.size());
+    std::vector<std::pair<int64_t, int>> expected(keys.size());
+    for (size_t i = 0; i < keys.size(); ++i) {
+      keys[i] = dist(rng);
+      values[i] = static_cast<int>(i);
+      expected[i] = {keys[i], values[i]};
+    }
+    std::stable_sort(
+        expected.begin(), expected.end(), [](const auto& a, const auto& b) {
+          return a.first < b.first;
+        });
+    funcs::RadixSortPairs(&keys, &values);
+    for (size_t i = 0; i < keys.size(); ++i) {
+      ASSERT_EQ(keys[i], expected[i].first);
+      ASSERT_EQ(values[i], expected[i].second);
+    }
+  }
+}
+
+TEST(selected_rows_merge_add, zipf_ids) {
+  const auto& ctx = GetCPUContext();
+  int64_t height = 100000;
+  int64_t width = 16;
+  auto ids = ZipfIds(height, 20000, 1.1, 1);
+  auto grad = RandomSelectedRows(ctx, ids, height, width, 2);
+  auto expected = ReferenceMerge(grad);
+
+  for (bool sorted_result : {false, true}) {
+    SelectedRows out;
+    funcs::scatter::MergeAdd<CPUContext, float> merge_add;
+    merge_add(ctx, grad, &out, sorted_result);
+    ASSERT_EQ(out.rows().size(), expected.size());
+    ASSERT_TRUE(std::is_sorted(out.rows().begin(), out.rows().end()));
+    const float* out_data = out.value().data<float>();
+    size_t i = 0;
+    for (auto& item : expected) {
+      ASSERT_EQ(out.rows()[i], item.first);
+      for (int64_t j = 0; j < width; ++j) {
+        ASSERT_EQ(out_data[i * width + j], item.second[j]);
+      }
+      ++i;
+    }
+  }
+}
+
+struct AdamState {
+  DenseTensor param;
+  DenseTensor moment1;
+  DenseTensor moment2;
+  DenseTensor beta1_pow;
+  DenseTensor beta2_pow;
+  DenseTensor learning_rate;
+
+  AdamState(const CPUContext& ctx, int64_t height, int64_t width) {
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<float> dist(-1.f, 1.f);
+    for (auto* t : {&param, &moment1, &moment2}) {
+      t->Resize({height, width});
+      auto* data = ctx.template Alloc<float>(t);
+      for (int64_t i = 0; i < t->numel(); ++i) {
+        data[i] = t == &moment2 ? std::abs(dist(rng)) : dist(rng);
+      }
+    }
+    for (auto* t : {&beta1_pow, &beta2_pow, &learning_rate}) {
+      t->Resize({1});
+      ctx.template Alloc<float>(t);
+    }
+    beta1_pow.data<float>()[0] = 0.9f;
+    beta2_pow.data<float>()[0] = 0.999f;
+    learning_rate.data<float>()[0] = 0.01f;
+  }
+
+  void Update(const CPUContext& ctx, const SelectedRows& grad, bool lazy) {
+    DenseTensor moment2_max;
+    sr::AdamDenseParamSparseGradKernel<float, CPUContext>(ctx,
+                                                          param,
+                                                          grad,
+                                                          learning_rate,
+                                                          moment1,
+                                                          moment2,
+                                                          paddle::none,
+                                                          beta1_pow,
+                                                          beta2_pow,
+                                                          paddle::none,
+                                                          paddle::none,
+                                                          0.9f,
+                                                          0.999f,
+                                                          1e-8f,
+                                                          lazy,
+                                                          0,
+                                                          false,
+                                                          false,
+                                                          false,
+                                                          &param,
+                                                          &moment1,
+                                                          &moment2,
+                                                          &moment2_max,
+                                                          &beta1_pow,
+                                                          &beta2_pow,
+                                                          nullptr);
+  }
+};
+
+TEST(sparse_adam, lazy_mode_only_updates_touched_rows) {
+  const auto& ctx = GetCPUContext();
+  int64_t height = 1000;
+  int64_t width = 8;
+  auto grad = RandomSelectedRows(
+      ctx, ZipfIds(height, 500, 1.1, 4), height, width, 5);
+  auto merged = ReferenceMerge(grad);
+
+  AdamState lazy_state(ctx, height, width);
+  AdamState dense_state(ctx, height, width);
+  std::vector<float> old_param(lazy_state.param.data<float>(),
+                               lazy_state.param.data<float>() + height * width);
+  lazy_state.Update(ctx, grad, true);
+  dense_state.Update(ctx, grad, false);
+
+  const float* lazy_param = lazy_state.param.data<float>();
+  const float* dense_param = dense_state.param.data<float>();
+  for (int64_t row = 0; row < height; ++row) {
+    bool touched = merged.count(row) > 0;
+    for (int64_t j = 0; j < width; ++j) {
+      int64_t i = row * width + j;
+      if (touched) {
+        // A touched row is updated the same way in both modes.
+        EXPECT_FLOAT_EQ(lazy_param[i], dense_param[i]);
+      } else {
+        EXPECT_EQ(lazy_param[i], old_param[i]);
+      }
+    }
+  }
+  EXPECT_FLOAT_EQ(lazy_state.beta1_pow.data<float>()[0], 0.9f * 0.9f);
+}
+
+// Cost of one sparse step on Zipf distributed ids.
+TEST(DISABLED_sparse_optimizer, benchmark_zipf) {
+  const auto& ctx = GetCPUContext();
+  int64_t height = 200000;
+  int64_t width = 32;
+  int64_t batch_ids = 65536;
+  phi::tests::Timer timer;
+
+  for (double skew : {0.8, 1.1, 1.4}) {
+    auto grad = RandomSelectedRows(
+        ctx, ZipfIds(height, batch_ids, skew, 6), height, width, 7);
+
+    timer.tic();
+    auto reference = ReferenceMerge(grad);
+    double hash_merge_ms = timer.toc();
+
+    SelectedRows merged;
+    funcs::scatter::MergeAdd<CPUContext, float> merge_add;
+    timer.tic();
+    merge_add(ctx, grad, &merged, true);
+    double sort_merge_ms = timer.toc();
+    EXPECT_EQ(merged.rows().size(), reference.size());
+
+    AdamState state(ctx, height, width);
+    timer.tic();
+    state.Update(ctx, grad, false);
+    double dense_adam_ms = timer.toc();
+    timer.tic();
+    state.Update(ctx, grad, true);
+    double lazy_adam_ms = timer.toc();
+
+    LOG(INFO) << "skew " << skew << ": " << batch_ids << " ids, "
+              << merged.rows().size() << " unique; merge with map "
+              << hash_merge_ms << "ms, sort and segment " << sort_merge_ms
+              << "ms; adam " << dense_adam_ms << "ms, lazy adam "
+              << lazy_adam_ms << "ms.";
+  }
+}
+
+}  // namespace tests
+}  // namespace phi
@@ -0,0 +1,242 @@
+/* Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "glog/logging.h"
+#include "gtest/gtest.h"
+#include "paddle/phi/backends/context_pool.h"
+#include "paddle/phi/common/port.h"
+#include "paddle/phi/infermeta/unary.h"
+#include "paddle/phi/kernels/funcs/weight_only_gemm_cpu.h"
+#include "paddle/phi/kernels/weight_only_linear_kernel.h"
+#include "paddle/phi/kernels/weight_quantize_kernel.h"
+
+namespace phi {
+namespace tests {
+
+inline double GetCurrentUS() {
+  struct timeval time = {};
+  gettimeofday(&time, nullptr);
+  return 1e+6 * time.tv_sec + time.tv_usec;  // NOLINT
+}
+
+// Random quantized weight and scales in the layout of weight_quantize with
+// arch = 0.
+struct QuantizedWeight {
+  QuantizedWeight(int64_t n, int64_t k, int bits, int group_size)
+      : weight(bits == 8 ? n * k : n / 2 * k),
+        scale(group_size > 0 ? (k + group_size - 1) / group_size * n : n) {
+    std::mt19937 rng(n * 31 + k + bits + group_size);
+    std::uniform_int_distribution<int> dist(bits == 8 ? -127 : -7,
+                                            bits == 8 ? 127 : 7);
+    for (auto& w : weight) {
+      if (bits == 8) {
+        w = static_cast<int8_t>(dist(rng));
+      } else {
+        w = static_cast<int8_t>((dist(rng) & 0x0F) | (dist(rng) << 4));
+      }
+    }
+    std::uniform_real_distribution<float> scale_dist(0.001f, 0.01f);
+    for (auto& s : scale) s = scale_dist(rng);
+  }
+
+  std::vector<int8_t> weight;
+  std::vector<float> scale;
+};
+
+std::vector<float> RandomVector(int64_t size) {
+  std::mt19937 rng(size);
+  std::uniform_real_distribution<float> dist(-1.f, 1.f);
+  std::vector<float> v(size);
+  for (auto& x : v) x = dist(rng);
+  return v;
+}
+
+void TestWeightOnlyGemm(
+    int64_t m, int64_t n, int64_t k, int bits, int group_size) {
+  QuantizedWeight qw(n, k, bits, group_size);
+  std::vector<float> x = RandomVector(m * k);
+  std::vector<float> bias = RandomVector(n);
+  std::vector<float> out(m * n), ref(m * n), w(n * k);
+
+  funcs::WeightOnlyGemmArgs args{x.data(),
+                                 qw.weight.data(),
+                                 qw.scale.data(),
+                                 bias.data(),
+                                 out.data(),
+                                 m,
+                                 n,
+                                 k,
+                                 bits,
+                                 group_size};
+  funcs::WeightOnlyGemm(args);
+  args.out = ref.data();
+  funcs::WeightOnlyGemmRef(args, 0, n);
+  for (int64_t i = 0; i < m * n; ++i) {
+    EXPECT_NEAR(out[i], ref[i], 1e-3f * (1.f + std::fabs(ref[i])))
+        << "m=" << m << " n=" << n << " k=" << k << " bits=" << bits
+        << " group_size=" << group_size << " i=" << i;
+  }
+
+  // The dequantized weight gives the same result with a plain GEMM.
+  funcs::WeightOnlyDequantize(args, w.data());
+  for (int64_t r = 0; r < m; ++r) {
+    for (int64_t c = 0; c < n; ++c) {
+      float sum = bias[c];
+      for (int64_t i = 0; i < k; ++i) {
+        sum += x[r * k + i] * w[c * k + i];
+      }
+      EXPECT_NEAR(sum, ref[r * n + c], 1e-3f * (1.f + std::fabs(sum)));
+    }
+  }
+}
+
+TEST(WeightOnlyGemmCPU, int8) {
+  for (int64_t m : {1, 3, 4, 7, 32}) {
+    TestWeightOnlyGemm(m, 64, 128, 8, -1);
+    TestWeightOnlyGemm(m, 64, 256, 8, 64);
+    TestWeightOnlyGemm(m, 96, 256, 8, 128);
+  }
+  // k not divisible by the SIMD width uses the reference.
+  TestWeightOnlyGemm(2, 64, 72, 8, -1);
+}
+
+TEST(WeightOnlyGemmCPU, int4) {
+  for (int64_t m : {1, 2, 5, 16}) {
+    TestWeightOnlyGemm(m, 64, 128, 4, -1);
+    TestWeightOnlyGemm(m, 128, 256, 4, 64);
+    TestWeightOnlyGemm(m, 64, 384, 4, 128);
+  }
+}
+
+// Quantizes a float [k, n] weight with weight_quantize (arch = 0) and runs
+// weight_only_linear on it. The result may differ from the float matmul by
+// at most half a quantization step of every weight.
+void TestQuantizedLinear(
+    int64_t m, int64_t n, int64_t k, int bits, int group_size) {
+  const auto& ctx = *static_cast<const CPUContext*>(
+      DeviceContextPool::Instance().Get(CPUPlace()));
+  const std::string algo = bits == 8 ? "weight_only_int8" : "weight_only_int4";
+  DenseTensor x, weight, bias, qweight, scale, out;
+  x.Resize({m, k});
+  weight.Resize({k, n});
+  bias.Resize({n});
+  std::vector<float> x_vec = RandomVector(m * k);
+  std::vector<float> w_vec = RandomVector(k * n);
+  std::vector<float> bias_vec = RandomVector(n);
+  std::copy_n(x_vec.begin(), x.numel(), ctx.Alloc<float>(&x));
+  std::copy_n(w_vec.begin(), weight.numel(), ctx.Alloc<float>(&weight));
+  std::copy_n(bias_vec.begin(), bias.numel(), ctx.Alloc<float>(&bias));
+
+  MetaTensor meta_qweight(&qweight), meta_scale(&scale);
+  WeightQuantizeInferMeta(
+      weight, algo, 0, group_size, &meta_qweight, &meta_scale);
+  WeightQuantizeKernel<float, CPUContext>(
+      ctx, weight, algo, 0, group_size, &qweight, &scale);
+  out.Resize({m, n});
+  WeightOnlyLinearKernel<float, CPUContext>(ctx,
+                                            x,
+                                            qweight,
+                                            bias,
+                                            scale,
+                                            bits == 8 ? "int8" : "int4",
+                                            0,
+                                            group_size,
+                                            &out);
+
+  // Quantization step of every weight.
+  const int64_t group = group_size > 0 ? group_size : k;
+  const float qmax = bits == 8 ? 127.f : 7.f;
+  std::vector<float> step(k * n);
+  for (int64_t c = 0; c < n; ++c) {
+    for (int64_t g = 0; g < k; g += group) {
+      float absmax = 0.f;
+      for (int64_t i = g; i < std::min(k, g + group); ++i) {
+        absmax = std::max(absmax, std::fabs(w_vec[i * n + c]));
+      }
+      for (int64_t i = g; i < std::min(k, g + group); ++i) {
+        step[i * n + c] = absmax / qmax;
+      }
+    }
+  }
+
+  const float* out_data = out.data<float>();
+  for (int64_t r = 0; r < m; ++r) {
+    for (int64_t c = 0; c < n; ++c) {
+      float ref = bias_vec[c];
+      float bound = 0.f;
+      for (int64_t i = 0; i < k; ++i) {
+        ref += x_vec[r * k + i] * w_vec[i * n + c];
+        bound += 0.5f * std::fabs(x_vec[r * k + i]) * step[i * n + c];
+      }
+      EXPECT_NEAR(out_data[r * n + c], ref, bound + 1e-3f)
+          << "m=" << m << " n=" << n << " k=" << k << " bits=" << bits
+          << " group_size=" << group_size << " r=" << r << " c=" << c;
+    }
+  }
+}
+
+TEST(WeightOnlyLinearCPU, quantized_weight) {
+  // m = 1 takes the GEMV path and m = 33 dequantizes the weight for a GEMM.
+  for (int64_t m : {1, 33}) {
+    for (int bits : {8, 4}) {
+      TestQuantizedLinear(m, 64, 128, bits, -1);
+      TestQuantizedLinear(m, 64, 128, bits, 64);
+      TestQuantizedLinear(m, 96, 256, bits, 128);
+    }
+  }
+}
+
+TEST(WeightOnlyGemmCPU, benchmark) {
+  const int64_t n = 1024, k = 1024;
+  const int repeat = 20;
+  for (int bits : {8, 4}) {
+    QuantizedWeight qw(n, k, bits, -1);
+    for (int64_t m : {1, 4, 32}) {
+      std::vector<float> x = RandomVector(m * k);
+      std::vector<float> out(m * n);
+      funcs::WeightOnlyGemmArgs args{x.data(),
+                                     qw.weight.data(),
+                                     qw.scale.data(),
+                                     nullptr,
+                                     out.data(),
+                                     m,
+                                     n,
+                                     k,
+                                     bits,
+                                     -1};
+      double start = GetCurrentUS();
+      for (int i = 0; i < repeat; ++i) {
+        funcs::WeightOnlyGemmRef(args, 0, n);
+      }
+      double ref_us = (GetCurrentUS() - start) / repeat;
+      start = GetCurrentUS();
+      for (int i = 0; i < repeat; ++i) {
+        funcs::WeightOnlyGemm(args);
+      }
+      double us = (GetCurrentUS() - start) / repeat;
+      VLOG(3) << "int" << bits << " m=" << m << " n=" << n << " k=" << k
+              << ": reference " << ref_us << " us, dispatched " << us
+              << " us";
+    }
+  }
+}
+
+}  // namespace tests
+}  // namespace phi
@@ -0,0 +1,247 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+#include "glog/logging.h"
+#include "paddle/fluid/pir/dialect/operator/ir/control_flow_op.h"
+#include "paddle/fluid/pir/dialect/operator/ir/op_dialect.h"
+#include "paddle/fluid/pir/dialect/operator/ir/pd_op.h"
+#include "paddle/pir/include/core/builder.h"
+#include "paddle/pir/include/core/builtin_dialect.h"
+#include "paddle/pir/include/core/ir_context.h"
+#include "paddle/pir/include/core/program.h"
+#include "paddle/pir/include/dialect/control_flow/ir/cf_dialect.h"
+#include "paddle/pir/include/dialect/control_flow/ir/cf_op.h"
+#include "paddle/pir/include/pass/pass.h"
+#include "paddle/pir/include/pass/pass_manager.h"
+#include "paddle/pir/include/pattern_rewrite/pattern_match.h"
+#include "test/cpp/pir/tools/test_dialect.h"
+#include "test/cpp/pir/tools/test_op.h"
+
+template <typename OpT>
+class EraseUnusedOpPattern : public pir::OpRewritePattern<OpT> {
+ public:
+  using pir::OpRewritePattern<OpT>::OpRewritePattern;
+
+  bool MatchAndRewrite(
+      OpT op,
+      pir::PatternRewriter &rewriter) const override {  // NOLINT
+    for (auto result : op->results()) {
+      if (!result.use_empty()) return false;
+    }
+    rewriter.EraseOp(op);
+    return true;
+  }
+};
+
+class EraseUnusedOpPass : public pir::PatternRewritePass {
+ public:
+  EraseUnusedOpPass() : pir::PatternRewritePass("erase_unused_op_pass", 1) {}
+
+  pir::RewritePatternSet InitializePatterns(pir::IrContext *context) override {
+    pir::RewritePatternSet ps(context);
+    ps.Add<EraseUnusedOpPattern<test::Operation1>,
+           EraseUnusedOpPattern<test::TraitExampleOp>>(context);
+    return ps;
+  }
+};
+
+// `num_regions` region ops, each one holding a chain of `chain_length`
+// unused ops. The region op i uses the value i / `share` defined outside of
+// it, so that `share` region ops use the same value.
+void BuildProgram(pir::Builder &builder,  // NOLINT
+                  pir::Block *block,
+                  int num_regions,
+                  int chain_length,
+                  int share) {
+  pir::Type f32 = builder.float32_type();
+  std::vector<pir::Value> inputs;
+  for (int i = 0; i < num_regions; ++i) {
+    builder.SetInsertionPointToBlockEnd(block);
+    if (i % share == 0) {
+      inputs.push_back(builder.Build<test::Operation1>().result(0));
+    }
+    auto region_op = builder.Build<test::RegionOp>();
+    builder.SetInsertionPointToBlockEnd(&region_op->region(0).emplace_back());
+    pir::Value x = inputs.back();
+    for (int j = 0; j < chain_length; ++j) {
+      x = builder
+              .Build<test::TraitExampleOp>(
+                  x, builder.Build<test::Operation1>().result(0), f32)
+              .result(0);
+    }
+  }
+}
+
+size_t CountOpsInRegions(pir::Block *block) {
+  size_t num_ops = 0;
+  for (auto &op : *block) {
+    for (size_t i = 0; i < op.num_regions(); ++i) {
+      for (auto &nested_block : op.region(i)) {
+        num_ops += nested_block.size();
+      }
+    }
+  }
+  return num_ops;
+}
+
+TEST(nested_pass_manager, run_on_regions) {
+  pir::IrContext *ctx = pir::IrContext::Instance();
+  ctx->GetOrRegisterDialect<pir::BuiltinDialect>();
+  ctx->GetOrRegisterDialect<test::TestDialect>();
+
+  for (int num_threads : {1, 4}) {
+    pir::Program program(ctx);
+    pir::Builder builder(ctx, program.block());
+    BuildProgram(builder, program.block(), 16, 10, 2);
+    size_t num_top_ops = program.block()->size();
+    EXPECT_EQ(CountOpsInRegions(program.block()), 16u * 20u);
+
+    std::atomic<int> num_pipelines{0};
+    pir::PassManager pm(ctx);
+    pm.AddNestedPipeline(
+        test::RegionOp::name(),
+        [&](pir::PassManager *nested_pm) {
+          ++num_pipelines;
+          nested_pm->AddPass(std::make_unique<EraseUnusedOpPass>());
+        },
+        num_threads);
+    EXPECT_TRUE(pm.Run(&program));
+
+    EXPECT_EQ(CountOpsInRegions(program.block()), 0u);
+    EXPECT_EQ(program.block()->size(), num_top_ops);
+    EXPECT_LE(num_pipelines, num_threads);
+  }
+}
+
+// Counts the runs on each test.region op.
+class CountRegionRunsPass : public pir::Pass {
+ public:
+  CountRegionRunsPass(std::unordered_map<pir::Operation *, int> *runs,
+                      std::mutex *mutex)
+      : pir::Pass("count_region_runs_pass", 0), runs_(runs), mutex_(mutex) {}
+
+  void Run(pir::Operation *op) override {
+    std::lock_guard<std::mutex> lock(*mutex_);
+    ++(*runs_)[op];
+  }
+
+  bool CanApplyOn(pir::Operation *op) const override {
+    return op->isa<test::RegionOp>();
+  }
+
+ private:
+  std::unordered_map<pir::Operation *, int> *runs_;
+  std::mutex *mutex_;
+};
+
+// Builds a test.region op holding one op at the insertion point.
+pir::Operation *BuildRegionOp(pir::Builder &builder) {  // NOLINT
+  auto region_op = builder.Build<test::RegionOp>();
+  auto insertion_point = builder.insertion_point();
+  builder.SetInsertionPointToBlockEnd(&region_op->region(0).emplace_back());
+  builder.Build<test::Operation1>();
+  builder.set_insertion_point(insertion_point);
+  return region_op;
+}
+
+// Builds an if op with no output at the insertion point, and moves the
+// insertion point to the start of its true block.
+paddle::dialect::IfOp BuildIfOp(pir::Builder &builder) {  // NOLINT
+  auto cond = builder.Build<paddle::dialect::FullOp>(
+      std::vector<int64_t>{1}, true, phi::DataType::BOOL);
+  auto if_op = builder.Build<paddle::dialect::IfOp>(cond.out(),
+                                                    std::vector<pir::Type>{});
+  builder.SetInsertionPointToStart(&if_op.false_block());
+  builder.Build<pir::YieldOp>(std::vector<pir::Value>{});
+  builder.SetInsertionPointToStart(&if_op.true_block());
+  builder.Build<pir::YieldOp>(std::vector<pir::Value>{});
+  builder.SetInsertionPointToStart(&if_op.true_block());
+  return if_op;
+}
+
+TEST(nested_pass_manager, run_once_on_nested_targets) {
+  pir::IrContext *ctx = pir::IrContext::Instance();
+  ctx->GetOrRegisterDialect<pir::BuiltinDialect>();
+  ctx->GetOrRegisterDialect<test::TestDialect>();
+  ctx->GetOrRegisterDialect<paddle::dialect::OperatorDialect>();
+  ctx->GetOrRegisterDialect<pir::ControlFlowDialect>();
+
+  // region_op
+  // if { region_op, if { region_op } }
+  pir::Program program(ctx);
+  pir::Builder builder(ctx, program.block());
+  std::vector<pir::Operation *> targets;
+  targets.push_back(BuildRegionOp(builder));
+  BuildIfOp(builder);
+  targets.push_back(BuildRegionOp(builder));
+  BuildIfOp(builder);
+  targets.push_back(BuildRegionOp(builder));
+
+  for (int num_threads : {1, 4}) {
+    std::unordered_map<pir::Operation *, int> runs;
+    std::mutex mutex;
+    pir::PassManager pm(ctx);
+    pm.AddNestedPipeline(
+        test::RegionOp::name(),
+        [&](pir::PassManager *nested_pm) {
+          nested_pm->AddPass(
+              std::make_unique<CountRegionRunsPass>(&runs, &mutex));
+        },
+        num_threads);
+    EXPECT_TRUE(pm.Run(&program));
+    EXPECT_EQ(runs.size(), targets.size());
+    for (auto *target : targets) {
+      EXPECT_EQ(runs[target], 1);
+    }
+  }
+}
+
+// Nested pipeline over many region ops, on one thread and on all cores.
+TEST(DISABLED_nested_pass_manager, benchmark_parallel_regions) {
+  pir::IrContext *ctx = pir::IrContext::Instance();
+  ctx->GetOrRegisterDialect<pir::BuiltinDialect>();
+  ctx->GetOrRegisterDialect<test::TestDialect>();
+
+  int max_threads = std::max(1u, std::thread::hardware_concurrency());
+  for (int num_threads : {1, max_threads}) {
+    pir::Program program(ctx);
+    pir::Builder builder(ctx, program.block());
+    BuildProgram(builder, program.block(), 256, 200, 1);
+
+    pir::PassManager pm(ctx);
+    pm.AddNestedPipeline(
+        test::RegionOp::name(),
+        [](pir::PassManager *nested_pm) {
+          nested_pm->AddPass(std::make_unique<EraseUnusedOpPass>());
+        },
+        num_threads);
+    pm.EnablePassTiming();
+    auto start = std::chrono::steady_clock::now();
+    EXPECT_TRUE(pm.Run(&program));
+    double ms = std::chrono::duration<double, std::milli>(
+                    std::chrono::steady_clock::now() - start)
+                    .count();
+    EXPECT_EQ(CountOpsInRegions(program.block()), 0u);
+    LOG(INFO) << "erase_unused_op_pass on 256 regions of 400 ops with "
+              << num_threads << " threads: " << ms << "ms.";
+  }
+}
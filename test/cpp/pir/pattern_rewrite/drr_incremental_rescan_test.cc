@@ -0,0 +1,135 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <glog/logging.h>
+#include <gtest/gtest.h>
+#include <chrono>
+#include <memory>
+
+#include "paddle/fluid/pir/dialect/operator/ir/op_dialect.h"
+#include "paddle/fluid/pir/dialect/operator/ir/pd_op.h"
+#include "paddle/fluid/pir/drr/include/drr_pattern_base.h"
+#include "paddle/pir/include/core/builtin_dialect.h"
+#include "paddle/pir/include/pass/pass.h"
+#include "paddle/pir/include/pass/pass_manager.h"
+#include "paddle/pir/include/pattern_rewrite/pattern_rewrite_driver.h"
+
+// relu(relu(x)) -> relu(x)
+class RemoveRedundantReluPattern : public paddle::drr::DrrPatternBase {
+ public:
+  std::string name() const override { return "RemoveRedundantReluPattern"; }
+
+  void operator()(paddle::drr::DrrPatternContext *ctx) const override {
+    paddle::drr::SourcePattern src = ctx->SourcePattern();
+    const auto &relu_1 = src.Op("pd_op.relu");
+    const auto &relu_2 = src.Op("pd_op.relu");
+    src.Tensor("relu_1_out") = relu_1(src.Tensor("x"));
+    src.Tensor("relu_2_out") = relu_2(src.Tensor("relu_1_out"));
+
+    paddle::drr::ResultPattern res = src.ResultPattern();
+    const auto &relu = res.Op("pd_op.relu");
+    res.Tensor("relu_2_out") = relu(res.Tensor("x"));
+  }
+};
+
+class RemoveRedundantReluPass : public pir::PatternRewritePass {
+ public:
+  explicit RemoveRedundantReluPass(bool incremental_rescan)
+      : pir::PatternRewritePass("remove_redundant_relu_pass", 1),
+        incremental_rescan_(incremental_rescan) {}
+
+  pir::RewritePatternSet InitializePatterns(pir::IrContext *context) override {
+    pir::RewritePatternSet ps(context);
+    ps.Add(paddle::drr::Create<RemoveRedundantReluPattern>(context));
+    return ps;
+  }
+
+  pir::GreedyRewriteConfig InitializeConfig() override {
+    auto config = pir::PatternRewritePass::InitializeConfig();
+    config.incremental_rescan = incremental_rescan_;
+    return config;
+  }
+
+ private:
+  bool incremental_rescan_;
+};
+
+// `num_chains` chains of `chain_length` relu, each one fed by a full op and
+// reduced to a single relu by the pass.
+void BuildProgram(pir::Builder &builder,  // NOLINT
+                  int num_chains,
+                  int chain_length) {
+  for (int i = 0; i < num_chains; ++i) {
+    pir::Value x = builder
+                       .Build<paddle::dialect::FullOp>(
+                           std::vector<int64_t>{4, 16},
+                           1.5,
+                           phi::DataType::FLOAT32,
+                           phi::CPUPlace())
+                       .out();
+    for (int j = 0; j < chain_length; ++j) {
+      x = builder.Build<paddle::dialect::ReluOp>(x).out();
+    }
+  }
+}
+
+// Returns the time of the pass in ms.
+double RunPass(pir::Program *program, bool incremental_rescan) {
+  pir::IrContext *ctx = pir::IrContext::Instance();
+  pir::PassManager pm(ctx);
+  pm.AddPass(std::make_unique<RemoveRedundantReluPass>(incremental_rescan));
+  pm.EnablePassTiming();
+  auto start = std::chrono::steady_clock::now();
+  PADDLE_ENFORCE_EQ(pm.Run(program),
+                    true,
+                    common::errors::Unavailable("pm fail to run program"));
+  return std::chrono::duration<double, std::milli>(
+             std::chrono::steady_clock::now() - start)
+      .count();
+}
+
+TEST(DrrTest, incremental_rescan) {
+  pir::IrContext *ctx = pir::IrContext::Instance();
+  ctx->GetOrRegisterDialect<paddle::dialect::OperatorDialect>();
+  ctx->GetOrRegisterDialect<pir::BuiltinDialect>();
+
+  for (bool incremental_rescan : {false, true}) {
+    pir::Program program(ctx);
+    pir::Builder builder = pir::Builder(ctx, program.block());
+    BuildProgram(builder, 8, 5);
+    EXPECT_EQ(program.block()->size(), 48u);
+
+    RunPass(&program, incremental_rescan);
+    EXPECT_EQ(program.block()->size(), 16u);
+  }
+}
+
+// Time of the drr pass on a large program with and without the rescan.
+TEST(DISABLED_DrrTest, benchmark_incremental_rescan) {
+  pir::IrContext *ctx = pir::IrContext::Instance();
+  ctx->GetOrRegisterDialect<paddle::dialect::OperatorDialect>();
+  ctx->GetOrRegisterDialect<pir::BuiltinDialect>();
+
+  double ms[2];
+  for (bool incremental_rescan : {false, true}) {
+    pir::Program program(ctx);
+    pir::Builder builder = pir::Builder(ctx, program.block());
+    BuildProgram(builder, 2000, 4);
+    ms[incremental_rescan] = RunPass(&program, incremental_rescan);
+    EXPECT_EQ(program.block()->size(), 4000u);
+  }
+  LOG(INFO) << "remove_redundant_relu_pass over 10000 ops: " << ms[0]
+            << "ms with full rescans, " << ms[1]
+            << "ms with incremental rescans.";
+}
@@ -0,0 +1,229 @@
+# Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import unittest
+
+import numpy as np
+from pass_test import PassTest
+
+import paddle
+from paddle.base import core
+from paddle.pir.core import create_parameter
+
+
+@unittest.skipIf(
+    not core.supports_avx512f() or not core.is_compiled_with_avx(),
+    "machine is not support AVX512F or is not compiled with AVX",
+)
+class TestRmsNormCpuFusePattern(PassTest):
+    r"""
+     x                   x       w
+     |                   |       |
+    pow                  |       |
+     |                   |       |
+    mean     epilson     |       |
+       \     /           |       |
+        rsqrt            |       |
+          |              |       |
+            \          /         |
+              multiply           |
+                 |               |
+                    \          /
+                      multiply
+    """
+
+    def is_program_valid(self, program=None):
+        return True
+
+    def sample_program(self):
+        for x_shape in [[2, 8, 256]]:
+            for w_shape in [[256]]:
+                with paddle.pir_utils.IrGuard():
+                    start_prog = paddle.static.Program()
+                    main_prog = paddle.static.Program()
+                    with paddle.pir.core.program_guard(main_prog, start_prog):
+                        x = paddle.static.data(
+                            name='x', shape=x_shape, dtype='float32'
+                        )
+                        w = create_parameter(
+                            name="w",
+                            shape=w_shape,
+                            dtype='float32',
+                            initializer=paddle.nn.initializer.Assign(
+                                np.random.random(w_shape).astype('float32')
+                            ),
+                        )
+                        variance = x.pow(2).mean(-1, keepdim=True)
+                        x = paddle.rsqrt(variance + 1e-6) * x
+                        out = x * w
+                        out = paddle.assign(out)
+                        self.pass_attr_list = [{'add_norm_cpu_fuse_pass': {}}]
+                        self.feeds = {
+                            "x": np.random.random(x_shape).astype("float32"),
+                        }
+                        self.fetch_list = [out]
+                        self.valid_op_map = {
+                            "pd_op.pow": 0,
+                            "pd_op.mean": 0,
+                            "pd_op.rsqrt": 0,
+                            "pd_op.multiply": 0,
+                            "pd_op.rms_norm": 1,
+                        }
+
+                        yield [main_prog, start_prog], False
+
+    def setUp(self):
+        self.places.append(paddle.CPUPlace())
+
+    def test_check_output(self):
+        self.check_pass_correct(atol=1e-4, rtol=1e-4)
+
+
+class TestAddRmsNormCpuFusePattern(TestRmsNormCpuFusePattern):
+    r"""
+    x         residual
+    |           |
+         add ------------
+          |              |
+       rms_norm          |
+          |              |
+        matmul           |
+          |              |
+          add -----------
+    """
+
+    def sample_program(self):
+        for x_shape in [[2, 8, 256]]:
+            for w_shape in [[256]]:
+                with paddle.pir_utils.IrGuard():
+                    start_prog = paddle.static.Program()
+                    main_prog = paddle.static.Program()
+                    with paddle.pir.core.program_guard(main_prog, start_prog):
+                        residual = paddle.static.data(
+                            name='residual', shape=x_shape, dtype='float32'
+                        )
+                        x = paddle.static.data(
+                            name='x', shape=x_shape, dtype='float32'
+                        )
+                        w = create_parameter(
+                            name="w",
+                            shape=w_shape,
+                            dtype='float32',
+                            initializer=paddle.nn.initializer.Assign(
+                                np.random.random(w_shape).astype('float32')
+                            ),
+                        )
+                        w1 = create_parameter(
+                            name="w1",
+                            shape=[256, 256],
+                            dtype='float32',
+                            initializer=paddle.nn.initializer.Assign(
+                                np.random.random([256, 256]).astype('float32')
+                            ),
+                        )
+                        add_out = paddle.add(residual, x)
+                        add_out_1 = add_out
+                        variance = add_out.pow(2).mean(-1, keepdim=True)
+                        add_out = paddle.rsqrt(variance + 1e-6) * add_out
+                        mul_out = add_out * w
+                        matmul_out = paddle.matmul(mul_out, w1)
+                        out = paddle.add(add_out_1, matmul_out)
+                        out = paddle.assign(out)
+                        self.pass_attr_list = [{'add_norm_cpu_fuse_pass': {}}]
+                        self.feeds = {
+                            "x": np.random.random(x_shape).astype("float32"),
+                            "residual": np.random.random(x_shape).astype(
+                                "float32"
+                            ),
+                        }
+                        self.fetch_list = [out]
+                        self.valid_op_map = {
+                            "pd_op.pow": 0,
+                            "pd_op.mean": 0,
+                            "pd_op.rsqrt": 0,
+                            "pd_op.multiply": 0,
+                            "pd_op.add": 1,
+                            "pd_op.rms_norm": 1,
+                        }
+
+                        yield [main_prog, start_prog], False
+
+    def test_check_output(self):
+        self.check_pass_correct(atol=1e-3, rtol=1e-3)
+
+
+class TestAddLayerNormCpuFusePattern(TestRmsNormCpuFusePattern):
+    r"""
+    x         residual
+    |           |
+         add ------------
+          |              |
+      layer_norm         |
+          |              |
+        matmul           |
+          |              |
+          add -----------
+    """
+
+    def sample_program(self):
+        for x_shape in [[2, 8, 256]]:
+            with paddle.pir_utils.IrGuard():
+                start_prog = paddle.static.Program()
+                main_prog = paddle.static.Program()
+                with paddle.pir.core.program_guard(main_prog, start_prog):
+                    residual = paddle.static.data(
+                        name='residual', shape=x_shape, dtype='float32'
+                    )
+                    x = paddle.static.data(
+                        name='x', shape=x_shape, dtype='float32'
+                    )
+                    w1 = create_parameter(
+                        name="w1",
+                        shape=[256, 256],
+                        dtype='float32',
+                        initializer=paddle.nn.initializer.Assign(
+                            np.random.random([256, 256]).astype('float32')
+                        ),
+                    )
+                    add_out = paddle.add(residual, x)
+                    add_out_1 = add_out
+                    layer_norm = paddle.nn.LayerNorm(
+                        add_out.shape[-1:], epsilon=1e-6
+                    )
+                    layer_norm_out = layer_norm(add_out)
+                    matmul_out = paddle.matmul(layer_norm_out, w1)
+                    out = paddle.add(add_out_1, matmul_out)
+                    out = paddle.assign(out)
+                    self.pass_attr_list = [{'add_norm_cpu_fuse_pass': {}}]
+                    self.feeds = {
+                        "x": np.random.random(x_shape).astype("float32"),
+                        "residual": np.random.random(x_shape).astype(
+                            "float32"
+                        ),
+                    }
+                    self.fetch_list = [out]
+                    self.valid_op_map = {
+                        "pd_op.layer_norm": 0,
+                        "pd_op.add": 1,
+                        "pd_op.fused_bias_residual_layernorm": 1,
+                    }
+
+                    yield [main_prog, start_prog], False
+
+    def test_check_output(self):
+        self.check_pass_correct(atol=1e-3, rtol=1e-3)
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,158 @@
+# Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import unittest
+
+import numpy as np
+from pass_test import PassTest
+
+import paddle
+from paddle import pir
+from paddle.base import core
+
+paddle.enable_static()
+
+HEIGHT = 100
+WIDTH = 8
+BATCH_SIZE = 4
+
+
+# The ids of BATCH_SIZE sequences of 0 to 4 ids. The ids need a lod, which
+# static.data does not keep in pir, so the programs are built in the old ir
+# and translated.
+def random_ids(seed):
+    rng = np.random.default_rng(seed)
+    lengths = rng.integers(0, 5, BATCH_SIZE)
+    ids = rng.integers(0, HEIGHT, int(lengths.sum())).astype('int64')
+    tensor = core.DenseTensor()
+    tensor.set(ids, core.CPUPlace())
+    tensor.set_lod([np.concatenate([[0], np.cumsum(lengths)]).tolist()])
+    return tensor
+
+
+class TestEmbeddingFusedSeqpoolCvmFusePattern(PassTest):
+    r"""
+    ids_0     w   ids_1     w
+      |       |     |       |
+      embedding     embedding
+            \         /
+             \       /   cvm
+           fused_seqpool_cvm
+    """
+
+    def is_program_valid(self, program=None):
+        return True
+
+    def build_program(self, slot_size):
+        with paddle.pir_utils.OldIrGuard():
+            main_prog = paddle.static.Program()
+            with paddle.static.program_guard(main_prog):
+                w = paddle.static.data(
+                    name='w', shape=[HEIGHT, WIDTH], dtype='float32'
+                )
+                cvm = paddle.static.data(
+                    name='cvm', shape=[BATCH_SIZE, 2], dtype='float32'
+                )
+                embs = []
+                for i in range(slot_size):
+                    ids = paddle.static.data(
+                        name=f'ids_{i}',
+                        shape=[-1],
+                        dtype='int64',
+                        lod_level=1,
+                    )
+                    embs.append(paddle.nn.functional.embedding(ids, w))
+                outs = paddle.incubate.layers.fused_seqpool_cvm(
+                    embs, 'sum', cvm, use_cvm=True
+                )
+                out = paddle.concat(outs, axis=1)
+                out = paddle.assign(out)
+        return main_prog
+
+    def sample_program(self):
+        for slot_size in [1, 3]:
+            main_prog = pir.translate_to_pir(
+                self.build_program(slot_size).desc
+            )
+            with paddle.pir_utils.IrGuard():
+                start_prog = paddle.static.Program()
+            self.pass_attr_list = [{'embedding_seqpool_cvm_fuse_pass': {}}]
+            self.feeds = {
+                'w': np.random.random([HEIGHT, WIDTH]).astype('float32'),
+                'cvm': np.random.random([BATCH_SIZE, 2]).astype('float32'),
+            }
+            for i in range(slot_size):
+                self.feeds[f'ids_{i}'] = random_ids(i)
+            self.valid_op_map = {
+                "pd_op.embedding": 0,
+                "pd_op.fused_seqpool_cvm": 0,
+                "pd_op.fused_embedding_seqpool_cvm": 1,
+            }
+            yield [main_prog, start_prog], False
+
+    def setUp(self):
+        self.places.append(paddle.CPUPlace())
+
+    def test_check_output(self):
+        self.check_pass_correct(atol=1e-5, rtol=1e-5)
+
+
+class TestEmbeddingSequencePoolFusePattern(
+    TestEmbeddingFusedSeqpoolCvmFusePattern
+):
+    r"""
+    ids     w
+     |      |
+     embedding
+         |
+    sequence_pool
+    """
+
+    def build_program(self, pool_type):
+        with paddle.pir_utils.OldIrGuard():
+            main_prog = paddle.static.Program()
+            with paddle.static.program_guard(main_prog):
+                w = paddle.static.data(
+                    name='w', shape=[HEIGHT, WIDTH], dtype='float32'
+                )
+                ids = paddle.static.data(
+                    name='ids', shape=[-1], dtype='int64', lod_level=1
+                )
+                emb = paddle.nn.functional.embedding(ids, w)
+                out = paddle.static.nn.sequence_pool(emb, pool_type)
+                out = paddle.assign(out)
+        return main_prog
+
+    def sample_program(self):
+        for pool_type in ['sum', 'average', 'sqrt']:
+            main_prog = pir.translate_to_pir(
+                self.build_program(pool_type).desc
+            )
+            with paddle.pir_utils.IrGuard():
+                start_prog = paddle.static.Program()
+            self.pass_attr_list = [{'embedding_seqpool_cvm_fuse_pass': {}}]
+            self.feeds = {
+                'w': np.random.random([HEIGHT, WIDTH]).astype('float32'),
+                'ids': random_ids(7),
+            }
+            self.valid_op_map = {
+                "pd_op.embedding": 0,
+                "pd_op.sequence_pool": 0,
+                "pd_op.fused_embedding_seqpool_cvm": 1,
+            }
+            yield [main_prog, start_prog], False
+
+
+if __name__ == "__main__":
+    unittest.main()
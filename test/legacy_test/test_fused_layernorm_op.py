@@ -838,6 +838,10 @@ class TestlayernormOpCPU(unittest.TestCase):
         self.norm_bias_np = np.random.uniform(-0.05, 0.05, [cols])
         self.epsilon = 1e-5
         self.residual_alpha = np.random.uniform(low=0.1, high=1.1, size=[1])
+        self.quant_scale = 0.15
+        self.quant_round_type = 1
+        self.quant_max_bound = 127
+        self.quant_min_bound = -127
 
     def check_layernorm(self, x_np, gamma_np, beta_np, dtype):
         paddle.disable_static()
@@ -911,6 +915,70 @@ class TestlayernormOpCPU(unittest.TestCase):
             paddle_naive_residual_out,
         )
 
+    def check_residual_bias_layernorm_int8(
+        self, x_np, gamma_np, beta_np, residual_np, bias_np, dtype
+    ):
+        paddle.disable_static()
+        x = paddle.to_tensor(x_np.astype(dtype))
+        gamma = paddle.to_tensor(gamma_np.astype(np.float32))
+        beta = paddle.to_tensor(beta_np.astype(np.float32))
+        residual = paddle.to_tensor(residual_np.astype(dtype))
+        bias = paddle.to_tensor(bias_np.astype(dtype))
+
+        paddle_layernorm_out = paddle.incubate.nn.functional.fused_layer_norm(
+            x,
+            gamma,
+            beta,
+            self.epsilon,
+            begin_norm_axis=1,
+            bias=bias,
+            residual=residual,
+            residual_alpha=self.residual_alpha,
+            quant_scale=self.quant_scale,
+            quant_round_type=self.quant_round_type,
+            quant_max_bound=self.quant_max_bound,
+            quant_min_bound=self.quant_min_bound,
+        )
+
+        (
+            paddle_naive_layernorm_out,
+            paddle_naive_residual_out,
+        ) = naive_residual_biasadd_layer_norm_int8(
+            x,
+            residual,
+            bias,
+            gamma,
+            beta,
+            self.epsilon,
+            self.residual_alpha,
+            self.quant_scale,
+            self.quant_round_type,
+            self.quant_max_bound,
+            self.quant_min_bound,
+        )
+        paddle.enable_static()
+        return (
+            paddle_layernorm_out,
+            paddle_naive_layernorm_out,
+            paddle_naive_residual_out,
+        )
+
+    def check_layernorm_bf16(self, x_np, gamma_np, beta_np):
+        paddle.disable_static()
+        x = paddle.to_tensor(x_np.astype(np.float32)).astype('bfloat16')
+        gamma = paddle.to_tensor(gamma_np.astype(np.float32))
+        beta = paddle.to_tensor(beta_np.astype(np.float32))
+
+        paddle_layernorm_out = paddle.incubate.nn.functional.fused_layer_norm(
+            x, gamma, beta, self.epsilon, begin_norm_axis=1
+        )[0]
+        # the reference runs in float32 on the same bfloat16 input
+        paddle_naive_layernorm_out = naive_layer_norm(
+            x.astype('float32'), gamma, beta, self.epsilon
+        )
+        paddle.enable_static()
+        return paddle_layernorm_out, paddle_naive_layernorm_out
+
     def test_residual_bias_add(self):
         (
             paddle_residual_bias_out,
@@ -963,6 +1031,43 @@ class TestlayernormOpCPU(unittest.TestCase):
             atol=1e-3,
         )
 
+    def test_residual_bias_add_layernorm_int8(self):
+        (
+            paddle_layernorm,
+            paddle_naive_layernorm,
+            paddle_naive_residual_out,
+        ) = self.check_residual_bias_layernorm_int8(
+            self.x_np,
+            self.norm_weight_np,
+            self.norm_bias_np,
+            self.residual_np,
+            self.bias_np,
+            'float32',
+        )
+        np.testing.assert_allclose(
+            paddle_layernorm[0].numpy(),
+            paddle_naive_layernorm.numpy(),
+            rtol=2,
+            atol=2,
+        )
+        np.testing.assert_allclose(
+            paddle_layernorm[1].numpy(),
+            paddle_naive_residual_out.numpy(),
+            rtol=1e-3,
+            atol=1e-3,
+        )
+
+    def test_layernorm_bf16(self):
+        paddle_layernorm, paddle_naive_layernorm = self.check_layernorm_bf16(
+            self.x_np, self.norm_weight_np, self.norm_bias_np
+        )
+        np.testing.assert_allclose(
+            paddle_layernorm.astype('float32').numpy(),
+            paddle_naive_layernorm.numpy(),
+            rtol=1e-2,
+            atol=1e-2,
+        )
+
 
 @unittest.skipIf(
     not core.supports_avx512f() or not core.is_compiled_with_avx(),
@@ -32,6 +32,26 @@ class HostPythonNode:
         self.mem_node = []
 
 
+class PerfCounterValues:
+    def __init__(
+        self,
+        cycles=0,
+        instructions=0,
+        cache_references=0,
+        cache_misses=0,
+        task_clock_ns=0,
+        hardware=True,
+    ):
+        self.valid = True
+        self.hardware = hardware
+        self.cycles = cycles
+        self.instructions = instructions
+        self.cache_references = cache_references
+        self.cache_misses = cache_misses
+        self.task_clock_ns = task_clock_ns
+        self.page_faults = 0
+
+
 class DevicePythonNode:
     def __init__(
         self, name, type, start_ns, end_ns, device_id, context_id, stream_id
@@ -1044,6 +1064,94 @@ class TestProfilerStatistic(unittest.TestCase):
                 )
             )
 
+    def test_statistic_perf_counters(self):
+        root_node = HostPythonNode(
+            'Root Node',
+            profiler.TracerEventType.UserDefined,
+            0,
+            float('inf'),
+            1000,
+            1001,
+        )
+        profilerstep_node = HostPythonNode(
+            'ProfileStep#1',
+            profiler.TracerEventType.ProfileStep,
+            0,
+            400,
+            1000,
+            1001,
+        )
+        matmul_node = HostPythonNode(
+            'matmul', profiler.TracerEventType.Operator, 10, 110, 1000, 1001
+        )
+        matmul_node.perf_counters = PerfCounterValues(
+            cycles=400,
+            instructions=1000,
+            cache_references=100,
+            cache_misses=2,
+            task_clock_ns=90,
+        )
+        relu_node = HostPythonNode(
+            'relu', profiler.TracerEventType.Operator, 120, 220, 1000, 1001
+        )
+        relu_node.perf_counters = PerfCounterValues(
+            cycles=1000,
+            instructions=500,
+            cache_references=100,
+            cache_misses=50,
+            task_clock_ns=100,
+        )
+        # an operator without counters, e.g. profiled before they were enabled
+        scale_node = HostPythonNode(
+            'scale', profiler.TracerEventType.Operator, 230, 240, 1000, 1001
+        )
+        root_node.children_node.append(profilerstep_node)
+        profilerstep_node.children_node.extend(
+            [matmul_node, relu_node, scale_node]
+        )
+        thread_tree = {'thread1001': root_node}
+        extra_info = {}
+        statistic_data = profiler.profiler_statistic.StatisticData(
+            thread_tree, extra_info
+        )
+        event_summary = statistic_data.event_summary
+
+        matmul = event_summary.items['matmul']
+        self.assertEqual(matmul.counter_call, 1)
+        self.assertEqual(matmul.counter_cpu_time, 100)
+        self.assertEqual(matmul.ipc, 2.5)
+        self.assertEqual(matmul.mpki, 2)
+        self.assertEqual(matmul.bytes_moved, 128)
+        self.assertEqual(matmul.bound, 'Compute')
+        relu = event_summary.items['relu']
+        self.assertEqual(relu.mpki, 100)
+        self.assertEqual(relu.bound, 'Memory')
+        self.assertEqual(event_summary.items['scale'].counter_call, 0)
+
+        table = profiler.profiler_statistic._build_table(
+            statistic_data,
+            sorted_by=profiler.SortedKeys.CPUTotal,
+            views=[profiler.SummaryView.CounterView],
+            time_unit='ns',
+        )
+        print(table)
+        self.assertIn('Operator Counter Summary', table)
+        self.assertNotIn('scale', table)
+
+        # software counters only
+        relu_node.perf_counters.hardware = False
+        statistic_data = profiler.profiler_statistic.StatisticData(
+            thread_tree, extra_info
+        )
+        self.assertEqual(statistic_data.event_summary.items['relu'].bound, '-')
+        table = profiler.profiler_statistic._build_table(
+            statistic_data,
+            sorted_by=profiler.SortedKeys.CPUTotal,
+            views=[profiler.SummaryView.CounterView],
+            time_unit='ns',
+        )
+        self.assertIn('only software counters are shown', table)
+
 
 if __name__ == '__main__':
     unittest.main()
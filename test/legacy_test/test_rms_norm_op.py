@@ -601,6 +601,10 @@ class TestRMSNormOpCPU(unittest.TestCase):
         self.norm_weight_np = np.random.random([cols])
         self.norm_bias_np = np.random.random([cols])
         self.epsilon = 1e-6
+        self.quant_scale = 0.15
+        self.quant_round_type = 1
+        self.quant_max_bound = 127
+        self.quant_min_bound = -127
 
     def check_rmsnorm(self, x_np, gamma_np, beta_np, dtype):
         paddle.disable_static()
@@ -615,6 +619,80 @@ class TestRMSNormOpCPU(unittest.TestCase):
         paddle.enable_static()
         return paddle_rmsnorm_out, paddle_naive_rmsnorm_out
 
+    def check_rmsnorm_int8(self, x_np, gamma_np, beta_np, dtype):
+        paddle.disable_static()
+        x = paddle.to_tensor(x_np.astype(dtype))
+        gamma = paddle.to_tensor(gamma_np.astype(dtype))
+        beta = paddle.to_tensor(beta_np.astype(dtype))
+
+        paddle_rmsnorm_out = paddle.incubate.nn.functional.fused_rms_norm(
+            x,
+            gamma,
+            beta,
+            self.epsilon,
+            begin_norm_axis=1,
+            quant_scale=self.quant_scale,
+            quant_round_type=self.quant_round_type,
+            quant_max_bound=self.quant_max_bound,
+            quant_min_bound=self.quant_min_bound,
+        )[0]
+
+        paddle_naive_rmsnorm_out = naive_rms_norm_int8(
+            x,
+            gamma,
+            beta,
+            self.epsilon,
+            self.quant_scale,
+            self.quant_round_type,
+            self.quant_max_bound,
+            self.quant_min_bound,
+        )
+        paddle.enable_static()
+        return paddle_rmsnorm_out, paddle_naive_rmsnorm_out
+
+    def check_residual_bias_rmsnorm_bf16(
+        self, x_np, gamma_np, beta_np, residual_np, bias_np
+    ):
+        paddle.disable_static()
+        x = paddle.to_tensor(x_np.astype('float32')).astype('bfloat16')
+        gamma = paddle.to_tensor(gamma_np.astype('float32')).astype('bfloat16')
+        beta = paddle.to_tensor(beta_np.astype('float32')).astype('bfloat16')
+        residual = paddle.to_tensor(residual_np.astype('float32')).astype(
+            'bfloat16'
+        )
+        bias = paddle.to_tensor(bias_np.astype('float32')).astype('bfloat16')
+
+        paddle_rmsnorm_out = paddle.incubate.nn.functional.fused_rms_norm(
+            x,
+            gamma,
+            beta,
+            self.epsilon,
+            begin_norm_axis=1,
+            bias=bias,
+            residual=residual,
+        )
+
+        # the reference runs in float32 on the same bfloat16 inputs
+        paddle_naive_rmsnorm_out = naive_residual_biasadd_rms_norm(
+            x.astype('float32'),
+            residual.astype('float32'),
+            bias.astype('float32'),
+            gamma.astype('float32'),
+            beta.astype('float32'),
+            self.epsilon,
+        )
+        paddle_naive_residual_out = naive_residual_bias_add(
+            x.astype('float32'),
+            residual.astype('float32'),
+            bias.astype('float32'),
+        )
+        paddle.enable_static()
+        return (
+            paddle_rmsnorm_out,
+            paddle_naive_rmsnorm_out,
+            paddle_naive_residual_out,
+        )
+
     def check_residual_bias_rmsnorm(
         self, x_np, gamma_np, beta_np, residual_np, bias_np, dtype
     ):
@@ -685,6 +763,43 @@ class TestRMSNormOpCPU(unittest.TestCase):
             atol=1e-3,
         )
 
+    def test_rmsnorm_int8(self):
+        paddle_rmsnorm, paddle_naive_rmsnorm = self.check_rmsnorm_int8(
+            self.x_np, self.norm_weight_np, self.norm_bias_np, 'float32'
+        )
+        np.testing.assert_allclose(
+            paddle_rmsnorm.numpy(),
+            paddle_naive_rmsnorm.numpy(),
+            rtol=2,
+            atol=2,
+        )
+
+    def test_residual_bias_add_rmsnorm_bf16(self):
+        (
+            paddle_rmsnorm,
+            paddle_naive_rmsnorm,
+            paddle_naive_residual_out,
+        ) = self.check_residual_bias_rmsnorm_bf16(
+            self.x_np,
+            self.norm_weight_np,
+            self.norm_bias_np,
+            self.residual_np,
+            self.bias_np,
+        )
+
+        np.testing.assert_allclose(
+            paddle_rmsnorm[0].astype('float32').numpy(),
+            paddle_naive_rmsnorm.numpy(),
+            rtol=2e-2,
+            atol=2e-2,
+        )
+        np.testing.assert_allclose(
+            paddle_rmsnorm[1].astype('float32').numpy(),
+            paddle_naive_residual_out.numpy(),
+            rtol=1e-2,
+            atol=1e-2,
+        )
+
 
 @unittest.skipIf(
     not core.supports_avx512f() or not core.is_compiled_with_avx(),